@@ -50,7 +50,7 @@ function(qt_internal_add_simd_part target)
         list(APPEND simd_flags_expanded "${QT_CFLAGS_AVX512CD}")
         list(REMOVE_DUPLICATES simd_flags_expanded)
     elseif("${arg_SIMD}" STREQUAL avx512core)
-        set(condition "QT_FEATURE_avx512cd AND QT_FEATURE_avx512bw AND QT_FEATURE_avx512dq AND QT_FEATURE_avx512vl")
+        set(condition QT_FEATURE_avx512cd AND QT_FEATURE_avx512bw AND QT_FEATURE_avx512dq AND QT_FEATURE_avx512vl)
         list(APPEND simd_flags_expanded "${QT_CFLAGS_ARCH_HASWELL}")
         list(APPEND simd_flags_expanded "${QT_CFLAGS_AVX512F}")
         list(APPEND simd_flags_expanded "${QT_CFLAGS_AVX512CD}")
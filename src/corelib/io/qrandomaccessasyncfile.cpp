@@ -0,0 +1,458 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qrandomaccessasyncfile_p_p.h"
+
+#include <QtCore/qfile.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qthreadpool.h>
+#include <QtCore/qwaitcondition.h>
+#include <QtCore/private/qcore_unix_p.h>
+#include <QtCore/private/qsystemerror_p.h>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+    \class QRandomAccessAsyncFile
+    \inmodule QtCore
+
+    \brief The QRandomAccessAsyncFile class reads and writes files at
+    explicit offsets without blocking the calling thread.
+
+    Every call to read() or write() returns a QIOOperation that emits
+    finished() once the data has been transferred. Completions are delivered
+    through the event loop of the thread the file lives in.
+
+    On Linux, operations are handed to the kernel through io_uring(7), and
+    all operations started within the same event loop iteration are
+    submitted with a single system call. When io_uring is not available, or
+    when Backend::ThreadPool is requested explicitly, the operations run as
+    blocking pread(2) and pwrite(2) calls on a dedicated thread pool.
+
+    Closing or destroying the file waits for all outstanding operations.
+*/
+
+/*!
+    \internal
+    \class QIOOperation
+    \inmodule QtCore
+
+    \brief The QIOOperation class represents a single read or write started
+    by QRandomAccessAsyncFile.
+
+    The operation is a child of the file that started it. It can be deleted
+    at any time; an operation deleted before it finished is silently
+    discarded when the transfer completes.
+*/
+
+QIOOperation::QIOOperation(QIOOperationPrivate &dd, QObject *parent)
+    : QObject(dd, parent)
+{
+}
+
+QIOOperation::~QIOOperation()
+    = default;
+
+QIOOperation::Type QIOOperation::type() const
+{
+    Q_D(const QIOOperation);
+    return d->type;
+}
+
+qint64 QIOOperation::offset() const
+{
+    Q_D(const QIOOperation);
+    return d->offset;
+}
+
+/*!
+    Returns the number of bytes read or written. For a read that hit the end
+    of the file this is less than the requested size.
+*/
+qint64 QIOOperation::bytesProcessed() const
+{
+    Q_D(const QIOOperation);
+    return d->processed;
+}
+
+/*!
+    Returns the data that was read, or the data passed to write().
+*/
+QByteArray QIOOperation::data() const
+{
+    Q_D(const QIOOperation);
+    return d->data;
+}
+
+bool QIOOperation::isFinished() const
+{
+    Q_D(const QIOOperation);
+    return d->finished;
+}
+
+QFileDevice::FileError QIOOperation::error() const
+{
+    Q_D(const QIOOperation);
+    return d->error;
+}
+
+QString QIOOperation::errorString() const
+{
+    Q_D(const QIOOperation);
+    return d->errorString;
+}
+
+namespace {
+// The pool runs blocking system calls, so it must not share its threads
+// with QThreadPool::globalInstance() and starve CPU bound work.
+Q_GLOBAL_STATIC(QThreadPool, asyncFileThreadPool)
+
+class QThreadPoolFileBackend final : public QAsyncFileBackend
+{
+public:
+    using QAsyncFileBackend::QAsyncFileBackend;
+
+    void submit(const QAsyncFileRequestPointer &request) override;
+    void waitForFinished() override;
+
+private:
+    void run(const QAsyncFileRequestPointer &request);
+    void deliver();
+
+    QMutex mutex;
+    QWaitCondition allDone;
+    QList<QAsyncFileRequestPointer> completed;
+    int running = 0;
+};
+
+void QThreadPoolFileBackend::submit(const QAsyncFileRequestPointer &request)
+{
+    {
+        QMutexLocker locker(&mutex);
+        ++running;
+    }
+    asyncFileThreadPool()->start([this, request] { run(request); });
+}
+
+void QThreadPoolFileBackend::run(const QAsyncFileRequestPointer &request)
+{
+    QAsyncFileRequest &r = *request;
+    const qint64 size = r.buffer.size();
+    while (r.processed < size) {
+        const qint64 offset = r.offset + r.processed;
+        const size_t count = size_t(size - r.processed);
+        ssize_t result;
+        if (r.type == QIOOperation::Type::Read)
+            EINTR_LOOP(result, ::pread(fd, r.buffer.data() + r.processed, count, off_t(offset)));
+        else
+            EINTR_LOOP(result, ::pwrite(fd, r.buffer.constData() + r.processed, count, off_t(offset)));
+
+        if (result < 0) {
+            r.errorCode = errno;
+            break;
+        }
+        if (result == 0)
+            break;
+        r.processed += result;
+    }
+
+    // Post while holding the mutex: waitForFinished() can only return, and
+    // the backend be destroyed, after this has been done.
+    QMutexLocker locker(&mutex);
+    completed.append(request);
+    if (completed.size() == 1)
+        QMetaObject::invokeMethod(this, [this] { deliver(); }, Qt::QueuedConnection);
+    if (--running == 0)
+        allDone.wakeAll();
+}
+
+void QThreadPoolFileBackend::deliver()
+{
+    // One at a time: a slot connected to QIOOperation::finished() may close
+    // the file, which delivers the rest from waitForFinished() and then
+    // destroys us.
+    const QPointer<QThreadPoolFileBackend> guard(this);
+    forever {
+        QAsyncFileRequestPointer request;
+        {
+            QMutexLocker locker(&mutex);
+            if (completed.isEmpty())
+                return;
+            request = completed.takeFirst();
+        }
+        d->complete(request);
+        if (!guard)
+            return;
+    }
+}
+
+void QThreadPoolFileBackend::waitForFinished()
+{
+    {
+        QMutexLocker locker(&mutex);
+        while (running)
+            allDone.wait(&mutex);
+    }
+    deliver();
+}
+} // unnamed namespace
+
+/*!
+    Constructs a file object with the given \a parent, using the best
+    backend available.
+*/
+QRandomAccessAsyncFile::QRandomAccessAsyncFile(QObject *parent)
+    : QRandomAccessAsyncFile(Backend::Automatic, parent)
+{
+}
+
+/*!
+    Constructs a file object with the given \a parent that uses \a backend.
+    If \a backend is not available, open() falls back to Backend::ThreadPool.
+*/
+QRandomAccessAsyncFile::QRandomAccessAsyncFile(Backend backend, QObject *parent)
+    : QObject(*new QRandomAccessAsyncFilePrivate(backend), parent)
+{
+}
+
+QRandomAccessAsyncFile::~QRandomAccessAsyncFile()
+{
+    close();
+}
+
+/*!
+    Returns the backend used by the open file, or Backend::Automatic if the
+    file is not open.
+*/
+QRandomAccessAsyncFile::Backend QRandomAccessAsyncFile::backend() const
+{
+    Q_D(const QRandomAccessAsyncFile);
+    return d->activeBackend;
+}
+
+/*!
+    Opens \a fileName with the given \a mode. Since all accesses specify an
+    offset, QIODevice::Append and QIODevice::Text are ignored; the file is
+    only truncated if QIODevice::Truncate is set.
+*/
+bool QRandomAccessAsyncFile::open(const QString &fileName, QIODeviceBase::OpenMode mode)
+{
+    Q_D(QRandomAccessAsyncFile);
+    if (d->fd >= 0) {
+        qWarning("QRandomAccessAsyncFile::open: File (%ls) already open", qUtf16Printable(fileName));
+        return false;
+    }
+
+    int flags;
+    if ((mode & QIODevice::ReadWrite) == QIODevice::ReadWrite)
+        flags = QT_OPEN_RDWR;
+    else if (mode & QIODevice::WriteOnly)
+        flags = QT_OPEN_WRONLY;
+    else
+        flags = QT_OPEN_RDONLY;
+
+    if (mode & QIODevice::WriteOnly) {
+        if (!(mode & QIODevice::ExistingOnly))
+            flags |= QT_OPEN_CREAT;
+        if (mode & QIODevice::NewOnly)
+            flags |= QT_OPEN_EXCL;
+        if (mode & QIODevice::Truncate)
+            flags |= QT_OPEN_TRUNC;
+    }
+
+    const QByteArray nativeName = QFile::encodeName(fileName);
+    d->fd = qt_safe_open(nativeName.constData(), flags, 0666);
+    if (d->fd < 0) {
+        d->setError(QFileDevice::OpenError, errno);
+        return false;
+    }
+
+#if QT_CONFIG(io_uring)
+    if (d->requestedBackend != Backend::ThreadPool) {
+        d->backend = qt_createIoUringFileBackend(d->fd, d);
+        if (d->backend)
+            d->activeBackend = Backend::IoUring;
+    }
+#endif
+    if (!d->backend) {
+        d->backend = std::make_unique<QThreadPoolFileBackend>(d->fd, d);
+        d->activeBackend = Backend::ThreadPool;
+    }
+
+    d->error = QFileDevice::NoError;
+    d->errorString.clear();
+    return true;
+}
+
+/*!
+    Waits for all outstanding operations to finish, then closes the file.
+*/
+void QRandomAccessAsyncFile::close()
+{
+    Q_D(QRandomAccessAsyncFile);
+    if (d->fd < 0)
+        return;
+
+    d->backend->waitForFinished();
+    if (d->fd < 0)
+        return; // closed from a slot connected to QIOOperation::finished()
+    d->backend.reset();
+    qt_safe_close(d->fd);
+    d->fd = -1;
+    d->activeBackend = Backend::Automatic;
+}
+
+bool QRandomAccessAsyncFile::isOpen() const
+{
+    Q_D(const QRandomAccessAsyncFile);
+    return d->fd >= 0;
+}
+
+/*!
+    Returns the current size of the file, or -1 if it is not open.
+*/
+qint64 QRandomAccessAsyncFile::size() const
+{
+    Q_D(const QRandomAccessAsyncFile);
+    if (d->fd < 0)
+        return -1;
+
+    QT_STATBUF st;
+    if (QT_FSTAT(d->fd, &st) == -1)
+        return -1;
+    return st.st_size;
+}
+
+QFileDevice::FileError QRandomAccessAsyncFile::error() const
+{
+    Q_D(const QRandomAccessAsyncFile);
+    return d->error;
+}
+
+QString QRandomAccessAsyncFile::errorString() const
+{
+    Q_D(const QRandomAccessAsyncFile);
+    return d->errorString;
+}
+
+/*!
+    Starts reading up to \a maxSize bytes at \a offset and returns the
+    operation tracking the read, or \nullptr if the file is not open.
+*/
+QIOOperation *QRandomAccessAsyncFile::read(qint64 offset, qint64 maxSize)
+{
+    Q_D(QRandomAccessAsyncFile);
+    if (offset < 0 || maxSize < 0) {
+        qWarning("QRandomAccessAsyncFile::read: Invalid offset or size");
+        return nullptr;
+    }
+    return d->start(QIOOperation::Type::Read, offset, QByteArray(maxSize, Qt::Uninitialized));
+}
+
+/*!
+    Starts writing \a data at \a offset and returns the operation tracking
+    the write, or \nullptr if the file is not open.
+*/
+QIOOperation *QRandomAccessAsyncFile::write(qint64 offset, const QByteArray &data)
+{
+    Q_D(QRandomAccessAsyncFile);
+    if (offset < 0) {
+        qWarning("QRandomAccessAsyncFile::write: Invalid offset");
+        return nullptr;
+    }
+    return d->start(QIOOperation::Type::Write, offset, data);
+}
+
+QIOOperation *QRandomAccessAsyncFilePrivate::start(QIOOperation::Type type, qint64 offset,
+                                                    const QByteArray &buffer)
+{
+    Q_Q(QRandomAccessAsyncFile);
+    if (fd < 0) {
+        qWarning("QRandomAccessAsyncFile: File not open");
+        return nullptr;
+    }
+
+    auto *operation = new QIOOperation(*new QIOOperationPrivate(type, offset), q);
+    if (type == QIOOperation::Type::Write)
+        operation->d_func()->data = buffer;
+
+    auto request = QAsyncFileRequestPointer::create();
+    request->type = type;
+    request->offset = offset;
+    request->buffer = buffer;
+    request->operation = operation;
+    backend->submit(request);
+    return operation;
+}
+
+void QRandomAccessAsyncFilePrivate::complete(const QAsyncFileRequestPointer &request)
+{
+    QIOOperation *operation = request->operation;
+    if (!operation)
+        return;
+
+    QIOOperationPrivate *od = operation->d_func();
+    od->processed = request->processed;
+    if (request->type == QIOOperation::Type::Read) {
+        request->buffer.truncate(request->processed);
+        od->data = std::move(request->buffer);
+    }
+    if (request->errorCode) {
+        od->error = request->type == QIOOperation::Type::Read ? QFileDevice::ReadError
+                                                              : QFileDevice::WriteError;
+        od->errorString = QSystemError::stdString(request->errorCode);
+    }
+    od->finished = true;
+    emit operation->finished();
+}
+
+void QRandomAccessAsyncFilePrivate::setError(QFileDevice::FileError err, int errorCode)
+{
+    error = err;
+    errorString = QSystemError::stdString(errorCode);
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qrandomaccessasyncfile_p.cpp"
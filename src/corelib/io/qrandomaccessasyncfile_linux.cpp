@@ -0,0 +1,395 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qrandomaccessasyncfile_p_p.h"
+
+#include <QtCore/qhash.h>
+#include <QtCore/qsocketnotifier.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qtimer.h>
+#include <QtCore/private/qcore_unix_p.h>
+
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+// io_uring has no glibc wrappers, and we don't want to depend on liburing
+// for the handful of calls we need.
+static int io_uring_setup(unsigned entries, io_uring_params *p)
+{
+    return int(syscall(__NR_io_uring_setup, entries, p));
+}
+
+static int io_uring_enter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+{
+    return int(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+static int io_uring_register(int fd, unsigned opcode, const void *arg, unsigned nrArgs)
+{
+    return int(syscall(__NR_io_uring_register, fd, opcode, arg, nrArgs));
+}
+
+class QIoUringFileBackend final : public QAsyncFileBackend
+{
+public:
+    using QAsyncFileBackend::QAsyncFileBackend;
+    ~QIoUringFileBackend();
+
+    bool init();
+
+    void submit(const QAsyncFileRequestPointer &request) override;
+    void waitForFinished() override;
+
+private:
+    // a single read or write is limited to what fits into io_uring_sqe::len
+    static constexpr qint64 MaxChunkSize = 1 << 30;
+    static constexpr unsigned QueueDepth = 64;
+
+    bool flush();
+    bool submitQueued();
+    void failRing(int errorCode);
+    void waitForCompletion();
+    bool reap();
+    bool deliverCompleted();
+    void queue(const QAsyncFileRequestPointer &request);
+
+    QHash<quint64, QAsyncFileRequestPointer> inFlight;
+    // the IDs of the entries in the submission queue that the kernel has not
+    // taken yet, oldest first
+    QList<quint64> unsubmitted;
+    QList<QAsyncFileRequestPointer> pending;
+    QList<QAsyncFileRequestPointer> completed;
+    QSocketNotifier *notifier = nullptr;
+    quint64 nextId = 0;
+    bool flushScheduled = false;
+    // set when io_uring_enter() failed for good; nothing is submitted after that
+    bool broken = false;
+
+    int ringFd = -1;
+    int eventFd = -1;
+    unsigned sqEntries = 0;
+
+    void *ring = MAP_FAILED;
+    size_t ringSize = 0;
+    io_uring_sqe *sqes = static_cast<io_uring_sqe *>(MAP_FAILED);
+    size_t sqesSize = 0;
+
+    unsigned *sqTail = nullptr;
+    unsigned *sqMask = nullptr;
+    unsigned *sqArray = nullptr;
+    unsigned *cqHead = nullptr;
+    unsigned *cqTail = nullptr;
+    unsigned *cqMask = nullptr;
+    io_uring_cqe *cqes = nullptr;
+};
+
+QIoUringFileBackend::~QIoUringFileBackend()
+{
+    Q_ASSERT(inFlight.isEmpty());
+    // we may be destroyed from a slot connected to QIOOperation::finished(),
+    // while the notifier is still delivering its activation
+    if (notifier) {
+        notifier->setEnabled(false);
+        notifier->deleteLater();
+    }
+    if (sqes != MAP_FAILED)
+        munmap(sqes, sqesSize);
+    if (ring != MAP_FAILED)
+        munmap(ring, ringSize);
+    if (eventFd >= 0)
+        qt_safe_close(eventFd);
+    if (ringFd >= 0)
+        qt_safe_close(ringFd);
+}
+
+bool QIoUringFileBackend::init()
+{
+    io_uring_params params = {};
+    ringFd = io_uring_setup(QueueDepth, &params);
+    if (ringFd < 0)
+        return false;
+
+    // IORING_OP_READ and IORING_OP_WRITE appeared together with
+    // IORING_FEAT_RW_CUR_POS in Linux 5.6
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_RW_CUR_POS))
+        return false;
+
+    sqEntries = params.sq_entries;
+    ringSize = qMax(params.sq_off.array + params.sq_entries * sizeof(unsigned),
+                    params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+    ring = mmap(nullptr, ringSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                ringFd, IORING_OFF_SQ_RING);
+    if (ring == MAP_FAILED)
+        return false;
+
+    sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    sqes = static_cast<io_uring_sqe *>(mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE,
+                                            MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES));
+    if (sqes == MAP_FAILED)
+        return false;
+
+    char *base = static_cast<char *>(ring);
+    sqTail = reinterpret_cast<unsigned *>(base + params.sq_off.tail);
+    sqMask = reinterpret_cast<unsigned *>(base + params.sq_off.ring_mask);
+    sqArray = reinterpret_cast<unsigned *>(base + params.sq_off.array);
+    cqHead = reinterpret_cast<unsigned *>(base + params.cq_off.head);
+    cqTail = reinterpret_cast<unsigned *>(base + params.cq_off.tail);
+    cqMask = reinterpret_cast<unsigned *>(base + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe *>(base + params.cq_off.cqes);
+
+    eventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (eventFd < 0 || io_uring_register(ringFd, IORING_REGISTER_EVENTFD, &eventFd, 1) < 0)
+        return false;
+
+    notifier = new QSocketNotifier(eventFd, QSocketNotifier::Read);
+    QObject::connect(notifier, &QSocketNotifier::activated, this, [this] {
+        eventfd_t value;
+        eventfd_read(eventFd, &value);
+        if (reap())
+            flush();
+    });
+    return true;
+}
+
+void QIoUringFileBackend::submit(const QAsyncFileRequestPointer &request)
+{
+    pending.append(request);
+
+    // Everything started from the current event loop iteration goes to the
+    // kernel with a single io_uring_enter() call.
+    if (!flushScheduled) {
+        flushScheduled = true;
+        QMetaObject::invokeMethod(this, [this] { flush(); }, Qt::QueuedConnection);
+    }
+}
+
+void QIoUringFileBackend::queue(const QAsyncFileRequestPointer &request)
+{
+    const quint64 id = nextId++;
+    const qint64 remaining = request->buffer.size() - request->processed;
+
+    const unsigned tail = *sqTail;
+    const unsigned index = tail & *sqMask;
+    io_uring_sqe *sqe = &sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->fd = fd;
+    sqe->off = quint64(request->offset + request->processed);
+    sqe->len = quint32(qMin(remaining, MaxChunkSize));
+    sqe->user_data = id;
+    if (request->type == QIOOperation::Type::Read) {
+        sqe->opcode = IORING_OP_READ;
+        sqe->addr = quintptr(request->buffer.data() + request->processed);
+    } else {
+        sqe->opcode = IORING_OP_WRITE;
+        sqe->addr = quintptr(request->buffer.constData() + request->processed);
+    }
+    sqArray[index] = index;
+
+    // publish the entry before the kernel can see the new tail
+    __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+    unsubmitted.append(id);
+
+    inFlight.insert(id, request);
+}
+
+// Returns false if the backend was destroyed by a slot connected to
+// QIOOperation::finished().
+bool QIoUringFileBackend::flush()
+{
+    flushScheduled = false;
+    if (broken)
+        return deliverCompleted();
+
+    // cap the number of operations in flight so that the completion queue
+    // (twice the size of the submission queue) can never overflow
+    while (!pending.isEmpty() && inFlight.size() < qsizetype(sqEntries))
+        queue(pending.takeFirst());
+
+    if (!submitQueued())
+        return deliverCompleted();
+    return true;
+}
+
+// Hands the queued entries to the kernel. Returns false, after failing every
+// request that the kernel does not own, if the ring cannot be used any more.
+bool QIoUringFileBackend::submitQueued()
+{
+    while (!unsubmitted.isEmpty()) {
+        const int submitted = io_uring_enter(ringFd, unsigned(unsubmitted.size()), 0, 0);
+        if (submitted < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EBUSY) {
+                // Completions trigger another flush, but if the kernel owns
+                // none of our operations, none will arrive.
+                if (inFlight.size() == unsubmitted.size() && !flushScheduled) {
+                    flushScheduled = true;
+                    QTimer::singleShot(0, this, [this] { flush(); });
+                }
+                return true;
+            }
+            const int errorCode = errno;
+            qErrnoWarning("QRandomAccessAsyncFile: io_uring_enter failed");
+            failRing(errorCode);
+            return false;
+        }
+        // the kernel takes the entries in order
+        unsubmitted.remove(0, qMin(qsizetype(submitted), unsubmitted.size()));
+    }
+    return true;
+}
+
+// Fails the requests that were not handed to the kernel and stops using the
+// ring. The operations the kernel owns still complete normally.
+void QIoUringFileBackend::failRing(int errorCode)
+{
+    broken = true;
+    for (quint64 id : qAsConst(unsubmitted)) {
+        const QAsyncFileRequestPointer request = inFlight.take(id);
+        request->errorCode = errorCode;
+        completed.append(request);
+    }
+    unsubmitted.clear();
+    for (const QAsyncFileRequestPointer &request : qAsConst(pending)) {
+        request->errorCode = errorCode;
+        completed.append(request);
+    }
+    pending.clear();
+}
+
+// Blocks until at least one operation owned by the kernel has completed.
+void QIoUringFileBackend::waitForCompletion()
+{
+    if (io_uring_enter(ringFd, 0, 1, IORING_ENTER_GETEVENTS) >= 0 || errno == EINTR)
+        return;
+
+    // The kernel keeps writing into the buffers of our operations whether we
+    // can wait for them with the ring or not, and it signals every completion
+    // through the eventfd.
+    pollfd pfd = qt_make_pollfd(eventFd, POLLIN);
+    if (qt_safe_poll(&pfd, 1, nullptr) > 0) {
+        eventfd_t value;
+        eventfd_read(eventFd, &value);
+    }
+}
+
+// Returns false if the backend was destroyed by a slot connected to
+// QIOOperation::finished().
+bool QIoUringFileBackend::reap()
+{
+    unsigned head = *cqHead;
+    const unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+    for ( ; head != tail; ++head) {
+        const io_uring_cqe &cqe = cqes[head & *cqMask];
+        const QAsyncFileRequestPointer request = inFlight.take(cqe.user_data);
+        Q_ASSERT(request);
+
+        const qint64 requested = qMin(request->buffer.size() - request->processed, MaxChunkSize);
+        if (cqe.res < 0) {
+            request->errorCode = -cqe.res;
+        } else {
+            request->processed += cqe.res;
+            // a short read means end of file, unless we split the request
+            // ourselves; writes are short only if the kernel says so
+            const bool more = request->processed < request->buffer.size()
+                    && (request->type == QIOOperation::Type::Write ? cqe.res > 0
+                                                                    : cqe.res == requested);
+            if (more && !broken) {
+                pending.prepend(request);
+                continue;
+            }
+            if (more)
+                request->errorCode = EIO;
+        }
+        completed.append(request);
+    }
+    __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+
+    return deliverCompleted();
+}
+
+// Only emit once the ring is consistent again. A slot may close the file,
+// which delivers the rest of the list from waitForFinished() before
+// destroying us. Returns false if that happened.
+bool QIoUringFileBackend::deliverCompleted()
+{
+    const QPointer<QIoUringFileBackend> guard(this);
+    while (!completed.isEmpty()) {
+        d->complete(completed.takeFirst());
+        if (!guard)
+            return false;
+    }
+    return true;
+}
+
+void QIoUringFileBackend::waitForFinished()
+{
+    // completed may be non-empty if we are called from a finished() slot
+    while (!inFlight.isEmpty() || !pending.isEmpty() || !completed.isEmpty()) {
+        if (!flush())
+            return;
+        if (inFlight.size() > unsubmitted.size()) {
+            waitForCompletion();
+        } else if (!unsubmitted.isEmpty()) {
+            // the kernel is short of resources and owns none of our
+            // operations, so there is nothing to wait for but time
+            QThread::msleep(1);
+        }
+        if (!reap())
+            return;
+    }
+}
+} // unnamed namespace
+
+std::unique_ptr<QAsyncFileBackend> qt_createIoUringFileBackend(int fd, QRandomAccessAsyncFilePrivate *d)
+{
+    auto backend = std::make_unique<QIoUringFileBackend>(fd, d);
+    if (!backend->init())
+        return nullptr;
+    return backend;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,135 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QRANDOMACCESSASYNCFILE_P_H
+#define QRANDOMACCESSASYNCFILE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qfiledevice.h>
+#include <QtCore/qobject.h>
+
+QT_REQUIRE_CONFIG(thread);
+
+QT_BEGIN_NAMESPACE
+
+class QRandomAccessAsyncFilePrivate;
+class QIOOperationPrivate;
+
+class Q_CORE_EXPORT QIOOperation : public QObject
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(QIOOperation)
+
+public:
+    enum class Type {
+        Read,
+        Write
+    };
+    Q_ENUM(Type)
+
+    ~QIOOperation() override;
+
+    Type type() const;
+    qint64 offset() const;
+    qint64 bytesProcessed() const;
+    QByteArray data() const;
+
+    bool isFinished() const;
+    QFileDevice::FileError error() const;
+    QString errorString() const;
+
+Q_SIGNALS:
+    void finished();
+
+private:
+    explicit QIOOperation(QIOOperationPrivate &dd, QObject *parent);
+
+    friend class QRandomAccessAsyncFilePrivate;
+    Q_DISABLE_COPY(QIOOperation)
+};
+
+class Q_CORE_EXPORT QRandomAccessAsyncFile : public QObject
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(QRandomAccessAsyncFile)
+
+public:
+    enum class Backend {
+        Automatic,
+        IoUring,
+        ThreadPool
+    };
+    Q_ENUM(Backend)
+
+    explicit QRandomAccessAsyncFile(QObject *parent = nullptr);
+    explicit QRandomAccessAsyncFile(Backend backend, QObject *parent = nullptr);
+    ~QRandomAccessAsyncFile() override;
+
+    Backend backend() const;
+
+    bool open(const QString &fileName, QIODeviceBase::OpenMode mode);
+    void close();
+    bool isOpen() const;
+    qint64 size() const;
+
+    QFileDevice::FileError error() const;
+    QString errorString() const;
+
+    QIOOperation *read(qint64 offset, qint64 maxSize);
+    QIOOperation *write(qint64 offset, const QByteArray &data);
+
+private:
+    Q_DISABLE_COPY(QRandomAccessAsyncFile)
+};
+
+QT_END_NAMESPACE
+
+#endif // QRANDOMACCESSASYNCFILE_P_H
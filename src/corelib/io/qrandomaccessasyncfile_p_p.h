@@ -0,0 +1,140 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QRANDOMACCESSASYNCFILE_P_P_H
+#define QRANDOMACCESSASYNCFILE_P_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qrandomaccessasyncfile_p.h"
+
+#include <QtCore/private/qobject_p.h>
+#include <QtCore/qpointer.h>
+#include <QtCore/qsharedpointer.h>
+
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+struct QAsyncFileRequest
+{
+    QIOOperation::Type type;
+    qint64 offset;
+    QByteArray buffer; // destination of a read, payload of a write
+    qint64 processed = 0;
+    int errorCode = 0; // errno of the failing call
+    QPointer<QIOOperation> operation;
+};
+using QAsyncFileRequestPointer = QSharedPointer<QAsyncFileRequest>;
+
+class QAsyncFileBackend : public QObject
+{
+public:
+    QAsyncFileBackend(int fd, QRandomAccessAsyncFilePrivate *d)
+        : fd(fd), d(d)
+    { }
+
+    virtual void submit(const QAsyncFileRequestPointer &request) = 0;
+
+    // Blocks until every submitted request has completed and was handed
+    // back through QRandomAccessAsyncFilePrivate::complete().
+    virtual void waitForFinished() = 0;
+
+protected:
+    const int fd;
+    QRandomAccessAsyncFilePrivate *const d;
+};
+
+#if QT_CONFIG(io_uring)
+// returns nullptr if io_uring is not usable on the running kernel
+std::unique_ptr<QAsyncFileBackend> qt_createIoUringFileBackend(int fd, QRandomAccessAsyncFilePrivate *d);
+#endif
+
+class QIOOperationPrivate : public QObjectPrivate
+{
+    Q_DECLARE_PUBLIC(QIOOperation)
+
+public:
+    QIOOperationPrivate(QIOOperation::Type type, qint64 offset)
+        : type(type), offset(offset)
+    { }
+
+    QIOOperation::Type type;
+    qint64 offset;
+    qint64 processed = 0;
+    QByteArray data;
+    QString errorString;
+    QFileDevice::FileError error = QFileDevice::NoError;
+    bool finished = false;
+};
+
+class QRandomAccessAsyncFilePrivate : public QObjectPrivate
+{
+    Q_DECLARE_PUBLIC(QRandomAccessAsyncFile)
+
+public:
+    explicit QRandomAccessAsyncFilePrivate(QRandomAccessAsyncFile::Backend backend)
+        : requestedBackend(backend)
+    { }
+
+    QIOOperation *start(QIOOperation::Type type, qint64 offset, const QByteArray &buffer);
+    void complete(const QAsyncFileRequestPointer &request);
+    void setError(QFileDevice::FileError err, int errorCode);
+
+    std::unique_ptr<QAsyncFileBackend> backend;
+    QString errorString;
+    QRandomAccessAsyncFile::Backend requestedBackend;
+    QRandomAccessAsyncFile::Backend activeBackend = QRandomAccessAsyncFile::Backend::Automatic;
+    QFileDevice::FileError error = QFileDevice::NoError;
+    int fd = -1;
+};
+
+QT_END_NAMESPACE
+
+#endif // QRANDOMACCESSASYNCFILE_P_P_H
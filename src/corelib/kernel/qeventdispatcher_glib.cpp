@@ -146,7 +146,8 @@ static gboolean timerSourceCheckHelper(GTimerSource *src)
         || (src->processEventsFlags & QEventLoop::X11ExcludeTimers))
         return false;
 
-    if (src->timerList.updateCurrentTime() < src->timerList.constFirst()->timeout)
+    timespec tv = { 0l, 0l };
+    if (!src->timerList.timerWait(tv) || tv.tv_sec || tv.tv_nsec)
         return false;
 
     return true;
@@ -55,10 +55,16 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <limits>
+
 #ifndef QT_NO_EVENTFD
 #  include <sys/eventfd.h>
 #endif
 
+#if QT_CONFIG(epoll)
+#  include <sys/epoll.h>
+#endif
+
 // VxWorks doesn't correctly set the _POSIX_... options
 #if defined(Q_OS_VXWORKS)
 #  if defined(_POSIX_MONOTONIC_CLOCK) && (_POSIX_MONOTONIC_CLOCK <= 0)
@@ -226,10 +232,34 @@ QEventDispatcherUNIXPrivate::QEventDispatcherUNIXPrivate()
 {
     if (Q_UNLIKELY(threadPipe.init() == false))
         qFatal("QEventDispatcherUNIXPrivate(): Cannot continue without a thread pipe");
+
+#if QT_CONFIG(epoll)
+    if (qEnvironmentVariableIntValue("QT_EVENT_DISPATCHER_EPOLL") > 0) {
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (epollFd == -1) {
+            perror("QEventDispatcherUNIXPrivate: Unable to create epoll instance, using poll");
+            return;
+        }
+
+        epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.fd = threadPipe.fds[0];
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, threadPipe.fds[0], &ev) == -1) {
+            perror("QEventDispatcherUNIXPrivate: Unable to watch thread pipe, using poll");
+            qt_safe_close(epollFd);
+            epollFd = -1;
+        }
+    }
+#endif
 }
 
 QEventDispatcherUNIXPrivate::~QEventDispatcherUNIXPrivate()
 {
+#if QT_CONFIG(epoll)
+    if (epollFd >= 0)
+        qt_safe_close(epollFd);
+#endif
+
     // cleanup timers
     qDeleteAll(timerList);
 }
@@ -255,38 +285,45 @@ void QEventDispatcherUNIXPrivate::markPendingSocketNotifiers()
         if (pfd.fd < 0 || pfd.revents == 0)
             continue;
 
-        auto it = socketNotifiers.find(pfd.fd);
-        Q_ASSERT(it != socketNotifiers.end());
+        Q_ASSERT(socketNotifiers.contains(pfd.fd));
+        markPendingSocketNotifiers(pfd.fd, pfd.revents);
+    }
+
+    pollfds.clear();
+}
 
-        const QSocketNotifierSetUNIX &sn_set = it.value();
+void QEventDispatcherUNIXPrivate::markPendingSocketNotifiers(int fd, short revents)
+{
+    auto it = socketNotifiers.find(fd);
+    if (it == socketNotifiers.end())
+        return;
 
-        static const struct {
-            QSocketNotifier::Type type;
-            short flags;
-        } notifiers[] = {
-            { QSocketNotifier::Read,      POLLIN  | POLLHUP | POLLERR },
-            { QSocketNotifier::Write,     POLLOUT | POLLHUP | POLLERR },
-            { QSocketNotifier::Exception, POLLPRI | POLLHUP | POLLERR }
-        };
+    const QSocketNotifierSetUNIX &sn_set = it.value();
 
-        for (const auto &n : notifiers) {
-            QSocketNotifier *notifier = sn_set.notifiers[n.type];
+    static const struct {
+        QSocketNotifier::Type type;
+        short flags;
+    } notifiers[] = {
+        { QSocketNotifier::Read,      POLLIN  | POLLHUP | POLLERR },
+        { QSocketNotifier::Write,     POLLOUT | POLLHUP | POLLERR },
+        { QSocketNotifier::Exception, POLLPRI | POLLHUP | POLLERR }
+    };
 
-            if (!notifier)
-                continue;
+    for (const auto &n : notifiers) {
+        QSocketNotifier *notifier = sn_set.notifiers[n.type];
 
-            if (pfd.revents & POLLNVAL) {
-                qWarning("QSocketNotifier: Invalid socket %d with type %s, disabling...",
-                         it.key(), socketType(n.type));
-                notifier->setEnabled(false);
-            }
+        if (!notifier)
+            continue;
 
-            if (pfd.revents & n.flags)
-                setSocketNotifierPending(notifier);
+        if (revents & POLLNVAL) {
+            qWarning("QSocketNotifier: Invalid socket %d with type %s, disabling...",
+                     it.key(), socketType(n.type));
+            notifier->setEnabled(false);
         }
-    }
 
-    pollfds.clear();
+        if (revents & n.flags)
+            setSocketNotifierPending(notifier);
+    }
 }
 
 int QEventDispatcherUNIXPrivate::activateSocketNotifiers()
@@ -308,6 +345,120 @@ int QEventDispatcherUNIXPrivate::activateSocketNotifiers()
     return n_activated;
 }
 
+#if QT_CONFIG(epoll)
+static inline uint32_t toEpollEvents(short events)
+{
+    uint32_t result = 0;
+    if (events & POLLIN)
+        result |= EPOLLIN;
+    if (events & POLLOUT)
+        result |= EPOLLOUT;
+    if (events & POLLPRI)
+        result |= EPOLLPRI;
+    return result;
+}
+
+static inline short toPollEvents(uint32_t events)
+{
+    short result = 0;
+    if (events & EPOLLIN)
+        result |= POLLIN;
+    if (events & EPOLLOUT)
+        result |= POLLOUT;
+    if (events & EPOLLPRI)
+        result |= POLLPRI;
+    if (events & EPOLLHUP)
+        result |= POLLHUP;
+    if (events & EPOLLERR)
+        result |= POLLERR;
+    return result;
+}
+
+/*
+    Synchronizes the kernel's interest list for \a fd with the notifiers
+    currently registered for it. Unlike the poll() path, which rebuilds the
+    whole descriptor set on every iteration, this is only called when a
+    notifier is enabled or disabled.
+*/
+void QEventDispatcherUNIXPrivate::updateEpollRegistration(int fd)
+{
+    const auto it = socketNotifiers.constFind(fd);
+    if (it == socketNotifiers.cend()) {
+        // the descriptor may already be closed, in which case the kernel
+        // has dropped it from the interest list and this fails with EBADF
+        if (!epollFallbackFds.removeOne(fd))
+            epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        return;
+    }
+
+    if (epollFallbackFds.contains(fd))
+        return;
+
+    epoll_event ev = {};
+    ev.events = toEpollEvents(it.value().events());
+    ev.data.fd = fd;
+
+    if (epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev) == 0)
+        return;
+    if (errno == ENOENT && epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) == 0)
+        return;
+
+    // epoll refuses regular files (EPERM) and invalid descriptors (EBADF);
+    // hand those to poll() so that they keep reporting ready or POLLNVAL
+    epollFallbackFds.append(fd);
+}
+
+int QEventDispatcherUNIXPrivate::epollProcessEvents(timespec *tm)
+{
+    timespec zero_tm = { 0, 0 };
+
+    // Descriptors that epoll cannot watch (regular files) are polled along
+    // with the epoll descriptor itself, which becomes readable when epoll has
+    // events, so that waiting for either one honors the timeout.
+    pollfds.clear();
+    if (!epollFallbackFds.isEmpty()) {
+        for (int fd : qAsConst(epollFallbackFds))
+            pollfds.append(qt_make_pollfd(fd, socketNotifiers.value(fd).events()));
+        pollfds.append(qt_make_pollfd(epollFd, POLLIN));
+        if (qt_safe_poll(pollfds.data(), pollfds.size(), tm) == -1)
+            perror("qt_safe_poll");
+        pollfds.removeLast(); // the epoll descriptor is not a socket notifier
+        tm = &zero_tm;
+    }
+
+    int timeout = -1;
+    if (tm) {
+        // round up, so that we don't wake up just before the next timer expires
+        const qint64 msecs = qint64(tm->tv_sec) * 1000 + (tm->tv_nsec + 999999) / 1000000;
+        timeout = int(qMin(msecs, qint64(std::numeric_limits<int>::max())));
+    }
+
+    epoll_event events[256];
+    int ready;
+    EINTR_LOOP(ready, epoll_wait(epollFd, events, int(std::size(events)), timeout));
+    if (ready == -1) {
+        perror("epoll_wait");
+        ready = 0;
+    }
+
+    int nevents = 0;
+    for (int i = 0; i < ready; ++i) {
+        const int fd = events[i].data.fd;
+        const short revents = toPollEvents(events[i].events);
+        if (fd == threadPipe.fds[0]) {
+            pollfd pfd = threadPipe.prepare();
+            pfd.revents = revents;
+            nevents += threadPipe.check(pfd);
+        } else {
+            markPendingSocketNotifiers(fd, revents);
+        }
+    }
+
+    // also marks the poll() fallback descriptors
+    return nevents + activateSocketNotifiers();
+}
+#endif // QT_CONFIG(epoll)
+
 QEventDispatcherUNIX::QEventDispatcherUNIX(QObject *parent)
     : QAbstractEventDispatcher(*new QEventDispatcherUNIXPrivate, parent)
 { }
@@ -412,6 +563,11 @@ void QEventDispatcherUNIX::registerSocketNotifier(QSocketNotifier *notifier)
                  Q_FUNC_INFO, sockfd, socketType(type));
 
     sn_set.notifiers[type] = notifier;
+
+#if QT_CONFIG(epoll)
+    if (d->epollFd >= 0)
+        d->updateEpollRegistration(sockfd);
+#endif
 }
 
 void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
@@ -454,6 +610,11 @@ void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
 
     if (sn_set.isEmpty())
         d->socketNotifiers.erase(i);
+
+#if QT_CONFIG(epoll)
+    if (d->epollFd >= 0)
+        d->updateEpollRegistration(sockfd);
+#endif
 }
 
 bool QEventDispatcherUNIX::processEvents(QEventLoop::ProcessEventsFlags flags)
@@ -487,6 +648,19 @@ bool QEventDispatcherUNIX::processEvents(QEventLoop::ProcessEventsFlags flags)
     if (!canWait || (include_timers && d->timerList.timerWait(wait_tm)))
         tm = &wait_tm;
 
+    int nevents = 0;
+
+#if QT_CONFIG(epoll)
+    // the epoll interest list always contains all enabled notifiers, so
+    // fall back to poll() on the thread pipe alone if they're excluded
+    if (d->epollFd >= 0 && include_notifiers) {
+        nevents += d->epollProcessEvents(tm);
+        if (include_timers)
+            nevents += d->activateTimers();
+        return (nevents > 0);
+    }
+#endif
+
     d->pollfds.clear();
     d->pollfds.reserve(1 + (include_notifiers ? d->socketNotifiers.size() : 0));
 
@@ -497,8 +671,6 @@ bool QEventDispatcherUNIX::processEvents(QEventLoop::ProcessEventsFlags flags)
     // This must be last, as it's popped off the end below
     d->pollfds.append(d->threadPipe.prepare());
 
-    int nevents = 0;
-
     switch (qt_safe_poll(d->pollfds.data(), d->pollfds.size(), tm)) {
     case -1:
         perror("qt_safe_poll");
@@ -135,12 +135,25 @@ public:
     int activateTimers();
 
     void markPendingSocketNotifiers();
+    void markPendingSocketNotifiers(int fd, short revents);
     int activateSocketNotifiers();
     void setSocketNotifierPending(QSocketNotifier *notifier);
 
+#if QT_CONFIG(epoll)
+    void updateEpollRegistration(int fd);
+    int epollProcessEvents(timespec *tm);
+#endif
+
     QThreadPipe threadPipe;
     QList<pollfd> pollfds;
 
+#if QT_CONFIG(epoll)
+    // opt-in epoll(7) backend, see QT_EVENT_DISPATCHER_EPOLL
+    int epollFd = -1;
+    // descriptors epoll refuses to watch (e.g. regular files)
+    QList<int> epollFallbackFds;
+#endif
+
     QHash<int, QSocketNotifierSetUNIX> socketNotifiers;
     QList<QSocketNotifier *> pendingNotifiers;
 
@@ -53,15 +53,49 @@
 
 #include <sys/times.h>
 
+#include <algorithm>
+#include <limits>
+
 QT_BEGIN_NAMESPACE
 
 Q_CORE_EXPORT bool qt_disable_lowpriority_timers=false;
 
 /*
- * Internal functions for manipulating timer data structures.  The
- * timerBitVec array is used for keeping track of timer identifiers.
+ * Internal functions for manipulating timer data structures.
+ *
+ * Timers are kept in a hierarchical timing wheel indexed by their timeout
+ * in milliseconds. Level n of the wheel has WheelSize slots covering
+ * WheelSize^n milliseconds each. A timer is stored on the lowest level on
+ * which its timeout and wheelTime only differ in that level's digit, so
+ * the slots up to and including wheelTime's own are always empty. When
+ * wheelTime reaches a slot, its timers are moved down to a lower level, or
+ * to dueTimers once they expire within wheelTime's millisecond. Timers
+ * that are too far ahead wait in the overflow slot.
+ *
+ * dueTimers is a binary heap rather than a sorted list, so that timers can
+ * still be added and removed quickly when a lot of them are overdue at
+ * once. Inserting and removing timers in the wheel takes constant time,
+ * and every timer is moved at most WheelLevels times before it fires. The
+ * exact timeout is kept in QTimerInfo, so the wheel does not affect the
+ * precision. Coarse timers are rounded to shared boundaries before they
+ * get inserted (see calculateCoarseTimerTimeout()), so they end up in the
+ * same slots and are moved down and fired in batches.
  */
 
+static inline quint64 toTick(const timespec &t)
+{
+    return quint64(t.tv_sec) * 1000 + quint64(t.tv_nsec) / (1000 * 1000);
+}
+
+static inline bool timerLessThan(const QTimerInfo *t1, const QTimerInfo *t2)
+{
+    if (t1->timeout < t2->timeout)
+        return true;
+    if (t2->timeout < t1->timeout)
+        return false;
+    return t1->sequence < t2->sequence;
+}
+
 QTimerInfoList::QTimerInfoList()
 {
 #if (_POSIX_MONOTONIC_CLOCK-0 <= 0) && !defined(Q_OS_MAC)
@@ -84,6 +118,7 @@ QTimerInfoList::QTimerInfoList()
 #endif
 
     firstTimerInfo = nullptr;
+    wheelTime = toTick(updateCurrentTime());
 }
 
 timespec QTimerInfoList::updateCurrentTime()
@@ -147,10 +182,23 @@ bool QTimerInfoList::timeChanged(timespec *delta)
 void QTimerInfoList::timerRepair(const timespec &diff)
 {
     // repair all timers
-    for (int i = 0; i < size(); ++i) {
-        QTimerInfo *t = at(i);
+    QList<QTimerInfo *> all;
+    all.reserve(timers.size());
+    for (QTimerInfo *t : qAsConst(timers)) {
         t->timeout = t->timeout + diff;
+        all.append(t);
     }
+
+    // and sort them into an empty wheel again
+    dueTimers.clear();
+    std::fill(std::begin(occupiedSlots), std::end(occupiedSlots), 0);
+    unsortedSlots = 0;
+    std::fill(std::begin(slotHeads), std::end(slotHeads), nullptr);
+    std::fill(std::begin(slotTails), std::end(slotTails), nullptr);
+    wheelTime = toTick(currentTime);
+    std::sort(all.begin(), all.end(), timerLessThan);
+    for (QTimerInfo *t : qAsConst(all))
+        wheelInsert(t);
 }
 
 void QTimerInfoList::repairTimersIfNeeded()
@@ -175,13 +223,251 @@ void QTimerInfoList::repairTimersIfNeeded()
 */
 void QTimerInfoList::timerInsert(QTimerInfo *ti)
 {
-    int index = size();
-    while (index--) {
-        const QTimerInfo * const t = at(index);
-        if (!(ti->timeout < t->timeout))
+    // timers with equal timeouts fire in the order they were inserted
+    ti->sequence = nextSequence++;
+    wheelInsert(ti);
+}
+
+/*
+  sort timer into the wheel, or into the list of due timers
+*/
+void QTimerInfoList::wheelInsert(QTimerInfo *t)
+{
+    const quint64 tick = toTick(t->timeout);
+    if (tick <= wheelTime) {
+        dueInsert(t);
+        return;
+    }
+
+    // the level is given by the most significant digit in which tick and wheelTime differ
+    const int level = (63 - qCountLeadingZeroBits(tick ^ wheelTime)) / WheelBits;
+    if (level >= WheelLevels) {
+        linkTimer(t, OverflowSlot, slotTails[OverflowSlot]);
+        return;
+    }
+
+    const int slot = level * WheelSize + int((tick >> (level * WheelBits)) & (WheelSize - 1));
+    QTimerInfo *tail = slotTails[slot];
+    // the lowest level gets sorted on demand, see firstWaitingTimer()
+    if (level == 0 && tail && timerLessThan(t, tail))
+        unsortedSlots |= Q_UINT64_C(1) << slot;
+    linkTimer(t, slot, tail);
+}
+
+/*
+  remove timer info from the wheel or the list of due timers
+*/
+void QTimerInfoList::timerRemove(QTimerInfo *t)
+{
+    if (t->slot != NoSlot) {
+        unlinkTimer(t);
+        return;
+    }
+
+    dueRemove(t);
+}
+
+void QTimerInfoList::dueInsert(QTimerInfo *t)
+{
+    t->slot = NoSlot;
+    t->prev = t->next = nullptr;
+    t->dueIndex = dueTimers.size();
+    dueTimers.append(t);
+    dueSift(t->dueIndex);
+}
+
+void QTimerInfoList::dueRemove(QTimerInfo *t)
+{
+    const qsizetype index = t->dueIndex;
+    Q_ASSERT(index < dueTimers.size() && dueTimers.at(index) == t);
+    QTimerInfo *last = dueTimers.takeLast();
+    if (last == t)
+        return;
+    last->dueIndex = index;
+    dueTimers[index] = last;
+    dueSift(index);
+}
+
+/*
+  restore the heap order of dueTimers after the timer at index changed
+*/
+void QTimerInfoList::dueSift(qsizetype index)
+{
+    QTimerInfo **heap = dueTimers.data();
+    QTimerInfo *t = heap[index];
+    while (index > 0) {
+        const qsizetype parent = (index - 1) / 2;
+        if (!timerLessThan(t, heap[parent]))
+            break;
+        heap[index] = heap[parent];
+        heap[index]->dueIndex = index;
+        index = parent;
+    }
+    const qsizetype size = dueTimers.size();
+    for (;;) {
+        qsizetype child = 2 * index + 1;
+        if (child >= size)
+            break;
+        if (child + 1 < size && timerLessThan(heap[child + 1], heap[child]))
+            ++child;
+        if (!timerLessThan(heap[child], t))
+            break;
+        heap[index] = heap[child];
+        heap[index]->dueIndex = index;
+        index = child;
+    }
+    heap[index] = t;
+    t->dueIndex = index;
+}
+
+void QTimerInfoList::linkTimer(QTimerInfo *t, int slot, QTimerInfo *after)
+{
+    t->slot = slot;
+    t->prev = after;
+    t->next = after ? after->next : slotHeads[slot];
+    (t->prev ? t->prev->next : slotHeads[slot]) = t;
+    (t->next ? t->next->prev : slotTails[slot]) = t;
+    if (slot != OverflowSlot)
+        occupiedSlots[slot / WheelSize] |= Q_UINT64_C(1) << (slot % WheelSize);
+}
+
+void QTimerInfoList::unlinkTimer(QTimerInfo *t)
+{
+    const int slot = t->slot;
+    (t->prev ? t->prev->next : slotHeads[slot]) = t->next;
+    (t->next ? t->next->prev : slotTails[slot]) = t->prev;
+    if (slot != OverflowSlot && !slotHeads[slot]) {
+        occupiedSlots[slot / WheelSize] &= ~(Q_UINT64_C(1) << (slot % WheelSize));
+        if (slot < WheelSize)
+            unsortedSlots &= ~(Q_UINT64_C(1) << slot);
+    }
+    t->slot = NoSlot;
+    t->prev = t->next = nullptr;
+}
+
+/*
+  move the timers of a slot wheelTime has reached down to the lower levels
+*/
+void QTimerInfoList::cascadeSlot(int slot)
+{
+    QTimerInfo *t = std::exchange(slotHeads[slot], nullptr);
+    slotTails[slot] = nullptr;
+    if (slot != OverflowSlot)
+        occupiedSlots[slot / WheelSize] &= ~(Q_UINT64_C(1) << (slot % WheelSize));
+    if (slot < WheelSize)
+        unsortedSlots &= ~(Q_UINT64_C(1) << slot);
+
+    while (t) {
+        QTimerInfo *next = t->next;
+        wheelInsert(t);
+        t = next;
+    }
+}
+
+/*
+  sort the timers of a slot on the lowest level by their timeout
+*/
+void QTimerInfoList::sortSlot(int slot)
+{
+    Q_ASSERT(slot < WheelSize);
+    unsortedSlots &= ~(Q_UINT64_C(1) << slot);
+
+    QList<QTimerInfo *> slotTimers;
+    for (QTimerInfo *t = slotHeads[slot]; t; t = t->next)
+        slotTimers.append(t);
+    std::sort(slotTimers.begin(), slotTimers.end(), timerLessThan);
+
+    QTimerInfo *prev = nullptr;
+    for (QTimerInfo *t : qAsConst(slotTimers)) {
+        t->prev = prev;
+        (prev ? prev->next : slotHeads[slot]) = t;
+        prev = t;
+    }
+    prev->next = nullptr;
+    slotTails[slot] = prev;
+}
+
+/*
+  Returns the point in time at which the wheel has to move timers next, or
+  the maximum value if it is empty.
+*/
+quint64 QTimerInfoList::nextWheelEvent() const
+{
+    // any occupied slot on a lower level comes before all slots on the higher ones
+    for (int level = 0; level < WheelLevels; ++level) {
+        if (const quint64 occupied = occupiedSlots[level]) {
+            const int shift = level * WheelBits;
+            const quint64 base = wheelTime >> (shift + WheelBits) << (shift + WheelBits);
+            return base | (quint64(qCountTrailingZeroBits(occupied)) << shift);
+        }
+    }
+    if (slotHeads[OverflowSlot])
+        return ((wheelTime >> OverflowShift) + 1) << OverflowShift;
+    return std::numeric_limits<quint64>::max();
+}
+
+/*
+  advance the wheel to tick, moving the timers expiring until then to the
+  list of due timers
+*/
+void QTimerInfoList::advanceWheel(quint64 tick)
+{
+    while (wheelTime < tick) {
+        const quint64 event = nextWheelEvent();
+        if (event > tick) {
+            wheelTime = tick;
             break;
+        }
+
+        const quint64 previous = std::exchange(wheelTime, event);
+        if ((previous >> OverflowShift) != (event >> OverflowShift))
+            cascadeSlot(OverflowSlot);
+        for (int level = WheelLevels - 1; level >= 0; --level) {
+            const int index = int((event >> (level * WheelBits)) & (WheelSize - 1));
+            if (occupiedSlots[level] & (Q_UINT64_C(1) << index))
+                cascadeSlot(level * WheelSize + index);
+        }
+    }
+}
+
+/*
+  Returns the first timer not already active, or nullptr. This may advance
+  the wheel beyond the current time, which only moves the next timers to
+  the list of due timers early.
+*/
+QTimerInfo *QTimerInfoList::firstWaitingTimer()
+{
+    for (;;) {
+        if (!dueTimers.isEmpty()) {
+            // only timers being activated further up the stack are skipped,
+            // so the top of the heap is almost always the one
+            QTimerInfo *first = nullptr;
+            for (QTimerInfo *t : qAsConst(dueTimers)) {
+                if (!t->activateRef && (!first || timerLessThan(t, first))) {
+                    first = t;
+                    if (first == dueTimers.constFirst())
+                        break;
+                }
+            }
+            if (first)
+                return first;
+        }
+        for (quint64 occupied = occupiedSlots[0]; occupied; occupied &= occupied - 1) {
+            const int slot = int(qCountTrailingZeroBits(occupied));
+            if (unsortedSlots & (Q_UINT64_C(1) << slot))
+                sortSlot(slot);
+            for (QTimerInfo *t = slotHeads[slot]; t; t = t->next) {
+                if (!t->activateRef)
+                    return t;
+            }
+        }
+
+        // bring the next timers down from the higher levels
+        const quint64 event = nextWheelEvent();
+        if (event == std::numeric_limits<quint64>::max())
+            return nullptr;
+        advanceWheel(event);
     }
-    insert(index+1, ti);
 }
 
 inline timespec &operator+=(timespec &t1, int ms)
@@ -385,14 +671,7 @@ bool QTimerInfoList::timerWait(timespec &tm)
     repairTimersIfNeeded();
 
     // Find first waiting timer not already active
-    QTimerInfo *t = nullptr;
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (!(*it)->activateRef) {
-            t = *it;
-            break;
-        }
-    }
-
+    const QTimerInfo *t = firstWaitingTimer();
     if (!t)
       return false;
 
@@ -419,16 +698,13 @@ int QTimerInfoList::timerRemainingTime(int timerId)
     repairTimersIfNeeded();
     timespec tm = {0, 0};
 
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            if (currentTime < t->timeout) {
-                // time to wait
-                tm = roundToMillisecond(t->timeout - currentTime);
-                return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
-            } else {
-                return 0;
-            }
+    if (const QTimerInfo *t = timers.value(timerId)) {
+        if (currentTime < t->timeout) {
+            // time to wait
+            tm = roundToMillisecond(t->timeout - currentTime);
+            return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
+        } else {
+            return 0;
         }
     }
 
@@ -489,6 +765,12 @@ void QTimerInfoList::registerTimer(int timerId, qint64 interval, Qt::TimerType t
             ++t->timeout.tv_sec;
     }
 
+    timers.insert(timerId, t);
+    QTimerInfo *&objectTimers = timersByObject[object];
+    t->objPrev = nullptr;
+    t->objNext = std::exchange(objectTimers, t);
+    if (t->objNext)
+        t->objNext->objPrev = t;
     timerInsert(t);
 
 #ifdef QTIMERINFO_DEBUG
@@ -501,21 +783,32 @@ void QTimerInfoList::registerTimer(int timerId, qint64 interval, Qt::TimerType t
 #endif
 }
 
+void QTimerInfoList::unregisterTimerInfo(QTimerInfo *t)
+{
+    timers.remove(t->id);
+    if (t->objNext)
+        t->objNext->objPrev = t->objPrev;
+    if (t->objPrev)
+        t->objPrev->objNext = t->objNext;
+    else if (t->objNext)
+        timersByObject[t->obj] = t->objNext;
+    else
+        timersByObject.remove(t->obj);
+
+    timerRemove(t);
+    if (t == firstTimerInfo)
+        firstTimerInfo = nullptr;
+    if (t->activateRef)
+        *(t->activateRef) = nullptr;
+    delete t;
+}
+
 bool QTimerInfoList::unregisterTimer(int timerId)
 {
     // set timer inactive
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            // found it
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = nullptr;
-            if (t->activateRef)
-                *(t->activateRef) = nullptr;
-            delete t;
-            return true;
-        }
+    if (QTimerInfo *t = timers.value(timerId)) {
+        unregisterTimerInfo(t);
+        return true;
     }
     // id not found
     return false;
@@ -525,35 +818,27 @@ bool QTimerInfoList::unregisterTimers(QObject *object)
 {
     if (isEmpty())
         return false;
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->obj == object) {
-            // object found
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = nullptr;
-            if (t->activateRef)
-                *(t->activateRef) = nullptr;
-            delete t;
-            // move back one so that we don't skip the new current item
-            --i;
-        }
-    }
+    while (QTimerInfo *t = timersByObject.value(object))
+        unregisterTimerInfo(t);
     return true;
 }
 
 QList<QAbstractEventDispatcher::TimerInfo> QTimerInfoList::registeredTimers(QObject *object) const
 {
+    // report them in the order they are going to fire
+    QList<QTimerInfo *> objectTimers;
+    for (QTimerInfo *t = timersByObject.value(object); t; t = t->objNext)
+        objectTimers.append(t);
+    std::sort(objectTimers.begin(), objectTimers.end(), timerLessThan);
+
     QList<QAbstractEventDispatcher::TimerInfo> list;
-    for (int i = 0; i < count(); ++i) {
-        const QTimerInfo * const t = at(i);
-        if (t->obj == object) {
-            list << QAbstractEventDispatcher::TimerInfo(t->id,
-                                                        (t->timerType == Qt::VeryCoarseTimer
-                                                         ? t->interval * 1000
-                                                         : t->interval),
-                                                        t->timerType);
-        }
+    list.reserve(objectTimers.size());
+    for (const QTimerInfo *t : qAsConst(objectTimers)) {
+        list << QAbstractEventDispatcher::TimerInfo(t->id,
+                                                    (t->timerType == Qt::VeryCoarseTimer
+                                                     ? t->interval * 1000
+                                                     : t->interval),
+                                                    t->timerType);
     }
     return list;
 }
@@ -573,20 +858,21 @@ int QTimerInfoList::activateTimers()
     // qDebug() << "Thread" << QThread::currentThreadId() << "woken up at" << currentTime;
     repairTimersIfNeeded();
 
+    // move the timers expiring until now out of the wheel
+    advanceWheel(toTick(currentTime));
 
     // Find out how many timer have expired
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (currentTime < (*it)->timeout)
-            break;
-        maxCount++;
+    for (const QTimerInfo *t : qAsConst(dueTimers)) {
+        if (!(currentTime < t->timeout))
+            maxCount++;
     }
 
     //fire the timers.
     while (maxCount--) {
-        if (isEmpty())
+        if (dueTimers.isEmpty())
             break;
 
-        QTimerInfo *currentTimerInfo = constFirst();
+        QTimerInfo *currentTimerInfo = dueTimers.constFirst();
         if (currentTime < currentTimerInfo->timeout)
             break; // no timer has expired
 
@@ -601,7 +887,7 @@ int QTimerInfoList::activateTimers()
         }
 
         // remove from list
-        removeFirst();
+        dueRemove(currentTimerInfo);
 
 #ifdef QTIMERINFO_DEBUG
         float diff;
@@ -56,6 +56,7 @@
 // #define QTIMERINFO_DEBUG
 
 #include "qabstracteventdispatcher.h"
+#include "qhash.h"
 
 #include <sys/time.h> // struct timeval
 
@@ -70,6 +71,15 @@ struct QTimerInfo {
     QObject *obj;     // - object to receive event
     QTimerInfo **activateRef; // - ref from activateTimers
 
+    // position in QTimerInfoList
+    quint64 sequence;   // - insertion order, breaks ties between equal timeouts
+    int slot;           // - wheel slot, or QTimerInfoList::NoSlot if due
+    qsizetype dueIndex; // - position in the heap of due timers
+    QTimerInfo *prev;   // - neighbours in the same wheel slot
+    QTimerInfo *next;
+    QTimerInfo *objPrev; // - neighbours among the timers of obj
+    QTimerInfo *objNext;
+
 #ifdef QTIMERINFO_DEBUG
     timeval expected; // when timer is expected to fire
     float cumulativeError;
@@ -77,7 +87,7 @@ struct QTimerInfo {
 #endif
 };
 
-class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
+class Q_CORE_EXPORT QTimerInfoList
 {
 #if ((_POSIX_MONOTONIC_CLOCK-0 <= 0) && !defined(Q_OS_MAC)) || defined(QT_BOOTSTRAPPED)
     timespec previousTime;
@@ -92,8 +102,50 @@ class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
     // state variables used by activateTimers()
     QTimerInfo *firstTimerInfo;
 
+    // Timers expiring at or before wheelTime are kept in dueTimers, a binary
+    // min-heap ordered by timeout. All others wait in a hierarchical timing
+    // wheel.
+    enum {
+        WheelBits = 6,
+        WheelSize = 1 << WheelBits,
+        WheelLevels = 6,
+        OverflowShift = WheelBits * WheelLevels
+    };
+
+    QList<QTimerInfo *> dueTimers;
+    quint64 wheelTime; // in milliseconds
+    quint64 occupiedSlots[WheelLevels] = {};
+    quint64 unsortedSlots = 0; // lowest level only
+    QTimerInfo *slotHeads[WheelLevels * WheelSize + 1] = {};
+    QTimerInfo *slotTails[WheelLevels * WheelSize + 1] = {};
+    quint64 nextSequence = 0;
+
+    QHash<int, QTimerInfo *> timers;
+    QHash<QObject *, QTimerInfo *> timersByObject; // first of each object's timers
+
+    void wheelInsert(QTimerInfo *t);
+    void dueInsert(QTimerInfo *t);
+    void dueRemove(QTimerInfo *t);
+    void dueSift(qsizetype index);
+    void timerRemove(QTimerInfo *t);
+    void unregisterTimerInfo(QTimerInfo *t);
+    void linkTimer(QTimerInfo *t, int slot, QTimerInfo *after);
+    void unlinkTimer(QTimerInfo *t);
+    void cascadeSlot(int slot);
+    void sortSlot(int slot);
+    quint64 nextWheelEvent() const;
+    void advanceWheel(quint64 tick);
+    QTimerInfo *firstWaitingTimer();
+
 public:
+    enum {
+        NoSlot = -1,
+        OverflowSlot = WheelLevels * WheelSize
+    };
+
     QTimerInfoList();
+    QTimerInfoList(const QTimerInfoList &) = delete;
+    QTimerInfoList &operator=(const QTimerInfoList &) = delete;
 
     timespec currentTime;
     timespec updateCurrentTime();
@@ -112,6 +164,14 @@ public:
     QList<QAbstractEventDispatcher::TimerInfo> registeredTimers(QObject *object) const;
 
     int activateTimers();
+
+    bool isEmpty() const { return timers.isEmpty(); }
+    qsizetype size() const { return timers.size(); }
+
+    // iterates over all registered QTimerInfo objects, in no particular order
+    using const_iterator = QHash<int, QTimerInfo *>::const_iterator;
+    const_iterator begin() const { return timers.cbegin(); }
+    const_iterator end() const { return timers.cend(); }
 };
 
 QT_END_NAMESPACE
@@ -47,6 +47,7 @@
 #include "private/qstringconverter_p.h"
 #include "private/qcborvalue_p.h"
 #include "private/qnumeric_p.h"
+#include "private/qsimd_p.h"
 
 //#define PARSER_DEBUG
 #ifdef PARSER_DEBUG
@@ -226,6 +227,9 @@ Parser::Parser(const char *json, int length)
     : head(json), json(json)
     , nestingLevel(0)
     , lastError(QJsonParseError::NoError)
+    , indexBase(json)
+    , structuralWord(0)
+    , structuralBits(0)
 {
     end = json + length;
 }
@@ -319,6 +323,359 @@ char Parser::nextToken()
     return token;
 }
 
+/*
+    Structural index
+
+    Before looking at the document byte by byte, parse() runs a vectorized
+    pass over all of it, in blocks of 64 bytes. It marks the positions of
+    the structural characters and quotation marks, and the first byte of
+    every other value outside of strings. parseIndexed() then only visits
+    those positions, and copies strings that are 7-bit ASCII and have no
+    escape sequences in one go, without looking at their contents again.
+
+    The indexed parser only handles valid documents. On any error, the
+    document is parsed again from the start by the byte by byte parser, so
+    that errors and their offsets are reported exactly as before.
+*/
+
+struct QJsonPrivate::BlockMasks
+{
+    quint64 quote = 0;
+    quint64 backslash = 0;
+    quint64 whitespace = 0;
+    quint64 op = 0; // structural characters other than the quotation mark
+    quint64 high = 0; // bytes that are not 7-bit ASCII
+};
+
+static inline quint64 prefixXor(quint64 x)
+{
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+void StructuralScanner::scan(const BlockMasks &m, quint64 *structurals, quint64 *specials)
+{
+    // a byte following an odd number of backslashes is escaped
+    quint64 escaped = escapedCarry;
+    escapedCarry = 0;
+    for (quint64 backslash = m.backslash & ~escaped; backslash; backslash &= backslash - 1) {
+        const quint64 bit = backslash & -backslash;
+        if (escaped & bit)
+            continue;
+        if (bit >> 63)
+            escapedCarry = 1;
+        else
+            escaped |= bit << 1;
+    }
+
+    // bits are set from the opening quotation mark up to, but not including,
+    // the closing one
+    const quint64 quote = m.quote & ~escaped;
+    const quint64 inString = prefixXor(quote) ^ inStringCarry;
+    inStringCarry = quint64(qint64(inString) >> 63);
+
+    // literals, numbers and anything that is not valid JSON
+    const quint64 value = ~(inString | quote | m.op | m.whitespace);
+    const quint64 valueStart = value & ~((value << 1) | valueCarry);
+    valueCarry = value >> 63;
+
+    *structurals = (m.op & ~inString) | quote | valueStart;
+    *specials = m.backslash | m.high;
+}
+
+static inline void classifyBlock(const uchar *p, BlockMasks *m)
+{
+    for (int i = 0; i < 64; ++i) {
+        const quint64 bit = Q_UINT64_C(1) << i;
+        switch (p[i]) {
+        case Quote:
+            m->quote |= bit;
+            break;
+        case '\\':
+            m->backslash |= bit;
+            break;
+        case Space:
+        case Tab:
+        case LineFeed:
+        case Return:
+            m->whitespace |= bit;
+            break;
+        case BeginArray:
+        case BeginObject:
+        case NameSeparator:
+        case ValueSeparator:
+        case EndArray:
+        case EndObject:
+            m->op |= bit;
+            break;
+        default:
+            if (p[i] >= 0x80)
+                m->high |= bit;
+            break;
+        }
+    }
+}
+
+#if defined(__SSE2__)
+static inline void classifyBlockSse2(const uchar *p, BlockMasks *m)
+{
+    // '[' and ']' only differ from '{' and '}' in the 0x20 bit
+    const __m128i caseBit = _mm_set1_epi8(0x20);
+    for (int i = 0; i < 64; i += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+        const __m128i folded = _mm_or_si128(data, caseBit);
+        const __m128i whitespace =
+                _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(data, _mm_set1_epi8(Space)),
+                                          _mm_cmpeq_epi8(data, _mm_set1_epi8(Tab))),
+                             _mm_or_si128(_mm_cmpeq_epi8(data, _mm_set1_epi8(LineFeed)),
+                                          _mm_cmpeq_epi8(data, _mm_set1_epi8(Return))));
+        const __m128i op =
+                _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(folded, _mm_set1_epi8(BeginObject)),
+                                          _mm_cmpeq_epi8(folded, _mm_set1_epi8(EndObject))),
+                             _mm_or_si128(_mm_cmpeq_epi8(data, _mm_set1_epi8(NameSeparator)),
+                                          _mm_cmpeq_epi8(data, _mm_set1_epi8(ValueSeparator))));
+        auto bits = [i](__m128i v) { return quint64(quint16(_mm_movemask_epi8(v))) << i; };
+        m->quote |= bits(_mm_cmpeq_epi8(data, _mm_set1_epi8(Quote)));
+        m->backslash |= bits(_mm_cmpeq_epi8(data, _mm_set1_epi8('\\')));
+        m->whitespace |= bits(whitespace);
+        m->op |= bits(op);
+        m->high |= bits(data);
+    }
+}
+#elif defined(__ARM_NEON__)
+static inline quint64 neonMovemask(uint8x16_t v, int shift)
+{
+    const uint8x8_t weights = { 1, 1 << 1, 1 << 2, 1 << 3, 1 << 4, 1 << 5, 1 << 6, 1 << 7 };
+    const quint64 low = vaddv_u8(vand_u8(vget_low_u8(v), weights));
+    const quint64 high = vaddv_u8(vand_u8(vget_high_u8(v), weights));
+    return (low | high << 8) << shift;
+}
+
+static inline void classifyBlockNeon(const uchar *p, BlockMasks *m)
+{
+    // '[' and ']' only differ from '{' and '}' in the 0x20 bit
+    const uint8x16_t caseBit = vdupq_n_u8(0x20);
+    for (int i = 0; i < 64; i += 16) {
+        const uint8x16_t data = vld1q_u8(p + i);
+        const uint8x16_t folded = vorrq_u8(data, caseBit);
+        const uint8x16_t whitespace =
+                vorrq_u8(vorrq_u8(vceqq_u8(data, vdupq_n_u8(Space)),
+                                  vceqq_u8(data, vdupq_n_u8(Tab))),
+                         vorrq_u8(vceqq_u8(data, vdupq_n_u8(LineFeed)),
+                                  vceqq_u8(data, vdupq_n_u8(Return))));
+        const uint8x16_t op =
+                vorrq_u8(vorrq_u8(vceqq_u8(folded, vdupq_n_u8(BeginObject)),
+                                  vceqq_u8(folded, vdupq_n_u8(EndObject))),
+                         vorrq_u8(vceqq_u8(data, vdupq_n_u8(NameSeparator)),
+                                  vceqq_u8(data, vdupq_n_u8(ValueSeparator))));
+        m->quote |= neonMovemask(vceqq_u8(data, vdupq_n_u8(Quote)), i);
+        m->backslash |= neonMovemask(vceqq_u8(data, vdupq_n_u8('\\')), i);
+        m->whitespace |= neonMovemask(whitespace, i);
+        m->op |= neonMovemask(op, i);
+        m->high |= neonMovemask(vcgeq_u8(data, vdupq_n_u8(0x80)), i);
+    }
+}
+#endif
+
+#if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED)
+QT_FUNCTION_TARGET(AVX2)
+static inline void classifyBlockAvx2(const uchar *p, BlockMasks *m)
+{
+    // '[' and ']' only differ from '{' and '}' in the 0x20 bit
+    const __m256i caseBit = _mm256_set1_epi8(0x20);
+    for (int i = 0; i < 64; i += 32) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+        const __m256i folded = _mm256_or_si256(data, caseBit);
+        const __m256i whitespace =
+                _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(data, _mm256_set1_epi8(Space)),
+                                                _mm256_cmpeq_epi8(data, _mm256_set1_epi8(Tab))),
+                                _mm256_or_si256(_mm256_cmpeq_epi8(data, _mm256_set1_epi8(LineFeed)),
+                                                _mm256_cmpeq_epi8(data, _mm256_set1_epi8(Return))));
+        const __m256i op =
+                _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(folded, _mm256_set1_epi8(BeginObject)),
+                                                _mm256_cmpeq_epi8(folded, _mm256_set1_epi8(EndObject))),
+                                _mm256_or_si256(_mm256_cmpeq_epi8(data, _mm256_set1_epi8(NameSeparator)),
+                                                _mm256_cmpeq_epi8(data, _mm256_set1_epi8(ValueSeparator))));
+        m->quote |= quint64(uint(_mm256_movemask_epi8(_mm256_cmpeq_epi8(data, _mm256_set1_epi8(Quote))))) << i;
+        m->backslash |= quint64(uint(_mm256_movemask_epi8(_mm256_cmpeq_epi8(data, _mm256_set1_epi8('\\'))))) << i;
+        m->whitespace |= quint64(uint(_mm256_movemask_epi8(whitespace))) << i;
+        m->op |= quint64(uint(_mm256_movemask_epi8(op))) << i;
+        m->high |= quint64(uint(_mm256_movemask_epi8(data))) << i;
+    }
+}
+#endif
+
+template <typename Classifier>
+static Q_ALWAYS_INLINE bool scanStructurals(const uchar *p, qsizetype length,
+                                            quint64 *structurals, quint64 *specials,
+                                            Classifier classify)
+{
+    StructuralScanner scanner;
+    qsizetype i = 0;
+    for ( ; i + 64 <= length; i += 64) {
+        BlockMasks m;
+        classify(p + i, &m);
+        scanner.scan(m, structurals++, specials++);
+    }
+    if (i < length) {
+        // pad the last block with whitespace
+        uchar block[64];
+        memset(block, Space, sizeof(block));
+        memcpy(block, p + i, length - i);
+        BlockMasks m;
+        classify(block, &m);
+        scanner.scan(m, structurals, specials);
+    }
+
+    // an unterminated string is an error
+    return !scanner.isInString();
+}
+
+#if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED)
+QT_FUNCTION_TARGET(AVX2)
+static bool scanStructuralsAvx2(const uchar *p, qsizetype length,
+                                quint64 *structurals, quint64 *specials)
+{
+    return scanStructurals(p, length, structurals, specials, classifyBlockAvx2);
+}
+#endif
+
+static bool scanStructurals(const uchar *p, qsizetype length,
+                            quint64 *structurals, quint64 *specials)
+{
+#if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED)
+    if (qCpuHasFeature(AVX2))
+        return scanStructuralsAvx2(p, length, structurals, specials);
+#endif
+#if defined(__SSE2__)
+    return scanStructurals(p, length, structurals, specials, classifyBlockSse2);
+#elif defined(__ARM_NEON__)
+    return scanStructurals(p, length, structurals, specials, classifyBlockNeon);
+#else
+    return scanStructurals(p, length, structurals, specials, classifyBlock);
+#endif
+}
+
+/*
+    Marks the structural characters and the other bytes listed for
+    buildStructuralIndex() in the block of up to 64 bytes at p, continuing
+    where the previous call left off.
+*/
+void StructuralScanner::scanBlock(const char *p, qsizetype length,
+                                  quint64 *structurals, quint64 *specials)
+{
+    const uchar *data = reinterpret_cast<const uchar *>(p);
+    uchar block[64];
+    if (length < 64) {
+        // pad the last block with whitespace
+        memset(block, Space, sizeof(block));
+        memcpy(block, p, length);
+        data = block;
+    }
+
+    BlockMasks m;
+#if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED)
+    if (qCpuHasFeature(AVX2))
+        classifyBlockAvx2(data, &m);
+    else
+#endif
+#if defined(__SSE2__)
+        classifyBlockSse2(data, &m);
+#elif defined(__ARM_NEON__)
+        classifyBlockNeon(data, &m);
+#else
+        classifyBlock(data, &m);
+#endif
+    scan(m, structurals, specials);
+}
+
+StructuralCursor::StructuralCursor(const char *begin, const char *end)
+    : block(begin), end(begin), stop(end), bits(0)
+{
+}
+
+/*
+    Returns a pointer to the next marked byte, or nullptr at the end of the
+    data.
+*/
+const char *StructuralCursor::next()
+{
+    while (!bits) {
+        block = end;
+        if (block >= stop)
+            return nullptr;
+        const qsizetype length = qMin<qsizetype>(stop - block, 64);
+        quint64 specials;
+        scanner.scanBlock(block, length, &bits, &specials);
+        end = block + length;
+    }
+    const char *pos = block + qCountTrailingZeroBits(bits);
+    bits &= bits - 1;
+    return pos;
+}
+
+// Returns whether any bit in [from, to) is set.
+static bool testBits(const quint64 *bits, qsizetype from, qsizetype to)
+{
+    if (from >= to)
+        return false;
+    const qsizetype first = from / 64;
+    const qsizetype last = (to - 1) / 64;
+    const quint64 firstMask = ~Q_UINT64_C(0) << (from % 64);
+    const quint64 lastMask = ~Q_UINT64_C(0) >> (63 - (to - 1) % 64);
+    if (first == last)
+        return bits[first] & firstMask & lastMask;
+    if (bits[first] & firstMask)
+        return true;
+    for (qsizetype i = first + 1; i < last; ++i) {
+        if (bits[i])
+            return true;
+    }
+    return bits[last] & lastMask;
+}
+
+/*
+    Marks the structural characters, quotation marks and the starts of
+    literals and numbers in structurals, and backslashes and non-ASCII bytes
+    in specials, one bit per byte of the document. Returns false if the
+    document ends inside a string.
+*/
+bool Parser::buildStructuralIndex()
+{
+    indexBase = json;
+    const qsizetype length = end - json;
+    const qsizetype words = (length + 63) / 64;
+    structurals.resize(words);
+    specials.resize(words);
+    structuralWord = 0;
+    if (!scanStructurals(reinterpret_cast<const uchar *>(json), length,
+                         structurals.data(), specials.data()))
+        return false;
+    structuralBits = words ? structurals[0] : 0;
+    return true;
+}
+
+/*
+    Returns the position of the next marked byte relative to indexBase, or
+    -1 at the end of the document.
+*/
+qsizetype Parser::nextStructural()
+{
+    while (!structuralBits) {
+        if (++structuralWord >= structurals.size())
+            return -1;
+        structuralBits = structurals[structuralWord];
+    }
+    const qsizetype pos = structuralWord * 64 + qCountTrailingZeroBits(structuralBits);
+    structuralBits &= structuralBits - 1;
+    return pos;
+}
+
 /*
     JSON-text = object / array
 */
@@ -329,9 +686,23 @@ QCborValue Parser::parse(QJsonParseError *error)
     qDebug(">>>>> parser begin");
 #endif
     eatBOM();
-    char token = nextToken();
 
     QCborValue data;
+    if (buildStructuralIndex() && parseIndexed(&data)) {
+        if (error) {
+            error->offset = 0;
+            error->error = QJsonParseError::NoError;
+        }
+        return data;
+    }
+
+    // report the error, or parse what the indexed parser did not handle
+    container.reset();
+    json = indexBase;
+    nestingLevel = 0;
+    lastError = QJsonParseError::NoError;
+
+    char token = nextToken();
 
     DEBUG << Qt::hex << (uint)token;
     if (token == BeginArray) {
@@ -683,9 +1054,166 @@ bool Parser::parseValue()
     return true;
 }
 
+/*
+    The indexed parser. It follows the grammar like the functions above, but
+    returns false without setting lastError on any error.
+*/
+bool Parser::parseIndexed(QCborValue *data)
+{
+    const qsizetype pos = nextStructural();
+    if (pos < 0)
+        return false;
 
+    const char token = indexBase[pos];
+    if (token != BeginArray && token != BeginObject)
+        return false;
+    container = new QCborContainerPrivate;
+    if (!(token == BeginArray ? parseIndexedArray() : parseIndexedObject()))
+        return false;
 
+    // garbage at the end
+    if (nextStructural() >= 0)
+        return false;
 
+    *data = QCborContainerPrivate::makeValue(token == BeginArray ? QCborValue::Array : QCborValue::Map,
+                                             -1, container.take(), QCborContainerPrivate::MoveContainer);
+    return true;
+}
+
+bool Parser::parseIndexedObject()
+{
+    if (++nestingLevel > nestingLimit)
+        return false;
+
+    qsizetype pos = nextStructural();
+    if (pos < 0)
+        return false;
+    while (indexBase[pos] == Quote) {
+        if (!container)
+            container = new QCborContainerPrivate;
+        if (!parseIndexedString(pos))
+            return false;
+        pos = nextStructural();
+        if (pos < 0 || indexBase[pos] != NameSeparator)
+            return false;
+        pos = nextStructural();
+        if (pos < 0 || !parseIndexedValue(pos, &pos) || pos < 0)
+            return false;
+        if (indexBase[pos] != ValueSeparator)
+            break;
+        pos = nextStructural();
+        if (pos < 0 || indexBase[pos] == EndObject)
+            return false;
+    }
+    if (indexBase[pos] != EndObject)
+        return false;
+
+    --nestingLevel;
+
+    if (container)
+        sortContainer(container.data());
+    return true;
+}
+
+bool Parser::parseIndexedArray()
+{
+    if (++nestingLevel > nestingLimit)
+        return false;
+
+    qsizetype pos = nextStructural();
+    if (pos < 0)
+        return false;
+    if (indexBase[pos] != EndArray) {
+        while (1) {
+            if (!container)
+                container = new QCborContainerPrivate;
+            if (!parseIndexedValue(pos, &pos) || pos < 0)
+                return false;
+            const char token = indexBase[pos];
+            if (token == EndArray)
+                break;
+            if (token != ValueSeparator)
+                return false;
+            pos = nextStructural();
+            if (pos < 0)
+                return false;
+        }
+    }
+
+    --nestingLevel;
+
+    return true;
+}
+
+/*
+    Parses the value starting at pos, and stores the position of the next
+    marked byte after it in next.
+*/
+bool Parser::parseIndexedValue(qsizetype pos, qsizetype *next)
+{
+    switch (indexBase[pos]) {
+    case Quote:
+        if (!parseIndexedString(pos))
+            return false;
+        break;
+    case BeginArray: {
+        StashedContainer stashedContainer(&container, QCborValue::Array);
+        if (!parseIndexedArray())
+            return false;
+        break;
+    }
+    case BeginObject: {
+        StashedContainer stashedContainer(&container, QCborValue::Map);
+        if (!parseIndexedObject())
+            return false;
+        break;
+    }
+    case NameSeparator:
+    case ValueSeparator:
+    case EndObject:
+    case EndArray:
+        return false;
+    default: {
+        // literals and numbers end in whitespace or at the next marked byte
+        json = indexBase + pos;
+        if (!parseValue())
+            return false;
+        *next = nextStructural();
+        const char *valueEnd = *next < 0 ? end : indexBase + *next;
+        if (json > valueEnd)
+            return false;
+        for ( ; json < valueEnd; ++json) {
+            if (*json != Space && *json != Tab && *json != LineFeed && *json != Return)
+                return false;
+        }
+        return true;
+    }
+    }
+
+    *next = nextStructural();
+    return true;
+}
+
+/*
+    Parses the string whose opening quotation mark is at pos. Only strings
+    with backslashes or non-ASCII bytes need to be scanned by parseString().
+*/
+bool Parser::parseIndexedString(qsizetype pos)
+{
+    // the next marked byte is always the closing quotation mark
+    const qsizetype close = nextStructural();
+    if (close < 0)
+        return false;
+    Q_ASSERT(indexBase[close] == Quote);
+
+    if (!testBits(specials.constData(), pos + 1, close)) {
+        container->appendAsciiString(indexBase + pos + 1, close - pos - 1);
+        return true;
+    }
+
+    json = indexBase + pos + 1;
+    return parseString() && json == indexBase + close + 1;
+}
 
 /*
         number = [ minus ] int [ frac ] [ exp ]
@@ -713,12 +1241,14 @@ bool Parser::parseNumber()
         ++json;
 
     // int = zero / ( digit1-9 *DIGIT )
+    const char *digits = json;
     if (json < end && *json == '0') {
         ++json;
     } else {
         while (json < end && *json >= '0' && *json <= '9')
             ++json;
     }
+    const char *intEnd = json;
 
     // frac = decimal-point 1*DIGIT
     if (json < end && *json == '.') {
@@ -744,6 +1274,16 @@ bool Parser::parseNumber()
         return false;
     }
 
+    // fast path for integers that cannot overflow
+    if (json == intEnd && json > digits && json - digits <= 18) {
+        qint64 n = 0;
+        for (const char *c = digits; c < json; ++c)
+            n = n * 10 + (*c - '0');
+        container->append(QCborValue(*start == '-' ? -n : n));
+        END;
+        return true;
+    }
+
     const QByteArray number = QByteArray::fromRawData(start, json - start);
     DEBUG << "numberstring" << number;
 
@@ -890,6 +1430,10 @@ bool Parser::parseString()
             isUtf8 = false;
             break;
         }
+        if (uchar(*json) < 0x80) {
+            ++json;
+            continue;
+        }
         if (!scanUtf8Char(json, end, &ch)) {
             lastError = QJsonParseError::IllegalUTF8String;
             return false;
@@ -929,13 +1473,21 @@ bool Parser::parseString()
                 lastError = QJsonParseError::IllegalEscapeSequence;
                 return false;
             }
+        } else if (uchar(*json) < 0x80) {
+            ucs4.append(QLatin1Char(*json++));
+            continue;
         } else {
             if (!scanUtf8Char(json, end, &ch)) {
                 lastError = QJsonParseError::IllegalUTF8String;
                 return false;
             }
         }
-        ucs4.append(QChar::fromUcs4(ch));
+        if (QChar::requiresSurrogates(ch)) {
+            ucs4.append(QChar(QChar::highSurrogate(ch)));
+            ucs4.append(QChar(QChar::lowSurrogate(ch)));
+        } else {
+            ucs4.append(QChar(char16_t(ch)));
+        }
     }
     ++json;
 
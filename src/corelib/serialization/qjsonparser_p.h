@@ -54,11 +54,46 @@
 #include <QtCore/private/qglobal_p.h>
 #include <QtCore/private/qcborvalue_p.h>
 #include <QtCore/qjsondocument.h>
+#include <QtCore/qvarlengtharray.h>
 
 QT_BEGIN_NAMESPACE
 
 namespace QJsonPrivate {
 
+struct BlockMasks;
+
+// Finds the structural characters in a JSON document, 64 bytes at a time.
+// It must start outside of a string.
+class StructuralScanner
+{
+public:
+    void scanBlock(const char *p, qsizetype length, quint64 *structurals, quint64 *specials);
+    inline void scan(const BlockMasks &m, quint64 *structurals, quint64 *specials);
+    bool isInString() const { return inStringCarry; }
+
+private:
+    quint64 escapedCarry = 0; // the first byte of the next block is escaped
+    quint64 inStringCarry = 0; // all bits set if the next block starts inside a string
+    quint64 valueCarry = 0; // the last byte of the previous block is part of a value
+};
+
+// Iterates over the structural characters, quotation marks and starts of
+// other values in [begin, end), scanning the data on demand. begin must not
+// be inside a string.
+class StructuralCursor
+{
+public:
+    StructuralCursor(const char *begin, const char *end);
+    const char *next();
+
+private:
+    StructuralScanner scanner;
+    const char *block;
+    const char *end;
+    const char *stop;
+    quint64 bits;
+};
+
 class Parser
 {
 public:
@@ -77,6 +112,16 @@ private:
     bool parseString();
     bool parseValue();
     bool parseNumber();
+
+    // structural index pass, see buildStructuralIndex()
+    bool buildStructuralIndex();
+    inline qsizetype nextStructural();
+    bool parseIndexed(QCborValue *data);
+    bool parseIndexedObject();
+    bool parseIndexedArray();
+    bool parseIndexedValue(qsizetype pos, qsizetype *next);
+    bool parseIndexedString(qsizetype pos);
+
     const char *head;
     const char *json;
     const char *end;
@@ -84,6 +129,12 @@ private:
     int nestingLevel;
     QJsonParseError::ParseError lastError;
     QExplicitlySharedDataPointer<QCborContainerPrivate> container;
+
+    const char *indexBase;
+    QVarLengthArray<quint64, 32> structurals;
+    QVarLengthArray<quint64, 32> specials;
+    qsizetype structuralWord;
+    quint64 structuralBits;
 };
 
 }
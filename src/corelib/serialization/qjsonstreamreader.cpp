@@ -0,0 +1,915 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qjsonstreamreader.h"
+
+#include <qiodevice.h>
+#include <qvarlengtharray.h>
+
+#include <private/qnumeric_p.h>
+#include <private/qsimd_p.h>
+#include <private/qstringconverter_p.h>
+
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+// same as QJsonDocument::fromJson()
+static constexpr int nestingLimit = 1024;
+
+// how much is read from the device at a time
+static constexpr qsizetype ReadChunkSize = 16 * 1024;
+
+static inline bool isWhitespace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static const char *findQuoteOrBackslash(const char *p, const char *end)
+{
+#ifdef __SSE2__
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    while (end - p >= 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        const uint mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(data, quote),
+                                                         _mm_cmpeq_epi8(data, backslash)));
+        if (mask)
+            return p + qCountTrailingZeroBits(mask);
+        p += 16;
+    }
+#endif
+    while (p != end && *p != '"' && *p != '\\')
+        ++p;
+    return p;
+}
+
+static inline bool addHexDigit(char digit, char32_t *result)
+{
+    *result <<= 4;
+    if (digit >= '0' && digit <= '9')
+        *result |= (digit - '0');
+    else if (digit >= 'a' && digit <= 'f')
+        *result |= (digit - 'a') + 10;
+    else if (digit >= 'A' && digit <= 'F')
+        *result |= (digit - 'A') + 10;
+    else
+        return false;
+    return true;
+}
+
+// Decodes the escape sequence that json points to (at the backslash) and
+// advances past it. Accepts the same sequences as QJsonDocument::fromJson().
+static bool scanEscapeSequence(const char *&json, const char *end, char32_t *ch)
+{
+    ++json;
+    if (json >= end)
+        return false;
+
+    const uchar escaped = *json++;
+    switch (escaped) {
+    case 'b':
+        *ch = 0x8;
+        break;
+    case 'f':
+        *ch = 0xc;
+        break;
+    case 'n':
+        *ch = 0xa;
+        break;
+    case 'r':
+        *ch = 0xd;
+        break;
+    case 't':
+        *ch = 0x9;
+        break;
+    case 'u':
+        *ch = 0;
+        if (json > end - 4)
+            return false;
+        for (int i = 0; i < 4; ++i) {
+            if (!addHexDigit(*json++, ch))
+                return false;
+        }
+        break;
+    default:
+        // '"', '\\', '/' and, leniently, anything else stand for themselves
+        *ch = escaped;
+    }
+    return true;
+}
+
+class QJsonStreamReaderPrivate
+{
+public:
+    using TokenType = QJsonStreamReader::TokenType;
+
+    enum State : quint8 {
+        ExpectValue,        // at the top level, after ':' and after ',' in an array
+        ExpectValueOrEnd,   // after '['
+        ExpectKey,          // after ',' in an object
+        ExpectKeyOrEnd,     // after '{'
+        ExpectColon,        // after a key
+        ExpectCommaOrEnd    // after a value inside an array or object
+    };
+
+    QIODevice *device = nullptr;
+    QByteArray buffer;
+    qsizetype pos = 0;          // first byte of buffer not consumed yet
+    qint64 bufferOffset = 0;    // offset in the stream of the first byte of buffer
+    QVarLengthArray<bool, 32> containers;   // true for objects, false for arrays
+    State state = ExpectValue;
+    TokenType token = QJsonStreamReader::NoToken;
+    QJsonParseError::ParseError error = QJsonParseError::NoError;
+    bool outOfData = false;
+    bool endOfData = false;     // no data follows what is in buffer
+    bool atStart = true;        // a byte order mark may follow
+    qint64 tokenOffset = 0;
+
+    // how far an incomplete string has been scanned, relative to its quote
+    qsizetype stringScanned = 0;
+    bool stringHasEscapes = false;
+
+    // the value of the current token
+    QAnyStringView text;
+    QString unescaped;
+    qint64 integer = 0;
+    double number = 0;
+    bool boolean = false;
+
+    void reset()
+    {
+        buffer.clear();
+        pos = 0;
+        bufferOffset = 0;
+        containers.clear();
+        state = ExpectValue;
+        token = QJsonStreamReader::NoToken;
+        error = QJsonParseError::NoError;
+        outOfData = false;
+        endOfData = false;
+        atStart = true;
+        tokenOffset = 0;
+        stringScanned = 0;
+        stringHasEscapes = false;
+        text = QAnyStringView();
+    }
+
+    // Drops the data that has been consumed. This invalidates text.
+    void compact()
+    {
+        if (pos == 0)
+            return;
+        buffer.remove(0, pos);
+        bufferOffset += pos;
+        pos = 0;
+    }
+
+    bool fill()
+    {
+        if (!device)
+            return false;
+        compact();
+        const qsizetype size = buffer.size();
+        buffer.resize(size + ReadChunkSize);
+        const qint64 n = device->read(buffer.data() + size, ReadChunkSize);
+        buffer.resize(size + qMax(n, qint64(0)));
+        return n > 0;
+    }
+
+    TokenType setError(QJsonParseError::ParseError e, const char *at)
+    {
+        error = e;
+        tokenOffset = bufferOffset + (at - buffer.constData());
+        stringScanned = 0;
+        return QJsonStreamReader::Invalid;
+    }
+
+    // For a token that the data ends in: NoToken if more data may arrive,
+    // otherwise the error e at the start of the token.
+    TokenType incomplete(QJsonParseError::ParseError e, const char *at)
+    {
+        if (endOfData)
+            return setError(e, at);
+        return QJsonStreamReader::NoToken;
+    }
+
+    TokenType finish(const char *tokenBegin, const char *tokenEnd, TokenType type)
+    {
+        tokenOffset = bufferOffset + (tokenBegin - buffer.constData());
+        pos = tokenEnd - buffer.constData();
+        stringScanned = 0;
+        return type;
+    }
+
+    TokenType finishValue(const char *tokenBegin, const char *tokenEnd, TokenType type)
+    {
+        state = containers.isEmpty() ? ExpectValue : ExpectCommaOrEnd;
+        return finish(tokenBegin, tokenEnd, type);
+    }
+
+    TokenType scan();
+    TokenType readValue(const char *p, const char *end);
+    TokenType readString(const char *p, const char *end, TokenType type);
+    TokenType readNumber(const char *p, const char *end);
+    TokenType readLiteral(const char *p, const char *end, QLatin1String literal, TokenType type);
+    TokenType endContainer(const char *p);
+};
+
+// Returns the next token, or NoToken if the data ends before it does. The
+// state only ever advances past complete tokens (or separators), so scanning
+// can simply be restarted once more data has arrived.
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::scan()
+{
+    const char *begin = buffer.constData();
+    const char *end = begin + buffer.size();
+    const char *p = begin + pos;
+
+    if (atStart) {
+        // skip a UTF-8 byte order mark, like QJsonDocument::fromJson()
+        static const char bom[] = "\xef\xbb\xbf";
+        const qsizetype available = qMin(end - p, qsizetype(sizeof(bom) - 1));
+        if (memcmp(p, bom, available) == 0) {
+            if (available == qsizetype(sizeof(bom) - 1))
+                p += available;
+            else if (!endOfData)
+                return QJsonStreamReader::NoToken;
+        }
+        atStart = false;
+    }
+
+    while (true) {
+        while (p != end && isWhitespace(*p))
+            ++p;
+        pos = p - begin;
+        if (p == end) {
+            // between two top-level values is the only place a stream can end
+            if (!endOfData || containers.isEmpty())
+                return QJsonStreamReader::NoToken;
+            return setError(containers.last() ? QJsonParseError::UnterminatedObject
+                                              : QJsonParseError::UnterminatedArray, p);
+        }
+
+        const char c = *p;
+        switch (state) {
+        case ExpectColon:
+            if (c != ':')
+                return setError(QJsonParseError::MissingNameSeparator, p);
+            ++p;
+            state = ExpectValue;
+            continue;
+
+        case ExpectCommaOrEnd:
+            if (c == ',') {
+                ++p;
+                state = containers.last() ? ExpectKey : ExpectValue;
+                continue;
+            }
+            if (c == (containers.last() ? '}' : ']'))
+                return endContainer(p);
+            if (c == '}' || c == ']') {
+                return setError(containers.last() ? QJsonParseError::UnterminatedObject
+                                                  : QJsonParseError::UnterminatedArray, p);
+            }
+            return setError(QJsonParseError::MissingValueSeparator, p);
+
+        case ExpectKeyOrEnd:
+            if (c == '}')
+                return endContainer(p);
+            Q_FALLTHROUGH();
+        case ExpectKey:
+            if (c != '"')
+                return setError(QJsonParseError::IllegalValue, p);
+            return readString(p, end, QJsonStreamReader::Key);
+
+        case ExpectValueOrEnd:
+            if (c == ']')
+                return endContainer(p);
+            Q_FALLTHROUGH();
+        case ExpectValue:
+            return readValue(p, end);
+        }
+    }
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::readValue(const char *p, const char *end)
+{
+    switch (*p) {
+    case '[':
+    case '{':
+        if (containers.size() >= nestingLimit)
+            return setError(QJsonParseError::DeepNesting, p);
+        containers.append(*p == '{');
+        state = *p == '{' ? ExpectKeyOrEnd : ExpectValueOrEnd;
+        return finish(p, p + 1, *p == '{' ? QJsonStreamReader::StartObject
+                                          : QJsonStreamReader::StartArray);
+    case '"':
+        return readString(p, end, QJsonStreamReader::String);
+    case 't':
+        return readLiteral(p, end, QLatin1String("true"), QJsonStreamReader::Bool);
+    case 'f':
+        return readLiteral(p, end, QLatin1String("false"), QJsonStreamReader::Bool);
+    case 'n':
+        return readLiteral(p, end, QLatin1String("null"), QJsonStreamReader::Null);
+    case '-':
+    case '0': case '1': case '2': case '3': case '4':
+    case '5': case '6': case '7': case '8': case '9':
+        return readNumber(p, end);
+    default:
+        return setError(QJsonParseError::IllegalValue, p);
+    }
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::endContainer(const char *p)
+{
+    const bool isObject = containers.last();
+    containers.removeLast();
+    return finishValue(p, p + 1, isObject ? QJsonStreamReader::EndObject
+                                          : QJsonStreamReader::EndArray);
+}
+
+QJsonStreamReader::TokenType
+QJsonStreamReaderPrivate::readLiteral(const char *p, const char *end, QLatin1String literal,
+                                      TokenType type)
+{
+    const qsizetype available = qMin(end - p, literal.size());
+    if (memcmp(p, literal.data(), available) != 0)
+        return setError(QJsonParseError::IllegalValue, p);
+    if (available < literal.size())
+        return incomplete(QJsonParseError::IllegalValue, p);
+    boolean = *p == 't';
+    return finishValue(p, p + literal.size(), type);
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::readNumber(const char *p, const char *end)
+{
+    const char *json = p;
+    bool isInt = true;
+
+    // same grammar (and leniency) as QJsonDocument::fromJson()
+    if (*json == '-')
+        ++json;
+    const char *digits = json;
+    if (json < end && *json == '0') {
+        ++json;
+    } else {
+        while (json < end && *json >= '0' && *json <= '9')
+            ++json;
+    }
+    if (json < end && *json == '.') {
+        isInt = false;
+        ++json;
+        while (json < end && *json >= '0' && *json <= '9')
+            ++json;
+    }
+    if (json < end && (*json == 'e' || *json == 'E')) {
+        isInt = false;
+        ++json;
+        if (json < end && (*json == '-' || *json == '+'))
+            ++json;
+        while (json < end && *json >= '0' && *json <= '9')
+            ++json;
+    }
+
+    // the number might continue in the next chunk
+    if (json == end && !endOfData)
+        return QJsonStreamReader::NoToken;
+
+    if (isInt && json > digits && json - digits <= 18) {
+        // fast path for integers that cannot overflow
+        qint64 n = 0;
+        for (const char *c = digits; c < json; ++c)
+            n = n * 10 + (*c - '0');
+        integer = *p == '-' ? -n : n;
+        return finishValue(p, json, QJsonStreamReader::Integer);
+    }
+
+    const QByteArray str = QByteArray::fromRawData(p, json - p);
+    bool ok;
+    if (isInt) {
+        integer = str.toLongLong(&ok);
+        if (ok)
+            return finishValue(p, json, QJsonStreamReader::Integer);
+    }
+    number = str.toDouble(&ok);
+    if (!ok)
+        return setError(QJsonParseError::IllegalNumber, p);
+    return finishValue(p, json, QJsonStreamReader::Double);
+}
+
+QJsonStreamReader::TokenType
+QJsonStreamReaderPrivate::readString(const char *p, const char *end, TokenType type)
+{
+    const char *begin = p + 1;
+
+    // When the string was incomplete before, continue where the last scan
+    // stopped instead of rescanning it from its start.
+    const char *stringEnd = findQuoteOrBackslash(p + qMax(stringScanned, qsizetype(1)), end);
+    if (stringEnd == end) {
+        stringScanned = end - p;
+        return incomplete(QJsonParseError::UnterminatedString, p);
+    }
+
+    if (*stringEnd == '"' && !stringHasEscapes) {
+        // no escape sequences: point straight into the buffer
+        const qsizetype len = stringEnd - begin;
+        const auto result = QUtf8::isValidUtf8(QByteArrayView(begin, len));
+        if (!result.isValidUtf8)
+            return setError(QJsonParseError::IllegalUTF8String, p);
+        if (result.isValidAscii)
+            text = QLatin1String(begin, len);
+        else
+            text = QUtf8StringView(begin, len);
+    } else {
+        // find the end of the string before decoding anything, as it may not
+        // have arrived yet
+        stringHasEscapes = true;
+        while (*stringEnd == '\\') {
+            if (end - stringEnd <= 2) {
+                stringScanned = stringEnd - p;
+                return incomplete(QJsonParseError::UnterminatedString, p);
+            }
+            stringEnd = findQuoteOrBackslash(stringEnd + 2, end);
+            if (stringEnd == end) {
+                stringScanned = end - p;
+                return incomplete(QJsonParseError::UnterminatedString, p);
+            }
+        }
+        stringHasEscapes = false;
+
+        // Decode to UTF-16, like QJsonDocument::fromJson() does, since escape
+        // sequences can produce unpaired surrogates.
+        unescaped.resize(0);
+        unescaped.reserve(stringEnd - begin);
+        const char *json = begin;
+        while (json < stringEnd) {
+            if (*json == '\\') {
+                const char *escape = json;
+                char32_t ch;
+                if (!scanEscapeSequence(json, stringEnd, &ch))
+                    return setError(QJsonParseError::IllegalEscapeSequence, escape);
+                unescaped.append(QChar(char16_t(ch)));
+                continue;
+            }
+
+            const char *run = json;
+            while (json < stringEnd && *json != '\\')
+                ++json;
+            const qsizetype oldSize = unescaped.size();
+            unescaped.resize(oldSize + (json - run));
+            QChar *dst = unescaped.data() + oldSize;
+            QStringConverter::State conversion(QStringConverter::Flag::Stateless
+                                               | QStringConverter::Flag::ConvertInitialBom);
+            const QChar *dstEnd = QUtf8::convertToUnicode(dst, QByteArrayView(run, json - run),
+                                                          &conversion);
+            if (conversion.invalidChars)
+                return setError(QJsonParseError::IllegalUTF8String, run);
+            unescaped.resize(dstEnd - unescaped.constData());
+        }
+        text = QStringView(unescaped);
+    }
+
+    if (type == QJsonStreamReader::Key) {
+        state = ExpectColon;
+        return finish(p, stringEnd + 1, type);
+    }
+    return finishValue(p, stringEnd + 1, type);
+}
+
+/*!
+    \class QJsonStreamReader
+    \inmodule QtCore
+    \ingroup json
+    \reentrant
+    \since 6.3
+
+    \brief The QJsonStreamReader class is a pull parser for JSON text that
+    arrives incrementally.
+
+    QJsonStreamReader reads JSON from a QIODevice or from data supplied with
+    addData() and reports it as a sequence of tokens, in the same way that
+    QXmlStreamReader does for XML and QCborStreamReader for CBOR. Unlike
+    QJsonDocument::fromJson(), it never needs the whole document in memory: it
+    only keeps the data that has not been consumed yet, so memory use stays
+    constant no matter how long the stream is.
+
+    Each call to readNext() returns the next token. For the following input
+
+    \snippet code/src_corelib_serialization_qjsonstreamreader.cpp 0
+
+    the tokens are StartObject, Key ("id"), Integer, Key ("tags"),
+    StartArray, String, Bool, EndArray and EndObject. The value of the
+    current token is available from text() for keys and strings, toInteger()
+    and toDouble() for numbers and toBool() for booleans.
+
+    A typical reading loop looks like this:
+
+    \snippet code/src_corelib_serialization_qjsonstreamreader.cpp 1
+
+    \section1 Incremental input
+
+    When the data ends before the next token is complete, readNext() returns
+    NoToken and atEnd() returns \c true. When reading from a device, more data
+    is requested from it first; when using addData(), the next chunk can be
+    added at this point. In either case, the following readNext() call
+    continues where the previous one left off, even if a token was split
+    between chunks.
+
+    Call setEndOfData() once all of the data has been added, or the device
+    has no more to give. Since a number has no terminator, a number at the
+    very end of the data is only reported after that, or once something
+    follows it. From then on, a document that was truncated is reported as
+    an error instead of with NoToken.
+
+    Several top-level values can follow each other, separated by whitespace,
+    as in the \l{https://jsonlines.org}{JSON Lines} format.
+
+    \section1 Strings
+
+    text() does not copy strings that contain no escape sequences: it returns
+    a QLatin1String or QUtf8StringView pointing into the reader's buffer.
+    Strings with escape sequences are decoded into an internal QString and
+    returned as a QStringView. Either way, the view is only valid until the
+    next call to readNext(), addData() or clear(); use toString() to keep a
+    copy.
+
+    \section1 Errors
+
+    QJsonStreamReader accepts the same input as QJsonDocument::fromJson(),
+    including a UTF-8 byte order mark at the start of the stream. In
+    addition, a top-level value does not need to be an object or an array:
+    strings, numbers, booleans and null are reported like any other value,
+    and several top-level values may follow each other. On a syntax error, readNext() returns Invalid, hasError() returns \c true
+    and lastError() describes the problem. The error is final: further calls
+    to readNext() return Invalid until clear() is called.
+
+    \sa QJsonStreamWriter, QJsonDocument, QCborStreamReader, QXmlStreamReader
+*/
+
+/*!
+    \enum QJsonStreamReader::TokenType
+
+    This enum describes the token that readNext() found.
+
+    \value NoToken      No token has been read, or the data ended before the
+                        next token did.
+    \value Invalid      A syntax error occurred. See lastError().
+    \value StartArray   The start of an array (\c{[}).
+    \value EndArray     The end of an array (\c{]}).
+    \value StartObject  The start of an object (\c{\{}).
+    \value EndObject    The end of an object (\c{\}}).
+    \value Key          The name of an object member. The value follows as
+                        the next token.
+    \value String       A string value.
+    \value Integer      A number without fraction or exponent that fits in a
+                        qint64.
+    \value Double       Any other number.
+    \value Bool         \c true or \c false.
+    \value Null         \c null.
+*/
+
+/*!
+    Constructs a QJsonStreamReader with no data. Use addData() or setDevice()
+    to provide the input.
+*/
+QJsonStreamReader::QJsonStreamReader()
+    : d(new QJsonStreamReaderPrivate)
+{
+}
+
+/*!
+    Constructs a QJsonStreamReader that reads from \a data. More data can be
+    added later with addData().
+*/
+QJsonStreamReader::QJsonStreamReader(const QByteArray &data)
+    : d(new QJsonStreamReaderPrivate)
+{
+    d->buffer = data;
+}
+
+/*!
+    Constructs a QJsonStreamReader that reads from \a device. The device must
+    be open for reading.
+
+    QJsonStreamReader does not take ownership of \a device.
+*/
+QJsonStreamReader::QJsonStreamReader(QIODevice *device)
+    : d(new QJsonStreamReaderPrivate)
+{
+    d->device = device;
+}
+
+/*!
+    Destroys the reader.
+*/
+QJsonStreamReader::~QJsonStreamReader()
+{
+}
+
+/*!
+    Clears the reader and makes it read from \a device.
+
+    \sa device(), clear()
+*/
+void QJsonStreamReader::setDevice(QIODevice *device)
+{
+    d->reset();
+    d->device = device;
+}
+
+/*!
+    Returns the device the reader reads from, or \nullptr if there is none.
+
+    \sa setDevice()
+*/
+QIODevice *QJsonStreamReader::device() const
+{
+    return d->device;
+}
+
+/*!
+    Adds \a data to the end of the input. If the reader is reading from a
+    device, this data is consumed before anything else is read from it.
+
+    This invalidates the string returned by text().
+*/
+void QJsonStreamReader::addData(const QByteArray &data)
+{
+    d->compact();
+    if (d->buffer.isEmpty())
+        d->buffer = data;
+    else
+        d->buffer += data;
+    d->outOfData = false;
+    d->endOfData = false;
+}
+
+/*!
+    \overload
+
+    Adds the \a len bytes starting at \a data to the end of the input.
+*/
+void QJsonStreamReader::addData(const char *data, qsizetype len)
+{
+    d->compact();
+    d->buffer.append(data, len);
+    d->outOfData = false;
+    d->endOfData = false;
+}
+
+/*!
+    Tells the reader that no data follows what has been added or read from
+    the device so far. The next call to readNext() reports a number at the
+    end of the data, and reports an error instead of NoToken if the data
+    ends inside an array, an object, a string or a literal.
+
+    Adding more data with addData() undoes this.
+
+    \sa atEnd(), addData()
+*/
+void QJsonStreamReader::setEndOfData()
+{
+    d->endOfData = true;
+}
+
+/*!
+    Discards all data and any error, and detaches the reader from its device.
+    The next token read will be the start of a new document.
+*/
+void QJsonStreamReader::clear()
+{
+    d->reset();
+    d->device = nullptr;
+}
+
+/*!
+    Returns \c true if the last call to readNext() ran out of data or an error
+    has occurred.
+
+    \sa readNext(), hasError()
+*/
+bool QJsonStreamReader::atEnd() const
+{
+    return d->outOfData || d->error != QJsonParseError::NoError;
+}
+
+/*!
+    Reads the next token and returns its type. If the data ends before the
+    token does, returns NoToken; once more data has become available, calling
+    this function again resumes at the same place. Returns Invalid if the
+    input is not valid JSON.
+
+    \sa tokenType(), atEnd()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::readNext()
+{
+    if (d->error != QJsonParseError::NoError)
+        return Invalid;
+
+    d->text = QAnyStringView();
+    TokenType type;
+    while ((type = d->scan()) == NoToken) {
+        if (!d->fill())
+            break;
+    }
+    d->outOfData = type == NoToken;
+    d->token = type;
+    return type;
+}
+
+/*!
+    Returns the type of the current token, which is the value returned by the
+    last call to readNext().
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::tokenType() const
+{
+    return d->token;
+}
+
+/*!
+    \fn bool QJsonStreamReader::isStartArray() const
+    Returns \c true if the current token is a StartArray.
+*/
+/*!
+    \fn bool QJsonStreamReader::isEndArray() const
+    Returns \c true if the current token is an EndArray.
+*/
+/*!
+    \fn bool QJsonStreamReader::isStartObject() const
+    Returns \c true if the current token is a StartObject.
+*/
+/*!
+    \fn bool QJsonStreamReader::isEndObject() const
+    Returns \c true if the current token is an EndObject.
+*/
+/*!
+    \fn bool QJsonStreamReader::isKey() const
+    Returns \c true if the current token is a Key.
+*/
+/*!
+    \fn bool QJsonStreamReader::isString() const
+    Returns \c true if the current token is a String.
+*/
+/*!
+    \fn bool QJsonStreamReader::isInteger() const
+    Returns \c true if the current token is an Integer.
+*/
+/*!
+    \fn bool QJsonStreamReader::isDouble() const
+    Returns \c true if the current token is a Double.
+*/
+/*!
+    \fn bool QJsonStreamReader::isBool() const
+    Returns \c true if the current token is a Bool.
+*/
+/*!
+    \fn bool QJsonStreamReader::isNull() const
+    Returns \c true if the current token is a Null.
+*/
+
+/*!
+    Returns the number of arrays and objects that have been started but not
+    yet ended.
+*/
+int QJsonStreamReader::containerDepth() const
+{
+    return int(d->containers.size());
+}
+
+/*!
+    Returns the offset in bytes, from the start of the input, of the current
+    token, or of the error if one has occurred.
+*/
+qint64 QJsonStreamReader::currentOffset() const
+{
+    return d->tokenOffset;
+}
+
+/*!
+    Returns the text of the current Key or String token, or an empty view for
+    any other token.
+
+    The returned view refers either to the input buffer or to an internal
+    string, so it is only valid until the next call to readNext(), addData()
+    or clear().
+
+    \sa toString()
+*/
+QAnyStringView QJsonStreamReader::text() const
+{
+    return d->text;
+}
+
+/*!
+    \fn QString QJsonStreamReader::toString() const
+
+    Returns a copy of the text of the current Key or String token.
+
+    \sa text()
+*/
+
+/*!
+    Returns the value of the current Integer token. For a Double token, returns
+    the value if it is integral and in range of qint64, 0 otherwise. Returns 0
+    for all other tokens.
+
+    \sa toDouble()
+*/
+qint64 QJsonStreamReader::toInteger() const
+{
+    if (d->token == Integer)
+        return d->integer;
+    qint64 i;
+    if (d->token == Double && convertDoubleTo(d->number, &i))
+        return i;
+    return 0;
+}
+
+/*!
+    Returns the value of the current Double or Integer token, or 0 for other
+    tokens.
+
+    \sa toInteger()
+*/
+double QJsonStreamReader::toDouble() const
+{
+    if (d->token == Integer)
+        return double(d->integer);
+    if (d->token == Double)
+        return d->number;
+    return 0;
+}
+
+/*!
+    Returns the value of the current Bool token, or \c false for other tokens.
+*/
+bool QJsonStreamReader::toBool() const
+{
+    return d->token == Bool && d->boolean;
+}
+
+/*!
+    Returns \c true if a syntax error has occurred.
+
+    \sa lastError()
+*/
+bool QJsonStreamReader::hasError() const
+{
+    return d->error != QJsonParseError::NoError;
+}
+
+/*!
+    Returns the last error. If no error has occurred, its \l{QJsonParseError::}{error}
+    member is QJsonParseError::NoError.
+
+    \sa hasError(), currentOffset()
+*/
+QJsonParseError QJsonStreamReader::lastError() const
+{
+    QJsonParseError error;
+    error.error = d->error;
+    if (d->error != QJsonParseError::NoError)
+        error.offset = int(qMin(d->tokenOffset, qint64(std::numeric_limits<int>::max())));
+    return error;
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qjsonstreamreader.cpp"
@@ -0,0 +1,855 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qjsonstreamwriter.h"
+
+#include <qcborarray.h>
+#include <qcbormap.h>
+#include <qiodevice.h>
+#include <qjsonvalue.h>
+#include <qlocale.h>
+#include <qvarlengtharray.h>
+
+#include <private/qcborvalue_p.h>
+#include <private/qdoublescanprint_p.h>
+#include <private/qjson_p.h>
+#include <private/qnumeric_p.h>
+#include <private/qsimd_p.h>
+#include <private/qstringconverter_p.h>
+
+QT_BEGIN_NAMESPACE
+
+// Once this many bytes are pending, they are written to the device.
+static constexpr qsizetype FlushThreshold = 16 * 1024;
+
+// Strings are escaped in chunks of this many code units, so that the buffer
+// stays bounded no matter how long a single string is.
+static constexpr qsizetype ChunkSize = 4096;
+
+// The longest expansion of a single code unit is the \u00XX form of a
+// control character (or of an unpaired surrogate).
+static constexpr qsizetype MaxEscapedLength = 6;
+
+static inline char hexdig(uint u)
+{
+    return char(u < 0xa ? '0' + u : 'a' + u - 0xa);
+}
+
+static char *escapeAscii(char *dst, uchar c)
+{
+    if (c >= 0x20 && c != '"' && c != '\\') {
+        *dst++ = char(c);
+        return dst;
+    }
+
+    *dst++ = '\\';
+    switch (c) {
+    case '"':
+        *dst++ = '"';
+        break;
+    case '\\':
+        *dst++ = '\\';
+        break;
+    case '\b':
+        *dst++ = 'b';
+        break;
+    case '\f':
+        *dst++ = 'f';
+        break;
+    case '\n':
+        *dst++ = 'n';
+        break;
+    case '\r':
+        *dst++ = 'r';
+        break;
+    case '\t':
+        *dst++ = 't';
+        break;
+    default:
+        *dst++ = 'u';
+        *dst++ = '0';
+        *dst++ = '0';
+        *dst++ = hexdig(c >> 4);
+        *dst++ = hexdig(c & 0xf);
+    }
+    return dst;
+}
+
+#ifdef __SSE2__
+// Returns a bit for each byte that is a control character, a quote, a
+// backslash or has its high bit set. The last comes for free: the signed
+// comparison sees those bytes as negative.
+static inline uint escapeMask(__m128i data)
+{
+    const __m128i m = _mm_or_si128(_mm_cmplt_epi8(data, _mm_set1_epi8(0x20)),
+                                   _mm_or_si128(_mm_cmpeq_epi8(data, _mm_set1_epi8('"')),
+                                                _mm_cmpeq_epi8(data, _mm_set1_epi8('\\'))));
+    return uint(_mm_movemask_epi8(m));
+}
+#endif
+
+// The SIMD loops below always store a full 16 bytes and then advance by the
+// number of bytes that were valid. The destination always has room for it,
+// because MaxEscapedLength bytes are reserved for each remaining code unit.
+
+static char *escapeUtf8(char *dst, const uchar *src, const uchar *end)
+{
+#ifdef __SSE2__
+    while (end - src >= 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), data);
+
+        // multi-byte sequences are copied verbatim
+        const uint mask = escapeMask(data) & ~uint(_mm_movemask_epi8(data));
+        if (!mask) {
+            src += 16;
+            dst += 16;
+            continue;
+        }
+        const uint n = qCountTrailingZeroBits(mask);
+        src += n;
+        dst = escapeAscii(dst + n, *src++);
+    }
+#endif
+    while (src != end) {
+        const uchar c = *src++;
+        if (c < 0x80)
+            dst = escapeAscii(dst, c);
+        else
+            *dst++ = char(c);
+    }
+    return dst;
+}
+
+static inline char *latin1ToUtf8(char *dst, uchar c)
+{
+    *dst++ = char(0xc0 | (c >> 6));
+    *dst++ = char(0x80 | (c & 0x3f));
+    return dst;
+}
+
+static char *escapeLatin1(char *dst, const uchar *src, const uchar *end)
+{
+#ifdef __SSE2__
+    while (end - src >= 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), data);
+
+        const uint mask = escapeMask(data);
+        if (!mask) {
+            src += 16;
+            dst += 16;
+            continue;
+        }
+        const uint n = qCountTrailingZeroBits(mask);
+        src += n;
+        dst += n;
+        const uchar c = *src++;
+        dst = c < 0x80 ? escapeAscii(dst, c) : latin1ToUtf8(dst, c);
+    }
+#endif
+    while (src != end) {
+        const uchar c = *src++;
+        dst = c < 0x80 ? escapeAscii(dst, c) : latin1ToUtf8(dst, c);
+    }
+    return dst;
+}
+
+static inline char *utf16ToUtf8(char *dst, char16_t u, const char16_t *&src, const char16_t *end)
+{
+    uchar *cursor = reinterpret_cast<uchar *>(dst);
+    if (QUtf8Functions::toUtf8<QUtf8BaseTraits>(u, cursor, src, end) < 0) {
+        // unpaired surrogate: use a JSON escape sequence, like QJsonDocument::toJson()
+        *cursor++ = '\\';
+        *cursor++ = 'u';
+        *cursor++ = hexdig(u >> 12 & 0x0f);
+        *cursor++ = hexdig(u >> 8 & 0x0f);
+        *cursor++ = hexdig(u >> 4 & 0x0f);
+        *cursor++ = hexdig(u & 0x0f);
+    }
+    return reinterpret_cast<char *>(cursor);
+}
+
+static char *escapeUtf16(char *dst, const char16_t *src, const char16_t *end)
+{
+#ifdef __SSE2__
+    while (end - src >= 16) {
+        // Narrow 16 code units to bytes. Anything that isn't ASCII saturates
+        // either to 0xff or (if the sign bit is set) to 0, so it is flagged
+        // by escapeMask() and re-examined below.
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 8));
+        const __m128i data = _mm_packus_epi16(lo, hi);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), data);
+
+        const uint mask = escapeMask(data);
+        if (!mask) {
+            src += 16;
+            dst += 16;
+            continue;
+        }
+        const uint n = qCountTrailingZeroBits(mask);
+        src += n;
+        dst += n;
+        const char16_t u = *src++;
+        dst = u < 0x80 ? escapeAscii(dst, uchar(u)) : utf16ToUtf8(dst, u, src, end);
+    }
+#endif
+    while (src != end) {
+        const char16_t u = *src++;
+        dst = u < 0x80 ? escapeAscii(dst, uchar(u)) : utf16ToUtf8(dst, u, src, end);
+    }
+    return dst;
+}
+
+class QJsonStreamWriterPrivate
+{
+public:
+    struct Container {
+        bool isObject;
+        bool isEmpty;
+    };
+
+    QIODevice *device = nullptr;
+    QByteArray *data = nullptr;
+    QByteArray buffer;
+    QVarLengthArray<Container, 16> containers;
+    QJsonDocument::JsonFormat format = QJsonDocument::Compact;
+    bool keyPending = false;
+    bool hasTopLevelValue = false;
+    bool hasIoError = false;
+
+    QByteArray &output() { return data ? *data : buffer; }
+
+    // Grows the output by n bytes and returns a pointer to the first new one.
+    char *reserve(qsizetype n)
+    {
+        QByteArray &out = output();
+        const qsizetype size = out.size();
+        out.resize(size + n);
+        return out.data() + size;
+    }
+
+    // Drops whatever reserve() handed out beyond end.
+    void truncate(const char *end)
+    {
+        QByteArray &out = output();
+        out.resize(end - out.constData());
+    }
+
+    void write(char c) { *reserve(1) = c; }
+    void write(const char *str, qsizetype len) { memcpy(reserve(len), str, len); }
+    void writeNewLine(qsizetype depth)
+    {
+        char *dst = reserve(1 + 4 * depth);
+        *dst++ = '\n';
+        memset(dst, ' ', 4 * depth);
+    }
+
+    void maybeFlush()
+    {
+        if (!data && buffer.size() >= FlushThreshold)
+            flush();
+    }
+
+    void flush()
+    {
+        // after a failed or short write the rest of the output is dropped,
+        // as in QXmlStreamWriter
+        if (device && !buffer.isEmpty() && !hasIoError) {
+            if (device->write(buffer.constData(), buffer.size()) != buffer.size())
+                hasIoError = true;
+        }
+        buffer.resize(0);   // keeps the capacity
+    }
+
+    void writeSeparator()
+    {
+        Container &c = containers.last();
+        if (!c.isEmpty)
+            write(',');
+        if (format == QJsonDocument::Indented)
+            writeNewLine(containers.size());
+        c.isEmpty = false;
+    }
+
+    void beginValue()
+    {
+        if (containers.isEmpty()) {
+            // several top-level values are written one per line
+            if (hasTopLevelValue && format == QJsonDocument::Compact)
+                write('\n');
+            hasTopLevelValue = true;
+            return;
+        }
+        if (keyPending) {
+            keyPending = false;
+            return;
+        }
+        if (containers.last().isObject)
+            qWarning("QJsonStreamWriter: value appended to an object without a key");
+        writeSeparator();
+    }
+
+    void endValue()
+    {
+        if (containers.isEmpty() && format == QJsonDocument::Indented)
+            write('\n');
+        maybeFlush();
+    }
+
+    void writeRawValue(const char *str, qsizetype len)
+    {
+        beginValue();
+        write(str, len);
+        endValue();
+    }
+
+    template <typename Char, typename Escape>
+    void writeChunked(const Char *src, const Char *end, Escape escape)
+    {
+        while (src != end) {
+            const Char *chunkEnd = end - src > ChunkSize ? src + ChunkSize : end;
+            if constexpr (sizeof(Char) == sizeof(char16_t)) {
+                // don't split a surrogate pair
+                if (chunkEnd != end && QChar::isHighSurrogate(chunkEnd[-1]))
+                    ++chunkEnd;
+            }
+            char *dst = reserve((chunkEnd - src) * MaxEscapedLength);
+            truncate(escape(dst, src, chunkEnd));
+            maybeFlush();
+            src = chunkEnd;
+        }
+    }
+
+    void writeString(QAnyStringView str)
+    {
+        write('"');
+        str.visit([this](auto s) {
+            using View = decltype(s);
+            if constexpr (std::is_same_v<View, QStringView>) {
+                writeChunked(s.utf16(), s.utf16() + s.size(), escapeUtf16);
+            } else {
+                const uchar *begin = reinterpret_cast<const uchar *>(s.data());
+                if constexpr (std::is_same_v<View, QLatin1String>)
+                    writeChunked(begin, begin + s.size(), escapeLatin1);
+                else
+                    writeChunked(begin, begin + s.size(), escapeUtf8);
+            }
+        });
+        write('"');
+    }
+
+    void writeKey(QAnyStringView key)
+    {
+        if (containers.isEmpty() || !containers.last().isObject || keyPending)
+            qWarning("QJsonStreamWriter: key appended outside of an object or after another key");
+        if (!containers.isEmpty() && !keyPending)
+            writeSeparator();
+        writeString(key);
+        if (format == QJsonDocument::Indented)
+            write(": ", 2);
+        else
+            write(':');
+        keyPending = !containers.isEmpty();
+    }
+
+    void startContainer(bool isObject)
+    {
+        beginValue();
+        write(isObject ? '{' : '[');
+        containers.append({ isObject, true });
+    }
+
+    bool endContainer(bool isObject)
+    {
+        if (containers.isEmpty() || containers.last().isObject != isObject) {
+            qWarning("QJsonStreamWriter: closing %s that wasn't open", isObject ? "object" : "array");
+            return false;
+        }
+
+        bool ok = true;
+        if (keyPending) {
+            qWarning("QJsonStreamWriter: object closed after a key without a value");
+            write("null", 4);
+            keyPending = false;
+            ok = false;
+        }
+
+        containers.removeLast();
+        if (format == QJsonDocument::Indented)
+            writeNewLine(containers.size());
+        write(isObject ? '}' : ']');
+        endValue();
+        return ok;
+    }
+
+    void writeInteger(qint64 i);
+    void writeUnsigned(quint64 u);
+    void writeDouble(double d);
+    void writeCborValue(const QCborValue &v);
+    void writeCborContainer(const QCborContainerPrivate *c, bool isObject);
+};
+
+static char *formatUnsigned(char *end, quint64 u)
+{
+    do {
+        *--end = char('0' + u % 10);
+        u /= 10;
+    } while (u);
+    return end;
+}
+
+void QJsonStreamWriterPrivate::writeInteger(qint64 i)
+{
+    char buf[24];
+    char *end = buf + sizeof(buf);
+    char *begin = formatUnsigned(end, i < 0 ? 0 - quint64(i) : quint64(i));
+    if (i < 0)
+        *--begin = '-';
+    writeRawValue(begin, end - begin);
+}
+
+void QJsonStreamWriterPrivate::writeUnsigned(quint64 u)
+{
+    char buf[24];
+    char *end = buf + sizeof(buf);
+    char *begin = formatUnsigned(end, u);
+    writeRawValue(begin, end - begin);
+}
+
+void QJsonStreamWriterPrivate::writeDouble(double d)
+{
+    if (!qIsFinite(d)) {
+        writeRawValue("null", 4); // +INF || -INF || NaN (see RFC4627#section2.4)
+        return;
+    }
+
+#if !defined(QT_NO_DOUBLECONVERSION) && !defined(QT_BOOTSTRAPPED)
+    char buf[double_conversion::DoubleToStringConverter::kMaxCharsEcmaScriptShortest + 1];
+    double_conversion::StringBuilder builder(buf, sizeof(buf));
+    double_conversion::DoubleToStringConverter::EcmaScriptConverter().ToShortest(d, &builder);
+    const int len = builder.position();
+    writeRawValue(builder.Finalize(), len);
+#else
+    const QByteArray ba = QByteArray::number(d, 'g', QLocale::FloatingPointShortest);
+    writeRawValue(ba.constData(), ba.size());
+#endif
+}
+
+static QAnyStringView stringAt(const QCborContainerPrivate *c, const QtCbor::Element &e)
+{
+    const QtCbor::ByteData *b = c->byteData(e);
+    if (!b)
+        return QAnyStringView();
+    if (e.flags & QtCbor::Element::StringIsUtf16)
+        return b->asStringView();
+    if (e.flags & QtCbor::Element::StringIsAscii)
+        return b->asLatin1();
+    return b->asUtf8StringView();
+}
+
+void QJsonStreamWriterPrivate::writeCborValue(const QCborValue &v)
+{
+    switch (v.type()) {
+    case QCborValue::True:
+    case QCborValue::False:
+        writeRawValue(v.isTrue() ? "true" : "false", v.isTrue() ? 4 : 5);
+        break;
+    case QCborValue::Integer:
+        writeInteger(v.toInteger());
+        break;
+    case QCborValue::Double:
+        writeDouble(v.toDouble());
+        break;
+    case QCborValue::String:
+        beginValue();
+        writeString(v.toString());
+        endValue();
+        break;
+    case QCborValue::Array:
+    case QCborValue::Map:
+        writeCborContainer(QJsonPrivate::Value::container(v), v.isMap());
+        break;
+    case QCborValue::Null:
+    default:
+        writeRawValue("null", 4);
+    }
+}
+
+void QJsonStreamWriterPrivate::writeCborContainer(const QCborContainerPrivate *c, bool isObject)
+{
+    startContainer(isObject);
+    const qsizetype count = c ? c->elements.size() : 0;
+    for (qsizetype i = 0; i < count; ++i) {
+        const QtCbor::Element &e = c->elements.at(i);
+        if (isObject && (i & 1) == 0) {
+            writeKey(stringAt(c, e));
+            continue;
+        }
+
+        // avoid the QString round-trip for strings and the reference
+        // counting for nested containers
+        if (e.type == QCborValue::String) {
+            beginValue();
+            writeString(stringAt(c, e));
+            endValue();
+        } else if (e.flags & QtCbor::Element::IsContainer) {
+            writeCborContainer(e.container, e.type == QCborValue::Map);
+        } else if (e.type == QCborValue::Array || e.type == QCborValue::Map) {
+            writeCborContainer(nullptr, e.type == QCborValue::Map);
+        } else {
+            writeCborValue(c->valueAt(i));
+        }
+    }
+    endContainer(isObject);
+}
+
+/*!
+    \class QJsonStreamWriter
+    \inmodule QtCore
+    \ingroup json
+    \reentrant
+    \since 6.3
+
+    \brief The QJsonStreamWriter class writes JSON text incrementally to a
+    QIODevice or QByteArray.
+
+    QJsonStreamWriter is the streaming counterpart to QJsonDocument::toJson(),
+    in the same way that QCborStreamWriter is for CBOR. Instead of building the
+    whole document in memory first, each call appends its piece of JSON to the
+    output as it is made. This allows very large documents to be written
+    while keeping memory use constant.
+
+    Arrays are started with startArray() and closed with endArray(); objects
+    likewise with startObject() and endObject(). Inside an object, each value
+    must be preceded by a call to appendKey(). Values are written with the
+    append() overloads, with appendNull(), or, for an existing QJsonValue,
+    QJsonObject or QJsonArray, with appendValue().
+
+    \snippet code/src_corelib_serialization_qjsonstreamwriter.cpp 0
+
+    Output written to a QIODevice is collected in a small internal buffer that
+    is handed to the device each time it holds more than a few kilobytes, and
+    on flush() and destruction. Long strings are escaped piecewise, so the
+    buffer stays bounded even for strings larger than itself.
+
+    Strings are written in UTF-8. QString and QStringView contents are
+    converted, QLatin1String contents are transcoded and UTF-8 input (such as
+    QUtf8StringView or a \c{const char *}) is copied as is, so it must be
+    valid UTF-8. In all cases quotes, backslashes and control characters are
+    escaped.
+
+    Doubles are written in the shortest form that reads back to the same
+    value. Since JSON cannot represent infinities and NaN, those are written
+    as \c null, as QJsonDocument::toJson() does.
+
+    If more than one value is written at the top level, the values are
+    separated by newlines, producing a \l{https://jsonlines.org}{JSON Lines}
+    stream.
+
+    If writing to the device fails, or the device accepts fewer bytes than it
+    was given, hasError() starts returning true and subsequent output is
+    discarded. Since output is buffered, check hasError() after flush().
+
+    QJsonStreamWriter does not validate that the output forms a well-formed
+    document beyond printing a warning for misplaced keys and mismatched end
+    calls. It is the programmer's responsibility to close every array and
+    object that was started.
+
+    \sa QJsonDocument, QCborStreamWriter, QXmlStreamWriter
+*/
+
+/*!
+    Creates a QJsonStreamWriter object that will write the JSON text to \a
+    device. The device must be opened before the first value is appended.
+
+    QJsonStreamWriter does not take ownership of \a device.
+
+    \sa device(), setDevice()
+*/
+QJsonStreamWriter::QJsonStreamWriter(QIODevice *device)
+    : d(new QJsonStreamWriterPrivate)
+{
+    d->device = device;
+    d->buffer.reserve(FlushThreshold + ChunkSize * MaxEscapedLength);
+}
+
+/*!
+    Creates a QJsonStreamWriter object that will append the JSON text to \a
+    data. All output is written immediately to the byte array, without the
+    need for flushing any buffers.
+
+    QJsonStreamWriter does not take ownership of \a data.
+*/
+QJsonStreamWriter::QJsonStreamWriter(QByteArray *data)
+    : d(new QJsonStreamWriterPrivate)
+{
+    d->data = data;
+}
+
+/*!
+    Flushes any buffered output to the device and destroys this
+    QJsonStreamWriter object.
+
+    QJsonStreamWriter does not check that all arrays and objects were closed
+    before the object is destroyed.
+*/
+QJsonStreamWriter::~QJsonStreamWriter()
+{
+    d->flush();
+}
+
+/*!
+    Flushes any buffered output to the current device or byte array and
+    replaces it with \a device.
+
+    \sa device()
+*/
+void QJsonStreamWriter::setDevice(QIODevice *device)
+{
+    d->flush();
+    d->device = device;
+    d->data = nullptr;
+}
+
+/*!
+    Returns the QIODevice that this QJsonStreamWriter object is writing to, or
+    \nullptr if it is writing to a QByteArray.
+
+    \sa setDevice()
+*/
+QIODevice *QJsonStreamWriter::device() const
+{
+    return d->device;
+}
+
+/*!
+    Sets the output format to \a format. The default is
+    QJsonDocument::Compact; QJsonDocument::Indented produces the same layout
+    as QJsonDocument::toJson().
+
+    The format should be set before anything is written.
+
+    \sa format()
+*/
+void QJsonStreamWriter::setFormat(QJsonDocument::JsonFormat format)
+{
+    d->format = format;
+}
+
+/*!
+    Returns the output format.
+
+    \sa setFormat()
+*/
+QJsonDocument::JsonFormat QJsonStreamWriter::format() const
+{
+    return d->format;
+}
+
+/*!
+    \overload
+
+    Appends the 64-bit signed integer \a i as a JSON number.
+*/
+void QJsonStreamWriter::append(qint64 i)
+{
+    d->writeInteger(i);
+}
+
+/*!
+    \overload
+
+    Appends the 64-bit unsigned integer \a u as a JSON number.
+
+    Note that many JSON readers, including QJsonDocument, store numbers as
+    doubles and lose precision on integers larger than 2\sup{53}.
+*/
+void QJsonStreamWriter::append(quint64 u)
+{
+    d->writeUnsigned(u);
+}
+
+/*!
+    \overload
+
+    Appends the floating point number \a d. Infinities and NaN are written as
+    \c null.
+*/
+void QJsonStreamWriter::append(double d)
+{
+    this->d->writeDouble(d);
+}
+
+/*!
+    \overload
+
+    Appends \c true or \c false, depending on \a b.
+*/
+void QJsonStreamWriter::append(bool b)
+{
+    d->writeRawValue(b ? "true" : "false", b ? 4 : 5);
+}
+
+/*!
+    \fn void QJsonStreamWriter::append(std::nullptr_t)
+    \overload
+
+    Appends \c null.
+
+    \sa appendNull()
+*/
+
+/*!
+    Appends the string \a str, escaping it as needed.
+*/
+void QJsonStreamWriter::append(QAnyStringView str)
+{
+    d->beginValue();
+    d->writeString(str);
+    d->endValue();
+}
+
+/*!
+    Appends \c null.
+*/
+void QJsonStreamWriter::appendNull()
+{
+    d->writeRawValue("null", 4);
+}
+
+/*!
+    Appends \a value, including the full contents of it if it is an array or
+    an object. An undefined \a value is written as \c null.
+
+    Unlike QJsonDocument::toJson(), this does not create a copy of the text of
+    the whole value in memory.
+*/
+void QJsonStreamWriter::appendValue(const QJsonValue &value)
+{
+    d->writeCborValue(QCborValue::fromJsonValue(value));
+}
+
+/*!
+    Appends \a key as the name of the next member of the current object. Each
+    value inside an object must be preceded by exactly one call to this
+    function.
+*/
+void QJsonStreamWriter::appendKey(QAnyStringView key)
+{
+    d->writeKey(key);
+}
+
+/*!
+    Starts a JSON array. Each startArray() call must be paired with one
+    endArray() call.
+
+    \sa endArray(), startObject()
+*/
+void QJsonStreamWriter::startArray()
+{
+    d->startContainer(false);
+}
+
+/*!
+    Terminates the array started by the last call to startArray(). Returns
+    false if the innermost open container is not an array.
+
+    \sa startArray(), endObject()
+*/
+bool QJsonStreamWriter::endArray()
+{
+    return d->endContainer(false);
+}
+
+/*!
+    Starts a JSON object. Each startObject() call must be paired with one
+    endObject() call, and each member needs a call to appendKey() before its
+    value.
+
+    \sa endObject(), startArray(), appendKey()
+*/
+void QJsonStreamWriter::startObject()
+{
+    d->startContainer(true);
+}
+
+/*!
+    Terminates the object started by the last call to startObject(). Returns
+    false if the innermost open container is not an object, or if the last key
+    was not followed by a value (in which case \c null is written for it).
+
+    \sa startObject(), endArray()
+*/
+bool QJsonStreamWriter::endObject()
+{
+    return d->endContainer(true);
+}
+
+/*!
+    Writes any buffered output to the device. This is done automatically
+    whenever the internal buffer fills up and when the writer is destroyed.
+
+    \sa hasError()
+*/
+void QJsonStreamWriter::flush()
+{
+    d->flush();
+}
+
+/*!
+    Returns \c true if writing to the device failed.
+
+    This happens if QIODevice::write() returned an error or wrote fewer bytes
+    than requested. Output that was still buffered at that point, and any
+    output appended afterwards, is discarded.
+
+    The error status is never reset, not even by setDevice(). Writing to a
+    QByteArray never fails.
+
+    \sa flush()
+*/
+bool QJsonStreamWriter::hasError() const
+{
+    return d->hasIoError;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,369 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qlazycborvalue_p.h"
+
+#include <QtCore/qcborstreamreader.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QLazyCborValue
+    \inmodule QtCore
+    \internal
+    \since 6.3
+
+    \brief The QLazyCborValue class is a read-only view of a CBOR item that
+    only decodes the parts that are accessed.
+
+    QCborValue::fromCbor() decodes the whole stream into a tree of values
+    before the first one can be read. QLazyCborValue instead keeps the
+    encoded data, for example a QFile::map() region wrapped with
+    QByteArray::fromRawData(), together with the offset of an item. Looking
+    up an element uses QCborStreamReader to skip over the elements before
+    it, without decoding them. To go through all elements of an array or
+    map, use begin() and end(), which only look at each element once.
+
+    Items are only validated when they are converted with toCborValue().
+    Tagged items are reported as QCborValue::Tag by type(), even if
+    toCborValue() converts them to one of the extended types. If a map
+    contains the same key more than once, value() returns the first one.
+*/
+
+/*!
+    Creates a view of the first CBOR item in \a cbor. The data is not copied
+    and not decoded.
+*/
+QLazyCborValue::QLazyCborValue(const QByteArray &cbor)
+    : cbor(cbor), offset(0)
+{
+}
+
+/*!
+    Returns the type of this item, or QCborValue::Invalid if it does not
+    exist or cannot be decoded.
+*/
+QCborValue::Type QLazyCborValue::type() const
+{
+    if (offset < 0)
+        return QCborValue::Invalid;
+
+    QCborStreamReader reader(cbor.constData() + offset, cbor.size() - offset);
+    switch (reader.type()) {
+    case QCborStreamReader::UnsignedInteger:
+        // integers that do not fit into qint64 are stored as doubles
+        if (qint64(reader.toUnsignedInteger()) < 0)
+            return QCborValue::Double;
+        return QCborValue::Integer;
+    case QCborStreamReader::NegativeInteger:
+        if (qint64(quint64(reader.toNegativeInteger()) - 1) < 0)
+            return QCborValue::Double;
+        return QCborValue::Integer;
+    case QCborStreamReader::ByteArray:
+        return QCborValue::ByteArray;
+    case QCborStreamReader::String:
+        return QCborValue::String;
+    case QCborStreamReader::Array:
+        return QCborValue::Array;
+    case QCborStreamReader::Map:
+        return QCborValue::Map;
+    case QCborStreamReader::Tag:
+        return QCborValue::Tag;
+    case QCborStreamReader::SimpleType:
+        return QCborValue::Type(QCborValue::SimpleType + int(reader.toSimpleType()));
+    case QCborStreamReader::Float16:
+    case QCborStreamReader::Float:
+    case QCborStreamReader::Double:
+        return QCborValue::Double;
+    case QCborStreamReader::Invalid:
+        break;
+    }
+    return QCborValue::Invalid;
+}
+
+// QCborStreamReader::next() stops at the item following a tag
+static bool skipItem(QCborStreamReader &reader)
+{
+    while (reader.isTag()) {
+        if (!reader.next())
+            return false;
+    }
+    return reader.next();
+}
+
+bool QLazyCborValue::enterContainer(QCborStreamReader &reader,
+                                    QCborValue::Type containerType) const
+{
+    if (containerType == QCborValue::Array ? !reader.isArray() : !reader.isMap())
+        return false;
+    return reader.enterContainer();
+}
+
+/*!
+    Returns the number of elements in this array or map, or 0 if it is
+    neither. If the encoding does not include the length, this skips over
+    all of its elements.
+*/
+qsizetype QLazyCborValue::size() const
+{
+    if (offset < 0)
+        return 0;
+    QCborStreamReader reader(cbor.constData() + offset, cbor.size() - offset);
+    if (!reader.isArray() && !reader.isMap())
+        return 0;
+    if (reader.isLengthKnown())
+        return qsizetype(reader.length());
+
+    const bool isMap = reader.isMap();
+    if (!reader.enterContainer())
+        return 0;
+    qsizetype count = 0;
+    while (reader.hasNext() && skipItem(reader))
+        ++count;
+    return isMap ? count / 2 : count;
+}
+
+/*!
+    Returns the element at index \a i of this array, or an invalid value if
+    there is no such element or this is not an array.
+*/
+QLazyCborValue QLazyCborValue::at(qsizetype i) const
+{
+    if (offset < 0 || i < 0)
+        return QLazyCborValue();
+    QCborStreamReader reader(cbor.constData() + offset, cbor.size() - offset);
+    if (!enterContainer(reader, QCborValue::Array))
+        return QLazyCborValue();
+
+    for ( ; reader.hasNext(); --i) {
+        if (i == 0)
+            return QLazyCborValue(cbor, offset + reader.currentOffset());
+        if (!skipItem(reader))
+            break;
+    }
+    return QLazyCborValue();
+}
+
+template <typename Match>
+QLazyCborValue QLazyCborValue::find(Match match) const
+{
+    if (offset < 0)
+        return QLazyCborValue();
+    QCborStreamReader reader(cbor.constData() + offset, cbor.size() - offset);
+    if (!enterContainer(reader, QCborValue::Map))
+        return QLazyCborValue();
+
+    while (reader.hasNext()) {
+        // match() reads the key if it may match, and skips it otherwise
+        const bool found = match(reader);
+        if (reader.lastError() != QCborError::NoError)
+            break;
+        if (found)
+            return QLazyCborValue(cbor, offset + reader.currentOffset());
+        if (!skipItem(reader))
+            break;
+    }
+    return QLazyCborValue();
+}
+
+/*!
+    Returns the value for the integer \a key in this map, or an invalid value
+    if there is no such key or this is not a map.
+*/
+QLazyCborValue QLazyCborValue::value(qint64 key) const
+{
+    return find([key](QCborStreamReader &reader) {
+        if (reader.isInteger() && reader.toInteger() == key)
+            return reader.next();
+        skipItem(reader);
+        return false;
+    });
+}
+
+/*!
+    \overload
+
+    Returns the value for the string \a key in this map, or an invalid value
+    if there is no such key or this is not a map.
+*/
+QLazyCborValue QLazyCborValue::value(QAnyStringView key) const
+{
+    return find([key](QCborStreamReader &reader) {
+        if (!reader.isString()) {
+            skipItem(reader);
+            return false;
+        }
+
+        QString string;
+        auto r = reader.readString();
+        while (r.status == QCborStreamReader::Ok) {
+            string += r.data;
+            r = reader.readString();
+        }
+        return r.status == QCborStreamReader::EndOfString && QAnyStringView::equal(string, key);
+    });
+}
+
+/*
+    Reads the element of this array or map that starts at pos, which is
+    its key for maps, into it, unless pos is the end of this container.
+    Returns false if there are no more elements or the element is
+    malformed.
+*/
+bool QLazyCborValue::readElement(qsizetype pos, const_iterator *it) const
+{
+    if (it->remaining == 0 || pos >= cbor.size())
+        return false;
+    // indefinite length containers end with a break byte
+    if (it->remaining < 0 && quint8(cbor.at(pos)) == 0xff)
+        return false;
+    if (it->remaining > 0)
+        --it->remaining;
+
+    if (it->keyOffset >= 0) {
+        QCborStreamReader reader(cbor.constData() + pos, cbor.size() - pos);
+        if (!skipItem(reader))
+            return false;
+        it->keyOffset = pos;
+        pos += reader.currentOffset();
+        if (pos >= cbor.size())
+            return false;
+    }
+    it->current = QLazyCborValue(cbor, pos);
+    return true;
+}
+
+/*
+    Returns an iterator to the first element of this array or map, or
+    end() if it is empty, malformed or neither.
+*/
+QLazyCborValue::const_iterator QLazyCborValue::first() const
+{
+    if (offset < 0)
+        return const_iterator();
+    QCborStreamReader reader(cbor.constData() + offset, cbor.size() - offset);
+    if (!reader.isArray() && !reader.isMap())
+        return const_iterator();
+
+    const_iterator it;
+    if (reader.isMap())
+        it.keyOffset = 0; // any non-negative value, set by readElement()
+    if (reader.isLengthKnown())
+        it.remaining = qsizetype(reader.length());
+    if (!reader.enterContainer() || !readElement(offset + reader.currentOffset(), &it))
+        return const_iterator();
+    return it;
+}
+
+/*!
+    \class QLazyCborValue::const_iterator
+    \inmodule QtCore
+    \internal
+
+    \brief The QLazyCborValue::const_iterator class goes through the
+    elements of an array or map in a QLazyCborValue.
+
+    Each element is only skipped over once, and not decoded. For maps, the
+    iterator points to the value of each entry, and key() returns its key.
+    Iteration stops early at a malformed element.
+*/
+
+/*!
+    Returns the key of the current entry of a map, or an invalid value if
+    the iterator goes through an array.
+*/
+QLazyCborValue QLazyCborValue::const_iterator::key() const
+{
+    if (keyOffset < 0)
+        return QLazyCborValue();
+    return QLazyCborValue(current.cbor, keyOffset);
+}
+
+/*!
+    Advances the iterator to the next element, or to end() if there are no
+    more elements.
+*/
+QLazyCborValue::const_iterator &QLazyCborValue::const_iterator::operator++()
+{
+    QCborStreamReader reader(current.cbor.constData() + current.offset,
+                             current.cbor.size() - current.offset);
+    if (!skipItem(reader) || !current.readElement(current.offset + reader.currentOffset(), this))
+        *this = const_iterator();
+    return *this;
+}
+
+/*!
+    \fn QLazyCborValue::const_iterator QLazyCborValue::begin() const
+
+    Returns an iterator to the first element of this array or map. If it is
+    neither, or it is empty, this returns end().
+*/
+
+/*!
+    \fn QLazyCborValue::const_iterator QLazyCborValue::end() const
+
+    Returns an iterator past the last element of this array or map.
+*/
+
+/*!
+    Decodes this item and everything in it. If \a error is not null, the
+    result of decoding is stored in it, with the offset relative to the
+    start of the data this view was created with.
+*/
+QCborValue QLazyCborValue::toCborValue(QCborParserError *error) const
+{
+    if (offset < 0) {
+        if (error) {
+            error->offset = 0;
+            error->error = { QCborError::EndOfFile };
+        }
+        return QCborValue();
+    }
+
+    QCborStreamReader reader(cbor.constData() + offset, cbor.size() - offset);
+    QCborValue result = QCborValue::fromCbor(reader);
+    if (error) {
+        error->error = reader.lastError();
+        error->offset = offset + reader.currentOffset();
+    }
+    return result;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,159 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QLAZYCBORVALUE_P_H
+#define QLAZYCBORVALUE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qcborvalue.h>
+
+#include <iterator>
+
+QT_REQUIRE_CONFIG(cborstreamreader);
+
+QT_BEGIN_NAMESPACE
+
+class QCborStreamReader;
+
+class Q_CORE_EXPORT QLazyCborValue
+{
+public:
+    QLazyCborValue() = default;
+    explicit QLazyCborValue(const QByteArray &cbor);
+
+    QCborValue::Type type() const;
+    bool isInteger() const { return type() == QCborValue::Integer; }
+    bool isByteArray() const { return type() == QCborValue::ByteArray; }
+    bool isString() const { return type() == QCborValue::String; }
+    bool isArray() const { return type() == QCborValue::Array; }
+    bool isMap() const { return type() == QCborValue::Map; }
+    bool isTag() const { return type() == QCborValue::Tag; }
+    bool isDouble() const { return type() == QCborValue::Double; }
+    bool isInvalid() const { return type() == QCborValue::Invalid; }
+
+    qsizetype size() const;
+    QLazyCborValue at(qsizetype i) const;
+    QLazyCborValue value(qint64 key) const;
+    QLazyCborValue value(QAnyStringView key) const;
+    QLazyCborValue operator[](qsizetype i) const { return at(i); }
+    QLazyCborValue operator[](QAnyStringView key) const { return value(key); }
+
+    QCborValue toCborValue(QCborParserError *error = nullptr) const;
+
+    class const_iterator;
+    using ConstIterator = const_iterator;
+
+    inline const_iterator begin() const;
+    inline const_iterator end() const;
+    inline const_iterator constBegin() const;
+    inline const_iterator constEnd() const;
+
+private:
+    QLazyCborValue(const QByteArray &cbor, qsizetype offset)
+        : cbor(cbor), offset(offset)
+    {}
+
+    bool enterContainer(QCborStreamReader &reader, QCborValue::Type containerType) const;
+    template <typename Match> QLazyCborValue find(Match match) const;
+    bool readElement(qsizetype pos, const_iterator *it) const;
+    const_iterator first() const;
+
+    QByteArray cbor;
+    qsizetype offset = -1;
+};
+
+class QLazyCborValue::const_iterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = qsizetype;
+    using value_type = QLazyCborValue;
+    using pointer = const QLazyCborValue *;
+    using reference = const QLazyCborValue &;
+
+    const_iterator() = default;
+
+    reference operator*() const { return current; }
+    pointer operator->() const { return &current; }
+    QLazyCborValue key() const;
+
+    const_iterator &operator++();
+    const_iterator operator++(int)
+    {
+        const_iterator it = *this;
+        ++*this;
+        return it;
+    }
+
+    bool operator==(const const_iterator &other) const noexcept
+    {
+        return current.offset == other.current.offset;
+    }
+    bool operator!=(const const_iterator &other) const noexcept { return !(*this == other); }
+
+private:
+    friend class QLazyCborValue;
+    QLazyCborValue current;
+    // offset of the key of the current map entry, -1 for arrays
+    qsizetype keyOffset = -1;
+    // elements after the current one, or -1 if the length is not encoded
+    qsizetype remaining = -1;
+};
+
+QLazyCborValue::const_iterator QLazyCborValue::begin() const { return first(); }
+QLazyCborValue::const_iterator QLazyCborValue::end() const { return const_iterator(); }
+QLazyCborValue::const_iterator QLazyCborValue::constBegin() const { return first(); }
+QLazyCborValue::const_iterator QLazyCborValue::constEnd() const { return const_iterator(); }
+
+QT_END_NAMESPACE
+
+#endif // QLAZYCBORVALUE_P_H
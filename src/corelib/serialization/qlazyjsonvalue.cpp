@@ -0,0 +1,448 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qlazyjsonvalue_p.h"
+#include "qjsonparser_p.h"
+
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsonobject.h>
+
+QT_BEGIN_NAMESPACE
+
+using namespace QJsonPrivate;
+
+/*!
+    \class QLazyJsonValue
+    \inmodule QtCore
+    \internal
+    \since 6.3
+
+    \brief The QLazyJsonValue class is a read-only view of a JSON document
+    that only parses the parts that are accessed.
+
+    QJsonDocument::fromJson() converts the whole document into a tree of
+    values before the first one can be read. QLazyJsonValue instead keeps
+    the JSON text, for example a QFile::map() region wrapped with
+    QByteArray::fromRawData(), and only looks for the structural
+    characters between the start of a value and the element that is
+    accessed. Nothing is allocated for the values that are skipped.
+
+    at() and value() look at the elements from the start of the array or
+    object every time they are called. Use begin() and end() to go through
+    all of the elements instead, which looks at each of them only once.
+
+    Values are only validated when they are converted with toJsonValue().
+    Skipped parts of the document are not validated at all. If an object
+    contains the same key more than once, value() returns the first one,
+    while QJsonObject keeps the last one.
+*/
+
+static inline bool isJsonSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/*!
+    Creates a view of the JSON document \a json. The document is not copied
+    and not parsed, and it must be an object or an array, as for
+    QJsonDocument::fromJson().
+*/
+QLazyJsonValue::QLazyJsonValue(const QByteArray &json)
+    : json(json)
+{
+    const char *data = json.constData();
+    qsizetype pos = 0;
+    if (json.startsWith("\xef\xbb\xbf"))
+        pos = 3;
+    while (pos < json.size() && isJsonSpace(data[pos]))
+        ++pos;
+    if (pos < json.size() && (data[pos] == '{' || data[pos] == '[')) {
+        beginOffset = pos;
+        endOffset = json.size();
+    }
+}
+
+/*!
+    Returns the type of this value, or QJsonValue::Undefined if it does not
+    exist. Numbers are always reported as QJsonValue::Double.
+*/
+QJsonValue::Type QLazyJsonValue::type() const
+{
+    if (beginOffset >= endOffset)
+        return QJsonValue::Undefined;
+    switch (json.at(beginOffset)) {
+    case '{':
+        return QJsonValue::Object;
+    case '[':
+        return QJsonValue::Array;
+    case '"':
+        return QJsonValue::String;
+    case 't':
+    case 'f':
+        return QJsonValue::Bool;
+    case 'n':
+        return QJsonValue::Null;
+    case '-':
+        return QJsonValue::Double;
+    default:
+        if (json.at(beginOffset) >= '0' && json.at(beginOffset) <= '9')
+            return QJsonValue::Double;
+        return QJsonValue::Undefined;
+    }
+}
+
+/*
+    Returns the end of the value starting at value, or nullptr if the
+    document ends early. The cursor must have returned value last.
+*/
+static const char *skipValue(StructuralCursor &cursor, const char *value, const char *end)
+{
+    switch (*value) {
+    case '"':
+        if (const char *close = cursor.next())
+            return close + 1;
+        return nullptr;
+    case '{':
+    case '[': {
+        // strings only show up as pairs of quotation marks
+        int depth = 1;
+        while (const char *pos = cursor.next()) {
+            if (*pos == '{' || *pos == '[') {
+                ++depth;
+            } else if (*pos == '}' || *pos == ']') {
+                if (--depth == 0)
+                    return pos + 1;
+            }
+        }
+        return nullptr;
+    }
+    case '}':
+    case ']':
+    case ',':
+    case ':':
+        return nullptr;
+    default:
+        // literals and numbers end at the next whitespace or structural character
+        while (value < end && !isJsonSpace(*value) && !strchr("{}[]:,\"", *value))
+            ++value;
+        return value;
+    }
+}
+
+/*
+    Calls callback with the key (without quotation marks, null for arrays)
+    and the value of each element in turn, until it returns true. Returns
+    false if this value is not an array or object, or if it is malformed.
+*/
+template <typename Callback>
+bool QLazyJsonValue::forEachElement(Callback callback) const
+{
+    const QJsonValue::Type t = type();
+    if (t != QJsonValue::Array && t != QJsonValue::Object)
+        return false;
+
+    const char *data = json.constData();
+    StructuralCursor cursor(data + beginOffset, data + endOffset);
+    const char close = t == QJsonValue::Array ? ']' : '}';
+    cursor.next(); // the opening bracket
+    const char *pos = cursor.next();
+    if (pos && *pos == close)
+        return true;
+
+    while (pos) {
+        QByteArrayView key;
+        if (t == QJsonValue::Object) {
+            if (*pos != '"')
+                return false;
+            const char *keyEnd = cursor.next();
+            const char *colon = cursor.next();
+            if (!keyEnd || !colon || *colon != ':')
+                return false;
+            key = QByteArrayView(pos + 1, keyEnd);
+            pos = cursor.next();
+            if (!pos)
+                return false;
+        }
+
+        const char *valueEnd = skipValue(cursor, pos, data + endOffset);
+        if (!valueEnd)
+            return false;
+        if (callback(key, pos - data, valueEnd - data))
+            return true;
+
+        pos = cursor.next();
+        if (!pos)
+            return false;
+        if (*pos == close)
+            return true;
+        if (*pos != ',')
+            return false;
+        pos = cursor.next();
+    }
+    return false;
+}
+
+/*!
+    Returns the number of elements in this array or object, or 0 if it is
+    neither. This looks at the whole array or object, but does not parse
+    its elements.
+*/
+qsizetype QLazyJsonValue::size() const
+{
+    qsizetype count = 0;
+    const bool ok = forEachElement([&count](QByteArrayView, qsizetype, qsizetype) {
+        ++count;
+        return false;
+    });
+    return ok ? count : 0;
+}
+
+/*!
+    Returns the element at index \a i of this array, or an undefined value
+    if there is no such element or this is not an array.
+*/
+QLazyJsonValue QLazyJsonValue::at(qsizetype i) const
+{
+    if (type() != QJsonValue::Array || i < 0)
+        return QLazyJsonValue();
+
+    QLazyJsonValue result;
+    forEachElement([&](QByteArrayView, qsizetype valueBegin, qsizetype valueEnd) {
+        if (i--)
+            return false;
+        result = QLazyJsonValue(json, valueBegin, valueEnd);
+        return true;
+    });
+    return result;
+}
+
+/*!
+    Returns the value for \a key in this object, or an undefined value if
+    there is no such key or this is not an object. Only the members up to
+    the first one with that key are looked at.
+*/
+QLazyJsonValue QLazyJsonValue::value(QAnyStringView key) const
+{
+    if (type() != QJsonValue::Object)
+        return QLazyJsonValue();
+
+    QLazyJsonValue result;
+    forEachElement([&](QByteArrayView rawKey, qsizetype valueBegin, qsizetype valueEnd) {
+        if (!rawKey.contains('\\')) {
+            if (QAnyStringView(QUtf8StringView(rawKey)) != key)
+                return false;
+        } else {
+            // let the parser deal with the escape sequences
+            const QLazyJsonValue keyValue(json, rawKey.data() - json.constData() - 1,
+                                          rawKey.data() - json.constData() + rawKey.size() + 1);
+            if (keyValue.toJsonValue().toString() != key)
+                return false;
+        }
+        result = QLazyJsonValue(json, valueBegin, valueEnd);
+        return true;
+    });
+    return result;
+}
+
+/*
+    Reads the element of this array or object that starts at pos, which is
+    the opening quotation mark of its key for objects, into it. Returns
+    false if the element is malformed.
+*/
+bool QLazyJsonValue::readElement(const char *pos, const_iterator *it) const
+{
+    const char *data = json.constData();
+    StructuralCursor cursor(pos, data + endOffset);
+    pos = cursor.next();
+    if (!pos)
+        return false;
+
+    if (type() == QJsonValue::Object) {
+        if (*pos != '"')
+            return false;
+        const char *keyEnd = cursor.next();
+        const char *colon = cursor.next();
+        if (!keyEnd || !colon || *colon != ':')
+            return false;
+        it->keyBegin = pos + 1 - data;
+        it->keyEnd = keyEnd - data;
+        pos = cursor.next();
+        if (!pos)
+            return false;
+    }
+
+    const char *valueEnd = skipValue(cursor, pos, data + endOffset);
+    if (!valueEnd)
+        return false;
+    it->current = QLazyJsonValue(json, pos - data, valueEnd - data);
+    return true;
+}
+
+/*
+    Returns an iterator to the first element of this array or object, or
+    end() if it is empty, malformed or neither.
+*/
+QLazyJsonValue::const_iterator QLazyJsonValue::first() const
+{
+    const QJsonValue::Type t = type();
+    if (t != QJsonValue::Array && t != QJsonValue::Object)
+        return const_iterator();
+
+    const char *data = json.constData();
+    StructuralCursor cursor(data + beginOffset, data + endOffset);
+    cursor.next(); // the opening bracket
+    const char *pos = cursor.next();
+    if (!pos || *pos == (t == QJsonValue::Array ? ']' : '}'))
+        return const_iterator();
+
+    const_iterator it;
+    it.container = *this;
+    if (!readElement(pos, &it))
+        return const_iterator();
+    return it;
+}
+
+/*!
+    \class QLazyJsonValue::const_iterator
+    \inmodule QtCore
+    \internal
+
+    \brief The QLazyJsonValue::const_iterator class goes through the
+    elements of an array or object in a QLazyJsonValue.
+
+    Each element is only looked at once, and not parsed. Iteration stops
+    early at a malformed element.
+*/
+
+/*!
+    Returns the key of the current element, or a null string if the
+    iterator goes through an array.
+*/
+QString QLazyJsonValue::const_iterator::key() const
+{
+    if (!keyBegin) // array elements; object keys never start at offset 0
+        return QString();
+    const QByteArrayView rawKey(current.json.constData() + keyBegin, keyEnd - keyBegin);
+    if (!rawKey.contains('\\'))
+        return QString::fromUtf8(rawKey);
+    // let the parser deal with the escape sequences
+    return QLazyJsonValue(current.json, keyBegin - 1, keyEnd + 1).toJsonValue().toString();
+}
+
+/*!
+    Advances the iterator to the next element, or to end() if there are no
+    more elements.
+*/
+QLazyJsonValue::const_iterator &QLazyJsonValue::const_iterator::operator++()
+{
+    const char *data = container.json.constData();
+    StructuralCursor cursor(data + current.endOffset, data + container.endOffset);
+    const char *pos = cursor.next();
+    if (pos && *pos == ',')
+        pos = cursor.next();
+    else
+        pos = nullptr;
+    if (!pos || !container.readElement(pos, this))
+        *this = const_iterator();
+    return *this;
+}
+
+/*!
+    \fn QLazyJsonValue::const_iterator QLazyJsonValue::begin() const
+
+    Returns an iterator to the first element of this array or object. If it
+    is neither, or it is empty, this returns end().
+*/
+
+/*!
+    \fn QLazyJsonValue::const_iterator QLazyJsonValue::end() const
+
+    Returns an iterator past the last element of this array or object.
+*/
+
+/*!
+    Returns the JSON text of this value.
+*/
+QByteArrayView QLazyJsonValue::rawJson() const
+{
+    return QByteArrayView(json.constData() + beginOffset, endOffset - beginOffset);
+}
+
+/*!
+    Parses this value and everything in it. If \a error is not null, the
+    result of parsing is stored in it, with the offset relative to the start
+    of this value. Returns an undefined value if it is not valid JSON.
+*/
+QJsonValue QLazyJsonValue::toJsonValue(QJsonParseError *error) const
+{
+    const QJsonValue::Type t = type();
+    if (t == QJsonValue::Undefined) {
+        if (error) {
+            error->offset = 0;
+            error->error = QJsonParseError::IllegalValue;
+        }
+        return QJsonValue(QJsonValue::Undefined);
+    }
+
+    if (t == QJsonValue::Array || t == QJsonValue::Object) {
+        const QByteArray data = QByteArray::fromRawData(json.constData() + beginOffset, endOffset - beginOffset);
+        const QJsonDocument doc = QJsonDocument::fromJson(data, error);
+        if (doc.isArray())
+            return doc.array();
+        if (doc.isObject())
+            return doc.object();
+        return QJsonValue(QJsonValue::Undefined);
+    }
+
+    // documents have to be arrays or objects, so wrap other values in one
+    QByteArray data;
+    data.reserve(endOffset - beginOffset + 2);
+    data += '[';
+    data += rawJson();
+    data += ']';
+    const QJsonDocument doc = QJsonDocument::fromJson(data, error);
+    if (error && error->error != QJsonParseError::NoError)
+        error->offset = qBound(0, error->offset - 1, int(endOffset - beginOffset));
+    if (!doc.isArray())
+        return QJsonValue(QJsonValue::Undefined);
+    return doc.array().first();
+}
+
+QT_END_NAMESPACE
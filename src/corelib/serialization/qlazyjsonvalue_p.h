@@ -0,0 +1,155 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QLAZYJSONVALUE_P_H
+#define QLAZYJSONVALUE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonvalue.h>
+
+#include <iterator>
+
+QT_BEGIN_NAMESPACE
+
+class Q_CORE_EXPORT QLazyJsonValue
+{
+public:
+    QLazyJsonValue() = default;
+    explicit QLazyJsonValue(const QByteArray &json);
+
+    QJsonValue::Type type() const;
+    bool isNull() const { return type() == QJsonValue::Null; }
+    bool isBool() const { return type() == QJsonValue::Bool; }
+    bool isDouble() const { return type() == QJsonValue::Double; }
+    bool isString() const { return type() == QJsonValue::String; }
+    bool isArray() const { return type() == QJsonValue::Array; }
+    bool isObject() const { return type() == QJsonValue::Object; }
+    bool isUndefined() const { return type() == QJsonValue::Undefined; }
+
+    qsizetype size() const;
+    QLazyJsonValue at(qsizetype i) const;
+    QLazyJsonValue value(QAnyStringView key) const;
+    QLazyJsonValue operator[](qsizetype i) const { return at(i); }
+    QLazyJsonValue operator[](QAnyStringView key) const { return value(key); }
+
+    QByteArrayView rawJson() const;
+    QJsonValue toJsonValue(QJsonParseError *error = nullptr) const;
+
+    class const_iterator;
+    using ConstIterator = const_iterator;
+
+    inline const_iterator begin() const;
+    inline const_iterator end() const;
+    inline const_iterator constBegin() const;
+    inline const_iterator constEnd() const;
+
+private:
+    QLazyJsonValue(const QByteArray &json, qsizetype begin, qsizetype end)
+        : json(json), beginOffset(begin), endOffset(end)
+    {}
+
+    template <typename Callback> bool forEachElement(Callback callback) const;
+    bool readElement(const char *pos, const_iterator *it) const;
+    const_iterator first() const;
+
+    QByteArray json;
+    qsizetype beginOffset = 0;
+    qsizetype endOffset = 0;
+};
+
+class QLazyJsonValue::const_iterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = qsizetype;
+    using value_type = QLazyJsonValue;
+    using pointer = const QLazyJsonValue *;
+    using reference = const QLazyJsonValue &;
+
+    const_iterator() = default;
+
+    reference operator*() const { return current; }
+    pointer operator->() const { return &current; }
+    QString key() const;
+
+    const_iterator &operator++();
+    const_iterator operator++(int)
+    {
+        const_iterator it = *this;
+        ++*this;
+        return it;
+    }
+
+    bool operator==(const const_iterator &other) const noexcept
+    {
+        return current.beginOffset == other.current.beginOffset
+                && current.endOffset == other.current.endOffset;
+    }
+    bool operator!=(const const_iterator &other) const noexcept { return !(*this == other); }
+
+private:
+    friend class QLazyJsonValue;
+    QLazyJsonValue container;
+    QLazyJsonValue current;
+    qsizetype keyBegin = 0;
+    qsizetype keyEnd = 0;
+};
+
+QLazyJsonValue::const_iterator QLazyJsonValue::begin() const { return first(); }
+QLazyJsonValue::const_iterator QLazyJsonValue::end() const { return const_iterator(); }
+QLazyJsonValue::const_iterator QLazyJsonValue::constBegin() const { return first(); }
+QLazyJsonValue::const_iterator QLazyJsonValue::constEnd() const { return const_iterator(); }
+
+QT_END_NAMESPACE
+
+#endif // QLAZYJSONVALUE_P_H
@@ -482,6 +482,418 @@ static void simdCompareAscii(const char8_t *&, const char8_t *, const char16_t *
 }
 #endif
 
+/*
+    Multi-byte UTF-8 kernels. They are entered with src pointing to a
+    non-ASCII character and handle the one-, two- and three-byte forms only:
+    when they reach anything else (four-byte sequences, surrogates, invalid
+    or overlong sequences) or the input is about to end, they return and
+    leave the character at src to the scalar code, which therefore remains
+    the only place where errors and state are handled.
+*/
+#if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED)
+namespace {
+struct Utf16CompressTable
+{
+    // for each 8-bit mask, a PSHUFB control that moves the 16-bit lanes
+    // selected by the mask to the front
+    uchar shuffle[256][16];
+};
+
+struct Utf8PackTable
+{
+    // indexed by the (length - 1) of four characters, two bits each; a
+    // PSHUFB control that packs the first length bytes of each 32-bit lane
+    uchar shuffle[256][16];
+    uchar length[256];
+};
+} // unnamed namespace
+
+static constexpr Utf16CompressTable makeUtf16CompressTable()
+{
+    Utf16CompressTable t = {};
+    for (int mask = 0; mask < 256; ++mask) {
+        int k = 0;
+        for (int lane = 0; lane < 8; ++lane) {
+            if (mask & (1 << lane)) {
+                t.shuffle[mask][2 * k] = uchar(2 * lane);
+                t.shuffle[mask][2 * k + 1] = uchar(2 * lane + 1);
+                ++k;
+            }
+        }
+        for ( ; k < 8; ++k)
+            t.shuffle[mask][2 * k] = t.shuffle[mask][2 * k + 1] = 0x80;
+    }
+    return t;
+}
+
+static constexpr Utf8PackTable makeUtf8PackTable()
+{
+    Utf8PackTable t = {};
+    for (int index = 0; index < 256; ++index) {
+        int k = 0;
+        for (int lane = 0; lane < 4; ++lane) {
+            const int length = qMin(((index >> (2 * lane)) & 3) + 1, 3);
+            for (int i = 0; i < length; ++i)
+                t.shuffle[index][k++] = uchar(4 * lane + i);
+        }
+        t.length[index] = uchar(k);
+        for ( ; k < 16; ++k)
+            t.shuffle[index][k] = 0x80;
+    }
+    return t;
+}
+
+alignas(16) static constexpr Utf16CompressTable utf16CompressTable = makeUtf16CompressTable();
+alignas(16) static constexpr Utf8PackTable utf8PackTable = makeUtf8PackTable();
+
+// spreads four bits to bits 0, 2, 4 and 6
+static constexpr uchar spreadBits[16] = {
+    0x00, 0x01, 0x04, 0x05, 0x10, 0x11, 0x14, 0x15,
+    0x40, 0x41, 0x44, 0x45, 0x50, 0x51, 0x54, 0x55
+};
+
+/*
+    Given the classification of the bytes of the block at src, which has as
+    many bytes as Mask has bits, returns how many of them can be decoded: the
+    whole block plus the continuation bytes of the sequence that runs past it
+    if the sequences starting in the block are valid and have one to three
+    bytes, or the offset of the first sequence that must be left to the
+    scalar code otherwise. The positions where a character starts are
+    returned in starts.
+*/
+template <typename Mask>
+static inline uint utf8BlockLength(const uchar *src, Mask cont, Mask lead2, Mask lead3,
+                                   Mask errors, Mask *starts)
+{
+    constexpr uint N = sizeof(Mask) * 8;
+    const auto isContinuation = [](uchar b) { return (b & 0xc0) == 0x80; };
+
+    // each lead byte must be followed by exactly its continuation bytes
+    const Mask lead = lead2 | lead3;
+    const Mask expected = (lead << 1) | (lead3 << 2);
+    errors |= expected ^ cont;
+    const uint tail1 = uint((lead >> (N - 1)) | (lead3 >> (N - 2))) & 1;
+    const uint tail2 = uint(lead3 >> (N - 1));
+
+    *starts = ~cont;
+    uint stop;
+    bool inSequence;
+    if (!errors) {
+        if ((!tail1 || isContinuation(src[N])) && (!tail2 || isContinuation(src[N + 1])))
+            return N + tail1 + tail2;
+        stop = N;
+        inSequence = true;
+    } else {
+        stop = qCountTrailingZeroBits(errors);
+        inSequence = (expected >> stop) & 1;
+    }
+    if (inSequence) {
+        // the error is in the middle of a sequence: stop at its lead byte,
+        // which is the last character start before the error
+        const Mask before = stop == N ? *starts : *starts & ((Mask(1) << stop) - 1);
+        stop = N - 1 - qCountLeadingZeroBits(before);
+    }
+    *starts &= (Mask(1) << stop) - 1;
+    return stop;
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static inline void avx2EncodeUtf8Half(uchar *&dst, __m128i data)
+{
+    const __m256i c = _mm256_cvtepu16_epi32(data);
+    const __m256i low6 = _mm256_and_si256(c, _mm256_set1_epi32(0x3f));
+    const __m256i mid6 = _mm256_and_si256(_mm256_srli_epi32(c, 6), _mm256_set1_epi32(0x3f));
+    // two bytes: 110xxxxx 10xxxxxx
+    const __m256i two = _mm256_or_si256(_mm256_or_si256(_mm256_set1_epi32(0x80c0),
+                                                        _mm256_srli_epi32(c, 6)),
+                                        _mm256_slli_epi32(low6, 8));
+    // three bytes: 1110xxxx 10xxxxxx 10xxxxxx
+    const __m256i three = _mm256_or_si256(_mm256_or_si256(_mm256_set1_epi32(0x8080e0),
+                                                          _mm256_srli_epi32(c, 12)),
+                                          _mm256_or_si256(_mm256_slli_epi32(mid6, 8),
+                                                          _mm256_slli_epi32(low6, 16)));
+    const __m256i isTwo = _mm256_cmpgt_epi32(c, _mm256_set1_epi32(0x7f));
+    const __m256i isThree = _mm256_cmpgt_epi32(c, _mm256_set1_epi32(0x7ff));
+    const __m256i bytes = _mm256_blendv_epi8(_mm256_blendv_epi8(c, two, isTwo), three, isThree);
+
+    const uint twoMask = _mm256_movemask_ps(_mm256_castsi256_ps(isTwo));
+    const uint threeMask = _mm256_movemask_ps(_mm256_castsi256_ps(isThree));
+    const uint lo = spreadBits[twoMask & 15] + spreadBits[threeMask & 15];
+    const uint hi = spreadBits[twoMask >> 4] + spreadBits[threeMask >> 4];
+
+    const __m128i loShuffle = _mm_load_si128(reinterpret_cast<const __m128i *>(utf8PackTable.shuffle[lo]));
+    const __m128i hiShuffle = _mm_load_si128(reinterpret_cast<const __m128i *>(utf8PackTable.shuffle[hi]));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),
+                     _mm_shuffle_epi8(_mm256_castsi256_si128(bytes), loShuffle));
+    dst += utf8PackTable.length[lo];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),
+                     _mm_shuffle_epi8(_mm256_extracti128_si256(bytes, 1), hiShuffle));
+    dst += utf8PackTable.length[hi];
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static void avx2EncodeUtf8(uchar *&dst, const char16_t *&src, const char16_t *end)
+{
+    // 16 characters produce at most 48 bytes, but the stores can go up to 4
+    // bytes past that, so we stay away from the end of the input
+    while (end - src >= 32) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+        if (_mm256_testz_si256(data, _mm256_set1_epi16(short(0xff80)))) {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),
+                             _mm_packus_epi16(_mm256_castsi256_si128(data), _mm256_extracti128_si256(data, 1)));
+            src += 16;
+            dst += 16;
+            continue;
+        }
+
+        const __m256i surrogates = _mm256_cmpeq_epi16(_mm256_and_si256(data, _mm256_set1_epi16(short(0xf800))),
+                                                      _mm256_set1_epi16(short(0xd800)));
+        const uint surrogateMask = _mm256_movemask_epi8(surrogates);
+        if (surrogateMask) {
+            // convert what comes before the first surrogate
+            const uint n = qCountTrailingZeroBits(surrogateMask) / 2;
+            if (n >= 8) {
+                avx2EncodeUtf8Half(dst, _mm256_castsi256_si128(data));
+                src += 8;
+            }
+            if (n & 7) {
+                const __m128i half = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+                const __m128i nonAscii = _mm_cmpeq_epi16(_mm_min_epu16(half, _mm_set1_epi16(0x80)),
+                                                         _mm_set1_epi16(0x80));
+                const __m128i three = _mm_cmpeq_epi16(_mm_min_epu16(half, _mm_set1_epi16(0x800)),
+                                                      _mm_set1_epi16(0x800));
+                const uint before = (1u << (2 * (n & 7))) - 1;
+                uchar *const start = dst;
+                avx2EncodeUtf8Half(dst, half);
+                dst = start + (n & 7) + (qPopulationCount(_mm_movemask_epi8(nonAscii) & before)
+                                         + qPopulationCount(_mm_movemask_epi8(three) & before)) / 2;
+                src += n & 7;
+            }
+            break;
+        }
+
+        avx2EncodeUtf8Half(dst, _mm256_castsi256_si128(data));
+        avx2EncodeUtf8Half(dst, _mm256_extracti128_si256(data, 1));
+        src += 16;
+    }
+}
+
+/*
+    Classifies the bytes of the 32-byte block at src and returns how many of
+    them avx2DecodeUtf8() can decode, as in utf8BlockLength().
+*/
+QT_FUNCTION_TARGET(AVX2)
+static inline uint avx2ScanUtf8(const uchar *src, __m256i data, uint high, uint *starts)
+{
+    const __m256i next1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 1));
+    const uint cont = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(data, _mm256_set1_epi8(char(0xc0))),
+                                                             _mm256_set1_epi8(char(0x80))));
+    // 0xc0 and 0xc1 would start overlong sequences
+    const uint lead2 = _mm256_movemask_epi8(_mm256_and_si256(
+            _mm256_cmpeq_epi8(_mm256_and_si256(data, _mm256_set1_epi8(char(0xe0))), _mm256_set1_epi8(char(0xc0))),
+            _mm256_cmpeq_epi8(_mm256_max_epu8(data, _mm256_set1_epi8(char(0xc2))), data)));
+    const uint lead3 = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(data, _mm256_set1_epi8(char(0xf0))),
+                                                              _mm256_set1_epi8(char(0xe0))));
+    // 0xe0 must be followed by 0xa0 or above (overlong) and 0xed by less
+    // than 0xa0 (surrogates)
+    const __m256i atLeastA0 = _mm256_cmpeq_epi8(_mm256_max_epu8(next1, _mm256_set1_epi8(char(0xa0))), next1);
+    const uint badThree = _mm256_movemask_epi8(_mm256_or_si256(
+            _mm256_andnot_si256(atLeastA0, _mm256_cmpeq_epi8(data, _mm256_set1_epi8(char(0xe0)))),
+            _mm256_and_si256(atLeastA0, _mm256_cmpeq_epi8(data, _mm256_set1_epi8(char(0xed))))));
+
+    const uint errors = ~(~high | cont | lead2 | lead3) | badThree;
+    return utf8BlockLength(src, cont, lead2, lead3, errors, starts);
+}
+
+// decodes the sequences starting in the 16 bytes at src
+QT_FUNCTION_TARGET(AVX2)
+static inline __m256i avx2DecodeUtf8Lanes(const uchar *src)
+{
+    const __m256i b0 = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)));
+    const __m256i b1 = _mm256_and_si256(_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 1))),
+                                        _mm256_set1_epi16(0x3f));
+    const __m256i b2 = _mm256_and_si256(_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 2))),
+                                        _mm256_set1_epi16(0x3f));
+    const __m256i two = _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(b0, _mm256_set1_epi16(0x1f)), 6), b1);
+    const __m256i three = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi16(b0, 12), _mm256_slli_epi16(b1, 6)), b2);
+    const __m256i chars = _mm256_blendv_epi8(b0, two, _mm256_cmpgt_epi16(b0, _mm256_set1_epi16(0xbf)));
+    return _mm256_blendv_epi8(chars, three, _mm256_cmpgt_epi16(b0, _mm256_set1_epi16(0xdf)));
+}
+
+// stores the lanes of chars where a character starts
+QT_FUNCTION_TARGET(AVX2)
+static inline void avx2StoreUtf16Starts(char16_t *&dst, __m256i chars, uint starts)
+{
+    const __m128i loShuffle = _mm_load_si128(reinterpret_cast<const __m128i *>(utf16CompressTable.shuffle[starts & 0xff]));
+    const __m128i hiShuffle = _mm_load_si128(reinterpret_cast<const __m128i *>(utf16CompressTable.shuffle[(starts >> 8) & 0xff]));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),
+                     _mm_shuffle_epi8(_mm256_castsi256_si128(chars), loShuffle));
+    dst += qPopulationCount(starts & 0xff);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),
+                     _mm_shuffle_epi8(_mm256_extracti128_si256(chars, 1), hiShuffle));
+    dst += qPopulationCount((starts >> 8) & 0xff);
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static void avx2DecodeUtf8(char16_t *&dst, const uchar *&src, const uchar *end)
+{
+    // Each iteration decodes the characters starting in a 32-byte block,
+    // looking at up to two bytes past it for the continuation bytes of the
+    // last sequence. The caller's scalar loop expects at least one byte to
+    // be left over.
+    while (end - src > 34) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+        const uint high = _mm256_movemask_epi8(data);
+        if (!high) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst),
+                                _mm256_cvtepu8_epi16(_mm256_castsi256_si128(data)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 16),
+                                _mm256_cvtepu8_epi16(_mm256_extracti128_si256(data, 1)));
+            src += 32;
+            dst += 32;
+            continue;
+        }
+
+        uint starts;
+        const uint length = avx2ScanUtf8(src, data, high, &starts);
+        if (!length)
+            break;
+
+        avx2StoreUtf16Starts(dst, avx2DecodeUtf8Lanes(src), starts & 0xffff);
+        if (length > 16)
+            avx2StoreUtf16Starts(dst, avx2DecodeUtf8Lanes(src + 16), starts >> 16);
+        src += length;
+        if (length < 32)
+            break;
+    }
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static void avx2ValidateUtf8(const uchar *&src, const uchar *end)
+{
+    while (end - src > 34) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+        const uint high = _mm256_movemask_epi8(data);
+        if (!high) {
+            src += 32;
+            continue;
+        }
+
+        uint starts;
+        const uint length = avx2ScanUtf8(src, data, high, &starts);
+        src += length;
+        if (length < 32)
+            break;
+    }
+}
+#endif
+
+#if QT_COMPILER_SUPPORTS_HERE(AVX512BW) && !defined(QT_BOOTSTRAPPED)
+QT_WARNING_PUSH
+// GCC 12 warns about the undefined upper halves in its own AVX-512 intrinsics
+QT_WARNING_DISABLE_GCC("-Wmaybe-uninitialized")
+QT_FUNCTION_TARGET(AVX512BW)
+static void avx512DecodeUtf8(char16_t *&dst, const uchar *&src, const uchar *end)
+{
+    // Like avx2DecodeUtf8(), with 64-byte blocks. Without VBMI2 there is no
+    // 16-bit compress, so the characters are decoded in 32-bit lanes,
+    // compressed and narrowed.
+    while (end - src > 66) {
+        const __m512i data = _mm512_loadu_si512(src);
+        const quint64 high = _mm512_movepi8_mask(data);
+        if (!high) {
+            _mm512_storeu_si512(dst, _mm512_cvtepu8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(src))));
+            _mm512_storeu_si512(dst + 32, _mm512_cvtepu8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 32))));
+            src += 64;
+            dst += 64;
+            continue;
+        }
+
+        const __m512i next1 = _mm512_loadu_si512(src + 1);
+        const quint64 cont = _mm512_cmpeq_epi8_mask(_mm512_and_si512(data, _mm512_set1_epi8(char(0xc0))),
+                                                    _mm512_set1_epi8(char(0x80)));
+        const quint64 lead2 = _mm512_cmpeq_epi8_mask(_mm512_and_si512(data, _mm512_set1_epi8(char(0xe0))),
+                                                     _mm512_set1_epi8(char(0xc0)))
+                & _mm512_cmpge_epu8_mask(data, _mm512_set1_epi8(char(0xc2)));
+        const quint64 lead3 = _mm512_cmpeq_epi8_mask(_mm512_and_si512(data, _mm512_set1_epi8(char(0xf0))),
+                                                     _mm512_set1_epi8(char(0xe0)));
+        const quint64 atLeastA0 = _mm512_cmpge_epu8_mask(next1, _mm512_set1_epi8(char(0xa0)));
+        const quint64 badThree = (_mm512_cmpeq_epi8_mask(data, _mm512_set1_epi8(char(0xe0))) & ~atLeastA0)
+                | (_mm512_cmpeq_epi8_mask(data, _mm512_set1_epi8(char(0xed))) & atLeastA0);
+        const quint64 errors = ~(~high | cont | lead2 | lead3) | badThree;
+
+        quint64 starts;
+        const uint length = utf8BlockLength(src, cont, lead2, lead3, errors, &starts);
+        if (!length)
+            break;
+
+        for (uint offset = 0; offset < qMin(length, 64u); offset += 16) {
+            const uchar *p = src + offset;
+            const __m512i b0 = _mm512_cvtepu8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+            const __m512i b1 = _mm512_and_si512(_mm512_cvtepu8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 1))),
+                                                _mm512_set1_epi32(0x3f));
+            const __m512i b2 = _mm512_and_si512(_mm512_cvtepu8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 2))),
+                                                _mm512_set1_epi32(0x3f));
+            const __m512i two = _mm512_or_si512(_mm512_slli_epi32(_mm512_and_si512(b0, _mm512_set1_epi32(0x1f)), 6), b1);
+            const __m512i three = _mm512_or_si512(_mm512_or_si512(_mm512_slli_epi32(_mm512_and_si512(b0, _mm512_set1_epi32(0x0f)), 12),
+                                                                  _mm512_slli_epi32(b1, 6)), b2);
+            __m512i chars = _mm512_mask_blend_epi32(_mm512_cmpgt_epu32_mask(b0, _mm512_set1_epi32(0xbf)), b0, two);
+            chars = _mm512_mask_blend_epi32(_mm512_cmpgt_epu32_mask(b0, _mm512_set1_epi32(0xdf)), chars, three);
+
+            const __mmask16 keep = __mmask16(starts >> offset);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst),
+                                _mm512_cvtepi32_epi16(_mm512_maskz_compress_epi32(keep, chars)));
+            dst += qPopulationCount(quint16(keep));
+        }
+        src += length;
+        if (length < 64)
+            break;
+    }
+}
+QT_WARNING_POP
+#endif
+
+static inline void simdEncodeNonAscii(uchar *&dst, const char16_t *&src, const char16_t *end)
+{
+#if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED)
+    // surrogates are left to the scalar code
+    if (!QChar::isSurrogate(*src) && qCpuHasFeature(AVX2))
+        avx2EncodeUtf8(dst, src, end);
+#else
+    Q_UNUSED(dst);
+    Q_UNUSED(src);
+    Q_UNUSED(end);
+#endif
+}
+
+static inline void simdDecodeNonAscii(char16_t *&dst, const uchar *&src, const uchar *end)
+{
+    // four-byte sequences and invalid bytes are left to the scalar code
+    if (*src >= 0xf0)
+        return;
+#if QT_COMPILER_SUPPORTS_HERE(AVX512BW) && !defined(QT_BOOTSTRAPPED)
+    if (qCpuHasFeature(AVX512BW))
+        return avx512DecodeUtf8(dst, src, end);
+#endif
+#if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED)
+    if (qCpuHasFeature(AVX2))
+        return avx2DecodeUtf8(dst, src, end);
+#endif
+    Q_UNUSED(dst);
+    Q_UNUSED(end);
+}
+
+static inline void simdValidateNonAscii(const uchar *&src, const uchar *end)
+{
+#if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED)
+    if (*src < 0xf0 && qCpuHasFeature(AVX2))
+        avx2ValidateUtf8(src, end);
+#else
+    Q_UNUSED(src);
+    Q_UNUSED(end);
+#endif
+}
+
 enum { HeaderDone = 1 };
 
 QByteArray QUtf8::convertFromUnicode(QStringView in)
@@ -499,6 +911,7 @@ QByteArray QUtf8::convertFromUnicode(QStringView in)
         if (simdEncodeAscii(dst, nextAscii, src, end))
             break;
 
+        simdEncodeNonAscii(dst, src, end);
         do {
             char16_t u = *src++;
             int res = QUtf8Functions::toUtf8<QUtf8BaseTraits>(u, dst, src, end);
@@ -566,6 +979,7 @@ char *QUtf8::convertFromUnicode(char *out, QStringView in, QStringConverter::Sta
         if (simdEncodeAscii(cursor, nextAscii, src, end))
             break;
 
+        simdEncodeNonAscii(cursor, src, end);
         do {
             char16_t uc = *src++;
             int res = QUtf8Functions::toUtf8<QUtf8BaseTraits>(uc, cursor, src, end);
@@ -653,6 +1067,7 @@ QChar *QUtf8::convertToUnicode(QChar *buffer, QByteArrayView in) noexcept
             if (simdDecodeAscii(dst, nextAscii, src, end))
                 break;
 
+            simdDecodeNonAscii(dst, src, end);
             do {
                 uchar b = *src++;
                 int res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(b, dst, src, end);
@@ -754,8 +1169,11 @@ QChar *QUtf8::convertToUnicode(QChar *out, QByteArrayView in, QStringConverter::
     res = 0;
     const uchar *nextAscii = src;
     while (res >= 0 && src < end) {
-        if (src >= nextAscii && simdDecodeAscii(dst, nextAscii, src, end))
-            break;
+        if (src >= nextAscii) {
+            if (simdDecodeAscii(dst, nextAscii, src, end))
+                break;
+            simdDecodeNonAscii(dst, src, end);
+        }
 
         ch = *src++;
         res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(ch, dst, src, end);
@@ -808,6 +1226,10 @@ QUtf8::ValidUtf8Result QUtf8::isValidUtf8(QByteArrayView in)
         if (src == end)
             break;
 
+        if (*src & 0x80) {
+            isValidAscii = false;
+            simdValidateNonAscii(src, end);
+        }
         do {
             uchar b = *src++;
             if ((b & 0x80) == 0)
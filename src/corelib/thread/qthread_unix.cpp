@@ -259,6 +259,9 @@ QAbstractEventDispatcher *QThreadPrivate::createEventDispatcher(QThreadData *dat
 #elif !defined(QT_NO_GLIB)
     const bool isQtMainThread = data->thread.loadAcquire() == QCoreApplicationPrivate::mainThread();
     if (qEnvironmentVariableIsEmpty("QT_NO_GLIB")
+#if QT_CONFIG(epoll)
+        && qEnvironmentVariableIntValue("QT_EVENT_DISPATCHER_EPOLL") <= 0
+#endif
         && (isQtMainThread || qEnvironmentVariableIsEmpty("QT_NO_THREADED_GLIB"))
         && QEventDispatcherGlib::versionSupported())
         return new QEventDispatcherGlib;
@@ -41,6 +41,8 @@
 #include "qthreadpool_p.h"
 #include "qdeadlinetimer.h"
 #include "qcoreapplication.h"
+#include "qrandom.h"
+#include "qscopeguard.h"
 
 #include <algorithm>
 
@@ -60,8 +62,16 @@ public:
     QWaitCondition runnableReady;
     QThreadPoolPrivate *manager;
     QRunnable *runnable;
+
+    // work stealing
+    QThreadPoolWorkQueue *workQueue = nullptr;
+    quint32 stealSeed;
+    uint unlockedRunCount = 0;
 };
 
+// the pool thread the calling thread is running, if any
+static thread_local QThreadPoolThread *currentPoolThread = nullptr;
+
 /*
     QThreadPool private class.
 */
@@ -71,7 +81,7 @@ public:
     \internal
 */
 QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
-    :manager(manager), runnable(nullptr)
+    :manager(manager), runnable(nullptr), stealSeed(QRandomGenerator::global()->generate() | 1)
 {
     setStackSize(manager->stackSize);
 }
@@ -81,13 +91,16 @@ QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
 */
 void QThreadPoolThread::run()
 {
+    currentPoolThread = this;
+    const auto resetCurrentPoolThread = qScopeGuard([] { currentPoolThread = nullptr; });
+
     QMutexLocker locker(&manager->mutex);
     for(;;) {
         QRunnable *r = runnable;
         runnable = nullptr;
 
         do {
-            if (r) {
+            while (r) {
                 // If autoDelete() is false, r might already be deleted after run(), so check status now.
                 const bool del = r->autoDelete();
 
@@ -109,16 +122,27 @@ void QThreadPoolThread::run()
 
                 if (del)
                     delete r;
-                locker.relock();
+
+                // pick up work from the per-thread queues without taking the lock
+                r = manager->takeUnlockedWork(this);
             }
+            locker.relock();
 
             // if too many threads are active, stop working in this one
             if (manager->tooManyThreadsActive())
                 break;
 
-            // all work is done, time to wait for more
-            if (manager->queue.isEmpty())
-                break;
+            if (manager->queue.isEmpty()) {
+                bool victimHasMoreWork = false;
+                r = manager->takeQueuedWork(this, &victimHasMoreWork);
+                if (victimHasMoreWork)
+                    manager->wakeIdleThread();
+
+                // all work is done, time to wait for more
+                if (!r)
+                    break;
+                continue;
+            }
 
             QueuePage *page = manager->queue.first();
             r = page->pop();
@@ -127,8 +151,12 @@ void QThreadPoolThread::run()
                 manager->queue.removeFirst();
                 delete page;
             }
+            manager->updatePriorityHint();
         } while (true);
 
+        // don't strand work this thread queued for itself
+        manager->flushWorkQueue(this);
+
         // this thread is about to be deleted, do not wait or expire
         if (!manager->allThreads.contains(this)) {
             registerThreadInactive();
@@ -171,6 +199,12 @@ void QThreadPoolThread::registerThreadInactive()
 QThreadPoolPrivate:: QThreadPoolPrivate()
 { }
 
+QThreadPoolPrivate::~QThreadPoolPrivate()
+{
+    for (int i = 0; i < workQueueCount.loadRelaxed(); ++i)
+        delete workQueues[i].load(std::memory_order_relaxed);
+}
+
 bool QThreadPoolPrivate::tryStart(QRunnable *task)
 {
     Q_ASSERT(task != nullptr);
@@ -193,18 +227,7 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
 
     if (!expiredThreads.isEmpty()) {
         // restart an expired thread
-        QThreadPoolThread *thread = expiredThreads.dequeue();
-        Q_ASSERT(thread->runnable == nullptr);
-
-        ++activeThreads;
-
-        thread->runnable = task;
-
-        // Ensure that the thread has actually finished, otherwise the following
-        // start() has no effect.
-        thread->wait();
-        Q_ASSERT(thread->isFinished());
-        thread->start(threadPriority);
+        restartThread(expiredThreads.dequeue(), task);
         return true;
     }
 
@@ -229,6 +252,19 @@ void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
     }
     auto it = std::upper_bound(queue.constBegin(), queue.constEnd(), priority, comparePriority);
     queue.insert(std::distance(queue.constBegin(), it), new QueuePage(runnable, priority));
+    updatePriorityHint();
+}
+
+/*!
+    \internal
+
+    Publishes whether the shared queue holds a task with a priority above the
+    default one, so that worker threads know when they have to take the lock
+    instead of running work from the per-thread queues.
+*/
+void QThreadPoolPrivate::updatePriorityHint()
+{
+    priorityWorkQueued.storeRelaxed(!queue.isEmpty() && queue.constFirst()->priority() > 0);
 }
 
 int QThreadPoolPrivate::activeThreadCount() const
@@ -253,7 +289,12 @@ void QThreadPoolPrivate::tryToStartMoreThreads()
             queue.removeFirst();
             delete page;
         }
+        updatePriorityHint();
     }
+
+    // the per-thread queues might be waiting for a thread, too
+    if (queue.isEmpty() && hasQueuedWork())
+        wakeIdleThread();
 }
 
 bool QThreadPoolPrivate::areAllThreadsActive() const
@@ -273,7 +314,6 @@ bool QThreadPoolPrivate::tooManyThreadsActive() const
 */
 void QThreadPoolPrivate::startThread(QRunnable *runnable)
 {
-    Q_ASSERT(runnable != nullptr);
     QScopedPointer<QThreadPoolThread> thread(new QThreadPoolThread(this));
     if (objectName.isEmpty())
         objectName = QLatin1String("Thread (pooled)");
@@ -286,6 +326,232 @@ void QThreadPoolPrivate::startThread(QRunnable *runnable)
     thread.take()->start(threadPriority);
 }
 
+/*!
+    \internal
+
+    Restarts the expired \a thread, making it run \a runnable first if that
+    is not a nullptr.
+*/
+void QThreadPoolPrivate::restartThread(QThreadPoolThread *thread, QRunnable *runnable)
+{
+    Q_ASSERT(thread->runnable == nullptr);
+
+    ++activeThreads;
+
+    thread->runnable = runnable;
+
+    // Ensure that the thread has actually finished, otherwise the following
+    // start() has no effect.
+    thread->wait();
+    Q_ASSERT(thread->isFinished());
+    thread->start(threadPriority);
+}
+
+/*!
+    \internal
+
+    Makes one more thread look for work in the per-thread queues, unless the
+    thread limit has been reached. Must be called with the mutex locked.
+*/
+void QThreadPoolPrivate::wakeIdleThread()
+{
+    if (areAllThreadsActive())
+        return;
+
+    if (!waitingThreads.isEmpty())
+        waitingThreads.takeFirst()->runnableReady.wakeOne();
+    else if (!expiredThreads.isEmpty())
+        restartThread(expiredThreads.dequeue());
+    else
+        startThread();
+}
+
+/*!
+    \internal
+
+    Pushes \a runnable onto the queue of the calling thread if work stealing
+    is enabled and the calling thread belongs to this pool. Returns \c false
+    if the runnable has to go through the shared queue instead.
+*/
+bool QThreadPoolPrivate::tryPushLocal(QRunnable *runnable)
+{
+    QThreadPoolThread *thread = currentPoolThread;
+    if (!thread || thread->manager != this || !workStealingEnabled.load(std::memory_order_relaxed))
+        return false;
+
+    if (!thread->workQueue) {
+        QMutexLocker locker(&mutex);
+        if (!assignWorkQueue(thread))
+            return false;
+    }
+
+    const bool wasEmpty = thread->workQueue->isEmpty();
+    if (!thread->workQueue->push(runnable))
+        return false;
+
+    // give an idle thread the chance to steal it
+    if (wasEmpty) {
+        QMutexLocker locker(&mutex);
+        wakeIdleThread();
+    }
+    return true;
+}
+
+/*!
+    \internal
+
+    The tryStart() counterpart of tryPushLocal(): if a thread is waiting for
+    work, pushes \a runnable onto the queue of the calling thread and wakes
+    the waiting thread up, which will steal it unless the calling thread gets
+    to it first. Must be called with the mutex locked.
+*/
+bool QThreadPoolPrivate::tryStartLocal(QRunnable *runnable)
+{
+    QThreadPoolThread *thread = currentPoolThread;
+    if (!thread || thread->manager != this || !workStealingEnabled.load(std::memory_order_relaxed))
+        return false;
+    if (waitingThreads.isEmpty() || areAllThreadsActive())
+        return false;
+    if (!thread->workQueue && !assignWorkQueue(thread))
+        return false;
+    if (!thread->workQueue->push(runnable))
+        return false;
+
+    waitingThreads.takeFirst()->runnableReady.wakeOne();
+    return true;
+}
+
+/*!
+    \internal
+
+    Returns the next task for \a thread from its own queue or another
+    thread's queue, or a nullptr if the thread has to take the lock and look
+    at the shared queue. Called without the mutex locked.
+*/
+QRunnable *QThreadPoolPrivate::takeUnlockedWork(QThreadPoolThread *thread)
+{
+    enum { SharedQueueInterval = 64 };
+
+    if (workQueueCount.loadAcquire() == 0)
+        return nullptr;
+
+    // tasks with a raised priority only ever wait in the shared queue
+    if (priorityWorkQueued.loadRelaxed())
+        return nullptr;
+
+    // don't starve the shared queue
+    if (++thread->unlockedRunCount % SharedQueueInterval == 0)
+        return nullptr;
+
+    bool victimHasMoreWork = false;
+    QRunnable *r = takeQueuedWork(thread, &victimHasMoreWork);
+    if (victimHasMoreWork) {
+        QMutexLocker locker(&mutex);
+        wakeIdleThread();
+    }
+    return r;
+}
+
+/*!
+    \internal
+
+    Pops the newest task off the queue of \a thread, or steals the oldest
+    one from another thread's queue if the former is empty.
+*/
+QRunnable *QThreadPoolPrivate::takeQueuedWork(QThreadPoolThread *thread, bool *victimHasMoreWork)
+{
+    if (thread->workQueue) {
+        if (QRunnable *r = thread->workQueue->pop())
+            return r;
+    }
+    return stealWork(thread, victimHasMoreWork);
+}
+
+/*!
+    \internal
+
+    Steals a task from the queue of a randomly chosen thread other than
+    \a thief. Sets \a victimHasMoreWork if that queue is still not empty,
+    so the caller can wake up another thread to help.
+*/
+QRunnable *QThreadPoolPrivate::stealWork(QThreadPoolThread *thief, bool *victimHasMoreWork)
+{
+    const int count = workQueueCount.loadAcquire();
+    if (count == 0)
+        return nullptr;
+
+    // xorshift32
+    quint32 seed = thief->stealSeed;
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    thief->stealSeed = seed;
+
+    const int start = int(seed % uint(count));
+    for (int i = 0; i < count; ++i) {
+        QThreadPoolWorkQueue *victim = workQueues[(start + i) % count].load(std::memory_order_acquire);
+        if (!victim || victim == thief->workQueue)
+            continue;
+        if (QRunnable *r = victim->steal()) {
+            *victimHasMoreWork = !victim->isEmpty();
+            return r;
+        }
+    }
+    return nullptr;
+}
+
+/*!
+    \internal
+
+    Returns \c true if any of the per-thread queues holds a task.
+*/
+bool QThreadPoolPrivate::hasQueuedWork() const
+{
+    const int count = workQueueCount.loadAcquire();
+    for (int i = 0; i < count; ++i) {
+        if (!workQueues[i].load(std::memory_order_acquire)->isEmpty())
+            return true;
+    }
+    return false;
+}
+
+/*!
+    \internal
+
+    Gives \a thread a queue of its own, reusing the one of a deleted thread
+    if possible. Must be called with the mutex locked.
+*/
+bool QThreadPoolPrivate::assignWorkQueue(QThreadPoolThread *thread)
+{
+    Q_ASSERT(!thread->workQueue);
+    if (!freeWorkQueues.isEmpty()) {
+        thread->workQueue = freeWorkQueues.takeLast();
+        return true;
+    }
+
+    const int count = workQueueCount.loadRelaxed();
+    if (count == MaxWorkQueues)
+        return false;
+    thread->workQueue = new QThreadPoolWorkQueue;
+    workQueues[count].store(thread->workQueue, std::memory_order_release);
+    workQueueCount.storeRelease(count + 1);
+    return true;
+}
+
+/*!
+    \internal
+
+    Moves the tasks left in the queue of \a thread to the shared queue, as
+    the thread is about to stop working. Must be called with the mutex locked.
+*/
+void QThreadPoolPrivate::flushWorkQueue(QThreadPoolThread *thread)
+{
+    if (!thread->workQueue)
+        return;
+    while (QRunnable *r = thread->workQueue->pop())
+        enqueueTask(r);
+}
+
 /*!
     \internal
 
@@ -300,6 +566,12 @@ void QThreadPoolPrivate::reset()
     expiredThreads.clear();
     waitingThreads.clear();
 
+    // the queues of the threads are empty now, keep them for their successors
+    for (QThreadPoolThread *thread : qAsConst(allThreadsCopy)) {
+        if (thread->workQueue)
+            freeWorkQueues.append(std::exchange(thread->workQueue, nullptr));
+    }
+
     mutex.unlock();
 
     for (QThreadPoolThread *thread : qAsConst(allThreadsCopy)) {
@@ -354,6 +626,19 @@ void QThreadPoolPrivate::clear()
         }
         delete page;
     }
+    updatePriorityHint();
+
+    const int count = workQueueCount.loadAcquire();
+    for (int i = 0; i < count; ++i) {
+        QThreadPoolWorkQueue *workQueue = workQueues[i].load(std::memory_order_acquire);
+        while (QRunnable *r = workQueue->steal()) {
+            if (r->autoDelete()) {
+                locker.unlock();
+                delete r;
+                locker.relock();
+            }
+        }
+    }
 }
 
 /*!
@@ -387,10 +672,17 @@ bool QThreadPool::tryTake(QRunnable *runnable)
                 d->queue.removeOne(page);
                 delete page;
             }
+            d->updatePriorityHint();
             return true;
         }
     }
 
+    const int count = d->workQueueCount.loadAcquire();
+    for (int i = 0; i < count; ++i) {
+        if (d->workQueues[i].load(std::memory_order_acquire)->tryTake(runnable))
+            return true;
+    }
+
     return false;
 }
 
@@ -521,6 +813,8 @@ QThreadPool *QThreadPool::globalInstance()
     ownership of \a runnable remains with the caller. Note that
     changing the auto-deletion on \a runnable after calling this
     functions results in undefined behavior.
+
+    \sa workStealingEnabled
 */
 void QThreadPool::start(QRunnable *runnable, int priority)
 {
@@ -528,6 +822,9 @@ void QThreadPool::start(QRunnable *runnable, int priority)
         return;
 
     Q_D(QThreadPool);
+    if (priority == 0 && d->tryPushLocal(runnable))
+        return;
+
     QMutexLocker locker(&d->mutex);
 
     if (!d->tryStart(runnable))
@@ -565,6 +862,8 @@ void QThreadPool::start(std::function<void()> functionToRun, int priority)
     ownership of \a runnable remains with the caller. Note that
     changing the auto-deletion on \a runnable after calling this
     function results in undefined behavior.
+
+    \sa workStealingEnabled
 */
 bool QThreadPool::tryStart(QRunnable *runnable)
 {
@@ -573,7 +872,7 @@ bool QThreadPool::tryStart(QRunnable *runnable)
 
     Q_D(QThreadPool);
     QMutexLocker locker(&d->mutex);
-    if (d->tryStart(runnable))
+    if (d->tryStartLocal(runnable) || d->tryStart(runnable))
         return true;
 
     return false;
@@ -599,7 +898,7 @@ bool QThreadPool::tryStart(std::function<void()> functionToRun)
         return false;
 
     QRunnable *runnable = QRunnable::create(std::move(functionToRun));
-    if (d->tryStart(runnable))
+    if (d->tryStartLocal(runnable) || d->tryStart(runnable))
         return true;
     delete runnable;
     return false;
@@ -753,6 +1052,46 @@ QThread::Priority QThreadPool::threadPriority() const
     return d->threadPriority;
 }
 
+/*! \property QThreadPool::workStealingEnabled
+    \brief whether runnables started from within the pool are queued per thread.
+
+    By default, all queued runnables wait in a single queue that is shared
+    by the worker threads and protected by a lock. When this property is
+    \c true, a runnable that one of this pool's worker threads passes to
+    start() with the default priority is pushed onto a queue owned by that
+    thread instead. The thread picks it up without taking the lock once its
+    current runnable returns, while idle threads steal work from the queues
+    of busy ones. This reduces contention for workloads that recursively
+    split into many small runnables.
+
+    A runnable that succeeds in tryStart() from one of the worker threads,
+    as Qt Concurrent does to spread its work, likewise goes onto that
+    thread's queue, and the idle thread reserved for it steals it from
+    there.
+
+    Runnables started from threads outside of the pool or with a priority
+    other than 0 always go through the shared queue. Queued runnables with
+    a priority greater than 0 are still run before any runnable from the
+    per-thread queues.
+
+    The default value is \c false.
+
+    \since 6.3
+    \sa start()
+*/
+
+void QThreadPool::setWorkStealingEnabled(bool enable)
+{
+    Q_D(QThreadPool);
+    d->workStealingEnabled.store(enable, std::memory_order_relaxed);
+}
+
+bool QThreadPool::isWorkStealingEnabled() const
+{
+    Q_D(const QThreadPool);
+    return d->workStealingEnabled.load(std::memory_order_relaxed);
+}
+
 /*!
     Releases a thread previously reserved by a call to reserveThread().
 
@@ -60,6 +60,8 @@
 #include "QtCore/qqueue.h"
 #include "private/qobject_p.h"
 
+#include <atomic>
+
 QT_REQUIRE_CONFIG(thread);
 
 QT_BEGIN_NAMESPACE
@@ -143,6 +145,104 @@ private:
     QRunnable *m_entries[MaxPageSize];
 };
 
+/*
+    A fixed-size Chase-Lev work-stealing deque. Only the owning thread may
+    push() and pop(); any thread may steal() from the other end or tryTake()
+    a specific runnable.
+
+    Consumers claim an entry by atomically replacing it with a nullptr, so
+    that tryTake() can remove entries from the middle of the deque. The
+    resulting holes are skipped by pop() and steal().
+*/
+class QThreadPoolWorkQueue
+{
+public:
+    enum {
+        Capacity = 1024 // must be a power of two
+    };
+
+    bool isEmpty() const
+    {
+        return m_bottom.load(std::memory_order_relaxed) <= m_top.load(std::memory_order_relaxed);
+    }
+
+    bool push(QRunnable *runnable)
+    {
+        Q_ASSERT(runnable != nullptr);
+        const qint64 b = m_bottom.load(std::memory_order_relaxed);
+        const qint64 t = m_top.load(std::memory_order_acquire);
+        if (b - t >= Capacity)
+            return false;
+        std::atomic<QRunnable *> &entry = m_entries[b & (Capacity - 1)];
+        // a thief may not have claimed the previous occupant of this entry yet
+        if (entry.load(std::memory_order_acquire) != nullptr)
+            return false;
+        entry.store(runnable, std::memory_order_relaxed);
+        m_bottom.store(b + 1, std::memory_order_release);
+        return true;
+    }
+
+    QRunnable *pop()
+    {
+        for (;;) {
+            const qint64 b = m_bottom.load(std::memory_order_relaxed) - 1;
+            m_bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            qint64 t = m_top.load(std::memory_order_relaxed);
+            if (t > b) {
+                m_bottom.store(b + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            if (t == b) {
+                // last entry, race against the thieves for it
+                const bool won = m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                               std::memory_order_relaxed);
+                m_bottom.store(b + 1, std::memory_order_relaxed);
+                if (!won)
+                    return nullptr;
+            }
+            if (QRunnable *runnable = m_entries[b & (Capacity - 1)].exchange(nullptr, std::memory_order_acq_rel))
+                return runnable;
+        }
+    }
+
+    QRunnable *steal()
+    {
+        for (;;) {
+            qint64 t = m_top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const qint64 b = m_bottom.load(std::memory_order_acquire);
+            if (t >= b)
+                return nullptr;
+            std::atomic<QRunnable *> &entry = m_entries[t & (Capacity - 1)];
+            QRunnable *runnable = entry.load(std::memory_order_acquire);
+            if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                               std::memory_order_relaxed)) {
+                return nullptr; // lost the race, let the caller pick another victim
+            }
+            if (runnable && entry.compare_exchange_strong(runnable, nullptr, std::memory_order_acq_rel))
+                return runnable;
+        }
+    }
+
+    bool tryTake(QRunnable *runnable)
+    {
+        const qint64 t = m_top.load(std::memory_order_acquire);
+        const qint64 b = m_bottom.load(std::memory_order_acquire);
+        for (qint64 i = t; i < b; ++i) {
+            QRunnable *expected = runnable;
+            if (m_entries[i & (Capacity - 1)].compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel))
+                return true;
+        }
+        return false;
+    }
+
+private:
+    alignas(64) std::atomic<qint64> m_top = 0;
+    alignas(64) std::atomic<qint64> m_bottom = 0;
+    alignas(64) std::atomic<QRunnable *> m_entries[Capacity] = {};
+};
+
 class QThreadPoolThread;
 class Q_CORE_EXPORT QThreadPoolPrivate : public QObjectPrivate
 {
@@ -151,9 +251,11 @@ class Q_CORE_EXPORT QThreadPoolPrivate : public QObjectPrivate
 
 public:
     QThreadPoolPrivate();
+    ~QThreadPoolPrivate();
 
     bool tryStart(QRunnable *task);
     void enqueueTask(QRunnable *task, int priority = 0);
+    void updatePriorityHint();
     int activeThreadCount() const;
 
     void tryToStartMoreThreads();
@@ -163,6 +265,8 @@ public:
     int maxThreadCount() const
     { return qMax(requestedMaxThreadCount, 1); }    // documentation says we start at least one
     void startThread(QRunnable *runnable = nullptr);
+    void restartThread(QThreadPoolThread *thread, QRunnable *runnable = nullptr);
+    void wakeIdleThread();
     void reset();
     bool waitForDone(int msecs);
     bool waitForDone(const QDeadlineTimer &timer);
@@ -170,6 +274,15 @@ public:
     void stealAndRunRunnable(QRunnable *runnable);
     void deletePageIfFinished(QueuePage *page);
 
+    bool tryPushLocal(QRunnable *runnable);
+    bool tryStartLocal(QRunnable *runnable);
+    QRunnable *takeUnlockedWork(QThreadPoolThread *thread);
+    QRunnable *takeQueuedWork(QThreadPoolThread *thread, bool *victimHasMoreWork);
+    QRunnable *stealWork(QThreadPoolThread *thief, bool *victimHasMoreWork);
+    bool hasQueuedWork() const;
+    bool assignWorkQueue(QThreadPoolThread *thread);
+    void flushWorkQueue(QThreadPoolThread *thread);
+
     mutable QMutex mutex;
     QSet<QThreadPoolThread *> allThreads;
     QQueue<QThreadPoolThread *> waitingThreads;
@@ -184,6 +297,17 @@ public:
     int activeThreads = 0;
     uint stackSize = 0;
     QThread::Priority threadPriority = QThread::InheritPriority;
+
+    // work stealing; the registry only ever grows while the pool is alive,
+    // so that thieves can walk it without holding the mutex
+    enum {
+        MaxWorkQueues = 256
+    };
+    std::atomic<QThreadPoolWorkQueue *> workQueues[MaxWorkQueues] = {};
+    QAtomicInt workQueueCount;
+    QList<QThreadPoolWorkQueue *> freeWorkQueues;
+    QAtomicInt priorityWorkQueued; // a task with priority > 0 waits in the shared queue
+    std::atomic<bool> workStealingEnabled = false;
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,885 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QFLATHASH_P_H
+#define QFLATHASH_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of a number of Qt sources files.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qhash.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qmath.h>
+#include <QtCore/qrefcount.h>
+#include <QtCore/qscopeguard.h>
+#include <QtCore/private/qsimd_p.h>
+
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+QT_BEGIN_NAMESPACE
+
+/*
+  QFlatHash is an implicitly shared, unordered associative container with the
+  same basic API as QHash, but a different memory layout.
+
+  QHash stores its entries in spans of 128 buckets, each bucket holding a one
+  byte offset into the span's entry storage; a lookup in a large hash therefore
+  costs two dependent cache misses (the offset, then the entry). QFlatHash is an
+  open-addressing table in the style of the "Swiss table": next to the slot
+  array there is one control byte per slot, holding either Empty, Deleted, or
+  the low seven bits of the hash of the key stored in the slot. The control
+  bytes are grouped in blocks of 16, and a lookup compares a whole group
+  against the searched hash bits with a single SSE2 or NEON comparison.
+  Probing moves from group to group in a triangular sequence; it ends as soon
+  as a group contains an Empty slot.
+
+  Nodes (key and value) are stored inline in the slot array if both types are
+  relocatable and the node is not larger than a cache line. Otherwise each slot
+  holds a pointer to a heap-allocated node. Either way, the slots can be moved
+  with memcpy when the table grows.
+
+  Iterators and references are invalidated by any insertion (the table may
+  rehash), and by detaching. The iteration order is unspecified.
+*/
+
+namespace QFlatHashPrivate {
+
+enum Control : signed char {
+    Empty = -128,
+    Deleted = -2,
+    // full slots store the seven low bits of the hash, 0 to 127
+};
+
+static constexpr size_t GroupSize = 16;
+
+inline constexpr signed char h2(size_t hash) noexcept
+{
+    return static_cast<signed char>(hash & 0x7f);
+}
+
+inline constexpr size_t h1(size_t hash) noexcept
+{
+    return hash >> 7;
+}
+
+// A set of matching positions inside a group. Each matching byte is
+// represented by one bit, located at bit (position << Shift).
+template <typename T, int Shift>
+struct BitMask
+{
+    T mask;
+
+    explicit constexpr operator bool() const noexcept { return mask != 0; }
+    constexpr uint lowest() const noexcept { return qCountTrailingZeroBits(mask) >> Shift; }
+    constexpr void clearLowest() noexcept { mask &= mask - 1; }
+};
+
+#if defined(__SSE2__)
+struct Group
+{
+    using Mask = BitMask<quint32, 0>;
+    __m128i ctrl;
+
+    explicit Group(const signed char *p) noexcept
+        : ctrl(_mm_load_si128(reinterpret_cast<const __m128i *>(p)))
+    {}
+
+    Mask match(signed char h) const noexcept
+    {
+        return Mask{ quint32(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(h)))) };
+    }
+    Mask matchEmpty() const noexcept
+    {
+        return match(Empty);
+    }
+    Mask matchEmptyOrDeleted() const noexcept
+    {
+        // Empty and Deleted are the only values below -1
+        return Mask{ quint32(_mm_movemask_epi8(_mm_cmplt_epi8(ctrl, _mm_set1_epi8(-1)))) };
+    }
+};
+#elif defined(__ARM_NEON__)
+struct Group
+{
+    // NEON has no movemask; narrow each byte to a nibble instead
+    using Mask = BitMask<quint64, 2>;
+    int8x16_t ctrl;
+
+    explicit Group(const signed char *p) noexcept
+        : ctrl(vld1q_s8(reinterpret_cast<const int8_t *>(p)))
+    {}
+
+    static Mask toMask(uint8x16_t cmp) noexcept
+    {
+        uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4);
+        quint64 m = vget_lane_u64(vreinterpret_u64_u8(nibbles), 0);
+        return Mask{ m & Q_UINT64_C(0x8888888888888888) };
+    }
+    Mask match(signed char h) const noexcept
+    {
+        return toMask(vceqq_s8(ctrl, vdupq_n_s8(h)));
+    }
+    Mask matchEmpty() const noexcept
+    {
+        return match(Empty);
+    }
+    Mask matchEmptyOrDeleted() const noexcept
+    {
+        return toMask(vcltq_s8(ctrl, vdupq_n_s8(-1)));
+    }
+};
+#else
+struct Group
+{
+    using Mask = BitMask<quint32, 0>;
+    const signed char *ctrl;
+
+    explicit Group(const signed char *p) noexcept
+        : ctrl(p)
+    {}
+
+    template <typename Predicate>
+    Mask matchIf(Predicate pred) const noexcept
+    {
+        quint32 m = 0;
+        for (size_t i = 0; i < GroupSize; ++i)
+            m |= quint32(pred(ctrl[i])) << i;
+        return Mask{ m };
+    }
+    Mask match(signed char h) const noexcept
+    {
+        return matchIf([h](signed char c) { return c == h; });
+    }
+    Mask matchEmpty() const noexcept
+    {
+        return match(Empty);
+    }
+    Mask matchEmptyOrDeleted() const noexcept
+    {
+        return matchIf([](signed char c) { return c < -1; });
+    }
+};
+#endif
+
+// Triangular probing over groups; with a power-of-two number of groups this
+// visits every group exactly once.
+struct ProbeSequence
+{
+    size_t group;
+    size_t groupMask;
+    size_t step = 0;
+
+    ProbeSequence(size_t hash, size_t numGroups) noexcept
+        : group(h1(hash) & (numGroups - 1)), groupMask(numGroups - 1)
+    {}
+
+    size_t offset() const noexcept { return group * GroupSize; }
+    void next() noexcept
+    {
+        ++step;
+        group = (group + step) & groupMask;
+    }
+};
+
+template <typename Key, typename T>
+struct Node
+{
+    using KeyType = Key;
+    using ValueType = T;
+
+    Key key;
+    T value;
+
+    template <typename K, typename ...Args>
+    static void createInPlace(Node *n, K &&k, Args &&... args)
+    {
+        new (n) Node{ Key(std::forward<K>(k)), T(std::forward<Args>(args)...) };
+    }
+};
+
+template <typename Node>
+struct Data
+{
+    using Key = typename Node::KeyType;
+    using T = typename Node::ValueType;
+
+    static constexpr bool StoreInline = QTypeInfo<Key>::isRelocatable
+            && QTypeInfo<T>::isRelocatable
+            && sizeof(Node) <= 64;
+    using Slot = std::conditional_t<StoreInline, Node, Node *>;
+
+    static constexpr size_t SlotAlignment = alignof(Slot) > GroupSize ? alignof(Slot) : GroupSize;
+
+    QtPrivate::RefCount ref = {{1}};
+    size_t size = 0;
+    size_t numSlots = 0;
+    size_t growthLeft = 0;
+    size_t seed = 0;
+    signed char *ctrl = nullptr;
+    Slot *entries = nullptr;
+
+    // maximum load factor is 7/8
+    static constexpr size_t capacityForSlots(size_t n) noexcept
+    {
+        return n - n / 8;
+    }
+    static size_t slotsForCapacity(size_t requestedCapacity) noexcept
+    {
+        if (requestedCapacity == 0)
+            return 0;
+        size_t n = requestedCapacity + (requestedCapacity + 6) / 7;
+        if (n <= GroupSize)
+            return GroupSize;
+        return size_t(qNextPowerOfTwo(quint64(n - 1)));
+    }
+    static size_t slotsOffset(size_t n) noexcept
+    {
+        return (n + alignof(Slot) - 1) & ~(alignof(Slot) - 1);
+    }
+
+    void allocate(size_t n)
+    {
+        numSlots = n;
+        growthLeft = capacityForSlots(n) - size;
+        if (!n) {
+            ctrl = nullptr;
+            entries = nullptr;
+            return;
+        }
+        void *storage = ::operator new(slotsOffset(n) + n * sizeof(Slot),
+                                       std::align_val_t(SlotAlignment));
+        ctrl = static_cast<signed char *>(storage);
+        entries = reinterpret_cast<Slot *>(static_cast<char *>(storage) + slotsOffset(n));
+        memset(ctrl, Empty, n);
+    }
+    static void deallocate(signed char *storage) noexcept
+    {
+        if (storage)
+            ::operator delete(storage, std::align_val_t(SlotAlignment));
+    }
+
+    Data(size_t reserve = 0)
+    {
+        allocate(slotsForCapacity(reserve));
+        seed = QHashSeed::globalSeed();
+    }
+    Data(const Data &other, size_t reserved = 0)
+        : seed(other.seed)
+    {
+        const size_t n = reserved ? slotsForCapacity(qMax(other.size, reserved)) : other.numSlots;
+        allocate(n);
+        auto cleanup = qScopeGuard([this] { destroyNodes(); deallocate(ctrl); });
+        if (n == other.numSlots) {
+            // same layout: copy the nodes to the same slots and keep the
+            // tombstones, since lookups probe past groups that have no Empty
+            // slot
+            for (size_t i = 0; i < n; ++i) {
+                if (other.ctrl[i] == Deleted) {
+                    ctrl[i] = Deleted;
+                    --growthLeft;
+                } else if (other.isFull(i)) {
+                    copyNodeAt(i, other.ctrl[i], other.node(i));
+                }
+            }
+            Q_ASSERT(growthLeft == other.growthLeft);
+        } else {
+            for (size_t i = 0; i < other.numSlots; ++i) {
+                if (!other.isFull(i))
+                    continue;
+                const Node &n = other.node(i);
+                const size_t hash = QHashPrivate::calculateHash(n.key, seed);
+                copyNodeAt(findFirstNonFull(hash), h2(hash), n);
+            }
+        }
+        cleanup.dismiss();
+    }
+    ~Data()
+    {
+        destroyNodes();
+        deallocate(ctrl);
+    }
+    Data &operator=(const Data &) = delete;
+
+    static Data *detached(Data *d, size_t size = 0)
+    {
+        if (!d)
+            return new Data(size);
+        Data *dd = new Data(*d, size);
+        if (!d->ref.deref())
+            delete d;
+        return dd;
+    }
+
+    bool isFull(size_t i) const noexcept { return ctrl[i] >= 0; }
+    size_t numGroups() const noexcept { return numSlots / GroupSize; }
+
+    static Node &slotNode(Slot &s) noexcept
+    {
+        if constexpr (StoreInline)
+            return s;
+        else
+            return *s;
+    }
+    Node &node(size_t i) const noexcept { return slotNode(entries[i]); }
+
+    size_t nextFull(size_t i) const noexcept
+    {
+        while (i < numSlots && !isFull(i))
+            ++i;
+        return i;
+    }
+
+    // Returns the slot holding key, or numSlots if there is none.
+    template <typename K>
+    size_t findIndex(const K &key) const noexcept
+    {
+        if (!size)
+            return numSlots;
+        return findIndex(key, QHashPrivate::calculateHash(key, seed));
+    }
+    template <typename K>
+    size_t findIndex(const K &key, size_t hash) const noexcept
+    {
+        Q_ASSERT(numSlots);
+        const signed char h = h2(hash);
+        for (ProbeSequence seq(hash, numGroups()); ; seq.next()) {
+            const Group g(ctrl + seq.offset());
+            for (auto m = g.match(h); m; m.clearLowest()) {
+                const size_t i = seq.offset() + m.lowest();
+                if (qHashEquals(node(i).key, key))
+                    return i;
+            }
+            if (g.matchEmpty())
+                return numSlots;
+        }
+    }
+
+    size_t findFirstNonFull(size_t hash) const noexcept
+    {
+        for (ProbeSequence seq(hash, numGroups()); ; seq.next()) {
+            const auto m = Group(ctrl + seq.offset()).matchEmptyOrDeleted();
+            if (m)
+                return seq.offset() + m.lowest();
+        }
+    }
+
+    struct InsertionResult
+    {
+        size_t index;
+        signed char h2;
+        bool initialized;
+    };
+
+    // Finds the slot for key, or reserves one for it, growing the table if
+    // necessary. A reserved slot is only marked as used by createNodeAt().
+    InsertionResult findOrInsert(const Key &key)
+    {
+        const size_t hash = QHashPrivate::calculateHash(key, seed);
+        if (size) {
+            const size_t i = findIndex(key, hash);
+            if (i != numSlots)
+                return { i, ctrl[i], true };
+        }
+        if (growthLeft == 0) {
+            // grow if at least half of the capacity holds live entries,
+            // otherwise only drop the tombstones
+            const size_t capacity = capacityForSlots(numSlots);
+            rehash(size >= capacity / 2 ? capacity + 1 : capacity);
+        }
+        return { findFirstNonFull(hash), h2(hash), false };
+    }
+
+    void copyNodeAt(size_t i, signed char h, const Node &other)
+    {
+        Q_ASSERT(!isFull(i));
+        if constexpr (StoreInline)
+            new (&entries[i]) Node(other);
+        else
+            entries[i] = new Node(other);
+        if (ctrl[i] == Empty)
+            --growthLeft;
+        ctrl[i] = h;
+        ++size;
+    }
+
+    template <typename K, typename ...Args>
+    Node *createNodeAt(const InsertionResult &r, K &&key, Args &&... args)
+    {
+        Q_ASSERT(!r.initialized);
+        Q_ASSERT(!isFull(r.index));
+        Node *n;
+        if constexpr (StoreInline) {
+            n = &entries[r.index];
+            Node::createInPlace(n, std::forward<K>(key), std::forward<Args>(args)...);
+        } else {
+            n = static_cast<Node *>(::operator new(sizeof(Node)));
+            auto cleanup = qScopeGuard([n] { ::operator delete(n); });
+            Node::createInPlace(n, std::forward<K>(key), std::forward<Args>(args)...);
+            cleanup.dismiss();
+            entries[r.index] = n;
+        }
+        if (ctrl[r.index] == Empty)
+            --growthLeft;
+        ctrl[r.index] = r.h2;
+        ++size;
+        return n;
+    }
+
+    void erase(size_t i) noexcept
+    {
+        Q_ASSERT(isFull(i));
+        if constexpr (StoreInline)
+            entries[i].~Node();
+        else
+            delete entries[i];
+        --size;
+        // If the group still has an Empty slot, no probe sequence ever went
+        // past it, so the slot can become Empty again instead of a tombstone.
+        if (Group(ctrl + (i & ~(GroupSize - 1))).matchEmpty()) {
+            ctrl[i] = Empty;
+            ++growthLeft;
+        } else {
+            ctrl[i] = Deleted;
+        }
+    }
+
+    void rehash(size_t sizeHint = 0)
+    {
+        signed char *oldCtrl = ctrl;
+        Slot *oldSlots = entries;
+        const size_t oldNumSlots = numSlots;
+
+        allocate(slotsForCapacity(qMax(size, sizeHint)));
+        for (size_t i = 0; i < oldNumSlots; ++i) {
+            if (oldCtrl[i] < 0)
+                continue;
+            const size_t hash = QHashPrivate::calculateHash(slotNode(oldSlots[i]).key, seed);
+            const size_t j = findFirstNonFull(hash);
+            // slots are relocatable by construction (see StoreInline)
+            memcpy(static_cast<void *>(entries + j), static_cast<const void *>(oldSlots + i), sizeof(Slot));
+            ctrl[j] = h2(hash);
+        }
+        deallocate(oldCtrl);
+    }
+
+    void destroyNodes() noexcept
+    {
+        if constexpr (StoreInline && std::is_trivially_destructible_v<Node>)
+            return;
+        for (size_t i = 0; i < numSlots; ++i) {
+            if (!isFull(i))
+                continue;
+            if constexpr (StoreInline)
+                entries[i].~Node();
+            else
+                delete entries[i];
+        }
+    }
+};
+
+} // namespace QFlatHashPrivate
+
+template <typename Key, typename T>
+class QFlatHash
+{
+    using Node = QFlatHashPrivate::Node<Key, T>;
+    using Data = QFlatHashPrivate::Data<Node>;
+
+    Data *d = nullptr;
+
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = T;
+    using size_type = qsizetype;
+    using difference_type = qsizetype;
+    using reference = T &;
+    using const_reference = const T &;
+
+    QFlatHash() noexcept = default;
+    QFlatHash(std::initializer_list<std::pair<Key, T>> list)
+        : d(new Data(list.size()))
+    {
+        for (const auto &e : list)
+            insert(e.first, e.second);
+    }
+    QFlatHash(const QFlatHash &other) noexcept
+        : d(other.d)
+    {
+        if (d)
+            d->ref.ref();
+    }
+    ~QFlatHash()
+    {
+        static_assert(std::is_nothrow_destructible_v<Key>, "Types with throwing destructors are not supported in Qt containers.");
+        static_assert(std::is_nothrow_destructible_v<T>, "Types with throwing destructors are not supported in Qt containers.");
+
+        if (d && !d->ref.deref())
+            delete d;
+    }
+
+    QFlatHash &operator=(const QFlatHash &other) noexcept
+    {
+        if (d != other.d) {
+            Data *o = other.d;
+            if (o)
+                o->ref.ref();
+            if (d && !d->ref.deref())
+                delete d;
+            d = o;
+        }
+        return *this;
+    }
+
+    QFlatHash(QFlatHash &&other) noexcept
+        : d(std::exchange(other.d, nullptr))
+    {
+    }
+    QT_MOVE_ASSIGNMENT_OPERATOR_IMPL_VIA_MOVE_AND_SWAP(QFlatHash)
+
+    void swap(QFlatHash &other) noexcept { qSwap(d, other.d); }
+
+    template <typename AKey = Key, typename AT = T>
+    QTypeTraits::compare_eq_result_container<QFlatHash, AKey, AT> operator==(const QFlatHash &other) const
+    {
+        if (d == other.d)
+            return true;
+        if (size() != other.size())
+            return false;
+
+        for (const_iterator it = other.begin(); it != other.end(); ++it) {
+            const_iterator i = find(it.key());
+            if (i == end() || !(i.value() == it.value()))
+                return false;
+        }
+        // all values must be the same as size is the same
+        return true;
+    }
+    template <typename AKey = Key, typename AT = T>
+    QTypeTraits::compare_eq_result_container<QFlatHash, AKey, AT> operator!=(const QFlatHash &other) const
+    { return !(*this == other); }
+
+    qsizetype size() const noexcept { return d ? qsizetype(d->size) : 0; }
+    bool isEmpty() const noexcept { return !d || d->size == 0; }
+
+    qsizetype capacity() const noexcept { return d ? qsizetype(Data::capacityForSlots(d->numSlots)) : 0; }
+    void reserve(qsizetype size)
+    {
+        if (isDetached())
+            d->rehash(size_t(size));
+        else
+            d = Data::detached(d, size_t(size));
+    }
+    void squeeze()
+    {
+        if (capacity())
+            reserve(0);
+    }
+
+    void detach() { if (!d || d->ref.isShared()) d = Data::detached(d); }
+    bool isDetached() const noexcept { return d && !d->ref.isShared(); }
+    bool isSharedWith(const QFlatHash &other) const noexcept { return d == other.d; }
+
+    void clear() noexcept
+    {
+        if (d && !d->ref.deref())
+            delete d;
+        d = nullptr;
+    }
+
+    bool remove(const Key &key)
+    {
+        if (isEmpty()) // prevents detaching shared null
+            return false;
+        const size_t i = d->findIndex(key);
+        if (i == d->numSlots)
+            return false;
+        detach(); // keeps the slot layout, so i stays valid
+        d->erase(i);
+        return true;
+    }
+    T take(const Key &key)
+    {
+        if (isEmpty()) // prevents detaching shared null
+            return T();
+        const size_t i = d->findIndex(key);
+        if (i == d->numSlots)
+            return T();
+        detach();
+        T value = std::move(d->node(i).value);
+        d->erase(i);
+        return value;
+    }
+
+    bool contains(const Key &key) const noexcept
+    {
+        return d && d->findIndex(key) != d->numSlots;
+    }
+
+    T value(const Key &key) const noexcept
+    {
+        return value(key, T());
+    }
+    T value(const Key &key, const T &defaultValue) const noexcept
+    {
+        if (d) {
+            const size_t i = d->findIndex(key);
+            if (i != d->numSlots)
+                return d->node(i).value;
+        }
+        return defaultValue;
+    }
+
+    T &operator[](const Key &key)
+    {
+        const auto copy = isDetached() ? QFlatHash() : *this; // keep 'key' alive across the detach
+        detach();
+        const auto result = d->findOrInsert(key);
+        if (!result.initialized)
+            return d->createNodeAt(result, key)->value;
+        return d->node(result.index).value;
+    }
+    const T operator[](const Key &key) const noexcept
+    {
+        return value(key);
+    }
+
+    QList<Key> keys() const
+    {
+        QList<Key> res;
+        res.reserve(size());
+        for (const_iterator it = begin(); it != end(); ++it)
+            res.append(it.key());
+        return res;
+    }
+    QList<T> values() const
+    {
+        QList<T> res;
+        res.reserve(size());
+        for (const_iterator it = begin(); it != end(); ++it)
+            res.append(it.value());
+        return res;
+    }
+
+    class const_iterator;
+
+    class iterator
+    {
+        friend class QFlatHash;
+        friend class const_iterator;
+
+        const Data *d = nullptr;
+        size_t i = 0;
+
+        iterator(const Data *data, size_t index) noexcept
+            : d(data), i(index)
+        {}
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef T *pointer;
+        typedef T &reference;
+
+        constexpr iterator() noexcept = default;
+
+        const Key &key() const noexcept { return d->node(i).key; }
+        T &value() const noexcept { return d->node(i).value; }
+        T &operator*() const noexcept { return value(); }
+        T *operator->() const noexcept { return &value(); }
+        // iterators of the same hash compare equal iff they point to the same slot
+        bool operator==(const iterator &o) const noexcept { return i == o.i; }
+        bool operator!=(const iterator &o) const noexcept { return i != o.i; }
+
+        iterator &operator++() noexcept
+        {
+            i = d->nextFull(i + 1);
+            return *this;
+        }
+        iterator operator++(int) noexcept
+        {
+            iterator r = *this;
+            ++(*this);
+            return r;
+        }
+
+        bool operator==(const const_iterator &o) const noexcept { return i == o.i; }
+        bool operator!=(const const_iterator &o) const noexcept { return i != o.i; }
+    };
+    friend class iterator;
+
+    class const_iterator
+    {
+        friend class QFlatHash;
+
+        const Data *d = nullptr;
+        size_t i = 0;
+
+        const_iterator(const Data *data, size_t index) noexcept
+            : d(data), i(index)
+        {}
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        constexpr const_iterator() noexcept = default;
+        const_iterator(const iterator &o) noexcept
+            : d(o.d), i(o.i)
+        {}
+
+        const Key &key() const noexcept { return d->node(i).key; }
+        const T &value() const noexcept { return d->node(i).value; }
+        const T &operator*() const noexcept { return value(); }
+        const T *operator->() const noexcept { return &value(); }
+        bool operator==(const const_iterator &o) const noexcept { return i == o.i; }
+        bool operator!=(const const_iterator &o) const noexcept { return i != o.i; }
+
+        const_iterator &operator++() noexcept
+        {
+            i = d->nextFull(i + 1);
+            return *this;
+        }
+        const_iterator operator++(int) noexcept
+        {
+            const_iterator r = *this;
+            ++(*this);
+            return r;
+        }
+    };
+    friend class const_iterator;
+
+    // STL style
+    iterator begin() { detach(); return iterator(d, d->nextFull(0)); }
+    const_iterator begin() const noexcept { return constBegin(); }
+    const_iterator cbegin() const noexcept { return constBegin(); }
+    const_iterator constBegin() const noexcept { return const_iterator(d, d ? d->nextFull(0) : 0); }
+    iterator end() noexcept { return iterator(d, endIndex()); }
+    const_iterator end() const noexcept { return constEnd(); }
+    const_iterator cend() const noexcept { return constEnd(); }
+    const_iterator constEnd() const noexcept { return const_iterator(d, endIndex()); }
+
+    iterator erase(const_iterator it)
+    {
+        Q_ASSERT(it != constEnd());
+        detach();
+        d->erase(it.i);
+        return iterator(d, d->nextFull(it.i + 1));
+    }
+
+    iterator find(const Key &key)
+    {
+        if (isEmpty()) // prevents detaching shared null
+            return end();
+        const size_t i = d->findIndex(key);
+        detach();
+        return iterator(d, i);
+    }
+    const_iterator find(const Key &key) const noexcept
+    {
+        return constFind(key);
+    }
+    const_iterator constFind(const Key &key) const noexcept
+    {
+        if (isEmpty())
+            return constEnd();
+        return const_iterator(d, d->findIndex(key));
+    }
+
+    iterator insert(const Key &key, const T &value)
+    {
+        return emplace(key, value);
+    }
+
+    template <typename ...Args>
+    iterator emplace(const Key &key, Args &&... args)
+    {
+        Key copy = key; // Needs to be explicit for MSVC 2019
+        return emplace(std::move(copy), std::forward<Args>(args)...);
+    }
+
+    template <typename ...Args>
+    iterator emplace(Key &&key, Args &&... args)
+    {
+        if (isDetached()) {
+            if (d->growthLeft == 0) // rehashing might invalidate references into the hash
+                return emplace_helper(std::move(key), T(std::forward<Args>(args)...));
+            return emplace_helper(std::move(key), std::forward<Args>(args)...);
+        }
+        // need to detach, keep a copy around in case args references into the hash
+        const auto copy = *this; // keep 'args' alive across the detach/growth
+        detach();
+        return emplace_helper(std::move(key), std::forward<Args>(args)...);
+    }
+
+private:
+    size_t endIndex() const noexcept { return d ? d->numSlots : 0; }
+
+    template <typename ...Args>
+    iterator emplace_helper(Key &&key, Args &&... args)
+    {
+        const auto result = d->findOrInsert(key);
+        if (!result.initialized)
+            d->createNodeAt(result, std::move(key), std::forward<Args>(args)...);
+        else
+            d->node(result.index).value = T(std::forward<Args>(args)...);
+        return iterator(d, result.index);
+    }
+};
+
+QT_END_NAMESPACE
+
+#endif // QFLATHASH_P_H
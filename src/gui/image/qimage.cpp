@@ -5043,8 +5043,9 @@ void QImage::applyColorTransform(const QColorTransform &transform)
     }
     QImage::Format oldFormat = format();
     if (depth() > 32) {
-        if (format() != QImage::Format_RGBX64 && format() != QImage::Format_RGBA64
-                && format() != QImage::Format_RGBA64_Premultiplied)
+        // Floating point images are transformed directly, keeping colors outside of [0-1]
+        if (!qt_fpColorPrecision(format()) && format() != QImage::Format_RGBX64
+                && format() != QImage::Format_RGBA64 && format() != QImage::Format_RGBA64_Premultiplied)
             *this = std::move(*this).convertToFormat(QImage::Format_RGBA64);
     } else if (format() != QImage::Format_ARGB32 && format() != QImage::Format_RGB32
                 && format() != QImage::Format_ARGB32_Premultiplied) {
@@ -5058,14 +5059,20 @@ void QImage::applyColorTransform(const QColorTransform &transform)
     switch (format()) {
     case Format_ARGB32_Premultiplied:
     case Format_RGBA64_Premultiplied:
+    case Format_RGBA16FPx4_Premultiplied:
+    case Format_RGBA32FPx4_Premultiplied:
         flags = QColorTransformPrivate::Premultiplied;
         break;
     case Format_RGB32:
     case Format_RGBX64:
+    case Format_RGBX16FPx4:
+    case Format_RGBX32FPx4:
         flags = QColorTransformPrivate::InputOpaque;
         break;
     case Format_ARGB32:
     case Format_RGBA64:
+    case Format_RGBA16FPx4:
+    case Format_RGBA32FPx4:
         break;
     default:
         Q_UNREACHABLE();
@@ -5073,7 +5080,21 @@ void QImage::applyColorTransform(const QColorTransform &transform)
 
     std::function<void(int,int)> transformSegment;
 
-    if (depth() > 32) {
+    if (qt_fpColorPrecision(format()) && depth() > 64) {
+        transformSegment = [&](int yStart, int yEnd) {
+            for (int y = yStart; y < yEnd; ++y) {
+                QRgbaFloat32 *scanline = reinterpret_cast<QRgbaFloat32 *>(scanLine(y));
+                transform.d->apply(scanline, scanline, width(), flags);
+            }
+        };
+    } else if (qt_fpColorPrecision(format())) {
+        transformSegment = [&](int yStart, int yEnd) {
+            for (int y = yStart; y < yEnd; ++y) {
+                QRgbaFloat16 *scanline = reinterpret_cast<QRgbaFloat16 *>(scanLine(y));
+                transform.d->apply(scanline, scanline, width(), flags);
+            }
+        };
+    } else if (depth() > 32) {
         transformSegment = [&](int yStart, int yEnd) {
             for (int y = yStart; y < yEnd; ++y) {
                 QRgba64 *scanline = reinterpret_cast<QRgba64 *>(scanLine(y));
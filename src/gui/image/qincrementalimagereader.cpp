@@ -0,0 +1,488 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qincrementalimagereader.h"
+#include "qincrementalimagereader_p.h"
+
+#include "qbuffer.h"
+#include "private/qobject_p.h"
+#ifndef QT_NO_IMAGEFORMAT_PNG
+#include "private/qpnghandler_p.h"
+#endif
+
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QIncrementalImageReader
+    \since 6.3
+
+    \inmodule QtGui
+
+    \brief The QIncrementalImageReader class decodes images from data that
+    arrives in pieces.
+
+    QImageReader decodes a whole image at once from a QIODevice and blocks
+    until all of its data is available. QIncrementalImageReader instead
+    accepts the encoded data as it arrives, for instance from a
+    QNetworkReply, and decodes as much of the image as possible each time
+    addData() is called. This makes it possible to show the first rows of a
+    large image long before the download completes.
+
+    Once the image header has been decoded, sizeAvailable() is emitted and
+    image() returns an image of the final size, where the parts that have
+    not been decoded yet are filled with zeros. Each time new rows have been
+    decoded, rowsDecoded() is emitted with the range of rows that changed.
+    For interlaced images a range of rows is updated once for each pass,
+    getting more detailed every time. When the whole image has been decoded,
+    finished() is emitted. Call finish() when no more data will arrive, to
+    report truncated data as an error.
+
+    \snippet code/src_gui_image_qincrementalimagereader.cpp 0
+
+    PNG images are decoded row by row as their data arrives. For other
+    formats, supportsIncrementalDecoding() returns \c false; their data is
+    collected until finish() is called and then decoded with QImageReader in
+    one go, emitting rowsDecoded() once for all rows. For those formats
+    sizeAvailable() is still emitted as soon as the size can be read from the
+    image header.
+
+    \note This includes JPEG: progressive JPEG images are not shown scan by
+    scan yet, but only once all of their data has arrived.
+
+    If no format is set, it is determined from the first bytes of the data.
+
+    \sa QImageReader, QMovie
+*/
+
+/*!
+    \fn void QIncrementalImageReader::sizeAvailable(const QSize &size)
+
+    This signal is emitted once the \a size of the image is known. From then
+    on, image() returns an image of this size.
+*/
+
+/*!
+    \fn void QIncrementalImageReader::rowsDecoded(int from, int to)
+
+    This signal is emitted when the rows \a from to \a to, inclusive, of
+    image() have been updated with newly decoded data.
+*/
+
+/*!
+    \fn void QIncrementalImageReader::finished()
+
+    This signal is emitted when the image has been decoded completely.
+*/
+
+/*!
+    \fn void QIncrementalImageReader::errorOccurred(QImageReader::ImageReaderError error)
+
+    This signal is emitted when the data can not be decoded. \a error
+    describes the problem, and errorString() gives a human readable
+    description of it.
+*/
+
+class QBufferedImageDecoder : public QIncrementalImageDecoder
+{
+public:
+    explicit QBufferedImageDecoder(const QByteArray &format)
+        : format(format)
+    { }
+
+    bool decode(const char *data, qsizetype length) override;
+    bool finish() override;
+
+private:
+    QByteArray format;
+    QByteArray buffer;
+    // buffer size at which the size is looked for next, or -1 to not look
+    qsizetype nextProbe = 0;
+};
+
+bool QBufferedImageDecoder::decode(const char *data, qsizetype length)
+{
+    buffer.append(data, length);
+    if (!size.isValid() && nextProbe >= 0 && buffer.size() >= nextProbe) {
+        // Most handlers read the size from the header without needing the
+        // rest of the data. Each probe reads the whole buffer, so only probe
+        // again once the data has doubled, and give up once there is enough
+        // data for any header and still no handler recognizes it.
+        constexpr qsizetype MaximumHeaderSize = 4096;
+        QBuffer device(&buffer);
+        device.open(QIODevice::ReadOnly);
+        QImageReader reader(&device, format);
+        if (reader.canRead())
+            size = reader.size();
+        else if (buffer.size() >= MaximumHeaderSize)
+            nextProbe = -1;
+        if (nextProbe >= 0)
+            nextProbe = 2 * buffer.size();
+    }
+    return true;
+}
+
+bool QBufferedImageDecoder::finish()
+{
+    QBuffer device(&buffer);
+    device.open(QIODevice::ReadOnly);
+    QImageReader reader(&device, format);
+    if (!reader.read(&image)) {
+        error = reader.error();
+        errorString = reader.errorString();
+        return false;
+    }
+    buffer.clear();
+    size = image.size();
+    markRowsDecoded(0, image.height() - 1);
+    finished = true;
+    return true;
+}
+
+QIncrementalImageDecoder::~QIncrementalImageDecoder()
+    = default;
+
+class QIncrementalImageReaderPrivate : public QObjectPrivate
+{
+    Q_DECLARE_PUBLIC(QIncrementalImageReader)
+public:
+    enum State {
+        Ready,
+        Decoding,
+        Finished,
+        Error
+    };
+
+    bool createDecoder(bool endOfData);
+    void decoded(bool ok);
+
+    QByteArray format;
+    QByteArray pendingData;
+    std::unique_ptr<QIncrementalImageDecoder> decoder;
+    QImageReader::ImageReaderError error = QImageReader::UnknownError;
+    QString errorString;
+    // incremented by reset(), which slots may call while signals are emitted
+    quint32 generation = 0;
+    bool sizeReported = false;
+    State state = Ready;
+};
+
+static const char pngSignature[] = "\x89\x50\x4E\x47\x0D\x0A\x1A\x0A";
+
+static bool isPngFormat(const QByteArray &format)
+{
+    return format.compare("png", Qt::CaseInsensitive) == 0;
+}
+
+/*!
+    \internal
+
+    Picks a decoder once the format is known, either because it was set or
+    because enough data has arrived to recognize it. Returns \c false if more
+    data is needed first.
+*/
+bool QIncrementalImageReaderPrivate::createDecoder(bool endOfData)
+{
+    const qsizetype signatureLength = sizeof(pngSignature) - 1;
+    if (format.isEmpty() && pendingData.size() < signatureLength && !endOfData)
+        return false;
+
+#if !defined(QT_NO_IMAGEFORMAT_PNG)
+    if (isPngFormat(format) || (format.isEmpty() && pendingData.startsWith(pngSignature)))
+        decoder.reset(QPngHandler::createIncrementalDecoder());
+#endif
+    if (!decoder)
+        decoder.reset(new QBufferedImageDecoder(format));
+    state = Decoding;
+    return true;
+}
+
+/*!
+    \internal
+
+    Reports the progress of the decoder after it has been handed data.
+*/
+void QIncrementalImageReaderPrivate::decoded(bool ok)
+{
+    Q_Q(QIncrementalImageReader);
+    // Collect everything before emitting anything: a slot may call reset(),
+    // which destroys the decoder.
+    const quint32 currentGeneration = generation;
+    const QSize size = decoder->size;
+    const bool reportSize = !sizeReported && size.isValid();
+    int from = -1, to = -1;
+    const bool reportRows = decoder->takeDecodedRows(&from, &to);
+    const bool finished = ok && decoder->finished;
+    if (!ok) {
+        error = decoder->error;
+        errorString = decoder->errorString;
+        if (errorString.isEmpty())
+            errorString = QImageReader::tr("Unable to read image data");
+    }
+
+    if (reportSize) {
+        sizeReported = true;
+        emit q->sizeAvailable(size);
+        if (generation != currentGeneration)
+            return;
+    }
+
+    if (reportRows) {
+        emit q->rowsDecoded(from, to);
+        if (generation != currentGeneration)
+            return;
+    }
+
+    if (!ok) {
+        state = Error;
+        emit q->errorOccurred(error);
+    } else if (finished) {
+        state = Finished;
+        emit q->finished();
+    }
+}
+
+/*!
+    Constructs a QIncrementalImageReader object with the given \a parent.
+    The format of the image is determined from its data.
+*/
+QIncrementalImageReader::QIncrementalImageReader(QObject *parent)
+    : QObject(*new QIncrementalImageReaderPrivate, parent)
+{
+}
+
+/*!
+    Constructs a QIncrementalImageReader object with the given \a parent,
+    which decodes images of the given \a format.
+*/
+QIncrementalImageReader::QIncrementalImageReader(const QByteArray &format, QObject *parent)
+    : QObject(*new QIncrementalImageReaderPrivate, parent)
+{
+    Q_D(QIncrementalImageReader);
+    d->format = format;
+}
+
+/*!
+    Destroys the QIncrementalImageReader object.
+*/
+QIncrementalImageReader::~QIncrementalImageReader()
+{
+}
+
+/*!
+    Sets the format of the image to \a format. This must be done before
+    any data is added. If \a format is empty, the format is determined
+    from the data.
+
+    \sa format()
+*/
+void QIncrementalImageReader::setFormat(const QByteArray &format)
+{
+    Q_D(QIncrementalImageReader);
+    if (d->state != QIncrementalImageReaderPrivate::Ready || !d->pendingData.isEmpty()) {
+        qWarning("QIncrementalImageReader::setFormat: Cannot change the format while decoding");
+        return;
+    }
+    d->format = format;
+}
+
+/*!
+    Returns the format set with setFormat() or in the constructor.
+
+    \sa setFormat()
+*/
+QByteArray QIncrementalImageReader::format() const
+{
+    Q_D(const QIncrementalImageReader);
+    return d->format;
+}
+
+/*!
+    Returns \c true if images of the given \a format are decoded while
+    their data arrives; otherwise returns \c false, in which case the
+    data is decoded once finish() is called.
+*/
+bool QIncrementalImageReader::supportsIncrementalDecoding(const QByteArray &format)
+{
+#if !defined(QT_NO_IMAGEFORMAT_PNG)
+    if (isPngFormat(format)) {
+        std::unique_ptr<QIncrementalImageDecoder> decoder(QPngHandler::createIncrementalDecoder());
+        return decoder != nullptr;
+    }
+#else
+    Q_UNUSED(format);
+#endif
+    return false;
+}
+
+/*!
+    Returns the size of the image, or an invalid size if it is not known
+    yet.
+
+    \sa sizeAvailable()
+*/
+QSize QIncrementalImageReader::size() const
+{
+    Q_D(const QIncrementalImageReader);
+    return d->decoder ? d->decoder->size : QSize();
+}
+
+/*!
+    Returns the image decoded so far. The rows that have not been decoded
+    yet are filled with zeros. Returns a null image if the size of the
+    image is not known yet.
+
+    \sa rowsDecoded()
+*/
+QImage QIncrementalImageReader::image() const
+{
+    Q_D(const QIncrementalImageReader);
+    return d->decoder ? d->decoder->image : QImage();
+}
+
+/*!
+    Returns \c true if the image has been decoded completely; otherwise
+    returns \c false.
+
+    \sa finished()
+*/
+bool QIncrementalImageReader::isFinished() const
+{
+    Q_D(const QIncrementalImageReader);
+    return d->state == QIncrementalImageReaderPrivate::Finished;
+}
+
+/*!
+    Returns the type of the last error that occurred.
+
+    \sa errorString(), errorOccurred()
+*/
+QImageReader::ImageReaderError QIncrementalImageReader::error() const
+{
+    Q_D(const QIncrementalImageReader);
+    return d->error;
+}
+
+/*!
+    Returns a human readable description of the last error that occurred.
+
+    \sa error()
+*/
+QString QIncrementalImageReader::errorString() const
+{
+    Q_D(const QIncrementalImageReader);
+    if (d->errorString.isEmpty())
+        return QImageReader::tr("Unknown error");
+    return d->errorString;
+}
+
+/*!
+    Decodes as much of the image as possible after appending \a data to the
+    data received so far. The signals reporting the progress are emitted
+    before this function returns.
+
+    Data added after the image has been decoded completely, or after an
+    error occurred, is ignored.
+*/
+void QIncrementalImageReader::addData(const QByteArray &data)
+{
+    Q_D(QIncrementalImageReader);
+    if (d->state == QIncrementalImageReaderPrivate::Finished
+            || d->state == QIncrementalImageReaderPrivate::Error || data.isEmpty()) {
+        return;
+    }
+
+    if (!d->decoder) {
+        d->pendingData += data;
+        if (!d->createDecoder(false))
+            return;
+        const QByteArray pendingData = std::exchange(d->pendingData, QByteArray());
+        d->decoded(d->decoder->decode(pendingData.constData(), pendingData.size()));
+        return;
+    }
+
+    d->decoded(d->decoder->decode(data.constData(), data.size()));
+}
+
+/*!
+    Tells the reader that no more data will arrive. If the image has not
+    been decoded completely by then, errorOccurred() is emitted, while
+    image() keeps the part that was decoded.
+*/
+void QIncrementalImageReader::finish()
+{
+    Q_D(QIncrementalImageReader);
+    if (d->state == QIncrementalImageReaderPrivate::Finished
+            || d->state == QIncrementalImageReaderPrivate::Error) {
+        return;
+    }
+
+    if (!d->decoder) {
+        d->createDecoder(true);
+        const QByteArray pendingData = std::exchange(d->pendingData, QByteArray());
+        if (!d->decoder->decode(pendingData.constData(), pendingData.size())) {
+            d->decoded(false);
+            return;
+        }
+    }
+
+    d->decoded(d->decoder->finish());
+}
+
+/*!
+    Discards the image and all data received so far, so that a new image
+    can be decoded.
+*/
+void QIncrementalImageReader::reset()
+{
+    Q_D(QIncrementalImageReader);
+    d->decoder.reset();
+    d->pendingData.clear();
+    d->error = QImageReader::UnknownError;
+    d->errorString.clear();
+    d->sizeReported = false;
+    d->state = QIncrementalImageReaderPrivate::Ready;
+    ++d->generation;
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qincrementalimagereader.cpp"
@@ -0,0 +1,103 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QINCREMENTALIMAGEREADER_P_H
+#define QINCREMENTALIMAGEREADER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtGui/private/qtguiglobal_p.h>
+#include <QtGui/qimage.h>
+#include <QtGui/qimagereader.h>
+
+QT_BEGIN_NAMESPACE
+
+// Backend of QIncrementalImageReader. Implementations decode the data handed to
+// decode() as far as possible, write finished rows into image and report them
+// with markRowsDecoded().
+class QIncrementalImageDecoder
+{
+public:
+    virtual ~QIncrementalImageDecoder();
+
+    // Returns false if the data could not be decoded
+    virtual bool decode(const char *data, qsizetype length) = 0;
+    // Called when no more data will arrive; returns false if the image is incomplete
+    virtual bool finish() = 0;
+
+    void markRowsDecoded(int from, int to)
+    {
+        firstDecodedRow = firstDecodedRow < 0 ? from : qMin(firstDecodedRow, from);
+        lastDecodedRow = qMax(lastDecodedRow, to);
+    }
+
+    bool takeDecodedRows(int *from, int *to)
+    {
+        if (firstDecodedRow < 0)
+            return false;
+        *from = firstDecodedRow;
+        *to = lastDecodedRow;
+        firstDecodedRow = lastDecodedRow = -1;
+        return true;
+    }
+
+    QImage image;
+    QSize size;
+    bool finished = false;
+    QImageReader::ImageReaderError error = QImageReader::InvalidDataError;
+    QString errorString;
+
+private:
+    int firstDecodedRow = -1;
+    int lastDecodedRow = -1;
+};
+
+QT_END_NAMESPACE
+
+#endif // QINCREMENTALIMAGEREADER_P_H
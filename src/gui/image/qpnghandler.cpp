@@ -49,6 +49,7 @@
 #include <qvariant.h>
 
 #include <private/qimage_p.h> // for qt_getImageText
+#include <private/qincrementalimagereader_p.h>
 
 #include <qcolorspace.h>
 #include <private/qcolorspace_p.h>
@@ -56,6 +57,8 @@
 #include <png.h>
 #include <pngconf.h>
 
+#include <limits>
+
 #if PNG_LIBPNG_VER >= 10400 && PNG_LIBPNG_VER <= 10502 \
         && defined(PNG_PEDANTIC_WARNINGS_SUPPORTED)
 /*
@@ -130,6 +133,7 @@ public:
     bool readPngHeader();
     bool readPngImage(QImage *image);
     void readPngTexts(png_info *info);
+    void readPngColorSpace();
 
     QImage::Format readImageFormat();
 
@@ -576,7 +580,14 @@ bool QPngHandlerPrivate::readPngHeader()
     png_read_info(png_ptr, info_ptr);
 
     readPngTexts(info_ptr);
+    readPngColorSpace();
+
+    state = ReadHeader;
+    return true;
+}
 
+void QPngHandlerPrivate::readPngColorSpace()
+{
 #ifdef PNG_iCCP_SUPPORTED
     if (png_get_valid(png_ptr, info_ptr, PNG_INFO_iCCP)) {
         png_charp name = nullptr;
@@ -635,9 +646,6 @@ bool QPngHandlerPrivate::readPngHeader()
             colorSpaceState = GammaChrm;
         }
     }
-
-    state = ReadHeader;
-    return true;
 }
 
 bool QPngHandlerPrivate::readPngImage(QImage *outImage)
@@ -783,6 +791,180 @@ QImage::Format QPngHandlerPrivate::readImageFormat()
         return format;
 }
 
+#ifdef PNG_PROGRESSIVE_READ_SUPPORTED
+class QPngIncrementalDecoder : public QIncrementalImageDecoder
+{
+public:
+    QPngIncrementalDecoder()
+        : d(nullptr), checkPalette(false)
+    { }
+    ~QPngIncrementalDecoder();
+
+    bool begin();
+    bool decode(const char *data, qsizetype length) override;
+    bool finish() override;
+
+    bool readInfo();
+    void readRow(png_bytep row, png_uint_32 rowNumber);
+    void readEnd();
+
+private:
+    QPngHandlerPrivate d;
+    bool checkPalette;
+};
+
+extern "C" {
+static void qt_png_info_fn(png_structp png_ptr, png_infop)
+{
+    QPngIncrementalDecoder *decoder = (QPngIncrementalDecoder *)png_get_progressive_ptr(png_ptr);
+    if (!decoder->readInfo())
+        png_error(png_ptr, "Could not allocate image");
+}
+
+static void qt_png_row_fn(png_structp png_ptr, png_bytep row, png_uint_32 rowNumber, int /*pass*/)
+{
+    QPngIncrementalDecoder *decoder = (QPngIncrementalDecoder *)png_get_progressive_ptr(png_ptr);
+    decoder->readRow(row, rowNumber);
+}
+
+static void qt_png_end_fn(png_structp png_ptr, png_infop)
+{
+    QPngIncrementalDecoder *decoder = (QPngIncrementalDecoder *)png_get_progressive_ptr(png_ptr);
+    decoder->readEnd();
+}
+}
+
+QPngIncrementalDecoder::~QPngIncrementalDecoder()
+{
+    if (d.png_ptr)
+        png_destroy_read_struct(&d.png_ptr, &d.info_ptr, nullptr);
+}
+
+bool QPngIncrementalDecoder::begin()
+{
+    d.png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+    if (!d.png_ptr)
+        return false;
+
+    png_set_error_fn(d.png_ptr, nullptr, nullptr, qt_png_warning);
+
+#if defined(PNG_SET_OPTION_SUPPORTED) && defined(PNG_MAXIMUM_INFLATE_WINDOW)
+    png_set_option(d.png_ptr, PNG_MAXIMUM_INFLATE_WINDOW, PNG_OPTION_ON);
+#endif
+
+    d.info_ptr = png_create_info_struct(d.png_ptr);
+    if (!d.info_ptr) {
+        png_destroy_read_struct(&d.png_ptr, nullptr, nullptr);
+        d.png_ptr = nullptr;
+        return false;
+    }
+
+    png_set_progressive_read_fn(d.png_ptr, this, qt_png_info_fn, qt_png_row_fn, qt_png_end_fn);
+    d.state = QPngHandlerPrivate::ReadHeader;
+    return true;
+}
+
+bool QPngIncrementalDecoder::decode(const char *data, qsizetype length)
+{
+    if (d.state == QPngHandlerPrivate::Error)
+        return false;
+    if (finished)
+        return true;
+
+    if (setjmp(png_jmpbuf(d.png_ptr))) {
+        png_destroy_read_struct(&d.png_ptr, &d.info_ptr, nullptr);
+        d.png_ptr = nullptr;
+        d.state = QPngHandlerPrivate::Error;
+        return false;
+    }
+
+    // png_process_data() takes at most png_size_t bytes at a time
+    while (length > 0 && !finished) {
+        const png_size_t chunk = png_size_t(qMin<quint64>(length, std::numeric_limits<png_size_t>::max()));
+        png_process_data(d.png_ptr, d.info_ptr, (png_bytep)data, chunk);
+        data += chunk;
+        length -= chunk;
+    }
+
+    if (finished) {
+        png_destroy_read_struct(&d.png_ptr, &d.info_ptr, nullptr);
+        d.png_ptr = nullptr;
+        d.state = QPngHandlerPrivate::Ready;
+    }
+    return true;
+}
+
+bool QPngIncrementalDecoder::finish()
+{
+    if (finished)
+        return true;
+    if (d.state != QPngHandlerPrivate::Error) {
+        error = QImageReader::InvalidDataError;
+        errorString = QImageReader::tr("Premature end of image data");
+    }
+    return false;
+}
+
+bool QPngIncrementalDecoder::readInfo()
+{
+    d.readPngColorSpace();
+
+    if (!setup_qt(image, d.png_ptr, d.info_ptr, QSize(), nullptr)) {
+        image = QImage();
+        error = QImageReader::InvalidDataError;
+        errorString = QImageReader::tr("Image is too large");
+        return false;
+    }
+    // Rows that have not been decoded yet are shown as transparent or black
+    image.fill(0);
+
+    png_int_32 offset_x = 0;
+    png_int_32 offset_y = 0;
+    int unit_type = PNG_OFFSET_PIXEL;
+    png_get_oFFs(d.png_ptr, d.info_ptr, &offset_x, &offset_y, &unit_type);
+    image.setDotsPerMeterX(png_get_x_pixels_per_meter(d.png_ptr, d.info_ptr));
+    image.setDotsPerMeterY(png_get_y_pixels_per_meter(d.png_ptr, d.info_ptr));
+    if (unit_type == PNG_OFFSET_PIXEL)
+        image.setOffset(QPoint(offset_x, offset_y));
+    if (d.colorSpaceState > QPngHandlerPrivate::Undefined && d.colorSpace.isValid())
+        image.setColorSpace(d.colorSpace);
+
+    checkPalette = png_get_color_type(d.png_ptr, d.info_ptr) == PNG_COLOR_TYPE_PALETTE
+                   && image.format() == QImage::Format_Indexed8;
+    size = image.size();
+    return true;
+}
+
+void QPngIncrementalDecoder::readRow(png_bytep row, png_uint_32 rowNumber)
+{
+    // Interlaced images hand out null rows for rows not changed by the current pass
+    if (!row || rowNumber >= png_uint_32(image.height()))
+        return;
+
+    uchar *scanLine = image.scanLine(rowNumber);
+    png_progressive_combine_row(d.png_ptr, scanLine, row);
+
+    // sanity check palette entries
+    if (checkPalette) {
+        const int colorTableSize = image.colorCount();
+        for (uchar *p = scanLine, *end = scanLine + image.width(); p < end; ++p) {
+            if (*p >= colorTableSize)
+                *p = 0;
+        }
+    }
+    markRowsDecoded(rowNumber, rowNumber);
+}
+
+void QPngIncrementalDecoder::readEnd()
+{
+    // Text chunks both before and after the image data end up in info_ptr
+    d.readPngTexts(d.info_ptr);
+    for (int i = 0; i < d.readTexts.size() - 1; i += 2)
+        image.setText(d.readTexts.at(i), d.readTexts.at(i + 1));
+    finished = true;
+}
+#endif // PNG_PROGRESSIVE_READ_SUPPORTED
+
 QPNGImageWriter::QPNGImageWriter(QIODevice* iod) :
     dev(iod),
     frames_written(0),
@@ -1214,6 +1396,26 @@ bool QPngHandler::canRead(QIODevice *device)
     return device->peek(8) == "\x89\x50\x4E\x47\x0D\x0A\x1A\x0A";
 }
 
+/*!
+    \internal
+
+    Returns a decoder for QIncrementalImageReader that decodes PNG data as it
+    arrives, or \nullptr if libpng does not support progressive reading.
+*/
+QIncrementalImageDecoder *QPngHandler::createIncrementalDecoder()
+{
+#ifdef PNG_PROGRESSIVE_READ_SUPPORTED
+    QPngIncrementalDecoder *decoder = new QPngIncrementalDecoder;
+    if (!decoder->begin()) {
+        delete decoder;
+        return nullptr;
+    }
+    return decoder;
+#else
+    return nullptr;
+#endif
+}
+
 bool QPngHandler::read(QImage *image)
 {
     if (!canRead())
@@ -58,6 +58,7 @@
 
 QT_BEGIN_NAMESPACE
 
+class QIncrementalImageDecoder;
 class QPngHandlerPrivate;
 class QPngHandler : public QImageIOHandler
 {
@@ -74,6 +75,7 @@ public:
     bool supportsOption(ImageOption option) const override;
 
     static bool canRead(QIODevice *device);
+    static QIncrementalImageDecoder *createIncrementalDecoder();
 
 private:
     QPngHandlerPrivate *d;
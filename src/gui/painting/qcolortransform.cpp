@@ -248,6 +248,7 @@ QColor QColorTransform::map(const QColor &color) const
 
 // Optimized sub-routines for fast block based conversion:
 
+template<bool DoClamp = true>
 static void applyMatrix(QColorVector *buffer, const qsizetype len, const QColorMatrix &colorMatrix)
 {
 #if defined(__SSE2__)
@@ -267,8 +268,10 @@ static void applyMatrix(QColorVector *buffer, const qsizetype len, const QColorM
         cx = _mm_add_ps(cx, cy);
         cx = _mm_add_ps(cx, cz);
         // Clamp:
-        cx = _mm_min_ps(cx, maxV);
-        cx = _mm_max_ps(cx, minV);
+        if (DoClamp) {
+            cx = _mm_min_ps(cx, maxV);
+            cx = _mm_max_ps(cx, minV);
+        }
         _mm_storeu_ps(&buffer[j].x, cx);
     }
 #elif defined(__ARM_NEON__)
@@ -285,16 +288,22 @@ static void applyMatrix(QColorVector *buffer, const qsizetype len, const QColorM
         cx = vaddq_f32(cx, cy);
         cx = vaddq_f32(cx, cz);
         // Clamp:
-        cx = vminq_f32(cx, maxV);
-        cx = vmaxq_f32(cx, minV);
+        if (DoClamp) {
+            cx = vminq_f32(cx, maxV);
+            cx = vmaxq_f32(cx, minV);
+        }
         vst1q_f32(&buffer[j].x, cx);
     }
 #else
     for (int j = 0; j < len; ++j) {
         const QColorVector cv = colorMatrix.map(buffer[j]);
-        buffer[j].x = std::max(0.0f, std::min(1.0f, cv.x));
-        buffer[j].y = std::max(0.0f, std::min(1.0f, cv.y));
-        buffer[j].z = std::max(0.0f, std::min(1.0f, cv.z));
+        if (DoClamp) {
+            buffer[j].x = std::max(0.0f, std::min(1.0f, cv.x));
+            buffer[j].y = std::max(0.0f, std::min(1.0f, cv.y));
+            buffer[j].z = std::max(0.0f, std::min(1.0f, cv.z));
+        } else {
+            buffer[j] = cv;
+        }
     }
 #endif
 }
@@ -870,6 +879,145 @@ static void storeOpaque(QRgba64 *dst, const QRgba64 *src, const QColorVector *bu
 }
 #endif
 
+// Floating point pixels can be outside of the [0-1] range. Values inside the range use the
+// lookup tables, interpolating between their entries to keep the precision of the formats,
+// while values outside of it are converted with the transfer functions.
+static inline float lookupInterpolated(const ushort *table, float f)
+{
+    const float fidx = f * (255 * 16);
+    const int idx = std::min(int(fidx), 255 * 16 - 1);
+    const float frac = fidx - idx;
+    return (table[idx] + (table[idx + 1] - table[idx]) * frac) * (1.0f / (255 * 256));
+}
+
+static inline float toLinearF32(const QColorSpacePrivate *cs, int i, float f)
+{
+    if (f >= 0.0f && f <= 1.0f)
+        return lookupInterpolated(cs->lut[i]->m_toLinear, f);
+    return cs->trc[i].applyExtended(f);
+}
+
+static inline float fromLinearF32(const QColorSpacePrivate *cs, int i, float f)
+{
+    if (f >= 0.0f && f <= 1.0f)
+        return lookupInterpolated(cs->lut[i]->m_fromLinear, f);
+    return cs->trc[i].applyInverseExtended(f);
+}
+
+#if defined(__SSE2__)
+// Looks up the red, green and blue channels of \a v in their tables at once.
+// Returns false if a channel is outside of [0-1] and can not use the tables.
+static inline bool lookupInterpolated(const ushort *const tables[3], __m128 v, __m128 &result)
+{
+    const __m128 inRange = _mm_and_ps(_mm_cmpge_ps(v, _mm_setzero_ps()), _mm_cmple_ps(v, _mm_set1_ps(1.0f)));
+    if ((_mm_movemask_ps(inRange) & 0x7) != 0x7)
+        return false;
+    const __m128 vf = _mm_mul_ps(v, _mm_set1_ps(255 * 16));
+    const __m128i vidx = _mm_cvttps_epi32(_mm_min_ps(vf, _mm_set1_ps(255 * 16 - 1)));
+    const __m128 frac = _mm_sub_ps(vf, _mm_cvtepi32_ps(vidx));
+    const int ridx = _mm_cvtsi128_si32(vidx);
+    const int gidx = _mm_extract_epi16(vidx, 2);
+    const int bidx = _mm_extract_epi16(vidx, 4);
+    const __m128 lo = _mm_setr_ps(tables[0][ridx], tables[1][gidx], tables[2][bidx], 0.0f);
+    const __m128 hi = _mm_setr_ps(tables[0][ridx + 1], tables[1][gidx + 1], tables[2][bidx + 1], 0.0f);
+    const __m128 vr = _mm_add_ps(lo, _mm_mul_ps(_mm_sub_ps(hi, lo), frac));
+    result = _mm_mul_ps(vr, _mm_set1_ps(1.0f / (255 * 256)));
+    return true;
+}
+#endif
+
+static inline QColorVector toLinearF32(const QColorSpacePrivate *cs, const QRgbaFloat32 &p)
+{
+#if defined(__SSE2__)
+    const ushort *const tables[3] = { cs->lut[0]->m_toLinear, cs->lut[1]->m_toLinear, cs->lut[2]->m_toLinear };
+    __m128 v;
+    if (lookupInterpolated(tables, _mm_loadu_ps(&p.r), v)) {
+        alignas(16) float c[4];
+        _mm_store_ps(c, v);
+        return QColorVector(c[0], c[1], c[2]);
+    }
+#endif
+    return QColorVector(toLinearF32(cs, 0, p.r), toLinearF32(cs, 1, p.g), toLinearF32(cs, 2, p.b));
+}
+
+static inline QRgbaFloat32 fromLinearF32(const QColorSpacePrivate *cs, const QColorVector &c, float a)
+{
+#if defined(__SSE2__)
+    const ushort *const tables[3] = { cs->lut[0]->m_fromLinear, cs->lut[1]->m_fromLinear, cs->lut[2]->m_fromLinear };
+    __m128 v;
+    if (lookupInterpolated(tables, _mm_setr_ps(c.x, c.y, c.z, 0.0f), v)) {
+        QRgbaFloat32 p;
+        _mm_storeu_ps(&p.r, v);
+        p.a = a;
+        return p;
+    }
+#endif
+    return QRgbaFloat32{fromLinearF32(cs, 0, c.x), fromLinearF32(cs, 1, c.y), fromLinearF32(cs, 2, c.z), a};
+}
+
+static void loadUnpremultiplied(QColorVector *buffer, const QRgbaFloat32 *src, const qsizetype len,
+                                const QColorTransformPrivate *d_ptr)
+{
+    const QColorSpacePrivate *cs = d_ptr->colorSpaceIn.constData();
+    for (qsizetype i = 0; i < len; ++i)
+        buffer[i] = toLinearF32(cs, src[i]);
+}
+
+static void loadPremultiplied(QColorVector *buffer, const QRgbaFloat32 *src, const qsizetype len,
+                              const QColorTransformPrivate *d_ptr)
+{
+    const QColorSpacePrivate *cs = d_ptr->colorSpaceIn.constData();
+#if defined(__SSE2__)
+    const ushort *const tables[3] = { cs->lut[0]->m_toLinear, cs->lut[1]->m_toLinear, cs->lut[2]->m_toLinear };
+    for (qsizetype i = 0; i < len; ++i) {
+        // Unpremultiply like QRgbaFloat32::unpremultiplied(), without branching on alpha
+        __m128 v = _mm_loadu_ps(&src[i].r);
+        const __m128 va = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+        const __m128 vOpaque = _mm_cmpge_ps(va, _mm_set1_ps(1.0f));
+        const __m128 vu = _mm_mul_ps(v, _mm_div_ps(_mm_set1_ps(1.0f), va));
+        v = _mm_or_ps(_mm_and_ps(vOpaque, v), _mm_andnot_ps(vOpaque, vu));
+        v = _mm_and_ps(v, _mm_cmpgt_ps(va, _mm_setzero_ps()));
+        __m128 c;
+        alignas(16) float f[4];
+        if (lookupInterpolated(tables, v, c)) {
+            _mm_store_ps(f, c);
+            buffer[i] = QColorVector(f[0], f[1], f[2]);
+        } else {
+            _mm_store_ps(f, v);
+            buffer[i] = QColorVector(toLinearF32(cs, 0, f[0]), toLinearF32(cs, 1, f[1]), toLinearF32(cs, 2, f[2]));
+        }
+    }
+#else
+    for (qsizetype i = 0; i < len; ++i)
+        buffer[i] = toLinearF32(cs, src[i].unpremultiplied());
+#endif
+}
+
+static void storePremultiplied(QRgbaFloat32 *dst, const QRgbaFloat32 *src, const QColorVector *buffer,
+                               const qsizetype len, const QColorTransformPrivate *d_ptr)
+{
+    const QColorSpacePrivate *cs = d_ptr->colorSpaceOut.constData();
+    for (qsizetype i = 0; i < len; ++i)
+        dst[i] = fromLinearF32(cs, buffer[i], src[i].a).premultiplied();
+}
+
+static void storeUnpremultiplied(QRgbaFloat32 *dst, const QRgbaFloat32 *src, const QColorVector *buffer,
+                                 const qsizetype len, const QColorTransformPrivate *d_ptr)
+{
+    const QColorSpacePrivate *cs = d_ptr->colorSpaceOut.constData();
+    for (qsizetype i = 0; i < len; ++i)
+        dst[i] = fromLinearF32(cs, buffer[i], src[i].a);
+}
+
+static void storeOpaque(QRgbaFloat32 *dst, const QRgbaFloat32 *src, const QColorVector *buffer,
+                        const qsizetype len, const QColorTransformPrivate *d_ptr)
+{
+    Q_UNUSED(src);
+    const QColorSpacePrivate *cs = d_ptr->colorSpaceOut.constData();
+    for (qsizetype i = 0; i < len; ++i)
+        dst[i] = fromLinearF32(cs, buffer[i], 1.0f);
+}
+
 static void storeGray(quint8 *dst, const QRgb *src, const QColorVector *buffer, const qsizetype len,
                       const QColorTransformPrivate *d_ptr)
 {
@@ -888,6 +1036,18 @@ static void storeGray(quint16 *dst, const QRgba64 *src, const QColorVector *buff
 
 static constexpr qsizetype WorkBlockSize = 256;
 
+#if defined(QT_COMPILER_SUPPORTS_AVX2)
+extern qsizetype QT_FASTCALL applyColorTransform_avx2(QRgb *dst, const QRgb *src, qsizetype count,
+                                                      QColorTransformPrivate::TransformFlags flags,
+                                                      const QColorTransformPrivate *d_ptr, bool doApplyMatrix);
+extern qsizetype QT_FASTCALL applyColorTransform_avx2(QRgba64 *dst, const QRgba64 *src, qsizetype count,
+                                                      QColorTransformPrivate::TransformFlags flags,
+                                                      const QColorTransformPrivate *d_ptr, bool doApplyMatrix);
+extern qsizetype QT_FASTCALL applyColorTransform_avx2(QRgbaFloat32 *dst, const QRgbaFloat32 *src, qsizetype count,
+                                                      QColorTransformPrivate::TransformFlags flags,
+                                                      const QColorTransformPrivate *d_ptr, bool doApplyMatrix);
+#endif
+
 template <typename T, int Count = 1>
 class QUninitialized
 {
@@ -911,6 +1071,11 @@ void QColorTransformPrivate::apply(T *dst, const T *src, qsizetype count, Transf
     QUninitialized<QColorVector, WorkBlockSize> buffer;
 
     qsizetype i = 0;
+#if defined(QT_COMPILER_SUPPORTS_AVX2)
+    // Leaves up to seven pixels for the loop below
+    if (qCpuHasFeature(ArchHaswell))
+        i = applyColorTransform_avx2(dst, src, count, flags, this, doApplyMatrix);
+#endif
     while (i < count) {
         const qsizetype len = qMin(count - i, WorkBlockSize);
         if (flags & InputPremultiplied)
@@ -918,8 +1083,11 @@ void QColorTransformPrivate::apply(T *dst, const T *src, qsizetype count, Transf
         else
             loadUnpremultiplied(buffer, src + i, len, this);
 
-        if (doApplyMatrix)
-            applyMatrix(buffer, len, colorMatrix);
+        if (doApplyMatrix) {
+            // Floating point formats keep colors outside of the gamut of the output space
+            constexpr bool DoClamp = !std::is_same_v<T, QRgbaFloat32>;
+            applyMatrix<DoClamp>(buffer, len, colorMatrix);
+        }
 
         if (flags & InputOpaque)
             storeOpaque(dst + i, src + i, buffer, len, this);
@@ -1019,6 +1187,54 @@ void QColorTransformPrivate::apply(QRgba64 *dst, const QRgba64 *src, qsizetype c
     apply<QRgba64>(dst, src, count, flags);
 }
 
+/*!
+    \internal
+    Applies the color transformation on \a count QRgbaFloat16 pixels starting from
+    \a src and stores the result in \a dst.
+
+    Unlike the integer versions, colors outside of the [0-1] range of the
+    input are transformed with the extended transfer functions, and the
+    result is not clamped to the gamut of the output color space.
+
+    Thread-safe if prepare() has been called first.
+
+    Assumes unpremultiplied data by default. Set \a flags to change defaults.
+
+    \sa prepare()
+*/
+void QColorTransformPrivate::apply(QRgbaFloat16 *dst, const QRgbaFloat16 *src, qsizetype count,
+                                   TransformFlags flags) const
+{
+    // Converting whole blocks takes advantage of the vectorized half-float conversions
+    QUninitialized<QRgbaFloat32, WorkBlockSize> buffer;
+
+    qsizetype i = 0;
+    while (i < count) {
+        const qsizetype len = qMin(count - i, WorkBlockSize);
+        qFloatFromFloat16(reinterpret_cast<float *>(static_cast<QRgbaFloat32 *>(buffer)),
+                          reinterpret_cast<const qfloat16 *>(src + i), len * 4);
+        apply<QRgbaFloat32>(buffer, buffer, len, flags);
+        qFloatToFloat16(reinterpret_cast<qfloat16 *>(dst + i),
+                        reinterpret_cast<const float *>(static_cast<QRgbaFloat32 *>(buffer)), len * 4);
+        i += len;
+    }
+}
+
+/*!
+    \internal
+    Applies the color transformation on \a count QRgbaFloat32 pixels starting from
+    \a src and stores the result in \a dst.
+
+    Behaves like the QRgbaFloat16 version.
+
+    \sa prepare()
+*/
+void QColorTransformPrivate::apply(QRgbaFloat32 *dst, const QRgbaFloat32 *src, qsizetype count,
+                                   TransformFlags flags) const
+{
+    apply<QRgbaFloat32>(dst, src, count, flags);
+}
+
 /*!
     \internal
     Is to be called on a color-transform to XYZ, returns only luminance values.
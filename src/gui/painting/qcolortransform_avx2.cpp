@@ -0,0 +1,386 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qcolortransform_p.h"
+
+#include "qcolormatrix_p.h"
+#include "qcolorspace_p.h"
+#include "qcolortrc_p.h"
+#include "qcolortrclut_p.h"
+
+#include <QtCore/private/qsimd_p.h>
+
+#if defined(QT_COMPILER_SUPPORTS_AVX2)
+
+QT_BEGIN_NAMESPACE
+
+// The lookups below gather 32 bits for each 16-bit table entry, reading the entry next to it.
+// Both tables are in the same QColorTrcLut, so that stays within it at either end.
+static_assert(offsetof(QColorTrcLut, m_fromLinear) == offsetof(QColorTrcLut, m_toLinear) + sizeof(QColorTrcLut::m_toLinear));
+
+// Looks up indexes in [0-4080] in m_toLinear
+static inline __m256i toLinear(const ushort *table, __m256i idx)
+{
+    const __m256i v = _mm256_i32gather_epi32(reinterpret_cast<const int *>(table), idx, 2);
+    return _mm256_and_si256(v, _mm256_set1_epi32(0xffff));
+}
+
+// Looks up indexes in [0-4080] in m_fromLinear
+static inline __m256i fromLinear(const ushort *table, __m256i idx)
+{
+    const __m256i v = _mm256_i32gather_epi32(reinterpret_cast<const int *>(table - 1), idx, 2);
+    return _mm256_srli_epi32(v, 16);
+}
+
+// Loads and stores eight pixels with one channel in each 32-bit lane
+template<typename T>
+struct PixelsAvx2;
+
+template<>
+struct PixelsAvx2<QRgb>
+{
+    static constexpr int MaxAlpha = 255;
+
+    static inline void load(const QRgb *src, __m256i &r, __m256i &g, __m256i &b, __m256i &a)
+    {
+        const __m256i mask = _mm256_set1_epi32(0xff);
+        const __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+        r = _mm256_and_si256(_mm256_srli_epi32(p, 16), mask);
+        g = _mm256_and_si256(_mm256_srli_epi32(p, 8), mask);
+        b = _mm256_and_si256(p, mask);
+        a = _mm256_srli_epi32(p, 24);
+    }
+    static inline void store(QRgb *dst, __m256i r, __m256i g, __m256i b, __m256i a)
+    {
+        __m256i p = _mm256_or_si256(_mm256_slli_epi32(a, 24), _mm256_slli_epi32(r, 16));
+        p = _mm256_or_si256(p, _mm256_or_si256(_mm256_slli_epi32(g, 8), b));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), p);
+    }
+    // [0-255] to [0-4080]
+    static inline __m256i toIndex(__m256i c)
+    {
+        return _mm256_slli_epi32(c, 4);
+    }
+    // [0-65280] to [0-255]
+    static inline __m256i fromTable(__m256i v)
+    {
+        return _mm256_srli_epi32(_mm256_add_epi32(v, _mm256_set1_epi32(0x80)), 8);
+    }
+};
+
+// The lanes hold the pixels in the order 0, 4, 1, 5, 2, 6, 3, 7, which store() restores.
+template<>
+struct PixelsAvx2<QRgba64>
+{
+    static constexpr int MaxAlpha = 65535;
+
+    static inline __m256i channel(__m256i lo, __m256i hi, int shift)
+    {
+        const __m256i mask = _mm256_set1_epi64x(0xffff);
+        lo = _mm256_and_si256(_mm256_srli_epi64(lo, shift), mask);
+        hi = _mm256_and_si256(_mm256_srli_epi64(hi, shift), mask);
+        return _mm256_blend_epi32(lo, _mm256_slli_epi64(hi, 32), 0xaa);
+    }
+    static inline void load(const QRgba64 *src, __m256i &r, __m256i &g, __m256i &b, __m256i &a)
+    {
+        const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+        const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 4));
+        r = channel(lo, hi, 0);
+        g = channel(lo, hi, 16);
+        b = channel(lo, hi, 32);
+        a = channel(lo, hi, 48);
+    }
+    static inline void store(QRgba64 *dst, __m256i r, __m256i g, __m256i b, __m256i a)
+    {
+        const __m256i rg = _mm256_or_si256(r, _mm256_slli_epi32(g, 16));
+        const __m256i ba = _mm256_or_si256(b, _mm256_slli_epi32(a, 16));
+        const __m256i lo = _mm256_unpacklo_epi32(rg, ba); // pixels 0, 4, 2, 6
+        const __m256i hi = _mm256_unpackhi_epi32(rg, ba); // pixels 1, 5, 3, 7
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), _mm256_unpacklo_epi64(lo, hi));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 4), _mm256_unpackhi_epi64(lo, hi));
+    }
+    // [0-65535] to [0-4080]
+    static inline __m256i toIndex(__m256i c)
+    {
+        return _mm256_srli_epi32(_mm256_sub_epi32(c, _mm256_srli_epi32(c, 8)), 4);
+    }
+    // [0-65280] to [0-65535]
+    static inline __m256i fromTable(__m256i v)
+    {
+        return _mm256_add_epi32(v, _mm256_srli_epi32(v, 8));
+    }
+};
+
+// Does what QColorTransformPrivate::apply() does with the SSE2 sub-routines, eight pixels
+// at a time, looking up the tables with gathers. Returns the number of pixels transformed,
+// leaving out the last count % 8 pixels.
+template<typename T>
+static qsizetype applyAvx2(T *dst, const T *src, qsizetype count,
+                           QColorTransformPrivate::TransformFlags flags,
+                           const QColorTransformPrivate *d_ptr, bool doApplyMatrix)
+{
+    using Pixels = PixelsAvx2<T>;
+    const QColorSpacePrivate *in = d_ptr->colorSpaceIn.constData();
+    const QColorSpacePrivate *out = d_ptr->colorSpaceOut.constData();
+    const ushort *const toLinearR = in->lut[0]->m_toLinear;
+    const ushort *const toLinearG = in->lut[1]->m_toLinear;
+    const ushort *const toLinearB = in->lut[2]->m_toLinear;
+    const ushort *const fromLinearR = out->lut[0]->m_fromLinear;
+    const ushort *const fromLinearG = out->lut[1]->m_fromLinear;
+    const ushort *const fromLinearB = out->lut[2]->m_fromLinear;
+
+    const QColorMatrix &matrix = d_ptr->colorMatrix;
+    const __m256 rx = _mm256_set1_ps(matrix.r.x);
+    const __m256 ry = _mm256_set1_ps(matrix.r.y);
+    const __m256 rz = _mm256_set1_ps(matrix.r.z);
+    const __m256 gx = _mm256_set1_ps(matrix.g.x);
+    const __m256 gy = _mm256_set1_ps(matrix.g.y);
+    const __m256 gz = _mm256_set1_ps(matrix.g.z);
+    const __m256 bx = _mm256_set1_ps(matrix.b.x);
+    const __m256 by = _mm256_set1_ps(matrix.b.y);
+    const __m256 bz = _mm256_set1_ps(matrix.b.z);
+
+    const __m256 minV = _mm256_setzero_ps();
+    const __m256 maxV = _mm256_set1_ps(1.0f);
+    const __m256 v4080 = _mm256_set1_ps(4080.f);
+    const __m256 iFF00 = _mm256_set1_ps(1.0f / (255 * 256));
+    const __m256i maxIndex = _mm256_set1_epi32(255 * 16);
+
+    const qsizetype end = count & ~qsizetype(7);
+    for (qsizetype i = 0; i < end; i += 8) {
+        __m256i r, g, b, a;
+        Pixels::load(src + i, r, g, b, a);
+
+        if (flags & QColorTransformPrivate::InputPremultiplied) {
+            // Approximate 1/a:
+            const __m256 va = _mm256_cvtepi32_ps(a);
+            __m256 via = _mm256_rcp_ps(va);
+            via = _mm256_sub_ps(_mm256_add_ps(via, via), _mm256_mul_ps(via, _mm256_mul_ps(via, va)));
+            // Handle zero alpha
+            via = _mm256_andnot_ps(_mm256_cmp_ps(va, minV, _CMP_EQ_OQ), via);
+            const auto toIndex = [&](__m256i c) {
+                const __m256 vf = _mm256_mul_ps(_mm256_cvtepi32_ps(c), via);
+                return _mm256_min_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(vf, v4080)), maxIndex);
+            };
+            r = toIndex(r);
+            g = toIndex(g);
+            b = toIndex(b);
+        } else {
+            r = Pixels::toIndex(r);
+            g = Pixels::toIndex(g);
+            b = Pixels::toIndex(b);
+        }
+        __m256 x = _mm256_mul_ps(_mm256_cvtepi32_ps(toLinear(toLinearR, r)), iFF00);
+        __m256 y = _mm256_mul_ps(_mm256_cvtepi32_ps(toLinear(toLinearG, g)), iFF00);
+        __m256 z = _mm256_mul_ps(_mm256_cvtepi32_ps(toLinear(toLinearB, b)), iFF00);
+
+        if (doApplyMatrix) {
+            const __m256 cx = _mm256_fmadd_ps(z, bx, _mm256_fmadd_ps(y, gx, _mm256_mul_ps(x, rx)));
+            const __m256 cy = _mm256_fmadd_ps(z, by, _mm256_fmadd_ps(y, gy, _mm256_mul_ps(x, ry)));
+            const __m256 cz = _mm256_fmadd_ps(z, bz, _mm256_fmadd_ps(y, gz, _mm256_mul_ps(x, rz)));
+            // Clamp:
+            x = _mm256_max_ps(_mm256_min_ps(cx, maxV), minV);
+            y = _mm256_max_ps(_mm256_min_ps(cy, maxV), minV);
+            z = _mm256_max_ps(_mm256_min_ps(cz, maxV), minV);
+        }
+
+        r = fromLinear(fromLinearR, _mm256_cvtps_epi32(_mm256_mul_ps(x, v4080)));
+        g = fromLinear(fromLinearG, _mm256_cvtps_epi32(_mm256_mul_ps(y, v4080)));
+        b = fromLinear(fromLinearB, _mm256_cvtps_epi32(_mm256_mul_ps(z, v4080)));
+
+        if (flags & QColorTransformPrivate::InputOpaque) {
+            a = _mm256_set1_epi32(Pixels::MaxAlpha);
+        } else if (flags & QColorTransformPrivate::OutputPremultiplied) {
+            const __m256 va = _mm256_mul_ps(_mm256_cvtepi32_ps(a), iFF00);
+            r = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(r), va));
+            g = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(g), va));
+            b = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(b), va));
+            Pixels::store(dst + i, r, g, b, a);
+            continue;
+        }
+        Pixels::store(dst + i, Pixels::fromTable(r), Pixels::fromTable(g), Pixels::fromTable(b), a);
+    }
+    return end;
+}
+
+// Floating point pixels in [0-1] use the lookup tables, interpolating between their entries
+// like the SSE2 version. Channels outside of that range are converted one by one.
+template<bool Inverse>
+static inline __m256 lookupInterpolated(const QColorSpacePrivate *cs, int channel, __m256 v)
+{
+    const ushort *table = Inverse ? cs->lut[channel]->m_fromLinear : cs->lut[channel]->m_toLinear;
+    const __m256 inRange = _mm256_and_ps(_mm256_cmp_ps(v, _mm256_setzero_ps(), _CMP_GE_OQ),
+                                         _mm256_cmp_ps(v, _mm256_set1_ps(1.0f), _CMP_LE_OQ));
+    const __m256 vf = _mm256_mul_ps(_mm256_max_ps(_mm256_min_ps(v, _mm256_set1_ps(1.0f)), _mm256_setzero_ps()),
+                                    _mm256_set1_ps(255 * 16));
+    const __m256i vidx = _mm256_cvttps_epi32(_mm256_min_ps(vf, _mm256_set1_ps(255 * 16 - 1)));
+    const __m256 frac = _mm256_sub_ps(vf, _mm256_cvtepi32_ps(vidx));
+    // each gather reads the entry at the index and the one after it
+    const __m256i entries = _mm256_i32gather_epi32(reinterpret_cast<const int *>(table), vidx, 2);
+    const __m256 lo = _mm256_cvtepi32_ps(_mm256_and_si256(entries, _mm256_set1_epi32(0xffff)));
+    const __m256 hi = _mm256_cvtepi32_ps(_mm256_srli_epi32(entries, 16));
+    __m256 result = _mm256_mul_ps(_mm256_fmadd_ps(_mm256_sub_ps(hi, lo), frac, lo),
+                                  _mm256_set1_ps(1.0f / (255 * 256)));
+
+    const int outOfRange = ~_mm256_movemask_ps(inRange) & 0xff;
+    if (Q_UNLIKELY(outOfRange)) {
+        alignas(32) float in[8];
+        alignas(32) float out[8];
+        _mm256_store_ps(in, v);
+        _mm256_store_ps(out, result);
+        for (int i = 0; i < 8; ++i) {
+            if (outOfRange & (1 << i))
+                out[i] = Inverse ? cs->trc[channel].applyInverseExtended(in[i])
+                                 : cs->trc[channel].applyExtended(in[i]);
+        }
+        result = _mm256_load_ps(out);
+    }
+    return result;
+}
+
+// Transposes eight pixels to one channel per register, with the pixels in the order
+// 0, 2, 4, 6, 1, 3, 5, 7, and back.
+static inline void loadFP(const QRgbaFloat32 *src, __m256 &r, __m256 &g, __m256 &b, __m256 &a)
+{
+    const __m256 p01 = _mm256_loadu_ps(&src[0].r);
+    const __m256 p23 = _mm256_loadu_ps(&src[2].r);
+    const __m256 p45 = _mm256_loadu_ps(&src[4].r);
+    const __m256 p67 = _mm256_loadu_ps(&src[6].r);
+    const __m256 rg0 = _mm256_unpacklo_ps(p01, p23);
+    const __m256 ba0 = _mm256_unpackhi_ps(p01, p23);
+    const __m256 rg1 = _mm256_unpacklo_ps(p45, p67);
+    const __m256 ba1 = _mm256_unpackhi_ps(p45, p67);
+    r = _mm256_shuffle_ps(rg0, rg1, _MM_SHUFFLE(1, 0, 1, 0));
+    g = _mm256_shuffle_ps(rg0, rg1, _MM_SHUFFLE(3, 2, 3, 2));
+    b = _mm256_shuffle_ps(ba0, ba1, _MM_SHUFFLE(1, 0, 1, 0));
+    a = _mm256_shuffle_ps(ba0, ba1, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+static inline void storeFP(QRgbaFloat32 *dst, __m256 r, __m256 g, __m256 b, __m256 a)
+{
+    const __m256 rg0 = _mm256_unpacklo_ps(r, g);
+    const __m256 ba0 = _mm256_unpacklo_ps(b, a);
+    const __m256 rg1 = _mm256_unpackhi_ps(r, g);
+    const __m256 ba1 = _mm256_unpackhi_ps(b, a);
+    _mm256_storeu_ps(&dst[0].r, _mm256_shuffle_ps(rg0, ba0, _MM_SHUFFLE(1, 0, 1, 0)));
+    _mm256_storeu_ps(&dst[2].r, _mm256_shuffle_ps(rg0, ba0, _MM_SHUFFLE(3, 2, 3, 2)));
+    _mm256_storeu_ps(&dst[4].r, _mm256_shuffle_ps(rg1, ba1, _MM_SHUFFLE(1, 0, 1, 0)));
+    _mm256_storeu_ps(&dst[6].r, _mm256_shuffle_ps(rg1, ba1, _MM_SHUFFLE(3, 2, 3, 2)));
+}
+
+qsizetype QT_FASTCALL applyColorTransform_avx2(QRgbaFloat32 *dst, const QRgbaFloat32 *src, qsizetype count,
+                                               QColorTransformPrivate::TransformFlags flags,
+                                               const QColorTransformPrivate *d_ptr, bool doApplyMatrix)
+{
+    const QColorSpacePrivate *in = d_ptr->colorSpaceIn.constData();
+    const QColorSpacePrivate *out = d_ptr->colorSpaceOut.constData();
+
+    const QColorMatrix &matrix = d_ptr->colorMatrix;
+    const __m256 rx = _mm256_set1_ps(matrix.r.x);
+    const __m256 ry = _mm256_set1_ps(matrix.r.y);
+    const __m256 rz = _mm256_set1_ps(matrix.r.z);
+    const __m256 gx = _mm256_set1_ps(matrix.g.x);
+    const __m256 gy = _mm256_set1_ps(matrix.g.y);
+    const __m256 gz = _mm256_set1_ps(matrix.g.z);
+    const __m256 bx = _mm256_set1_ps(matrix.b.x);
+    const __m256 by = _mm256_set1_ps(matrix.b.y);
+    const __m256 bz = _mm256_set1_ps(matrix.b.z);
+    const __m256 one = _mm256_set1_ps(1.0f);
+
+    const qsizetype end = count & ~qsizetype(7);
+    for (qsizetype i = 0; i < end; i += 8) {
+        __m256 r, g, b, a;
+        loadFP(src + i, r, g, b, a);
+
+        if (flags & QColorTransformPrivate::InputPremultiplied) {
+            // as QRgbaFloat32::unpremultiplied()
+            const __m256 opaque = _mm256_cmp_ps(a, one, _CMP_GE_OQ);
+            const __m256 visible = _mm256_cmp_ps(a, _mm256_setzero_ps(), _CMP_GT_OQ);
+            const __m256 ia = _mm256_and_ps(_mm256_blendv_ps(_mm256_div_ps(one, a), one, opaque), visible);
+            r = _mm256_mul_ps(r, ia);
+            g = _mm256_mul_ps(g, ia);
+            b = _mm256_mul_ps(b, ia);
+        }
+        __m256 x = lookupInterpolated<false>(in, 0, r);
+        __m256 y = lookupInterpolated<false>(in, 1, g);
+        __m256 z = lookupInterpolated<false>(in, 2, b);
+
+        // Floating point formats keep colors outside of the gamut of the output space
+        if (doApplyMatrix) {
+            const __m256 cx = _mm256_fmadd_ps(z, bx, _mm256_fmadd_ps(y, gx, _mm256_mul_ps(x, rx)));
+            const __m256 cy = _mm256_fmadd_ps(z, by, _mm256_fmadd_ps(y, gy, _mm256_mul_ps(x, ry)));
+            const __m256 cz = _mm256_fmadd_ps(z, bz, _mm256_fmadd_ps(y, gz, _mm256_mul_ps(x, rz)));
+            x = cx;
+            y = cy;
+            z = cz;
+        }
+
+        r = lookupInterpolated<true>(out, 0, x);
+        g = lookupInterpolated<true>(out, 1, y);
+        b = lookupInterpolated<true>(out, 2, z);
+
+        if (flags & QColorTransformPrivate::InputOpaque) {
+            a = one;
+        } else if (flags & QColorTransformPrivate::OutputPremultiplied) {
+            r = _mm256_mul_ps(r, a);
+            g = _mm256_mul_ps(g, a);
+            b = _mm256_mul_ps(b, a);
+        }
+        storeFP(dst + i, r, g, b, a);
+    }
+    return end;
+}
+
+qsizetype QT_FASTCALL applyColorTransform_avx2(QRgb *dst, const QRgb *src, qsizetype count,
+                                               QColorTransformPrivate::TransformFlags flags,
+                                               const QColorTransformPrivate *d_ptr, bool doApplyMatrix)
+{
+    return applyAvx2(dst, src, count, flags, d_ptr, doApplyMatrix);
+}
+
+qsizetype QT_FASTCALL applyColorTransform_avx2(QRgba64 *dst, const QRgba64 *src, qsizetype count,
+                                               QColorTransformPrivate::TransformFlags flags,
+                                               const QColorTransformPrivate *d_ptr, bool doApplyMatrix)
+{
+    return applyAvx2(dst, src, count, flags, d_ptr, doApplyMatrix);
+}
+
+QT_END_NAMESPACE
+
+#endif
@@ -54,6 +54,8 @@
 #include "qcolormatrix_p.h"
 #include "qcolorspace_p.h"
 
+#include <QtGui/qrgbafloat.h>
+
 #include <QtCore/qshareddata.h>
 
 QT_BEGIN_NAMESPACE
@@ -84,6 +86,10 @@ public:
 
     void apply(QRgb *dst, const QRgb *src, qsizetype count, TransformFlags flags = Unpremultiplied) const;
     void apply(QRgba64 *dst, const QRgba64 *src, qsizetype count, TransformFlags flags = Unpremultiplied) const;
+    void apply(QRgbaFloat16 *dst, const QRgbaFloat16 *src, qsizetype count,
+               TransformFlags flags = Unpremultiplied) const;
+    void apply(QRgbaFloat32 *dst, const QRgbaFloat32 *src, qsizetype count,
+               TransformFlags flags = Unpremultiplied) const;
     void apply(quint8 *dst, const QRgb *src, qsizetype count, TransformFlags flags = Unpremultiplied) const;
     void apply(quint16 *dst, const QRgba64 *src, qsizetype count, TransformFlags flags = Unpremultiplied) const;
 
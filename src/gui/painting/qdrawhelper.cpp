@@ -315,8 +315,20 @@ static Convert64ToFPFunc convert64ToRGBA32F[QImage::NImageFormats] = {
 
 static void convertRGBA32FToRGBA32FPM(QRgbaFloat32 *buffer, int count)
 {
+#ifdef __SSE2__
+    // multiply r, g and b by alpha, and alpha by one
+    const __m128 colorMask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+    const __m128 oneAlpha = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+    for (int i = 0; i < count; ++i) {
+        const __m128 vsf = _mm_load_ps(reinterpret_cast<const float *>(buffer + i));
+        const __m128 vsa = _mm_shuffle_ps(vsf, vsf, _MM_SHUFFLE(3, 3, 3, 3));
+        const __m128 factor = _mm_or_ps(_mm_and_ps(vsa, colorMask), oneAlpha);
+        _mm_store_ps(reinterpret_cast<float *>(buffer + i), _mm_mul_ps(vsf, factor));
+    }
+#else
     for (int i = 0; i < count; ++i)
         buffer[i] = buffer[i].premultiplied();
+#endif
 }
 
 static void convertRGBA32FToRGBA32F(QRgbaFloat32 *, int)
@@ -2971,8 +2983,8 @@ template<TextureBlendType blendType>
 static const QRgbaFloat32 *QT_FASTCALL fetchTransformedBilinearFP(QRgbaFloat32 *buffer, const QSpanData *data,
                                                               int y, int x, int length)
 {
-    const auto convert = data->rasterBuffer->format == QImage::Format_RGBA32FPx4 ? convertRGBA32FToRGBA32FPM
-                                                                                 : convertRGBA32FToRGBA32F;
+    const auto convert = data->texture.format == QImage::Format_RGBA32FPx4 ? convertRGBA32FToRGBA32FPM
+                                                                           : convertRGBA32FToRGBA32F;
 
     const qreal cx = x + qreal(0.5);
     const qreal cy = y + qreal(0.5);
@@ -3204,18 +3216,32 @@ static const QRgba64& qt_gradient_pixel64_fixed(const QGradientData *data, int f
 #endif
 
 #if QT_CONFIG(raster_fp)
+static inline QRgbaFloat32 qt_gradient_colorFP(QRgba64 rgb64)
+{
+#ifdef __SSE2__
+    // Widen all four channels at once instead of converting them one by one,
+    // this is done for every pixel of a floating point gradient.
+    const __m128i v = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(&rgb64)),
+                                         _mm_setzero_si128());
+    QRgbaFloat32 res;
+    _mm_store_ps(reinterpret_cast<float *>(&res),
+                 _mm_mul_ps(_mm_cvtepi32_ps(v), _mm_set1_ps(1.0f / 65535.0f)));
+    return res;
+#else
+    return QRgbaFloat32::fromRgba64(rgb64.red(), rgb64.green(), rgb64.blue(), rgb64.alpha());
+#endif
+}
+
 static inline QRgbaFloat32 qt_gradient_pixelFP(const QGradientData *data, qreal pos)
 {
     int ipos = int(pos * (GRADIENT_STOPTABLE_SIZE - 1) + qreal(0.5));
-    QRgba64 rgb64 = data->colorTable64[qt_gradient_clamp(data, ipos)];
-    return QRgbaFloat32::fromRgba64(rgb64.red(),rgb64.green(), rgb64.blue(), rgb64.alpha());
+    return qt_gradient_colorFP(data->colorTable64[qt_gradient_clamp(data, ipos)]);
 }
 
 static inline QRgbaFloat32 qt_gradient_pixelFP_fixed(const QGradientData *data, int fixed_pos)
 {
     int ipos = (fixed_pos + (FIXPT_SIZE / 2)) >> FIXPT_BITS;
-    QRgba64 rgb64 = data->colorTable64[qt_gradient_clamp(data, ipos)];
-    return QRgbaFloat32::fromRgba64(rgb64.red(), rgb64.green(), rgb64.blue(), rgb64.alpha());
+    return qt_gradient_colorFP(data->colorTable64[qt_gradient_clamp(data, ipos)]);
 }
 #endif
 
@@ -3288,9 +3314,9 @@ public:
     }
     static void memfill(Type *buffer, Type fill, int length)
     {
-        quint64 fillCopy;
-        memcpy(&fillCopy, &fill, sizeof(quint64));
-        qt_memfill64((quint64*)buffer, fillCopy, length);
+        // A QRgbaFloat32 is 16 bytes wide, so qt_memfill64 can not be used here
+        for (int i = 0; i < length; ++i)
+            buffer[i] = fill;
     }
 };
 #endif
@@ -6395,6 +6421,14 @@ static void qInitDrawhelperFunctions()
         qt_functionForMode_C[QPainter::CompositionMode_Source] = comp_func_Source_avx2;
         qt_functionForMode_C[QPainter::CompositionMode_SourceOver] = comp_func_SourceOver_avx2;
         qt_functionForModeSolid_C[QPainter::CompositionMode_SourceOver] = comp_func_solid_SourceOver_avx2;
+        extern void QT_FASTCALL comp_func_solid_Source_avx2(uint *destPixels, int length, uint color, uint const_alpha);
+        extern void QT_FASTCALL comp_func_Plus_avx2(uint *destPixels, const uint *srcPixels, int length, uint const_alpha);
+        qt_functionForModeSolid_C[QPainter::CompositionMode_Source] = comp_func_solid_Source_avx2;
+        qt_functionForMode_C[QPainter::CompositionMode_Plus] = comp_func_Plus_avx2;
+
+        extern const uint * QT_FASTCALL qt_fetch_radial_gradient_avx2(uint *buffer, const Operator *op, const QSpanData *data,
+                                                                      int y, int x, int length);
+        qt_fetch_radial_gradient = qt_fetch_radial_gradient_avx2;
 #if QT_CONFIG(raster_64bit)
         extern void QT_FASTCALL comp_func_Source_rgb64_avx2(QRgba64 *destPixels, const QRgba64 *srcPixels, int length, uint const_alpha);
         extern void QT_FASTCALL comp_func_SourceOver_rgb64_avx2(QRgba64 *destPixels, const QRgba64 *srcPixels, int length, uint const_alpha);
@@ -6472,11 +6506,51 @@ static void qInitDrawhelperFunctions()
         qFetchToRGBA32F[QImage::Format_RGBA16FPx4] = fetchRGBA16FToRGBA32F_avx2;
         qStoreFromRGBA32F[QImage::Format_RGBX16FPx4] = storeRGBX16FFromRGBA32F_avx2;
         qStoreFromRGBA32F[QImage::Format_RGBA16FPx4] = storeRGBA16FFromRGBA32F_avx2;
+        extern const QRgbaFloat32 *QT_FASTCALL fetchRGBA32FToRGBA32F_avx2(QRgbaFloat32 *buffer, const uchar *src, int index, int count, const QList<QRgb> *, QDitherInfo *);
+        extern void QT_FASTCALL storeRGBX32FFromRGBA32F_avx2(uchar *dest, const QRgbaFloat32 *src, int index, int count, const QList<QRgb> *, QDitherInfo *);
+        extern void QT_FASTCALL storeRGBA32FFromRGBA32F_avx2(uchar *dest, const QRgbaFloat32 *src, int index, int count, const QList<QRgb> *, QDitherInfo *);
+        qFetchToRGBA32F[QImage::Format_RGBA32FPx4] = fetchRGBA32FToRGBA32F_avx2;
+        qStoreFromRGBA32F[QImage::Format_RGBX32FPx4] = storeRGBX32FFromRGBA32F_avx2;
+        qStoreFromRGBA32F[QImage::Format_RGBA32FPx4] = storeRGBA32FFromRGBA32F_avx2;
 #endif // QT_CONFIG(raster_fp)
     }
 
 #endif
 
+#if defined(QT_COMPILER_SUPPORTS_AVX512BW)
+    if (qCpuHasFeature(ArchHaswell) && qCpuHasFeature(AVX512F) && qCpuHasFeature(AVX512CD)
+            && qCpuHasFeature(AVX512BW) && qCpuHasFeature(AVX512DQ) && qCpuHasFeature(AVX512VL)) {
+        extern void qt_blend_argb32_on_argb32_avx512(uchar *destPixels, int dbpl,
+                                                     const uchar *srcPixels, int sbpl,
+                                                     int w, int h, int const_alpha);
+        qBlendFunctions[QImage::Format_RGB32][QImage::Format_ARGB32_Premultiplied] = qt_blend_argb32_on_argb32_avx512;
+        qBlendFunctions[QImage::Format_ARGB32_Premultiplied][QImage::Format_ARGB32_Premultiplied] = qt_blend_argb32_on_argb32_avx512;
+        qBlendFunctions[QImage::Format_RGBX8888][QImage::Format_RGBA8888_Premultiplied] = qt_blend_argb32_on_argb32_avx512;
+        qBlendFunctions[QImage::Format_RGBA8888_Premultiplied][QImage::Format_RGBA8888_Premultiplied] = qt_blend_argb32_on_argb32_avx512;
+
+        extern void QT_FASTCALL comp_func_Source_avx512(uint *destPixels, const uint *srcPixels, int length, uint const_alpha);
+        extern void QT_FASTCALL comp_func_SourceOver_avx512(uint *destPixels, const uint *srcPixels, int length, uint const_alpha);
+        extern void QT_FASTCALL comp_func_Plus_avx512(uint *destPixels, const uint *srcPixels, int length, uint const_alpha);
+        extern void QT_FASTCALL comp_func_solid_Source_avx512(uint *destPixels, int length, uint color, uint const_alpha);
+        extern void QT_FASTCALL comp_func_solid_SourceOver_avx512(uint *destPixels, int length, uint color, uint const_alpha);
+        qt_functionForMode_C[QPainter::CompositionMode_Source] = comp_func_Source_avx512;
+        qt_functionForMode_C[QPainter::CompositionMode_SourceOver] = comp_func_SourceOver_avx512;
+        qt_functionForMode_C[QPainter::CompositionMode_Plus] = comp_func_Plus_avx512;
+        qt_functionForModeSolid_C[QPainter::CompositionMode_Source] = comp_func_solid_Source_avx512;
+        qt_functionForModeSolid_C[QPainter::CompositionMode_SourceOver] = comp_func_solid_SourceOver_avx512;
+#if QT_CONFIG(raster_fp)
+        extern void QT_FASTCALL comp_func_Source_rgbafp_avx512(QRgbaFloat32 *destPixels, const QRgbaFloat32 *srcPixels, int length, uint const_alpha);
+        extern void QT_FASTCALL comp_func_SourceOver_rgbafp_avx512(QRgbaFloat32 *destPixels, const QRgbaFloat32 *srcPixels, int length, uint const_alpha);
+        extern void QT_FASTCALL comp_func_solid_Source_rgbafp_avx512(QRgbaFloat32 *destPixels, int length, QRgbaFloat32 color, uint const_alpha);
+        extern void QT_FASTCALL comp_func_solid_SourceOver_rgbafp_avx512(QRgbaFloat32 *destPixels, int length, QRgbaFloat32 color, uint const_alpha);
+        qt_functionForModeFP_C[QPainter::CompositionMode_Source] = comp_func_Source_rgbafp_avx512;
+        qt_functionForModeFP_C[QPainter::CompositionMode_SourceOver] = comp_func_SourceOver_rgbafp_avx512;
+        qt_functionForModeSolidFP_C[QPainter::CompositionMode_Source] = comp_func_solid_Source_rgbafp_avx512;
+        qt_functionForModeSolidFP_C[QPainter::CompositionMode_SourceOver] = comp_func_solid_SourceOver_rgbafp_avx512;
+#endif
+    }
+#endif
+
 #endif // SSE2
 
 #if defined(__ARM_NEON__)
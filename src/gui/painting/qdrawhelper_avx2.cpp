@@ -622,6 +622,83 @@ void QT_FASTCALL comp_func_solid_SourceOver_avx2(uint *destPixels, int length, u
     }
 }
 
+void QT_FASTCALL comp_func_solid_Source_avx2(uint *destPixels, int length, uint color, uint const_alpha)
+{
+    if (const_alpha == 255) {
+        qt_memfill32(destPixels, color, length);
+    } else {
+        const quint32 ialpha = 255 - const_alpha;
+        color = BYTE_MUL(color, const_alpha);
+        int x = 0;
+
+        quint32 *dst = (quint32 *) destPixels;
+        const __m256i colorVector = _mm256_set1_epi32(color);
+        const __m256i colorMask = _mm256_set1_epi32(0x00ff00ff);
+        const __m256i half = _mm256_set1_epi16(0x80);
+        const __m256i iAlphaVector = _mm256_set1_epi16(ialpha);
+
+        ALIGNMENT_PROLOGUE_32BYTES(dst, x, length)
+            destPixels[x] = color + BYTE_MUL(destPixels[x], ialpha);
+
+        for (; x < length - 7; x += 8) {
+            __m256i dstVector = _mm256_load_si256((__m256i *)&dst[x]);
+            BYTE_MUL_AVX2(dstVector, iAlphaVector, colorMask, half);
+            dstVector = _mm256_add_epi8(colorVector, dstVector);
+            _mm256_store_si256((__m256i *)&dst[x], dstVector);
+        }
+        SIMD_EPILOGUE(x, length, 7)
+            destPixels[x] = color + BYTE_MUL(destPixels[x], ialpha);
+    }
+}
+
+void QT_FASTCALL comp_func_Plus_avx2(uint *dst, const uint *src, int length, uint const_alpha)
+{
+    int x = 0;
+
+    if (const_alpha == 255) {
+        // 1) Prologue: align destination on 32 bytes
+        ALIGNMENT_PROLOGUE_32BYTES(dst, x, length)
+            dst[x] = comp_func_Plus_one_pixel(dst[x], src[x]);
+
+        // 2) composition with AVX2
+        for (; x < length - 7; x += 8) {
+            const __m256i srcVector = _mm256_lddqu_si256((const __m256i *)&src[x]);
+            const __m256i dstVector = _mm256_load_si256((__m256i *)&dst[x]);
+
+            const __m256i result = _mm256_adds_epu8(srcVector, dstVector);
+            _mm256_store_si256((__m256i *)&dst[x], result);
+        }
+
+        // 3) Epilogue:
+        SIMD_EPILOGUE(x, length, 7)
+            dst[x] = comp_func_Plus_one_pixel(dst[x], src[x]);
+    } else {
+        const int one_minus_const_alpha = 255 - const_alpha;
+        const __m256i constAlphaVector = _mm256_set1_epi16(const_alpha);
+        const __m256i oneMinusConstAlpha =  _mm256_set1_epi16(one_minus_const_alpha);
+
+        // 1) Prologue: align destination on 32 bytes
+        ALIGNMENT_PROLOGUE_32BYTES(dst, x, length)
+            dst[x] = comp_func_Plus_one_pixel_const_alpha(dst[x], src[x], const_alpha, one_minus_const_alpha);
+
+        const __m256i half = _mm256_set1_epi16(0x80);
+        const __m256i colorMask = _mm256_set1_epi32(0x00ff00ff);
+        // 2) composition with AVX2
+        for (; x < length - 7; x += 8) {
+            const __m256i srcVector = _mm256_lddqu_si256((const __m256i *)&src[x]);
+            __m256i dstVector = _mm256_load_si256((__m256i *)&dst[x]);
+
+            const __m256i result = _mm256_adds_epu8(srcVector, dstVector);
+            INTERPOLATE_PIXEL_255_AVX2(result, dstVector, constAlphaVector, oneMinusConstAlpha, colorMask, half);
+            _mm256_store_si256((__m256i *)&dst[x], dstVector);
+        }
+
+        // 3) Epilogue:
+        SIMD_EPILOGUE(x, length, 7)
+            dst[x] = comp_func_Plus_one_pixel_const_alpha(dst[x], src[x], const_alpha, one_minus_const_alpha);
+    }
+}
+
 #if QT_CONFIG(raster_64bit)
 void QT_FASTCALL comp_func_solid_SourceOver_rgb64_avx2(QRgba64 *destPixels, int length, QRgba64 color, uint const_alpha)
 {
@@ -1133,6 +1210,48 @@ void QT_FASTCALL fetchTransformedBilinearARGB32PM_fast_rotate_helper_avx2(uint *
     }
 }
 
+class QSimdAvx2
+{
+public:
+    // Eight lanes, under the names QRadialFetchSimd expects.
+    typedef __m256i Int32x4;
+    typedef __m256 Float32x4;
+
+    union Vect_buffer_i { Int32x4 v; int i[8]; };
+    union Vect_buffer_f { Float32x4 v; float f[8]; };
+
+    static inline Float32x4 Q_DECL_VECTORCALL v_dup(float x) { return _mm256_set1_ps(x); }
+    static inline Float32x4 Q_DECL_VECTORCALL v_dup(double x) { return _mm256_set1_ps(x); }
+    static inline Int32x4 Q_DECL_VECTORCALL v_dup(int x) { return _mm256_set1_epi32(x); }
+    static inline Int32x4 Q_DECL_VECTORCALL v_dup(uint x) { return _mm256_set1_epi32(x); }
+
+    static inline Float32x4 Q_DECL_VECTORCALL v_add(Float32x4 a, Float32x4 b) { return _mm256_add_ps(a, b); }
+    static inline Int32x4 Q_DECL_VECTORCALL v_add(Int32x4 a, Int32x4 b) { return _mm256_add_epi32(a, b); }
+
+    static inline Float32x4 Q_DECL_VECTORCALL v_max(Float32x4 a, Float32x4 b) { return _mm256_max_ps(a, b); }
+    static inline Float32x4 Q_DECL_VECTORCALL v_min(Float32x4 a, Float32x4 b) { return _mm256_min_ps(a, b); }
+    static inline Int32x4 Q_DECL_VECTORCALL v_min_16(Int32x4 a, Int32x4 b) { return _mm256_min_epi16(a, b); }
+
+    static inline Int32x4 Q_DECL_VECTORCALL v_and(Int32x4 a, Int32x4 b) { return _mm256_and_si256(a, b); }
+
+    static inline Float32x4 Q_DECL_VECTORCALL v_sub(Float32x4 a, Float32x4 b) { return _mm256_sub_ps(a, b); }
+    static inline Int32x4 Q_DECL_VECTORCALL v_sub(Int32x4 a, Int32x4 b) { return _mm256_sub_epi32(a, b); }
+
+    static inline Float32x4 Q_DECL_VECTORCALL v_mul(Float32x4 a, Float32x4 b) { return _mm256_mul_ps(a, b); }
+
+    static inline Float32x4 Q_DECL_VECTORCALL v_sqrt(Float32x4 x) { return _mm256_sqrt_ps(x); }
+
+    static inline Int32x4 Q_DECL_VECTORCALL v_toInt(Float32x4 x) { return _mm256_cvttps_epi32(x); }
+
+    static inline Int32x4 Q_DECL_VECTORCALL v_greaterOrEqual(Float32x4 a, Float32x4 b) { return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_GT_OQ)); }
+};
+
+const uint * QT_FASTCALL qt_fetch_radial_gradient_avx2(uint *buffer, const Operator *op, const QSpanData *data,
+                                                       int y, int x, int length)
+{
+    return qt_fetch_radial_gradient_template<QRadialFetchSimd<QSimdAvx2>,uint>(buffer, op, data, y, x, length);
+}
+
 static inline __m256i epilogueMaskFromCount(qsizetype count)
 {
     Q_ASSERT(count > 0);
@@ -1642,6 +1761,78 @@ void QT_FASTCALL storeRGBA16FFromRGBA32F_avx2(uchar *dest, const QRgbaFloat32 *s
         _mm_storel_epi64((__m128i *)(d + i), _mm_cvtps_ph(vsf, 0));
     }
 }
+
+const QRgbaFloat32 *QT_FASTCALL fetchRGBA32FToRGBA32F_avx2(QRgbaFloat32 *buffer, const uchar *src, int index, int count,
+                                                       const QList<QRgb> *, QDitherInfo *)
+{
+    const QRgbaFloat32 *s = reinterpret_cast<const QRgbaFloat32 *>(src) + index;
+    int i = 0;
+    for (; i + 1 < count; i += 2) {
+        __m256 vsf = _mm256_loadu_ps(reinterpret_cast<const float *>(s + i));
+        const __m256 vsa = _mm256_permute_ps(vsf, _MM_SHUFFLE(3, 3, 3, 3));
+        vsf = _mm256_mul_ps(vsf, vsa);
+        vsf = _mm256_blend_ps(vsf, vsa, 0x88);
+        _mm256_storeu_ps(reinterpret_cast<float *>(buffer + i), vsf);
+    }
+    if (i < count) {
+        __m128 vsf = _mm_load_ps(reinterpret_cast<const float *>(s + i));
+        const __m128 vsa = _mm_permute_ps(vsf, _MM_SHUFFLE(3, 3, 3, 3));
+        vsf = _mm_mul_ps(vsf, vsa);
+        vsf = _mm_insert_ps(vsf, vsa, 0x30);
+        _mm_store_ps(reinterpret_cast<float *>(buffer + i), vsf);
+    }
+    return buffer;
+}
+
+// Unpremultiplies two pixels at a time without branching on their alpha.
+// The reciprocal is refined with one Newton-Raphson step like in the SSE4
+// version, and the last pixel of an odd span is handled the same way.
+static inline __m256 unpremultiply_rgbafp_avx2(__m256 vsf)
+{
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 vsa = _mm256_permute_ps(vsf, _MM_SHUFFLE(3, 3, 3, 3));
+    __m256 vsr = _mm256_rcp_ps(vsa);
+    vsr = _mm256_sub_ps(_mm256_add_ps(vsr, vsr), _mm256_mul_ps(vsr, _mm256_mul_ps(vsr, vsa)));
+    vsr = _mm256_blendv_ps(vsr, one, _mm256_cmp_ps(vsa, one, _CMP_GE_OQ));
+    vsr = _mm256_blend_ps(vsr, one, 0x88);
+    vsf = _mm256_mul_ps(vsf, vsr);
+    return _mm256_and_ps(vsf, _mm256_cmp_ps(vsa, _mm256_setzero_ps(), _CMP_GT_OQ));
+}
+
+static inline __m256 loadRgbaFPSpan(const QRgbaFloat32 *src, int i, int count)
+{
+    if (i + 1 < count)
+        return _mm256_loadu_ps(reinterpret_cast<const float *>(src + i));
+    return _mm256_castps128_ps256(_mm_load_ps(reinterpret_cast<const float *>(src + i)));
+}
+
+static inline void storeRgbaFPSpan(QRgbaFloat32 *dst, int i, int count, __m256 v)
+{
+    if (i + 1 < count)
+        _mm256_storeu_ps(reinterpret_cast<float *>(dst + i), v);
+    else
+        _mm_store_ps(reinterpret_cast<float *>(dst + i), _mm256_castps256_ps128(v));
+}
+
+void QT_FASTCALL storeRGBX32FFromRGBA32F_avx2(uchar *dest, const QRgbaFloat32 *src, int index, int count,
+                                              const QList<QRgb> *, QDitherInfo *)
+{
+    QRgbaFloat32 *d = reinterpret_cast<QRgbaFloat32 *>(dest) + index;
+    const __m256 one = _mm256_set1_ps(1.0f);
+    for (int i = 0; i < count; i += 2) {
+        __m256 vsf = unpremultiply_rgbafp_avx2(loadRgbaFPSpan(src, i, count));
+        vsf = _mm256_blend_ps(vsf, one, 0x88);
+        storeRgbaFPSpan(d, i, count, vsf);
+    }
+}
+
+void QT_FASTCALL storeRGBA32FFromRGBA32F_avx2(uchar *dest, const QRgbaFloat32 *src, int index, int count,
+                                              const QList<QRgb> *, QDitherInfo *)
+{
+    QRgbaFloat32 *d = reinterpret_cast<QRgbaFloat32 *>(dest) + index;
+    for (int i = 0; i < count; i += 2)
+        storeRgbaFPSpan(d, i, count, unpremultiply_rgbafp_avx2(loadRgbaFPSpan(src, i, count)));
+}
 #endif
 
 QT_END_NAMESPACE
@@ -0,0 +1,380 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qdrawhelper_p.h"
+#include "qdrawhelper_x86_p.h"
+#include "qdrawingprimitive_sse2_p.h"
+
+#if defined(QT_COMPILER_SUPPORTS_AVX512BW)
+
+QT_BEGIN_NAMESPACE
+
+// The functions below process 16 pixels per iteration. The tail of a span
+// is handled with masked loads and stores instead of a scalar epilogue, and
+// unaligned accesses are used throughout, as they cost the same as aligned
+// ones on processors with AVX-512.
+
+// Returns the mask of the pixels left to process in a span of \a count.
+static inline __mmask16 spanMask(int count)
+{
+    return count >= 16 ? __mmask16(0xffff) : __mmask16((1u << count) - 1);
+}
+
+// The alpha and green channels are masked with _mm512_and_si512 rather than
+// _mm512_andnot_si512, and 32-bit shifts are avoided, as GCC 12 warns about
+// their implementation using _mm512_undefined_epi32().
+
+// See BYTE_MUL_SSE2 for details.
+static inline __m512i Q_DECL_VECTORCALL
+BYTE_MUL_AVX512(__m512i pixelVector, __m512i alphaChannel, __m512i colorMask, __m512i half)
+{
+    const __m512i alphaGreenMask = _mm512_set1_epi32(0xff00ff00);
+    __m512i pixelVectorAG = _mm512_srli_epi16(pixelVector, 8);
+    __m512i pixelVectorRB = _mm512_and_si512(pixelVector, colorMask);
+
+    pixelVectorAG = _mm512_mullo_epi16(pixelVectorAG, alphaChannel);
+    pixelVectorRB = _mm512_mullo_epi16(pixelVectorRB, alphaChannel);
+
+    pixelVectorRB = _mm512_add_epi16(pixelVectorRB, _mm512_srli_epi16(pixelVectorRB, 8));
+    pixelVectorAG = _mm512_add_epi16(pixelVectorAG, _mm512_srli_epi16(pixelVectorAG, 8));
+    pixelVectorRB = _mm512_add_epi16(pixelVectorRB, half);
+    pixelVectorAG = _mm512_add_epi16(pixelVectorAG, half);
+
+    pixelVectorRB = _mm512_srli_epi16(pixelVectorRB, 8);
+    pixelVectorAG = _mm512_and_si512(pixelVectorAG, alphaGreenMask);
+
+    return _mm512_or_si512(pixelVectorAG, pixelVectorRB);
+}
+
+// See INTERPOLATE_PIXEL_255_SSE2 for details.
+static inline __m512i Q_DECL_VECTORCALL
+INTERPOLATE_PIXEL_255_AVX512(__m512i srcVector, __m512i dstVector, __m512i alphaChannel, __m512i oneMinusAlphaChannel, __m512i colorMask, __m512i half)
+{
+    const __m512i alphaGreenMask = _mm512_set1_epi32(0xff00ff00);
+    const __m512i srcVectorAG = _mm512_srli_epi16(srcVector, 8);
+    const __m512i dstVectorAG = _mm512_srli_epi16(dstVector, 8);
+    const __m512i srcVectorRB = _mm512_and_si512(srcVector, colorMask);
+    const __m512i dstVectorRB = _mm512_and_si512(dstVector, colorMask);
+    const __m512i srcVectorAGalpha = _mm512_mullo_epi16(srcVectorAG, alphaChannel);
+    const __m512i srcVectorRBalpha = _mm512_mullo_epi16(srcVectorRB, alphaChannel);
+    const __m512i dstVectorAGoneMinusAlpha = _mm512_mullo_epi16(dstVectorAG, oneMinusAlphaChannel);
+    const __m512i dstVectorRBoneMinusAlpha = _mm512_mullo_epi16(dstVectorRB, oneMinusAlphaChannel);
+    __m512i finalAG = _mm512_add_epi16(srcVectorAGalpha, dstVectorAGoneMinusAlpha);
+    __m512i finalRB = _mm512_add_epi16(srcVectorRBalpha, dstVectorRBoneMinusAlpha);
+    finalAG = _mm512_add_epi16(finalAG, _mm512_srli_epi16(finalAG, 8));
+    finalRB = _mm512_add_epi16(finalRB, _mm512_srli_epi16(finalRB, 8));
+    finalAG = _mm512_add_epi16(finalAG, half);
+    finalRB = _mm512_add_epi16(finalRB, half);
+    finalAG = _mm512_and_si512(finalAG, alphaGreenMask);
+    finalRB = _mm512_srli_epi16(finalRB, 8);
+
+    return _mm512_or_si512(finalAG, finalRB);
+}
+
+// Returns src + BYTE_MUL(dst, qAlpha(~src)) for each pixel.
+static inline __m512i Q_DECL_VECTORCALL
+SOURCE_OVER_AVX512(__m512i srcVector, __m512i dstVector, __m512i colorMask, __m512i half)
+{
+    // Spread the inverted alpha of each pixel into both of its 16-bit halves.
+    const __m512i alphaShuffleMask = _mm512_set_epi32(int(0x800f800f), int(0x800b800b), int(0x80078007), int(0x80038003),
+                                                      int(0x800f800f), int(0x800b800b), int(0x80078007), int(0x80038003),
+                                                      int(0x800f800f), int(0x800b800b), int(0x80078007), int(0x80038003),
+                                                      int(0x800f800f), int(0x800b800b), int(0x80078007), int(0x80038003));
+    const __m512i alphaChannel = _mm512_shuffle_epi8(_mm512_xor_si512(srcVector, _mm512_set1_epi32(-1)), alphaShuffleMask);
+    return _mm512_add_epi8(srcVector, BYTE_MUL_AVX512(dstVector, alphaChannel, colorMask, half));
+}
+
+static inline void Q_DECL_VECTORCALL
+BLEND_SOURCE_OVER_ARGB32_AVX512(quint32 *dst, const quint32 *src, int length)
+{
+    const __m512i half = _mm512_set1_epi16(0x80);
+    const __m512i colorMask = _mm512_set1_epi32(0x00ff00ff);
+    const __m512i alphaMask = _mm512_set1_epi32(0xff000000);
+
+    for (int x = 0; x < length; x += 16) {
+        const __mmask16 mask = spanMask(length - x);
+        const __m512i srcVector = _mm512_maskz_loadu_epi32(mask, &src[x]);
+        if (!_mm512_mask_test_epi32_mask(mask, srcVector, alphaMask))
+            continue;
+        if (_mm512_mask_cmpge_epu32_mask(mask, srcVector, alphaMask) == mask) {
+            _mm512_mask_storeu_epi32(&dst[x], mask, srcVector);
+        } else {
+            const __m512i dstVector = _mm512_maskz_loadu_epi32(mask, &dst[x]);
+            _mm512_mask_storeu_epi32(&dst[x], mask, SOURCE_OVER_AVX512(srcVector, dstVector, colorMask, half));
+        }
+    }
+}
+
+static inline void Q_DECL_VECTORCALL
+BLEND_SOURCE_OVER_ARGB32_WITH_CONST_ALPHA_AVX512(quint32 *dst, const quint32 *src, int length, int const_alpha)
+{
+    const __m512i half = _mm512_set1_epi16(0x80);
+    const __m512i colorMask = _mm512_set1_epi32(0x00ff00ff);
+    const __m512i alphaMask = _mm512_set1_epi32(0xff000000);
+    const __m512i constAlphaVector = _mm512_set1_epi16(const_alpha);
+
+    for (int x = 0; x < length; x += 16) {
+        const __mmask16 mask = spanMask(length - x);
+        __m512i srcVector = _mm512_maskz_loadu_epi32(mask, &src[x]);
+        if (!_mm512_mask_test_epi32_mask(mask, srcVector, alphaMask))
+            continue;
+        srcVector = BYTE_MUL_AVX512(srcVector, constAlphaVector, colorMask, half);
+        const __m512i dstVector = _mm512_maskz_loadu_epi32(mask, &dst[x]);
+        _mm512_mask_storeu_epi32(&dst[x], mask, SOURCE_OVER_AVX512(srcVector, dstVector, colorMask, half));
+    }
+}
+
+void qt_blend_argb32_on_argb32_avx512(uchar *destPixels, int dbpl,
+                                      const uchar *srcPixels, int sbpl,
+                                      int w, int h,
+                                      int const_alpha)
+{
+    if (const_alpha == 256) {
+        for (int y = 0; y < h; ++y) {
+            const quint32 *src = reinterpret_cast<const quint32 *>(srcPixels);
+            quint32 *dst = reinterpret_cast<quint32 *>(destPixels);
+            BLEND_SOURCE_OVER_ARGB32_AVX512(dst, src, w);
+            destPixels += dbpl;
+            srcPixels += sbpl;
+        }
+    } else if (const_alpha != 0) {
+        const_alpha = (const_alpha * 255) >> 8;
+        for (int y = 0; y < h; ++y) {
+            const quint32 *src = reinterpret_cast<const quint32 *>(srcPixels);
+            quint32 *dst = reinterpret_cast<quint32 *>(destPixels);
+            BLEND_SOURCE_OVER_ARGB32_WITH_CONST_ALPHA_AVX512(dst, src, w, const_alpha);
+            destPixels += dbpl;
+            srcPixels += sbpl;
+        }
+    }
+}
+
+void QT_FASTCALL comp_func_SourceOver_avx512(uint *destPixels, const uint *srcPixels, int length, uint const_alpha)
+{
+    Q_ASSERT(const_alpha < 256);
+
+    const quint32 *src = (const quint32 *) srcPixels;
+    quint32 *dst = (quint32 *) destPixels;
+
+    if (const_alpha == 255)
+        BLEND_SOURCE_OVER_ARGB32_AVX512(dst, src, length);
+    else
+        BLEND_SOURCE_OVER_ARGB32_WITH_CONST_ALPHA_AVX512(dst, src, length, const_alpha);
+}
+
+void QT_FASTCALL comp_func_Source_avx512(uint *dst, const uint *src, int length, uint const_alpha)
+{
+    if (const_alpha == 255) {
+        ::memcpy(dst, src, length * sizeof(uint));
+    } else {
+        const __m512i half = _mm512_set1_epi16(0x80);
+        const __m512i colorMask = _mm512_set1_epi32(0x00ff00ff);
+        const __m512i constAlphaVector = _mm512_set1_epi16(const_alpha);
+        const __m512i oneMinusConstAlpha = _mm512_set1_epi16(255 - const_alpha);
+        for (int x = 0; x < length; x += 16) {
+            const __mmask16 mask = spanMask(length - x);
+            const __m512i srcVector = _mm512_maskz_loadu_epi32(mask, &src[x]);
+            const __m512i dstVector = _mm512_maskz_loadu_epi32(mask, &dst[x]);
+            _mm512_mask_storeu_epi32(&dst[x], mask,
+                                     INTERPOLATE_PIXEL_255_AVX512(srcVector, dstVector, constAlphaVector,
+                                                                  oneMinusConstAlpha, colorMask, half));
+        }
+    }
+}
+
+void QT_FASTCALL comp_func_Plus_avx512(uint *dst, const uint *src, int length, uint const_alpha)
+{
+    if (const_alpha == 255) {
+        for (int x = 0; x < length; x += 16) {
+            const __mmask16 mask = spanMask(length - x);
+            const __m512i srcVector = _mm512_maskz_loadu_epi32(mask, &src[x]);
+            const __m512i dstVector = _mm512_maskz_loadu_epi32(mask, &dst[x]);
+            _mm512_mask_storeu_epi32(&dst[x], mask, _mm512_adds_epu8(srcVector, dstVector));
+        }
+    } else {
+        const __m512i half = _mm512_set1_epi16(0x80);
+        const __m512i colorMask = _mm512_set1_epi32(0x00ff00ff);
+        const __m512i constAlphaVector = _mm512_set1_epi16(const_alpha);
+        const __m512i oneMinusConstAlpha = _mm512_set1_epi16(255 - const_alpha);
+        for (int x = 0; x < length; x += 16) {
+            const __mmask16 mask = spanMask(length - x);
+            const __m512i srcVector = _mm512_maskz_loadu_epi32(mask, &src[x]);
+            const __m512i dstVector = _mm512_maskz_loadu_epi32(mask, &dst[x]);
+            const __m512i result = _mm512_adds_epu8(srcVector, dstVector);
+            _mm512_mask_storeu_epi32(&dst[x], mask,
+                                     INTERPOLATE_PIXEL_255_AVX512(result, dstVector, constAlphaVector,
+                                                                  oneMinusConstAlpha, colorMask, half));
+        }
+    }
+}
+
+// Blends color, premultiplied by const_alpha, with each pixel multiplied by alpha.
+static inline void Q_DECL_VECTORCALL
+BLEND_SOLID_AVX512(quint32 *dst, int length, quint32 color, quint32 alpha)
+{
+    const __m512i colorVector = _mm512_set1_epi32(color);
+    const __m512i colorMask = _mm512_set1_epi32(0x00ff00ff);
+    const __m512i half = _mm512_set1_epi16(0x80);
+    const __m512i alphaVector = _mm512_set1_epi16(alpha);
+    for (int x = 0; x < length; x += 16) {
+        const __mmask16 mask = spanMask(length - x);
+        __m512i dstVector = _mm512_maskz_loadu_epi32(mask, &dst[x]);
+        dstVector = BYTE_MUL_AVX512(dstVector, alphaVector, colorMask, half);
+        _mm512_mask_storeu_epi32(&dst[x], mask, _mm512_add_epi8(colorVector, dstVector));
+    }
+}
+
+void QT_FASTCALL comp_func_solid_Source_avx512(uint *destPixels, int length, uint color, uint const_alpha)
+{
+    if (const_alpha == 255) {
+        qt_memfill32(destPixels, color, length);
+    } else {
+        color = BYTE_MUL(color, const_alpha);
+        BLEND_SOLID_AVX512(destPixels, length, color, 255 - const_alpha);
+    }
+}
+
+void QT_FASTCALL comp_func_solid_SourceOver_avx512(uint *destPixels, int length, uint color, uint const_alpha)
+{
+    if ((const_alpha & qAlpha(color)) == 255) {
+        qt_memfill32(destPixels, color, length);
+    } else {
+        if (const_alpha != 255)
+            color = BYTE_MUL(color, const_alpha);
+        BLEND_SOLID_AVX512(destPixels, length, color, qAlpha(~color));
+    }
+}
+
+#if QT_CONFIG(raster_fp)
+// The floating point functions process 4 pixels of 4 floats per iteration,
+// and mask the remaining channels of the tail in the same way.
+static inline __mmask16 spanMaskFP(int count)
+{
+    return count >= 4 ? __mmask16(0xffff) : __mmask16((1u << (count * 4)) - 1);
+}
+
+void QT_FASTCALL comp_func_SourceOver_rgbafp_avx512(QRgbaFloat32 *dst, const QRgbaFloat32 *src, int length, uint const_alpha)
+{
+    Q_ASSERT(const_alpha < 256); // const_alpha is in [0-255]
+
+    const __m512 one = _mm512_set1_ps(1.0f);
+    const __m512 constAlphaVector = _mm512_set1_ps(const_alpha / 255.0f);
+    for (int x = 0; x < length; x += 4) {
+        const __mmask16 mask = spanMaskFP(length - x);
+        __m512 srcVector = _mm512_maskz_loadu_ps(mask, &src[x]);
+        __m512 dstVector = _mm512_maskz_loadu_ps(mask, &dst[x]);
+        if (const_alpha != 255)
+            srcVector = _mm512_mul_ps(srcVector, constAlphaVector);
+        const __m512 alphaChannel = _mm512_sub_ps(one, _mm512_maskz_permute_ps(mask, srcVector, _MM_SHUFFLE(3, 3, 3, 3)));
+        dstVector = _mm512_fmadd_ps(dstVector, alphaChannel, srcVector);
+        _mm512_mask_storeu_ps(&dst[x], mask, dstVector);
+    }
+}
+
+void QT_FASTCALL comp_func_Source_rgbafp_avx512(QRgbaFloat32 *dst, const QRgbaFloat32 *src, int length, uint const_alpha)
+{
+    Q_ASSERT(const_alpha < 256); // const_alpha is in [0-255]
+    if (const_alpha == 255) {
+        ::memcpy(dst, src, length * sizeof(QRgbaFloat32));
+    } else {
+        const float ca = const_alpha / 255.f;
+        const __m512 constAlphaVector = _mm512_set1_ps(ca);
+        const __m512 oneMinusConstAlpha = _mm512_set1_ps(1.0f - ca);
+        for (int x = 0; x < length; x += 4) {
+            const __mmask16 mask = spanMaskFP(length - x);
+            const __m512 srcVector = _mm512_maskz_loadu_ps(mask, &src[x]);
+            const __m512 dstVector = _mm512_maskz_loadu_ps(mask, &dst[x]);
+            _mm512_mask_storeu_ps(&dst[x], mask,
+                                  _mm512_fmadd_ps(dstVector, oneMinusConstAlpha,
+                                                  _mm512_mul_ps(srcVector, constAlphaVector)));
+        }
+    }
+}
+
+// Blends color with each pixel multiplied by alpha.
+static inline void BLEND_SOLID_RGBAFP_AVX512(QRgbaFloat32 *dst, int length, QRgbaFloat32 color, float alpha)
+{
+    const __m512 colorVector = _mm512_setr4_ps(color.r, color.g, color.b, color.a);
+    const __m512 alphaVector = _mm512_set1_ps(alpha);
+    for (int x = 0; x < length; x += 4) {
+        const __mmask16 mask = spanMaskFP(length - x);
+        const __m512 dstVector = _mm512_maskz_loadu_ps(mask, &dst[x]);
+        _mm512_mask_storeu_ps(&dst[x], mask, _mm512_fmadd_ps(dstVector, alphaVector, colorVector));
+    }
+}
+
+static inline void FILL_RGBAFP_AVX512(QRgbaFloat32 *dst, int length, QRgbaFloat32 color)
+{
+    const __m512 colorVector = _mm512_setr4_ps(color.r, color.g, color.b, color.a);
+    for (int x = 0; x < length; x += 4)
+        _mm512_mask_storeu_ps(&dst[x], spanMaskFP(length - x), colorVector);
+}
+
+static inline QRgbaFloat32 multiplyAlphaFP(QRgbaFloat32 color, float a)
+{
+    return QRgbaFloat32{color.r * a, color.g * a, color.b * a, color.a * a};
+}
+
+void QT_FASTCALL comp_func_solid_Source_rgbafp_avx512(QRgbaFloat32 *dst, int length, QRgbaFloat32 color, uint const_alpha)
+{
+    Q_ASSERT(const_alpha < 256); // const_alpha is in [0-255]
+    if (const_alpha == 255) {
+        FILL_RGBAFP_AVX512(dst, length, color);
+    } else {
+        const float a = const_alpha / 255.0f;
+        BLEND_SOLID_RGBAFP_AVX512(dst, length, multiplyAlphaFP(color, a), 1.0f - a);
+    }
+}
+
+void QT_FASTCALL comp_func_solid_SourceOver_rgbafp_avx512(QRgbaFloat32 *dst, int length, QRgbaFloat32 color, uint const_alpha)
+{
+    Q_ASSERT(const_alpha < 256); // const_alpha is in [0-255]
+    if (const_alpha == 255 && color.a >= 1.0f) {
+        FILL_RGBAFP_AVX512(dst, length, color);
+    } else {
+        if (const_alpha != 255)
+            color = multiplyAlphaFP(color, const_alpha / 255.0f);
+        BLEND_SOLID_RGBAFP_AVX512(dst, length, color, 1.0f - color.a);
+    }
+}
+#endif
+
+QT_END_NAMESPACE
+
+#endif
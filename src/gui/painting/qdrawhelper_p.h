@@ -538,13 +538,16 @@ public:
     static void fetch(uint *buffer, uint *end, const Operator *op, const QSpanData *data, qreal det,
                       qreal delta_det, qreal delta_delta_det, qreal b, qreal delta_b)
     {
+        // Each lane advances by Lanes pixels per step.
+        constexpr int Lanes = sizeof(typename Simd::Float32x4) / sizeof(float);
+
         typename Simd::Vect_buffer_f det_vec;
         typename Simd::Vect_buffer_f delta_det4_vec;
         typename Simd::Vect_buffer_f b_vec;
 
-        for (int i = 0; i < 4; ++i) {
+        for (int i = 0; i < Lanes; ++i) {
             det_vec.f[i] = det;
-            delta_det4_vec.f[i] = 4 * delta_det;
+            delta_det4_vec.f[i] = Lanes * delta_det;
             b_vec.f[i] = b;
 
             det += delta_det;
@@ -552,9 +555,9 @@ public:
             b += delta_b;
         }
 
-        const typename Simd::Float32x4 v_delta_delta_det16 = Simd::v_dup(16 * delta_delta_det);
-        const typename Simd::Float32x4 v_delta_delta_det6 = Simd::v_dup(6 * delta_delta_det);
-        const typename Simd::Float32x4 v_delta_b4 = Simd::v_dup(4 * delta_b);
+        const typename Simd::Float32x4 v_delta_delta_det16 = Simd::v_dup(Lanes * Lanes * delta_delta_det);
+        const typename Simd::Float32x4 v_delta_delta_det6 = Simd::v_dup(Lanes * (Lanes - 1) / 2 * delta_delta_det);
+        const typename Simd::Float32x4 v_delta_b4 = Simd::v_dup(Lanes * delta_b);
 
         const typename Simd::Float32x4 v_r0 = Simd::v_dup(data->gradient.radial.focal.radius);
         const typename Simd::Float32x4 v_dr = Simd::v_dup(op->radial.dr);
@@ -595,7 +598,7 @@ public:
             det_vec.v = Simd::v_add(Simd::v_add(det_vec.v, delta_det4_vec.v), v_delta_delta_det6); \
             delta_det4_vec.v = Simd::v_add(delta_det4_vec.v, v_delta_delta_det16); \
             b_vec.v = Simd::v_add(b_vec.v, v_delta_b4); \
-            for (int i = 0; i < 4; ++i) \
+            for (int i = 0; i < Lanes; ++i) \
                 *buffer++ = (extended_mask | v_buffer_mask.i[i]) & data->gradient.colorTable32[index_vec.i[i]]; \
         }
 
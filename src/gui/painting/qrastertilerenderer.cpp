@@ -0,0 +1,395 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qrastertilerenderer_p.h"
+
+#ifndef QT_NO_PICTURE
+
+#include <qimage.h>
+#include <qpainter.h>
+#include <qpicture.h>
+#include <qpixmap.h>
+#include <qpaintengine.h>
+#include <private/qguiapplication_p.h>
+#include <qpa/qplatformintegration.h>
+
+#if QT_CONFIG(thread)
+#include <qsemaphore.h>
+#include <qthreadpool.h>
+#include <qthread.h>
+#endif
+
+#include <atomic>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QRasterTileRenderer
+    \internal
+    \ingroup painting
+
+    \brief The QRasterTileRenderer class replays a QPicture into a QImage,
+    rendering tiles of the image in parallel.
+
+    The picture records the paint commands. Every tile then replays all of
+    them with a painter of its own, on a thread of the global QThreadPool.
+    The tile is set as the system clip of the tile's paint engine, just like
+    the region of a partial update of a window, so the raster engine rejects
+    the primitives outside of the tile before rasterizing them and only
+    blends pixels inside of it.
+
+    The result is identical to replaying the picture with a single painter
+    on the whole image. Fetches that step in fixed point from the first
+    pixel of a span, as for scaled or transformed images and for gradients,
+    would round differently when a tile edge moves that first pixel. Before
+    painting in parallel, the picture is therefore replayed once into a
+    paint engine that only checks the commands, and pictures using any of
+    these are painted with a single painter instead.
+
+    Painting also falls back to a single painter on the calling thread when
+    the image cannot be shared between threads, or when the platform
+    does not support pixmaps outside of the GUI thread.
+*/
+
+namespace {
+
+// Replays nothing; only finds out whether the commands of a picture paint
+// the same pixels when clipped to tiles. Pixels may then only depend on
+// their device position, so fills must be solid or untransformed textures,
+// images and pixmaps must be drawn unscaled, and text must not be drawn in
+// perspective, which the raster engine fills through paths of its own.
+class QTileExactnessEngine : public QPaintEngine
+{
+public:
+    QTileExactnessEngine() : QPaintEngine(AllFeatures) { }
+
+    bool isExact() const { return exact; }
+
+    bool begin(QPaintDevice *) override { return true; }
+    bool end() override { return true; }
+    void updateState(const QPaintEngineState &) override { }
+    Type type() const override { return User; }
+
+    void drawPath(const QPainterPath &) override { checkFill(); checkStroke(); }
+    void drawPolygon(const QPointF *, int, PolygonDrawMode mode) override
+    {
+        if (mode != PolylineMode)
+            checkFill();
+        checkStroke();
+    }
+    void drawPolygon(const QPoint *, int, PolygonDrawMode mode) override
+    {
+        if (mode != PolylineMode)
+            checkFill();
+        checkStroke();
+    }
+    void drawRects(const QRectF *, int) override { checkFill(); checkStroke(); }
+    void drawRects(const QRect *, int) override { checkFill(); checkStroke(); }
+    void drawEllipse(const QRectF &) override { checkFill(); checkStroke(); }
+    void drawEllipse(const QRect &) override { checkFill(); checkStroke(); }
+    void drawLines(const QLineF *, int) override { checkStroke(); }
+    void drawLines(const QLine *, int) override { checkStroke(); }
+    void drawPoints(const QPointF *, int) override { checkStroke(); }
+    void drawPoints(const QPoint *, int) override { checkStroke(); }
+
+    void drawPixmap(const QRectF &r, const QPixmap &pm, const QRectF &sr) override
+    {
+        checkImage(r, sr, pm.devicePixelRatio());
+    }
+    void drawImage(const QRectF &r, const QImage &image, const QRectF &sr,
+                   Qt::ImageConversionFlags) override
+    {
+        checkImage(r, sr, image.devicePixelRatio());
+    }
+    void drawTiledPixmap(const QRectF &r, const QPixmap &pm, const QPointF &) override
+    {
+        const qreal dpr = pm.devicePixelRatio();
+        checkImage(r, QRectF(r.topLeft(), r.size() * dpr), dpr);
+    }
+    void drawTextItem(const QPointF &, const QTextItem &) override
+    {
+        if (painter()->combinedTransform().type() == QTransform::TxProject)
+            exact = false;
+        checkStroke();
+    }
+
+private:
+    void checkBrush(const QBrush &brush)
+    {
+        switch (brush.style()) {
+        case Qt::NoBrush:
+        case Qt::SolidPattern:
+            break;
+        case Qt::LinearGradientPattern:
+        case Qt::RadialGradientPattern:
+        case Qt::ConicalGradientPattern:
+            exact = false;
+            break;
+        default:
+            // textures and patterns are fetched at their device position
+            // unless the fetch is scaled or rotated
+            if ((brush.transform() * painter()->combinedTransform()).type() > QTransform::TxTranslate)
+                exact = false;
+            break;
+        }
+    }
+    void checkFill() { checkBrush(painter()->brush()); }
+    void checkStroke()
+    {
+        if (painter()->pen().style() != Qt::NoPen)
+            checkBrush(painter()->pen().brush());
+    }
+    void checkImage(const QRectF &r, const QRectF &sr, qreal dpr)
+    {
+        if (sr.isEmpty())
+            return;
+        const QTransform scale = QTransform::fromScale(r.width() * dpr / sr.width(),
+                                                       r.height() * dpr / sr.height());
+        if ((scale * painter()->combinedTransform()).type() > QTransform::TxTranslate)
+            exact = false;
+    }
+
+    bool exact = true;
+};
+
+// Stands in for the image while its picture is checked, so that the
+// picture is laid out for the same metrics.
+class QTileExactnessDevice : public QPaintDevice
+{
+public:
+    explicit QTileExactnessDevice(const QImage *image) : image(image) { }
+
+    QPaintEngine *paintEngine() const override { return &engine; }
+    bool isExact() const { return engine.isExact(); }
+
+protected:
+    int metric(PaintDeviceMetric metric) const override
+    {
+        switch (metric) {
+        case PdmWidth:
+            return image->width();
+        case PdmHeight:
+            return image->height();
+        case PdmWidthMM:
+            return image->widthMM();
+        case PdmHeightMM:
+            return image->heightMM();
+        case PdmNumColors:
+            return image->colorCount();
+        case PdmDepth:
+            return image->depth();
+        case PdmDpiX:
+            return image->logicalDpiX();
+        case PdmDpiY:
+            return image->logicalDpiY();
+        case PdmPhysicalDpiX:
+            return image->physicalDpiX();
+        case PdmPhysicalDpiY:
+            return image->physicalDpiY();
+        case PdmDevicePixelRatio:
+            return image->devicePixelRatio();
+        case PdmDevicePixelRatioScaled:
+            return image->devicePixelRatio() * devicePixelRatioFScale();
+        }
+        return QPaintDevice::metric(metric);
+    }
+
+private:
+    const QImage *image;
+    mutable QTileExactnessEngine engine;
+};
+
+} // unnamed namespace
+
+/*!
+    Constructs a renderer painting into \a image, which must stay
+    valid while the renderer is in use.
+*/
+QRasterTileRenderer::QRasterTileRenderer(QImage *image)
+    : m_image(image)
+{
+    Q_ASSERT(image);
+}
+
+/*!
+    \fn QSize QRasterTileRenderer::tileSize() const
+
+    Returns the size of the tiles, or an invalid size if the image
+    is split into horizontal bands, the default.
+*/
+
+/*!
+    \fn void QRasterTileRenderer::setTileSize(const QSize &size)
+
+    Sets the size of the tiles to \a size. With an invalid size, the
+    image is split into horizontal bands, a few for each thread of the
+    global QThreadPool.
+*/
+
+/*!
+    Returns the rectangles of the image rendered separately.
+*/
+QList<QRect> QRasterTileRenderer::tiles() const
+{
+    QList<QRect> tiles;
+    const QRect imageRect = m_image->rect();
+    if (imageRect.isEmpty())
+        return tiles;
+
+    if (m_tileSize.isValid() && !m_tileSize.isEmpty()) {
+        for (int y = 0; y < imageRect.height(); y += m_tileSize.height()) {
+            for (int x = 0; x < imageRect.width(); x += m_tileSize.width())
+                tiles.append(QRect(QPoint(x, y), m_tileSize) & imageRect);
+        }
+        return tiles;
+    }
+
+    // Bands taller than a few scanlines, and several of them for each
+    // thread so that a band with more content does not stall the others.
+    int segments = 1;
+#if QT_CONFIG(thread)
+    if (QThreadPool *threadPool = QThreadPool::globalInstance())
+        segments = threadPool->maxThreadCount() * 4;
+#endif
+    segments = qBound(1, segments, imageRect.height() / 32);
+
+    int y = 0;
+    for (int i = 0; i < segments; ++i) {
+        const int yn = (imageRect.height() - y) / (segments - i);
+        tiles.append(QRect(0, y, imageRect.width(), yn));
+        y += yn;
+    }
+    return tiles;
+}
+
+/*!
+    Replays \a picture into the image, and returns \c true if
+    successful; otherwise returns \c false.
+
+    \sa QPainter::drawPicture()
+*/
+bool QRasterTileRenderer::render(const QPicture &picture)
+{
+    if (m_image->isNull())
+        return false;
+    if (picture.isNull())
+        return true;
+
+#if QT_CONFIG(thread)
+    const QList<QRect> tiles = this->tiles();
+    QThreadPool *threadPool = QThreadPool::globalInstance();
+    if (tiles.size() > 1 && threadPool && !threadPool->contains(QThread::currentThread())
+        && canRenderInParallel(picture)) {
+        // The tiles paint on images sharing our buffer, detach first.
+        m_image->bits();
+
+        std::atomic<bool> ok(true);
+        QSemaphore semaphore;
+        for (const QRect &tile : tiles) {
+            threadPool->start([this, &picture, &ok, &semaphore, tile]() {
+                if (!renderTile(picture, tile))
+                    ok = false;
+                semaphore.release(1);
+            });
+        }
+        semaphore.acquire(tiles.size());
+        return ok;
+    }
+#endif
+
+    QPainter painter(m_image);
+    painter.drawPicture(0, 0, picture);
+    return painter.end();
+}
+
+/*!
+    Returns \c true if render() paints the tiles of \a picture in parallel;
+    otherwise returns \c false, in which case it paints with a single
+    painter, because the image or the platform does not allow painting from
+    other threads, or because tiles could change the rounding of some of the
+    picture's commands.
+*/
+bool QRasterTileRenderer::canRenderInParallel(const QPicture &picture) const
+{
+    // The paint engine cannot paint on indexed and monochrome images
+    // directly, these are converted and must not be shared.
+    if (m_image->depth() < 8 || m_image->format() == QImage::Format_Indexed8)
+        return false;
+
+    // Pixmaps in the picture are created when replaying it.
+    const QPlatformIntegration *platformIntegration = QGuiApplicationPrivate::platformIntegration();
+    if (!platformIntegration
+            || !platformIntegration->hasCapability(QPlatformIntegration::ThreadedPixmaps)) {
+        return false;
+    }
+
+    // QPicture::play() is not reentrant, check a copy of our own.
+    QPicture checked;
+    checked.setData(picture.data(), picture.size());
+    QTileExactnessDevice device(m_image);
+    QPainter painter(&device);
+    painter.drawPicture(0, 0, checked);
+    painter.end();
+    return device.isExact();
+}
+
+bool QRasterTileRenderer::renderTile(const QPicture &picture, const QRect &tile)
+{
+    // QPicture::play() is not reentrant, each tile replays its own copy.
+    QPicture tilePicture;
+    tilePicture.setData(picture.data(), picture.size());
+
+    // render() detached the image already, so this is our buffer.
+    uchar *bits = const_cast<uchar *>(m_image->constBits());
+    QImage tileImage(bits, m_image->width(), m_image->height(),
+                     m_image->bytesPerLine(), m_image->format());
+    tileImage.setDevicePixelRatio(m_image->devicePixelRatio());
+    tileImage.setDotsPerMeterX(m_image->dotsPerMeterX());
+    tileImage.setDotsPerMeterY(m_image->dotsPerMeterY());
+    tileImage.paintEngine()->setSystemClip(QRegion(tile));
+
+    QPainter painter(&tileImage);
+    painter.drawPicture(0, 0, tilePicture);
+    return painter.end();
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_PICTURE
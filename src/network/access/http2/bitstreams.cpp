@@ -305,8 +305,8 @@ bool BitIStream::read(QByteArray *dstPtr)
                 return true;
             }
 
-            BitIStream slice(first + offset / 8, first + offset / 8 + len);
-            if (huffman_decode_string(slice, &dst)) {
+            const uchar *src = first + offset / 8;
+            if (huffman_decode_string(src, src + len, &dst)) {
                 offset += quint64(len) * 8;
                 return true;
             }
@@ -42,6 +42,7 @@
 #include <QtCore/qdebug.h>
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstring>
 #include <limits>
@@ -84,6 +85,36 @@ int compare(const QByteArray &lhs, const QByteArray &rhs)
     return lhs.size() - rhs.size();
 }
 
+// FNV-1a, with a seed chosen so that the names in the static
+// table map to distinct values (a perfect hash for these names).
+quint32 static_name_hash(const QByteArray &name)
+{
+    quint32 hash = 139565;
+    for (const char c : name)
+        hash = (hash ^ uchar(c)) * 16777619u;
+    return hash >> (32 - 7);
+}
+
+using StaticNameIndex = std::array<quint8, 1 << 7>;
+
+// Maps the hash of a name to the (1-based) index of
+// its first entry in the static table, 0 if none.
+const StaticNameIndex &staticNameIndex()
+{
+    static const StaticNameIndex index = [] {
+        StaticNameIndex index = {};
+        const auto &table = FieldLookupTable::staticPart();
+        for (quint32 i = 0; i < table.size(); ++i) {
+            quint8 &slot = index[static_name_hash(table[i].name)];
+            if (!slot)
+                slot = quint8(i + 1);
+            Q_ASSERT(table[slot - 1].name == table[i].name);
+        }
+        return index;
+    }();
+    return index;
+}
+
 } // unnamed namespace
 
 FieldLookupTable::SearchEntry::SearchEntry()
@@ -444,8 +475,7 @@ void FieldLookupTable::setMaxDynamicTableSize(quint32 size)
     updateDynamicTableSize(size);
 }
 
-// This data is from the HPACK's specs and it's quite conveniently sorted,
-// except ... 'accept' is in the wrong position, see how we handle it below.
+// This data is from the HPACK's specs, entries with the same name are adjacent.
 const std::vector<HeaderField> &FieldLookupTable::staticPart()
 {
     static std::vector<HeaderField> table = {
@@ -518,27 +548,23 @@ const std::vector<HeaderField> &FieldLookupTable::staticPart()
 std::vector<HeaderField>::const_iterator FieldLookupTable::findInStaticPart(const HeaderField &field, CompareMode mode)
 {
     const auto &table = staticPart();
-    const auto acceptPos = table.begin() + 18;
-    if (field.name == "accept") {
-        if (mode == CompareMode::nameAndValue && field.value != "")
-            return table.end();
-        return acceptPos;
+    const quint8 first = staticNameIndex()[static_name_hash(field.name)];
+    if (!first)
+        return table.end();
+
+    // Entries with the same name are adjacent:
+    auto pos = table.begin() + (first - 1);
+    if (pos->name != field.name)
+        return table.end();
+    if (mode == CompareMode::nameOnly)
+        return pos;
+
+    for (; pos != table.end() && pos->name == field.name; ++pos) {
+        if (pos->value == field.value)
+            return pos;
     }
 
-    auto predicate = [mode](const HeaderField &lhs, const HeaderField &rhs) {
-        const int cmp = compare(lhs.name, rhs.name);
-        if (cmp)
-            return cmp < 0;
-        else if (mode == CompareMode::nameAndValue)
-            return compare(lhs.value, rhs.value) < 0;
-        return false;
-    };
-
-    const auto staticPos = std::lower_bound(table.begin(), acceptPos, field, predicate);
-    if (staticPos != acceptPos)
-        return staticPos;
-
-    return std::lower_bound(acceptPos + 1, table.end(), field, predicate);
+    return table.end();
 }
 
 }
@@ -124,8 +124,10 @@ inline HeaderSize entry_size(const HeaderField &entry)
     offset in this chunk - random access.
 
     Lookup in a static part is straightforward:
-    it's an (immutable) vector, data is sorted,
-    contains no duplicates, we use binary search comparing string values.
+    it's an (immutable) vector and entries with the same name
+    are adjacent. A perfect hash of the name gives us the
+    first entry with this name (if any), then we compare
+    values of the (at most 7) entries with this name.
 
     To provide a lookup in dynamic table faster than a linear search,
     we have an std::set of 'SearchEntries', where each entry contains:
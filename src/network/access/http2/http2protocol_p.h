@@ -149,6 +149,9 @@ const quint32 lastValidStreamID((quint32(1) << 31) - 1); // HTTP/2, 5.1.1
 // we do the same and split this window size between our concurrent streams.
 const qint32 maxSessionReceiveWindowSize((quint32(1) << 31) - 1);
 const qint32 qtDefaultStreamReceiveWindowSize = maxSessionReceiveWindowSize / maxConcurrentStreams;
+// With window auto-tuning enabled, we grow receive windows up to this size
+// (but never shrink a window that was configured to be larger):
+const qint32 maxAutoTunedWindowSize = 16 * 1024 * 1024;
 
 struct Frame configurationToSettingsFrame(const QHttp2Configuration &configuration);
 QByteArray settingsFrameToBase64(const Frame &settingsFrame);
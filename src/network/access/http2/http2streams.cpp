@@ -59,6 +59,7 @@ Stream::Stream(const HttpMessagePair &message, quint32 id, qint32 sendSize, qint
       sendWindow(sendSize),
       recvWindow(recvSize)
 {
+    timer.start();
 }
 
 Stream::Stream(const QString &cacheKey, quint32 id, qint32 recvSize)
@@ -68,6 +69,7 @@ Stream::Stream(const QString &cacheKey, quint32 id, qint32 recvSize)
       state(remoteReserved),
       key(cacheKey)
 {
+    timer.start();
 }
 
 QHttpNetworkReply *Stream::reply() const
@@ -92,6 +94,9 @@ QHttpNetworkRequest::Priority Stream::priority() const
 
 uchar Stream::weight() const
 {
+    if (peerWeight >= 0)
+        return uchar(peerWeight);
+
     switch (priority()) {
     case QHttpNetworkRequest::LowPriority:
         return 0;
@@ -57,6 +57,7 @@
 #include <private/qhttpnetworkconnectionchannel_p.h>
 #include <private/qhttpnetworkrequest_p.h>
 
+#include <QtCore/qelapsedtimer.h>
 #include <QtCore/qglobal.h>
 #include <QtCore/qstring.h>
 
@@ -105,6 +106,17 @@ struct Q_AUTOTEST_EXPORT Stream
 
     StreamState state = idle;
     QString key; // for PUSH_PROMISE
+
+    // Set by our peer's PRIORITY frames (5.3), until then
+    // a stream depends on the root and weight() is derived
+    // from the request's priority:
+    quint32 dependency = 0;
+    int peerWeight = -1;
+
+    // Throughput counters:
+    qint64 bytesSent = 0;
+    qint64 bytesReceived = 0;
+    QElapsedTimer timer; // started when the stream is created
 };
 
 struct PushPromise
@@ -42,8 +42,9 @@
 
 #include <QtCore/qbytearray.h>
 
-#include <algorithm>
+#include <array>
 #include <limits>
+#include <vector>
 
 QT_BEGIN_NAMESPACE
 
@@ -60,32 +61,22 @@ namespace HPack
     code length. All codes were left-aligned - for implementation
     convenience.
 
-    Using binary trees to implement decoding would be prohibitively
-    expensive (both memory and time-wise). Instead we use a table-based
-    approach and any given code itself works as an index into such table(s).
-    We have 256 possible byte values and code lengths in
-    a range [5, 26]. This would require a huge table (and most of entries
-    would be 'wasted', since we only have to encode 256 elements).
-    Instead we use multi-level tables. The first level table
-    is using 9-bit length index; some entries in this table are 'terminal',
-    some reference the next level table(s).
-
-    For example, bytes with values 48 and 49 (ASCII codes for '0' and '1')
-    both have code length 5, Huffman codes are: 00000 and 00001. They
-    both are placed in the 'root' table,
-    the 'root' table has index length == 9:
-    [00000 | 4 remaining bits]
-     ...
-    [00001 | 4 remaining bits]
-
-    All entries with indices between these two will 'point' to value 48
-    with bitLength == 5 so that bit stream (for example) 000001010 will be
-    decoded as: 48 + "put 1010 back into bitstream".
-
-    A good description can be found here:
-    http://commandlinefanatic.com/cgi-bin/showarticle.cgi?article=art007
-    or just google "Efficient Huffman Decoding".
-    Also see comments below about 'filling holes'.
+    Decoding bit by bit (walking a binary tree, or peeking the longest
+    possible code and looking it up in multi-level tables) has to
+    re-read the input for every symbol. Instead, as nghttp2 does, we
+    use a finite state machine that consumes the input 4 bits at a time.
+    A state is an internal node of the Huffman tree - the bits of the
+    current code seen so far; with 257 symbols (including EOS) there
+    are 256 such nodes, so a state fits into a byte. For every state and
+    every 4-bit input we precompute the state we end up in and the symbol
+    completed on the way, if any. The shortest code is 5 bits long, so
+    4 bits can complete at most one symbol, and every input octet takes
+    exactly two table lookups.
+
+    The input may only end at the root of the tree, or in a state
+    reached from the root by at most 7 bits, all of them set - this is
+    the padding allowed by HPACK, 5.2. Such states are marked
+    as 'accepting' in the table.
 */
 
 namespace
@@ -385,7 +376,7 @@ quint64 huffman_encoded_bit_length(const QByteArray &inputData)
 {
     quint64 bitLength = 0;
     for (int i = 0, e = inputData.size(); i < e; ++i)
-        bitLength += staticHuffmanCodeTable[int(inputData[i])].bitLength;
+        bitLength += staticHuffmanCodeTable[uchar(inputData[i])].bitLength;
 
     return bitLength;
 }
@@ -402,172 +393,114 @@ void huffman_encode_string(const QByteArray &inputData, BitOStream &outputStream
         outputStream.writeBits(0xff, 8 - outputStream.bitLength() % 8);
 }
 
-bool padding_is_valid(quint32 chunk, quint32 nBits)
+namespace
 {
-    Q_ASSERT(nBits);
-
-    // HPACK, 5.2: "A padding strictly longer than 7 bits MUST be
-    // treated as a decoding error."
-    if (nBits > 7)
-        return false;
-    // HPACK, 5.2:
-    // "A padding not corresponding to the most significant bits
-    // of the code for the EOS symbol MUST be treated as a decoding error."
-    return (chunk >> (32 - nBits)) == quint32((1 << nBits) - 1);
-}
 
-HuffmanDecoder::HuffmanDecoder()
-    : minCodeLength()
+enum HuffmanDecodeFlag : quint8
 {
-    const auto nCodes = sizeof staticHuffmanCodeTable / sizeof staticHuffmanCodeTable[0];
-
-    std::vector<CodeEntry> symbols(staticHuffmanCodeTable, staticHuffmanCodeTable + nCodes);
-    // Now we sort: by bit length first (in the descending order) and by the symbol
-    // value (descending). Descending order: to make sure we do not create prefix tables with
-    // short 'indexLength' first and having longer codes that do not fit into such tables later.
-    std::sort(symbols.begin(), symbols.end(), [](const CodeEntry &code1, const CodeEntry &code2) {
-        if (code1.bitLength == code2.bitLength)
-            return code1.byteValue > code2.byteValue;
-        return code1.bitLength > code2.bitLength;
-    });
-
-    minCodeLength = symbols.back().bitLength; // The shortest one, currently it's 5.
-
-    // TODO: add a verification - Huffman codes
-    // within a given bit length range also
-    // should be in descending order.
-
-    // Initialize 'prefixTables' and 'tableData'.
-    addTable(0, quint32(BitConstants::rootPrefix)); // 'root' table.
-
-    for (const auto &s : symbols) {
-        quint32 tableIndex = 0;
-        while (true) {
-            Q_ASSERT(tableIndex < prefixTables.size());
-            // Note, by value - since prefixTables will be updated in between.
-            const auto table = prefixTables[tableIndex];
-            // We skip prefixed bits (if any) and use indexed bits only:
-            const auto entryIndex = s.huffmanCode << table.prefixLength >> (32 - table.indexLength);
-            // Again, by value.
-            PrefixTableEntry entry = tableEntry(table, entryIndex);
-            // How many bits were coded by previous tables and this table:
-            const auto codedLength = table.prefixLength + table.indexLength;
-            if (codedLength < s.bitLength) {
-                // We have to add a new prefix table ... (if it's not done yet).
-                if (!entry.bitLength) {
-                    entry.nextTable = addTable(codedLength, std::min<quint32>(quint32(BitConstants::childPrefix),
-                                                                              s.bitLength - codedLength));
-                    entry.bitLength = s.bitLength;
-                    entry.byteValue = s.byteValue;
-                    setTableEntry(table, entryIndex, entry);
-                }
-                tableIndex = entry.nextTable;
-            } else {
-                // We found the slot for our code (terminal entry):
-                entry.byteValue = s.byteValue;
-                entry.bitLength = s.bitLength;
-                // Refer to our own table as 'nextTable':
-                entry.nextTable = tableIndex;
-                setTableEntry(table, entryIndex, entry);
-                break;
-            }
-        }
-    }
-
-    // Now, we have a table(s) and have to fill 'holes' to
-    // 'fix' terminal entries.
-    for (const auto &table : prefixTables) {
-        const quint32 codedLength = table.prefixLength + table.indexLength;
-        for (quint32 j = 0; j < table.size();) {
-            const PrefixTableEntry &entry = tableEntry(table, j);
-            if (entry.bitLength && entry.bitLength < codedLength) {
-                const quint32 range = 1 << (codedLength - entry.bitLength);
-                for (quint32 k = 1; k < range; ++k)
-                    setTableEntry(table, j + k, entry);
-                j += range;
-            } else {
-                ++j;
-            }
-        }
-    }
-}
+    HuffmanAccepted = 0x1, // The input can end in the new state.
+    HuffmanSymbol = 0x2,   // 'symbol' was decoded.
+    HuffmanFailure = 0x4   // EOS was decoded (HPACK, 5.2).
+};
 
-bool HuffmanDecoder::decodeStream(BitIStream &inputStream, QByteArray &outputBuffer)
+struct HuffmanDecodeEntry
 {
-    while (true) {
-        quint32 chunk = 0;
-        const quint32 readBits = inputStream.peekBits(inputStream.streamOffset(), 32, &chunk);
-        if (!readBits)
-            return !inputStream.hasMoreBits();
-
-        if (readBits < minCodeLength) {
-            inputStream.skipBits(readBits);
-            return padding_is_valid(chunk, readBits);
-        }
-
-        quint32 tableIndex = 0;
-        const PrefixTable *table = &prefixTables[tableIndex];
-        quint32 entryIndex = chunk >> (32 - table->indexLength);
-        PrefixTableEntry entry = tableEntry(*table, entryIndex);
+    quint8 state;
+    quint8 flags;
+    quint8 symbol;
+};
 
-        while (true) {
-            if (entry.nextTable == tableIndex)
-                break;
+using HuffmanDecodeTable = std::array<std::array<HuffmanDecodeEntry, 16>, 256>;
 
-            tableIndex = entry.nextTable;
-            table = &prefixTables[tableIndex];
-            entryIndex = chunk << table->prefixLength >> (32 - table->indexLength);
-            entry = tableEntry(*table, entryIndex);
-        }
-
-        if (entry.bitLength > readBits) {
-            inputStream.skipBits(readBits);
-            return padding_is_valid(chunk, readBits);
+HuffmanDecodeTable build_huffman_decode_table()
+{
+    // The Huffman tree: internal nodes are numbered from 0 (the root),
+    // a leaf is stored as the complement of its symbol.
+    std::vector<std::array<int, 2>> nodes(1, {0, 0});
+    for (const CodeEntry &code : staticHuffmanCodeTable) {
+        int node = 0;
+        for (quint32 i = 0; i < code.bitLength; ++i) {
+            const int bit = (code.huffmanCode >> (31 - i)) & 1;
+            if (i + 1 == code.bitLength) {
+                nodes[node][bit] = ~int(code.byteValue);
+            } else {
+                if (!nodes[node][bit]) {
+                    nodes[node][bit] = int(nodes.size());
+                    nodes.push_back({0, 0});
+                }
+                node = nodes[node][bit];
+            }
         }
+    }
+    Q_ASSERT(nodes.size() == 256);
+
+    // The root and up to 7 bits of EOS' prefix are valid padding.
+    std::array<bool, 256> accepting = {};
+    for (int node = 0, depth = 0; depth <= 7; ++depth, node = nodes[node][1])
+        accepting[node] = true;
+
+    HuffmanDecodeTable table;
+    for (int state = 0; state < 256; ++state) {
+        for (int input = 0; input < 16; ++input) {
+            HuffmanDecodeEntry &entry = table[state][input];
+            entry = HuffmanDecodeEntry();
+            int node = state;
+            for (int i = 3; i >= 0; --i) {
+                node = nodes[node][(input >> i) & 1];
+                if (node < 0) {
+                    if (~node == 256) {
+                        entry.flags = HuffmanFailure;
+                        break;
+                    }
+                    entry.flags = HuffmanSymbol;
+                    entry.symbol = quint8(~node);
+                    node = 0;
+                }
+            }
 
-        if (!entry.bitLength || entry.byteValue == 256) {
-            //EOS (256) == compression error (HPACK).
-            inputStream.skipBits(readBits);
-            return false;
+            if (entry.flags != HuffmanFailure) {
+                entry.state = quint8(node);
+                if (accepting[node])
+                    entry.flags |= HuffmanAccepted;
+            }
         }
-
-        outputBuffer.append(entry.byteValue);
-        inputStream.skipBits(entry.bitLength);
     }
 
-    return false;
-}
-
-quint32 HuffmanDecoder::addTable(quint32 prefix, quint32 index)
-{
-    PrefixTable newTable{prefix, index};
-    newTable.offset = quint32(tableData.size());
-    prefixTables.push_back(newTable);
-    // Add entries for this table:
-    tableData.resize(tableData.size() + newTable.size());
-
-    return quint32(prefixTables.size() - 1);
-}
-
-PrefixTableEntry HuffmanDecoder::tableEntry(const PrefixTable &table, quint32 index)
-{
-    Q_ASSERT(index < table.size());
-    return tableData[table.offset + index];
+    return table;
 }
 
-void HuffmanDecoder::setTableEntry(const PrefixTable &table, quint32 index,
-                                   const PrefixTableEntry &entry)
-{
-    Q_ASSERT(index < table.size());
-    tableData[table.offset + index] = entry;
-}
+} // unnamed namespace
 
-bool huffman_decode_string(BitIStream &inputStream, QByteArray *outputBuffer)
+bool huffman_decode_string(const uchar *first, const uchar *last, QByteArray *outputBuffer)
 {
     Q_ASSERT(outputBuffer);
+    Q_ASSERT(first <= last);
+
+    static const HuffmanDecodeTable table = build_huffman_decode_table();
+
+    // Every code is at least 5 bits long:
+    const qsizetype oldSize = outputBuffer->size();
+    outputBuffer->resize(oldSize + (last - first) * 8 / 5);
+    char *dst = outputBuffer->data() + oldSize;
+
+    quint8 state = 0;
+    bool accepted = true;
+    for (; first != last; ++first) {
+        for (const uchar input : {uchar(*first >> 4), uchar(*first & 0xf)}) {
+            const HuffmanDecodeEntry &entry = table[state][input];
+            if (entry.flags & HuffmanFailure) {
+                outputBuffer->truncate(oldSize);
+                return false;
+            }
+            if (entry.flags & HuffmanSymbol)
+                *dst++ = char(entry.symbol);
+            state = entry.state;
+            accepted = entry.flags & HuffmanAccepted;
+        }
+    }
 
-    static HuffmanDecoder decoder;
-    return decoder.decodeStream(inputStream, *outputBuffer);
+    outputBuffer->truncate(dst - outputBuffer->constData());
+    return accepted;
 }
 
 }
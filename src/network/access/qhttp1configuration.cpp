@@ -0,0 +1,290 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qhttp1configuration.h"
+
+#include "private/qhttpnetworkconnection_p.h"
+
+#include "qdebug.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QHttp1Configuration
+    \brief The QHttp1Configuration class controls HTTP/1.1 connection pool parameters.
+    \since 6.3
+
+    \reentrant
+    \inmodule QtNetwork
+    \ingroup network
+    \ingroup shared
+
+    QHttp1Configuration controls how QNetworkAccessManager manages the
+    HTTP/1.1 connections it opens to a host. The parameters that
+    QHttp1Configuration currently supports include:
+
+    \list
+      \li The number of connections QNetworkAccessManager opens in parallel
+          to the host. Requests that are sent while all connections are
+          busy are queued until one of them becomes available.
+      \li The pipelining depth, which limits how many requests are sent on
+          a connection while a response is still outstanding. This only
+          applies to requests that allow pipelining, see
+          QNetworkRequest::HttpPipeliningAllowedAttribute.
+      \li The idle timeout, after which the connections to the host are
+          closed if no further requests were sent.
+      \li Whether TCP keep-alive probes are enabled on the connections.
+    \endlist
+
+    \note The configuration only applies to connections opened after it
+    was set with QNetworkAccessManager::setHttp1Configuration(). The
+    parameters of an HTTP/2 session are controlled by QHttp2Configuration.
+
+    \sa QNetworkAccessManager::setHttp1Configuration(), QHttp2Configuration
+*/
+
+class QHttp1ConfigurationPrivate : public QSharedData
+{
+public:
+    unsigned numberOfConnectionsPerHost = QHttpNetworkConnectionPrivate::defaultHttpChannelCount;
+    unsigned pipeliningDepth = QHttpNetworkConnectionPrivate::defaultPipelineLength;
+    int idleTimeout = QHttpNetworkConnectionPrivate::defaultIdleTimeout;
+    bool keepAliveProbesEnabled = true;
+};
+
+/*!
+    Default constructs a QHttp1Configuration object.
+
+    Such a configuration has the following values:
+    \list
+        \li Up to 6 connections are opened per host
+        \li Up to 3 requests are pipelined behind an outstanding response
+        \li Idle connections are closed after 120 seconds
+        \li TCP keep-alive probes are enabled
+    \endlist
+*/
+QHttp1Configuration::QHttp1Configuration()
+    : d(new QHttp1ConfigurationPrivate)
+{
+}
+
+/*!
+    Copy-constructs this QHttp1Configuration.
+*/
+QHttp1Configuration::QHttp1Configuration(const QHttp1Configuration &) = default;
+
+/*!
+    Move-constructs this QHttp1Configuration from \a other
+*/
+QHttp1Configuration::QHttp1Configuration(QHttp1Configuration &&other) noexcept
+{
+    swap(other);
+}
+
+/*!
+    Copy-assigns \a other to this QHttp1Configuration.
+*/
+QHttp1Configuration &QHttp1Configuration::operator=(const QHttp1Configuration &) = default;
+
+/*!
+    Move-assigns \a other to this QHttp1Configuration.
+*/
+QHttp1Configuration &QHttp1Configuration::operator=(QHttp1Configuration &&) noexcept = default;
+
+/*!
+    Destructor.
+*/
+QHttp1Configuration::~QHttp1Configuration()
+{
+}
+
+/*!
+    Sets the maximum number of connections QNetworkAccessManager opens
+    in parallel to a host. \a number cannot be 0 and must not exceed 65535.
+
+    Returns \c true on success, \c false otherwise.
+
+    \sa numberOfConnectionsPerHost()
+*/
+bool QHttp1Configuration::setNumberOfConnectionsPerHost(unsigned number)
+{
+    if (!number || number > std::numeric_limits<quint16>::max()) {
+        qWarning("QHttp1Configuration::setNumberOfConnectionsPerHost: invalid number of connections %u",
+                 number);
+        return false;
+    }
+
+    d->numberOfConnectionsPerHost = number;
+    return true;
+}
+
+/*!
+    Returns the maximum number of connections QNetworkAccessManager opens
+    in parallel to a host. The default value is 6.
+
+    \sa setNumberOfConnectionsPerHost()
+*/
+unsigned QHttp1Configuration::numberOfConnectionsPerHost() const
+{
+    return d->numberOfConnectionsPerHost;
+}
+
+/*!
+    Sets the maximum number of requests that are pipelined on a connection
+    behind a request whose response has not been received yet to \a depth.
+    A \a depth of 0 disables pipelining. \a depth must not exceed 64.
+
+    Returns \c true on success, \c false otherwise.
+
+    \sa pipeliningDepth(), QNetworkRequest::HttpPipeliningAllowedAttribute
+*/
+bool QHttp1Configuration::setPipeliningDepth(unsigned depth)
+{
+    if (depth > 64) {
+        qWarning("QHttp1Configuration::setPipeliningDepth: invalid depth %u", depth);
+        return false;
+    }
+
+    d->pipeliningDepth = depth;
+    return true;
+}
+
+/*!
+    Returns the maximum number of requests that are pipelined on a
+    connection. The default value is 3.
+
+    \sa setPipeliningDepth()
+*/
+unsigned QHttp1Configuration::pipeliningDepth() const
+{
+    return d->pipeliningDepth;
+}
+
+/*!
+    Sets the time, in \a seconds, after which the connections to a host are
+    closed once the last pending request has been processed. \a seconds
+    cannot be negative; with 0, connections are closed as soon as they become
+    idle.
+
+    This is the default for requests that do not set
+    QNetworkRequest::ConnectionCacheExpiryTimeoutSecondsAttribute.
+
+    Returns \c true on success, \c false otherwise.
+
+    \sa idleTimeout()
+*/
+bool QHttp1Configuration::setIdleTimeout(int seconds)
+{
+    if (seconds < 0) {
+        qWarning("QHttp1Configuration::setIdleTimeout: invalid timeout %d", seconds);
+        return false;
+    }
+
+    d->idleTimeout = seconds;
+    return true;
+}
+
+/*!
+    Returns the time, in seconds, after which idle connections are closed.
+    The default value is 120 seconds.
+
+    \sa setIdleTimeout()
+*/
+int QHttp1Configuration::idleTimeout() const
+{
+    return d->idleTimeout;
+}
+
+/*!
+    If \a enable is \c true, the operating system periodically probes idle
+    connections to detect peers that went away without closing them.
+    Enabled by default.
+
+    \sa keepAliveProbesEnabled(), QAbstractSocket::KeepAliveOption
+*/
+void QHttp1Configuration::setKeepAliveProbesEnabled(bool enable)
+{
+    d->keepAliveProbesEnabled = enable;
+}
+
+/*!
+    Returns \c true if TCP keep-alive probes are enabled.
+
+    \sa setKeepAliveProbesEnabled()
+*/
+bool QHttp1Configuration::keepAliveProbesEnabled() const
+{
+    return d->keepAliveProbesEnabled;
+}
+
+/*!
+    Swaps this configuration with the \a other configuration.
+*/
+void QHttp1Configuration::swap(QHttp1Configuration &other) noexcept
+{
+    d.swap(other.d);
+}
+
+/*!
+    \fn bool QHttp1Configuration::operator==(const QHttp1Configuration &lhs, const QHttp1Configuration &rhs) noexcept
+    Returns \c true if \a lhs and \a rhs have the same set of HTTP/1.1
+    parameters.
+*/
+
+/*!
+    \fn bool QHttp1Configuration::operator!=(const QHttp1Configuration &lhs, const QHttp1Configuration &rhs) noexcept
+    Returns \c true if \a lhs and \a rhs do not have the same set of HTTP/1.1
+    parameters.
+*/
+
+/*!
+    \internal
+*/
+bool QHttp1Configuration::isEqual(const QHttp1Configuration &other) const noexcept
+{
+    if (d == other.d)
+        return true;
+
+    return d->numberOfConnectionsPerHost == other.d->numberOfConnectionsPerHost
+           && d->pipeliningDepth == other.d->pipeliningDepth
+           && d->idleTimeout == other.d->idleTimeout
+           && d->keepAliveProbesEnabled == other.d->keepAliveProbesEnabled;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,95 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QHTTP1CONFIGURATION_H
+#define QHTTP1CONFIGURATION_H
+
+#include <QtNetwork/qtnetworkglobal.h>
+
+#include <QtCore/qshareddata.h>
+
+#ifndef Q_CLANG_QDOC
+QT_REQUIRE_CONFIG(http);
+#endif
+
+QT_BEGIN_NAMESPACE
+
+class QHttp1ConfigurationPrivate;
+class Q_NETWORK_EXPORT QHttp1Configuration
+{
+public:
+    QHttp1Configuration();
+    QHttp1Configuration(const QHttp1Configuration &other);
+    QHttp1Configuration(QHttp1Configuration &&other) noexcept;
+    QHttp1Configuration &operator = (const QHttp1Configuration &other);
+    QHttp1Configuration &operator = (QHttp1Configuration &&other) noexcept;
+
+    ~QHttp1Configuration();
+
+    bool setNumberOfConnectionsPerHost(unsigned number);
+    unsigned numberOfConnectionsPerHost() const;
+
+    bool setPipeliningDepth(unsigned depth);
+    unsigned pipeliningDepth() const;
+
+    bool setIdleTimeout(int seconds);
+    int idleTimeout() const;
+
+    void setKeepAliveProbesEnabled(bool enable);
+    bool keepAliveProbesEnabled() const;
+
+    void swap(QHttp1Configuration &other) noexcept;
+
+private:
+    QSharedDataPointer<QHttp1ConfigurationPrivate> d;
+
+    bool isEqual(const QHttp1Configuration &other) const noexcept;
+
+    friend bool operator==(const QHttp1Configuration &lhs, const QHttp1Configuration &rhs) noexcept
+    { return lhs.isEqual(rhs); }
+    friend bool operator!=(const QHttp1Configuration &lhs, const QHttp1Configuration &rhs) noexcept
+    { return !lhs.isEqual(rhs); }
+
+};
+
+Q_DECLARE_SHARED(QHttp1Configuration)
+
+QT_END_NAMESPACE
+
+#endif // QHTTP1CONFIGURATION_H
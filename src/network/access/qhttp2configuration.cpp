@@ -81,7 +81,8 @@ QT_BEGIN_NAMESPACE
 
     The QHttp2Configuration class also controls if the header compression
     algorithm (HPACK) is additionally using Huffman coding for string
-    compression.
+    compression, and if the receive window sizes are adjusted to the
+    bandwidth-delay product of the connection while responses are received.
 
     \note The configuration must be set before the first request
     was sent to a given host (and thus an HTTP/2 session established).
@@ -103,6 +104,7 @@ public:
     unsigned maxFrameSize = Http2::minPayloadLimit; // Initial (default) value of 16Kb.
 
     bool pushEnabled = false;
+    bool windowAutoTuningEnabled = false;
     // TODO: for now those two below are noop.
     bool huffmanCompressionEnabled = true;
 };
@@ -114,6 +116,7 @@ public:
     \list
         \li Server push is disabled
         \li Huffman string compression is enabled
+        \li Receive window auto-tuning is disabled
         \li Window size for connection-level flow control is 65535 octets
         \li Window size for stream-level flow control is 65535 octets
         \li Frame size is 16384 octets
@@ -202,6 +205,42 @@ bool QHttp2Configuration::huffmanCompressionEnabled() const
     return d->huffmanCompressionEnabled;
 }
 
+/*!
+    \since 6.3
+
+    If \a enable is \c true, QNetworkAccessManager measures the
+    bandwidth-delay product of the connection while it receives data, using
+    'PING' frames to sample the round-trip time, and grows the session and
+    stream receive windows to twice that product when they are too small to
+    keep the connection busy. This avoids downloads stalling on
+    'WINDOW_UPDATE' round trips on fast connections with high latency.
+
+    The windows start at sessionReceiveWindowSize() and
+    streamReceiveWindowSize(), and are never shrunk. They grow up to
+    16 MiB, or the configured size if that is larger.
+
+    Auto-tuning is disabled by default.
+
+    \sa windowAutoTuningEnabled(), setStreamReceiveWindowSize(), setSessionReceiveWindowSize()
+*/
+void QHttp2Configuration::setWindowAutoTuningEnabled(bool enable)
+{
+    d->windowAutoTuningEnabled = enable;
+}
+
+/*!
+    \since 6.3
+
+    Returns \c true if the receive window sizes are adjusted to the
+    bandwidth-delay product of the connection.
+
+    \sa setWindowAutoTuningEnabled()
+*/
+bool QHttp2Configuration::windowAutoTuningEnabled() const
+{
+    return d->windowAutoTuningEnabled;
+}
+
 /*!
     Sets the window size for connection-level flow control.
     \a size cannot be 0 and must not exceed 2147483647 octets.
@@ -319,6 +358,7 @@ bool QHttp2Configuration::isEqual(const QHttp2Configuration &other) const noexce
 
     return d->pushEnabled == other.d->pushEnabled
            && d->huffmanCompressionEnabled == other.d->huffmanCompressionEnabled
+           && d->windowAutoTuningEnabled == other.d->windowAutoTuningEnabled
            && d->sessionWindowSize == other.d->sessionWindowSize
            && d->streamWindowSize == other.d->streamWindowSize;
 }
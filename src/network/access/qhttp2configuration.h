@@ -74,6 +74,9 @@ public:
     bool setStreamReceiveWindowSize(unsigned size);
     unsigned streamReceiveWindowSize() const;
 
+    void setWindowAutoTuningEnabled(bool enable);
+    bool windowAutoTuningEnabled() const;
+
     bool setMaxFrameSize(unsigned size);
     unsigned maxFrameSize() const;
 
@@ -181,6 +181,9 @@ QHttp2ProtocolHandler::QHttp2ProtocolHandler(QHttpNetworkConnectionChannel *chan
     maxSessionReceiveWindowSize = h2Config.sessionReceiveWindowSize();
     pushPromiseEnabled = h2Config.serverPushEnabled();
     streamInitialReceiveWindowSize = h2Config.streamReceiveWindowSize();
+    streamReceiveWindowSize = streamInitialReceiveWindowSize;
+    // Nothing to tune if the configured windows are already large enough:
+    windowAutoTuning = h2Config.windowAutoTuningEnabled() && canGrowReceiveWindows();
     encoder.setCompressStrings(h2Config.huffmanCompressionEnabled());
 
     if (!channel->ssl && m_connection->connectionType() != QHttpNetworkConnection::ConnectionTypeHTTP2Direct) {
@@ -194,6 +197,8 @@ QHttp2ProtocolHandler::QHttp2ProtocolHandler(QHttpNetworkConnectionChannel *chan
         Q_ASSERT(initialStreamID == 1);
         Stream &stream = activeStreams[initialStreamID];
         stream.state = Stream::halfClosedLocal;
+        // The 101 response to that request has been received already.
+        sessionEstablished = true;
     }
 }
 
@@ -524,7 +529,20 @@ bool QHttp2ProtocolHandler::sendDATA(Stream &stream)
     const auto replyPrivate = reply->d_func();
     Q_ASSERT(replyPrivate);
 
-    auto slot = std::min<qint32>(sessionSendWindowSize, stream.sendWindow);
+    if (isBlockedByDependency(stream)) {
+        // The stream it depends on gets the window first (5.3.1).
+        addToSuspended(stream);
+        return true;
+    }
+
+    // When other uploads are waiting, the streams take turns and the size
+    // of a turn is proportional to the stream's weight (5.3.2), the highest
+    // weight allowing 16 frames of the default size.
+    qint32 budget = std::numeric_limits<qint32>::max();
+    if (!suspendedStreams.empty())
+        budget = (qint32(stream.weight()) + 1) * (Http2::minPayloadLimit / 16);
+
+    auto slot = std::min<qint32>({sessionSendWindowSize, stream.sendWindow, budget});
     while (replyPrivate->totallyUploadedData < request.contentLength() && slot) {
         qint64 chunkSize = 0;
         const uchar *src =
@@ -548,10 +566,12 @@ bool QHttp2ProtocolHandler::sendDATA(Stream &stream)
         stream.data()->advanceReadPointer(bytesWritten);
         stream.sendWindow -= bytesWritten;
         sessionSendWindowSize -= bytesWritten;
+        budget -= bytesWritten;
+        stream.bytesSent += bytesWritten;
         replyPrivate->totallyUploadedData += bytesWritten;
         emit reply->dataSendProgress(replyPrivate->totallyUploadedData,
                                      request.contentLength());
-        slot = std::min(sessionSendWindowSize, stream.sendWindow);
+        slot = std::min({sessionSendWindowSize, stream.sendWindow, budget});
     }
 
     if (replyPrivate->totallyUploadedData == request.contentLength()) {
@@ -561,8 +581,14 @@ bool QHttp2ProtocolHandler::sendDATA(Stream &stream)
         stream.state = Stream::halfClosedLocal;
         stream.data()->disconnect(this);
         removeFromSuspended(stream.streamID);
+        // Streams depending on this one can now proceed:
+        if (!suspendedStreams.empty())
+            scheduleResumeSuspendedStreams();
     } else if (!stream.data()->atEnd()) {
         addToSuspended(stream);
+        // Our turn is over, but we are not blocked by flow control:
+        if (budget <= 0)
+            scheduleResumeSuspendedStreams();
     }
 
     return true;
@@ -577,6 +603,15 @@ bool QHttp2ProtocolHandler::sendWINDOW_UPDATE(quint32 streamID, quint32 delta)
     return frameWriter.write(*m_socket);
 }
 
+bool QHttp2ProtocolHandler::sendPING(quint64 payload)
+{
+    Q_ASSERT(m_socket);
+
+    frameWriter.start(FrameType::PING, FrameFlag::EMPTY, connectionStreamID);
+    frameWriter.append(payload);
+    return frameWriter.write(*m_socket);
+}
+
 bool QHttp2ProtocolHandler::sendRST_STREAM(quint32 streamID, quint32 errorCode)
 {
     Q_ASSERT(m_socket);
@@ -612,6 +647,9 @@ void QHttp2ProtocolHandler::handleDATA()
 
     sessionReceiveWindowSize -= inboundFrame.payloadSize();
 
+    if (windowAutoTuning)
+        sampleBandwidthDelayProduct(inboundFrame.payloadSize());
+
     if (activeStreams.contains(streamID)) {
         auto &stream = activeStreams[streamID];
 
@@ -623,17 +661,18 @@ void QHttp2ProtocolHandler::handleDATA()
             deleteActiveStream(streamID);
         } else {
             stream.recvWindow -= inboundFrame.payloadSize();
+            stream.bytesReceived += inboundFrame.payloadSize();
             // Uncompress data if needed and append it ...
             updateStream(stream, inboundFrame);
 
             if (inboundFrame.flags().testFlag(FrameFlag::END_STREAM)) {
                 finishStream(stream);
                 deleteActiveStream(stream.streamID);
-            } else if (stream.recvWindow < streamInitialReceiveWindowSize / 2) {
+            } else if (stream.recvWindow < streamReceiveWindowSize / 2) {
                 QMetaObject::invokeMethod(this, "sendWINDOW_UPDATE", Qt::QueuedConnection,
                                           Q_ARG(quint32, stream.streamID),
-                                          Q_ARG(quint32, streamInitialReceiveWindowSize - stream.recvWindow));
-                stream.recvWindow = streamInitialReceiveWindowSize;
+                                          Q_ARG(quint32, streamReceiveWindowSize - stream.recvWindow));
+                stream.recvWindow = streamReceiveWindowSize;
             }
         }
     }
@@ -697,10 +736,37 @@ void QHttp2ProtocolHandler::handlePRIORITY()
     const bool exclusive = streamDependency & 0x80000000;
     streamDependency &= ~0x80000000;
 
-    // Ignore this for now ...
-    // Can be used for streams (re)prioritization - 5.3
-    Q_UNUSED(exclusive);
-    Q_UNUSED(weight);
+    // 5.3: only affects how we schedule our uploads.
+    if (!activeStreams.contains(streamID) || streamDependency == streamID)
+        return;
+
+    if (exclusive) {
+        // 5.3.3: the stream becomes the sole dependency of its new parent.
+        for (auto &sibling : activeStreams) {
+            if (sibling.streamID != streamID && sibling.dependency == streamDependency)
+                sibling.dependency = streamID;
+        }
+    }
+
+    // 5.3.3: if the stream is made dependent on one of its own dependencies,
+    // that one first takes the place of the stream.
+    for (quint32 id = streamDependency; id != connectionStreamID;) {
+        const auto it = activeStreams.find(id);
+        if (it == activeStreams.end())
+            break;
+        if (it->dependency == streamID) {
+            it->dependency = activeStreams[streamID].dependency;
+            break;
+        }
+        id = it->dependency;
+    }
+
+    Stream &stream = activeStreams[streamID];
+    stream.dependency = streamDependency;
+    stream.peerWeight = weight;
+
+    if (!suspendedStreams.empty())
+        scheduleResumeSuspendedStreams();
 }
 
 void QHttp2ProtocolHandler::handleRST_STREAM()
@@ -757,6 +823,8 @@ void QHttp2ProtocolHandler::handleSETTINGS()
         return;
     }
 
+    sessionEstablished = true;
+
     if (inboundFrame.dataSize()) {
         auto src = inboundFrame.dataBegin();
         for (const uchar *end = src + inboundFrame.dataSize(); src != end; src += 6) {
@@ -832,11 +900,14 @@ void QHttp2ProtocolHandler::handlePING()
     if (inboundFrame.streamID() != connectionStreamID)
         return connectionError(PROTOCOL_ERROR, "PING on invalid stream");
 
-    if (inboundFrame.flags() & FrameFlag::ACK)
-        return connectionError(PROTOCOL_ERROR, "unexpected PING ACK");
-
     Q_ASSERT(inboundFrame.dataSize() == 8);
 
+    if (inboundFrame.flags() & FrameFlag::ACK) {
+        if (!bdpPingInFlight || qFromBigEndian<quint64>(inboundFrame.dataBegin()) != bdpPingPayload)
+            return connectionError(PROTOCOL_ERROR, "unexpected PING ACK");
+        return bandwidthDelayProductSampled();
+    }
+
     frameWriter.start(FrameType::PING, FrameFlag::ACK, connectionStreamID);
     frameWriter.append(inboundFrame.dataBegin(), inboundFrame.dataBegin() + 8);
     frameWriter.write(*m_socket);
@@ -943,7 +1014,7 @@ void QHttp2ProtocolHandler::handleWINDOW_UPDATE()
     // Since we're in _q_receiveReply at the moment, let's first handle other
     // frames and resume suspended streams (if any) == start sending our own frame
     // after handling these frames, since one them can be e.g. GOAWAY.
-    QMetaObject::invokeMethod(this, "resumeSuspendedStreams", Qt::QueuedConnection);
+    scheduleResumeSuspendedStreams();
 }
 
 void QHttp2ProtocolHandler::handleCONTINUATION()
@@ -1043,6 +1114,79 @@ void QHttp2ProtocolHandler::handleContinuedHEADERS()
     }
 }
 
+void QHttp2ProtocolHandler::sampleBandwidthDelayProduct(quint32 bytesReceived)
+{
+    Q_ASSERT(windowAutoTuning);
+
+    if (bdpPingInFlight) {
+        bdpSample += bytesReceived;
+        return;
+    }
+
+    // Start a new sample: count what arrives until our PING comes back.
+    if (!sendPING(++bdpPingPayload))
+        return;
+    bdpPingInFlight = true;
+    bdpSample = bytesReceived;
+    bdpPingTimer.start();
+}
+
+void QHttp2ProtocolHandler::bandwidthDelayProductSampled()
+{
+    bdpPingInFlight = false;
+
+    // This is the heuristic that gRPC uses: if a round trip's worth of data
+    // fills most of the window, the window is likely what limits us, and
+    // if the bandwidth is still growing, a window twice as large will help.
+    const qint64 roundTripTime = std::max<qint64>(bdpPingTimer.nsecsElapsed(), 1);
+    const double bandwidth = double(bdpSample) / double(roundTripTime);
+    const qint32 oldWindowSize = streamReceiveWindowSize;
+    if (bandwidth >= maxBandwidth) {
+        maxBandwidth = bandwidth;
+        if (bdpSample >= qint64(streamReceiveWindowSize) * 2 / 3)
+            growReceiveWindows(qint32(std::min<qint64>(2 * bdpSample, Http2::maxAutoTunedWindowSize)));
+    }
+
+    // Don't keep sending a PING every round trip for the lifetime of the
+    // connection: stop once the windows can't grow any more, or once they
+    // have stopped growing.
+    if (streamReceiveWindowSize > oldWindowSize)
+        bdpStalledSamples = 0;
+    else
+        ++bdpStalledSamples;
+
+    if (!canGrowReceiveWindows() || bdpStalledSamples >= maxStalledBdpSamples) {
+        qCDebug(QT_HTTP2) << "window auto-tuning done, stream receive window is"
+                          << streamReceiveWindowSize;
+        windowAutoTuning = false;
+    }
+}
+
+bool QHttp2ProtocolHandler::canGrowReceiveWindows() const
+{
+    return streamReceiveWindowSize < Http2::maxAutoTunedWindowSize
+           || maxSessionReceiveWindowSize < Http2::maxAutoTunedWindowSize;
+}
+
+void QHttp2ProtocolHandler::growReceiveWindows(qint32 windowSize)
+{
+    if (windowSize > streamReceiveWindowSize) {
+        qCDebug(QT_HTTP2) << "stream receive window grown to" << windowSize;
+        // Streams will get the difference with their next WINDOW_UPDATE:
+        streamReceiveWindowSize = windowSize;
+    }
+
+    if (windowSize > maxSessionReceiveWindowSize) {
+        qCDebug(QT_HTTP2) << "session receive window grown to" << windowSize;
+        const qint32 delta = windowSize - maxSessionReceiveWindowSize;
+        maxSessionReceiveWindowSize = windowSize;
+        sessionReceiveWindowSize += delta;
+        QMetaObject::invokeMethod(this, "sendWINDOW_UPDATE", Qt::QueuedConnection,
+                                  Q_ARG(quint32, connectionStreamID),
+                                  Q_ARG(quint32, delta));
+    }
+}
+
 bool QHttp2ProtocolHandler::acceptSetting(Http2::Settings identifier, quint32 newValue)
 {
     if (identifier == Settings::HEADER_TABLE_SIZE_ID) {
@@ -1083,7 +1227,7 @@ bool QHttp2ProtocolHandler::acceptSetting(Http2::Settings identifier, quint32 ne
             deleteActiveStream(id);
         }
 
-        QMetaObject::invokeMethod(this, "resumeSuspendedStreams", Qt::QueuedConnection);
+        scheduleResumeSuspendedStreams();
     }
 
     if (identifier == Settings::MAX_CONCURRENT_STREAMS_ID)
@@ -1294,6 +1438,7 @@ void QHttp2ProtocolHandler::finishStream(Stream &stream, Qt::ConnectionType conn
     Q_ASSERT(stream.state == Stream::remoteReserved || stream.reply());
 
     stream.state = Stream::closed;
+    sessionEstablished = true;
     auto httpReply = stream.reply();
     if (httpReply) {
         httpReply->disconnect(this);
@@ -1308,7 +1453,9 @@ void QHttp2ProtocolHandler::finishStream(Stream &stream, Qt::ConnectionType conn
         }
     }
 
-    qCDebug(QT_HTTP2) << "stream" << stream.streamID << "closed";
+    qCDebug(QT_HTTP2) << "stream" << stream.streamID << "closed, sent" << stream.bytesSent
+                      << "and received" << stream.bytesReceived << "bytes in"
+                      << stream.timer.elapsed() << "ms";
 }
 
 void QHttp2ProtocolHandler::finishStreamWithError(Stream &stream, quint32 errorCode)
@@ -1351,6 +1498,10 @@ quint32 QHttp2ProtocolHandler::createNewStream(const HttpMessagePair &message, b
     replyPrivate->connection = m_connection;
     replyPrivate->connectionChannel = m_channel;
     reply->setHttp2WasUsed(true);
+    // Requests sent together with the client preface, including the one
+    // that performed a protocol upgrade, are the ones that opened the
+    // connection, however many streams they use.
+    replyPrivate->connectionReused = sessionEstablished;
     streamIDs.insert(reply, newStreamID);
     connect(reply, SIGNAL(destroyed(QObject*)),
             this, SLOT(_q_replyDestroyed(QObject*)));
@@ -1378,11 +1529,13 @@ quint32 QHttp2ProtocolHandler::createNewStream(const HttpMessagePair &message, b
 
 void QHttp2ProtocolHandler::addToSuspended(Stream &stream)
 {
-    qCDebug(QT_HTTP2) << "stream" << stream.streamID
-                      << "suspended by flow control";
-    const auto priority = stream.priority();
-    Q_ASSERT(int(priority) >= 0 && int(priority) < 3);
-    suspendedStreams[priority].push_back(stream.streamID);
+    if (std::find(suspendedStreams.begin(), suspendedStreams.end(), stream.streamID)
+        != suspendedStreams.end()) {
+        return;
+    }
+
+    qCDebug(QT_HTTP2) << "stream" << stream.streamID << "suspended";
+    suspendedStreams.push_back(stream.streamID);
 }
 
 void QHttp2ProtocolHandler::markAsReset(quint32 streamID)
@@ -1409,37 +1562,45 @@ void QHttp2ProtocolHandler::markAsReset(quint32 streamID)
 
 quint32 QHttp2ProtocolHandler::popStreamToResume()
 {
-    quint32 streamID = connectionStreamID;
-    using QNR = QHttpNetworkRequest;
-    const QNR::Priority ranks[] = {QNR::HighPriority,
-                                   QNR::NormalPriority,
-                                   QNR::LowPriority};
-
-    for (const QNR::Priority rank : ranks) {
-        auto &queue = suspendedStreams[rank];
-        auto it = queue.begin();
-        for (; it != queue.end(); ++it) {
-            if (!activeStreams.contains(*it))
-                continue;
-            if (activeStreams[*it].sendWindow > 0)
-                break;
+    // The first stream in line that has a window and does not
+    // depend on another stream that can send:
+    for (auto it = suspendedStreams.begin(); it != suspendedStreams.end(); ++it) {
+        const auto streamIt = activeStreams.constFind(*it);
+        if (streamIt == activeStreams.cend())
+            continue;
+        if (streamIt->sendWindow > 0 && !isBlockedByDependency(*streamIt)) {
+            const quint32 streamID = *it;
+            suspendedStreams.erase(it);
+            return streamID;
         }
+    }
 
-        if (it != queue.end()) {
-            streamID = *it;
-            queue.erase(it);
-            break;
+    return connectionStreamID;
+}
+
+bool QHttp2ProtocolHandler::isBlockedByDependency(const Stream &stream) const
+{
+    // 5.3.1: a stream only gets resources if none of the streams it
+    // depends on can use them. The depth check protects us from a cycle.
+    quint32 id = stream.dependency;
+    for (qsizetype depth = 0; id != connectionStreamID && depth < activeStreams.size(); ++depth) {
+        const auto it = activeStreams.constFind(id);
+        if (it == activeStreams.cend())
+            return false;
+        if (it->sendWindow > 0
+            && std::find(suspendedStreams.begin(), suspendedStreams.end(), id) != suspendedStreams.end()) {
+            return true;
         }
+        id = it->dependency;
     }
 
-    return streamID;
+    return false;
 }
 
 void QHttp2ProtocolHandler::removeFromSuspended(quint32 streamID)
 {
-    for (auto &q : suspendedStreams) {
-        q.erase(std::remove(q.begin(), q.end(), streamID), q.end());
-    }
+    suspendedStreams.erase(std::remove(suspendedStreams.begin(), suspendedStreams.end(), streamID),
+                           suspendedStreams.end());
 }
 
 void QHttp2ProtocolHandler::deleteActiveStream(quint32 streamID)
@@ -1458,6 +1619,9 @@ void QHttp2ProtocolHandler::deleteActiveStream(quint32 streamID)
     }
 
     removeFromSuspended(streamID);
+    // Streams that depended on this one may be able to proceed now:
+    if (!suspendedStreams.empty())
+        scheduleResumeSuspendedStreams();
     if (m_channel->h2RequestsToSend.size())
         QMetaObject::invokeMethod(this, "sendRequest", Qt::QueuedConnection);
 }
@@ -1470,8 +1634,19 @@ bool QHttp2ProtocolHandler::streamWasReset(quint32 streamID) const
     return it != recycledStreams.end() && *it == streamID;
 }
 
+void QHttp2ProtocolHandler::scheduleResumeSuspendedStreams()
+{
+    if (resumePending)
+        return;
+    resumePending = true;
+    QMetaObject::invokeMethod(this, "resumeSuspendedStreams", Qt::QueuedConnection);
+}
+
 void QHttp2ProtocolHandler::resumeSuspendedStreams()
 {
+    // Cleared first, so that streams suspended again below get another turn.
+    resumePending = false;
+
     while (sessionSendWindowSize > 0) {
         const auto streamID = popStreamToResume();
         if (!streamID)
@@ -1637,8 +1812,7 @@ void QHttp2ProtocolHandler::connectionError(Http2::Http2Error errorCode,
 void QHttp2ProtocolHandler::closeSession()
 {
     activeStreams.clear();
-    for (auto &q: suspendedStreams)
-        q.clear();
+    suspendedStreams.clear();
     recycledStreams.clear();
 
     m_channel->close();
@@ -65,6 +65,7 @@
 
 #include <QtCore/qnamespace.h>
 #include <QtCore/qbytearray.h>
+#include <QtCore/qelapsedtimer.h>
 #include <QtCore/qglobal.h>
 #include <QtCore/qobject.h>
 #include <QtCore/qflags.h>
@@ -112,6 +113,7 @@ private:
     bool sendHEADERS(Stream &stream);
     bool sendDATA(Stream &stream);
     Q_INVOKABLE bool sendWINDOW_UPDATE(quint32 streamID, quint32 delta);
+    bool sendPING(quint64 payload);
     bool sendRST_STREAM(quint32 streamID, quint32 errorCoder);
     bool sendGOAWAY(quint32 errorCode);
 
@@ -130,6 +132,12 @@ private:
 
     bool acceptSetting(Http2::Settings identifier, quint32 newValue);
 
+    // Receive window auto-tuning:
+    void sampleBandwidthDelayProduct(quint32 bytesReceived);
+    void bandwidthDelayProductSampled();
+    void growReceiveWindows(qint32 windowSize);
+    bool canGrowReceiveWindows() const;
+
     void updateStream(Stream &stream, const HPack::HttpHeader &headers,
                       Qt::ConnectionType connectionType = Qt::DirectConnection);
     void updateStream(Stream &stream, const Http2::Frame &dataFrame,
@@ -146,6 +154,7 @@ private:
     void addToSuspended(Stream &stream);
     void markAsReset(quint32 streamID);
     quint32 popStreamToResume();
+    bool isBlockedByDependency(const Stream &stream) const;
     void removeFromSuspended(quint32 streamID);
     void deleteActiveStream(quint32 streamID);
     bool streamWasReset(quint32 streamID) const;
@@ -155,6 +164,9 @@ private:
     // SETTINGS only once, immediately after
     // the client's preface 24-byte message.
     bool waitingForSettingsACK = false;
+    // Set once the server's SETTINGS frame has arrived or a request has been
+    // answered; streams created from then on report a reused connection.
+    bool sessionEstablished = false;
 
     static const quint32 maxAcceptableTableSize = 16 * HPack::FieldLookupTable::DefaultSize;
     // HTTP/2 4.3: Header compression is stateful. One compression context and
@@ -164,7 +176,9 @@ private:
 
     QHash<QObject *, int> streamIDs;
     QHash<quint32, Stream> activeStreams;
-    std::deque<quint32> suspendedStreams[3]; // 3 for priorities: High, Normal, Low.
+    // Streams with more data to upload, they take turns sending DATA
+    // frames in proportion to their weights:
+    std::deque<quint32> suspendedStreams;
     static const std::deque<quint32>::size_type maxRecycledStreams;
     std::deque<quint32> recycledStreams;
 
@@ -190,8 +204,8 @@ private:
     // sending requests and creating streams while maxConcurrentStreams allows).
 
     // This is our (client-side) maximum possible receive window size, we set
-    // it in a ctor from QHttp2Configuration, it does not change after that.
-    // The default is 64Kb:
+    // it in a ctor from QHttp2Configuration, only window auto-tuning changes
+    // it after that. The default is 64Kb:
     qint32 maxSessionReceiveWindowSize = Http2::defaultSessionWindowSize;
 
     // Our session current receive window size, updated in a ctor from
@@ -201,6 +215,23 @@ private:
     // Our per-stream receive window size, default is 64 Kb, will be updated
     // from QHttp2Configuration. Again, signed - can become negative.
     qint32 streamInitialReceiveWindowSize = Http2::defaultSessionWindowSize;
+    // The size we restore stream receive windows to with WINDOW_UPDATE,
+    // the same as the initial size unless auto-tuning has grown it:
+    qint32 streamReceiveWindowSize = Http2::defaultSessionWindowSize;
+
+    // Window auto-tuning: we measure how many bytes arrive in one round
+    // trip (the time it takes our PING to be ACKed) and grow the receive
+    // windows when they are too small for this bandwidth-delay product.
+    bool windowAutoTuning = false;
+    bool bdpPingInFlight = false;
+    quint64 bdpPingPayload = 0;
+    QElapsedTimer bdpPingTimer;
+    qint64 bdpSample = 0;
+    double maxBandwidth = 0; // bytes per nanosecond
+    // Samples in a row that did not grow the windows; after this many,
+    // auto-tuning stops:
+    int bdpStalledSamples = 0;
+    static const int maxStalledBdpSamples = 8;
 
     // These are our peer's receive window sizes, they will be updated by the
     // peer's SETTINGS and WINDOW_UPDATE frames, defaults presumed to be 64Kb.
@@ -214,6 +245,10 @@ private:
     // the headers size), we never enforce it, it's just a hint to our peer.
 
     Q_INVOKABLE void resumeSuspendedStreams();
+    // Queues one call to resumeSuspendedStreams(), however often this is
+    // called before it runs.
+    void scheduleResumeSuspendedStreams();
+    bool resumePending = false;
     // Our stream IDs (all odd), the first valid will be 1.
     quint32 nextID = 1;
     quint32 allocateStreamID();
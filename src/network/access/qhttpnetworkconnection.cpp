@@ -74,6 +74,9 @@ const int QHttpNetworkConnectionPrivate::defaultPipelineLength = 3;
 // This means that there are 2 requests in flight and 2 slots free that will be re-filled.
 const int QHttpNetworkConnectionPrivate::defaultRePipelineLength = 2;
 
+// Matches the expiry time of QNetworkAccessCache, which keeps idle connections.
+const int QHttpNetworkConnectionPrivate::defaultIdleTimeout = 120;
+
 
 QHttpNetworkConnectionPrivate::QHttpNetworkConnectionPrivate(const QString &hostName,
                                                              quint16 port, bool encrypt,
@@ -102,14 +105,20 @@ QHttpNetworkConnectionPrivate::QHttpNetworkConnectionPrivate(quint16 connectionC
                                                              quint16 port, bool encrypt,
                                                              QHttpNetworkConnection::ConnectionType type)
 : state(RunningState), networkLayerState(Unknown),
-  hostName(hostName), port(port), encrypt(encrypt), delayIpv4(true),
-  activeChannelCount(connectionCount), channelCount(connectionCount)
+  hostName(hostName), port(port), encrypt(encrypt), delayIpv4(true)
+  , activeChannelCount(type == QHttpNetworkConnection::ConnectionTypeHTTP2
+                       || type == QHttpNetworkConnection::ConnectionTypeHTTP2Direct
+                       ? 1 : connectionCount)
+  , channelCount(connectionCount)
 #ifndef QT_NO_NETWORKPROXY
   , networkProxy(QNetworkProxy::NoProxy)
 #endif
   , preConnectRequests(0)
   , connectionType(type)
 {
+    // As above, all channels are allocated so that a failed HTTP/2
+    // negotiation can fall back to HTTP/1.1 with connectionCount channels.
+    Q_ASSERT(channelCount >= activeChannelCount);
     channels = new QHttpNetworkConnectionChannel[channelCount];
 }
 
@@ -771,7 +780,12 @@ void QHttpNetworkConnectionPrivate::fillPipeline(QAbstractSocket *socket)
     if (channels[i].reply == nullptr)
         return;
 
-    if (! (defaultPipelineLength - channels[i].alreadyPipelinedRequests.length() >= defaultRePipelineLength)) {
+    const int pipelineLength = int(http1Parameters.pipeliningDepth());
+    if (!pipelineLength)
+        return;
+    // Only re-fill the pipeline if enough slots are free, see defaultRePipelineLength:
+    const int rePipelineLength = qMin(pipelineLength, defaultRePipelineLength);
+    if (! (pipelineLength - channels[i].alreadyPipelinedRequests.length() >= rePipelineLength)) {
         return;
     }
 
@@ -815,7 +829,7 @@ void QHttpNetworkConnectionPrivate::fillPipeline(QAbstractSocket *socket)
         lengthBefore = channels[i].alreadyPipelinedRequests.length();
         fillPipeline(highPriorityQueue, channels[i]);
 
-        if (channels[i].alreadyPipelinedRequests.length() >= defaultPipelineLength) {
+        if (channels[i].alreadyPipelinedRequests.length() >= pipelineLength) {
             channels[i].pipelineFlush();
             return;
         }
@@ -828,7 +842,7 @@ void QHttpNetworkConnectionPrivate::fillPipeline(QAbstractSocket *socket)
         lengthBefore = channels[i].alreadyPipelinedRequests.length();
         fillPipeline(lowPriorityQueue, channels[i]);
 
-        if (channels[i].alreadyPipelinedRequests.length() >= defaultPipelineLength) {
+        if (channels[i].alreadyPipelinedRequests.length() >= pipelineLength) {
             channels[i].pipelineFlush();
             return;
         }
@@ -1443,6 +1457,18 @@ void QHttpNetworkConnection::setConnectionType(ConnectionType type)
     d->connectionType = type;
 }
 
+QHttp1Configuration QHttpNetworkConnection::http1Parameters() const
+{
+    Q_D(const QHttpNetworkConnection);
+    return d->http1Parameters;
+}
+
+void QHttpNetworkConnection::setHttp1Parameters(const QHttp1Configuration &params)
+{
+    Q_D(QHttpNetworkConnection);
+    d->http1Parameters = params;
+}
+
 QHttp2Configuration QHttpNetworkConnection::http2Parameters() const
 {
     Q_D(const QHttpNetworkConnection);
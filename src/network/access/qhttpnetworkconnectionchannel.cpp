@@ -762,6 +762,8 @@ void QHttpNetworkConnectionChannel::pipelineInto(HttpMessagePair &pair)
     reply->d_func()->connectionChannel = this;
     reply->d_func()->autoDecompress = request.d->autoDecompress;
     reply->d_func()->pipeliningUsed = true;
+    reply->d_func()->connectionReused = true;
+    ++requestsOnSocket;
 
 #ifndef QT_NO_NETWORKPROXY
     pipeline.append(QHttpNetworkRequestPrivate::header(request,
@@ -914,9 +916,11 @@ void QHttpNetworkConnectionChannel::_q_connected()
     // the requests into one TCP packet.
 
     // not sure yet if it helps, but it makes sense
-    socket->setSocketOption(QAbstractSocket::KeepAliveOption, 1);
+    if (connection->d_func()->http1Parameters.keepAliveProbesEnabled())
+        socket->setSocketOption(QAbstractSocket::KeepAliveOption, 1);
 
     pipeliningSupported = QHttpNetworkConnectionChannel::PipeliningSupportUnknown;
+    requestsOnSocket = 0;
 
     if (QNetworkConnectionMonitor::isEnabled()) {
         auto connectionPrivate = connection->d_func();
@@ -116,6 +116,7 @@ public:
     int lastStatus; // last status received on this channel
     bool pendingEncrypt; // for https (send after encrypted)
     int reconnectAttempts; // maximum 2 reconnection attempts
+    int requestsOnSocket = 0; // requests sent since the socket connected
     QAuthenticator authenticator;
     QAuthenticator proxyAuthenticator;
     bool authenticationCredentialsSent;
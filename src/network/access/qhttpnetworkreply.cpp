@@ -307,6 +307,11 @@ bool QHttpNetworkReply::isPipeliningUsed() const
     return d_func()->pipeliningUsed;
 }
 
+bool QHttpNetworkReply::isConnectionReused() const
+{
+    return d_func()->connectionReused;
+}
+
 bool QHttpNetworkReply::isHttp2Used() const
 {
     return d_func()->h2Used;
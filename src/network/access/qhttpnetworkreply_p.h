@@ -146,6 +146,7 @@ public:
     bool isFinished() const;
 
     bool isPipeliningUsed() const;
+    bool isConnectionReused() const;
     bool isHttp2Used() const;
     void setHttp2WasUsed(bool h2Used);
     qint64 removedContentLength() const;
@@ -272,6 +273,7 @@ public:
     bool requestIsPrepared;
 
     bool pipeliningUsed;
+    bool connectionReused = false;
     bool h2Used;
     bool downstreamLimited;
 
@@ -279,6 +279,7 @@ bool QHttpProtocolHandler::sendRequest()
             m_reply->d_func()->state = QHttpNetworkReplyPrivate::AllDoneState;
             m_channel->allDone();
             m_connection->preConnectFinished(); // will only decrease the counter
+            ++m_channel->requestsOnSocket; // the next request reuses this connection
             m_reply = nullptr; // so we can reuse this channel
             return true; // we have a working connection and are done
         }
@@ -292,6 +293,7 @@ bool QHttpProtocolHandler::sendRequest()
         replyPrivate->connectionChannel = m_channel;
         replyPrivate->autoDecompress = m_channel->request.d->autoDecompress;
         replyPrivate->pipeliningUsed = false;
+        replyPrivate->connectionReused = m_channel->requestsOnSocket++ > 0;
 
         // if the url contains authentication parameters, use the new ones
         // both channels will use the new authentication parameters
@@ -181,9 +181,10 @@ class QNetworkAccessCachedHttpConnection: public QHttpNetworkConnection,
 {
     // Q_OBJECT
 public:
-    QNetworkAccessCachedHttpConnection(const QString &hostName, quint16 port, bool encrypt,
+    QNetworkAccessCachedHttpConnection(quint16 connectionCount, const QString &hostName, quint16 port,
+                                       bool encrypt,
                                        QHttpNetworkConnection::ConnectionType connectionType)
-        : QHttpNetworkConnection(hostName, port, encrypt, connectionType)
+        : QHttpNetworkConnection(connectionCount, hostName, port, encrypt, nullptr, connectionType)
     {
         setExpires(true);
         setShareable(true);
@@ -229,6 +230,7 @@ QHttpThreadDelegate::QHttpThreadDelegate(QObject *parent) :
     , connectionCacheExpiryTimeoutSeconds(-1)
     , incomingStatusCode(0)
     , isPipeliningUsed(false)
+    , isConnectionReused(false)
     , isHttp2Used(false)
     , incomingContentLength(-1)
     , removedContentLength(-1)
@@ -333,8 +335,10 @@ void QHttpThreadDelegate::startRequest()
     if (!httpConnection) {
         // no entry in cache; create an object
         // the http object is actually a QHttpNetworkConnection
-        httpConnection = new QNetworkAccessCachedHttpConnection(urlCopy.host(), urlCopy.port(), ssl,
+        httpConnection = new QNetworkAccessCachedHttpConnection(http1Parameters.numberOfConnectionsPerHost(),
+                                                                urlCopy.host(), urlCopy.port(), ssl,
                                                                 connectionType);
+        httpConnection->setHttp1Parameters(http1Parameters);
         if (connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2
             || connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2Direct) {
             httpConnection->setHttp2Parameters(http2Parameters);
@@ -641,6 +645,7 @@ void QHttpThreadDelegate::headerChangedSlot()
     incomingStatusCode = httpReply->statusCode();
     incomingReasonPhrase = httpReply->reasonPhrase();
     isPipeliningUsed = httpReply->isPipeliningUsed();
+    isConnectionReused = httpReply->isConnectionReused();
     incomingContentLength = httpReply->contentLength();
     removedContentLength = httpReply->removedContentLength();
     isHttp2Used = httpReply->isHttp2Used();
@@ -654,7 +659,8 @@ void QHttpThreadDelegate::headerChangedSlot()
                           incomingContentLength,
                           removedContentLength,
                           isHttp2Used,
-                          isCompressed);
+                          isCompressed,
+                          isConnectionReused);
 }
 
 void QHttpThreadDelegate::synchronousHeaderChangedSlot()
@@ -670,6 +676,7 @@ void QHttpThreadDelegate::synchronousHeaderChangedSlot()
     incomingStatusCode = httpReply->statusCode();
     incomingReasonPhrase = httpReply->reasonPhrase();
     isPipeliningUsed = httpReply->isPipeliningUsed();
+    isConnectionReused = httpReply->isConnectionReused();
     isHttp2Used = httpReply->isHttp2Used();
     incomingContentLength = httpReply->contentLength();
 }
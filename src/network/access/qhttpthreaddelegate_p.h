@@ -62,6 +62,7 @@
 #include <QNetworkReply>
 #include "qhttpnetworkrequest_p.h"
 #include "qhttpnetworkconnection_p.h"
+#include "qhttp1configuration.h"
 #include "qhttp2configuration.h"
 #include <QSharedPointer>
 #include <QScopedPointer>
@@ -113,11 +114,13 @@ public:
     int incomingStatusCode;
     QString incomingReasonPhrase;
     bool isPipeliningUsed;
+    bool isConnectionReused;
     bool isHttp2Used;
     qint64 incomingContentLength;
     qint64 removedContentLength;
     QNetworkReply::NetworkError incomingErrorCode;
     QString incomingErrorDetail;
+    QHttp1Configuration http1Parameters;
     QHttp2Configuration http2Parameters;
 
     bool isCompressed;
@@ -147,7 +150,7 @@ signals:
     void socketConnecting();
     void requestSent();
     void downloadMetaData(const QList<QPair<QByteArray,QByteArray> > &, int, const QString &, bool,
-                          QSharedPointer<char>, qint64, qint64, bool, bool);
+                          QSharedPointer<char>, qint64, qint64, bool, bool, bool);
     void downloadProgress(qint64, qint64);
     void downloadData(const QByteArray &);
     void error(QNetworkReply::NetworkError, const QString &);
@@ -1431,6 +1431,51 @@ void QNetworkAccessManager::setTransferTimeout(int timeout)
     d_func()->transferTimeout = timeout;
 }
 
+#if QT_CONFIG(http)
+/*!
+    \since 6.3
+
+    Returns the HTTP/1.1 connection pool configuration used for the host
+    \a hostName. If setHttp1Configuration() was not called for this host, a
+    default-constructed QHttp1Configuration is returned.
+
+    \sa setHttp1Configuration()
+*/
+QHttp1Configuration QNetworkAccessManager::http1Configuration(const QString &hostName) const
+{
+    return d_func()->http1Configurations.value(hostName.toLower(), QHttp1Configuration());
+}
+
+/*!
+    \since 6.3
+
+    Sets the HTTP/1.1 connection pool \a configuration used for requests to
+    the host \a hostName, for example to allow more parallel connections to
+    a single backend than the default of six.
+
+    The configuration applies to connections that are opened after this call;
+    connections that are already open keep their configuration until they
+    are closed. The idle timeout of the configuration is overridden by the
+    QNetworkRequest::ConnectionCacheExpiryTimeoutSecondsAttribute of a request,
+    if set.
+
+    Whether a reply was received over a connection that had already served
+    another request is reported by
+    QNetworkRequest::ConnectionReusedAttribute.
+
+    \sa http1Configuration(), QHttp1Configuration
+*/
+void QNetworkAccessManager::setHttp1Configuration(const QString &hostName,
+                                                  const QHttp1Configuration &configuration)
+{
+    Q_D(QNetworkAccessManager);
+    if (configuration == QHttp1Configuration())
+        d->http1Configurations.remove(hostName.toLower());
+    else
+        d->http1Configurations.insert(hostName.toLower(), configuration);
+}
+#endif // QT_CONFIG(http)
+
 void QNetworkAccessManagerPrivate::_q_replyFinished(QNetworkReply *reply)
 {
     Q_Q(QNetworkAccessManager);
@@ -65,6 +65,7 @@ class QNetworkProxyFactory;
 class QSslError;
 class QHstsPolicy;
 class QHttpMultiPart;
+class QHttp1Configuration;
 
 class QNetworkReplyImplPrivate;
 class QNetworkAccessManagerPrivate;
@@ -148,6 +149,11 @@ public:
     int transferTimeout() const;
     void setTransferTimeout(int timeout = QNetworkRequest::DefaultTransferTimeoutConstant);
 
+#if QT_CONFIG(http)
+    QHttp1Configuration http1Configuration(const QString &hostName) const;
+    void setHttp1Configuration(const QString &hostName, const QHttp1Configuration &configuration);
+#endif
+
 Q_SIGNALS:
 #ifndef QT_NO_NETWORKPROXY
     void proxyAuthenticationRequired(const QNetworkProxy &proxy, QAuthenticator *authenticator);
@@ -61,6 +61,9 @@
 #include "private/qobject_p.h"
 #include "QtNetwork/qnetworkproxy.h"
 #include "qnetworkaccessauthenticationmanager_p.h"
+#if QT_CONFIG(http)
+#include "qhttp1configuration.h"
+#endif
 
 #if QT_CONFIG(settings)
 #include "qhstsstore_p.h"
@@ -169,6 +172,11 @@ public:
 
     int transferTimeout = 0;
 
+#if QT_CONFIG(http)
+    // Connection pool parameters, by (lower case) host name:
+    QHash<QString, QHttp1Configuration> http1Configurations;
+#endif
+
     Q_DECLARE_PUBLIC(QNetworkAccessManager)
 };
 
@@ -52,15 +52,20 @@
 #include <qurl.h>
 #include <qcryptographichash.h>
 #include <qdebug.h>
+#include <qendian.h>
+#include <qsavefile.h>
 
+#include <algorithm>
 #include <memory>
 
 #define CACHE_POSTFIX QLatin1String(".d")
 #define PREPARED_SLASH QLatin1String("prepared/")
 #define CACHE_VERSION 8
 #define DATA_DIR QLatin1String("data")
+#define INDEX_FILE QLatin1String(".index")
 
 #define MAX_COMPRESSION_SIZE (1024 * 1024 * 3)
+#define MAX_SYNCHRONOUS_REMOVALS 64
 
 QT_BEGIN_NAMESPACE
 
@@ -76,6 +81,11 @@ QT_BEGIN_NAMESPACE
     are compressed using qCompress.  Data is written to disk only in insert()
     and updateMetaData().
 
+    An index of the cached files, their sizes and the order in which they
+    were stored is kept in a journal file inside of the cacheDirectory, so
+    that expire() does not have to scan the whole directory. Large numbers
+    of expired files are removed in a background thread.
+
     Currently you cannot share the same cache files with more than
     one disk cache.
 
@@ -152,6 +162,7 @@ void QNetworkDiskCache::setCacheDirectory(const QString &cacheDir)
 
     d->dataDirectory = d->cacheDirectory + DATA_DIR + QString::number(CACHE_VERSION) + QLatin1Char('/');
     d->prepareLayout();
+    d->loadIndex();
 }
 
 /*!
@@ -263,6 +274,185 @@ void QNetworkDiskCachePrivate::prepareLayout()
     }
 }
 
+/*!
+    Loads the index of the cache files from the journal in the data
+    directory, rebuilding it from the directory contents if it is missing
+    or unreadable. Left-over temporary files of insertions that never
+    finished are removed.
+
+    The journal can miss files when the application crashed between
+    storing a file and recording it, or when writing the journal failed.
+    Such a journal is not marked as closed cleanly, and the index is then
+    reconciled with the files that are actually in the data directory, so
+    that every file is counted and can be expired. The journal of a cache
+    that was shut down in an orderly way is trusted as is, which avoids
+    walking the whole data directory on every start.
+*/
+void QNetworkDiskCachePrivate::loadIndex()
+{
+    lastItem.reset();
+    bool clean = false;
+    if (!index.load(dataDirectory + INDEX_FILE, &clean)) {
+        index.reset(scanDataDirectory());
+    } else if (!clean) {
+        const QList<std::pair<quint64, qint64>> files = scanDataDirectory();
+        QSet<quint64> found;
+        found.reserve(files.size());
+        for (const auto &[key, size] : files) {
+            found.insert(key);
+            if (index.size(key) != size)
+                index.insert(key, size);
+        }
+        const QList<quint64> keys = index.keys();
+        for (quint64 key : keys) {
+            if (!found.contains(key))
+                index.remove(key);
+        }
+    }
+    currentCacheSize = index.totalSize();
+
+    QDirIterator it(cacheDirectory + PREPARED_SLASH, QDir::Files);
+    while (it.hasNext()) {
+        const QString path = it.next();
+        if (!path.endsWith(CACHE_POSTFIX))
+            continue;
+        const bool inProgress = std::any_of(inserting.cbegin(), inserting.cend(),
+                                            [&path](const QCacheItem *item) {
+            return item && item->file && item->file->fileName() == path;
+        });
+        if (!inProgress)
+            QFile::remove(path);
+    }
+}
+
+/*!
+    Scans the data directory and returns the key and size of every cache
+    file, oldest first, using the file creation date to determine how old a
+    cache file is.
+*/
+QList<std::pair<quint64, qint64>> QNetworkDiskCachePrivate::scanDataDirectory() const
+{
+    struct ScannedFile {
+        QDateTime time;
+        quint64 key;
+        qint64 size;
+    };
+    QList<ScannedFile> files;
+    QDirIterator it(dataDirectory, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QFileInfo info = it.nextFileInfo();
+        const quint64 key = indexKey(info.filePath());
+        if (!key)
+            continue;
+        const QDateTime birthTime = info.fileTime(QFile::FileBirthTime);
+        files.append({ birthTime.isValid() ? birthTime
+                                           : info.fileTime(QFile::FileMetadataChangeTime),
+                       key, info.size() });
+    }
+    std::stable_sort(files.begin(), files.end(),
+                     [](const ScannedFile &lhs, const ScannedFile &rhs) {
+        return lhs.time < rhs.time;
+    });
+
+    QList<std::pair<quint64, qint64>> entries;
+    entries.reserve(files.size());
+    for (const ScannedFile &file : qAsConst(files))
+        entries.append({ file.key, file.size });
+    return entries;
+}
+
+/*!
+    Returns the key under which the cache file \a fileName is recorded in
+    the index, or 0 if \a fileName is not a file in the data directory.
+    The key packs the up to eight characters of the base name generated by
+    uniqueFileName(), from which the full path can be recomputed.
+*/
+quint64 QNetworkDiskCachePrivate::indexKey(const QString &fileName) const
+{
+    if (dataDirectory.isEmpty() || !fileName.startsWith(dataDirectory)
+        || !fileName.endsWith(CACHE_POSTFIX)) {
+        return 0;
+    }
+    const qsizetype slash = fileName.lastIndexOf(QLatin1Char('/'));
+    const QStringView id = QStringView(fileName).mid(slash + 1).chopped(CACHE_POSTFIX.size());
+    if (id.isEmpty() || id.size() > 8)
+        return 0;
+    quint64 key = 0;
+    for (qsizetype i = 0; i < id.size(); ++i) {
+        const char16_t c = id.at(i).unicode();
+        if (c == 0 || c > 0x7f)
+            return 0;
+        key |= quint64(c) << (8 * i);
+    }
+    if (fileName != fileNameForKey(key))
+        return 0;
+    return key;
+}
+
+/*!
+    Returns the fully qualified path of the cache file recorded under \a key.
+*/
+QString QNetworkDiskCachePrivate::fileNameForKey(quint64 key) const
+{
+    char id[8];
+    int length = 0;
+    while (length < 8 && (key & 0xff)) {
+        id[length++] = char(key & 0xff);
+        key >>= 8;
+    }
+    if (!length)
+        return QString();
+    // must match the layout generated by uniqueFileName()
+    const uint code = uint(id[length - 1]) % 16;
+    return dataDirectory + QString::number(code, 16) + QLatin1Char('/')
+           + QLatin1String(id, length) + CACHE_POSTFIX;
+}
+
+/*!
+    Removes the cache \a files, which must already be dropped from the index.
+
+    Large batches, as produced by expire() on a big cache, are handed to a
+    background thread so that the caller is not blocked by the file system.
+    Until a file is actually removed it is reported as missing by data() and
+    metaData(), and storing a new file under the same name cancels its
+    removal.
+*/
+void QNetworkDiskCachePrivate::removeFiles(const QStringList &files)
+{
+#if QT_CONFIG(thread)
+    if (files.size() > MAX_SYNCHRONOUS_REMOVALS) {
+        {
+            QMutexLocker locker(&removalMutex);
+            for (const QString &file : files)
+                pendingRemovals.insert(file);
+        }
+        removalPool.start([this, files] {
+            for (const QString &file : files) {
+                QMutexLocker locker(&removalMutex);
+                if (pendingRemovals.remove(file))
+                    QFile::remove(file);
+            }
+        });
+        return;
+    }
+#endif
+    for (const QString &file : files)
+        QFile::remove(file);
+}
+
+bool QNetworkDiskCachePrivate::isRemovalPending(const QString &file)
+{
+    QMutexLocker locker(&removalMutex);
+    return pendingRemovals.contains(file);
+}
+
+void QNetworkDiskCachePrivate::cancelRemoval(const QString &file)
+{
+    QMutexLocker locker(&removalMutex);
+    if (pendingRemovals.remove(file))
+        QFile::remove(file);
+}
+
 
 void QNetworkDiskCachePrivate::storeItem(QCacheItem *cacheItem)
 {
@@ -272,6 +462,7 @@ void QNetworkDiskCachePrivate::storeItem(QCacheItem *cacheItem)
     QString fileName = cacheFileName(cacheItem->metaData.url());
     Q_ASSERT(!fileName.isEmpty());
 
+    cancelRemoval(fileName);
     if (QFile::exists(fileName)) {
         if (!removeFile(fileName)) {
             qWarning() << "QNetworkDiskCache: couldn't remove the cache file " << fileName;
@@ -294,10 +485,14 @@ void QNetworkDiskCachePrivate::storeItem(QCacheItem *cacheItem)
         && cacheItem->file->error() == QFile::NoError) {
         cacheItem->file->setAutoRemove(false);
         // ### use atomic rename rather then remove & rename
-        if (cacheItem->file->rename(fileName))
-            currentCacheSize += cacheItem->file->size();
-        else
+        if (cacheItem->file->rename(fileName)) {
+            const qint64 size = cacheItem->file->size();
+            currentCacheSize += size;
+            if (const quint64 key = indexKey(fileName))
+                index.insert(key, size);
+        } else {
             cacheItem->file->setAutoRemove(true);
+        }
     }
     if (cacheItem->metaData.url() == lastItem.metaData.url())
         lastItem.reset();
@@ -343,10 +538,16 @@ bool QNetworkDiskCachePrivate::removeFile(const QString &file)
     if (!fileName.endsWith(CACHE_POSTFIX))
         return false;
     qint64 size = info.size();
+    const quint64 key = indexKey(file);
     if (QFile::remove(file)) {
-        currentCacheSize -= size;
+        // a file whose removal is pending has already left the index, and
+        // its size was already subtracted by expire()
+        if (!key || index.remove(key))
+            currentCacheSize -= size;
         return true;
     }
+    if (!info.exists() && key)
+        index.remove(key);
     return false;
 }
 
@@ -361,7 +562,10 @@ QNetworkCacheMetaData QNetworkDiskCache::metaData(const QUrl &url)
     Q_D(QNetworkDiskCache);
     if (d->lastItem.metaData.url() == url)
         return d->lastItem.metaData;
-    return fileMetaData(d->cacheFileName(url));
+    const QString fileName = d->cacheFileName(url);
+    if (d->isRemovalPending(fileName))
+        return QNetworkCacheMetaData();
+    return fileMetaData(fileName);
 }
 
 /*!
@@ -402,7 +606,10 @@ QIODevice *QNetworkDiskCache::data(const QUrl &url)
         buffer.reset(new QBuffer);
         buffer->setData(d->lastItem.data.data());
     } else {
-        QScopedPointer<QFile> file(new QFile(d->cacheFileName(url)));
+        const QString fileName = d->cacheFileName(url);
+        if (d->isRemovalPending(fileName))
+            return nullptr;
+        QScopedPointer<QFile> file(new QFile(fileName));
         if (!file->open(QFile::ReadOnly | QIODevice::Unbuffered))
             return nullptr;
 
@@ -490,8 +697,10 @@ void QNetworkDiskCache::setMaximumCacheSize(qint64 size)
 
     When the current size of the cache is greater than the maximumCacheSize()
     older cache files are removed until the total size is less then 90% of
-    maximumCacheSize() starting with the oldest ones first using the file
-    creation date to determine how old a cache file is.
+    maximumCacheSize() starting with the oldest ones first, in the order in
+    which they were stored in the cache. The files to remove are taken from
+    the index of the cache rather than by scanning the cache directory, and
+    large numbers of files are removed in a background thread.
 
     Subclasses can reimplement this function to change the order that cache
     files are removed taking into account information in the application
@@ -516,56 +725,25 @@ qint64 QNetworkDiskCache::expire()
     // close file handle to prevent "in use" error when QFile::remove() is called
     d->lastItem.reset();
 
-    QDir::Filters filters = QDir::AllDirs | QDir:: Files | QDir::NoDotAndDotDot;
-    QDirIterator it(cacheDirectory(), filters, QDirIterator::Subdirectories);
-
-    QMultiMap<QDateTime, QString> cacheItems;
-    qint64 totalSize = 0;
-    while (it.hasNext()) {
-        QFileInfo info = it.nextFileInfo();
-        QString path = info.filePath();
-        QString fileName = info.fileName();
-        if (fileName.endsWith(CACHE_POSTFIX)) {
-            const QDateTime birthTime = info.fileTime(QFile::FileBirthTime);
-            cacheItems.insert(birthTime.isValid() ? birthTime
-                              : info.fileTime(QFile::FileMetadataChangeTime), path);
-            totalSize += info.size();
-        }
-    }
-
-    int removedFiles = 0;
-    qint64 goal = (maximumCacheSize() * 9) / 10;
-    QMultiMap<QDateTime, QString>::const_iterator i = cacheItems.constBegin();
-    while (i != cacheItems.constEnd()) {
-        if (totalSize < goal)
+    const qint64 goal = (maximumCacheSize() * 9) / 10;
+    QStringList removedFiles;
+    while (d->index.totalSize() >= goal) {
+        const quint64 key = d->index.takeOldest();
+        if (!key)
             break;
-        QString name = i.value();
-        QFile file(name);
-
-        if (name.contains(PREPARED_SLASH)) {
-            for (QCacheItem *item : qAsConst(d->inserting)) {
-                if (item && item->file && item->file->fileName() == name) {
-                    delete item->file;
-                    item->file = nullptr;
-                    break;
-                }
-            }
-        }
-
-        qint64 size = file.size();
-        file.remove();
-        totalSize -= size;
-        ++removedFiles;
-        ++i;
+        removedFiles.append(d->fileNameForKey(key));
     }
+    if (!removedFiles.isEmpty() && d->index.count() == 0)
+        d->index.clear();
+    d->removeFiles(removedFiles);
 #if defined(QNETWORKDISKCACHE_DEBUG)
-    if (removedFiles > 0) {
+    if (!removedFiles.isEmpty()) {
         qDebug() << "QNetworkDiskCache::expire()"
-                << "Removed:" << removedFiles
-                << "Kept:" << cacheItems.count() - removedFiles;
+                << "Removed:" << removedFiles.count()
+                << "Kept:" << d->index.count();
     }
 #endif
-    return totalSize;
+    return d->index.totalSize();
 }
 
 /*!
@@ -581,6 +759,19 @@ void QNetworkDiskCache::clear()
     d->maximumCacheSize = 0;
     d->currentCacheSize = expire();
     d->maximumCacheSize = size;
+
+    // expire() only knows about the files in the index, and may have been
+    // reimplemented; remove whatever is left in the data directory.
+    if (d->dataDirectory.isEmpty())
+        return;
+    QDirIterator it(d->dataDirectory, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString path = it.next();
+        if (path.endsWith(CACHE_POSTFIX))
+            QFile::remove(path);
+    }
+    d->index.clear();
+    d->currentCacheSize = 0;
 }
 
 /*!
@@ -724,6 +915,277 @@ bool QCacheItem::read(QFile *device, bool readData)
     return metaData.isValid();
 }
 
+enum
+{
+    IndexMagic = 0x51444349, // "QDCI"
+    IndexVersion = 2,
+    // magic, version, state
+    IndexHeaderSize = 4 + 4 + 4,
+    IndexStateOffset = 8,
+    // operation, key, size
+    IndexRecordSize = 1 + 8 + 8,
+    // number of stale records tolerated before the journal is compacted
+    IndexCompactionSlack = 1024
+};
+
+enum IndexState : quint32
+{
+    IndexOpen = 0,
+    IndexClosed = 1
+};
+
+static void writeIndexRecord(uchar *record, quint8 operation, quint64 key, qint64 size)
+{
+    record[0] = operation;
+    qToLittleEndian<quint64>(key, record + 1);
+    qToLittleEndian<qint64>(size, record + 9);
+}
+
+/*!
+    Loads the index from the journal \a fileName, which is kept open for
+    appending. Returns \c false if the journal does not exist or is not a
+    valid index, in which case the index is empty and has to be rebuilt.
+    Otherwise \a clean is set to whether the journal was closed in an
+    orderly way by close(), that is, whether it can be trusted to hold
+    every file of the cache.
+
+    The journal is a header followed by fixed size insert and remove
+    records; a truncated record left by an interrupted write is dropped.
+    The header holds the state of the journal, which is marked as open
+    until close() is called.
+*/
+bool QNetworkDiskCacheIndex::load(const QString &fileName, bool *clean)
+{
+    close();
+    entries.clear();
+    order.clear();
+    nextSequence = 0;
+    total = 0;
+    journalRecords = 0;
+    journalFailed = false;
+    *clean = false;
+
+    journal.setFileName(fileName);
+    if (!journal.open(QIODevice::ReadWrite | QIODevice::Unbuffered))
+        return false;
+    const qint64 size = journal.size();
+    if (size < IndexHeaderSize)
+        return false;
+
+    QByteArray buffer;
+    uchar *mapped = journal.map(0, size);
+    const uchar *data = mapped;
+    if (!data) {
+        buffer = journal.readAll();
+        if (buffer.size() != size)
+            return false;
+        data = reinterpret_cast<const uchar *>(buffer.constData());
+    }
+
+    bool valid = qFromLittleEndian<quint32>(data) == IndexMagic
+                 && qFromLittleEndian<quint32>(data + 4) == IndexVersion;
+    const bool closed = valid && qFromLittleEndian<quint32>(data + IndexStateOffset) == IndexClosed;
+    qint64 offset = IndexHeaderSize;
+    while (valid && offset + IndexRecordSize <= size) {
+        const uchar *record = data + offset;
+        const quint64 key = qFromLittleEndian<quint64>(record + 1);
+        switch (record[0]) {
+        case InsertOperation:
+            insertEntry(key, qFromLittleEndian<qint64>(record + 9));
+            break;
+        case RemoveOperation:
+            removeEntry(key);
+            break;
+        default:
+            valid = false;
+            continue;
+        }
+        ++journalRecords;
+        offset += IndexRecordSize;
+    }
+    if (mapped)
+        journal.unmap(mapped);
+
+    if (offset == IndexHeaderSize && !valid)
+        return false;
+    if (offset != size)
+        journal.resize(offset);
+    *clean = closed && writeState(IndexOpen);
+    journal.seek(offset);
+    if (journalRecords > 2 * entries.size() + IndexCompactionSlack)
+        compact();
+    return true;
+}
+
+/*!
+    Marks the journal as closed cleanly, unless writing it failed, and
+    closes it.
+*/
+void QNetworkDiskCacheIndex::close()
+{
+    if (journal.isOpen() && !journalFailed)
+        writeState(IndexClosed);
+    journal.close();
+}
+
+/*!
+    Replaces the contents of the index with \a oldestFirst, a list of keys
+    and sizes ordered from the oldest to the newest entry, and rewrites the
+    journal.
+*/
+void QNetworkDiskCacheIndex::reset(const QList<std::pair<quint64, qint64>> &oldestFirst)
+{
+    entries.clear();
+    order.clear();
+    nextSequence = 0;
+    total = 0;
+    entries.reserve(oldestFirst.size());
+    for (const auto &entry : oldestFirst)
+        insertEntry(entry.first, entry.second);
+    compact();
+}
+
+void QNetworkDiskCacheIndex::clear()
+{
+    reset({});
+}
+
+void QNetworkDiskCacheIndex::insert(quint64 key, qint64 size)
+{
+    insertEntry(key, size);
+    append(InsertOperation, key, size);
+}
+
+qint64 QNetworkDiskCacheIndex::size(quint64 key) const
+{
+    const auto it = entries.constFind(key);
+    return it == entries.cend() ? -1 : it->size;
+}
+
+QList<quint64> QNetworkDiskCacheIndex::keys() const
+{
+    return entries.keys();
+}
+
+bool QNetworkDiskCacheIndex::remove(quint64 key)
+{
+    if (!removeEntry(key))
+        return false;
+    append(RemoveOperation, key, 0);
+    return true;
+}
+
+/*!
+    Removes the oldest entry from the index and returns its key, or 0 if
+    the index is empty.
+*/
+quint64 QNetworkDiskCacheIndex::takeOldest()
+{
+    while (!order.empty()) {
+        const auto [sequence, key] = order.front();
+        order.pop_front();
+        const auto it = entries.find(key);
+        if (it == entries.end() || it->sequence != sequence)
+            continue;
+        total -= it->size;
+        entries.erase(it);
+        append(RemoveOperation, key, 0);
+        return key;
+    }
+    return 0;
+}
+
+void QNetworkDiskCacheIndex::insertEntry(quint64 key, qint64 size)
+{
+    auto it = entries.find(key);
+    if (it != entries.end())
+        total -= it->size;
+    entries.insert(key, { size, nextSequence });
+    order.push_back({ nextSequence, key });
+    ++nextSequence;
+    total += size;
+}
+
+bool QNetworkDiskCacheIndex::removeEntry(quint64 key)
+{
+    const auto it = entries.find(key);
+    if (it == entries.end())
+        return false;
+    total -= it->size;
+    entries.erase(it);
+    return true;
+}
+
+void QNetworkDiskCacheIndex::append(Operation operation, quint64 key, qint64 size)
+{
+    if (!journal.isOpen())
+        return;
+    uchar record[IndexRecordSize];
+    writeIndexRecord(record, operation, key, size);
+    if (journal.write(reinterpret_cast<const char *>(record), IndexRecordSize) != IndexRecordSize)
+        journalFailed = true;
+    if (++journalRecords > 2 * entries.size() + IndexCompactionSlack)
+        compact();
+}
+
+/*!
+    Rewrites the journal so that it only holds one insert record for each
+    entry, oldest first, dropping the stale records.
+*/
+void QNetworkDiskCacheIndex::compact()
+{
+    const QString fileName = journal.fileName();
+    journal.close();
+
+    QByteArray data(IndexHeaderSize + entries.size() * IndexRecordSize, Qt::Uninitialized);
+    uchar *out = reinterpret_cast<uchar *>(data.data());
+    qToLittleEndian<quint32>(IndexMagic, out);
+    qToLittleEndian<quint32>(IndexVersion, out + 4);
+    qToLittleEndian<quint32>(IndexOpen, out + IndexStateOffset);
+    out += IndexHeaderSize;
+
+    std::deque<std::pair<quint64, quint64>> compacted;
+    quint64 sequence = 0;
+    for (const auto &[oldSequence, key] : order) {
+        const auto it = entries.find(key);
+        if (it == entries.end() || it->sequence != oldSequence)
+            continue;
+        it->sequence = sequence;
+        compacted.push_back({ sequence++, key });
+        writeIndexRecord(out, InsertOperation, key, it->size);
+        out += IndexRecordSize;
+    }
+    order.swap(compacted);
+    nextSequence = sequence;
+    journalRecords = order.size();
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        qWarning() << "QNetworkDiskCache: couldn't write the cache index" << fileName;
+        journalFailed = true;
+    }
+    // not opened for appending, so that close() can update the header
+    if (journal.open(QIODevice::ReadWrite | QIODevice::Unbuffered))
+        journal.seek(journal.size());
+}
+
+/*!
+    Writes \a state to the header of the journal, leaving the position
+    of the journal undefined. Returns \c false if that failed, in which
+    case the journal is not trusted anymore.
+*/
+bool QNetworkDiskCacheIndex::writeState(quint32 state)
+{
+    uchar data[4];
+    qToLittleEndian<quint32>(state, data);
+    if (!journal.seek(IndexStateOffset)
+        || journal.write(reinterpret_cast<const char *>(data), sizeof(data)) != qint64(sizeof(data))) {
+        journalFailed = true;
+        return false;
+    }
+    return true;
+}
+
 QT_END_NAMESPACE
 
 #include "moc_qnetworkdiskcache.cpp"
@@ -55,15 +55,21 @@
 #include "private/qabstractnetworkcache_p.h"
 
 #include <qbuffer.h>
+#include <qfile.h>
 #include <qhash.h>
+#include <qmutex.h>
+#include <qset.h>
 #include <qtemporaryfile.h>
+#if QT_CONFIG(thread)
+#include <qthreadpool.h>
+#endif
+
+#include <deque>
 
 QT_REQUIRE_CONFIG(networkdiskcache);
 
 QT_BEGIN_NAMESPACE
 
-class QFile;
-
 class QCacheItem
 {
 public:
@@ -94,6 +100,53 @@ public:
     bool canCompress() const;
 };
 
+class QNetworkDiskCacheIndex
+{
+public:
+    ~QNetworkDiskCacheIndex() { close(); }
+
+    bool load(const QString &fileName, bool *clean);
+    void close();
+    void reset(const QList<std::pair<quint64, qint64>> &oldestFirst);
+    void clear();
+
+    void insert(quint64 key, qint64 size);
+    bool remove(quint64 key);
+    quint64 takeOldest();
+
+    qint64 size(quint64 key) const;
+    QList<quint64> keys() const;
+    qint64 totalSize() const { return total; }
+    qsizetype count() const { return entries.size(); }
+
+private:
+    enum Operation : quint8 {
+        InsertOperation = 1,
+        RemoveOperation = 2
+    };
+    void insertEntry(quint64 key, qint64 size);
+    bool removeEntry(quint64 key);
+    void append(Operation operation, quint64 key, qint64 size);
+    void compact();
+    bool writeState(quint32 state);
+
+    struct Entry {
+        qint64 size;
+        quint64 sequence;
+    };
+
+    QFile journal;
+    QHash<quint64, Entry> entries;
+    // (sequence, key) in insertion order; may contain stale pairs until the
+    // next compaction, which are skipped by takeOldest()
+    std::deque<std::pair<quint64, quint64>> order;
+    quint64 nextSequence = 0;
+    qint64 total = 0;
+    qsizetype journalRecords = 0;
+    // set when the journal could not be written and may miss records
+    bool journalFailed = false;
+};
+
 class QNetworkDiskCachePrivate : public QAbstractNetworkCachePrivate
 {
 public:
@@ -101,7 +154,11 @@ public:
         : QAbstractNetworkCachePrivate()
         , maximumCacheSize(1024 * 1024 * 50)
         , currentCacheSize(-1)
-        {}
+    {
+#if QT_CONFIG(thread)
+        removalPool.setMaxThreadCount(1);
+#endif
+    }
 
     static QString uniqueFileName(const QUrl &url);
     QString cacheFileName(const QUrl &url) const;
@@ -111,6 +168,14 @@ public:
     void prepareLayout();
     static quint32 crc32(const char *data, uint len);
 
+    void loadIndex();
+    QList<std::pair<quint64, qint64>> scanDataDirectory() const;
+    quint64 indexKey(const QString &fileName) const;
+    QString fileNameForKey(quint64 key) const;
+    void removeFiles(const QStringList &files);
+    bool isRemovalPending(const QString &file);
+    void cancelRemoval(const QString &file);
+
     mutable QCacheItem lastItem;
     QString cacheDirectory;
     QString dataDirectory;
@@ -118,6 +183,14 @@ public:
     qint64 currentCacheSize;
 
     QHash<QIODevice*, QCacheItem*> inserting;
+    QNetworkDiskCacheIndex index;
+
+    // Files handed to the removal thread by expire(); guarded by removalMutex
+    QMutex removalMutex;
+    QSet<QString> pendingRemovals;
+#if QT_CONFIG(thread)
+    QThreadPool removalPool;
+#endif
     Q_DECLARE_PUBLIC(QNetworkDiskCache)
 };
 
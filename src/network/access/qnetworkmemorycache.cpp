@@ -0,0 +1,331 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qnetworkmemorycache.h"
+#include "qnetworkmemorycache_p.h"
+
+#include <qbuffer.h>
+#include <qdebug.h>
+
+#include <limits>
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+// The device returned by prepare(). When the reply has no Content-Length,
+// its size is only known once it has been written, so the device stops
+// buffering once the data exceeds the limit, and the item is not cached.
+class QNetworkMemoryCacheBuffer : public QIODevice
+{
+public:
+    explicit QNetworkMemoryCacheBuffer(qint64 limit)
+        : limit(limit)
+    {
+        open(QIODevice::WriteOnly);
+    }
+
+    bool isSequential() const override { return true; }
+    bool exceedsLimit() const { return exceeded; }
+    QByteArray takeData() { return std::move(buffer); }
+
+protected:
+    qint64 readData(char *, qint64) override { return -1; }
+    qint64 writeData(const char *data, qint64 len) override
+    {
+        if (exceeded)
+            return len;
+        if (buffer.size() + len > limit) {
+            exceeded = true;
+            buffer = QByteArray();
+            return len;
+        }
+        buffer.append(data, len);
+        return len;
+    }
+
+private:
+    QByteArray buffer;
+    const qint64 limit;
+    bool exceeded = false;
+};
+} // unnamed namespace
+
+/*!
+    \class QNetworkMemoryCache
+    \since 6.3
+    \inmodule QtNetwork
+
+    \brief The QNetworkMemoryCache class provides a network cache that keeps
+    its items in memory.
+
+    QNetworkMemoryCache stores the data of each cached URL in an implicitly
+    shared QByteArray. Cache hits do not touch the file system and do not
+    copy the data: the QIODevice returned by data() reads directly from the
+    bytes held by the cache.
+
+    The total size of the cache is limited by maximumCacheSize(), 10MB by
+    default. When inserting an item would exceed the limit, the items that
+    have been used least recently are discarded first. The size of an item
+    is the size of its data plus the size of its raw headers. Items larger
+    than three quarters of the maximum cache size are not cached; their
+    data is not buffered beyond that size either.
+
+    Unlike QNetworkDiskCache, the contents of a QNetworkMemoryCache are lost
+    when it is destroyed. Items whose metadata does not allow them to be
+    saved to disk are not cached either, since QNetworkAccessManager will
+    not use them.
+
+    A memory cache can be enabled by:
+
+    \snippet code/src_network_access_qnetworkmemorycache.cpp 0
+
+    \sa QNetworkDiskCache
+*/
+
+/*!
+    Creates a new memory cache. The \a parent argument is passed to
+    QAbstractNetworkCache's constructor.
+ */
+QNetworkMemoryCache::QNetworkMemoryCache(QObject *parent)
+    : QAbstractNetworkCache(*new QNetworkMemoryCachePrivate, parent)
+{
+}
+
+/*!
+    Destroys the cache object and all of its items.
+ */
+QNetworkMemoryCache::~QNetworkMemoryCache()
+{
+    Q_D(QNetworkMemoryCache);
+    qDeleteAll(d->inserting.keyBegin(), d->inserting.keyEnd());
+}
+
+/*!
+    Returns the current maximum size for the memory cache.
+
+    \sa setMaximumCacheSize()
+ */
+qint64 QNetworkMemoryCache::maximumCacheSize() const
+{
+    Q_D(const QNetworkMemoryCache);
+    return d->entries.maxCost();
+}
+
+/*!
+    Sets the maximum size of the memory cache to be \a size bytes.
+
+    If the new size is smaller than the current cache size, the least
+    recently used items are discarded until the cache fits.
+
+    \sa maximumCacheSize()
+ */
+void QNetworkMemoryCache::setMaximumCacheSize(qint64 size)
+{
+    Q_D(QNetworkMemoryCache);
+    size = qBound(qint64(0), size, qint64(std::numeric_limits<qsizetype>::max()));
+    d->entries.setMaxCost(qsizetype(size));
+}
+
+/*!
+    \reimp
+*/
+qint64 QNetworkMemoryCache::cacheSize() const
+{
+    Q_D(const QNetworkMemoryCache);
+    return d->entries.totalCost();
+}
+
+/*!
+    \reimp
+*/
+QNetworkCacheMetaData QNetworkMemoryCache::metaData(const QUrl &url)
+{
+    Q_D(QNetworkMemoryCache);
+    const QNetworkMemoryCachePrivate::Entry *entry = d->entries.object(d->cacheKey(url));
+    return entry ? entry->metaData : QNetworkCacheMetaData();
+}
+
+/*!
+    \reimp
+*/
+void QNetworkMemoryCache::updateMetaData(const QNetworkCacheMetaData &metaData)
+{
+    Q_D(QNetworkMemoryCache);
+    const QUrl key = d->cacheKey(metaData.url());
+    const QNetworkMemoryCachePrivate::Entry *entry = d->entries.object(key);
+    if (!entry)
+        return;
+    if (!metaData.isValid() || !metaData.saveToDisk()) {
+        d->entries.remove(key);
+        return;
+    }
+    d->store(key, new QNetworkMemoryCachePrivate::Entry{ metaData, entry->data });
+}
+
+/*!
+    \reimp
+
+    The returned device shares the data held by the cache rather than
+    copying it.
+*/
+QIODevice *QNetworkMemoryCache::data(const QUrl &url)
+{
+    Q_D(QNetworkMemoryCache);
+    const QNetworkMemoryCachePrivate::Entry *entry = d->entries.object(d->cacheKey(url));
+    if (!entry)
+        return nullptr;
+    std::unique_ptr<QBuffer> buffer = std::make_unique<QBuffer>();
+    buffer->setData(entry->data);
+    buffer->open(QBuffer::ReadOnly);
+    return buffer.release();
+}
+
+/*!
+    \reimp
+*/
+bool QNetworkMemoryCache::remove(const QUrl &url)
+{
+    Q_D(QNetworkMemoryCache);
+    const QUrl key = d->cacheKey(url);
+
+    // remove is also used to cancel insertions, not a common operation
+    for (auto it = d->inserting.cbegin(), end = d->inserting.cend(); it != end; ++it) {
+        if (d->cacheKey(it.value().url()) == key) {
+            delete it.key();
+            d->inserting.erase(it);
+            return true;
+        }
+    }
+
+    return d->entries.remove(key);
+}
+
+/*!
+    \reimp
+*/
+QIODevice *QNetworkMemoryCache::prepare(const QNetworkCacheMetaData &metaData)
+{
+    Q_D(QNetworkMemoryCache);
+    if (!metaData.isValid() || !metaData.url().isValid() || !metaData.saveToDisk())
+        return nullptr;
+
+    const qint64 limit = (maximumCacheSize() * 3) / 4;
+    const auto headers = metaData.rawHeaders();
+    for (const auto &header : headers) {
+        if (header.first.compare("content-length", Qt::CaseInsensitive) == 0) {
+            const qint64 size = header.second.toLongLong();
+            if (size > limit)
+                return nullptr;
+            break;
+        }
+    }
+
+    auto *buffer = new QNetworkMemoryCacheBuffer(limit);
+    d->inserting.insert(buffer, metaData);
+    return buffer;
+}
+
+/*!
+    \reimp
+*/
+void QNetworkMemoryCache::insert(QIODevice *device)
+{
+    Q_D(QNetworkMemoryCache);
+    const auto it = d->inserting.constFind(device);
+    if (Q_UNLIKELY(it == d->inserting.cend())) {
+        qWarning() << "QNetworkMemoryCache::insert() called on a device we don't know about" << device;
+        return;
+    }
+
+    const QNetworkCacheMetaData metaData = it.value();
+    d->inserting.erase(it);
+    std::unique_ptr<QNetworkMemoryCacheBuffer> buffer(static_cast<QNetworkMemoryCacheBuffer *>(device));
+    if (buffer->exceedsLimit()) {
+        // the new data replaces what was cached before
+        d->entries.remove(d->cacheKey(metaData.url()));
+        return;
+    }
+    d->store(d->cacheKey(metaData.url()),
+             new QNetworkMemoryCachePrivate::Entry{ metaData, buffer->takeData() });
+}
+
+/*!
+    \reimp
+*/
+void QNetworkMemoryCache::clear()
+{
+    Q_D(QNetworkMemoryCache);
+    d->entries.clear();
+}
+
+/*!
+    Returns the URL under which the data for \a url is stored, without the
+    password and the fragment.
+ */
+QUrl QNetworkMemoryCachePrivate::cacheKey(const QUrl &url)
+{
+    return url.adjusted(QUrl::RemovePassword | QUrl::RemoveFragment);
+}
+
+/*!
+    Returns the number of bytes \a entry accounts for in the cache size.
+ */
+qsizetype QNetworkMemoryCachePrivate::cost(const Entry &entry)
+{
+    qsizetype size = entry.data.size();
+    const auto headers = entry.metaData.rawHeaders();
+    for (const auto &header : headers)
+        size += header.first.size() + header.second.size();
+    return size;
+}
+
+/*!
+    Takes ownership of \a entry and stores it under \a key, evicting the
+    least recently used entries if needed. Entries larger than the maximum
+    cache size are dropped.
+ */
+void QNetworkMemoryCachePrivate::store(const QUrl &key, Entry *entry)
+{
+    entries.insert(key, entry, cost(*entry));
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qnetworkmemorycache.cpp"
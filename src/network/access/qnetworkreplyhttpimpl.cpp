@@ -815,11 +815,15 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
 
     // Create the HTTP thread delegate
     QHttpThreadDelegate *delegate = new QHttpThreadDelegate;
-    // Propagate Http/2 settings:
+    // Propagate Http/1.1 connection pool and Http/2 settings:
+    delegate->http1Parameters = managerPrivate->http1Configurations.value(url.host(),
+                                                                          QHttp1Configuration());
     delegate->http2Parameters = request.http2Configuration();
 
     if (request.attribute(QNetworkRequest::ConnectionCacheExpiryTimeoutSecondsAttribute).isValid())
         delegate->connectionCacheExpiryTimeoutSeconds = request.attribute(QNetworkRequest::ConnectionCacheExpiryTimeoutSecondsAttribute).toInt();
+    else if (managerPrivate->http1Configurations.contains(url.host()))
+        delegate->connectionCacheExpiryTimeoutSeconds = delegate->http1Parameters.idleTimeout();
 
     // For the synchronous HTTP, this is the normal way the delegate gets deleted
     // For the asynchronous HTTP this is a safety measure, the delegate deletes itself when HTTP is finished
@@ -992,7 +996,8 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
                     delegate->incomingContentLength,
                     delegate->removedContentLength,
                     delegate->isHttp2Used,
-                    delegate->isCompressed);
+                    delegate->isCompressed,
+                    delegate->isConnectionReused);
         replyDownloadData(delegate->synchronousDownloadData);
 
         if (delegate->incomingErrorCode != QNetworkReply::NoError)
@@ -1327,7 +1332,8 @@ void QNetworkReplyHttpImplPrivate::replyDownloadMetaData(const QList<QPair<QByte
                                                          QSharedPointer<char> db,
                                                          qint64 contentLength,
                                                          qint64 removedContentLength,
-                                                         bool h2Used, bool isCompressed)
+                                                         bool h2Used, bool isCompressed,
+                                                         bool connectionReused)
 {
     Q_Q(QNetworkReplyHttpImpl);
     Q_UNUSED(contentLength);
@@ -1354,6 +1360,7 @@ void QNetworkReplyHttpImplPrivate::replyDownloadMetaData(const QList<QPair<QByte
 
     q->setAttribute(QNetworkRequest::HttpPipeliningWasUsedAttribute, pu);
     q->setAttribute(QNetworkRequest::Http2WasUsedAttribute, h2Used);
+    q->setAttribute(QNetworkRequest::ConnectionReusedAttribute, connectionReused);
 
     // reconstruct the HTTP header
     QList<QPair<QByteArray, QByteArray> > headerMap = hm;
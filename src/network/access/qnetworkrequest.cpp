@@ -336,6 +336,14 @@ QT_BEGIN_NAMESPACE
         This attribute is ignored if the Http2AllowedAttribute is not set.
         (This value was introduced in 6.3.)
 
+    \value ConnectionReusedAttribute
+        Replies only, type: QMetaType::Bool (default: false)
+        Indicates whether the request was sent over a connection that had
+        already been used for another request, instead of a newly opened
+        one. Pipelined requests and requests multiplexed on an established
+        HTTP/2 connection are sent over reused connections.
+        (This value was introduced in 6.3.)
+
     \value User
         Special type. Additional information can be passed in
         QVariants with types ranging from User to UserMax. The default
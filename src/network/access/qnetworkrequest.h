@@ -99,6 +99,7 @@ public:
         AutoDeleteReplyOnFinishAttribute,
         ConnectionCacheExpiryTimeoutSecondsAttribute,
         Http2CleartextAllowedAttribute,
+        ConnectionReusedAttribute,
 
         User = 1000,
         UserMax = 32767
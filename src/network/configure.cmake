@@ -142,6 +142,43 @@ ci.ifa_prefered = ci.ifa_valid = 0;
 }
 ")
 
+# sendmmsg
+qt_config_compile_test(sendmmsg
+    LABEL "sendmmsg() and recvmmsg()"
+    CODE
+"#include <sys/types.h>
+#include <sys/socket.h>
+
+int main(void)
+{
+    /* BEGIN TEST: */
+struct mmsghdr msgs[2];
+(void) recvmmsg(-1, msgs, 2, MSG_DONTWAIT, 0);
+(void) sendmmsg(-1, msgs, 2, 0);
+(void) msgs[0].msg_len;
+    /* END TEST: */
+    return 0;
+}
+")
+
+# sendfile
+qt_config_compile_test(sendfile
+    LABEL "Linux sendfile()"
+    CODE
+"#include <sys/types.h>
+#include <sys/sendfile.h>
+
+int main(void)
+{
+    /* BEGIN TEST: */
+off_t offset = 0;
+ssize_t sent = sendfile(-1, -1, &offset, 1);
+(void) sent;
+    /* END TEST: */
+    return 0;
+}
+")
+
 # sctp
 qt_config_compile_test(sctp
     LABEL "SCTP support"
@@ -252,6 +289,14 @@ qt_feature("linux-netlink" PRIVATE
     LABEL "Linux AF_NETLINK"
     CONDITION LINUX AND NOT ANDROID AND TEST_linux_netlink
 )
+qt_feature("sendmmsg" PRIVATE
+    LABEL "sendmmsg()/recvmmsg()"
+    CONDITION UNIX AND TEST_sendmmsg
+)
+qt_feature("sendfile" PRIVATE
+    LABEL "sendfile()"
+    CONDITION LINUX AND TEST_sendfile
+)
 qt_feature("openssl" PRIVATE
     LABEL "OpenSSL"
     CONDITION QT_FEATURE_openssl_runtime OR QT_FEATURE_openssl_linked
@@ -374,6 +419,12 @@ qt_feature("dnslookup" PUBLIC
     PURPOSE "Provides API for DNS lookups."
     CONDITION NOT INTEGRITY
 )
+qt_feature("dnsresolver" PRIVATE
+    SECTION "Networking"
+    LABEL "DNS stub resolver"
+    PURPOSE "Lets QHostInfo send DNS queries asynchronously instead of calling getaddrinfo() in a thread pool."
+    CONDITION QT_FEATURE_dnslookup AND QT_FEATURE_udpsocket AND QT_FEATURE_library AND QT_FEATURE_thread AND UNIX AND NOT ANDROID
+)
 qt_feature("gssapi" PUBLIC
     SECTION "Networking"
     LABEL "GSSAPI"
@@ -407,6 +458,14 @@ qt_configure_add_summary_entry(
     ARGS "linux-netlink"
     CONDITION LINUX
 )
+qt_configure_add_summary_entry(
+    ARGS "sendmmsg"
+    CONDITION UNIX
+)
+qt_configure_add_summary_entry(
+    ARGS "sendfile"
+    CONDITION LINUX
+)
 qt_configure_add_summary_entry(
     ARGS "securetransport"
     CONDITION APPLE
@@ -144,6 +144,12 @@ public:
     { }
     void run() override;
 
+    static void parseReply(const unsigned char *response, int responseLength,
+                           QDnsLookupReply *reply);
+#if QT_CONFIG(dnsresolver)
+    static QList<QHostAddress> systemNameServers();
+#endif
+
 signals:
     void finished(const QDnsLookupReply &reply);
 
@@ -222,11 +222,28 @@ void QDnsLookupRunnable::query(const int requestType, const QByteArray &requestN
         }
     }
 
-    unsigned char *response = buffer.data();
+    parseReply(buffer.data(), responseLength, reply);
+}
+
+/*
+    Parses the DNS message of \a responseLength bytes at \a response into
+    \a reply. The response code is checked first, because res_nquery()
+    returns -1 as the length of an error response.
+*/
+void QDnsLookupRunnable::parseReply(const unsigned char *response, int responseLength,
+                                    QDnsLookupReply *reply)
+{
+    resolveLibrary();
+    if (!local_dn_expand) {
+        reply->error = QDnsLookup::ResolverError;
+        reply->errorString = tr("Resolver functions not found");
+        return;
+    }
+
     // Check the response header. Though res_nquery returns -1 as a
     // responseLength in case of error, we still can extract the
     // exact error code from the response.
-    HEADER *header = (HEADER*)response;
+    const HEADER *header = (const HEADER*)response;
     const int answerCount = ntohs(header->ancount);
     switch (header->rcode) {
     case NOERROR:
@@ -262,7 +279,7 @@ void QDnsLookupRunnable::query(const int requestType, const QByteArray &requestN
 
     // Skip the query host, type (2 bytes) and class (2 bytes).
     char host[PACKETSZ], answer[PACKETSZ];
-    unsigned char *p = response + sizeof(HEADER);
+    const unsigned char *p = response + sizeof(HEADER);
     int status = local_dn_expand(response, response + responseLength, p, host, sizeof(host));
     if (status < 0) {
         reply->error = QDnsLookup::InvalidReplyError;
@@ -283,6 +300,13 @@ void QDnsLookupRunnable::query(const int requestType, const QByteArray &requestN
         const QString name = QUrl::fromAce(host);
 
         p += status;
+        // The fixed part of the record and its data must fit in the response.
+        if (response + responseLength - p < 10
+            || response + responseLength - p - 10 < ((p[8] << 8) | p[9])) {
+            reply->error = QDnsLookup::InvalidReplyError;
+            reply->errorString = tr("Invalid reply received");
+            return;
+        }
         const quint16 type = (p[0] << 8) | p[1];
         p += 2; // RR type
         p += 2; // RR class
@@ -383,7 +407,7 @@ void QDnsLookupRunnable::query(const int requestType, const QByteArray &requestN
             record.d->weight = weight;
             reply->serviceRecords.append(record);
         } else if (type == QDnsLookup::TXT) {
-            unsigned char *txt = p;
+            const unsigned char *txt = p;
             QDnsTextRecord record;
             record.d->name = name;
             record.d->timeToLive = ttl;
@@ -405,6 +429,41 @@ void QDnsLookupRunnable::query(const int requestType, const QByteArray &requestN
     }
 }
 
+#if QT_CONFIG(dnsresolver)
+/*
+    Returns the addresses of the name servers configured for the system's
+    resolver, in the order they should be tried.
+*/
+QList<QHostAddress> QDnsLookupRunnable::systemNameServers()
+{
+    QList<QHostAddress> nameServers;
+
+    resolveLibrary();
+    if (!local_res_nclose || !local_res_ninit)
+        return nameServers;
+
+    struct __res_state state;
+    std::memset(&state, 0, sizeof(state));
+    if (local_res_ninit(&state) < 0)
+        return nameServers;
+    QScopedPointer<struct __res_state, QDnsLookupStateDeleter> state_ptr(&state);
+
+    for (int i = 0; i < state.nscount && i < MAXNS; ++i) {
+        if (state.nsaddr_list[i].sin_family == AF_INET) {
+            nameServers.append(QHostAddress(ntohl(state.nsaddr_list[i].sin_addr.s_addr)));
+            continue;
+        }
+#if defined(Q_OS_LINUX)
+        // IPv6 name servers are kept in the extension part of the state.
+        const struct sockaddr_in6 *ns = state._u._ext.nsaddrs[i];
+        if (ns && ns->sin6_family == AF_INET6)
+            nameServers.append(QHostAddress(ns->sin6_addr.s6_addr));
+#endif
+    }
+    return nameServers;
+}
+#endif // QT_CONFIG(dnsresolver)
+
 #else
 void QDnsLookupRunnable::query(const int requestType, const QByteArray &requestName, const QHostAddress &nameserver, QDnsLookupReply *reply)
 {
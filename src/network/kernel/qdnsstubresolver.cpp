@@ -0,0 +1,434 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qdnsstubresolver_p.h"
+
+#include "private/qdnslookup_p.h"
+
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qcoreevent.h>
+#include <QtCore/qrandom.h>
+#include <QtCore/qurl.h>
+#include <QtNetwork/qnetworkdatagram.h>
+#include <QtNetwork/qudpsocket.h>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+//#define QDNSSTUBRESOLVER_DEBUG
+
+namespace {
+enum : quint16 {
+    TypeA = 1,
+    TypeAAAA = 28,
+    ClassIN = 1
+};
+
+enum {
+    HeaderSize = 12,
+    MaxNameLength = 253,
+    MaxLabelLength = 63,
+    // large enough for anything but EDNS replies, which we never ask for
+    MaxReplySize = 4096,
+    ReadBatchSize = 32,
+    // longer chains are almost certainly loops
+    MaxCanonicalNames = 8,
+    // answers are not validated, so do not let a bad one stick for long
+    MaxTimeToLive = 300
+};
+}
+
+/*
+    Returns the ACE form of \a name without the trailing dot, or an empty
+    byte array if it cannot be sent as a DNS question.
+*/
+static QByteArray aceName(const QString &name)
+{
+    QByteArray ace = QUrl::toAce(name);
+    if (ace.endsWith('.'))
+        ace.chop(1);
+    if (ace.isEmpty() || ace.size() > MaxNameLength)
+        return QByteArray();
+    for (const QByteArray &label : ace.split('.')) {
+        if (label.isEmpty() || label.size() > MaxLabelLength)
+            return QByteArray();
+    }
+    return ace;
+}
+
+/*
+    Returns \a ace with the case of each letter chosen at random. Servers
+    copy the question into the reply as it was sent, so an attacker who
+    forges a reply has to guess the case of the name as well as the message
+    ID and the port (the "0x20 bit" encoding).
+*/
+static QByteArray randomizeCase(QByteArray ace)
+{
+    quint32 bits = 0;
+    for (qsizetype i = 0; i < ace.size(); ++i) {
+        if (i % 32 == 0)
+            bits = QRandomGenerator::global()->generate();
+        const char c = ace.at(i);
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))
+            ace[i] = (bits & 1) ? char(c & ~0x20) : char(c | 0x20);
+        bits >>= 1;
+    }
+    return ace;
+}
+
+static QByteArray encodeQuery(quint16 id, const QByteArray &ace, quint16 type)
+{
+    QByteArray message;
+    message.reserve(HeaderSize + ace.size() + 2 + 4);
+
+    // ID, RD set, one question, no answer, authority or additional records
+    const char header[HeaderSize] = { char(id >> 8), char(id & 0xff), 0x01, 0x00,
+                                      0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    message.append(header, HeaderSize);
+    for (const QByteArray &label : ace.split('.')) {
+        message.append(char(label.size()));
+        message.append(label);
+    }
+    message.append('\0');
+    message.append(char(type >> 8));
+    message.append(char(type & 0xff));
+    message.append(char(ClassIN >> 8));
+    message.append(char(ClassIN & 0xff));
+    return message;
+}
+
+/*
+    Constructs a resolver sending its queries to port \a port of
+    \a nameServers, in turn.
+*/
+QDnsStubResolver::QDnsStubResolver(const QList<QHostAddress> &nameServers, quint16 port,
+                                   QObject *parent)
+    : QObject(parent), nameServers(nameServers), port(port)
+{
+}
+
+QDnsStubResolver::~QDnsStubResolver()
+{
+}
+
+/*
+    Returns \c true if \a name is a host name that this resolver can look up
+    with the same result as the system resolver would produce.
+
+    IP address literals, single-label names (which are subject to the search
+    domains) and names that the system resolves without the DNS, such as
+    \c localhost and mDNS \c .local names, are left to the system.
+*/
+bool QDnsStubResolver::canResolve(const QString &name)
+{
+    QHostAddress address;
+    if (name.isEmpty() || address.setAddress(name))
+        return false;
+
+    const QByteArray ace = aceName(name);
+    if (ace.isEmpty() || !ace.contains('.'))
+        return false;
+    if (ace == "localhost" || ace.endsWith(".localhost") || ace.endsWith(".local"))
+        return false;
+    return true;
+}
+
+/*
+    Returns how often a query is sent before the resolver gives up: each name
+    server is tried twice.
+*/
+int QDnsStubResolver::maximumAttempts() const
+{
+    return qMax(2, 2 * int(nameServers.size()));
+}
+
+/*
+    Starts looking up the addresses of \a name, unless a lookup for it is
+    already in progress. Either resolved() or resolutionFailed() is emitted
+    once for every lookup that is started.
+*/
+void QDnsStubResolver::resolve(const QString &name)
+{
+    if (resolutions.contains(name))
+        return;
+
+    const QByteArray ace = aceName(name);
+    if (ace.isEmpty() || nameServers.isEmpty() || !ensureSocket()) {
+        emit resolutionFailed(name);
+        return;
+    }
+
+    Resolution &resolution = resolutions[name];
+    for (quint16 type : { TypeA, TypeAAAA }) {
+        quint16 id;
+        do {
+            id = quint16(QRandomGenerator::global()->generate());
+        } while (queries.contains(id));
+
+        Query &query = queries[id];
+        query.name = name;
+        query.type = type;
+        query.message = encodeQuery(id, randomizeCase(ace), type);
+        ++resolution.pendingQueries;
+        sendQuery(query);
+    }
+
+    if (!retransmitTimer.isActive())
+        retransmitTimer.start(qMax(10, retransmitMsecs / 4), this);
+}
+
+bool QDnsStubResolver::ensureSocket()
+{
+    if (socket)
+        return true;
+
+    socket = new QUdpSocket(this);
+    if (!socket->bind(QHostAddress::Any, 0) && !socket->bind(QHostAddress::AnyIPv4, 0)) {
+#if defined(QDNSSTUBRESOLVER_DEBUG)
+        qDebug("QDnsStubResolver: cannot bind: %s", qPrintable(socket->errorString()));
+#endif
+        delete socket;
+        socket = nullptr;
+        return false;
+    }
+    connect(socket, &QUdpSocket::readyRead, this, &QDnsStubResolver::readDatagrams);
+    return true;
+}
+
+void QDnsStubResolver::sendQuery(Query &query)
+{
+    const QHostAddress &server = nameServers.at(query.attempts % nameServers.size());
+    ++query.attempts;
+    query.deadline.setRemainingTime(retransmitMsecs);
+
+#if defined(QDNSSTUBRESOLVER_DEBUG)
+    qDebug("QDnsStubResolver: query %s type %d to %s (attempt %d)", qPrintable(query.name),
+           query.type, qPrintable(server.toString()), query.attempts);
+#endif
+
+    // A failed send is treated like a lost datagram: the retransmission
+    // timer moves on to the next server.
+    socket->writeDatagram(query.message, server, port);
+}
+
+void QDnsStubResolver::readDatagrams()
+{
+    while (socket->hasPendingDatagrams()) {
+        const QList<QNetworkDatagram> datagrams = socket->receiveDatagrams(ReadBatchSize, MaxReplySize);
+        if (datagrams.isEmpty())
+            break;
+        for (const QNetworkDatagram &datagram : datagrams)
+            processReply(datagram.data(), datagram.senderAddress(), datagram.senderPort());
+    }
+}
+
+void QDnsStubResolver::processReply(const QByteArray &reply, const QHostAddress &sender,
+                                    quint16 senderPort)
+{
+    if (reply.size() < HeaderSize)
+        return;
+
+    const auto *data = reinterpret_cast<const unsigned char *>(reply.constData());
+    const quint16 id = quint16((data[0] << 8) | data[1]);
+    const auto it = queries.find(id);
+    if (it == queries.end())
+        return;
+    Query &query = it.value();
+
+    // Only accept the reply if it comes from one of our servers and answers
+    // the question we asked, so that stray or spoofed datagrams are dropped.
+    if (senderPort != port)
+        return;
+    const bool knownServer = std::any_of(nameServers.cbegin(), nameServers.cend(),
+                                         [&](const QHostAddress &server) {
+        return server.isEqual(sender, QHostAddress::ConvertV4MappedToIPv4);
+    });
+    if (!knownServer)
+        return;
+    const bool isResponse = data[2] & 0x80;
+    const int questionCount = (data[4] << 8) | data[5];
+    const qsizetype questionSize = query.message.size() - HeaderSize;
+    if (!isResponse || questionCount != 1 || reply.size() < HeaderSize + questionSize)
+        return;
+    // The name has to come back with the case it was sent in.
+    if (memcmp(reply.constData() + HeaderSize, query.message.constData() + HeaderSize,
+               questionSize) != 0) {
+        return;
+    }
+
+    // A truncated reply would need TCP; let the system resolver deal with it.
+    const bool truncated = data[2] & 0x02;
+    if (truncated) {
+        queryFinished(id, true);
+        return;
+    }
+
+    QDnsLookupReply parsed;
+    QDnsLookupRunnable::parseReply(data, int(reply.size()), &parsed);
+
+    switch (parsed.error) {
+    case QDnsLookup::NoError:
+        break;
+    case QDnsLookup::NotFoundError:
+        queryFinished(id, false);
+        return;
+    case QDnsLookup::ServerFailureError:
+    case QDnsLookup::ServerRefusedError:
+        if (query.attempts < maximumAttempts())
+            sendQuery(query);
+        else
+            queryFinished(id, true);
+        return;
+    default:
+        queryFinished(id, true);
+        return;
+    }
+
+    // Only use the records for the name that was asked for, or for the names
+    // it is an alias of. A server may add others, which it has no authority
+    // for.
+    QList<QByteArray> owners = { aceName(query.name).toLower() };
+    QList<quint32> aliasTimesToLive;
+    for (int i = 0; i < MaxCanonicalNames; ++i) {
+        const auto cname = std::find_if(parsed.canonicalNameRecords.cbegin(),
+                                        parsed.canonicalNameRecords.cend(),
+                                        [&](const QDnsDomainNameRecord &record) {
+            return aceName(record.name()).toLower() == owners.constLast();
+        });
+        if (cname == parsed.canonicalNameRecords.cend())
+            break;
+        const QByteArray target = aceName(cname->value()).toLower();
+        if (target.isEmpty() || owners.contains(target))
+            break;
+        owners.append(target);
+        aliasTimesToLive.append(cname->timeToLive());
+    }
+
+    Resolution &resolution = resolutions[query.name];
+    bool answered = false;
+    for (const QDnsHostAddressRecord &record : qAsConst(parsed.hostAddressRecords)) {
+        if (!owners.contains(aceName(record.name()).toLower()))
+            continue;
+        const QHostAddress address = record.value();
+        if (query.type == TypeA && address.protocol() == QAbstractSocket::IPv4Protocol)
+            resolution.ipv4Addresses.append(address);
+        else if (query.type == TypeAAAA && address.protocol() == QAbstractSocket::IPv6Protocol)
+            resolution.ipv6Addresses.append(address);
+        else
+            continue;
+        resolution.timeToLive = qMin(resolution.timeToLive, record.timeToLive());
+        answered = true;
+    }
+    if (answered) {
+        for (quint32 timeToLive : qAsConst(aliasTimesToLive))
+            resolution.timeToLive = qMin(resolution.timeToLive, timeToLive);
+    }
+
+    queryFinished(id, false);
+}
+
+void QDnsStubResolver::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() != retransmitTimer.timerId()) {
+        QObject::timerEvent(event);
+        return;
+    }
+
+    QList<quint16> expired;
+    for (auto it = queries.cbegin(), end = queries.cend(); it != end; ++it) {
+        if (it.value().deadline.hasExpired())
+            expired.append(it.key());
+    }
+
+    const int attempts = maximumAttempts();
+    for (quint16 id : qAsConst(expired)) {
+        const auto it = queries.find(id);
+        if (it == queries.end())
+            continue;
+        if (it.value().attempts < attempts)
+            sendQuery(it.value());
+        else
+            queryFinished(id, true);
+    }
+}
+
+void QDnsStubResolver::queryFinished(quint16 id, bool failed)
+{
+    const QString name = queries.take(id).name;
+    if (queries.isEmpty())
+        retransmitTimer.stop();
+
+    Resolution &resolution = resolutions[name];
+    resolution.failed |= failed;
+    if (--resolution.pendingQueries == 0)
+        finishResolution(name);
+}
+
+void QDnsStubResolver::finishResolution(const QString &name)
+{
+    const Resolution resolution = resolutions.take(name);
+
+    QHostInfo info;
+    info.setHostName(name);
+    if (resolution.failed) {
+        // Even if one of the queries succeeded, its addresses alone would be
+        // an incomplete answer.
+#if defined(QDNSSTUBRESOLVER_DEBUG)
+        qDebug("QDnsStubResolver: %s failed", qPrintable(name));
+#endif
+        emit resolutionFailed(name);
+    } else if (!resolution.ipv4Addresses.isEmpty() || !resolution.ipv6Addresses.isEmpty()) {
+        // IPv4 first: QAbstractSocket tries the addresses in this order.
+        info.setAddresses(resolution.ipv4Addresses + resolution.ipv6Addresses);
+        const int timeToLive = int(qMin(resolution.timeToLive, quint32(MaxTimeToLive)));
+#if defined(QDNSSTUBRESOLVER_DEBUG)
+        qDebug("QDnsStubResolver: %s resolved, TTL %d", qPrintable(name), timeToLive);
+#endif
+        emit resolved(name, info, timeToLive);
+    } else {
+        // NXDOMAIN, or no addresses of either family
+        info.setError(QHostInfo::HostNotFound);
+        info.setErrorString(QCoreApplication::translate("QHostInfoAgent", "Host not found"));
+        emit resolved(name, info, -1);
+    }
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,141 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QDNSSTUBRESOLVER_P_H
+#define QDNSSTUBRESOLVER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the QHostInfo class.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtNetwork/private/qtnetworkglobal_p.h>
+#include "QtCore/qbasictimer.h"
+#include "QtCore/qdeadlinetimer.h"
+#include "QtCore/qhash.h"
+#include "QtCore/qlist.h"
+#include "QtCore/qobject.h"
+#include "QtNetwork/qhostaddress.h"
+#include "QtNetwork/qhostinfo.h"
+
+#include <limits>
+
+QT_REQUIRE_CONFIG(dnsresolver);
+
+QT_BEGIN_NAMESPACE
+
+class QUdpSocket;
+
+// Sends the A and AAAA queries for host names straight to a set of name
+// servers over a single UDP socket, so that any number of lookups can be in
+// flight without tying up a thread each. Concurrent requests for the same name
+// share one pair of queries. Anything the resolver cannot answer with
+// certainty (timeouts, server failures, truncated replies) is reported through
+// resolutionFailed() so that the caller can fall back to the system resolver.
+class Q_AUTOTEST_EXPORT QDnsStubResolver : public QObject
+{
+    Q_OBJECT
+public:
+    explicit QDnsStubResolver(const QList<QHostAddress> &nameServers, quint16 port = 53,
+                              QObject *parent = nullptr);
+    ~QDnsStubResolver();
+
+    static bool canResolve(const QString &name);
+
+    int retransmitInterval() const { return retransmitMsecs; }
+    void setRetransmitInterval(int msecs) { retransmitMsecs = msecs; }
+    int maximumAttempts() const;
+
+public Q_SLOTS:
+    void resolve(const QString &name);
+
+Q_SIGNALS:
+    // timeToLive is in seconds and at most five minutes; -1 means the reply
+    // carried none (negative answers)
+    void resolved(const QString &name, const QHostInfo &info, int timeToLive);
+    void resolutionFailed(const QString &name);
+
+protected:
+    void timerEvent(QTimerEvent *event) override;
+
+private:
+    struct Resolution
+    {
+        QList<QHostAddress> ipv4Addresses;
+        QList<QHostAddress> ipv6Addresses;
+        quint32 timeToLive = std::numeric_limits<quint32>::max();
+        int pendingQueries = 0;
+        bool failed = false;
+    };
+
+    struct Query
+    {
+        QString name;
+        QByteArray message;
+        quint16 type = 0;
+        int attempts = 0;
+        QDeadlineTimer deadline;
+    };
+
+    bool ensureSocket();
+    void readDatagrams();
+    void processReply(const QByteArray &reply, const QHostAddress &sender, quint16 senderPort);
+    void sendQuery(Query &query);
+    void queryFinished(quint16 id, bool failed);
+    void finishResolution(const QString &name);
+
+    QList<QHostAddress> nameServers;
+    QUdpSocket *socket = nullptr;
+    QHash<quint16, Query> queries;              // by message ID
+    QHash<QString, Resolution> resolutions;     // by host name
+    QBasicTimer retransmitTimer;
+    int retransmitMsecs = 1000;
+    quint16 port;
+};
+
+QT_END_NAMESPACE
+
+#endif // QDNSSTUBRESOLVER_P_H
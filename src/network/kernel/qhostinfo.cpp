@@ -53,6 +53,11 @@
 #include <qthread.h>
 #include <qurl.h>
 
+#if QT_CONFIG(dnsresolver)
+#include "private/qdnslookup_p.h"
+#include "private/qdnsstubresolver_p.h"
+#endif
+
 #include <algorithm>
 
 #ifdef Q_OS_UNIX
@@ -228,6 +233,13 @@ bool QHostInfoResult::event(QEvent *event)
     compared to previous versions of Qt.
     \note Since Qt 4.6.3 QHostInfo is using a small internal 60 second DNS cache
     for performance improvements.
+    \note Since Qt 6.3 the cache also remembers for a few seconds that a host
+    was not found. On Unix systems, setting the environment variable
+    \c QT_HOSTINFO_STUB_RESOLVER to \c 1 makes QHostInfo send the DNS queries
+    for fully qualified host names to the system's name servers itself, many
+    at a time, and keep their results for as long as their DNS records
+    allow. Such lookups bypass \c /etc/hosts, search domains and other name
+    services, which is why this is not done by default.
 
     \sa QAbstractSocket, {RFC 3492}, {RFC 6724}
 */
@@ -922,6 +934,14 @@ QHostInfoLookupManager::QHostInfoLookupManager() : wasDeleted(false)
                      Qt::DirectConnection);
     threadPool.setMaxThreadCount(20); // do up to 20 DNS lookups in parallel
 #endif
+#if QT_CONFIG(dnsresolver)
+    resolverThread.setObjectName(QStringLiteral("QHostInfo resolver"));
+    QObject::connect(QCoreApplication::instance(), &QObject::destroyed,
+                     &resolverThread, [&](QObject *) { stopResolver(); },
+                     Qt::DirectConnection);
+    if (qEnvironmentVariableIntValue("QT_HOSTINFO_STUB_RESOLVER") > 0)
+        setNameServers(QDnsLookupRunnable::systemNameServers());
+#endif
 }
 
 QHostInfoLookupManager::~QHostInfoLookupManager()
@@ -932,6 +952,9 @@ QHostInfoLookupManager::~QHostInfoLookupManager()
 
     // don't qDeleteAll currentLookups, the QThreadPool has ownership
     clear();
+#if QT_CONFIG(dnsresolver)
+    stopResolver();
+#endif
 }
 
 void QHostInfoLookupManager::clear()
@@ -946,6 +969,11 @@ void QHostInfoLookupManager::clear()
 #endif
         scheduledLookups.clear();
         finishedLookups.clear();
+#if QT_CONFIG(dnsresolver)
+        for (const QList<QHostInfoRunnable*> &waiting : qAsConst(resolverLookups))
+            qDeleteAll(waiting);
+        resolverLookups.clear();
+#endif
     }
 
 #if QT_CONFIG(thread)
@@ -1020,6 +1048,21 @@ void QHostInfoLookupManager::scheduleLookup(QHostInfoRunnable *r)
     if (wasDeleted)
         return;
 
+#if QT_CONFIG(dnsresolver)
+    if (resolver && QDnsStubResolver::canResolve(r->toBeLookedUp)) {
+        // only the first lookup for a name needs to reach the resolver, the
+        // others wait for the same answer
+        QList<QHostInfoRunnable*> &waiting = resolverLookups[r->toBeLookedUp];
+        waiting.append(r);
+        if (waiting.size() == 1) {
+            QMetaObject::invokeMethod(resolver, [resolver = resolver, name = r->toBeLookedUp] {
+                resolver->resolve(name);
+            }, Qt::QueuedConnection);
+        }
+        return;
+    }
+#endif
+
     scheduledLookups.enqueue(r);
     rescheduleWithMutexHeld();
 }
@@ -1050,6 +1093,21 @@ void QHostInfoLookupManager::abortLookup(int id)
         }
     }
 
+#if QT_CONFIG(dnsresolver)
+    // is waiting for the stub resolver? delete and return
+    for (auto it = resolverLookups.begin(); it != resolverLookups.end(); ++it) {
+        QList<QHostInfoRunnable*> &waiting = it.value();
+        for (int i = 0; i < waiting.length(); i++) {
+            if (waiting.at(i)->id == id) {
+                delete waiting.takeAt(i);
+                if (waiting.isEmpty())
+                    resolverLookups.erase(it);
+                return;
+            }
+        }
+    }
+#endif
+
     if (!abortedLookups.contains(id))
         abortedLookups.append(id);
 }
@@ -1080,6 +1138,96 @@ void QHostInfoLookupManager::lookupFinished(QHostInfoRunnable *r)
     rescheduleWithMutexHeld();
 }
 
+#if QT_CONFIG(dnsresolver)
+void QHostInfoLookupManager::setNameServers(const QList<QHostAddress> &nameServers, quint16 port)
+{
+    stopResolver();
+    if (nameServers.isEmpty())
+        return;
+
+    QMutexLocker locker(&this->mutex);
+    if (wasDeleted)
+        return;
+
+    resolver = new QDnsStubResolver(nameServers, port);
+    resolver->moveToThread(&resolverThread);
+    QObject::connect(&resolverThread, &QThread::finished, resolver, &QObject::deleteLater);
+    // the handlers take the mutex, they are called in the resolver thread
+    QObject::connect(resolver, &QDnsStubResolver::resolved, resolver,
+                     [this](const QString &name, const QHostInfo &info, int timeToLive) {
+        resolverFinished(name, info, timeToLive);
+    }, Qt::DirectConnection);
+    QObject::connect(resolver, &QDnsStubResolver::resolutionFailed, resolver,
+                     [this](const QString &name) { resolverFailed(name); },
+                     Qt::DirectConnection);
+    resolverThread.start();
+}
+
+void QHostInfoLookupManager::stopResolver()
+{
+    {
+        QMutexLocker locker(&this->mutex);
+        if (!resolver)
+            return;
+        resolver = nullptr;
+    }
+
+    // the resolver deletes itself once its thread has finished; it must not be
+    // waited for with the mutex held, as its handlers need it
+    resolverThread.quit();
+    resolverThread.wait();
+
+    // hand the lookups it did not answer to the thread pool
+    QMutexLocker locker(&this->mutex);
+    for (const QList<QHostInfoRunnable*> &waiting : qAsConst(resolverLookups)) {
+        for (QHostInfoRunnable *r : waiting)
+            scheduledLookups.enqueue(r);
+    }
+    resolverLookups.clear();
+    rescheduleWithMutexHeld();
+}
+
+// called in the resolver thread
+void QHostInfoLookupManager::resolverFinished(const QString &name, const QHostInfo &info,
+                                              int timeToLive)
+{
+    QList<QHostInfoRunnable*> waiting;
+    {
+        QMutexLocker locker(&this->mutex);
+        if (wasDeleted)
+            return;
+        waiting = resolverLookups.take(name);
+    }
+
+    if (cache.isEnabled())
+        cache.put(name, info, timeToLive);
+
+    QHostInfo hostInfo = info;
+    for (QHostInfoRunnable *r : qAsConst(waiting)) {
+        if (!wasAborted(r->id)) {
+            hostInfo.setLookupId(r->id);
+            r->resultEmitter.postResultsReady(hostInfo);
+        }
+        lookupFinished(r);
+        delete r;
+    }
+}
+
+// called in the resolver thread
+void QHostInfoLookupManager::resolverFailed(const QString &name)
+{
+    QMutexLocker locker(&this->mutex);
+    if (wasDeleted)
+        return;
+
+    // let the system resolver have a go
+    const QList<QHostInfoRunnable*> waiting = resolverLookups.take(name);
+    for (QHostInfoRunnable *r : waiting)
+        scheduledLookups.enqueue(r);
+    rescheduleWithMutexHeld();
+}
+#endif
+
 // This function returns immediately when we had a result in the cache, else it will later emit a signal
 QHostInfo qt_qhostinfo_lookup(const QString &name, QObject *receiver, const char *member, bool *valid, int *id)
 {
@@ -1127,11 +1275,26 @@ void qt_qhostinfo_cache_inject(const QString &hostname, const QHostInfo &resolut
 
     manager->cache.put(hostname, resolution);
 }
+
+#if QT_CONFIG(dnsresolver)
+void qt_qhostinfo_use_dns_server(const QHostAddress &address, quint16 port)
+{
+    QHostInfoLookupManager* manager = theHostInfoLookupManager();
+    if (!manager)
+        return;
+
+    QList<QHostAddress> nameServers;
+    if (!address.isNull())
+        nameServers.append(address);
+    manager->setNameServers(nameServers, port);
+}
+#endif
 #endif
 
-// cache for 60 seconds
+// cache for 60 seconds, or as long as the DNS records say
+// cache hosts that do not exist for 10 seconds
 // cache 128 items
-QHostInfoCache::QHostInfoCache() : max_age(60), enabled(true), cache(128)
+QHostInfoCache::QHostInfoCache() : max_age(60), negative_max_age(10), enabled(true), cache(128)
 {
 #ifdef QT_QHOSTINFO_CACHE_DISABLED_BY_DEFAULT
     enabled.store(false, std::memory_order_relaxed);
@@ -1144,7 +1307,7 @@ QHostInfo QHostInfoCache::get(const QString &name, bool *valid)
 
     *valid = false;
     if (QHostInfoCacheElement *element = cache.object(name)) {
-        if (element->age.elapsed() < max_age*1000)
+        if (!element->expiry.hasExpired())
             *valid = true;
         return element->info;
 
@@ -1156,16 +1319,29 @@ QHostInfo QHostInfoCache::get(const QString &name, bool *valid)
     return QHostInfo();
 }
 
-void QHostInfoCache::put(const QString &name, const QHostInfo &info)
+void QHostInfoCache::put(const QString &name, const QHostInfo &info, int timeToLive)
 {
-    // if the lookup failed, don't cache
-    if (info.error() != QHostInfo::NoError)
+    // a host that does not exist is remembered briefly, so that repeated
+    // attempts to reach it don't each cost a lookup; if the lookup failed
+    // for any other reason, don't cache
+    switch (info.error()) {
+    case QHostInfo::NoError:
+        if (timeToLive < 0)
+            timeToLive = max_age;
+        break;
+    case QHostInfo::HostNotFound:
+        if (timeToLive < 0)
+            timeToLive = negative_max_age;
+        break;
+    default:
+        return;
+    }
+    if (timeToLive == 0)
         return;
 
     QHostInfoCacheElement* element = new QHostInfoCacheElement();
     element->info = info;
-    element->age = QElapsedTimer();
-    element->age.start();
+    element->expiry = QDeadlineTimer(qint64(timeToLive) * 1000);
 
     QMutexLocker locker(&this->mutex);
     cache.insert(name, element); // cache will take ownership
@@ -67,7 +67,7 @@
 #include "QtCore/qrunnable.h"
 #include "QtCore/qlist.h"
 #include "QtCore/qqueue.h"
-#include <QElapsedTimer>
+#include <QDeadlineTimer>
 #include <QCache>
 
 #include <QSharedPointer>
@@ -76,6 +76,9 @@
 
 QT_BEGIN_NAMESPACE
 
+#if QT_CONFIG(dnsresolver)
+class QDnsStubResolver;
+#endif
 
 class QHostInfoResult : public QObject
 {
@@ -149,15 +152,19 @@ QHostInfo Q_NETWORK_EXPORT qt_qhostinfo_lookup(const QString &name, QObject *rec
 void Q_AUTOTEST_EXPORT qt_qhostinfo_clear_cache();
 void Q_AUTOTEST_EXPORT qt_qhostinfo_enable_cache(bool e);
 void Q_AUTOTEST_EXPORT qt_qhostinfo_cache_inject(const QString &hostname, const QHostInfo &resolution);
+#if QT_CONFIG(dnsresolver)
+void Q_AUTOTEST_EXPORT qt_qhostinfo_use_dns_server(const QHostAddress &address, quint16 port);
+#endif
 
 class QHostInfoCache
 {
 public:
     QHostInfoCache();
     const int max_age; // seconds
+    const int negative_max_age; // seconds
 
     QHostInfo get(const QString &name, bool *valid);
-    void put(const QString &name, const QHostInfo &info);
+    void put(const QString &name, const QHostInfo &info, int timeToLive = -1);
     void clear();
 
     bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
@@ -168,7 +175,7 @@ private:
     std::atomic<bool> enabled;
     struct QHostInfoCacheElement {
         QHostInfo info;
-        QElapsedTimer age;
+        QDeadlineTimer expiry;
     };
     QCache<QString,QHostInfoCacheElement> cache;
     QMutex mutex;
@@ -205,6 +212,11 @@ public:
     void lookupFinished(QHostInfoRunnable *r);
     bool wasAborted(int id);
 
+#if QT_CONFIG(dnsresolver)
+    // an empty list of servers turns the stub resolver off
+    void setNameServers(const QList<QHostAddress> &nameServers, quint16 port = 53);
+#endif
+
     QHostInfoCache cache;
 
     friend class QHostInfoRunnable;
@@ -224,8 +236,20 @@ protected:
 
     bool wasDeleted;
 
+#if QT_CONFIG(dnsresolver)
+    // lookups waiting for the stub resolver, by host name
+    QHash<QString, QList<QHostInfoRunnable*>> resolverLookups;
+    QThread resolverThread;
+    QDnsStubResolver *resolver = nullptr;
+#endif
+
 private:
     void rescheduleWithMutexHeld();
+#if QT_CONFIG(dnsresolver)
+    void stopResolver();
+    void resolverFinished(const QString &name, const QHostInfo &info, int timeToLive);
+    void resolverFailed(const QString &name);
+#endif
 };
 
 QT_END_NAMESPACE
@@ -476,6 +476,7 @@
 #include <qpointer.h>
 #include <qtimer.h>
 #include <qelapsedtimer.h>
+#include <qfile.h>
 #include <qscopedvaluerollback.h>
 #include <qvarlengtharray.h>
 
@@ -540,7 +541,10 @@ QAbstractSocketPrivate::QAbstractSocketPrivate()
       socketType(QAbstractSocket::UnknownSocketType),
       state(QAbstractSocket::UnconnectedState),
       socketError(QAbstractSocket::UnknownSocketError),
-      preferredNetworkLayerProtocol(QAbstractSocket::UnknownNetworkLayerProtocol)
+      preferredNetworkLayerProtocol(QAbstractSocket::UnknownNetworkLayerProtocol),
+      sendFileOffset(0),
+      sendFileRemaining(0),
+      sendFileBufferedBefore(0)
 {
     writeBufferChunkSize = QABSTRACTSOCKET_BUFFERSIZE;
 }
@@ -565,6 +569,9 @@ void QAbstractSocketPrivate::resetSocketLayer()
 #endif
 
     hasPendingData = false;
+    sendFileDevice = nullptr;
+    sendFileRemaining = 0;
+    sendFileBufferedBefore = 0;
     if (socketEngine) {
         socketEngine->close();
         socketEngine->disconnect();
@@ -781,7 +788,8 @@ void QAbstractSocketPrivate::connectionNotification()
 
 /*! \internal
 
-    Writes one pending data block in the write buffer to the socket.
+    Writes one pending data block in the write buffer, or the next part of
+    the file passed to sendFile(), to the socket.
 
     It is usually invoked by canWriteNotification after one or more
     calls to write().
@@ -792,7 +800,7 @@ bool QAbstractSocketPrivate::writeToSocket()
 {
     Q_Q(QAbstractSocket);
     if (!socketEngine || !socketEngine->isValid() || (writeBuffer.isEmpty()
-        && socketEngine->bytesToWrite() == 0)) {
+        && sendFileRemaining == 0 && socketEngine->bytesToWrite() == 0)) {
 #if defined (QABSTRACTSOCKET_DEBUG)
     qDebug("QAbstractSocketPrivate::writeToSocket() nothing to do: valid ? %s, writeBuffer.isEmpty() ? %s",
            (socketEngine && socketEngine->isValid()) ? "yes" : "no", writeBuffer.isEmpty() ? "yes" : "no");
@@ -809,17 +817,28 @@ bool QAbstractSocketPrivate::writeToSocket()
         return false;
     }
 
-    qint64 nextSize = writeBuffer.nextDataBlockSize();
-    const char *ptr = writeBuffer.readPointer();
+    // Data written before sendFile() was called goes out ahead of the file.
+    const bool sendingFile = sendFileRemaining > 0 && sendFileBufferedBefore == 0;
+    qint64 written;
+    if (sendingFile) {
+        written = sendFileToSocket();
+    } else {
+        qint64 nextSize = writeBuffer.nextDataBlockSize();
+        if (sendFileRemaining > 0)
+            nextSize = qMin(nextSize, sendFileBufferedBefore);
+        const char *ptr = writeBuffer.readPointer();
 
-    // Attempt to write it all in one chunk.
-    qint64 written = nextSize ? socketEngine->write(ptr, nextSize) : Q_INT64_C(0);
+        // Attempt to write it all in one chunk.
+        written = nextSize ? socketEngine->write(ptr, nextSize) : Q_INT64_C(0);
+    }
     if (written < 0) {
 #if defined (QABSTRACTSOCKET_DEBUG)
         qDebug() << "QAbstractSocketPrivate::writeToSocket() write error, aborting."
                  << socketEngine->errorString();
 #endif
-        setErrorAndEmit(socketEngine->error(), socketEngine->errorString());
+        // sendFileToSocket() has already reported its error.
+        if (!sendingFile)
+            setErrorAndEmit(socketEngine->error(), socketEngine->errorString());
         // an unexpected error so close the socket.
         q->abort();
         return false;
@@ -832,20 +851,58 @@ bool QAbstractSocketPrivate::writeToSocket()
 
     if (written > 0) {
         // Remove what we wrote so far.
-        writeBuffer.free(written);
+        if (sendingFile) {
+            sendFileOffset += written;
+            sendFileRemaining -= written;
+            if (sendFileRemaining == 0)
+                sendFileDevice = nullptr;
+        } else {
+            writeBuffer.free(written);
+            if (sendFileRemaining > 0)
+                sendFileBufferedBefore -= written;
+        }
 
         // Emit notifications.
         emitBytesWritten(written);
     }
 
-    if (writeBuffer.isEmpty() && socketEngine && !socketEngine->bytesToWrite())
+    if (writeBuffer.isEmpty() && sendFileRemaining == 0 && socketEngine
+        && !socketEngine->bytesToWrite()) {
         socketEngine->setWriteNotificationEnabled(false);
+    }
     if (state == QAbstractSocket::ClosingState)
         q->disconnectFromHost();
 
     return written > 0;
 }
 
+/*! \internal
+
+    Sends the next part of the file passed to sendFile() directly from the
+    file to the socket. Returns the number of bytes sent, or -1 after
+    setting the error if the file could not be sent.
+*/
+qint64 QAbstractSocketPrivate::sendFileToSocket()
+{
+    if (!sendFileDevice || sendFileDevice->handle() == -1) {
+        setErrorAndEmit(QAbstractSocket::UnknownSocketError,
+                        QAbstractSocket::tr("File closed before it was sent"));
+        return -1;
+    }
+
+    const qint64 sent = socketEngine->sendFile(sendFileDevice->handle(), sendFileOffset,
+                                               sendFileRemaining);
+    if (sent < 0) {
+        setErrorAndEmit(socketEngine->error(), socketEngine->errorString());
+    } else if (sent == 0 && sendFileDevice->size() < sendFileOffset + sendFileRemaining) {
+        // sendfile() reports end of file in the same way as a full socket buffer.
+        setErrorAndEmit(QAbstractSocket::UnknownSocketError,
+                        QAbstractSocket::tr("File truncated while it was being sent"));
+        return -1;
+    }
+    return sent;
+}
+
 /*! \internal
 
     Writes pending data in the write buffers to the socket. The function
@@ -856,7 +913,7 @@ bool QAbstractSocketPrivate::flush()
 {
     bool dataWasWritten = false;
 
-    while (!allWriteBuffersEmpty() && writeToSocket())
+    while ((!allWriteBuffersEmpty() || sendFileRemaining > 0) && writeToSocket())
         dataWasWritten = true;
 
     return dataWasWritten;
@@ -1754,7 +1811,7 @@ void QAbstractSocket::connectToHost(const QHostAddress &address, quint16 port,
 */
 qint64 QAbstractSocket::bytesToWrite() const
 {
-    const qint64 pendingBytes = QIODevice::bytesToWrite();
+    const qint64 pendingBytes = QIODevice::bytesToWrite() + d_func()->sendFileRemaining;
 #if defined(QABSTRACTSOCKET_DEBUG)
     qDebug("QAbstractSocket::bytesToWrite() == %lld", pendingBytes);
 #endif
@@ -2181,7 +2238,8 @@ bool QAbstractSocket::waitForReadyRead(int msecs)
 
         bool readyToRead = false;
         bool readyToWrite = false;
-        if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, true, !d->writeBuffer.isEmpty(),
+        if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, true,
+                                                 !d->writeBuffer.isEmpty() || d->sendFileRemaining > 0,
                                                qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
 #if defined (QABSTRACTSOCKET_DEBUG)
             qDebug("QAbstractSocket::waitForReadyRead(%i) failed (%i, %s)",
@@ -2233,7 +2291,7 @@ bool QAbstractSocket::waitForBytesWritten(int msecs)
         return false;
     }
 
-    if (d->writeBuffer.isEmpty())
+    if (d->writeBuffer.isEmpty() && d->sendFileRemaining == 0)
         return false;
 
     QElapsedTimer stopWatch;
@@ -2250,7 +2308,7 @@ bool QAbstractSocket::waitForBytesWritten(int msecs)
         bool readyToWrite = false;
         if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite,
                                   !d->readBufferMaxSize || d->buffer.size() < d->readBufferMaxSize,
-                                  !d->writeBuffer.isEmpty(),
+                                  !d->writeBuffer.isEmpty() || d->sendFileRemaining > 0,
                                   qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
 #if defined (QABSTRACTSOCKET_DEBUG)
             qDebug("QAbstractSocket::waitForBytesWritten(%i) failed (%i, %s)",
@@ -2330,7 +2388,7 @@ bool QAbstractSocket::waitForDisconnected(int msecs)
         bool readyToRead = false;
         bool readyToWrite = false;
         if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, state() == ConnectedState,
-                                               !d->writeBuffer.isEmpty(),
+                                               !d->writeBuffer.isEmpty() || d->sendFileRemaining > 0,
                                                qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
 #if defined (QABSTRACTSOCKET_DEBUG)
             qDebug("QAbstractSocket::waitForReadyRead(%i) failed (%i, %s)",
@@ -2397,6 +2455,81 @@ bool QAbstractSocket::flush()
     return d_func()->flush();
 }
 
+/*!
+    \since 6.3
+
+    Queues \a length bytes of \a file, starting at \a offset, to be sent
+    after any data already written to the socket. If \a length is -1, the
+    file is sent up to its end. Returns \c true if the data was queued;
+    otherwise returns \c false.
+
+    Where the platform allows it (sendfile() on Linux), the data is sent
+    directly from the file to the network when control returns to the event
+    loop, without being copied into the socket's write buffer. The
+    bytesWritten() signal reports the progress, and bytesToWrite() includes
+    the part of the file that has not been sent yet. The file must stay open
+    until bytesToWrite() returns 0. Data written with write() while the
+    transfer is in progress is sent after the file.
+
+    Encrypted and proxied sockets, and platforms without such support, fall
+    back to reading the file and writing its contents to the socket as if
+    write() had been called; the file's position is preserved.
+
+    Only one file can be queued at a time. The socket must be a connected
+    TCP socket, and \a file must be open for reading and must not be
+    sequential.
+
+    \sa bytesToWrite(), bytesWritten()
+*/
+bool QAbstractSocket::sendFile(QFile *file, qint64 offset, qint64 length)
+{
+    Q_D(QAbstractSocket);
+    if (d->state != ConnectedState || d->socketType != TcpSocket) {
+        qWarning("QAbstractSocket::sendFile() is only allowed on a connected TCP socket");
+        return false;
+    }
+    if (!file || !file->isReadable() || file->isSequential()) {
+        qWarning("QAbstractSocket::sendFile() requires a seekable file that is open for reading");
+        return false;
+    }
+    if (d->sendFileRemaining > 0) {
+        qWarning("QAbstractSocket::sendFile() called while another file is being sent");
+        return false;
+    }
+
+    const qint64 fileSize = file->size();
+    if (offset < 0 || offset > fileSize || length < -1 || length > fileSize - offset) {
+        qWarning("QAbstractSocket::sendFile() called with a range outside of the file");
+        return false;
+    }
+    if (length == -1)
+        length = fileSize - offset;
+    if (length == 0)
+        return true;
+
+    if (d->socketEngine && d->socketEngine->supportsSendFile() && file->handle() != -1) {
+        d->sendFileDevice = file;
+        d->sendFileOffset = offset;
+        d->sendFileRemaining = length;
+        d->sendFileBufferedBefore = d->writeBuffer.size();
+        d->socketEngine->setWriteNotificationEnabled(true);
+        return true;
+    }
+
+    // No direct path (TLS, proxy or unsupported platform): copy the data.
+    constexpr qint64 ChunkSize = 64 * 1024;
+    const qint64 originalPosition = file->pos();
+    bool ok = file->seek(offset);
+    QByteArray chunk;
+    while (ok && length > 0) {
+        chunk = file->read(qMin(length, ChunkSize));
+        ok = !chunk.isEmpty() && write(chunk) == chunk.size();
+        length -= chunk.size();
+    }
+    file->seek(originalPosition);
+    return ok;
+}
+
 /*! \reimp
 */
 qint64 QAbstractSocket::readData(char *data, qint64 maxSize)
@@ -2449,7 +2582,7 @@ qint64 QAbstractSocket::writeData(const char *data, qint64 size)
     }
 
     if (!d->isBuffered && d->socketType == TcpSocket
-        && d->socketEngine && d->writeBuffer.isEmpty()) {
+        && d->socketEngine && d->writeBuffer.isEmpty() && d->sendFileRemaining == 0) {
         // This code is for the new Unbuffered QTcpSocket use case
         qint64 written = size ? d->socketEngine->write(data, size) : Q_INT64_C(0);
         if (written < 0) {
@@ -2677,7 +2810,7 @@ void QAbstractSocket::disconnectFromHost()
 
         // Wait for pending data to be written.
         if (d->socketEngine && d->socketEngine->isValid() && (!d->allWriteBuffersEmpty()
-            || d->socketEngine->bytesToWrite() > 0)) {
+            || d->sendFileRemaining > 0 || d->socketEngine->bytesToWrite() > 0)) {
             d->socketEngine->setWriteNotificationEnabled(true);
 
 #if defined(QABSTRACTSOCKET_DEBUG)
@@ -57,6 +57,7 @@ QT_BEGIN_NAMESPACE
 
 
 class QHostAddress;
+class QFile;
 #ifndef QT_NO_NETWORKPROXY
 class QNetworkProxy;
 #endif
@@ -209,6 +210,7 @@ public:
     void close() override;
     bool isSequential() const override;
     bool flush();
+    bool sendFile(QFile *file, qint64 offset = 0, qint64 length = -1);
 
     // for synchronous access
     virtual bool waitForConnected(int msecs = 30000);
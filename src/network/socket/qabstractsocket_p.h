@@ -55,6 +55,7 @@
 #include "QtNetwork/qabstractsocket.h"
 #include "QtCore/qbytearray.h"
 #include "QtCore/qlist.h"
+#include "QtCore/qpointer.h"
 #include "QtCore/qtimer.h"
 #include "private/qiodevice_p.h"
 #include "private/qabstractsocketengine_p.h"
@@ -63,6 +64,7 @@
 QT_BEGIN_NAMESPACE
 
 class QHostInfo;
+class QFile;
 
 class QAbstractSocketPrivate : public QIODevicePrivate, public QAbstractSocketEngineReceiver
 {
@@ -137,6 +139,7 @@ public:
     void fetchConnectionParameters();
     bool readFromSocket();
     virtual bool writeToSocket();
+    qint64 sendFileToSocket();
     void emitReadyRead(int channel = 0);
     void emitBytesWritten(qint64 bytes, int channel = 0);
 
@@ -159,6 +162,13 @@ public:
 
     QAbstractSocket::NetworkLayerProtocol preferredNetworkLayerProtocol;
 
+    // File being sent with sendFile(); it follows the first
+    // sendFileBufferedBefore bytes of the write buffer.
+    QPointer<QFile> sendFileDevice;
+    qint64 sendFileOffset;
+    qint64 sendFileRemaining;
+    qint64 sendFileBufferedBefore;
+
     bool prePauseReadSocketNotifierState;
     bool prePauseWriteSocketNotifierState;
     bool prePauseExceptionSocketNotifierState;
@@ -128,6 +128,83 @@ QAbstractSocketEngine *QAbstractSocketEngine::createSocketEngine(qintptr socketD
     return new QNativeSocketEngine(parent);
 }
 
+/*!
+    Reads up to \a count datagrams into \a buffers. Each buffer's size is
+    the maximum number of bytes to read into it; on return it holds the size
+    of the datagram that was read. Returns the number of datagrams read,
+    which is 0 if none was available, or -1 if an error occurred before any
+    datagram could be read.
+
+    The default implementation calls readDatagram() once per datagram;
+    engines that can receive several datagrams per system call override it.
+*/
+qsizetype QAbstractSocketEngine::readDatagrams(DatagramBuffer *buffers, qsizetype count,
+                                                PacketHeaderOptions options)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+#ifndef QT_NO_UDPSOCKET
+        if (i > 0 && !hasPendingDatagrams())
+            return i;
+#endif
+        const qint64 readBytes = readDatagram(buffers[i].data, buffers[i].size, buffers[i].header,
+                                              options);
+        if (readBytes < 0)
+            return i ? i : (readBytes == -2 ? 0 : -1);
+        buffers[i].size = readBytes;
+    }
+    return count;
+}
+
+/*!
+    Writes the \a count datagrams described by \a buffers, in order, and
+    returns the number of datagrams written. Returns 0 if the first datagram
+    could not be written without blocking, or -1 if writing it failed.
+
+    The default implementation calls writeDatagram() once per datagram;
+    engines that can send several datagrams per system call override it.
+*/
+qsizetype QAbstractSocketEngine::writeDatagrams(const DatagramBuffer *buffers, qsizetype count)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        const qint64 sent = writeDatagram(buffers[i].data, buffers[i].size, *buffers[i].header);
+        if (sent < 0)
+            return i ? i : (sent == -2 ? 0 : -1);
+    }
+    return count;
+}
+
+/*!
+    Returns \c true if this engine can send the contents of a file directly
+    with sendFile(), without copying them through a user-space buffer.
+
+    The default implementation returns \c false.
+*/
+bool QAbstractSocketEngine::supportsSendFile() const
+{
+    return false;
+}
+
+/*!
+    Sends up to \a length bytes, starting at \a offset, of the file opened
+    as \a fileDescriptor. Returns the number of bytes sent, which is 0 if
+    the socket cannot accept more data without blocking, or -1 if an error
+    occurred.
+
+    The default implementation sets UnsupportedSocketOperationError and
+    returns -1.
+
+    \sa supportsSendFile()
+*/
+qint64 QAbstractSocketEngine::sendFile(qintptr fileDescriptor, qint64 offset, qint64 length)
+{
+    Q_UNUSED(fileDescriptor);
+    Q_UNUSED(offset);
+    Q_UNUSED(length);
+    setError(QAbstractSocket::UnsupportedSocketOperationError,
+             QAbstractSocketEngine::tr("Unsupported socket operation"));
+    return -1;
+}
+
 QAbstractSocket::SocketError QAbstractSocketEngine::error() const
 {
     return d_func()->socketError;
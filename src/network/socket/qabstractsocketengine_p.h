@@ -107,7 +107,8 @@ public:
         ReceivePacketInformation,
         ReceiveHopLimit,
         MaxStreamsSocketOption,
-        PathMtuInformation
+        PathMtuInformation,
+        PortReusable
     };
 
     enum PacketHeaderOption {
@@ -122,6 +123,12 @@ public:
     };
     Q_DECLARE_FLAGS(PacketHeaderOptions, PacketHeaderOption)
 
+    struct DatagramBuffer {
+        char *data;
+        qint64 size;
+        QIpPacketHeader *header;
+    };
+
     virtual bool initialize(QAbstractSocket::SocketType type, QAbstractSocket::NetworkLayerProtocol protocol = QAbstractSocket::IPv4Protocol) = 0;
 
     virtual bool initialize(qintptr socketDescriptor, QAbstractSocket::SocketState socketState = QAbstractSocket::ConnectedState) = 0;
@@ -159,6 +166,11 @@ public:
     virtual qint64 readDatagram(char *data, qint64 maxlen, QIpPacketHeader *header = nullptr,
                                 PacketHeaderOptions = WantNone) = 0;
     virtual qint64 writeDatagram(const char *data, qint64 len, const QIpPacketHeader &header) = 0;
+    virtual qsizetype readDatagrams(DatagramBuffer *buffers, qsizetype count,
+                                    PacketHeaderOptions options = WantNone);
+    virtual qsizetype writeDatagrams(const DatagramBuffer *buffers, qsizetype count);
+    virtual bool supportsSendFile() const;
+    virtual qint64 sendFile(qintptr fileDescriptor, qint64 offset, qint64 length);
     virtual qint64 bytesToWrite() const = 0;
 
     virtual int option(SocketOption option) const = 0;
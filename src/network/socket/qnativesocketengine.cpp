@@ -900,6 +900,51 @@ qint64 QNativeSocketEngine::writeDatagram(const char *data, qint64 size, const Q
     return d->nativeSendDatagram(data, size, header);
 }
 
+/*!
+    Reads up to \a count datagrams into \a buffers and returns the number
+    of datagrams read, or -1 if an error occurred. Where the platform
+    supports it (recvmmsg() on Linux), all datagrams are received with a
+    single system call.
+
+    \sa QAbstractSocketEngine::readDatagrams()
+*/
+qsizetype QNativeSocketEngine::readDatagrams(DatagramBuffer *buffers, qsizetype count,
+                                             PacketHeaderOptions options)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::readDatagrams(), -1);
+    Q_CHECK_STATES(QNativeSocketEngine::readDatagrams(), QAbstractSocket::BoundState,
+                   QAbstractSocket::ConnectedState, -1);
+
+#if QT_CONFIG(sendmmsg)
+    return d->nativeReceiveDatagrams(buffers, count, options);
+#else
+    return QAbstractSocketEngine::readDatagrams(buffers, count, options);
+#endif
+}
+
+/*!
+    Writes the \a count datagrams described by \a buffers and returns the
+    number of datagrams written, or -1 if an error occurred. Where the
+    platform supports it (sendmmsg() on Linux), all datagrams are sent with a
+    single system call.
+
+    \sa QAbstractSocketEngine::writeDatagrams()
+*/
+qsizetype QNativeSocketEngine::writeDatagrams(const DatagramBuffer *buffers, qsizetype count)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::writeDatagrams(), -1);
+    Q_CHECK_STATES(QNativeSocketEngine::writeDatagrams(), QAbstractSocket::BoundState,
+                   QAbstractSocket::ConnectedState, -1);
+
+#if QT_CONFIG(sendmmsg)
+    return d->nativeSendDatagrams(buffers, count);
+#else
+    return QAbstractSocketEngine::writeDatagrams(buffers, count);
+#endif
+}
+
 /*!
     Writes a block of \a size bytes from \a data to the socket.
     Returns the number of bytes written, or -1 if an error occurred.
@@ -916,6 +961,38 @@ qint64 QNativeSocketEngine::write(const char *data, qint64 size)
     return d->nativeWrite(data, size);
 }
 
+/*!
+    Returns \c true if the platform can send file contents directly to the
+    socket (sendfile() on Linux).
+*/
+bool QNativeSocketEngine::supportsSendFile() const
+{
+#if QT_CONFIG(sendfile)
+    return true;
+#else
+    return false;
+#endif
+}
+
+/*!
+    Sends up to \a length bytes, starting at \a offset, of the file opened
+    as \a fileDescriptor to the connected peer without copying them through
+    user space. Returns the number of bytes sent, which is 0 if the socket
+    buffer is full, or -1 if an error occurred.
+*/
+qint64 QNativeSocketEngine::sendFile(qintptr fileDescriptor, qint64 offset, qint64 length)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::sendFile(), -1);
+    Q_CHECK_TYPE(QNativeSocketEngine::sendFile(), QAbstractSocket::TcpSocket, -1);
+    Q_CHECK_STATE(QNativeSocketEngine::sendFile(), QAbstractSocket::ConnectedState, -1);
+
+#if QT_CONFIG(sendfile)
+    return d->nativeSendFile(fileDescriptor, offset, length);
+#else
+    return QAbstractSocketEngine::sendFile(fileDescriptor, offset, length);
+#endif
+}
 
 qint64 QNativeSocketEngine::bytesToWrite() const
 {
@@ -164,6 +164,11 @@ public:
     qint64 readDatagram(char *data, qint64 maxlen, QIpPacketHeader * = nullptr,
                         PacketHeaderOptions = WantNone) override;
     qint64 writeDatagram(const char *data, qint64 len, const QIpPacketHeader &) override;
+    qsizetype readDatagrams(DatagramBuffer *buffers, qsizetype count,
+                            PacketHeaderOptions options = WantNone) override;
+    qsizetype writeDatagrams(const DatagramBuffer *buffers, qsizetype count) override;
+    bool supportsSendFile() const override;
+    qint64 sendFile(qintptr fileDescriptor, qint64 offset, qint64 length) override;
     qint64 bytesToWrite() const override;
 
 #if 0   // currently unused
@@ -277,8 +282,16 @@ public:
     qint64 nativeReceiveDatagram(char *data, qint64 maxLength, QIpPacketHeader *header,
                                  QAbstractSocketEngine::PacketHeaderOptions options);
     qint64 nativeSendDatagram(const char *data, qint64 length, const QIpPacketHeader &header);
+#if QT_CONFIG(sendmmsg)
+    qsizetype nativeReceiveDatagrams(QAbstractSocketEngine::DatagramBuffer *buffers, qsizetype count,
+                                     QAbstractSocketEngine::PacketHeaderOptions options);
+    qsizetype nativeSendDatagrams(const QAbstractSocketEngine::DatagramBuffer *buffers, qsizetype count);
+#endif
     qint64 nativeRead(char *data, qint64 maxLength);
     qint64 nativeWrite(const char *data, qint64 length);
+#if QT_CONFIG(sendfile)
+    qint64 nativeSendFile(qintptr fileDescriptor, qint64 offset, qint64 length);
+#endif
     int nativeSelect(int timeout, bool selectForRead) const;
     int nativeSelect(int timeout, bool checkRead, bool checkWrite,
                      bool *selectForRead, bool *selectForWrite) const;
@@ -67,6 +67,9 @@
 #endif
 
 #include <netinet/tcp.h>
+#if QT_CONFIG(sendfile)
+#include <sys/sendfile.h>
+#endif
 #ifndef QT_NO_SCTP
 #include <sys/types.h>
 #include <sys/socket.h>
@@ -207,6 +210,14 @@ static void convertToLevelAndOption(QNativeSocketEngine::SocketOption opt,
 #endif
         }
         break;
+
+    case QNativeSocketEngine::PortReusable:
+        // Only Linux distributes incoming connections among all the sockets
+        // bound with SO_REUSEPORT; elsewhere the last one gets them all.
+#if defined(SO_REUSEPORT) && defined(Q_OS_LINUX)
+        n = SO_REUSEPORT;
+#endif
+        break;
     }
 }
 
@@ -904,18 +915,173 @@ qint64 QNativeSocketEnginePrivate::nativePendingDatagramSize() const
     return qint64(recvResult);
 }
 
-qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxSize, QIpPacketHeader *header,
-                                                         QAbstractSocketEngine::PacketHeaderOptions options)
-{
-    // we use quintptr to force the alignment
-    quintptr cbuf[(CMSG_SPACE(sizeof(struct in6_pktinfo)) + CMSG_SPACE(sizeof(int))
+// we use quintptr to force the alignment
+static constexpr size_t ReceiveControlBufferLength =
+        (CMSG_SPACE(sizeof(struct in6_pktinfo)) + CMSG_SPACE(sizeof(int))
 #if !defined(IP_PKTINFO) && defined(IP_RECVIF) && defined(Q_OS_BSD4)
-                   + CMSG_SPACE(sizeof(sockaddr_dl))
+         + CMSG_SPACE(sizeof(sockaddr_dl))
+#endif
+#ifndef QT_NO_SCTP
+         + CMSG_SPACE(sizeof(struct sctp_sndrcvinfo))
 #endif
+         + sizeof(quintptr) - 1) / sizeof(quintptr);
+
+static constexpr size_t SendControlBufferLength =
+        (CMSG_SPACE(sizeof(struct in6_pktinfo)) + CMSG_SPACE(sizeof(int))
 #ifndef QT_NO_SCTP
-                   + CMSG_SPACE(sizeof(struct sctp_sndrcvinfo))
+         + CMSG_SPACE(sizeof(struct sctp_sndrcvinfo))
 #endif
-                   + sizeof(quintptr) - 1) / sizeof(quintptr)];
+         + sizeof(quintptr) - 1) / sizeof(quintptr);
+
+static void qt_parseDatagramHeader(struct msghdr *msg, const qt_sockaddr *aa, quint16 localPort,
+                                   QIpPacketHeader *header)
+{
+    qt_socket_getPortAndAddress(aa, &header->senderPort, &header->senderAddress);
+    header->destinationPort = localPort;
+    header->endOfRecord = (msg->msg_flags & MSG_EOR) != 0;
+
+    // parse the ancillary data
+    struct cmsghdr *cmsgptr;
+    QT_WARNING_PUSH
+    QT_WARNING_DISABLE_CLANG("-Wsign-compare")
+    for (cmsgptr = CMSG_FIRSTHDR(msg); cmsgptr != nullptr;
+         cmsgptr = CMSG_NXTHDR(msg, cmsgptr)) {
+        QT_WARNING_POP
+        if (cmsgptr->cmsg_level == IPPROTO_IPV6 && cmsgptr->cmsg_type == IPV6_PKTINFO
+                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in6_pktinfo))) {
+            in6_pktinfo *info = reinterpret_cast<in6_pktinfo *>(CMSG_DATA(cmsgptr));
+
+            header->destinationAddress.setAddress(reinterpret_cast<quint8 *>(&info->ipi6_addr));
+            header->ifindex = info->ipi6_ifindex;
+            if (header->ifindex)
+                header->destinationAddress.setScopeId(QString::number(info->ipi6_ifindex));
+        }
+
+#ifdef IP_PKTINFO
+        if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_PKTINFO
+                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in_pktinfo))) {
+            in_pktinfo *info = reinterpret_cast<in_pktinfo *>(CMSG_DATA(cmsgptr));
+
+            header->destinationAddress.setAddress(ntohl(info->ipi_addr.s_addr));
+            header->ifindex = info->ipi_ifindex;
+        }
+#else
+#  ifdef IP_RECVDSTADDR
+        if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_RECVDSTADDR
+                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in_addr))) {
+            in_addr *addr = reinterpret_cast<in_addr *>(CMSG_DATA(cmsgptr));
+
+            header->destinationAddress.setAddress(ntohl(addr->s_addr));
+        }
+#  endif
+#  if defined(IP_RECVIF) && defined(Q_OS_BSD4)
+        if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_RECVIF
+                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(sockaddr_dl))) {
+            sockaddr_dl *sdl = reinterpret_cast<sockaddr_dl *>(CMSG_DATA(cmsgptr));
+            header->ifindex = sdl->sdl_index;
+        }
+#  endif
+#endif
+
+        if (cmsgptr->cmsg_len == CMSG_LEN(sizeof(int))
+                && ((cmsgptr->cmsg_level == IPPROTO_IPV6 && cmsgptr->cmsg_type == IPV6_HOPLIMIT)
+                    || (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_TTL))) {
+            static_assert(sizeof(header->hopLimit) == sizeof(int));
+            memcpy(&header->hopLimit, CMSG_DATA(cmsgptr), sizeof(header->hopLimit));
+        }
+
+#ifndef QT_NO_SCTP
+        if (cmsgptr->cmsg_level == IPPROTO_SCTP && cmsgptr->cmsg_type == SCTP_SNDRCV
+            && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(sctp_sndrcvinfo))) {
+            sctp_sndrcvinfo *rcvInfo = reinterpret_cast<sctp_sndrcvinfo *>(CMSG_DATA(cmsgptr));
+
+            header->streamNumber = int(rcvInfo->sinfo_stream);
+        }
+#endif
+    }
+}
+
+// Fills the control buffer that msg->msg_control points to with the options
+// from header; msg->msg_name must already hold the destination address.
+static void qt_buildDatagramControl(struct msghdr *msg, const QIpPacketHeader &header)
+{
+    struct cmsghdr *cmsgptr = reinterpret_cast<struct cmsghdr *>(msg->msg_control);
+    msg->msg_controllen = 0;
+
+    if (msg->msg_namelen == sizeof(sockaddr_in6)) {
+        if (header.hopLimit != -1) {
+            msg->msg_controllen += CMSG_SPACE(sizeof(int));
+            cmsgptr->cmsg_len = CMSG_LEN(sizeof(int));
+            cmsgptr->cmsg_level = IPPROTO_IPV6;
+            cmsgptr->cmsg_type = IPV6_HOPLIMIT;
+            memcpy(CMSG_DATA(cmsgptr), &header.hopLimit, sizeof(int));
+            cmsgptr = reinterpret_cast<cmsghdr *>(reinterpret_cast<char *>(cmsgptr) + CMSG_SPACE(sizeof(int)));
+        }
+        if (header.ifindex != 0 || !header.senderAddress.isNull()) {
+            struct in6_pktinfo *data = reinterpret_cast<in6_pktinfo *>(CMSG_DATA(cmsgptr));
+            memset(data, 0, sizeof(*data));
+            msg->msg_controllen += CMSG_SPACE(sizeof(*data));
+            cmsgptr->cmsg_len = CMSG_LEN(sizeof(*data));
+            cmsgptr->cmsg_level = IPPROTO_IPV6;
+            cmsgptr->cmsg_type = IPV6_PKTINFO;
+            data->ipi6_ifindex = header.ifindex;
+
+            QIPv6Address tmp = header.senderAddress.toIPv6Address();
+            memcpy(&data->ipi6_addr, &tmp, sizeof(tmp));
+            cmsgptr = reinterpret_cast<cmsghdr *>(reinterpret_cast<char *>(cmsgptr) + CMSG_SPACE(sizeof(*data)));
+        }
+    } else {
+        if (header.hopLimit != -1) {
+            msg->msg_controllen += CMSG_SPACE(sizeof(int));
+            cmsgptr->cmsg_len = CMSG_LEN(sizeof(int));
+            cmsgptr->cmsg_level = IPPROTO_IP;
+            cmsgptr->cmsg_type = IP_TTL;
+            memcpy(CMSG_DATA(cmsgptr), &header.hopLimit, sizeof(int));
+            cmsgptr = reinterpret_cast<cmsghdr *>(reinterpret_cast<char *>(cmsgptr) + CMSG_SPACE(sizeof(int)));
+        }
+
+#if defined(IP_PKTINFO) || defined(IP_SENDSRCADDR)
+        if (header.ifindex != 0 || !header.senderAddress.isNull()) {
+#  ifdef IP_PKTINFO
+            struct in_pktinfo *data = reinterpret_cast<in_pktinfo *>(CMSG_DATA(cmsgptr));
+            memset(data, 0, sizeof(*data));
+            cmsgptr->cmsg_type = IP_PKTINFO;
+            data->ipi_ifindex = header.ifindex;
+            data->ipi_addr.s_addr = htonl(header.senderAddress.toIPv4Address());
+#  elif defined(IP_SENDSRCADDR)
+            struct in_addr *data = reinterpret_cast<in_addr *>(CMSG_DATA(cmsgptr));
+            cmsgptr->cmsg_type = IP_SENDSRCADDR;
+            data->s_addr = htonl(header.senderAddress.toIPv4Address());
+#  endif
+            cmsgptr->cmsg_level = IPPROTO_IP;
+            msg->msg_controllen += CMSG_SPACE(sizeof(*data));
+            cmsgptr->cmsg_len = CMSG_LEN(sizeof(*data));
+            cmsgptr = reinterpret_cast<cmsghdr *>(reinterpret_cast<char *>(cmsgptr) + CMSG_SPACE(sizeof(*data)));
+        }
+#endif
+    }
+
+#ifndef QT_NO_SCTP
+    if (header.streamNumber != -1) {
+        struct sctp_sndrcvinfo *data = reinterpret_cast<sctp_sndrcvinfo *>(CMSG_DATA(cmsgptr));
+        memset(data, 0, sizeof(*data));
+        msg->msg_controllen += CMSG_SPACE(sizeof(sctp_sndrcvinfo));
+        cmsgptr->cmsg_len = CMSG_LEN(sizeof(sctp_sndrcvinfo));
+        cmsgptr->cmsg_level = IPPROTO_SCTP;
+        cmsgptr->cmsg_type =  SCTP_SNDRCV;
+        data->sinfo_stream = uint16_t(header.streamNumber);
+        cmsgptr = reinterpret_cast<cmsghdr *>(reinterpret_cast<char *>(cmsgptr) + CMSG_SPACE(sizeof(*data)));
+    }
+#endif
+
+    if (msg->msg_controllen == 0)
+        msg->msg_control = nullptr;
+}
+
+qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxSize, QIpPacketHeader *header,
+                                                         QAbstractSocketEngine::PacketHeaderOptions options)
+{
+    quintptr cbuf[ReceiveControlBufferLength];
 
     struct msghdr msg;
     struct iovec vec;
@@ -963,69 +1129,7 @@ qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxS
             header->clear();
     } else if (options != QAbstractSocketEngine::WantNone) {
         Q_ASSERT(header);
-        qt_socket_getPortAndAddress(&aa, &header->senderPort, &header->senderAddress);
-        header->destinationPort = localPort;
-        header->endOfRecord = (msg.msg_flags & MSG_EOR) != 0;
-
-        // parse the ancillary data
-        struct cmsghdr *cmsgptr;
-        QT_WARNING_PUSH
-        QT_WARNING_DISABLE_CLANG("-Wsign-compare")
-        for (cmsgptr = CMSG_FIRSTHDR(&msg); cmsgptr != nullptr;
-             cmsgptr = CMSG_NXTHDR(&msg, cmsgptr)) {
-            QT_WARNING_POP
-            if (cmsgptr->cmsg_level == IPPROTO_IPV6 && cmsgptr->cmsg_type == IPV6_PKTINFO
-                    && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in6_pktinfo))) {
-                in6_pktinfo *info = reinterpret_cast<in6_pktinfo *>(CMSG_DATA(cmsgptr));
-
-                header->destinationAddress.setAddress(reinterpret_cast<quint8 *>(&info->ipi6_addr));
-                header->ifindex = info->ipi6_ifindex;
-                if (header->ifindex)
-                    header->destinationAddress.setScopeId(QString::number(info->ipi6_ifindex));
-            }
-
-#ifdef IP_PKTINFO
-            if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_PKTINFO
-                    && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in_pktinfo))) {
-                in_pktinfo *info = reinterpret_cast<in_pktinfo *>(CMSG_DATA(cmsgptr));
-
-                header->destinationAddress.setAddress(ntohl(info->ipi_addr.s_addr));
-                header->ifindex = info->ipi_ifindex;
-            }
-#else
-#  ifdef IP_RECVDSTADDR
-            if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_RECVDSTADDR
-                    && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in_addr))) {
-                in_addr *addr = reinterpret_cast<in_addr *>(CMSG_DATA(cmsgptr));
-
-                header->destinationAddress.setAddress(ntohl(addr->s_addr));
-            }
-#  endif
-#  if defined(IP_RECVIF) && defined(Q_OS_BSD4)
-            if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_RECVIF
-                    && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(sockaddr_dl))) {
-                sockaddr_dl *sdl = reinterpret_cast<sockaddr_dl *>(CMSG_DATA(cmsgptr));
-                header->ifindex = sdl->sdl_index;
-            }
-#  endif
-#endif
-
-            if (cmsgptr->cmsg_len == CMSG_LEN(sizeof(int))
-                    && ((cmsgptr->cmsg_level == IPPROTO_IPV6 && cmsgptr->cmsg_type == IPV6_HOPLIMIT)
-                        || (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_TTL))) {
-                static_assert(sizeof(header->hopLimit) == sizeof(int));
-                memcpy(&header->hopLimit, CMSG_DATA(cmsgptr), sizeof(header->hopLimit));
-            }
-
-#ifndef QT_NO_SCTP
-            if (cmsgptr->cmsg_level == IPPROTO_SCTP && cmsgptr->cmsg_type == SCTP_SNDRCV
-                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(sctp_sndrcvinfo))) {
-                sctp_sndrcvinfo *rcvInfo = reinterpret_cast<sctp_sndrcvinfo *>(CMSG_DATA(cmsgptr));
-
-                header->streamNumber = int(rcvInfo->sinfo_stream);
-            }
-#endif
-        }
+        qt_parseDatagramHeader(&msg, &aa, localPort, header);
     }
 
 #if defined (QNATIVESOCKETENGINE_DEBUG)
@@ -1042,14 +1146,8 @@ qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxS
 
 qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 len, const QIpPacketHeader &header)
 {
-    // we use quintptr to force the alignment
-    quintptr cbuf[(CMSG_SPACE(sizeof(struct in6_pktinfo)) + CMSG_SPACE(sizeof(int))
-#ifndef QT_NO_SCTP
-                   + CMSG_SPACE(sizeof(struct sctp_sndrcvinfo))
-#endif
-                   + sizeof(quintptr) - 1) / sizeof(quintptr)];
+    quintptr cbuf[SendControlBufferLength];
 
-    struct cmsghdr *cmsgptr = reinterpret_cast<struct cmsghdr *>(cbuf);
     struct msghdr msg;
     struct iovec vec;
     qt_sockaddr aa;
@@ -1068,84 +1166,168 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
                           &aa, &msg.msg_namelen);
     }
 
-    if (msg.msg_namelen == sizeof(aa.a6)) {
-        if (header.hopLimit != -1) {
-            msg.msg_controllen += CMSG_SPACE(sizeof(int));
-            cmsgptr->cmsg_len = CMSG_LEN(sizeof(int));
-            cmsgptr->cmsg_level = IPPROTO_IPV6;
-            cmsgptr->cmsg_type = IPV6_HOPLIMIT;
-            memcpy(CMSG_DATA(cmsgptr), &header.hopLimit, sizeof(int));
-            cmsgptr = reinterpret_cast<cmsghdr *>(reinterpret_cast<char *>(cmsgptr) + CMSG_SPACE(sizeof(int)));
+    qt_buildDatagramControl(&msg, header);
+    ssize_t sentBytes = qt_safe_sendmsg(socketDescriptor, &msg, 0);
+
+    if (sentBytes < 0) {
+        switch (errno) {
+#if defined(EWOULDBLOCK) && EWOULDBLOCK != EAGAIN
+        case EWOULDBLOCK:
+#endif
+        case EAGAIN:
+            sentBytes = -2;
+            break;
+        case EMSGSIZE:
+            setError(QAbstractSocket::DatagramTooLargeError, DatagramTooLargeErrorString);
+            break;
+        case ECONNRESET:
+            setError(QAbstractSocket::RemoteHostClosedError, RemoteHostClosedErrorString);
+            break;
+        default:
+            setError(QAbstractSocket::NetworkError, SendDatagramErrorString);
         }
-        if (header.ifindex != 0 || !header.senderAddress.isNull()) {
-            struct in6_pktinfo *data = reinterpret_cast<in6_pktinfo *>(CMSG_DATA(cmsgptr));
-            memset(data, 0, sizeof(*data));
-            msg.msg_controllen += CMSG_SPACE(sizeof(*data));
-            cmsgptr->cmsg_len = CMSG_LEN(sizeof(*data));
-            cmsgptr->cmsg_level = IPPROTO_IPV6;
-            cmsgptr->cmsg_type = IPV6_PKTINFO;
-            data->ipi6_ifindex = header.ifindex;
+    }
 
-            QIPv6Address tmp = header.senderAddress.toIPv6Address();
-            memcpy(&data->ipi6_addr, &tmp, sizeof(tmp));
-            cmsgptr = reinterpret_cast<cmsghdr *>(reinterpret_cast<char *>(cmsgptr) + CMSG_SPACE(sizeof(*data)));
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEngine::sendDatagram(%p \"%s\", %lli, \"%s\", %i) == %lli", data,
+           QtDebugUtils::toPrintable(data, len, 16).constData(), len,
+           header.destinationAddress.toString().toLatin1().constData(),
+           header.destinationPort, (qint64) sentBytes);
+#endif
+
+    return qint64(sentBytes);
+}
+
+#if QT_CONFIG(sendmmsg)
+// the kernel handles at most UIO_MAXIOV messages per call
+static constexpr qsizetype MaxMessagesPerCall = 1024;
+
+qsizetype QNativeSocketEnginePrivate::nativeReceiveDatagrams(QAbstractSocketEngine::DatagramBuffer *buffers,
+                                                             qsizetype count,
+                                                             QAbstractSocketEngine::PacketHeaderOptions options)
+{
+    const qsizetype n = qMin(count, MaxMessagesPerCall);
+    const bool wantSender = options & QAbstractSocketEngine::WantDatagramSender;
+    const bool wantControl = options & (QAbstractSocketEngine::WantDatagramHopLimit
+                                        | QAbstractSocketEngine::WantDatagramDestination
+                                        | QAbstractSocketEngine::WantStreamNumber);
+
+    QVarLengthArray<struct mmsghdr, 32> msgs(n);
+    QVarLengthArray<struct iovec, 32> vecs(n);
+    QVarLengthArray<qt_sockaddr, 32> addresses(n);
+    QVarLengthArray<quintptr, 32 * ReceiveControlBufferLength> cbufs(wantControl ? n * ReceiveControlBufferLength : 0);
+    char c;
+    memset(msgs.data(), 0, n * sizeof(struct mmsghdr));
+    memset(addresses.data(), 0, n * sizeof(qt_sockaddr));
+
+    for (qsizetype i = 0; i < n; ++i) {
+        struct msghdr &msg = msgs[i].msg_hdr;
+        // we need to receive at least one byte, even if our user isn't interested in it
+        vecs[i].iov_base = buffers[i].size ? buffers[i].data : &c;
+        vecs[i].iov_len = buffers[i].size ? buffers[i].size : 1;
+        msg.msg_iov = &vecs[i];
+        msg.msg_iovlen = 1;
+        if (wantSender) {
+            msg.msg_name = &addresses[i];
+            msg.msg_namelen = sizeof(qt_sockaddr);
         }
-    } else {
-        if (header.hopLimit != -1) {
-            msg.msg_controllen += CMSG_SPACE(sizeof(int));
-            cmsgptr->cmsg_len = CMSG_LEN(sizeof(int));
-            cmsgptr->cmsg_level = IPPROTO_IP;
-            cmsgptr->cmsg_type = IP_TTL;
-            memcpy(CMSG_DATA(cmsgptr), &header.hopLimit, sizeof(int));
-            cmsgptr = reinterpret_cast<cmsghdr *>(reinterpret_cast<char *>(cmsgptr) + CMSG_SPACE(sizeof(int)));
+        if (wantControl) {
+            msg.msg_control = cbufs.data() + i * ReceiveControlBufferLength;
+            msg.msg_controllen = ReceiveControlBufferLength * sizeof(quintptr);
         }
+    }
 
-#if defined(IP_PKTINFO) || defined(IP_SENDSRCADDR)
-        if (header.ifindex != 0 || !header.senderAddress.isNull()) {
-#  ifdef IP_PKTINFO
-            struct in_pktinfo *data = reinterpret_cast<in_pktinfo *>(CMSG_DATA(cmsgptr));
-            memset(data, 0, sizeof(*data));
-            cmsgptr->cmsg_type = IP_PKTINFO;
-            data->ipi_ifindex = header.ifindex;
-            data->ipi_addr.s_addr = htonl(header.senderAddress.toIPv4Address());
-#  elif defined(IP_SENDSRCADDR)
-            struct in_addr *data = reinterpret_cast<in_addr *>(CMSG_DATA(cmsgptr));
-            cmsgptr->cmsg_type = IP_SENDSRCADDR;
-            data->s_addr = htonl(header.senderAddress.toIPv4Address());
-#  endif
-            cmsgptr->cmsg_level = IPPROTO_IP;
-            msg.msg_controllen += CMSG_SPACE(sizeof(*data));
-            cmsgptr->cmsg_len = CMSG_LEN(sizeof(*data));
-            cmsgptr = reinterpret_cast<cmsghdr *>(reinterpret_cast<char *>(cmsgptr) + CMSG_SPACE(sizeof(*data)));
-        }
+    int received;
+    do {
+        received = ::recvmmsg(socketDescriptor, msgs.data(), uint(n), MSG_DONTWAIT, nullptr);
+    } while (received == -1 && errno == EINTR);
+
+    if (received == -1) {
+        switch (errno) {
+#if defined(EWOULDBLOCK) && EWOULDBLOCK != EAGAIN
+        case EWOULDBLOCK:
 #endif
+        case EAGAIN:
+            // No datagram was available for reading
+            return 0;
+        case ECONNREFUSED:
+            setError(QAbstractSocket::ConnectionRefusedError, ConnectionRefusedErrorString);
+            break;
+        default:
+            setError(QAbstractSocket::NetworkError, ReceiveDatagramErrorString);
+        }
+        if (buffers[0].header)
+            buffers[0].header->clear();
+        return -1;
     }
 
-#ifndef QT_NO_SCTP
-    if (header.streamNumber != -1) {
-        struct sctp_sndrcvinfo *data = reinterpret_cast<sctp_sndrcvinfo *>(CMSG_DATA(cmsgptr));
-        memset(data, 0, sizeof(*data));
-        msg.msg_controllen += CMSG_SPACE(sizeof(sctp_sndrcvinfo));
-        cmsgptr->cmsg_len = CMSG_LEN(sizeof(sctp_sndrcvinfo));
-        cmsgptr->cmsg_level = IPPROTO_SCTP;
-        cmsgptr->cmsg_type =  SCTP_SNDRCV;
-        data->sinfo_stream = uint16_t(header.streamNumber);
-        cmsgptr = reinterpret_cast<cmsghdr *>(reinterpret_cast<char *>(cmsgptr) + CMSG_SPACE(sizeof(*data)));
+    for (int i = 0; i < received; ++i) {
+        if (buffers[i].size)
+            buffers[i].size = msgs[i].msg_len;
+        if (options != QAbstractSocketEngine::WantNone) {
+            Q_ASSERT(buffers[i].header);
+            qt_parseDatagramHeader(&msgs[i].msg_hdr, &addresses[i], localPort, buffers[i].header);
+        }
     }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeReceiveDatagrams(%p, %lli) == %i",
+           buffers, qint64(count), received);
 #endif
 
-    if (msg.msg_controllen == 0)
-        msg.msg_control = nullptr;
-    ssize_t sentBytes = qt_safe_sendmsg(socketDescriptor, &msg, 0);
+    return received;
+}
 
-    if (sentBytes < 0) {
+qsizetype QNativeSocketEnginePrivate::nativeSendDatagrams(const QAbstractSocketEngine::DatagramBuffer *buffers,
+                                                          qsizetype count)
+{
+    const qsizetype n = qMin(count, MaxMessagesPerCall);
+
+    QVarLengthArray<struct mmsghdr, 32> msgs(n);
+    QVarLengthArray<struct iovec, 32> vecs(n);
+    QVarLengthArray<qt_sockaddr, 32> addresses(n);
+    QVarLengthArray<quintptr, 32 * SendControlBufferLength> cbufs(n * SendControlBufferLength);
+    memset(msgs.data(), 0, n * sizeof(struct mmsghdr));
+    memset(addresses.data(), 0, n * sizeof(qt_sockaddr));
+
+    for (qsizetype i = 0; i < n; ++i) {
+        const QIpPacketHeader &header = *buffers[i].header;
+        struct msghdr &msg = msgs[i].msg_hdr;
+        vecs[i].iov_base = buffers[i].data;
+        vecs[i].iov_len = buffers[i].size;
+        msg.msg_iov = &vecs[i];
+        msg.msg_iovlen = 1;
+        msg.msg_control = cbufs.data() + i * SendControlBufferLength;
+
+        if (header.destinationPort != 0) {
+            msg.msg_name = &addresses[i].a;
+            setPortAndAddress(header.destinationPort, header.destinationAddress,
+                              &addresses[i], &msg.msg_namelen);
+        }
+        qt_buildDatagramControl(&msg, header);
+    }
+
+    int flags = 0;
+#ifdef MSG_NOSIGNAL
+    flags |= MSG_NOSIGNAL;
+#else
+    qt_ignore_sigpipe();
+#endif
+
+    int sent;
+    do {
+        sent = ::sendmmsg(socketDescriptor, msgs.data(), uint(n), flags);
+    } while (sent == -1 && errno == EINTR);
+
+    // sendmmsg() only fails if the first datagram could not be sent; errors
+    // for later datagrams are reported by the next call
+    if (sent == -1) {
         switch (errno) {
 #if defined(EWOULDBLOCK) && EWOULDBLOCK != EAGAIN
         case EWOULDBLOCK:
 #endif
         case EAGAIN:
-            sentBytes = -2;
-            break;
+            return 0;
         case EMSGSIZE:
             setError(QAbstractSocket::DatagramTooLargeError, DatagramTooLargeErrorString);
             break;
@@ -1158,14 +1340,13 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
     }
 
 #if defined (QNATIVESOCKETENGINE_DEBUG)
-    qDebug("QNativeSocketEngine::sendDatagram(%p \"%s\", %lli, \"%s\", %i) == %lli", data,
-           QtDebugUtils::toPrintable(data, len, 16).constData(), len,
-           header.destinationAddress.toString().toLatin1().constData(),
-           header.destinationPort, (qint64) sentBytes);
+    qDebug("QNativeSocketEnginePrivate::nativeSendDatagrams(%p, %lli) == %i",
+           buffers, qint64(count), sent);
 #endif
 
-    return qint64(sentBytes);
+    return sent;
 }
+#endif // QT_CONFIG(sendmmsg)
 
 bool QNativeSocketEnginePrivate::fetchConnectionParameters()
 {
@@ -1331,6 +1512,54 @@ qint64 QNativeSocketEnginePrivate::nativeWrite(const char *data, qint64 len)
 
     return qint64(writtenBytes);
 }
+
+#if QT_CONFIG(sendfile)
+qint64 QNativeSocketEnginePrivate::nativeSendFile(qintptr fileDescriptor, qint64 offset,
+                                                  qint64 length)
+{
+    Q_Q(QNativeSocketEngine);
+
+    // Linux never transfers more than this per call; larger requests are
+    // silently truncated, so ask for no more.
+    constexpr qint64 MaxSendFileLength = 0x7ffff000;
+
+    // sendfile() has no MSG_NOSIGNAL equivalent.
+    qt_ignore_sigpipe();
+
+    off_t fileOffset = off_t(offset);
+    ssize_t sentBytes;
+    EINTR_LOOP(sentBytes, ::sendfile(socketDescriptor, int(fileDescriptor), &fileOffset,
+                                     size_t(qMin(length, MaxSendFileLength))));
+
+    if (sentBytes < 0) {
+        switch (errno) {
+        case EPIPE:
+        case ECONNRESET:
+            setError(QAbstractSocket::RemoteHostClosedError, RemoteHostClosedErrorString);
+            q->close();
+            break;
+        case EAGAIN:
+            sentBytes = 0;
+            break;
+        case EINVAL:
+        case ENOSYS:
+            setError(QAbstractSocket::UnsupportedSocketOperationError,
+                     OperationUnsupportedErrorString);
+            break;
+        default:
+            setError(QAbstractSocket::UnknownSocketError, UnknownSocketErrorString);
+            break;
+        }
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeSendFile(%lld, %lld, %lld) == %lld",
+           qint64(fileDescriptor), offset, length, qint64(sentBytes));
+#endif
+
+    return qint64(sentBytes);
+}
+#endif // QT_CONFIG(sendfile)
 /*
 */
 qint64 QNativeSocketEnginePrivate::nativeRead(char *data, qint64 maxSize)
@@ -254,6 +254,7 @@ static void convertToLevelAndOption(QNativeSocketEngine::SocketOption opt,
         break;
 
     case QAbstractSocketEngine::PathMtuInformation:
+    case QAbstractSocketEngine::PortReusable:
         break;          // not supported on Windows
     }
 }
@@ -188,6 +188,10 @@ void QTcpServerPrivate::configureCreatedSocket()
     // trying to bind/listen.
     socketEngine->setOption(QAbstractSocketEngine::AddressReusable, 1);
 #endif
+    // As above, this is a hint: if the option is not supported, binding a
+    // second server to the same port fails with AddressInUseError.
+    if (portSharing)
+        socketEngine->setOption(QAbstractSocketEngine::PortReusable, 1);
 }
 
 /*! \internal
@@ -677,6 +681,46 @@ int QTcpServer::listenBacklogSize() const
     return d_func()->listenBacklog;
 }
 
+/*!
+    \since 6.3
+
+    If \a enabled is \c true, lets other servers that also enable port
+    sharing listen on the same address and port as this one. The operating
+    system then distributes incoming connections among all of them.
+
+    This allows a multi-threaded server to accept connections in every
+    thread without passing socket descriptors between threads: create one
+    QTcpServer in each thread, enable port sharing on all of them, and make
+    them listen on the same address and port. Each server then receives its
+    share of the connections in its own thread's event loop.
+
+    Only servers run by the same user can share a port. Port sharing is
+    supported on Linux (\c SO_REUSEPORT). On other platforms this setting has
+    no effect, and listening on a port that is already in use fails with
+    QAbstractSocket::AddressInUseError.
+
+    \note This property must be set prior to calling listen().
+
+    \sa isPortSharingEnabled(), listen()
+*/
+void QTcpServer::setPortSharingEnabled(bool enabled)
+{
+    d_func()->portSharing = enabled;
+}
+
+/*!
+    \since 6.3
+
+    Returns \c true if port sharing is enabled for this server; otherwise
+    returns \c false. Port sharing is disabled by default.
+
+    \sa setPortSharingEnabled()
+*/
+bool QTcpServer::isPortSharingEnabled() const
+{
+    return d_func()->portSharing;
+}
+
 /*!
     Returns an error code for the last error that occurred.
 
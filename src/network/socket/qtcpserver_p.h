@@ -84,6 +84,7 @@ public:
     QString serverSocketErrorString;
 
     int listenBacklog = 50;
+    bool portSharing = false;
     int maxConnections;
 
 #ifndef QT_NO_NETWORKPROXY
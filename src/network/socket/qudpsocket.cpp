@@ -102,6 +102,7 @@
 #include "qnetworkdatagram.h"
 #include "qnetworkinterface.h"
 #include "qabstractsocket_p.h"
+#include "qvarlengtharray.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -125,6 +126,9 @@ public:
 
     inline bool ensureInitialized(const QHostAddress &remoteAddress)
     { return doEnsureInitialized(QHostAddress(), 0, remoteAddress); }
+
+    // scratch space for receiveDatagrams()
+    QByteArray datagramBuffer;
 };
 
 bool QUdpSocketPrivate::doEnsureInitialized(const QHostAddress &bindAddress, quint16 bindPort,
@@ -476,6 +480,139 @@ QNetworkDatagram QUdpSocket::receiveDatagram(qint64 maxSize)
     return result;
 }
 
+/*!
+    \since 6.3
+
+    Receives up to \a maxCount pending datagrams, each no larger than \a
+    maxSize bytes, and returns them in the order they arrived. Like
+    receiveDatagram(), this function also tries to determine each
+    datagram's sender and destination address, port, and hop count.
+
+    Returns an empty list if no datagram is pending or if an error occurred.
+
+    Where the operating system supports it (\c recvmmsg() on Linux), many
+    datagrams are received with a single system call, which makes this
+    function considerably cheaper than calling receiveDatagram() in a loop
+    when datagrams arrive at a high rate.
+
+    If \a maxSize is too small, the rest of each datagram will be lost. If \a
+    maxSize is -1 (the default), this function is prepared to read
+    datagrams of the maximum UDP size, which limits the number of datagrams
+    read per system call; pass the largest size your protocol uses instead
+    for best performance.
+
+    \sa writeDatagrams(), receiveDatagram(), hasPendingDatagrams()
+*/
+QList<QNetworkDatagram> QUdpSocket::receiveDatagrams(qsizetype maxCount, qint64 maxSize)
+{
+    Q_D(QUdpSocket);
+
+#if defined QUDPSOCKET_DEBUG
+    qDebug("QUdpSocket::receiveDatagrams(%lld, %lld)", qint64(maxCount), maxSize);
+#endif
+    QT_CHECK_BOUND("QUdpSocket::receiveDatagrams()", QList<QNetworkDatagram>());
+
+    QList<QNetworkDatagram> result;
+    if (maxCount <= 0)
+        return result;
+
+    // The largest possible UDP payload is 65507 bytes (IPv4) or 65527 bytes
+    // (IPv6, without jumbograms). Keep the scratch buffer below 512 KiB.
+    constexpr qint64 MaxDatagramSize = 65536;
+    constexpr qint64 MaxBufferSize = 512 * 1024;
+    const qint64 slotSize = maxSize < 0 ? MaxDatagramSize : maxSize;
+    const qsizetype batchSize = qMin(maxCount, qsizetype(qMax(Q_INT64_C(1), MaxBufferSize / qMax(slotSize, Q_INT64_C(1)))));
+    d->datagramBuffer.resize(qMax(batchSize * slotSize, Q_INT64_C(1)));
+
+    QVarLengthArray<QIpPacketHeader, 64> headers(batchSize);
+    QVarLengthArray<QAbstractSocketEngine::DatagramBuffer, 64> buffers(batchSize);
+    while (result.size() < maxCount) {
+        const qsizetype n = qMin(batchSize, maxCount - result.size());
+        for (qsizetype i = 0; i < n; ++i)
+            buffers[i] = { d->datagramBuffer.data() + i * slotSize, slotSize, &headers[i] };
+
+        const qsizetype received = d->socketEngine->readDatagrams(buffers.data(), n,
+                                                                  QAbstractSocketEngine::WantAll);
+        if (received < 0) {
+            d->setErrorAndEmit(d->socketEngine->error(), d->socketEngine->errorString());
+            break;
+        }
+        result.reserve(result.size() + received);
+        for (qsizetype i = 0; i < received; ++i) {
+            QNetworkDatagram datagram(QByteArray(buffers[i].data, buffers[i].size));
+            datagram.d->header = headers[i];
+            result.append(std::move(datagram));
+        }
+        if (received < n)
+            break;
+    }
+
+    d->hasPendingData = false;
+    d->socketEngine->setReadNotificationEnabled(true);
+    return result;
+}
+
+/*!
+    \since 6.3
+
+    Sends the datagrams in \a datagrams, in order, and returns the number of
+    datagrams sent, or -1 if not even the first datagram could be sent. The
+    destination address, port and other header fields of each datagram are
+    interpreted as in writeDatagram().
+
+    Where the operating system supports it (\c sendmmsg() on Linux), many
+    datagrams are sent with a single system call. If fewer datagrams than
+    requested were sent, the socket's send buffer was full or an error
+    occurred; call the function again with the remaining datagrams once
+    bytesWritten() has been emitted.
+
+    \sa receiveDatagrams(), writeDatagram()
+*/
+qsizetype QUdpSocket::writeDatagrams(const QList<QNetworkDatagram> &datagrams)
+{
+    Q_D(QUdpSocket);
+#if defined QUDPSOCKET_DEBUG
+    qDebug("QUdpSocket::writeDatagrams(%lld)", qint64(datagrams.size()));
+#endif
+    if (datagrams.isEmpty())
+        return 0;
+    if (!d->doEnsureInitialized(QHostAddress::Any, 0, datagrams.constFirst().destinationAddress()))
+        return -1;
+    if (state() == UnconnectedState)
+        bind();
+
+    QVarLengthArray<QAbstractSocketEngine::DatagramBuffer, 64> buffers(datagrams.size());
+    for (qsizetype i = 0; i < datagrams.size(); ++i) {
+        const QNetworkDatagram &datagram = datagrams.at(i);
+        buffers[i] = { const_cast<char *>(datagram.d->data.constData()), datagram.d->data.size(),
+                       &datagram.d->header };
+    }
+
+    qsizetype written = 0;
+    bool failed = false;
+    while (written < datagrams.size()) {
+        const qsizetype sent = d->socketEngine->writeDatagrams(buffers.constData() + written,
+                                                               datagrams.size() - written);
+        if (sent < 0) {
+            failed = true;
+            d->setErrorAndEmit(d->socketEngine->error(), d->socketEngine->errorString());
+        }
+        if (sent <= 0)
+            break;
+        written += sent;
+    }
+    d->cachedSocketDescriptor = d->socketEngine->socketDescriptor();
+
+    if (written == 0 && failed)
+        return -1;
+    qint64 bytes = 0;
+    for (qsizetype i = 0; i < written; ++i)
+        bytes += buffers[i].size;
+    if (written)
+        emit bytesWritten(bytes);
+    return written;
+}
+
 /*!
     Receives a datagram no larger than \a maxSize bytes and stores
     it in \a data. The sender's host address and port is stored in
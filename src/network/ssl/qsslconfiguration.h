@@ -198,6 +198,7 @@ private:
     friend class QSslConfigurationPrivate;
     friend class QSslContext;
     friend class QTlsBackend;
+    friend class QTlsSessionCache;
     QSslConfiguration(QSslConfigurationPrivate *dd);
     QSharedDataPointer<QSslConfigurationPrivate> d;
 };
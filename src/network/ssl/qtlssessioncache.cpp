@@ -0,0 +1,217 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qtlssessioncache_p.h"
+
+#include "qsslconfiguration.h"
+#include "qsslconfiguration_p.h"
+#include "qsslcertificate.h"
+#include "qsslcipher.h"
+
+#include <QtCore/qglobal.h>
+
+QT_BEGIN_NAMESPACE
+
+// Used when the server does not give a lifetime hint for its session
+static constexpr int defaultSessionLifetime = 2 * 60 * 60; // seconds
+
+Q_GLOBAL_STATIC(QTlsSessionCache, tlsSessionCache)
+
+/*!
+    \internal
+    \class QTlsSessionCache
+    \inmodule QtNetwork
+
+    \brief QTlsSessionCache is a process-wide cache of TLS client sessions.
+
+    The cache stores serialized sessions, as returned by
+    QSslConfiguration::sessionTicket(), so that a new connection to a peer
+    can resume a session negotiated by an earlier connection to the same
+    peer instead of doing a full handshake, even if the two connections use
+    different QSslSocket objects or QNetworkAccessManager instances. TLS
+    backends look sessions up when they start a client handshake and store
+    them once the handshake succeeded without certificate errors.
+
+    Sessions are keyed by the peer name, the port and a hash of the parts of
+    the QSslConfiguration that affect the handshake, so that a session is
+    never resumed by a connection that would verify the peer differently.
+    The number of cached sessions is bounded; the least recently used ones
+    are dropped first. The cache is thread-safe.
+
+    Setting QSsl::SslOptionDisableSessionSharing on a configuration keeps its
+    connections out of the cache.
+*/
+
+/*!
+    Returns the process-wide cache, or \nullptr during application shutdown.
+*/
+QTlsSessionCache *QTlsSessionCache::instance()
+{
+    return tlsSessionCache();
+}
+
+/*!
+    Returns the key under which sessions negotiated with \a peerName on
+    \a port using \a configuration are stored.
+*/
+QTlsSessionCache::Key QTlsSessionCache::key(const QString &peerName, quint16 port,
+                                            const QSslConfiguration &configuration)
+{
+    QtPrivate::QHashCombine hash;
+    size_t seed = 0;
+    seed = hash(seed, int(configuration.protocol()));
+    seed = hash(seed, int(configuration.peerVerifyMode()));
+    seed = hash(seed, configuration.peerVerifyDepth());
+    seed = hash(seed, int(configuration.d->sslOptions));
+    const auto ciphers = configuration.ciphers();
+    for (const QSslCipher &cipher : ciphers)
+        seed = hash(seed, cipher.name());
+    const auto protocols = configuration.allowedNextProtocols();
+    for (const QByteArray &protocol : protocols)
+        seed = hash(seed, protocol);
+    seed = hash(seed, configuration.localCertificate());
+    const auto caCertificates = configuration.caCertificates();
+    for (const QSslCertificate &certificate : caCertificates)
+        seed = hash(seed, certificate);
+    return { peerName, port, seed };
+}
+
+/*!
+    Returns the session stored for \a key, or an empty QByteArray if there is
+    none or it has expired. Updates the hit and miss counters.
+*/
+QByteArray QTlsSessionCache::session(const Key &key)
+{
+    QMutexLocker locker(&mutex);
+    if (const Entry *entry = entries.object(key)) {
+        if (!entry->expiry.hasExpired()) {
+            ++hitCount;
+            return entry->session;
+        }
+        entries.remove(key);
+    }
+    ++missCount;
+    return QByteArray();
+}
+
+/*!
+    Stores \a session for \a key, replacing any previous one. The session is
+    considered expired after \a lifetimeHint seconds, or after two hours if
+    \a lifetimeHint is not positive.
+*/
+void QTlsSessionCache::insert(const Key &key, const QByteArray &session, int lifetimeHint)
+{
+    if (session.isEmpty())
+        return;
+    const int lifetime = lifetimeHint > 0 ? qMin(lifetimeHint, defaultSessionLifetime)
+                                          : defaultSessionLifetime;
+    QMutexLocker locker(&mutex);
+    entries.insert(key, new Entry{ session, QDeadlineTimer(qint64(lifetime) * 1000) });
+}
+
+/*!
+    Removes the session stored for \a key. Returns \c true if there was one.
+*/
+bool QTlsSessionCache::remove(const Key &key)
+{
+    QMutexLocker locker(&mutex);
+    return entries.remove(key);
+}
+
+/*!
+    Removes all sessions and resets the hit and miss counters.
+*/
+void QTlsSessionCache::clear()
+{
+    QMutexLocker locker(&mutex);
+    entries.clear();
+    hitCount = 0;
+    missCount = 0;
+}
+
+/*!
+    Returns the maximum number of sessions kept in the cache. The default
+    is 256.
+*/
+qsizetype QTlsSessionCache::maximumSize() const
+{
+    QMutexLocker locker(&mutex);
+    return entries.maxCost();
+}
+
+/*!
+    Sets the maximum number of sessions kept in the cache to \a size,
+    dropping the least recently used sessions if needed.
+*/
+void QTlsSessionCache::setMaximumSize(qsizetype size)
+{
+    QMutexLocker locker(&mutex);
+    entries.setMaxCost(qMax(size, qsizetype(0)));
+}
+
+/*!
+    Returns the number of sessions in the cache.
+*/
+qsizetype QTlsSessionCache::size() const
+{
+    QMutexLocker locker(&mutex);
+    return entries.size();
+}
+
+/*!
+    Returns how many lookups found a session since the cache was created or
+    last cleared.
+*/
+quint64 QTlsSessionCache::hits() const
+{
+    QMutexLocker locker(&mutex);
+    return hitCount;
+}
+
+/*!
+    Returns how many lookups did not find a session since the cache was
+    created or last cleared.
+*/
+quint64 QTlsSessionCache::misses() const
+{
+    QMutexLocker locker(&mutex);
+    return missCount;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,119 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QTLSSESSIONCACHE_P_H
+#define QTLSSESSIONCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtNetwork/private/qtnetworkglobal_p.h>
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qcache.h>
+#include <QtCore/qdeadlinetimer.h>
+#include <QtCore/qhashfunctions.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qstring.h>
+
+QT_REQUIRE_CONFIG(ssl);
+
+QT_BEGIN_NAMESPACE
+
+class QSslConfiguration;
+
+class Q_NETWORK_PRIVATE_EXPORT QTlsSessionCache
+{
+public:
+    struct Key
+    {
+        QString peerName;
+        quint16 port = 0;
+        size_t configurationHash = 0;
+
+        friend bool operator==(const Key &lhs, const Key &rhs) noexcept
+        {
+            return lhs.port == rhs.port && lhs.configurationHash == rhs.configurationHash
+                   && lhs.peerName == rhs.peerName;
+        }
+        friend size_t qHash(const Key &key, size_t seed = 0) noexcept
+        {
+            return qHashMulti(seed, key.peerName, key.port, key.configurationHash);
+        }
+    };
+
+    static QTlsSessionCache *instance();
+    static Key key(const QString &peerName, quint16 port, const QSslConfiguration &configuration);
+
+    QByteArray session(const Key &key);
+    void insert(const Key &key, const QByteArray &session, int lifetimeHint);
+    bool remove(const Key &key);
+    void clear();
+
+    qsizetype maximumSize() const;
+    void setMaximumSize(qsizetype size);
+    qsizetype size() const;
+
+    quint64 hits() const;
+    quint64 misses() const;
+
+private:
+    struct Entry
+    {
+        QByteArray session;
+        QDeadlineTimer expiry;
+    };
+
+    mutable QMutex mutex;
+    QCache<Key, Entry> entries{256};
+    quint64 hitCount = 0;
+    quint64 missCount = 0;
+};
+
+QT_END_NAMESPACE
+
+#endif // QTLSSESSIONCACHE_P_H
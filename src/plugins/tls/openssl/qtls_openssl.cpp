@@ -835,6 +835,9 @@ void TlsCryptographOpenSSL::continueHandshake()
 #endif // QT_DECRYPT_SSL_TRAFFIC
 
     const auto &configuration = q->sslConfiguration();
+    if (mode == QSslSocket::SslClientMode)
+        storeSessionInCache(q_SSL_get_session(ssl));
+
     // Cache this SSL session inside the QSslContext
     if (!(configuration.testSslOption(QSsl::SslOptionDisableSessionSharing))) {
         if (!sslContextPointer->cacheSession(ssl)) {
@@ -1263,7 +1266,8 @@ int TlsCryptographOpenSSL::handleNewSessionTicket(SSL *connection)
     Q_ASSERT(q);
     Q_ASSERT(d);
 
-    if (q->sslConfiguration().testSslOption(QSsl::SslOptionDisableSessionPersistence)) {
+    const bool persistent = !q->sslConfiguration().testSslOption(QSsl::SslOptionDisableSessionPersistence);
+    if (!persistent && !useSessionCache) {
         // We silently ignore, do nothing, remove from cache.
         return 0;
     }
@@ -1287,6 +1291,10 @@ int TlsCryptographOpenSSL::handleNewSessionTicket(SSL *connection)
     }
 #endif // TLS1_3_VERSION
 
+    storeSessionInCache(currentSession);
+    if (!persistent)
+        return 0;
+
     const int sessionSize = q_i2d_SSL_SESSION(currentSession, nullptr);
     if (sessionSize <= 0) {
         qCWarning(lcTlsBackend, "could not store persistent version of SSL session");
@@ -1439,6 +1447,31 @@ bool TlsCryptographOpenSSL::initSslContext()
         }
     }
 
+    // Resume a session negotiated by an earlier connection to the same peer,
+    // unless the context (e.g. shared by QHttpNetworkConnection, or set up
+    // from QSslConfiguration::sessionTicket()) already provided one.
+    useSessionCache = mode == QSslSocket::SslClientMode
+                      && !configuration.testSslOption(QSsl::SslOptionDisableSessionSharing)
+                      && QTlsSessionCache::instance();
+    if (useSessionCache) {
+        const auto verificationPeerName = d->verificationName();
+        QString peerName = verificationPeerName.isEmpty() ? q->peerName() : verificationPeerName;
+        if (peerName.isEmpty())
+            peerName = d->tlsHostName();
+        sessionCacheKey = QTlsSessionCache::key(peerName, q->peerPort(), configuration);
+        if (!q_SSL_get_session(ssl)) {
+            const QByteArray asn1 = QTlsSessionCache::instance()->session(sessionCacheKey);
+            const auto *data = reinterpret_cast<const unsigned char *>(asn1.constData());
+            if (!asn1.isEmpty()) {
+                if (SSL_SESSION *session = q_d2i_SSL_SESSION(nullptr, &data, asn1.size())) {
+                    if (!q_SSL_set_session(ssl, session))
+                        qCWarning(lcTlsBackend, "could not set SSL session");
+                    q_SSL_SESSION_free(session);
+                }
+            }
+        }
+    }
+
     // Clear the session.
     errorList.clear();
 
@@ -1520,6 +1553,43 @@ bool TlsCryptographOpenSSL::initSslContext()
     return true;
 }
 
+// Stores the session in the process-wide session cache, so that other
+// connections to the same peer can resume it. Sessions of handshakes that
+// reported certificate errors are not stored, even if the errors were
+// ignored, since resuming them would bypass the verification of the peer.
+// (The peer verify mode is part of the cache key, so sessions established
+// without verifying the peer are only resumed by such connections.)
+void TlsCryptographOpenSSL::storeSessionInCache(SSL_SESSION *session)
+{
+    Q_ASSERT(q);
+
+    if (!useSessionCache || !session)
+        return;
+
+    const auto verifyMode = q->peerVerifyMode();
+    const bool verifiesPeer = verifyMode == QSslSocket::VerifyPeer
+                              || verifyMode == QSslSocket::AutoVerifyPeer;
+    if (verifiesPeer && !q->sslHandshakeErrors().isEmpty())
+        return;
+
+#ifdef TLS1_3_VERSION
+    // With TLS 1.3 the session only becomes resumable once a ticket arrives
+    if (!q_SSL_SESSION_is_resumable(session))
+        return;
+#endif // TLS1_3_VERSION
+
+    const int sessionSize = q_i2d_SSL_SESSION(session, nullptr);
+    if (sessionSize <= 0)
+        return;
+    QByteArray asn1(sessionSize, Qt::Uninitialized);
+    auto data = reinterpret_cast<unsigned char *>(asn1.data());
+    if (!q_i2d_SSL_SESSION(session, &data))
+        return;
+
+    if (auto *cache = QTlsSessionCache::instance())
+        cache->insert(sessionCacheKey, asn1, int(q_SSL_SESSION_get_ticket_lifetime_hint(session)));
+}
+
 void TlsCryptographOpenSSL::destroySslContext()
 {
     if (ssl) {
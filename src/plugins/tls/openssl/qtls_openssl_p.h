@@ -57,6 +57,8 @@
 #include "qsslcontext_openssl_p.h"
 #include "qopenssl_p.h"
 
+#include <QtNetwork/private/qtlssessioncache_p.h>
+
 #include <QtNetwork/qsslcertificate.h>
 #include <QtNetwork/qocspresponse.h>
 
@@ -135,10 +137,15 @@ private:
     // easier (see qsslsocket_openssl.cpp, while it exists).
     bool initSslContext();
     void destroySslContext();
+    void storeSessionInCache(SSL_SESSION *session);
 
     std::shared_ptr<QSslContext> sslContextPointer;
     SSL *ssl = nullptr; // TLSTODO: RAII.
 
+    // Key of this connection in the process-wide session cache
+    QTlsSessionCache::Key sessionCacheKey;
+    bool useSessionCache = false;
+
     QList<QSslErrorEntry> errorList;
     QList<QSslError> sslErrors;
 
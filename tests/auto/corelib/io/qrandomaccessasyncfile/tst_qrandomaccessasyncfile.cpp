@@ -0,0 +1,280 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QPointer>
+
+#include <private/qrandomaccessasyncfile_p.h>
+
+class tst_QRandomAccessAsyncFile : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void read_data();
+    void read();
+    void write_data();
+    void write();
+    void manyReads_data();
+    void manyReads();
+    void closeWaitsForOperations_data();
+    void closeWaitsForOperations();
+    void closeFromFinished_data();
+    void closeFromFinished();
+    void deleteOperation_data();
+    void deleteOperation();
+    void openError();
+
+private:
+    void addBackendColumn();
+
+    QTemporaryDir dir;
+    QString dataFile;
+    QByteArray contents;
+};
+
+using Backend = QRandomAccessAsyncFile::Backend;
+
+void tst_QRandomAccessAsyncFile::initTestCase()
+{
+    QVERIFY2(dir.isValid(), qPrintable(dir.errorString()));
+
+    contents.reserve(1 << 20);
+    for (int i = 0; contents.size() < (1 << 20); ++i)
+        contents += QByteArray::number(i) + ' ';
+
+    dataFile = dir.filePath("data.txt");
+    QFile file(dataFile);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(contents), contents.size());
+}
+
+void tst_QRandomAccessAsyncFile::addBackendColumn()
+{
+    QTest::addColumn<Backend>("backend");
+    QTest::newRow("automatic") << Backend::Automatic;
+    QTest::newRow("threadpool") << Backend::ThreadPool;
+}
+
+void tst_QRandomAccessAsyncFile::read_data()
+{
+    addBackendColumn();
+}
+
+void tst_QRandomAccessAsyncFile::read()
+{
+    QFETCH(Backend, backend);
+
+    QRandomAccessAsyncFile file(backend);
+    QVERIFY(file.open(dataFile, QIODevice::ReadOnly));
+    QVERIFY(file.backend() != Backend::Automatic);
+    if (backend == Backend::ThreadPool)
+        QCOMPARE(file.backend(), Backend::ThreadPool);
+    QCOMPARE(file.size(), contents.size());
+
+    QIOOperation *middle = file.read(1000, 5000);
+    QVERIFY(middle);
+    QCOMPARE(middle->type(), QIOOperation::Type::Read);
+    QCOMPARE(middle->offset(), 1000);
+    QSignalSpy spy(middle, &QIOOperation::finished);
+
+    // reading past the end returns what is there
+    QIOOperation *tail = file.read(contents.size() - 10, 100);
+    QVERIFY(tail);
+
+    QTRY_VERIFY(middle->isFinished());
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(middle->error(), QFileDevice::NoError);
+    QCOMPARE(middle->bytesProcessed(), 5000);
+    QCOMPARE(middle->data(), contents.mid(1000, 5000));
+
+    QTRY_VERIFY(tail->isFinished());
+    QCOMPARE(tail->bytesProcessed(), 10);
+    QCOMPARE(tail->data(), contents.right(10));
+}
+
+void tst_QRandomAccessAsyncFile::write_data()
+{
+    addBackendColumn();
+}
+
+void tst_QRandomAccessAsyncFile::write()
+{
+    QFETCH(Backend, backend);
+    const QString fileName = dir.filePath(QStringLiteral("write-%1.txt").arg(int(backend)));
+
+    QRandomAccessAsyncFile file(backend);
+    QVERIFY(file.open(fileName, QIODevice::ReadWrite | QIODevice::Truncate));
+
+    const QByteArray second = contents.mid(4096, 4096);
+    const QByteArray first = contents.left(4096);
+    QIOOperation *op2 = file.write(4096, second);
+    QIOOperation *op1 = file.write(0, first);
+    QVERIFY(op1);
+    QVERIFY(op2);
+    QCOMPARE(op1->type(), QIOOperation::Type::Write);
+
+    QTRY_VERIFY(op1->isFinished() && op2->isFinished());
+    QCOMPARE(op1->error(), QFileDevice::NoError);
+    QCOMPARE(op1->bytesProcessed(), first.size());
+    QCOMPARE(op2->bytesProcessed(), second.size());
+    QCOMPARE(file.size(), 8192);
+
+    QIOOperation *readBack = file.read(0, 8192);
+    QTRY_VERIFY(readBack->isFinished());
+    QCOMPARE(readBack->data(), contents.left(8192));
+}
+
+void tst_QRandomAccessAsyncFile::manyReads_data()
+{
+    addBackendColumn();
+}
+
+void tst_QRandomAccessAsyncFile::manyReads()
+{
+    QFETCH(Backend, backend);
+
+    QRandomAccessAsyncFile file(backend);
+    QVERIFY(file.open(dataFile, QIODevice::ReadOnly));
+
+    // more than fits into a single submission queue
+    constexpr int Count = 500;
+    constexpr int Chunk = 1000;
+    QList<QIOOperation *> operations;
+    int finished = 0;
+    for (int i = 0; i < Count; ++i) {
+        QIOOperation *op = file.read(qint64(i) * Chunk, Chunk);
+        connect(op, &QIOOperation::finished, this, [&finished] { ++finished; });
+        operations.append(op);
+    }
+
+    QTRY_COMPARE(finished, Count);
+    for (int i = 0; i < Count; ++i)
+        QCOMPARE(operations.at(i)->data(), contents.mid(i * Chunk, Chunk));
+}
+
+void tst_QRandomAccessAsyncFile::closeWaitsForOperations_data()
+{
+    addBackendColumn();
+}
+
+void tst_QRandomAccessAsyncFile::closeWaitsForOperations()
+{
+    QFETCH(Backend, backend);
+
+    QRandomAccessAsyncFile file(backend);
+    QVERIFY(file.open(dataFile, QIODevice::ReadOnly));
+    QIOOperation *op = file.read(0, contents.size());
+    QSignalSpy spy(op, &QIOOperation::finished);
+
+    file.close();
+    QVERIFY(!file.isOpen());
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(op->data(), contents);
+
+    QTest::ignoreMessage(QtWarningMsg, "QRandomAccessAsyncFile: File not open");
+    QVERIFY(!file.read(0, 10));
+}
+
+void tst_QRandomAccessAsyncFile::closeFromFinished_data()
+{
+    addBackendColumn();
+}
+
+void tst_QRandomAccessAsyncFile::closeFromFinished()
+{
+    QFETCH(Backend, backend);
+
+    QRandomAccessAsyncFile file(backend);
+    QVERIFY(file.open(dataFile, QIODevice::ReadOnly));
+    QList<QIOOperation *> operations;
+    int finished = 0;
+    for (int i = 0; i < 10; ++i) {
+        QIOOperation *op = file.read(i * 100, 100);
+        connect(op, &QIOOperation::finished, this, [&] {
+            ++finished;
+            file.close();
+        });
+        operations.append(op);
+    }
+
+    // the first finished() closes the file, which finishes all the others
+    QTRY_VERIFY(!file.isOpen());
+    QCOMPARE(finished, operations.size());
+    for (int i = 0; i < operations.size(); ++i) {
+        QVERIFY(operations.at(i)->isFinished());
+        QCOMPARE(operations.at(i)->data(), contents.mid(i * 100, 100));
+    }
+
+    // the same, deleting the file
+    auto *owned = new QRandomAccessAsyncFile(backend);
+    QVERIFY(owned->open(dataFile, QIODevice::ReadOnly));
+    QPointer<QRandomAccessAsyncFile> guard(owned);
+    for (int i = 0; i < 10; ++i) {
+        QIOOperation *op = owned->read(i * 100, 100);
+        // the destructor closes the file and finishes the other operations
+        connect(op, &QIOOperation::finished, this, [&owned] { delete std::exchange(owned, nullptr); });
+    }
+    QTRY_VERIFY(!guard);
+}
+
+void tst_QRandomAccessAsyncFile::deleteOperation_data()
+{
+    addBackendColumn();
+}
+
+void tst_QRandomAccessAsyncFile::deleteOperation()
+{
+    QFETCH(Backend, backend);
+
+    QRandomAccessAsyncFile file(backend);
+    QVERIFY(file.open(dataFile, QIODevice::ReadOnly));
+    delete file.read(0, contents.size());
+    QIOOperation *op = file.read(0, 10);
+
+    QTRY_VERIFY(op->isFinished());
+    QCOMPARE(op->data(), contents.left(10));
+}
+
+void tst_QRandomAccessAsyncFile::openError()
+{
+    QRandomAccessAsyncFile file;
+    QVERIFY(!file.open(dir.filePath("does-not-exist"), QIODevice::ReadOnly));
+    QCOMPARE(file.error(), QFileDevice::OpenError);
+    QVERIFY(!file.errorString().isEmpty());
+    QVERIFY(!file.isOpen());
+    QCOMPARE(file.backend(), Backend::Automatic);
+}
+
+QTEST_MAIN(tst_QRandomAccessAsyncFile)
+#include "tst_qrandomaccessasyncfile.moc"
@@ -33,6 +33,8 @@
 #include <QtCore/QCoreApplication>
 #include <QtCore/QTimer>
 #include <QtCore/QSocketNotifier>
+#include <QtCore/QTemporaryFile>
+#include <QtCore/QThread>
 #include <QtNetwork/QTcpServer>
 #include <QtNetwork/QTcpSocket>
 #include <QtNetwork/QUdpSocket>
@@ -40,6 +42,7 @@
 #define NATIVESOCKETENGINE QNativeSocketEngine
 #ifdef Q_OS_UNIX
 #include <private/qnet_unix_p.h>
+#include <private/qeventdispatcher_unix_p.h>
 #include <sys/select.h>
 #endif
 #include <limits>
@@ -59,6 +62,9 @@ private slots:
     void mixingWithTimers();
 #ifdef Q_OS_UNIX
     void posixSockets();
+#endif
+#if QT_CONFIG(epoll)
+    void epollDispatcher();
 #endif
     void asyncMultipleDatagram();
     void activationReason_data();
@@ -362,6 +368,64 @@ void tst_QSocketNotifier::posixSockets()
 }
 #endif
 
+#if QT_CONFIG(epoll)
+void tst_QSocketNotifier::epollDispatcher()
+{
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QVERIFY(file.write("regular files are always readable") > 0);
+    QVERIFY(file.flush());
+
+    qputenv("QT_EVENT_DISPATCHER_EPOLL", "1");
+    QAbstractEventDispatcher *dispatcher = new QEventDispatcherUNIX;
+    qunsetenv("QT_EVENT_DISPATCHER_EPOLL");
+
+    bool pipeWritable = false;
+    bool pipeReadable = false;
+    bool fileReadable = false;
+    QScopedPointer<QThread> thread(QThread::create([&] {
+        int fds[2];
+        if (qt_safe_pipe(fds, O_NONBLOCK) == -1)
+            return;
+
+        QEventLoop loop;
+        QSocketNotifier rn(fds[0], QSocketNotifier::Read);
+        QSocketNotifier wn(fds[1], QSocketNotifier::Write);
+        QSocketNotifier fn(file.handle(), QSocketNotifier::Read);
+        connect(&wn, &QSocketNotifier::activated, [&] {
+            pipeWritable = true;
+            wn.setEnabled(false);
+            qt_safe_write(fds[1], "x", 1);
+        });
+        connect(&rn, &QSocketNotifier::activated, [&] {
+            char c;
+            qt_safe_read(fds[0], &c, 1);
+            pipeReadable = true;
+            if (fileReadable)
+                loop.quit();
+        });
+        connect(&fn, &QSocketNotifier::activated, [&] {
+            fileReadable = true;
+            fn.setEnabled(false);
+            if (pipeReadable)
+                loop.quit();
+        });
+        QTimer::singleShot(5000, &loop, &QEventLoop::quit);
+        loop.exec();
+
+        qt_safe_close(fds[0]);
+        qt_safe_close(fds[1]);
+    }));
+    thread->setEventDispatcher(dispatcher);
+    thread->start();
+    QVERIFY(thread->wait(10000));
+
+    QVERIFY(pipeWritable);
+    QVERIFY(pipeReadable);
+    QVERIFY(fileReadable);
+}
+#endif
+
 void tst_QSocketNotifier::async_readDatagramSlot()
 {
     char buf[1];
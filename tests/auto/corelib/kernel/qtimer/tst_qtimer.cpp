@@ -87,6 +87,9 @@ private slots:
     void timerOrderBackgroundThread();
     void timerOrderBackgroundThread_data() { timerOrder_data(); }
 
+    void manyTimers_data();
+    void manyTimers();
+
     void dontBlockEvents();
     void postedEventsShouldNotStarveTimers();
     void callOnTimeout();
@@ -957,6 +960,75 @@ void tst_QTimer::singleShot_chrono()
 #endif
 }
 
+class ManyTimersObject : public QObject
+{
+public:
+    struct Timer {
+        int interval;
+        qint64 fired = -1; // msecs since elapsed was started
+    };
+    QHash<int, Timer> timers;
+    QList<int> firingOrder;
+    QElapsedTimer elapsed;
+
+    void timerEvent(QTimerEvent *e) override
+    {
+        auto it = timers.find(e->timerId());
+        QVERIFY(it != timers.end());
+        QCOMPARE(it->fired, -1);
+        it->fired = elapsed.elapsed();
+        firingOrder.append(e->timerId());
+        killTimer(e->timerId());
+    }
+};
+
+void tst_QTimer::manyTimers_data()
+{
+    QTest::addColumn<Qt::TimerType>("timerType");
+    QTest::newRow("precise") << Qt::PreciseTimer;
+    QTest::newRow("coarse") << Qt::CoarseTimer;
+}
+
+void tst_QTimer::manyTimers()
+{
+    // intervals spanning several levels of the timer wheel, killing some of
+    // the timers before they fire
+    QFETCH(Qt::TimerType, timerType);
+    constexpr int timerCount = 3000;
+
+    ManyTimersObject object;
+    QList<int> killed;
+    object.elapsed.start();
+    for (int i = 0; i < timerCount; ++i) {
+        const int interval = (i * 7919) % 600;
+        const int id = object.startTimer(interval, timerType);
+        QVERIFY(id > 0);
+        if (i % 3 == 2)
+            killed.append(id);
+        else
+            object.timers.insert(id, { interval });
+    }
+    for (int id : qAsConst(killed))
+        object.killTimer(id);
+
+    QTRY_COMPARE_WITH_TIMEOUT(object.firingOrder.size(), object.timers.size(), 10000);
+
+    int maxInterval = 0;
+    for (int id : qAsConst(object.firingOrder)) {
+        const ManyTimersObject::Timer &timer = object.timers.value(id);
+        if (timerType == Qt::PreciseTimer) {
+            QVERIFY2(timer.fired >= timer.interval, qPrintable(QString::number(timer.interval)));
+            // allow for the time it took to start all of them
+            QVERIFY2(timer.interval >= maxInterval - 20, qPrintable(QString::number(timer.interval)));
+        } else {
+            // coarse timers may fire up to 5% early
+            QVERIFY2(timer.fired >= timer.interval - timer.interval / 20 - 1,
+                     qPrintable(QString::number(timer.interval)));
+        }
+        maxInterval = qMax(maxInterval, timer.interval);
+    }
+}
+
 class DontBlockEvents : public QObject
 {
     Q_OBJECT
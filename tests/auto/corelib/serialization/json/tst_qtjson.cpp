@@ -120,6 +120,8 @@ private Q_SLOTS:
 
     void parseEscapes_data();
     void parseEscapes();
+    void parseBlockBoundaries_data();
+    void parseBlockBoundaries();
     void makeEscapes_data();
     void makeEscapes();
 
@@ -2498,6 +2500,51 @@ void tst_QtJson::parseEscapes()
     QCOMPARE(array.first().toString(), result);
 }
 
+void tst_QtJson::parseBlockBoundaries_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QString>("result");
+
+    // the parser indexes documents in blocks of 64 bytes, make sure escape
+    // sequences, strings and numbers crossing them are handled
+    for (int padding = 56; padding < 72; ++padding) {
+        const QByteArray spaces(padding, ' ');
+        for (int backslashes = 0; backslashes < 4; ++backslashes) {
+            const QByteArray escaped = QByteArray(2 * backslashes, '\\') + "\\\"";
+            QTest::addRow("escaped-quote-%d-%d", padding, backslashes)
+                    << "[" + spaces + "\"" + escaped + "\", 123 ]"
+                    << QString(backslashes, u'\\') + u'"';
+            QTest::addRow("backslashes-%d-%d", padding, backslashes)
+                    << "[" + spaces + "\"" + QByteArray(2 * backslashes, '\\') + "\", 123 ]"
+                    << QString(backslashes, u'\\');
+        }
+        QTest::addRow("utf8-%d", padding)
+                << "[" + spaces + "\"\xc3\xa4\xe2\x82\xac\", 123 ]" << QStringLiteral(u"\u00e4\u20ac");
+        QTest::addRow("structural-%d", padding)
+                << "[" + spaces + "\"{[:,]}\", 123 ]" << QStringLiteral("{[:,]}");
+    }
+}
+
+void tst_QtJson::parseBlockBoundaries()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QString, result);
+
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(json, &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QJsonArray array = doc.array();
+    QCOMPARE(array.size(), 2);
+    QCOMPARE(array.first().toString(), result);
+    QCOMPARE(array.last().toInteger(), 123);
+
+    // cutting the document short anywhere must be an error
+    for (int i = 1; i < json.size(); ++i) {
+        QJsonDocument::fromJson(json.left(i), &error);
+        QVERIFY2(error.error != QJsonParseError::NoError, json.left(i).constData());
+    }
+}
+
 void tst_QtJson::makeEscapes_data()
 {
     QTest::addColumn<QString>("input");
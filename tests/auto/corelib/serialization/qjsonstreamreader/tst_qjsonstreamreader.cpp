@@ -0,0 +1,371 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+#include <QtCore/qbuffer.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonobject.h>
+#include <QtCore/qjsonstreamreader.h>
+#include <QtCore/qmetaobject.h>
+
+class tst_QJsonStreamReader : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void tokens_data();
+    void tokens();
+    void chunked_data();
+    void chunked();
+    void device();
+    void stringViews();
+    void errors_data();
+    void errors();
+    void endOfData_data();
+    void endOfData();
+    void deepNesting();
+};
+
+// Describes the tokens of a document, one per line, stopping at the first
+// token that isn't a value.
+static QString describeTokens(QJsonStreamReader &reader)
+{
+    const QMetaEnum tokenTypes = QMetaEnum::fromType<QJsonStreamReader::TokenType>();
+    QStringList tokens;
+    while (true) {
+        const QJsonStreamReader::TokenType type = reader.readNext();
+        if (type == QJsonStreamReader::NoToken || type == QJsonStreamReader::Invalid)
+            break;
+        QString token = QString::fromLatin1(tokenTypes.valueToKey(type));
+        switch (type) {
+        case QJsonStreamReader::Key:
+        case QJsonStreamReader::String:
+            token += u':' + reader.toString();
+            break;
+        case QJsonStreamReader::Integer:
+            token += u':' + QString::number(reader.toInteger());
+            break;
+        case QJsonStreamReader::Double:
+            token += u':' + QString::number(reader.toDouble());
+            break;
+        case QJsonStreamReader::Bool:
+            token += reader.toBool() ? u":true" : u":false";
+            break;
+        default:
+            break;
+        }
+        tokens << token;
+    }
+    return tokens.join(u' ');
+}
+
+void tst_QJsonStreamReader::tokens_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("empty-object") << QByteArray("{}") << u"StartObject EndObject"_qs;
+    QTest::newRow("empty-array") << QByteArray(" [ ] ") << u"StartArray EndArray"_qs;
+    QTest::newRow("literals") << QByteArray("[true,false,null]")
+                              << u"StartArray Bool:true Bool:false Null EndArray"_qs;
+    QTest::newRow("numbers") << QByteArray("[0, -7, 1.5, 2e3, -0.25E-1, 9223372036854775807, "
+                                           "9223372036854775808]")
+                             << u"StartArray Integer:0 Integer:-7 Double:1.5 Double:2000 "
+                                "Double:-0.025 Integer:9223372036854775807 "
+                                "Double:9.22337e+18 EndArray"_qs;
+    QTest::newRow("object") << QByteArray("{ \"id\": 42, \"tags\": [ \"new\", true ] }")
+                            << u"StartObject Key:id Integer:42 Key:tags StartArray String:new "
+                               "Bool:true EndArray EndObject"_qs;
+    QTest::newRow("nested") << QByteArray("[[[]],{\"a\":{\"b\":[{}]}}]")
+                            << u"StartArray StartArray StartArray EndArray EndArray StartObject "
+                               "Key:a StartObject Key:b StartArray StartObject EndObject EndArray "
+                               "EndObject EndObject EndArray"_qs;
+    QTest::newRow("escapes") << QByteArray(R"(["a\"b", "\\\/\b\f\n\r\t", "\u00e9\ud83d\ude00"])")
+                             << u"StartArray String:a\"b String:\\/\b\f\n\r\t String:é\U0001F600 "
+                                "EndArray"_qs;
+    QTest::newRow("utf8") << QByteArray("{\"Gr\xc3\xbc\xc3\x9f""e\":\"\xe2\x82\xac\"}")
+                          << u"StartObject Key:Grüße String:€ EndObject"_qs;
+    QTest::newRow("json-lines") << QByteArray("{\"a\":1}\n[2]\n\"three\"\nnull\n")
+                                << u"StartObject Key:a Integer:1 EndObject StartArray Integer:2 "
+                                   "EndArray String:three Null"_qs;
+    QTest::newRow("trailing-number") << QByteArray("[1] 2")
+                                     << u"StartArray Integer:1 EndArray Integer:2"_qs;
+    QTest::newRow("lone-number") << QByteArray("-1.5") << u"Double:-1.5"_qs;
+    QTest::newRow("json-lines-unterminated") << QByteArray("{\"a\":1}\n42")
+                                             << u"StartObject Key:a Integer:1 EndObject "
+                                                "Integer:42"_qs;
+    QTest::newRow("bom") << QByteArray("\xef\xbb\xbf{\"a\":[]}")
+                         << u"StartObject Key:a StartArray EndArray EndObject"_qs;
+    QTest::newRow("bom-scalar") << QByteArray("\xef\xbb\xbf\"text\"") << u"String:text"_qs;
+}
+
+void tst_QJsonStreamReader::tokens()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QString, expected);
+
+    QJsonStreamReader reader(json);
+    reader.setEndOfData();
+    QCOMPARE(describeTokens(reader), expected);
+    QVERIFY(!reader.hasError());
+    QVERIFY(reader.atEnd());
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::NoToken);
+    QCOMPARE(reader.containerDepth(), 0);
+}
+
+void tst_QJsonStreamReader::chunked_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    QTest::newRow("simple") << QByteArray(
+            R"({ "id": 42, "name": "Grüße", "values": [1.5, -2, 3e10, true, false, null] })");
+    QTest::newRow("escapes") << QByteArray(
+            R"({"k\"ey": "\ud83d\ude00 and \\ and \u00e9", "x": ["\n", "\""]})");
+
+    QJsonArray array;
+    for (int i = 0; i < 200; ++i) {
+        array.append(QJsonObject{ { "index", i }, { "half", i / 2.0 },
+                                  { "text", QString(i % 40, u'é') + u"\t\""_qs } });
+    }
+    QTest::newRow("large") << QJsonDocument(array).toJson();
+    QTest::newRow("bom") << QByteArray("\xef\xbb\xbf[\"x\", 1]");
+    QTest::newRow("long-strings") << (QByteArray("[\"") + QByteArray(500, 'a') + "\", \""
+                                      + QByteArray(200, 'b') + "\\\"" + QByteArray(300, 'c')
+                                      + "\\n\"]");
+}
+
+void tst_QJsonStreamReader::chunked()
+{
+    QFETCH(QByteArray, json);
+
+    QJsonStreamReader reference(json);
+    const QString expected = describeTokens(reference);
+    QVERIFY(!reference.hasError());
+
+    for (qsizetype chunkSize : { 1, 2, 3, 7, 16, 100 }) {
+        QJsonStreamReader reader;
+        QString tokens;
+        for (qsizetype i = 0; i < json.size(); i += chunkSize) {
+            reader.addData(json.mid(i, chunkSize));
+            QVERIFY(!reader.atEnd());
+            const QString more = describeTokens(reader);
+            QVERIFY(reader.atEnd());
+            if (!more.isEmpty())
+                tokens += (tokens.isEmpty() ? QString() : u" "_qs) + more;
+        }
+        QVERIFY(!reader.hasError());
+        QCOMPARE(tokens, expected);
+    }
+}
+
+void tst_QJsonStreamReader::device()
+{
+    // bigger than the chunks the reader reads from the device
+    QJsonArray array;
+    for (int i = 0; i < 5000; ++i)
+        array.append(QJsonObject{ { "id", i }, { "name", u"Zürich"_qs } });
+    QByteArray json = QJsonDocument(array).toJson(QJsonDocument::Compact);
+
+    QBuffer buffer(&json);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamReader reader(&buffer);
+    QCOMPARE(reader.device(), &buffer);
+
+    int count = 0;
+    QString lastName;
+    while (!reader.atEnd()) {
+        if (reader.readNext() == QJsonStreamReader::Key && reader.text() == u"id") {
+            QCOMPARE(reader.readNext(), QJsonStreamReader::Integer);
+            QCOMPARE(reader.toInteger(), count);
+            ++count;
+        } else if (reader.isString()) {
+            lastName = reader.toString();
+        }
+    }
+    QVERIFY(!reader.hasError());
+    QCOMPARE(count, 5000);
+    QCOMPARE(lastName, u"Zürich"_qs);
+    QCOMPARE(reader.currentOffset(), json.size() - 1);
+}
+
+static const char *encodingOf(QAnyStringView str)
+{
+    return str.visit([](auto view) {
+        using View = decltype(view);
+        if constexpr (std::is_same_v<View, QLatin1String>)
+            return "Latin-1";
+        else if constexpr (std::is_same_v<View, QUtf8StringView>)
+            return "UTF-8";
+        else
+            return "UTF-16";
+    });
+}
+
+void tst_QJsonStreamReader::stringViews()
+{
+    const QByteArray json = R"(["ascii", "Grüße", "esc\naped"])";
+    QJsonStreamReader reader(json);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+
+    // strings without escape sequences are not copied
+    QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+    QCOMPARE(encodingOf(reader.text()), "Latin-1");
+    QCOMPARE(reader.text().data(), json.constData() + 2);
+    QCOMPARE(reader.text(), u"ascii");
+
+    QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+    QCOMPARE(encodingOf(reader.text()), "UTF-8");
+    QCOMPARE(reader.text().data(), json.constData() + json.indexOf("Gr"));
+    QCOMPARE(reader.text(), u"Grüße");
+
+    QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+    QCOMPARE(encodingOf(reader.text()), "UTF-16");
+    QCOMPARE(reader.text(), u"esc\naped");
+
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndArray);
+    QVERIFY(reader.text().isEmpty());
+}
+
+void tst_QJsonStreamReader::errors_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QJsonParseError::ParseError>("error");
+    QTest::addColumn<int>("offset");
+
+    QTest::newRow("bad-value") << QByteArray("[1, x]") << QJsonParseError::IllegalValue << 4;
+    QTest::newRow("bad-literal") << QByteArray("[tru ]") << QJsonParseError::IllegalValue << 1;
+    QTest::newRow("missing-colon") << QByteArray("{\"a\" 1}")
+                                   << QJsonParseError::MissingNameSeparator << 5;
+    QTest::newRow("missing-comma") << QByteArray("[1 2]")
+                                   << QJsonParseError::MissingValueSeparator << 3;
+    QTest::newRow("mismatched-array") << QByteArray("[1}") << QJsonParseError::UnterminatedArray
+                                      << 2;
+    QTest::newRow("mismatched-object") << QByteArray("{\"a\":1]")
+                                       << QJsonParseError::UnterminatedObject << 6;
+    QTest::newRow("trailing-comma") << QByteArray("{\"a\":1,}") << QJsonParseError::IllegalValue
+                                    << 7;
+    QTest::newRow("non-string-key") << QByteArray("{1:2}") << QJsonParseError::IllegalValue << 1;
+    QTest::newRow("bad-number") << QByteArray("[-]") << QJsonParseError::IllegalNumber << 1;
+    QTest::newRow("bad-escape") << QByteArray(R"(["\u12x4"])")
+                                << QJsonParseError::IllegalEscapeSequence << 2;
+    QTest::newRow("bad-utf8") << QByteArray("[\"\xc3\"]") << QJsonParseError::IllegalUTF8String
+                              << 1;
+    QTest::newRow("bad-utf8-escaped") << QByteArray("[\"\\n\xff\"]")
+                                      << QJsonParseError::IllegalUTF8String << 4;
+}
+
+void tst_QJsonStreamReader::errors()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QJsonParseError::ParseError, error);
+    QFETCH(int, offset);
+
+    QJsonStreamReader reader(json);
+    QJsonStreamReader::TokenType type;
+    while ((type = reader.readNext()) != QJsonStreamReader::Invalid)
+        QVERIFY2(type != QJsonStreamReader::NoToken, "error not detected");
+
+    QVERIFY(reader.hasError());
+    QVERIFY(reader.atEnd());
+    QCOMPARE(reader.lastError().error, error);
+    QCOMPARE(reader.lastError().offset, offset);
+
+    // errors are final
+    reader.addData("[]");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+
+    reader.clear();
+    QVERIFY(!reader.hasError());
+    reader.addData("[]");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+}
+
+void tst_QJsonStreamReader::endOfData_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QJsonParseError::ParseError>("error");
+    QTest::addColumn<int>("offset");
+
+    QTest::newRow("array") << QByteArray("[1, [2]") << QJsonParseError::UnterminatedArray << 7;
+    QTest::newRow("object") << QByteArray("{\"a\": ") << QJsonParseError::UnterminatedObject
+                            << 6;
+    QTest::newRow("after-key") << QByteArray("{\"a\"") << QJsonParseError::UnterminatedObject
+                               << 4;
+    QTest::newRow("string") << QByteArray("[\"abc") << QJsonParseError::UnterminatedString << 1;
+    QTest::newRow("escape") << QByteArray("[\"abc\\") << QJsonParseError::UnterminatedString
+                            << 1;
+    QTest::newRow("literal") << QByteArray("[tr") << QJsonParseError::IllegalValue << 1;
+    QTest::newRow("number") << QByteArray("1e") << QJsonParseError::IllegalNumber << 0;
+    QTest::newRow("bom") << QByteArray("\xef\xbb") << QJsonParseError::IllegalValue << 0;
+}
+
+void tst_QJsonStreamReader::endOfData()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QJsonParseError::ParseError, error);
+    QFETCH(int, offset);
+
+    // without setEndOfData(), more data might still arrive
+    QJsonStreamReader reader(json);
+    describeTokens(reader);
+    QVERIFY(!reader.hasError());
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::NoToken);
+
+    reader.setEndOfData();
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.lastError().error, error);
+    QCOMPARE(reader.lastError().offset, offset);
+
+    // adding data undoes setEndOfData()
+    QJsonStreamReader resumed(QByteArray("[1"));
+    resumed.setEndOfData();
+    resumed.addData("2]");
+    QCOMPARE(describeTokens(resumed), u"StartArray Integer:12 EndArray"_qs);
+    QVERIFY(!resumed.hasError());
+}
+
+void tst_QJsonStreamReader::deepNesting()
+{
+    QJsonStreamReader reader(QByteArray(1024, '[') + QByteArray(1024, ']'));
+    for (int i = 0; i < 1024; ++i)
+        QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.containerDepth(), 1024);
+    for (int i = 0; i < 1024; ++i)
+        QCOMPARE(reader.readNext(), QJsonStreamReader::EndArray);
+    QCOMPARE(reader.containerDepth(), 0);
+
+    reader.clear();
+    reader.addData(QByteArray(1025, '['));
+    while (reader.readNext() == QJsonStreamReader::StartArray)
+        ;
+    QCOMPARE(reader.lastError().error, QJsonParseError::DeepNesting);
+}
+
+QTEST_MAIN(tst_QJsonStreamReader)
+#include "tst_qjsonstreamreader.moc"
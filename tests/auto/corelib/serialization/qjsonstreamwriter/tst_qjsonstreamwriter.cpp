@@ -0,0 +1,443 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+#include <QtCore/qbuffer.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonobject.h>
+#include <QtCore/qjsonstreamwriter.h>
+
+#include <cmath>
+#include <limits>
+
+class tst_QJsonStreamWriter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void scalars_data();
+    void scalars();
+    void containers();
+    void matchesToJson_data();
+    void matchesToJson();
+    void escaping_data();
+    void escaping();
+    void doubles_data();
+    void doubles();
+    void jsonLines();
+    void deviceBuffering();
+    void deviceErrors();
+    void misuse();
+};
+
+void tst_QJsonStreamWriter::scalars_data()
+{
+    QTest::addColumn<QJsonValue>("value");
+    QTest::addColumn<QByteArray>("expected");
+
+    QTest::newRow("null") << QJsonValue(QJsonValue::Null) << QByteArray("null");
+    QTest::newRow("undefined") << QJsonValue(QJsonValue::Undefined) << QByteArray("null");
+    QTest::newRow("true") << QJsonValue(true) << QByteArray("true");
+    QTest::newRow("false") << QJsonValue(false) << QByteArray("false");
+    QTest::newRow("zero") << QJsonValue(0) << QByteArray("0");
+    QTest::newRow("negative") << QJsonValue(-42) << QByteArray("-42");
+    QTest::newRow("int64-min") << QJsonValue(std::numeric_limits<qint64>::min())
+                               << QByteArray("-9223372036854775808");
+    QTest::newRow("int64-max") << QJsonValue(std::numeric_limits<qint64>::max())
+                               << QByteArray("9223372036854775807");
+    QTest::newRow("double") << QJsonValue(1.5) << QByteArray("1.5");
+    QTest::newRow("string") << QJsonValue(u"Hello"_qs) << QByteArray("\"Hello\"");
+}
+
+void tst_QJsonStreamWriter::scalars()
+{
+    QFETCH(QJsonValue, value);
+    QFETCH(QByteArray, expected);
+
+    QByteArray output;
+    {
+        QJsonStreamWriter writer(&output);
+        writer.appendValue(value);
+    }
+    QCOMPARE(output, expected);
+}
+
+void tst_QJsonStreamWriter::containers()
+{
+    QByteArray output;
+    QJsonStreamWriter writer(&output);
+    writer.startObject();
+    writer.appendKey(u"a");
+    writer.append(1);
+    writer.appendKey(QLatin1String("b"));
+    writer.startArray();
+    writer.append(true);
+    writer.append(nullptr);
+    writer.append(quint64(18446744073709551615ULL));
+    writer.append("text");
+    writer.startObject();
+    QVERIFY(writer.endObject());
+    writer.startArray();
+    QVERIFY(writer.endArray());
+    QVERIFY(writer.endArray());
+    writer.appendKey("c");
+    writer.appendNull();
+    QVERIFY(writer.endObject());
+
+    QCOMPARE(output, QByteArray(R"({"a":1,"b":[true,null,18446744073709551615,"text",{},[]],"c":null})"));
+}
+
+void tst_QJsonStreamWriter::matchesToJson_data()
+{
+    QTest::addColumn<QJsonValue>("value");
+
+    QTest::newRow("empty-object") << QJsonValue(QJsonObject());
+    QTest::newRow("empty-array") << QJsonValue(QJsonArray());
+    QTest::newRow("flat") << QJsonValue(QJsonObject{
+            { "int", 12 }, { "neg", -3 }, { "fraction", 0.25 }, { "bool", false },
+            { "null", QJsonValue::Null }, { "string", "a \"quoted\" \\ string\n" } });
+
+    const QJsonObject nested{
+        { "empty", QJsonObject() },
+        { "emptyArray", QJsonArray() },
+        { "list", QJsonArray{ 1, "two", QJsonArray{ 3, QJsonObject{ { "four", 4 } } } } },
+        { u"Grüße"_qs, u"日本\U0001F600"_qs },
+    };
+    QTest::newRow("nested-object") << QJsonValue(nested);
+    QTest::newRow("nested-array") << QJsonValue(QJsonArray{ nested, QJsonArray(), nested });
+}
+
+void tst_QJsonStreamWriter::matchesToJson()
+{
+    QFETCH(QJsonValue, value);
+
+    const QJsonDocument doc = value.isObject() ? QJsonDocument(value.toObject())
+                                               : QJsonDocument(value.toArray());
+    for (auto format : { QJsonDocument::Compact, QJsonDocument::Indented }) {
+        QByteArray output;
+        QJsonStreamWriter writer(&output);
+        writer.setFormat(format);
+        writer.appendValue(value);
+        QCOMPARE(output, doc.toJson(format));
+    }
+}
+
+void tst_QJsonStreamWriter::escaping_data()
+{
+    QTest::addColumn<QString>("string");
+
+    // place each interesting character before, on and after the 16-byte
+    // boundaries of the vectorized loops
+    const QString filler = u"abcdefghijklmnopqrstuvwxyz0123456789"_qs;
+    const struct {
+        const char *name;
+        QString special;
+    } specials[] = {
+        { "quote", u"\""_qs },
+        { "backslash", u"\\"_qs },
+        { "newline", u"\n"_qs },
+        { "nul", QString(QChar(0)) },
+        { "control", u"\x1f"_qs },
+        { "del", u"\x7f"_qs },
+        { "latin1", u"é"_qs },
+        { "bmp", u"€"_qs },
+        { "surrogate-pair", u"\U0001F600"_qs },
+        { "unpaired-high", QString(QChar(0xd800)) },
+        { "unpaired-low", QString(QChar(0xdc00)) },
+    };
+    for (const auto &s : specials) {
+        for (int pos : { 0, 1, 14, 15, 16, 17, 31, 32 }) {
+            QString str = filler;
+            str.insert(pos, s.special);
+            QTest::addRow("%s-%d", s.name, pos) << str;
+        }
+    }
+    QTest::newRow("empty") << QString();
+    QTest::newRow("all-special") << u"\"\\\"\\\n\r\t\b\f\"\"\"\"\"\"\"\"\"\"\"\""_qs;
+
+    // longer than one escaping chunk, with a surrogate pair straddling it
+    QString longString(4095, u'x');
+    longString += u"\U0001F600"_qs;
+    longString += QString(5000, u'"');
+    QTest::newRow("long") << longString;
+}
+
+void tst_QJsonStreamWriter::escaping()
+{
+    QFETCH(QString, string);
+
+    QByteArray expected = QJsonDocument(QJsonArray{ string }).toJson(QJsonDocument::Compact);
+    expected = expected.mid(1, expected.size() - 2);
+
+    QByteArray output;
+    {
+        QJsonStreamWriter writer(&output);
+        writer.append(string);
+    }
+    QCOMPARE(output, expected);
+
+    // UTF-8 input takes a different path, as long as it is valid
+    bool hasUnpairedSurrogate = false;
+    for (qsizetype i = 0; i < string.size(); ++i) {
+        if (string.at(i).isHighSurrogate() && i + 1 < string.size()
+            && string.at(i + 1).isLowSurrogate()) {
+            ++i;
+        } else if (string.at(i).isSurrogate()) {
+            hasUnpairedSurrogate = true;
+        }
+    }
+    if (!hasUnpairedSurrogate) {
+        output.clear();
+        {
+            QJsonStreamWriter writer(&output);
+            writer.append(QUtf8StringView(string.toUtf8()));
+        }
+        QCOMPARE(output, expected);
+    }
+
+    // and so does Latin-1
+    bool isLatin1 = std::all_of(string.cbegin(), string.cend(),
+                                [](QChar c) { return c.unicode() < 0x100; });
+    if (isLatin1) {
+        output.clear();
+        {
+            QJsonStreamWriter writer(&output);
+            writer.append(QLatin1String(string.toLatin1()));
+        }
+        QCOMPARE(output, expected);
+    }
+
+    // keys are escaped the same way
+    output.clear();
+    {
+        QJsonStreamWriter writer(&output);
+        writer.startObject();
+        writer.appendKey(string);
+        writer.append(0);
+        writer.endObject();
+    }
+    QCOMPARE(output, '{' + expected + ":0}");
+}
+
+void tst_QJsonStreamWriter::doubles_data()
+{
+    QTest::addColumn<double>("value");
+
+    QTest::newRow("zero") << 0.0;
+    QTest::newRow("one") << 1.0;
+    QTest::newRow("fraction") << 0.1;
+    QTest::newRow("negative") << -1234.5678;
+    QTest::newRow("large") << 1e300;
+    QTest::newRow("small") << 5e-324;
+    QTest::newRow("max") << std::numeric_limits<double>::max();
+    QTest::newRow("2^53+2") << 9007199254740994.0;
+    QTest::newRow("third") << 1.0 / 3;
+}
+
+void tst_QJsonStreamWriter::doubles()
+{
+    QFETCH(double, value);
+
+    QByteArray output;
+    {
+        QJsonStreamWriter writer(&output);
+        writer.startArray();
+        writer.append(value);
+        writer.endArray();
+    }
+
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(output, &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QCOMPARE(doc.array().at(0).toDouble(), value);
+}
+
+void tst_QJsonStreamWriter::jsonLines()
+{
+    QByteArray output;
+    {
+        QJsonStreamWriter writer(&output);
+        writer.startObject();
+        writer.appendKey("id");
+        writer.append(1);
+        writer.endObject();
+        writer.append(std::numeric_limits<double>::infinity());
+        writer.append(qQNaN());
+        writer.append("last");
+    }
+    QCOMPARE(output, QByteArray("{\"id\":1}\nnull\nnull\n\"last\""));
+}
+
+void tst_QJsonStreamWriter::deviceBuffering()
+{
+    QByteArray storage;
+    QBuffer buffer(&storage);
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+
+    QJsonArray reference;
+    {
+        QJsonStreamWriter writer(&buffer);
+        QCOMPARE(writer.device(), &buffer);
+        writer.startArray();
+        writer.append(u"small"_qs);
+        reference.append(u"small"_qs);
+        QVERIFY(storage.isEmpty());
+
+        // a string several times larger than the internal buffer goes out
+        // piecewise, before the writer is done
+        const QString big(200 * 1024, u'é');
+        writer.append(big);
+        reference.append(big);
+        QVERIFY(!storage.isEmpty());
+
+        for (int i = 0; i < 10000; ++i) {
+            writer.append(i);
+            reference.append(i);
+        }
+        writer.endArray();
+        writer.flush();
+        QCOMPARE(storage, QJsonDocument(reference).toJson(QJsonDocument::Compact));
+    }
+
+    // switching devices flushes what was written to the old one
+    QByteArray other;
+    QBuffer otherBuffer(&other);
+    QVERIFY(otherBuffer.open(QIODevice::WriteOnly));
+    storage.clear();
+    buffer.seek(0);
+    {
+        QJsonStreamWriter writer(&buffer);
+        writer.append(1);
+        writer.setDevice(&otherBuffer);
+        QCOMPARE(storage, QByteArray("1"));
+        writer.append(2);
+    }
+    QCOMPARE(other, QByteArray("\n2"));
+}
+
+// Accepts at most limit bytes, then reports short writes
+class LimitedDevice : public QIODevice
+{
+public:
+    explicit LimitedDevice(qint64 limit) : limit(limit) {}
+    QByteArray written;
+
+protected:
+    qint64 readData(char *, qint64) override { return -1; }
+    qint64 writeData(const char *data, qint64 len) override
+    {
+        len = qMin(len, limit);
+        limit -= len;
+        written.append(data, len);
+        return len;
+    }
+
+private:
+    qint64 limit;
+};
+
+void tst_QJsonStreamWriter::deviceErrors()
+{
+    {
+        QByteArray output;
+        QJsonStreamWriter writer(&output);
+        writer.append(1);
+        writer.flush();
+        QVERIFY(!writer.hasError());
+    }
+
+    // the device is not open for writing
+    {
+        QBuffer buffer;
+        QJsonStreamWriter writer(&buffer);
+        writer.append(1);
+        QVERIFY(!writer.hasError());    // still buffered
+        QTest::ignoreMessage(QtWarningMsg, "QIODevice::write (QBuffer): device not open");
+        writer.flush();
+        QVERIFY(writer.hasError());
+    }
+
+    // short write: nothing more is sent once the device has fallen behind
+    {
+        LimitedDevice device(8);
+        QVERIFY(device.open(QIODevice::WriteOnly));
+        QJsonStreamWriter writer(&device);
+        writer.append("abc");
+        writer.flush();
+        QVERIFY(!writer.hasError());
+        QCOMPARE(device.written, QByteArray("\"abc\""));
+
+        device.written.clear();
+        writer.append(12345);
+        writer.flush();
+        QVERIFY(writer.hasError());
+        QCOMPARE(device.written, QByteArray("\n12"));
+
+        device.written.clear();
+        writer.append(6);
+        writer.flush();
+        QVERIFY(writer.hasError());
+        QVERIFY(device.written.isEmpty());
+
+        // not reset by switching devices
+        QByteArray storage;
+        QBuffer buffer(&storage);
+        QVERIFY(buffer.open(QIODevice::WriteOnly));
+        writer.setDevice(&buffer);
+        QVERIFY(writer.hasError());
+    }
+}
+
+void tst_QJsonStreamWriter::misuse()
+{
+    QByteArray output;
+    QJsonStreamWriter writer(&output);
+
+    QTest::ignoreMessage(QtWarningMsg, "QJsonStreamWriter: closing array that wasn't open");
+    QVERIFY(!writer.endArray());
+
+    writer.startObject();
+    QTest::ignoreMessage(QtWarningMsg, "QJsonStreamWriter: closing array that wasn't open");
+    QVERIFY(!writer.endArray());
+    writer.appendKey("k");
+    QTest::ignoreMessage(QtWarningMsg,
+                         "QJsonStreamWriter: object closed after a key without a value");
+    QVERIFY(!writer.endObject());
+    QCOMPARE(output, QByteArray("{\"k\":null}"));
+
+    output.clear();
+    writer.startObject();
+    QTest::ignoreMessage(QtWarningMsg,
+                         "QJsonStreamWriter: value appended to an object without a key");
+    writer.append(1);
+    QVERIFY(writer.endObject());
+}
+
+QTEST_MAIN(tst_QJsonStreamWriter)
+#include "tst_qjsonstreamwriter.moc"
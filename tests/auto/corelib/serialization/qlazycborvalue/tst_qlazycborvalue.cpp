@@ -0,0 +1,242 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+#include <QtCore/qcborarray.h>
+#include <QtCore/qcbormap.h>
+#include <QtCore/qcborstreamwriter.h>
+#include <QtCore/private/qlazycborvalue_p.h>
+
+class tst_QLazyCborValue : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void types_data();
+    void types();
+    void mapLookup();
+    void arrayAccess();
+    void indefiniteLength();
+    void malformed();
+    void iteration();
+    void compareWithValue();
+};
+
+void tst_QLazyCborValue::types_data()
+{
+    QTest::addColumn<QCborValue>("value");
+    QTest::addColumn<QCborValue::Type>("type");
+
+    QTest::newRow("integer") << QCborValue(-42) << QCborValue::Integer;
+    QTest::newRow("large-unsigned") << QCborValue(1e19) << QCborValue::Double;
+    QTest::newRow("double") << QCborValue(1.5) << QCborValue::Double;
+    QTest::newRow("bytearray") << QCborValue(QByteArray("\1\2")) << QCborValue::ByteArray;
+    QTest::newRow("string") << QCborValue("Grüße") << QCborValue::String;
+    QTest::newRow("false") << QCborValue(false) << QCborValue::False;
+    QTest::newRow("null") << QCborValue(nullptr) << QCborValue::Null;
+    QTest::newRow("simple") << QCborValue(QCborSimpleType(42)) << QCborValue::Type(QCborValue::SimpleType + 42);
+    QTest::newRow("tag") << QCborValue(QCborKnownTags::Signature, 1) << QCborValue::Tag;
+    QTest::newRow("array") << QCborValue(QCborArray { 1, "2" }) << QCborValue::Array;
+    QTest::newRow("map") << QCborValue(QCborMap { { 1, 2 } }) << QCborValue::Map;
+}
+
+void tst_QLazyCborValue::types()
+{
+    QFETCH(QCborValue, value);
+    QFETCH(QCborValue::Type, type);
+
+    if (value.isDouble() && type == QCborValue::Double && value.toDouble() == 1e19) {
+        // QCborValue would encode it as a double, write the integer by hand
+        QByteArray cbor;
+        QCborStreamWriter writer(&cbor);
+        writer.append(Q_UINT64_C(10000000000000000000));
+        QCOMPARE(QLazyCborValue(cbor).type(), type);
+        QCOMPARE(QLazyCborValue(cbor).toCborValue().type(), type);
+        return;
+    }
+
+    const QLazyCborValue lazy(QCborArray { value }.toCborValue().toCbor());
+    QCOMPARE(lazy.type(), QCborValue::Array);
+    QCOMPARE(lazy.size(), 1);
+    QCOMPARE(lazy[0].type(), type);
+    QCOMPARE(lazy[0].toCborValue(), value);
+    QVERIFY(lazy[1].isInvalid());
+}
+
+void tst_QLazyCborValue::mapLookup()
+{
+    const QCborMap map {
+        { 1, "one" },
+        { "two", 2 },
+        { QCborArray { 3 }, "array key" },
+        { "four", QCborMap { { "inner", QCborArray { 1, 2, 3 } } } },
+        { u"fünf"_qs, 5 }
+    };
+    const QLazyCborValue lazy(map.toCborValue().toCbor());
+    QVERIFY(lazy.isMap());
+    QCOMPARE(lazy.size(), 5);
+    QCOMPARE(lazy.value(1).toCborValue(), QCborValue("one"));
+    QCOMPARE(lazy["two"].toCborValue(), QCborValue(2));
+    QCOMPARE(lazy["four"]["inner"][2].toCborValue(), QCborValue(3));
+    QCOMPARE(lazy[u"fünf"].toCborValue(), QCborValue(5));
+    QVERIFY(lazy["one"].isInvalid());
+    QVERIFY(lazy.value(2).isInvalid());
+    QVERIFY(lazy[0].isInvalid());
+}
+
+void tst_QLazyCborValue::arrayAccess()
+{
+    const QCborArray array { QCborMap { { "a", 1 } }, QCborArray { 1, 2 }, "three", 4.5 };
+    const QLazyCborValue lazy(array.toCborValue().toCbor());
+    QCOMPARE(lazy.size(), 4);
+    QCOMPARE(lazy[0]["a"].toCborValue(), QCborValue(1));
+    QCOMPARE(lazy[1].toCborValue(), QCborValue(QCborArray { 1, 2 }));
+    QCOMPARE(lazy[2].toCborValue(), QCborValue("three"));
+    QCOMPARE(lazy[3].toCborValue(), QCborValue(4.5));
+    QVERIFY(lazy[4].isInvalid());
+    QVERIFY(lazy[-1].isInvalid());
+    QVERIFY(lazy["a"].isInvalid());
+}
+
+void tst_QLazyCborValue::indefiniteLength()
+{
+    QByteArray cbor;
+    QCborStreamWriter writer(&cbor);
+    writer.startMap();
+    writer.append("list");
+    writer.startArray();
+    for (int i = 0; i < 10; ++i)
+        writer.append(i);
+    writer.endArray();
+    writer.append("name");
+    writer.appendTextString("chunked", 7);
+    writer.endMap();
+
+    const QLazyCborValue lazy(cbor);
+    QCOMPARE(lazy.size(), 2);
+    QCOMPARE(lazy["list"].size(), 10);
+    QCOMPARE(lazy["list"][7].toCborValue(), QCborValue(7));
+    QCOMPARE(lazy["name"].toCborValue(), QCborValue("chunked"));
+}
+
+void tst_QLazyCborValue::malformed()
+{
+    QVERIFY(QLazyCborValue().isInvalid());
+    QVERIFY(QLazyCborValue(QByteArray()).isInvalid());
+    QCOMPARE(QLazyCborValue(QByteArray()).size(), 0);
+
+    // an array of three elements that ends after the second one
+    const QByteArray truncated = QCborValue(QCborArray { 1, "two", 3 }).toCbor().chopped(1);
+    const QLazyCborValue lazy(truncated);
+    QCOMPARE(lazy[1].toCborValue(), QCborValue("two"));
+    QVERIFY(lazy[2].isInvalid());
+
+    QCborParserError error;
+    lazy.toCborValue(&error);
+    QCOMPARE(error.error, QCborError::EndOfFile);
+}
+
+void tst_QLazyCborValue::iteration()
+{
+    const QCborArray array { 1, "two", QCborArray { 3, QCborArray { 4 } },
+                             QCborMap { { 5, 5 } }, nullptr };
+    const QLazyCborValue lazyArray(array.toCborValue().toCbor());
+    qsizetype i = 0;
+    for (auto it = lazyArray.begin(); it != lazyArray.end(); ++it, ++i) {
+        QVERIFY(it.key().isInvalid());
+        QCOMPARE(it->toCborValue(), array.at(i));
+    }
+    QCOMPARE(i, array.size());
+
+    const QCborMap map { { "a", QCborMap { { "b", QCborArray { 1 } } } }, { 2, "two" },
+                         { QCborValue(QCborTag(1), 3), 3.5 }, { "", QCborArray() } };
+    const QLazyCborValue lazyMap(map.toCborValue().toCbor());
+    auto expected = map.constBegin();
+    for (auto it = lazyMap.constBegin(); it != lazyMap.constEnd(); ++it, ++expected) {
+        QVERIFY(expected != map.constEnd());
+        QCOMPARE(it.key().toCborValue(), expected.key());
+        QCOMPARE(it->toCborValue(), expected.value());
+    }
+    QVERIFY(expected == map.constEnd());
+
+    // indefinite length containers end with a break
+    QByteArray cbor;
+    QCborStreamWriter writer(&cbor);
+    writer.startArray();
+    writer.startMap();
+    writer.append(1);
+    writer.append("one");
+    writer.endMap();
+    writer.startArray();
+    writer.endArray();
+    writer.append(2);
+    writer.endArray();
+    const QLazyCborValue indefinite(cbor);
+    QList<QCborValue> elements;
+    for (const QLazyCborValue &element : indefinite)
+        elements << element.toCborValue();
+    QCOMPARE(elements, QList<QCborValue>({ QCborMap { { 1, "one" } }, QCborArray(), 2 }));
+    QCOMPARE(indefinite[0].begin().key().toCborValue(), QCborValue(1));
+    QCOMPARE(indefinite[1].begin(), indefinite[1].end());
+
+    QCOMPARE(QLazyCborValue(QCborArray().toCborValue().toCbor()).begin(), QLazyCborValue().end());
+    QCOMPARE(QLazyCborValue(QCborMap().toCborValue().toCbor()).begin(), QLazyCborValue().end());
+    QCOMPARE(lazyArray[0].begin(), lazyArray[0].end());
+
+    // iteration stops at the first malformed element
+    const QByteArray truncated = QCborValue(QCborArray { 1, "two", 3 }).toCbor().chopped(1);
+    elements.clear();
+    for (const QLazyCborValue &element : QLazyCborValue(truncated))
+        elements << element.toCborValue();
+    QCOMPARE(elements, QList<QCborValue>({ 1, "two" }));
+}
+
+void tst_QLazyCborValue::compareWithValue()
+{
+    QCborMap map;
+    for (int i = 0; i < 50; ++i) {
+        map.insert(QString::number(i), QCborMap {
+            { "string", QString(i, u'é') },
+            { "bytes", QByteArray(i, 'x') },
+            { "array", QCborArray { i, QString::number(i), nullptr } }
+        });
+    }
+
+    const QLazyCborValue lazy(map.toCborValue().toCbor());
+    QCOMPARE(lazy.size(), map.size());
+    for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+        const QLazyCborValue value = lazy[it.key().toString()];
+        QCOMPARE(value.toCborValue(), it.value());
+        QCOMPARE(value["array"][1].toCborValue(), it.value()["array"][1]);
+    }
+    QCOMPARE(lazy.toCborValue(), QCborValue(map));
+}
+
+QTEST_APPLESS_MAIN(tst_QLazyCborValue)
+
+#include "tst_qlazycborvalue.moc"
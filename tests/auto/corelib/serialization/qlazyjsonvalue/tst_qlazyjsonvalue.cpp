@@ -0,0 +1,262 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsonobject.h>
+#include <QtCore/private/qlazyjsonvalue_p.h>
+
+class tst_QLazyJsonValue : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void types_data();
+    void types();
+    void objectLookup();
+    void arrayAccess();
+    void nested();
+    void escapedKeys();
+    void malformed();
+    void iteration();
+    void iterationKeys_data();
+    void iterationKeys();
+    void compareWithDocument();
+};
+
+void tst_QLazyJsonValue::types_data()
+{
+    QTest::addColumn<QByteArray>("element");
+    QTest::addColumn<QJsonValue>("expected");
+
+    QTest::newRow("null") << QByteArray("null") << QJsonValue(QJsonValue::Null);
+    QTest::newRow("true") << QByteArray("true") << QJsonValue(true);
+    QTest::newRow("false") << QByteArray("false") << QJsonValue(false);
+    QTest::newRow("integer") << QByteArray("-42") << QJsonValue(-42);
+    QTest::newRow("double") << QByteArray("1.5e3") << QJsonValue(1500.);
+    QTest::newRow("string") << QByteArray("\"a\\\\b\\\"c\"") << QJsonValue("a\\b\"c");
+    QTest::newRow("utf8") << QByteArray("\"Gr\xc3\xbc\xc3\x9f""e\"") << QJsonValue(u"Grüße"_qs);
+    QTest::newRow("array") << QByteArray("[1, [2], {\"3\": 3}]")
+                           << QJsonValue(QJsonArray { 1, QJsonArray { 2 }, QJsonObject { { "3", 3 } } });
+    QTest::newRow("object") << QByteArray("{ \"a\" : [], \"b\": {} }")
+                            << QJsonValue(QJsonObject { { "a", QJsonArray() }, { "b", QJsonObject() } });
+}
+
+void tst_QLazyJsonValue::types()
+{
+    QFETCH(QByteArray, element);
+    QFETCH(QJsonValue, expected);
+
+    const QLazyJsonValue array(" [ " + element + " ] ");
+    QVERIFY(array.isArray());
+    QCOMPARE(array.size(), 1);
+    QCOMPARE(array[0].type(), expected.type());
+    QCOMPARE(array[0].rawJson(), element);
+    QCOMPARE(array[0].toJsonValue(), expected);
+    QVERIFY(array[1].isUndefined());
+
+    const QLazyJsonValue object("{\"key\":" + element + "}");
+    QVERIFY(object.isObject());
+    QCOMPARE(object.size(), 1);
+    QCOMPARE(object["key"].type(), expected.type());
+    QCOMPARE(object["key"].toJsonValue(), expected);
+    QVERIFY(object["other"].isUndefined());
+}
+
+void tst_QLazyJsonValue::objectLookup()
+{
+    const QLazyJsonValue doc(R"({"first": 1, "second": "two", "third": [3], "first": 4})");
+    QCOMPARE(doc.size(), 4);
+    QCOMPARE(doc.value(QLatin1String("second")).toJsonValue(), QJsonValue("two"));
+    QCOMPARE(doc.value(u"third").toJsonValue(), QJsonValue(QJsonArray { 3 }));
+    QCOMPARE(doc.value(QUtf8StringView("first")).toJsonValue(), QJsonValue(1));
+    QVERIFY(doc.value(u"fourth").isUndefined());
+    QVERIFY(doc.at(0).isUndefined());
+
+    QVERIFY(QLazyJsonValue("{}").isObject());
+    QCOMPARE(QLazyJsonValue("{}").size(), 0);
+    QVERIFY(QLazyJsonValue("{}")["a"].isUndefined());
+}
+
+void tst_QLazyJsonValue::arrayAccess()
+{
+    const QLazyJsonValue doc("\xef\xbb\xbf[\"a\",\"]\",\"[\",{},[],null]");
+    QCOMPARE(doc.size(), 6);
+    QCOMPARE(doc[0].toJsonValue(), QJsonValue("a"));
+    QCOMPARE(doc[1].toJsonValue(), QJsonValue("]"));
+    QCOMPARE(doc[2].toJsonValue(), QJsonValue("["));
+    QVERIFY(doc[3].isObject());
+    QVERIFY(doc[4].isArray());
+    QVERIFY(doc[5].isNull());
+    QVERIFY(doc[6].isUndefined());
+    QVERIFY(doc[-1].isUndefined());
+    QVERIFY(doc["a"].isUndefined());
+
+    QCOMPARE(QLazyJsonValue("[]").size(), 0);
+    QVERIFY(QLazyJsonValue("[]")[0].isUndefined());
+}
+
+void tst_QLazyJsonValue::nested()
+{
+    // long enough to span several blocks of the structural scanner
+    QByteArray json = "{\"padding\": \"" + QByteArray(100, '{') + "\", \"list\": [";
+    for (int i = 0; i < 100; ++i)
+        json += "{\"id\": " + QByteArray::number(i) + ", \"name\": \"item\\\\" + QByteArray::number(i) + "\"},";
+    json += "{}], \"last\": true}";
+
+    const QLazyJsonValue doc(json);
+    QCOMPARE(doc.size(), 3);
+    QCOMPARE(doc["list"].size(), 101);
+    QCOMPARE(doc["list"][57]["id"].toJsonValue(), QJsonValue(57));
+    QCOMPARE(doc["list"][99]["name"].toJsonValue(), QJsonValue("item\\99"));
+    QCOMPARE(doc["last"].toJsonValue(), QJsonValue(true));
+    QCOMPARE(doc["list"].toJsonValue(), QJsonDocument::fromJson(json).object().value("list"));
+}
+
+void tst_QLazyJsonValue::escapedKeys()
+{
+    const QLazyJsonValue doc(R"({"a\"b": 1, "ä": 2, "ä\\": 3})");
+    QCOMPARE(doc["a\"b"].toJsonValue(), QJsonValue(1));
+    QCOMPARE(doc[u"ä"].toJsonValue(), QJsonValue(2));
+    QCOMPARE(doc[u"ä\\"].toJsonValue(), QJsonValue(3));
+}
+
+void tst_QLazyJsonValue::malformed()
+{
+    QVERIFY(QLazyJsonValue("").isUndefined());
+    QVERIFY(QLazyJsonValue("  42").isUndefined());
+    QVERIFY(QLazyJsonValue("[1, 2").isArray());
+    QCOMPARE(QLazyJsonValue("[1, 2").size(), 0);
+    QVERIFY(QLazyJsonValue("{\"a\" 1}")["a"].isUndefined());
+    QVERIFY(QLazyJsonValue("[\"unterminated]")[0].isUndefined());
+
+    // skipped values are not validated, accessed ones are
+    const QLazyJsonValue doc("[nul, 1x, 3]");
+    QCOMPARE(doc[2].toJsonValue(), QJsonValue(3));
+    QJsonParseError error;
+    QCOMPARE(doc[1].toJsonValue(&error), QJsonValue(QJsonValue::Undefined));
+    QVERIFY(error.error != QJsonParseError::NoError);
+    QCOMPARE(doc.toJsonValue(&error), QJsonValue(QJsonValue::Undefined));
+    QCOMPARE(error.error, QJsonParseError::IllegalValue);
+}
+
+void tst_QLazyJsonValue::iteration()
+{
+    const QLazyJsonValue array(R"([1, "two", [3, [4]], {"5": 5}, null])");
+    const QJsonArray expectedArray = array.toJsonValue().toArray();
+    qsizetype i = 0;
+    for (auto it = array.begin(); it != array.end(); ++it, ++i) {
+        QVERIFY(it.key().isNull());
+        QCOMPARE(it->toJsonValue(), expectedArray.at(i));
+    }
+    QCOMPARE(i, expectedArray.size());
+
+    const QLazyJsonValue object(R"({ "a" : {"b": [1]}, "a\"b": 2, "\u00e4": "3" , "": [] })");
+    const QStringList keys = { "a", "a\"b", u"ä"_qs, "" };
+    const QJsonObject expectedObject = object.toJsonValue().toObject();
+    i = 0;
+    for (auto it = object.begin(); it != object.end(); ++it, ++i) {
+        QCOMPARE(it.key(), keys.at(i));
+        QCOMPARE(it->toJsonValue(), expectedObject.value(keys.at(i)));
+    }
+    QCOMPARE(i, keys.size());
+
+    QCOMPARE(QLazyJsonValue("[]").begin(), QLazyJsonValue("[]").end());
+    QCOMPARE(QLazyJsonValue(" { } ").begin(), QLazyJsonValue(" { } ").end());
+    QCOMPARE(array[0].begin(), array[0].end());
+
+    // iteration stops at the first malformed element
+    QStringList elements;
+    for (const QLazyJsonValue &element : QLazyJsonValue("[1, 2 3, 4]"))
+        elements << QString::fromUtf8(element.rawJson());
+    QCOMPARE(elements, QStringList({ "1", "2" }));
+}
+
+void tst_QLazyJsonValue::iterationKeys_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QStringList>("keys");
+
+    // array elements have null keys, object keys are never null
+    QTest::newRow("array") << QByteArray("[1, 2]") << QStringList({ QString(), QString() });
+    QTest::newRow("array-leading-space") << QByteArray("  [[1], {}]")
+                                         << QStringList({ QString(), QString() });
+    QTest::newRow("object") << QByteArray(R"({"a": [1], "b": 2})") << QStringList({ "a", "b" });
+    QTest::newRow("object-empty-key") << QByteArray(R"({"": 1})") << QStringList({ "" });
+}
+
+void tst_QLazyJsonValue::iterationKeys()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QStringList, keys);
+
+    QStringList actual;
+    const QLazyJsonValue value(json);
+    for (auto it = value.begin(); it != value.end(); ++it) {
+        QVERIFY(actual.size() < keys.size());
+        const QString key = it.key();
+        QCOMPARE(key.isNull(), keys.at(actual.size()).isNull());
+        actual << key;
+    }
+    QCOMPARE(actual, keys);
+}
+
+void tst_QLazyJsonValue::compareWithDocument()
+{
+    QJsonObject object;
+    for (int i = 0; i < 50; ++i) {
+        object.insert(QString::number(i), QJsonObject {
+            { "string", QString(i, u'é') + "\"\\\n" },
+            { "number", i * 1.25 },
+            { "array", QJsonArray { i, QString::number(i), QJsonValue::Null } }
+        });
+    }
+
+    for (auto format : { QJsonDocument::Compact, QJsonDocument::Indented }) {
+        const QByteArray json = QJsonDocument(object).toJson(format);
+        const QLazyJsonValue doc(json);
+        QCOMPARE(doc.size(), object.size());
+        for (auto it = object.constBegin(); it != object.constEnd(); ++it) {
+            const QLazyJsonValue value = doc[it.key()];
+            QCOMPARE(value.toJsonValue(), it.value());
+            const QJsonObject inner = it.value().toObject();
+            QCOMPARE(value["string"].toJsonValue(), inner["string"]);
+            QCOMPARE(value["array"][1].toJsonValue(), inner["array"].toArray().at(1));
+        }
+        QCOMPARE(doc.toJsonValue(), QJsonValue(object));
+
+        qsizetype count = 0;
+        for (auto it = doc.begin(); it != doc.end(); ++it, ++count)
+            QCOMPARE(it->toJsonValue(), object.value(it.key()));
+        QCOMPARE(count, object.size());
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_QLazyJsonValue)
+
+#include "tst_qlazyjsonvalue.moc"
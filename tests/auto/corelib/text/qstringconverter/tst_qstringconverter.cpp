@@ -32,6 +32,8 @@
 #include <qstringconverter.h>
 #include <qthreadpool.h>
 
+#include <private/qstringconverter_p.h>
+
 class tst_QStringConverter : public QObject
 {
     Q_OBJECT
@@ -50,6 +52,12 @@ private slots:
     void nonFlaggedEFBFBF() const;
     void decode0D() const;
 
+    void utf8SimdAgainstScalar_data();
+    void utf8SimdAgainstScalar();
+    void utf8SimdAllCodePoints();
+    void utf8SimdInvalidSequences();
+    void utf8SimdSurrogates();
+
     void utf8Codec_data();
     void utf8Codec();
 
@@ -295,6 +303,187 @@ static QString fromInvalidUtf8Sequence(const QByteArray &ba)
 }
 
 // copied from tst_QString::fromUtf8_data()
+// The SIMD kernels in QUtf8 must produce exactly what the scalar code does.
+// These helpers run the scalar conversion one character at a time.
+static QString scalarFromUtf8(QByteArrayView in)
+{
+    QString result(in.size(), Qt::Uninitialized);
+    char16_t *dst = reinterpret_cast<char16_t *>(result.data());
+    const uchar *src = reinterpret_cast<const uchar *>(in.data());
+    const uchar *const end = src + in.size();
+    if (in.startsWith("\xef\xbb\xbf"))
+        src += 3;   // skip the BOM
+    while (src < end) {
+        uchar b = *src++;
+        if (QUtf8Functions::fromUtf8<QUtf8BaseTraits>(b, dst, src, end) < 0)
+            *dst++ = QChar::ReplacementCharacter;
+    }
+    result.truncate(dst - reinterpret_cast<char16_t *>(result.data()));
+    return result;
+}
+
+static QByteArray scalarToUtf8(QStringView in)
+{
+    QByteArray result(in.size() * 3, Qt::Uninitialized);
+    uchar *dst = reinterpret_cast<uchar *>(result.data());
+    const char16_t *src = in.utf16();
+    const char16_t *const end = src + in.size();
+    while (src < end) {
+        char16_t u = *src++;
+        if (QUtf8Functions::toUtf8<QUtf8BaseTraits>(u, dst, src, end) < 0)
+            *dst++ = '?';
+    }
+    result.truncate(dst - reinterpret_cast<uchar *>(result.data()));
+    return result;
+}
+
+static bool scalarIsValidUtf8(QByteArrayView in)
+{
+    const uchar *src = reinterpret_cast<const uchar *>(in.data());
+    const uchar *const end = src + in.size();
+    while (src < end) {
+        uchar b = *src++;
+        char16_t buffer[2];
+        char16_t *dst = buffer;
+        if (QUtf8Functions::fromUtf8<QUtf8BaseTraits>(b, dst, src, end) < 0)
+            return false;
+    }
+    return true;
+}
+
+// fills n bytes with two-byte sequences, plus one ASCII character if n is odd
+static QByteArray utf8Filler(qsizetype n)
+{
+    QByteArray result = QByteArray("\xd0\xb4").repeated(n / 2);
+    if (n & 1)
+        result += 'a';
+    return result;
+}
+
+void tst_QStringConverter::utf8SimdAgainstScalar_data()
+{
+    QTest::addColumn<QString>("text");
+
+    QTest::newRow("ascii") << QString::fromLatin1("The quick brown fox jumps over the lazy dog. ");
+    QTest::newRow("latin1") << u"Größenwahn à la française, señor! "_qs;
+    QTest::newRow("cyrillic") << u"Съешь же ещё этих мягких французских булок, да выпей чаю. "_qs;
+    QTest::newRow("greek") << u"Ξεσκεπάζω την ψυχοφθόρα βδελυγμία. "_qs;
+    QTest::newRow("cjk") << u"我能吞下玻璃而不伤身体。私はガラスを食べられます。나는 유리를 먹을 수 있어요. "_qs;
+    QTest::newRow("mixed") << u"Qt 6: Привет, 世界! ½ ≠ ∞ — ok"_qs;
+    QTest::newRow("emoji") << u"Hi 😀 Привет 🎉 世界 👍🏽 end"_qs;
+    QTest::newRow("noncharacters") << u"￾￿﷐ࠀ߿\u0080\u007F"_qs;
+}
+
+void tst_QStringConverter::utf8SimdAgainstScalar()
+{
+    QFETCH(QString, text);
+
+    // vary the length and the alignment of the non-ASCII parts
+    const QString repeated = text.repeated(8);
+    for (qsizetype prefix = 0; prefix < 70; ++prefix) {
+        const QString input = QString(prefix, u'x') + repeated;
+        for (qsizetype len = input.size() - 40; len <= input.size(); ++len) {
+            if (input.at(len - 1).isHighSurrogate())
+                continue;   // don't split surrogate pairs
+            const QStringView utf16 = QStringView(input).left(len);
+            const QByteArray utf8 = scalarToUtf8(utf16);
+            QCOMPARE(utf16.toUtf8(), utf8);
+            QCOMPARE(QString::fromUtf8(utf8), scalarFromUtf8(utf8));
+            QCOMPARE(QString::fromUtf8(utf8), utf16);
+            QVERIFY(QByteArrayView(utf8).isValidUtf8());
+
+            QStringEncoder encoder(QStringEncoder::Utf8);
+            QCOMPARE(QByteArray(encoder(utf16)), utf8);
+            QStringDecoder decoder(QStringDecoder::Utf8);
+            QCOMPARE(QString(decoder(utf8)), utf16);
+            QVERIFY(!decoder.hasError());
+        }
+    }
+
+    // stateful decoding in chunks that split sequences
+    const QByteArray utf8 = repeated.toUtf8();
+    for (qsizetype chunk : { 1, 2, 3, 5, 17, 33, 64, 100 }) {
+        QStringDecoder decoder(QStringDecoder::Utf8);
+        QString decoded;
+        for (qsizetype i = 0; i < utf8.size(); i += chunk)
+            decoded += decoder(QByteArrayView(utf8).sliced(i, qMin(chunk, utf8.size() - i)));
+        QVERIFY(!decoder.hasError());
+        QCOMPARE(decoded, repeated);
+    }
+}
+
+void tst_QStringConverter::utf8SimdAllCodePoints()
+{
+    QString all;
+    for (char32_t c = 1; c <= 0x10ffff; c += (c < 0x10000 ? 1 : 37)) {
+        if (QChar::isSurrogate(c))
+            continue;
+        if (QChar::requiresSurrogates(c)) {
+            all += QChar(QChar::highSurrogate(c));
+            all += QChar(QChar::lowSurrogate(c));
+        } else {
+            all += QChar(c);
+        }
+    }
+
+    for (qsizetype offset = 0; offset < 4; ++offset) {
+        const QString input = QString(offset, u'x') + all;
+        const QByteArray utf8 = scalarToUtf8(input);
+        QCOMPARE(input.toUtf8(), utf8);
+        QCOMPARE(QString::fromUtf8(utf8), input);
+        QCOMPARE(QStringDecoder(QStringDecoder::Utf8).decode(utf8), input);
+        QVERIFY(QByteArrayView(utf8).isValidUtf8());
+    }
+}
+
+void tst_QStringConverter::utf8SimdInvalidSequences()
+{
+    // every lead byte followed by every byte, then a selection of bytes
+    // that matter to the three-byte checks, placed around the positions
+    // where the kernels split their blocks
+    const uchar thirdBytes[] = { 0x00, 0x41, 0x7f, 0x80, 0x9f, 0xa0, 0xbf, 0xc0, 0xe0, 0xff };
+    const qsizetype offsets[] = { 0, 1, 13, 14, 15, 16, 17, 29, 30, 31, 32, 33 };
+    const QByteArray suffix = utf8Filler(80);
+
+    for (uint lead = 0x80; lead < 0x100; ++lead) {
+        for (uint second = 0; second < 0x100; ++second) {
+            for (uchar third : thirdBytes) {
+                const char sequence[] = { char(lead), char(second), char(third) };
+                for (qsizetype offset : offsets) {
+                    const QByteArray input = utf8Filler(offset) + QByteArray(sequence, 3) + suffix;
+                    const QByteArray context = QByteArray(sequence, 3).toHex() + " at offset "
+                            + QByteArray::number(offset);
+                    QVERIFY2(QString::fromUtf8(input) == scalarFromUtf8(input), context);
+                    QVERIFY2(QByteArrayView(input).isValidUtf8() == scalarIsValidUtf8(input), context);
+                }
+            }
+        }
+    }
+}
+
+void tst_QStringConverter::utf8SimdSurrogates()
+{
+    const QString cjk = u"我能吞下玻璃而不伤身体"_qs.repeated(4);
+    const char16_t surrogates[][2] = {
+        { 0xd800, 0x4e00 },     // lone high surrogate
+        { 0xdc00, 0x4e00 },     // lone low surrogate
+        { 0xdbff, 0xdfff },     // valid pair
+        { 0xdfff, 0xd800 },     // reversed pair
+    };
+    for (const auto &pair : surrogates) {
+        for (qsizetype offset = 0; offset < 20; ++offset) {
+            const QString input = cjk.left(offset) + QStringView(pair, 2).toString() + cjk;
+            const QByteArray expected = scalarToUtf8(input);
+            QCOMPARE(input.toUtf8(), expected);
+            QCOMPARE(QUtf8::convertFromUnicode(input), expected);
+            QStringEncoder encoder(QStringEncoder::Utf8);
+            const QByteArray encoded = encoder(input);
+            QCOMPARE(encoder.hasError(), !QChar::isHighSurrogate(pair[0]) || !QChar::isLowSurrogate(pair[1]));
+            QCOMPARE(QString::fromUtf8(encoded), QString::fromUtf8(expected).replace(u'?', QChar::ReplacementCharacter));
+        }
+    }
+}
+
 void tst_QStringConverter::utf8Codec_data()
 {
     QTest::addColumn<QByteArray>("utf8");
@@ -108,6 +108,12 @@ private slots:
     void takeAllAndIncreaseMaxThreadCount();
     void waitForDoneAfterTake();
     void threadReuse();
+    void workStealing_data();
+    void workStealing();
+    void workStealingPriority();
+    void workStealingReleaseThread();
+    void workStealingClearAndTake();
+    void workStealingTryStart();
 
 private:
     QMutex m_functionTestMutex;
@@ -1460,5 +1466,176 @@ void tst_QThreadPool::threadReuse()
     }
 }
 
+void tst_QThreadPool::workStealing_data()
+{
+    QTest::addColumn<int>("maxThreadCount");
+    QTest::newRow("1") << 1;
+    QTest::newRow("2") << 2;
+    QTest::newRow("8") << 8;
+}
+
+void tst_QThreadPool::workStealing()
+{
+    QFETCH(int, maxThreadCount);
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(maxThreadCount);
+    QVERIFY(!threadPool.isWorkStealingEnabled());
+    threadPool.setWorkStealingEnabled(true);
+    QVERIFY(threadPool.isWorkStealingEnabled());
+
+    // recursively split a range, more tasks than fit into a per-thread queue
+    constexpr int depth = 14;
+    QAtomicInt leaves = 0;
+    std::function<void(int)> split = [&](int level) {
+        if (level == depth) {
+            leaves.ref();
+            return;
+        }
+        threadPool.start([&split, level] { split(level + 1); });
+        threadPool.start([&split, level] { split(level + 1); });
+    };
+    threadPool.start([&split] { split(0); });
+
+    QVERIFY(threadPool.waitForDone(60 * 1000));
+    QCOMPARE(leaves.loadRelaxed(), 1 << depth);
+    QCOMPARE(threadPool.activeThreadCount(), 0);
+}
+
+void tst_QThreadPool::workStealingPriority()
+{
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(1);
+    threadPool.setWorkStealingEnabled(true);
+
+    QMutex mutex;
+    QList<int> order;
+    auto record = [&](int id) {
+        QMutexLocker locker(&mutex);
+        order.append(id);
+    };
+
+    threadPool.start([&] {
+        for (int i = 0; i < 10; ++i)
+            threadPool.start([&record, i] { record(i); });
+        // raised priorities bypass the per-thread queue and overtake it
+        threadPool.start([&record] { record(100); }, 1);
+    });
+    QVERIFY(threadPool.waitForDone(60 * 1000));
+
+    QCOMPARE(order.size(), 11);
+    QCOMPARE(order.first(), 100);
+    // the per-thread queue is LIFO for its owner
+    for (int i = 1; i < order.size(); ++i)
+        QCOMPARE(order.at(i), 10 - i);
+}
+
+void tst_QThreadPool::workStealingReleaseThread()
+{
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(1);
+    threadPool.setWorkStealingEnabled(true);
+
+    QSemaphore ran;
+    QAtomicInt result = 0;
+    threadPool.start([&] {
+        threadPool.start([&ran] { ran.release(); });
+        // the runnable waits in this thread's own queue; releasing the
+        // thread has to get another thread to steal it
+        threadPool.releaseThread();
+        result.storeRelaxed(ran.tryAcquire(1, 10 * 1000) ? 1 : -1);
+        threadPool.reserveThread();
+    });
+    QVERIFY(threadPool.waitForDone(60 * 1000));
+    QCOMPARE(result.loadRelaxed(), 1);
+}
+
+void tst_QThreadPool::workStealingClearAndTake()
+{
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(1);
+    threadPool.setWorkStealingEnabled(true);
+
+    QSemaphore queued;
+    QSemaphore proceed;
+    const QSemaphoreReleaser proceedReleaser(proceed);
+    QAtomicInt runCount = 0;
+    QAtomicInt dtorCount = 0;
+
+    class CountingTask : public QRunnable
+    {
+    public:
+        CountingTask(QAtomicInt &runs, QAtomicInt &dtors) : runs(runs), dtors(dtors) {}
+        ~CountingTask() override { dtors.ref(); }
+        void run() override { runs.ref(); }
+        QAtomicInt &runs;
+        QAtomicInt &dtors;
+    };
+
+    CountingTask *kept = new CountingTask(runCount, dtorCount);
+    kept->setAutoDelete(false);
+    threadPool.start([&] {
+        threadPool.start(kept);
+        for (int i = 0; i < 5; ++i)
+            threadPool.start(new CountingTask(runCount, dtorCount));
+        queued.release();
+        proceed.acquire();
+    });
+    QVERIFY(queued.tryAcquire(1, 60 * 1000));
+
+    QVERIFY(threadPool.tryTake(kept));
+    QVERIFY(!threadPool.tryTake(kept));
+    threadPool.clear();
+    QCOMPARE(dtorCount.loadRelaxed(), 5);
+
+    proceed.release();
+    QVERIFY(threadPool.waitForDone(60 * 1000));
+    QCOMPARE(runCount.loadRelaxed(), 0);
+    delete kept;
+}
+
+void tst_QThreadPool::workStealingTryStart()
+{
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(4);
+    threadPool.setWorkStealingEnabled(true);
+
+    // split work the way Qt Concurrent does: hand half of it to another
+    // thread if one is available, otherwise do it in this one
+    constexpr int depth = 14;
+    QAtomicInt leaves = 0;
+    std::function<void(int)> split = [&](int level) {
+        if (level == depth) {
+            leaves.ref();
+            return;
+        }
+        if (!threadPool.tryStart([&split, level] { split(level + 1); }))
+            split(level + 1);
+        split(level + 1);
+    };
+    QVERIFY(threadPool.tryStart([&split] { split(0); }));
+
+    QVERIFY(threadPool.waitForDone(60 * 1000));
+    QCOMPARE(leaves.loadRelaxed(), 1 << depth);
+    QCOMPARE(threadPool.activeThreadCount(), 0);
+
+    // tryStart() still fails once all threads are busy
+    QSemaphore proceed;
+    const QSemaphoreReleaser proceedReleaser(proceed, 4);
+    QAtomicInt started = 0;
+    QAtomicInt result = 0;
+    threadPool.start([&] {
+        for (int i = 0; i < 3; ++i) {
+            if (threadPool.tryStart([&proceed] { proceed.acquire(); }))
+                started.ref();
+        }
+        result.storeRelaxed(threadPool.tryStart([] {}) ? -1 : 1);
+        proceed.acquire();
+    });
+    QVERIFY(QTest::qWaitFor([&] { return result.loadRelaxed() != 0; }));
+    QCOMPARE(started.loadRelaxed(), 3);
+    QCOMPARE(result.loadRelaxed(), 1);
+}
+
 QTEST_MAIN(tst_QThreadPool);
 #include "tst_qthreadpool.moc"
@@ -0,0 +1,443 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+
+#include <private/qflathash_p.h>
+#include <qhash.h>
+#include <qrandom.h>
+#include <qstring.h>
+
+#include <algorithm>
+
+// A key whose hash collides a lot, to exercise long probe sequences
+struct BadKey
+{
+    int k;
+    friend bool operator==(BadKey a, BadKey b) noexcept { return a.k == b.k; }
+};
+size_t qHash(BadKey key, size_t seed = 0) noexcept
+{
+    return qHash(key.k % 7, seed);
+}
+
+// Not relocatable, and counts its instances, so it is stored out of line
+struct Counted
+{
+    static int instances;
+    int v = 0;
+    Counted *self = this;
+    Counted(int v = 0) : v(v) { ++instances; }
+    Counted(const Counted &o) : v(o.v) { ++instances; }
+    Counted &operator=(const Counted &o) { v = o.v; return *this; }
+    ~Counted() { Q_ASSERT(self == this); --instances; }
+    friend bool operator==(const Counted &a, const Counted &b) { return a.v == b.v; }
+};
+int Counted::instances = 0;
+
+static_assert(QFlatHashPrivate::Data<QFlatHashPrivate::Node<int, int>>::StoreInline);
+static_assert(QFlatHashPrivate::Data<QFlatHashPrivate::Node<QString, int>>::StoreInline);
+static_assert(!QFlatHashPrivate::Data<QFlatHashPrivate::Node<int, Counted>>::StoreInline);
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+private slots:
+    void constructing();
+    void insertAndFind();
+    void operatorBracket();
+    void removal();
+    void take();
+    void collisions();
+    void tombstones();
+    void detachKeepsTombstones();
+    void implicitSharing();
+    void iterators();
+    void reserveAndSqueeze();
+    void outOfLineNodes();
+    void emplaceReferenceIntoSelf();
+    void compareWithQHash();
+};
+
+void tst_QFlatHash::constructing()
+{
+    QFlatHash<int, QString> empty;
+    QVERIFY(empty.isEmpty());
+    QCOMPARE(empty.size(), 0);
+    QCOMPARE(empty.capacity(), 0);
+    QVERIFY(!empty.contains(1));
+    QCOMPARE(empty.value(1, QStringLiteral("x")), QStringLiteral("x"));
+    QVERIFY(empty.begin() == empty.end());
+    QVERIFY(empty.constFind(1) == empty.constEnd());
+
+    QFlatHash<int, QString> list{ { 1, "one" }, { 2, "two" }, { 3, "three" } };
+    QCOMPARE(list.size(), 3);
+    QCOMPARE(list.value(2), QStringLiteral("two"));
+
+    QFlatHash<int, QString> copy(list);
+    QVERIFY(copy.isSharedWith(list));
+    QCOMPARE(copy, list);
+
+    QFlatHash<int, QString> moved(std::move(copy));
+    QVERIFY(copy.isEmpty());
+    QCOMPARE(moved, list);
+
+    empty = moved;
+    QCOMPARE(empty, list);
+    empty.clear();
+    QVERIFY(empty.isEmpty());
+    QCOMPARE(list.size(), 3);
+}
+
+void tst_QFlatHash::insertAndFind()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i * 2);
+    QCOMPARE(hash.size(), 1000);
+    QVERIFY(hash.capacity() >= 1000);
+    for (int i = 0; i < 1000; ++i) {
+        QVERIFY(hash.contains(i));
+        QCOMPARE(hash.value(i), i * 2);
+        auto it = hash.constFind(i);
+        QVERIFY(it != hash.constEnd());
+        QCOMPARE(it.key(), i);
+        QCOMPARE(*it, i * 2);
+    }
+    QVERIFY(!hash.contains(1000));
+    QVERIFY(!hash.contains(-1));
+
+    // inserting an existing key replaces the value
+    auto it = hash.insert(7, 42);
+    QCOMPARE(it.key(), 7);
+    QCOMPARE(it.value(), 42);
+    QCOMPARE(hash.size(), 1000);
+    QCOMPARE(hash.value(7), 42);
+
+    QFlatHash<QString, QString> strings;
+    strings.emplace(QStringLiteral("a"), 3, QLatin1Char('a'));
+    strings.insert(QStringLiteral("b"), QStringLiteral("bb"));
+    QCOMPARE(strings.value(QStringLiteral("a")), QStringLiteral("aaa"));
+    QCOMPARE(strings.value(QStringLiteral("b")), QStringLiteral("bb"));
+    QCOMPARE(strings.value(QStringLiteral("c")), QString());
+}
+
+void tst_QFlatHash::operatorBracket()
+{
+    QFlatHash<QString, int> hash;
+    hash[QStringLiteral("one")] = 1;
+    ++hash[QStringLiteral("one")];
+    QCOMPARE(hash.size(), 1);
+    QCOMPARE(hash.value(QStringLiteral("one")), 2);
+    QCOMPARE(hash[QStringLiteral("two")], 0);
+    QCOMPARE(hash.size(), 2);
+
+    const auto &constHash = hash;
+    QCOMPARE(constHash[QStringLiteral("three")], 0);
+    QCOMPARE(hash.size(), 2);
+}
+
+void tst_QFlatHash::removal()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, i);
+    for (int i = 0; i < 100; i += 2)
+        QVERIFY(hash.remove(i));
+    QVERIFY(!hash.remove(0));
+    QVERIFY(!hash.remove(1000));
+    QCOMPARE(hash.size(), 50);
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(hash.contains(i), bool(i & 1));
+
+    // removing from an empty, shared null does not allocate
+    QFlatHash<int, int> empty;
+    QVERIFY(!empty.remove(1));
+    QVERIFY(!empty.isDetached());
+}
+
+void tst_QFlatHash::take()
+{
+    QFlatHash<int, QString> hash{ { 1, "one" }, { 2, "two" } };
+    QFlatHash<int, QString> copy = hash;
+    QCOMPARE(hash.take(1), QStringLiteral("one"));
+    QCOMPARE(hash.take(1), QString());
+    QCOMPARE(hash.size(), 1);
+    QCOMPARE(copy.size(), 2);
+    QCOMPARE(copy.value(1), QStringLiteral("one"));
+}
+
+void tst_QFlatHash::collisions()
+{
+    // only seven distinct hash values: every probe sequence is long
+    QFlatHash<BadKey, int> hash;
+    for (int i = 0; i < 2000; ++i)
+        hash.insert(BadKey{ i }, i);
+    QCOMPARE(hash.size(), 2000);
+    for (int i = 0; i < 2000; ++i)
+        QCOMPARE(hash.value(BadKey{ i }, -1), i);
+    QVERIFY(!hash.contains(BadKey{ 2000 }));
+
+    for (int i = 0; i < 2000; i += 3)
+        QVERIFY(hash.remove(BadKey{ i }));
+    for (int i = 0; i < 2000; ++i)
+        QCOMPARE(hash.contains(BadKey{ i }), i % 3 != 0);
+}
+
+void tst_QFlatHash::tombstones()
+{
+    // churn through far more keys than the table holds at any time; the
+    // table must recycle deleted slots instead of growing without bound
+    QFlatHash<int, int> hash;
+    hash.reserve(100);
+    const qsizetype capacity = hash.capacity();
+    for (int i = 0; i < 100000; ++i) {
+        hash.insert(i, i);
+        if (i >= 50)
+            QVERIFY(hash.remove(i - 50));
+    }
+    QCOMPARE(hash.size(), 50);
+    QCOMPARE(hash.capacity(), capacity);
+    for (int i = 100000 - 50; i < 100000; ++i)
+        QCOMPARE(hash.value(i, -1), i);
+}
+
+void tst_QFlatHash::detachKeepsTombstones()
+{
+    // keys with colliding hashes fill whole groups, so erasing from the
+    // first groups leaves tombstones that later keys are found past
+    QFlatHash<BadKey, int> hash;
+    for (int i = 0; i < 200; ++i)
+        hash.insert(BadKey{ i }, i);
+    for (int i = 0; i < 200; i += 5)
+        QVERIFY(hash.remove(BadKey{ i }));
+
+    QFlatHash<BadKey, int> copy = hash;
+    copy.insert(BadKey{ 1000 }, 1000); // detaches
+    QVERIFY(!copy.isSharedWith(hash));
+    for (int i = 0; i < 200; ++i) {
+        QCOMPARE(copy.value(BadKey{ i }, -1), i % 5 ? i : -1);
+        QCOMPARE(hash.value(BadKey{ i }, -1), i % 5 ? i : -1);
+    }
+    QCOMPARE(copy.value(BadKey{ 1000 }), 1000);
+
+    QFlatHash<BadKey, int> other = hash;
+    QVERIFY(other.remove(BadKey{ 199 })); // detaches
+    QVERIFY(!other.contains(BadKey{ 199 }));
+    QCOMPARE(other.size(), hash.size() - 1);
+    for (int i = 0; i < 199; ++i)
+        QCOMPARE(other.value(BadKey{ i }, -1), i % 5 ? i : -1);
+    QCOMPARE(hash.value(BadKey{ 199 }), 199);
+}
+
+void tst_QFlatHash::implicitSharing()
+{
+    QFlatHash<int, QString> a{ { 1, "one" }, { 2, "two" } };
+    QFlatHash<int, QString> b = a;
+    QVERIFY(a.isSharedWith(b));
+    QVERIFY(!a.isDetached());
+
+    // const access does not detach
+    QCOMPARE(b.value(1), QStringLiteral("one"));
+    QVERIFY(b.contains(2));
+    QVERIFY(std::as_const(b).find(2) != std::as_const(b).end());
+    QVERIFY(a.isSharedWith(b));
+
+    b.insert(3, QStringLiteral("three"));
+    QVERIFY(!a.isSharedWith(b));
+    QVERIFY(a.isDetached());
+    QVERIFY(b.isDetached());
+    QCOMPARE(a.size(), 2);
+    QCOMPARE(b.size(), 3);
+    QVERIFY(!a.contains(3));
+
+    QFlatHash<int, QString> c = a;
+    c[1] = QStringLiteral("uno");
+    QCOMPARE(a.value(1), QStringLiteral("one"));
+    QCOMPARE(c.value(1), QStringLiteral("uno"));
+
+    QFlatHash<int, QString> d = a;
+    auto it = d.find(2);
+    QVERIFY(!d.isSharedWith(a));
+    *it = QStringLiteral("dos");
+    QCOMPARE(a.value(2), QStringLiteral("two"));
+    QCOMPARE(d.value(2), QStringLiteral("dos"));
+
+    QFlatHash<int, QString> e = a;
+    e.remove(1);
+    QCOMPARE(a.size(), 2);
+    QCOMPARE(e.size(), 1);
+}
+
+void tst_QFlatHash::iterators()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 500; ++i)
+        hash.insert(i, -i);
+
+    QList<int> keys;
+    for (auto it = hash.cbegin(); it != hash.cend(); ++it) {
+        QCOMPARE(it.value(), -it.key());
+        keys.append(it.key());
+    }
+    std::sort(keys.begin(), keys.end());
+    QCOMPARE(keys.size(), 500);
+    for (int i = 0; i < 500; ++i)
+        QCOMPARE(keys.at(i), i);
+
+    QList<int> fromKeys = hash.keys();
+    std::sort(fromKeys.begin(), fromKeys.end());
+    QCOMPARE(fromKeys, keys);
+    QCOMPARE(hash.values().size(), 500);
+
+    int sum = 0;
+    for (int v : std::as_const(hash))
+        sum += v;
+    QCOMPARE(sum, -(499 * 500) / 2);
+
+    // erase every odd key while iterating
+    for (auto it = hash.begin(); it != hash.end();) {
+        if (it.key() & 1)
+            it = hash.erase(it);
+        else
+            ++it;
+    }
+    QCOMPARE(hash.size(), 250);
+    for (int i = 0; i < 500; ++i)
+        QCOMPARE(hash.contains(i), !(i & 1));
+
+    // mutable iteration detaches
+    QFlatHash<int, int> copy = hash;
+    for (auto it = copy.begin(); it != copy.end(); ++it)
+        *it = 0;
+    QCOMPARE(hash.value(2), -2);
+    QCOMPARE(copy.value(2), 0);
+}
+
+void tst_QFlatHash::reserveAndSqueeze()
+{
+    QFlatHash<int, int> hash;
+    hash.reserve(1000);
+    QVERIFY(hash.capacity() >= 1000);
+    const qsizetype capacity = hash.capacity();
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+    QCOMPARE(hash.capacity(), capacity);
+
+    QFlatHash<int, int> copy = hash;
+    copy.reserve(5000);
+    QVERIFY(copy.capacity() >= 5000);
+    QCOMPARE(hash.capacity(), capacity);
+    QCOMPARE(copy, hash);
+
+    for (int i = 10; i < 1000; ++i)
+        hash.remove(i);
+    hash.squeeze();
+    QVERIFY(hash.capacity() < capacity);
+    QVERIFY(hash.capacity() >= 10);
+    for (int i = 0; i < 10; ++i)
+        QCOMPARE(hash.value(i, -1), i);
+
+    hash.clear();
+    hash.squeeze();
+    QCOMPARE(hash.capacity(), 0);
+}
+
+void tst_QFlatHash::outOfLineNodes()
+{
+    QCOMPARE(Counted::instances, 0);
+    {
+        QFlatHash<int, Counted> hash;
+        for (int i = 0; i < 1000; ++i)
+            hash.insert(i, Counted(i));
+        QCOMPARE(Counted::instances, 1000);
+        // growth moves node pointers, not the nodes
+        for (int i = 0; i < 1000; ++i)
+            QCOMPARE(hash.value(i).v, i);
+
+        QFlatHash<int, Counted> copy = hash;
+        copy.remove(0);
+        QCOMPARE(Counted::instances, 1999);
+        copy.squeeze();
+        QCOMPARE(Counted::instances, 1999);
+        QCOMPARE(copy.value(500).v, 500);
+
+        hash.clear();
+        QCOMPARE(Counted::instances, 999);
+    }
+    QCOMPARE(Counted::instances, 0);
+}
+
+void tst_QFlatHash::emplaceReferenceIntoSelf()
+{
+    QFlatHash<int, QString> hash;
+    hash.insert(0, QStringLiteral("value"));
+    // growing the table while args references an element of the hash
+    for (int i = 1; i < 200; ++i)
+        hash.emplace(i, hash.constFind(0).value());
+    for (int i = 0; i < 200; ++i)
+        QCOMPARE(hash.value(i), QStringLiteral("value"));
+
+    QFlatHash<int, QString> copy = hash;
+    copy.emplace(1000, hash.constFind(0).value());
+    QCOMPARE(copy.value(1000), QStringLiteral("value"));
+    QVERIFY(!hash.contains(1000));
+}
+
+void tst_QFlatHash::compareWithQHash()
+{
+    QRandomGenerator rng(42);
+    QFlatHash<quint32, quint32> flat;
+    QHash<quint32, quint32> reference;
+    for (int round = 0; round < 200000; ++round) {
+        const quint32 key = rng.bounded(5000);
+        switch (rng.bounded(4)) {
+        case 0:
+        case 1:
+            flat.insert(key, round);
+            reference.insert(key, round);
+            break;
+        case 2:
+            QCOMPARE(flat.remove(key), reference.remove(key));
+            break;
+        case 3:
+            QCOMPARE(flat.value(key, 0xffffffff), reference.value(key, 0xffffffff));
+            break;
+        }
+        QCOMPARE(flat.size(), reference.size());
+    }
+    for (auto it = reference.cbegin(); it != reference.cend(); ++it)
+        QCOMPARE(flat.value(it.key()), it.value());
+    qsizetype n = 0;
+    for (auto it = flat.cbegin(); it != flat.cend(); ++it, ++n)
+        QCOMPARE(reference.value(it.key()), it.value());
+    QCOMPARE(n, reference.size());
+}
+
+QTEST_APPLESS_MAIN(tst_QFlatHash)
+#include "tst_qflathash.moc"
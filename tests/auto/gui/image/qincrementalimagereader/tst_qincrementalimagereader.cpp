@@ -0,0 +1,335 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QTest>
+#include <QSignalSpy>
+
+#include <QBuffer>
+#include <QImageWriter>
+#include <QIncrementalImageReader>
+
+class tst_QIncrementalImageReader : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void supportsIncrementalDecoding();
+    void decodeInChunks_data();
+    void decodeInChunks();
+    void partialData();
+    void truncatedData();
+    void invalidData();
+    void bufferedFormat();
+    void reset();
+    void resetFromSignal_data();
+    void resetFromSignal();
+};
+
+static QByteArray encodedImage(const QImage &image, const QByteArray &format)
+{
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    QImageWriter writer(&buffer, format);
+    if (!writer.write(image))
+        qWarning() << "Failed to write image:" << writer.errorString();
+    return data;
+}
+
+static QImage testImage(QImage::Format format)
+{
+    QImage image(97, 61, QImage::Format_ARGB32);
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x)
+            image.setPixel(x, y, qRgba(x * 2, y * 4, (x + y) & 0xff, 255 - x));
+    }
+    return image.convertToFormat(format);
+}
+
+static QByteArray readFile(const QString &fileName)
+{
+    QFile file(QFINDTESTDATA(fileName));
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+    return file.readAll();
+}
+
+void tst_QIncrementalImageReader::supportsIncrementalDecoding()
+{
+    QVERIFY(QIncrementalImageReader::supportsIncrementalDecoding("png"));
+    QVERIFY(QIncrementalImageReader::supportsIncrementalDecoding("PNG"));
+    QVERIFY(!QIncrementalImageReader::supportsIncrementalDecoding("bmp"));
+    QVERIFY(!QIncrementalImageReader::supportsIncrementalDecoding(QByteArray()));
+}
+
+void tst_QIncrementalImageReader::decodeInChunks_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QByteArray>("format");
+    QTest::addColumn<int>("chunkSize");
+
+    const QByteArray interlaced = readFile("images/interlaced.png");
+    QVERIFY(!interlaced.isEmpty());
+
+    const struct {
+        const char *name;
+        QImage::Format format;
+    } formats[] = {
+        { "argb32", QImage::Format_ARGB32 },
+        { "rgb32", QImage::Format_RGB32 },
+        { "indexed8", QImage::Format_Indexed8 },
+        { "mono", QImage::Format_Mono },
+        { "grayscale8", QImage::Format_Grayscale8 },
+        { "rgba64", QImage::Format_RGBA64 },
+    };
+    const int chunkSizes[] = { 1, 113, 1 << 20 };
+
+    for (int chunkSize : chunkSizes) {
+        for (const auto &format : formats) {
+            QTest::addRow("%s, %d", format.name, chunkSize)
+                    << encodedImage(testImage(format.format), "png") << QByteArray() << chunkSize;
+        }
+        QTest::addRow("interlaced, %d", chunkSize) << interlaced << QByteArray() << chunkSize;
+        QTest::addRow("interlaced, png, %d", chunkSize) << interlaced << QByteArray("png") << chunkSize;
+    }
+}
+
+void tst_QIncrementalImageReader::decodeInChunks()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QByteArray, format);
+    QFETCH(int, chunkSize);
+
+    const QImage expected = QImage::fromData(data, "png");
+    QVERIFY(!expected.isNull());
+
+    QIncrementalImageReader reader(format);
+    QSignalSpy sizeSpy(&reader, &QIncrementalImageReader::sizeAvailable);
+    QSignalSpy rowsSpy(&reader, &QIncrementalImageReader::rowsDecoded);
+    QSignalSpy finishedSpy(&reader, &QIncrementalImageReader::finished);
+    QSignalSpy errorSpy(&reader, &QIncrementalImageReader::errorOccurred);
+
+    QList<bool> rowDecoded(expected.height(), false);
+    connect(&reader, &QIncrementalImageReader::rowsDecoded, this, [&](int from, int to) {
+        QVERIFY(from >= 0);
+        QVERIFY(from <= to);
+        QVERIFY(to < expected.height());
+        for (int y = from; y <= to; ++y)
+            rowDecoded[y] = true;
+    });
+
+    for (qsizetype i = 0; i < data.size(); i += chunkSize) {
+        QVERIFY(!reader.isFinished());
+        reader.addData(data.mid(i, chunkSize));
+    }
+    reader.finish();
+
+    QCOMPARE(errorSpy.count(), 0);
+    QCOMPARE(sizeSpy.count(), 1);
+    QCOMPARE(sizeSpy.at(0).at(0).toSize(), expected.size());
+    QCOMPARE(finishedSpy.count(), 1);
+    QVERIFY(reader.isFinished());
+    QVERIFY(!rowDecoded.contains(false));
+    if (chunkSize < data.size())
+        QVERIFY(rowsSpy.count() > 1);
+
+    const QImage image = reader.image();
+    QCOMPARE(reader.size(), expected.size());
+    QCOMPARE(image.format(), expected.format());
+    QCOMPARE(image, expected);
+    QCOMPARE(image.textKeys(), expected.textKeys());
+    for (const QString &key : expected.textKeys())
+        QCOMPARE(image.text(key), expected.text(key));
+}
+
+void tst_QIncrementalImageReader::partialData()
+{
+    const QImage expected = testImage(QImage::Format_RGB32);
+    const QByteArray data = encodedImage(expected, "png");
+
+    QIncrementalImageReader reader;
+    QSignalSpy sizeSpy(&reader, &QIncrementalImageReader::sizeAvailable);
+    QSignalSpy rowsSpy(&reader, &QIncrementalImageReader::rowsDecoded);
+
+    reader.addData(data.left(data.size() / 2));
+    QCOMPARE(sizeSpy.count(), 1);
+    QCOMPARE(reader.size(), expected.size());
+    QVERIFY(!reader.isFinished());
+
+    // The first rows are available before all data has arrived
+    QCOMPARE(rowsSpy.count(), 1);
+    const int lastRow = rowsSpy.at(0).at(1).toInt();
+    QCOMPARE(rowsSpy.at(0).at(0).toInt(), 0);
+    QVERIFY(lastRow > 0);
+    QVERIFY(lastRow < expected.height() - 1);
+    const QImage image = reader.image();
+    QCOMPARE(image.size(), expected.size());
+    for (int y = 0; y <= lastRow; ++y)
+        QVERIFY(!memcmp(image.constScanLine(y), expected.constScanLine(y), expected.bytesPerLine()));
+
+    reader.addData(data.mid(data.size() / 2));
+    QVERIFY(reader.isFinished());
+    QCOMPARE(rowsSpy.count(), 2);
+    QCOMPARE(rowsSpy.at(1).at(0).toInt(), lastRow + 1);
+    QCOMPARE(rowsSpy.at(1).at(1).toInt(), expected.height() - 1);
+    QCOMPARE(reader.image(), expected);
+}
+
+void tst_QIncrementalImageReader::truncatedData()
+{
+    const QImage expected = testImage(QImage::Format_ARGB32);
+    const QByteArray data = encodedImage(expected, "png");
+
+    QIncrementalImageReader reader;
+    QSignalSpy finishedSpy(&reader, &QIncrementalImageReader::finished);
+    QSignalSpy errorSpy(&reader, &QIncrementalImageReader::errorOccurred);
+
+    reader.addData(data.left(data.size() / 2));
+    reader.finish();
+    QCOMPARE(finishedSpy.count(), 0);
+    QCOMPARE(errorSpy.count(), 1);
+    QCOMPARE(reader.error(), QImageReader::InvalidDataError);
+    QVERIFY(!reader.isFinished());
+    QVERIFY(!reader.errorString().isEmpty());
+    // The part that was decoded stays available
+    QCOMPARE(reader.image().size(), expected.size());
+}
+
+void tst_QIncrementalImageReader::invalidData()
+{
+    QByteArray data = encodedImage(testImage(QImage::Format_RGB32), "png");
+    // Corrupt the IHDR chunk
+    data[16] = '\xff';
+    data[17] = '\xff';
+
+    QIncrementalImageReader reader;
+    QSignalSpy sizeSpy(&reader, &QIncrementalImageReader::sizeAvailable);
+    QSignalSpy errorSpy(&reader, &QIncrementalImageReader::errorOccurred);
+    reader.addData(data);
+    QCOMPARE(errorSpy.count(), 1);
+    QCOMPARE(sizeSpy.count(), 0);
+    QVERIFY(reader.image().isNull());
+
+    // Data after an error is ignored
+    reader.addData(data);
+    reader.finish();
+    QCOMPARE(errorSpy.count(), 1);
+}
+
+void tst_QIncrementalImageReader::bufferedFormat()
+{
+    const QImage expected = testImage(QImage::Format_RGB32);
+    const QByteArray data = encodedImage(expected, "bmp");
+
+    QIncrementalImageReader reader;
+    QSignalSpy sizeSpy(&reader, &QIncrementalImageReader::sizeAvailable);
+    QSignalSpy rowsSpy(&reader, &QIncrementalImageReader::rowsDecoded);
+    QSignalSpy finishedSpy(&reader, &QIncrementalImageReader::finished);
+
+    reader.addData(data.left(100));
+    QCOMPARE(sizeSpy.count(), 1);
+    QCOMPARE(reader.size(), expected.size());
+    QCOMPARE(rowsSpy.count(), 0);
+
+    reader.addData(data.mid(100));
+    QCOMPARE(finishedSpy.count(), 0);
+    reader.finish();
+    QCOMPARE(finishedSpy.count(), 1);
+    QCOMPARE(rowsSpy.count(), 1);
+    QCOMPARE(rowsSpy.at(0).at(0).toInt(), 0);
+    QCOMPARE(rowsSpy.at(0).at(1).toInt(), expected.height() - 1);
+    QCOMPARE(reader.image(), expected);
+}
+
+void tst_QIncrementalImageReader::reset()
+{
+    const QImage expected = testImage(QImage::Format_ARGB32);
+    const QByteArray data = encodedImage(expected, "png");
+
+    QIncrementalImageReader reader;
+    QSignalSpy errorSpy(&reader, &QIncrementalImageReader::errorOccurred);
+    reader.addData(data.left(data.size() / 2));
+    reader.finish();
+    QCOMPARE(errorSpy.count(), 1);
+
+    reader.reset();
+    QVERIFY(reader.image().isNull());
+    QVERIFY(!reader.size().isValid());
+    reader.addData(data);
+    QVERIFY(reader.isFinished());
+    QCOMPARE(errorSpy.count(), 1);
+    QCOMPARE(reader.image(), expected);
+}
+
+void tst_QIncrementalImageReader::resetFromSignal_data()
+{
+    QTest::addColumn<QByteArray>("signal");
+    QTest::addColumn<bool>("truncate");
+
+    QTest::newRow("sizeAvailable") << QByteArray(SIGNAL(sizeAvailable(QSize))) << false;
+    QTest::newRow("rowsDecoded") << QByteArray(SIGNAL(rowsDecoded(int,int))) << false;
+    QTest::newRow("finished") << QByteArray(SIGNAL(finished())) << false;
+    QTest::newRow("errorOccurred") << QByteArray(SIGNAL(errorOccurred(QImageReader::ImageReaderError)))
+                                   << true;
+}
+
+void tst_QIncrementalImageReader::resetFromSignal()
+{
+    QFETCH(QByteArray, signal);
+    QFETCH(bool, truncate);
+
+    const QImage expected = testImage(QImage::Format_ARGB32);
+    const QByteArray data = encodedImage(expected, "png");
+
+    // e.g. a viewer rejecting an image that is too large
+    QIncrementalImageReader reader;
+    QVERIFY(connect(&reader, signal.constData(), &reader, SLOT(reset())));
+    QSignalSpy finishedSpy(&reader, &QIncrementalImageReader::finished);
+    QSignalSpy errorSpy(&reader, &QIncrementalImageReader::errorOccurred);
+    if (truncate) {
+        reader.addData(data.left(data.size() / 2));
+        reader.finish();
+    } else {
+        reader.addData(data);
+    }
+    QVERIFY(!reader.isFinished());
+    QVERIFY(!reader.size().isValid());
+    QVERIFY(reader.image().isNull());
+    QCOMPARE(finishedSpy.count(), signal.contains("finished") ? 1 : 0);
+    QCOMPARE(errorSpy.count(), truncate ? 1 : 0);
+
+    QVERIFY(disconnect(&reader, signal.constData(), &reader, SLOT(reset())));
+    reader.reset();
+    reader.addData(data);
+    QVERIFY(reader.isFinished());
+    QCOMPARE(reader.image(), expected);
+}
+
+QTEST_GUILESS_MAIN(tst_QIncrementalImageReader)
+#include "tst_qincrementalimagereader.moc"
@@ -32,6 +32,7 @@
 #include <qcolorspace.h>
 #include <qimage.h>
 #include <qimagereader.h>
+#include <qrgbafloat.h>
 
 #include <private/qcolorspace_p.h>
 
@@ -65,6 +66,10 @@ private slots:
     void imageConversion64PM();
     void imageConversionOverLargerGamut_data();
     void imageConversionOverLargerGamut();
+    void imageConversionFP_data();
+    void imageConversionFP();
+    void imageConversionChannels_data();
+    void imageConversionChannels();
 
     void loadImage();
 
@@ -489,6 +494,102 @@ void tst_QColorSpace::imageConversionOverLargerGamut()
     }
 }
 
+void tst_QColorSpace::imageConversionFP_data()
+{
+    QTest::addColumn<QImage::Format>("format");
+
+    QTest::newRow("rgbx16fpx4") << QImage::Format_RGBX16FPx4;
+    QTest::newRow("rgba16fpx4") << QImage::Format_RGBA16FPx4;
+    QTest::newRow("rgba16fpx4pm") << QImage::Format_RGBA16FPx4_Premultiplied;
+    QTest::newRow("rgbx32fpx4") << QImage::Format_RGBX32FPx4;
+    QTest::newRow("rgba32fpx4") << QImage::Format_RGBA32FPx4;
+    QTest::newRow("rgba32fpx4pm") << QImage::Format_RGBA32FPx4_Premultiplied;
+}
+
+static QRgbaFloat32 pixelFP(const QImage &image, int x, int y)
+{
+    if (image.depth() > 64)
+        return reinterpret_cast<const QRgbaFloat32 *>(image.constScanLine(y))[x];
+    const QRgbaFloat16 p = reinterpret_cast<const QRgbaFloat16 *>(image.constScanLine(y))[x];
+    return QRgbaFloat32{p.red(), p.green(), p.blue(), p.alpha()};
+}
+
+void tst_QColorSpace::imageConversionFP()
+{
+    QFETCH(QImage::Format, format);
+
+    // Floating point images must keep colors that fall outside of the target gamut
+    QImage testImage(256, 1, format);
+    testImage.setColorSpace(QColorSpace::DisplayP3);
+    for (int i = 0; i < 256; ++i)
+        testImage.setPixelColor(i, 0, QColor::fromRgbF(i / 255.0f, 0.0f, i / 510.0f));
+
+    QImage resultImage = testImage.convertedToColorSpace(QColorSpace::SRgb);
+    QCOMPARE(resultImage.format(), format);
+    QCOMPARE(resultImage.colorSpace(), QColorSpace(QColorSpace::SRgb));
+    const QRgbaFloat32 red = pixelFP(resultImage, 255, 0);
+    QVERIFY(red.r > 1.0f);
+    QVERIFY(red.g < 0.0f);
+    QCOMPARE(red.a, 1.0f);
+
+    resultImage.convertToColorSpace(QColorSpace::DisplayP3);
+    const float tolerance = resultImage.depth() > 64 ? 0.001f : 0.004f;
+    for (int i = 0; i < 256; ++i) {
+        const QRgbaFloat32 expected = pixelFP(testImage, i, 0);
+        const QRgbaFloat32 p = pixelFP(resultImage, i, 0);
+        QVERIFY2(qAbs(p.r - expected.r) <= tolerance, qPrintable(QString::number(p.r)));
+        QVERIFY2(qAbs(p.g - expected.g) <= tolerance, qPrintable(QString::number(p.g)));
+        QVERIFY2(qAbs(p.b - expected.b) <= tolerance, qPrintable(QString::number(p.b)));
+        QCOMPARE(p.a, expected.a);
+    }
+}
+
+void tst_QColorSpace::imageConversionChannels_data()
+{
+    QTest::addColumn<QImage::Format>("format");
+
+    QTest::newRow("argb32") << QImage::Format_ARGB32;
+    QTest::newRow("argb32pm") << QImage::Format_ARGB32_Premultiplied;
+    QTest::newRow("rgb32") << QImage::Format_RGB32;
+    QTest::newRow("rgba64") << QImage::Format_RGBA64;
+    QTest::newRow("rgba64pm") << QImage::Format_RGBA64_Premultiplied;
+    QTest::newRow("rgbx64") << QImage::Format_RGBX64;
+}
+
+void tst_QColorSpace::imageConversionChannels()
+{
+    QFETCH(QImage::Format, format);
+
+    // Distinct channels in every pixel, and a width that is not a multiple of
+    // any vector size, must give the same result as mapping each pixel
+    QImage testImage(37, 7, QImage::Format_ARGB32);
+    for (int y = 0; y < testImage.height(); ++y) {
+        for (int x = 0; x < testImage.width(); ++x)
+            testImage.setPixel(x, y, qRgba(x * 7, 255 - x * 5, y * 40, 255 - y * 15));
+    }
+    testImage = testImage.convertToFormat(format);
+    testImage.setColorSpace(QColorSpace::SRgb);
+
+    const QColorTransform transform =
+            QColorSpace(QColorSpace::SRgb).transformationToColorSpace(QColorSpace::DisplayP3);
+    const QImage resultImage = testImage.convertedToColorSpace(QColorSpace::DisplayP3);
+    QCOMPARE(resultImage.format(), format);
+    const bool opaque = !resultImage.hasAlphaChannel();
+    for (int y = 0; y < testImage.height(); ++y) {
+        for (int x = 0; x < testImage.width(); ++x) {
+            const QRgb expected = transform.map(testImage.pixelColor(x, y).rgba());
+            const QRgb p = resultImage.pixelColor(x, y).rgba();
+            const int a = opaque ? 255 : qAlpha(expected);
+            // premultiplied formats lose precision in the low alpha pixels
+            const int tolerance = 1 + 255 / qMax(a, 1);
+            QVERIFY2(qAbs(qRed(p) - qRed(expected)) <= tolerance, qPrintable(QString::number(x)));
+            QVERIFY2(qAbs(qGreen(p) - qGreen(expected)) <= tolerance, qPrintable(QString::number(x)));
+            QVERIFY2(qAbs(qBlue(p) - qBlue(expected)) <= tolerance, qPrintable(QString::number(x)));
+            QCOMPARE(qAlpha(p), a);
+        }
+    }
+}
+
 void tst_QColorSpace::loadImage()
 {
     QString prefix = QFINDTESTDATA("resources/");
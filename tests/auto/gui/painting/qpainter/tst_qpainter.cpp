@@ -167,6 +167,8 @@ private slots:
     void porterDuff_warning();
 
     void drawhelper_blend_color();
+    void drawhelper_blend_spans_data();
+    void drawhelper_blend_spans();
 
 #ifndef QT_NO_WIDGETS
     void childWidgetViewport();
@@ -182,6 +184,8 @@ private slots:
 
     void gradientPixelFormat_data();
     void gradientPixelFormat();
+    void gradientPixelFormatRotated_data();
+    void gradientPixelFormatRotated();
 
 #if QT_CONFIG(raster_64bit)
     void linearGradientRgb30_data();
@@ -2692,6 +2696,101 @@ void tst_QPainter::drawhelper_blend_color()
     QCOMPARE(dest, expected);
 }
 
+void tst_QPainter::drawhelper_blend_spans_data()
+{
+    QTest::addColumn<QImage::Format>("format");
+    QTest::addColumn<QPainter::CompositionMode>("mode");
+    QTest::addColumn<qreal>("opacity");
+    QTest::addColumn<bool>("solid");
+
+    const struct {
+        QImage::Format format;
+        const char *name;
+    } formats[] = {
+        { QImage::Format_ARGB32_Premultiplied, "argb32pm" },
+        { QImage::Format_RGBA32FPx4_Premultiplied, "rgba32fpx4pm" },
+        { QImage::Format_RGBA32FPx4, "rgba32fpx4" },
+    };
+    const struct {
+        QPainter::CompositionMode mode;
+        const char *name;
+    } modes[] = {
+        { QPainter::CompositionMode_SourceOver, "SourceOver" },
+        { QPainter::CompositionMode_Source, "Source" },
+        { QPainter::CompositionMode_Plus, "Plus" },
+    };
+    for (const auto &format : formats) {
+        for (const auto &mode : modes) {
+            for (qreal opacity : { 1.0, 0.6 }) {
+                QTest::addRow("%s, %s, opacity %g, image", format.name, mode.name, opacity)
+                        << format.format << mode.mode << opacity << false;
+                QTest::addRow("%s, %s, opacity %g, solid", format.name, mode.name, opacity)
+                        << format.format << mode.mode << opacity << true;
+            }
+        }
+    }
+}
+
+void tst_QPainter::drawhelper_blend_spans()
+{
+    QFETCH(QImage::Format, format);
+    QFETCH(QPainter::CompositionMode, mode);
+    QFETCH(qreal, opacity);
+    QFETCH(bool, solid);
+
+    // The SIMD blend functions handle the start and the end of a span
+    // separately, blending a span at once must give what blending each
+    // of its pixels does. The images are two pixels high, as a single
+    // pixel of an image is painted as a solid color.
+    const int maxLength = 67;
+    const int maxOffset = 16;
+
+    QImage src(maxLength, 2, QImage::Format_ARGB32_Premultiplied);
+    for (int x = 0; x < src.width(); ++x) {
+        const int alpha = x % 5 == 4 ? 0 : x % 3 ? (x * 29) % 256 : 255;
+        const QRgb pixel = qPremultiply(qRgba(x * 7 % 256, x * 13 % 256, x * 31 % 256, alpha));
+        src.setPixel(x, 0, pixel);
+        src.setPixel(x, 1, pixel);
+    }
+    QImage background(maxOffset + maxLength, 2, QImage::Format_ARGB32_Premultiplied);
+    for (int x = 0; x < background.width(); ++x) {
+        const QRgb pixel = qPremultiply(qRgba(x * 11 % 256, x * 23 % 256, x * 53 % 256, x * 37 % 256));
+        background.setPixel(x, 0, pixel);
+        background.setPixel(x, 1, pixel);
+    }
+    src.convertTo(format);
+    background.convertTo(format);
+    const QColor color(40, 120, 200, 160);
+
+    const auto blend = [&](QPainter *p, int x, int from, int length) {
+        if (solid)
+            p->fillRect(x + from, 0, length, 2, color);
+        else
+            p->drawImage(x + from, 0, src, from, 0, length, 2);
+    };
+
+    for (int offset = 0; offset < maxOffset; ++offset) {
+        for (int length = 1; length <= maxLength; ++length) {
+            QImage span = background.copy();
+            QPainter p(&span);
+            p.setCompositionMode(mode);
+            p.setOpacity(opacity);
+            blend(&p, offset, 0, length);
+            p.end();
+
+            QImage pixels = background.copy();
+            p.begin(&pixels);
+            p.setCompositionMode(mode);
+            p.setOpacity(opacity);
+            for (int x = 0; x < length; ++x)
+                blend(&p, offset, x, 1);
+            p.end();
+
+            QCOMPARE(span, pixels);
+        }
+    }
+}
+
 #ifndef QT_NO_WIDGETS
 class ViewportTestWidget : public QWidget
 {
@@ -3873,6 +3972,9 @@ void tst_QPainter::gradientPixelFormat_data()
     QTest::newRow("rgba8888_pm") << QImage::Format_RGBA8888_Premultiplied;
     QTest::newRow("rgbx64") << QImage::Format_RGBX64;
     QTest::newRow("rgba64_pm") << QImage::Format_RGBA64_Premultiplied;
+    QTest::newRow("rgba16fpx4_pm") << QImage::Format_RGBA16FPx4_Premultiplied;
+    QTest::newRow("rgba32fpx4") << QImage::Format_RGBA32FPx4;
+    QTest::newRow("rgba32fpx4_pm") << QImage::Format_RGBA32FPx4_Premultiplied;
 }
 
 void tst_QPainter::gradientPixelFormat()
@@ -3906,6 +4008,38 @@ void tst_QPainter::gradientPixelFormat()
     QCOMPARE(a, b.convertToFormat(QImage::Format_ARGB32_Premultiplied));
 }
 
+void tst_QPainter::gradientPixelFormatRotated_data()
+{
+    gradientPixelFormat_data();
+}
+
+void tst_QPainter::gradientPixelFormatRotated()
+{
+    QFETCH(QImage::Format, format);
+
+    // The gradient is constant along each rotated span, which makes the
+    // gradient fetch fill the span with a single color.
+    QImage a(8, 64, QImage::Format_ARGB32_Premultiplied);
+    QImage b(8, 64, format);
+    a.fill(0);
+    b.fill(0);
+
+    QLinearGradient gradient(0, 0, 64, 0);
+    gradient.setColorAt(0.0, Qt::blue);
+    gradient.setColorAt(0.3, Qt::red);
+    gradient.setColorAt(0.6, Qt::green);
+    gradient.setColorAt(1.0, Qt::black);
+
+    for (QImage *image : { &a, &b }) {
+        QPainter p(image);
+        p.translate(8, 0);
+        p.rotate(90);
+        p.fillRect(0, 0, 64, 8, gradient);
+    }
+
+    QCOMPARE(b.convertToFormat(QImage::Format_ARGB32_Premultiplied), a);
+}
+
 void tst_QPainter::gradientInterpolation()
 {
     QImage image(256, 8, QImage::Format_ARGB32_Premultiplied);
@@ -0,0 +1,201 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QTest>
+#include <QImage>
+#include <QPainter>
+#include <QPainterPath>
+#include <QPicture>
+#include <QPixmap>
+
+#include <private/qguiapplication_p.h>
+#include <private/qrastertilerenderer_p.h>
+#include <qpa/qplatformintegration.h>
+
+class tst_QRasterTileRenderer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void tiles();
+    void render_data();
+    void render();
+};
+
+static QImage sourceImage()
+{
+    QImage image(40, 30, QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x)
+            image.setPixel(x, y, qRgba(x * 6, y * 8, (x + y) * 3, 255));
+    }
+    return image;
+}
+
+using PaintFunction = void (*)(QPainter *);
+Q_DECLARE_METATYPE(PaintFunction)
+
+static void paintSolid(QPainter *p)
+{
+    p->fillRect(10, 10, 200, 100, Qt::red);
+    p->setRenderHint(QPainter::Antialiasing);
+    p->setPen(QPen(Qt::blue, 3.5));
+    p->setBrush(QColor(0, 128, 0, 128));
+    p->drawEllipse(QPointF(150.3, 100.7), 120, 80);
+    p->rotate(17);
+    p->drawRoundedRect(QRectF(40.5, 20.25, 150, 90), 12, 12);
+    p->setClipRect(0, 50, 150, 80);
+    p->drawLine(QPointF(0, 0), QPointF(300, 200));
+}
+
+static void paintText(QPainter *p)
+{
+    p->setPen(Qt::black);
+    p->setFont(QFont(QStringLiteral("Arial"), 14));
+    for (int i = 0; i < 10; ++i)
+        p->drawText(QPointF(5.5, 18 * i + 14.25), QStringLiteral("Tiles are painted in parallel"));
+}
+
+static void paintImages(QPainter *p)
+{
+    const QImage image = sourceImage();
+    for (int i = 0; i < 6; ++i)
+        p->drawImage(QPointF(i * 45.5, i * 31), image);
+    p->drawTiledPixmap(QRect(0, 120, 300, 70), QPixmap::fromImage(image), QPoint(7, 3));
+    p->setBrush(QBrush(image));
+    p->translate(3, 5);
+    p->drawRect(150, 10, 140, 100);
+}
+
+static void paintLinearGradient(QPainter *p)
+{
+    QLinearGradient gradient(0, 0, 300, 37);
+    gradient.setColorAt(0, Qt::red);
+    gradient.setColorAt(1, Qt::blue);
+    p->fillRect(0, 0, 300, 200, gradient);
+}
+
+static void paintScaledImage(QPainter *p)
+{
+    p->setRenderHint(QPainter::SmoothPixmapTransform);
+    p->drawImage(QRectF(3.5, 7, 291, 187), sourceImage());
+}
+
+static void paintRotatedPixmap(QPainter *p)
+{
+    p->setRenderHint(QPainter::SmoothPixmapTransform);
+    p->translate(150, 100);
+    p->rotate(33);
+    p->scale(3, 3);
+    p->drawPixmap(-20, -15, QPixmap::fromImage(sourceImage()));
+}
+
+static void paintGradientPen(QPainter *p)
+{
+    QRadialGradient gradient(150, 100, 120);
+    gradient.setColorAt(0, Qt::green);
+    gradient.setColorAt(1, Qt::magenta);
+    p->setPen(QPen(QBrush(gradient), 20));
+    p->drawLine(0, 0, 300, 200);
+}
+
+void tst_QRasterTileRenderer::tiles()
+{
+    QImage image(301, 203, QImage::Format_ARGB32_Premultiplied);
+    QRasterTileRenderer renderer(&image);
+
+    // the bands and the tiles cover the image exactly once
+    for (const QSize &tileSize : { QSize(), QSize(64, 64), QSize(37, 23), QSize(1000, 1000) }) {
+        renderer.setTileSize(tileSize);
+        const QList<QRect> tiles = renderer.tiles();
+        QVERIFY(!tiles.isEmpty());
+        QRegion covered;
+        qint64 area = 0;
+        for (const QRect &tile : tiles) {
+            QVERIFY(!tile.isEmpty());
+            QVERIFY(image.rect().contains(tile));
+            if (!tileSize.isValid())
+                QCOMPARE(tile.width(), image.width());
+            covered += tile;
+            area += qint64(tile.width()) * tile.height();
+        }
+        QCOMPARE(covered, QRegion(image.rect()));
+        QCOMPARE(area, qint64(image.width()) * image.height());
+    }
+}
+
+void tst_QRasterTileRenderer::render_data()
+{
+    QTest::addColumn<PaintFunction>("paint");
+    QTest::addColumn<bool>("parallel");
+
+    QTest::newRow("solid") << &paintSolid << true;
+    QTest::newRow("text") << &paintText << true;
+    QTest::newRow("images") << &paintImages << true;
+    // fetches that step from the first pixel of a span would round
+    // differently at tile edges, these are painted with a single painter
+    QTest::newRow("linearGradient") << &paintLinearGradient << false;
+    QTest::newRow("scaledImage") << &paintScaledImage << false;
+    QTest::newRow("rotatedPixmap") << &paintRotatedPixmap << false;
+    QTest::newRow("gradientPen") << &paintGradientPen << false;
+}
+
+void tst_QRasterTileRenderer::render()
+{
+    QFETCH(PaintFunction, paint);
+    QFETCH(bool, parallel);
+
+    QPicture picture;
+    QPainter painter(&picture);
+    paint(&painter);
+    painter.end();
+
+    for (const QImage::Format format : { QImage::Format_ARGB32_Premultiplied, QImage::Format_RGB32,
+                                         QImage::Format_RGB16 }) {
+        QImage expected(300, 200, format);
+        expected.fill(Qt::white);
+        QPainter p(&expected);
+        p.drawPicture(0, 0, picture);
+        p.end();
+
+        for (const QSize &tileSize : { QSize(), QSize(37, 23) }) {
+            QImage image(expected.size(), format);
+            image.fill(Qt::white);
+            QRasterTileRenderer renderer(&image);
+            renderer.setTileSize(tileSize);
+            if (QGuiApplicationPrivate::platformIntegration()->hasCapability(QPlatformIntegration::ThreadedPixmaps))
+                QCOMPARE(renderer.canRenderInParallel(picture), parallel);
+            QVERIFY(renderer.render(picture));
+            QCOMPARE(image, expected);
+        }
+    }
+}
+
+QTEST_MAIN(tst_QRasterTileRenderer)
+#include "tst_qrastertilerenderer.moc"
@@ -55,6 +55,8 @@ private Q_SLOTS:
     void bitstreamReadWrite();
     void bitstreamCompression();
     void bitstreamErrors();
+    void huffmanDecoding_data();
+    void huffmanDecoding();
 
     void lookupTableConstructor();
 
@@ -343,6 +345,55 @@ void tst_Hpack::bitstreamErrors()
     }
 }
 
+void tst_Hpack::huffmanDecoding_data()
+{
+    QTest::addColumn<QByteArray>("encoded"); // Huffman-compressed string literal.
+    QTest::addColumn<bool>("valid");
+    QTest::addColumn<QByteArray>("decoded");
+
+    QTest::newRow("empty") << QByteArray::fromHex("80") << true << QByteArray();
+    // 'a' is 00011, padded with 111:
+    QTest::newRow("padded") << QByteArray::fromHex("811f") << true << QByteArray("a");
+    QTest::newRow("not-padded-with-eos") << QByteArray::fromHex("8118") << false << QByteArray();
+    QTest::newRow("padding-too-long") << QByteArray::fromHex("821fff") << false << QByteArray();
+    // EOS is 30 bits set:
+    QTest::newRow("eos") << QByteArray::fromHex("84ffffffff") << false << QByteArray();
+    // From HPACK's specs, C.4.1:
+    QTest::newRow("www.example.com") << QByteArray::fromHex("8cf1e3c2e5f23a6ba0ab90f4ff")
+                                     << true << QByteArray("www.example.com");
+
+    // All octets, codes with every length:
+    QByteArray allOctets;
+    for (int i = 0; i < 256; ++i)
+        allOctets.append(char(i));
+    std::vector<uchar> buffer;
+    BitOStream out(buffer);
+    out.write(allOctets, true);
+    QTest::newRow("all-octets") << QByteArray(reinterpret_cast<const char *>(out.begin()),
+                                              int(out.byteLength()))
+                                << true << allOctets;
+}
+
+void tst_Hpack::huffmanDecoding()
+{
+    QFETCH(const QByteArray, encoded);
+    QFETCH(const bool, valid);
+    QFETCH(const QByteArray, decoded);
+
+    const auto begin = reinterpret_cast<const uchar *>(encoded.constData());
+    BitIStream in(begin, begin + encoded.size());
+    QByteArray data;
+    QCOMPARE(in.read(&data), valid);
+    if (valid) {
+        QCOMPARE(in.error(), StreamError::NoError);
+        QCOMPARE(data, decoded);
+        QVERIFY(!in.hasMoreBits());
+    } else {
+        QCOMPARE(in.error(), StreamError::CompressionError);
+        QCOMPARE(in.streamOffset(), quint64(0));
+    }
+}
+
 void tst_Hpack::lookupTableConstructor()
 {
     {
@@ -399,6 +450,17 @@ void tst_Hpack::lookupTableStatic()
         QCOMPARE(value, field.value);
         ++currentIndex;
     }
+
+    // Name-only lookup finds the first entry with this name:
+    QCOMPARE(table.indexOf(":status"), 8u);
+    QCOMPARE(table.indexOf("accept"), 19u);
+    QCOMPARE(table.indexOf("www-authenticate"), 61u);
+
+    const FieldLookupTable emptyTable(0, true);
+    QCOMPARE(emptyTable.indexOf(":status", "201"), 0u);
+    QCOMPARE(emptyTable.indexOf("accept", "*/*"), 0u);
+    QCOMPARE(emptyTable.indexOf("Accept"), 0u);
+    QCOMPARE(emptyTable.indexOf("x-custom-header"), 0u);
 }
 
 void tst_Hpack::lookupTableDynamic()
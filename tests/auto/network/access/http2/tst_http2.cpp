@@ -95,8 +95,11 @@ private slots:
     void singleRequest_data();
     void singleRequest();
     void multipleRequests();
+    void connectionReused();
     void flowControlClientSide();
     void flowControlServerSide();
+    void windowAutoTuning_data();
+    void windowAutoTuning();
     void pushPromise();
     void goaway_data();
     void goaway();
@@ -129,7 +132,8 @@ protected slots:
     void decompressionFailed(quint32 streamID);
     void receivedRequest(quint32 streamID);
     void receivedData(quint32 streamID);
-    void windowUpdated(quint32 streamID);
+    void windowUpdated(quint32 streamID, quint32 delta);
+    void receivedPING();
     void replyFinished();
     void replyFinishedWithError();
 
@@ -159,6 +163,8 @@ private:
     int nSentRequests = 0;
 
     int windowUpdates = 0;
+    quint32 maxWindowUpdateDelta = 0;
+    int pingsReceived = 0;
     bool prefaceOK = false;
     bool serverGotSettingsACK = false;
     bool POSTResponseHEADOnly = true;
@@ -342,6 +348,56 @@ void tst_Http2::multipleRequests()
     QVERIFY(serverGotSettingsACK);
 }
 
+void tst_Http2::connectionReused()
+{
+    clearHTTP2State();
+
+    serverPort = 0;
+    nRequests = 3;
+
+    ServerPtr srv(newServer(defaultServerSettings, H2Type::h2cDirect));
+
+    QMetaObject::invokeMethod(srv.data(), "startServer", Qt::QueuedConnection);
+    runEventLoop();
+
+    QVERIFY(serverPort != 0);
+
+    auto url = requestUrl(H2Type::h2cDirect);
+    url.setPath("/index.html");
+
+    QNetworkRequest request(url);
+    request.setAttribute(QNetworkRequest::Http2CleartextAllowedAttribute, true);
+    request.setAttribute(QNetworkRequest::Http2DirectAttribute, QVariant(true));
+
+    // The requests that open the connection are all sent with the client
+    // preface, so none of them reuses it, even if they get streams 3 and 5.
+    QList<QNetworkReply *> replies;
+    for (int i = 0; i < nRequests; ++i) {
+        replies.append(manager->get(request));
+        connect(replies.last(), &QNetworkReply::finished, this, &tst_Http2::replyFinished);
+    }
+
+    runEventLoop();
+    STOP_ON_FAILURE
+
+    QVERIFY(nRequests == 0);
+    for (QNetworkReply *reply : qAsConst(replies)) {
+        QCOMPARE(reply->error(), QNetworkReply::NoError);
+        QCOMPARE(reply->attribute(QNetworkRequest::ConnectionReusedAttribute).toBool(), false);
+    }
+
+    nRequests = 1;
+    QNetworkReply *reply = manager->get(request);
+    connect(reply, &QNetworkReply::finished, this, &tst_Http2::replyFinished);
+
+    runEventLoop();
+    STOP_ON_FAILURE
+
+    QVERIFY(nRequests == 0);
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QCOMPARE(reply->attribute(QNetworkRequest::ConnectionReusedAttribute).toBool(), true);
+}
+
 void tst_Http2::flowControlClientSide()
 {
     // Create a server but impose limits:
@@ -428,6 +484,74 @@ void tst_Http2::flowControlServerSide()
     QVERIFY(serverGotSettingsACK);
 }
 
+void tst_Http2::windowAutoTuning_data()
+{
+    QTest::addColumn<bool>("autoTuning");
+    QTest::addColumn<qint32>("streamWindowSize");
+
+    QTest::addRow("fixed-windows") << false << qint32(Http2::defaultSessionWindowSize);
+    QTest::addRow("auto-tuning") << true << qint32(Http2::defaultSessionWindowSize);
+    // Windows that are already as large as auto-tuning would make them
+    // are left alone, without measuring anything:
+    QTest::addRow("auto-tuning-large-windows") << true << Http2::maxAutoTunedWindowSize;
+}
+
+void tst_Http2::windowAutoTuning()
+{
+    // The client starts with the default (small) stream receive window;
+    // with auto-tuning it measures the bandwidth-delay product using PING
+    // frames and grows the window, which shows up as WINDOW_UPDATE frames
+    // larger than the initial window.
+    using namespace Http2;
+
+    QFETCH(const bool, autoTuning);
+    QFETCH(const qint32, streamWindowSize);
+
+    clearHTTP2State();
+
+    serverPort = 0;
+    nRequests = 5;
+
+    QHttp2Configuration params;
+    params.setStreamReceiveWindowSize(streamWindowSize);
+    params.setSessionReceiveWindowSize(streamWindowSize * 5);
+    params.setWindowAutoTuningEnabled(autoTuning);
+    QCOMPARE(params.windowAutoTuningEnabled(), autoTuning);
+
+    ServerPtr srv(newServer(defaultServerSettings, defaultConnectionType(),
+                            qt_H2ConfigurationToSettings(params)));
+    const QByteArray respond(int(Http2::defaultSessionWindowSize * 100), 'x');
+    srv->setResponseBody(respond);
+
+    QMetaObject::invokeMethod(srv.data(), "startServer", Qt::QueuedConnection);
+
+    runEventLoop();
+    QVERIFY(serverPort != 0);
+
+    for (int i = 0; i < nRequests; ++i)
+        sendRequest(i, QNetworkRequest::NormalPriority, {}, params);
+
+    runEventLoop(120000);
+    STOP_ON_FAILURE
+
+    QVERIFY(nRequests == 0);
+    QVERIFY(prefaceOK);
+    QVERIFY(serverGotSettingsACK);
+    if (streamWindowSize >= Http2::maxAutoTunedWindowSize) {
+        QCOMPARE(pingsReceived, 0);
+        return;
+    }
+
+    QVERIFY(windowUpdates > 0);
+    if (autoTuning) {
+        QVERIFY(pingsReceived > 0);
+        QVERIFY(maxWindowUpdateDelta > quint32(Http2::defaultSessionWindowSize));
+    } else {
+        QCOMPARE(pingsReceived, 0);
+        QVERIFY(maxWindowUpdateDelta <= quint32(Http2::defaultSessionWindowSize));
+    }
+}
+
 void tst_Http2::pushPromise()
 {
     // We will first send some request, the server should reply and also emulate
@@ -1235,6 +1359,8 @@ void tst_Http2::serverStarted(quint16 port)
 void tst_Http2::clearHTTP2State()
 {
     windowUpdates = 0;
+    maxWindowUpdateDelta = 0;
+    pingsReceived = 0;
     prefaceOK = false;
     serverGotSettingsACK = false;
     POSTResponseHEADOnly = true;
@@ -1268,6 +1394,7 @@ Http2Server *tst_Http2::newServer(const RawSettings &serverSettings, H2Type conn
     connect(srv, &Srv::receivedRequest, this, &Cl::receivedRequest);
     connect(srv, &Srv::receivedData, this, &Cl::receivedData);
     connect(srv, &Srv::windowUpdate, this, &Cl::windowUpdated);
+    connect(srv, &Srv::receivedPING, this, &Cl::receivedPING);
 
     srv->moveToThread(workerThread);
 
@@ -1374,11 +1501,17 @@ void tst_Http2::receivedData(quint32 streamID)
                               Q_ARG(bool, POSTResponseHEADOnly /*true = HEADERS only*/));
 }
 
-void tst_Http2::windowUpdated(quint32 streamID)
+void tst_Http2::windowUpdated(quint32 streamID, quint32 delta)
 {
     Q_UNUSED(streamID);
 
     ++windowUpdates;
+    maxWindowUpdateDelta = std::max(maxWindowUpdateDelta, delta);
+}
+
+void tst_Http2::receivedPING()
+{
+    ++pingsReceived;
 }
 
 void tst_Http2::replyFinished()
@@ -70,6 +70,11 @@ private slots:
     void updateMetaData();
     void fileMetaData();
     void expire();
+    void expireManyItems();
+    void index_data();
+    void index();
+    void unjournaledFiles();
+    void cleanJournal();
 
     void oldCacheVersionFile_data();
     void oldCacheVersionFile();
@@ -562,6 +567,221 @@ void tst_QNetworkDiskCache::expire()
     }
 }
 
+void tst_QNetworkDiskCache::expireManyItems()
+{
+    QTemporaryDir dir(tempDir.path() + "/expireManyItems.XXXXXX");
+    QVERIFY(dir.isValid());
+    SubQNetworkDiskCache cache;
+    cache.setCacheDirectory(dir.path());
+
+    // enough items for the expired files to be removed in the background
+    const int itemCount = 500;
+    for (int i = 0; i < itemCount; ++i) {
+        QNetworkCacheMetaData m;
+        m.setUrl(QUrl("http://localhost:4/" + QString::number(i)));
+        QIODevice *d = cache.prepare(m);
+        QVERIFY(d);
+        d->write(QByteArray(1024, 'Z'));
+        cache.insert(d);
+    }
+    const qint64 fullSize = cache.cacheSize();
+    QVERIFY(fullSize > itemCount * 1024);
+
+    cache.setMaximumCacheSize(fullSize / 4);
+    QVERIFY(cache.cacheSize() < fullSize / 4);
+
+    // the oldest items are gone as soon as expire() returns...
+    QVERIFY(!cache.metaData(QUrl("http://localhost:4/0")).isValid());
+    QVERIFY(!cache.data(QUrl("http://localhost:4/1")));
+    QVERIFY(cache.metaData(QUrl("http://localhost:4/" + QString::number(itemCount - 1))).isValid());
+
+    // removing an item that is still being removed does not count it twice
+    const qint64 expiredSize = cache.cacheSize();
+    cache.remove(QUrl("http://localhost:4/2"));
+    QCOMPARE(cache.cacheSize(), expiredSize);
+
+    // ...and an expired item can be stored again right away
+    QNetworkCacheMetaData m;
+    m.setUrl(QUrl("http://localhost:4/0"));
+    QIODevice *d = cache.prepare(m);
+    QVERIFY(d);
+    d->write("Hello World!");
+    cache.insert(d);
+
+    // the files follow shortly
+    const auto countCacheFiles = [&dir] {
+        return countFiles(dir.path()).count() - NUM_SUBDIRECTORIES - 2;
+    };
+    QTRY_VERIFY(countCacheFiles() < itemCount / 4);
+    QScopedPointer<QIODevice> device(cache.data(QUrl("http://localhost:4/0")));
+    QVERIFY(device);
+    QCOMPARE(device->readAll(), QByteArray("Hello World!"));
+}
+
+void tst_QNetworkDiskCache::index_data()
+{
+    QTest::addColumn<bool>("removeIndex");
+    QTest::newRow("journal") << false;
+    QTest::newRow("rebuilt") << true;
+}
+
+void tst_QNetworkDiskCache::index()
+{
+    QFETCH(bool, removeIndex);
+    QTemporaryDir dir(tempDir.path() + "/index.XXXXXX");
+    QVERIFY(dir.isValid());
+
+    qint64 cacheSize = 0;
+    {
+        SubQNetworkDiskCache cache;
+        cache.setCacheDirectory(dir.path());
+        for (int i = 0; i < 3; ++i) {
+            QNetworkCacheMetaData m;
+            m.setUrl(QUrl("http://localhost:4/" + QString::number(i)));
+            QIODevice *d = cache.prepare(m);
+            QVERIFY(d);
+            d->write(QByteArray(1024 * (i + 1), 'Z'));
+            cache.insert(d);
+        }
+        QVERIFY(cache.remove(QUrl("http://localhost:4/1")));
+        cacheSize = cache.cacheSize();
+        cache.setClearCacheOnDestruction(false);
+    }
+
+    if (removeIndex) {
+        const QStringList journals = QDir(dir.path() + "/data8").entryList(QDir::Files | QDir::Hidden);
+        QCOMPARE(journals.count(), 1);
+        QVERIFY(QFile::remove(dir.path() + "/data8/" + journals.first()));
+    }
+
+    SubQNetworkDiskCache cache;
+    cache.setCacheDirectory(dir.path());
+    QCOMPARE(cache.cacheSize(), cacheSize);
+    QVERIFY(cache.metaData(QUrl("http://localhost:4/0")).isValid());
+    QVERIFY(!cache.metaData(QUrl("http://localhost:4/1")).isValid());
+    QVERIFY(cache.metaData(QUrl("http://localhost:4/2")).isValid());
+
+    if (!removeIndex) {
+        // the oldest entry goes first
+        cache.setMaximumCacheSize(cacheSize - 1);
+        QVERIFY(!cache.metaData(QUrl("http://localhost:4/0")).isValid());
+        QVERIFY(cache.metaData(QUrl("http://localhost:4/2")).isValid());
+    }
+
+    cache.clear();
+    QCOMPARE(cache.cacheSize(), qint64(0));
+    QCOMPARE(countFiles(dir.path()).count(), NUM_SUBDIRECTORIES + 2);
+}
+
+void tst_QNetworkDiskCache::unjournaledFiles()
+{
+    QTemporaryDir dir(tempDir.path() + "/unjournaledFiles.XXXXXX");
+    QVERIFY(dir.isValid());
+    const QString dataDir = dir.path() + "/data8/";
+
+    const auto store = [](QNetworkDiskCache &cache, int i) {
+        QNetworkCacheMetaData m;
+        m.setUrl(QUrl("http://localhost:4/" + QString::number(i)));
+        QIODevice *d = cache.prepare(m);
+        QVERIFY(d);
+        d->write(QByteArray(1024 * (i + 1), 'Z'));
+        cache.insert(d);
+    };
+
+    QByteArray journal;
+    qint64 cacheSize = 0;
+    {
+        SubQNetworkDiskCache cache;
+        cache.setCacheDirectory(dir.path());
+        store(cache, 0);
+        const QStringList journals = QDir(dataDir).entryList(QDir::Files | QDir::Hidden);
+        QCOMPARE(journals.count(), 1);
+        QFile file(dataDir + journals.first());
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        journal = file.readAll();
+        store(cache, 1);
+        store(cache, 2);
+        cacheSize = cache.cacheSize();
+        cache.setClearCacheOnDestruction(false);
+    }
+
+    // as if the application had crashed before recording the last two files
+    const QStringList journals = QDir(dataDir).entryList(QDir::Files | QDir::Hidden);
+    QFile file(dataDir + journals.first());
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    QCOMPARE(file.write(journal), journal.size());
+    file.close();
+
+    SubQNetworkDiskCache cache;
+    cache.setCacheDirectory(dir.path());
+    QCOMPARE(cache.cacheSize(), cacheSize);
+    QVERIFY(cache.metaData(QUrl("http://localhost:4/2")).isValid());
+
+    cache.setMaximumCacheSize(1);
+    QTRY_COMPARE(countFiles(dir.path()).count(), NUM_SUBDIRECTORIES + 2);
+    QCOMPARE(cache.cacheSize(), qint64(0));
+
+    // clear() removes files that the index doesn't know about, too
+    SubQNetworkDiskCache other;
+    other.setCacheDirectory(dir.path());
+    store(cache, 0);
+    QCOMPARE(countFiles(dir.path()).count(), NUM_SUBDIRECTORIES + 3);
+    other.clear();
+    QCOMPARE(other.cacheSize(), qint64(0));
+    QCOMPARE(countFiles(dir.path()).count(), NUM_SUBDIRECTORIES + 2);
+}
+
+void tst_QNetworkDiskCache::cleanJournal()
+{
+    QTemporaryDir dir(tempDir.path() + "/cleanJournal.XXXXXX");
+    QVERIFY(dir.isValid());
+
+    qint64 cacheSize = 0;
+    QString fileName;
+    {
+        SubQNetworkDiskCache cache;
+        cache.setCacheDirectory(dir.path());
+        QNetworkCacheMetaData m;
+        m.setUrl(QUrl("http://localhost:4/"));
+        QIODevice *d = cache.prepare(m);
+        QVERIFY(d);
+        d->write(QByteArray(1024, 'Z'));
+        cache.insert(d);
+        cacheSize = cache.cacheSize();
+        QDirIterator it(dir.path(), { "*.d" }, QDir::Files, QDirIterator::Subdirectories);
+        QVERIFY(it.hasNext());
+        fileName = it.next();
+        cache.setClearCacheOnDestruction(false);
+    }
+
+    // the journal of a cache that was closed cleanly is trusted as is,
+    // without scanning the data directory
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::Append));
+    QCOMPARE(file.write(QByteArray(1024, 'Z')), qint64(1024));
+    file.close();
+    {
+        SubQNetworkDiskCache cache;
+        cache.setCacheDirectory(dir.path());
+        QCOMPARE(cache.cacheSize(), cacheSize);
+        cache.setClearCacheOnDestruction(false);
+    }
+
+    // as if the application had crashed while the cache was in use
+    const QString dataDir = dir.path() + "/data8/";
+    const QStringList journals = QDir(dataDir).entryList(QDir::Files | QDir::Hidden);
+    QCOMPARE(journals.count(), 1);
+    QFile journal(dataDir + journals.first());
+    QVERIFY(journal.open(QIODevice::ReadWrite));
+    QVERIFY(journal.seek(8));
+    QCOMPARE(journal.write(QByteArray(4, '\0')), qint64(4));
+    journal.close();
+
+    SubQNetworkDiskCache cache;
+    cache.setCacheDirectory(dir.path());
+    QCOMPARE(cache.cacheSize(), cacheSize + 1024);
+}
+
 void tst_QNetworkDiskCache::oldCacheVersionFile_data()
 {
     QTest::addColumn<int>("pass");
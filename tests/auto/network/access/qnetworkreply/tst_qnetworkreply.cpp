@@ -69,6 +69,7 @@
 #include <QtNetwork/qnetworkcookie.h>
 #include <QtNetwork/QNetworkCookieJar>
 #include <QtNetwork/QHttpPart>
+#include <QtNetwork/QHttp1Configuration>
 #include <QtNetwork/QHttpMultiPart>
 #include <QtNetwork/QNetworkProxyQuery>
 #if QT_CONFIG(ssl)
@@ -461,6 +462,9 @@ private Q_SLOTS:
     void closeClientSideConnectionEagerlyQtbug20726();
     void varyingCacheExpiry_data();
     void varyingCacheExpiry();
+    void http1ConnectionsPerHost_data();
+    void http1ConnectionsPerHost();
+    void connectionReusedAttribute();
 
     void dontInsertPartialContentIntoTheCache();
 
@@ -8103,6 +8107,75 @@ void tst_QNetworkReply::varyingCacheExpiry()
     QVERIFY(success);
 }
 
+void tst_QNetworkReply::http1ConnectionsPerHost_data()
+{
+    QTest::addColumn<int>("connectionsPerHost");
+    QTest::addColumn<int>("expectedConnections");
+
+    QTest::newRow("default") << 0 << 6;
+    QTest::newRow("single") << 1 << 1;
+    QTest::newRow("many") << 12 << 12;
+}
+
+void tst_QNetworkReply::http1ConnectionsPerHost()
+{
+    QFETCH(int, connectionsPerHost);
+    QFETCH(int, expectedConnections);
+
+    // The server never replies, so every request keeps its connection busy
+    // and the remaining requests have to be queued:
+    MiniHttpServer server(httpEmpty200Response);
+    server.doClose = false;
+    server.stopTransfer = true;
+
+    QNetworkAccessManager manager;
+    if (connectionsPerHost) {
+        QHttp1Configuration configuration;
+        QVERIFY(configuration.setNumberOfConnectionsPerHost(connectionsPerHost));
+        manager.setHttp1Configuration(u"127.0.0.1"_qs, configuration);
+        QCOMPARE(manager.http1Configuration(u"127.0.0.1"_qs), configuration);
+    }
+    QCOMPARE(manager.http1Configuration(u"127.0.0.1"_qs).numberOfConnectionsPerHost(),
+             unsigned(expectedConnections));
+
+    QUrl url(u"http://127.0.0.1"_qs);
+    url.setPort(server.serverPort());
+    QNetworkRequest request(url);
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, false);
+
+    QList<QNetworkReplyPtr> replies;
+    for (int i = 0; i < 2 * expectedConnections; ++i)
+        replies.append(QNetworkReplyPtr(manager.get(request)));
+
+    QTRY_COMPARE(server.totalConnections, expectedConnections);
+    // No further connections are opened for the queued requests:
+    QTest::qWait(100);
+    QCOMPARE(server.totalConnections, expectedConnections);
+
+    for (const QNetworkReplyPtr &reply : qAsConst(replies))
+        reply->abort();
+}
+
+void tst_QNetworkReply::connectionReusedAttribute()
+{
+    MiniHttpServer server(httpEmpty200Response);
+    server.doClose = false;
+    server.multiple = true;
+
+    QNetworkAccessManager manager;
+    QUrl url(u"http://127.0.0.1"_qs);
+    url.setPort(server.serverPort());
+    QNetworkRequest request(url);
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, false);
+
+    for (bool reused : { false, true, true }) {
+        QNetworkReplyPtr reply(manager.get(request));
+        QCOMPARE(waitForFinish(reply), Success);
+        QCOMPARE(reply->attribute(QNetworkRequest::ConnectionReusedAttribute).toBool(), reused);
+    }
+    QCOMPARE(server.totalConnections, 1);
+}
+
 void tst_QNetworkReply::dontInsertPartialContentIntoTheCache()
 {
     QByteArray reply206 =
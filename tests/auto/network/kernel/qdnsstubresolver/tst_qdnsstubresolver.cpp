@@ -0,0 +1,594 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+#include <QSignalSpy>
+#include <QEventLoop>
+#include <QTimer>
+#include <QSet>
+#include <QUdpSocket>
+#include <QNetworkDatagram>
+#include <QHostInfo>
+
+#include "private/qdnsstubresolver_p.h"
+#include "private/qhostinfo_p.h"
+
+// A name server that answers from a fixed table, counting the queries it gets.
+class StubDnsServer : public QObject
+{
+    Q_OBJECT
+public:
+    enum Behavior {
+        Answer,
+        Ignore,
+        Truncate,
+        WrongQuestion,
+        LowerCaseQuestion,
+        WrongOwner
+    };
+
+    StubDnsServer()
+    {
+        socket.bind(QHostAddress::LocalHost, 0);
+        connect(&socket, &QUdpSocket::readyRead, this, &StubDnsServer::readQueries);
+    }
+
+    bool isListening() const { return socket.state() == QAbstractSocket::BoundState; }
+    quint16 port() const { return socket.localPort(); }
+
+    void addHost(const QByteArray &name, const QList<QHostAddress> &addresses, quint32 ttl = 300)
+    {
+        hosts.insert(name, { addresses, ttl, 0 });
+    }
+    void addFailure(const QByteArray &name, int rcode) { hosts.insert(name, { {}, 0, rcode }); }
+    // answers for name with a CNAME record pointing to target, and target's addresses
+    void addAlias(const QByteArray &name, const QByteArray &target) { aliases.insert(name, target); }
+
+    int queryCount(const QByteArray &name, quint16 type) const
+    {
+        return counts.value(qMakePair(name, type));
+    }
+    int queryCount(const QByteArray &name) const
+    {
+        return queryCount(name, A) + queryCount(name, AAAA);
+    }
+
+    Behavior behavior = Answer;
+    QByteArray lastQuestionName;
+
+    static constexpr quint16 A = 1;
+    static constexpr quint16 AAAA = 28;
+
+private:
+    struct Host
+    {
+        QList<QHostAddress> addresses;
+        quint32 ttl;
+        int rcode;
+    };
+
+    void readQueries()
+    {
+        while (socket.hasPendingDatagrams()) {
+            const QNetworkDatagram query = socket.receiveDatagram();
+            const QByteArray response = reply(query.data());
+            if (!response.isEmpty())
+                socket.writeDatagram(query.makeReply(response));
+        }
+    }
+
+    QByteArray reply(const QByteArray &query)
+    {
+        const auto append16 = [](QByteArray &data, quint16 value) {
+            data.append(char(value >> 8));
+            data.append(char(value & 0xff));
+        };
+
+        if (query.size() < 12)
+            return QByteArray();
+
+        QByteArray name;
+        int pos = 12;
+        while (pos < query.size() && query.at(pos)) {
+            const int length = uchar(query.at(pos));
+            if (!name.isEmpty())
+                name += '.';
+            name += query.mid(pos + 1, length);
+            pos += length + 1;
+        }
+        pos += 1;
+        if (pos + 4 > query.size())
+            return QByteArray();
+        const quint16 type = quint16((uchar(query.at(pos)) << 8) | uchar(query.at(pos + 1)));
+        QByteArray question = query.mid(12, pos + 4 - 12);
+        lastQuestionName = name;
+
+        name = name.toLower();
+        ++counts[qMakePair(name, type)];
+        if (behavior == Ignore)
+            return QByteArray();
+
+        QByteArray answers;
+        int answerCount = 0;
+        QByteArray owner = "\xc0\x0c"; // pointer to the name in the question
+        if (behavior == WrongOwner)
+            owner = encodeName("attacker.example.test");
+        if (aliases.contains(name)) {
+            const QByteArray target = aliases.value(name);
+            const QByteArray rdata = encodeName(target);
+            answers += owner;
+            append16(answers, 5); // CNAME
+            append16(answers, 1);
+            append16(answers, 0);
+            append16(answers, 60);
+            append16(answers, quint16(rdata.size()));
+            answers += rdata;
+            ++answerCount;
+            name = target;
+            owner = rdata;
+        }
+
+        const auto it = hosts.constFind(name);
+        const int rcode = it == hosts.constEnd() ? 3 : it->rcode;
+
+        if (rcode == 0) {
+            for (const QHostAddress &address : it->addresses) {
+                QByteArray rdata;
+                if (type == A && address.protocol() == QAbstractSocket::IPv4Protocol) {
+                    const quint32 ip4 = address.toIPv4Address();
+                    append16(rdata, quint16(ip4 >> 16));
+                    append16(rdata, quint16(ip4 & 0xffff));
+                } else if (type == AAAA && address.protocol() == QAbstractSocket::IPv6Protocol) {
+                    const Q_IPV6ADDR ip6 = address.toIPv6Address();
+                    rdata = QByteArray(reinterpret_cast<const char *>(ip6.c), 16);
+                } else {
+                    continue;
+                }
+                answers += owner;
+                append16(answers, type);
+                append16(answers, 1);
+                append16(answers, quint16(it->ttl >> 16));
+                append16(answers, quint16(it->ttl & 0xffff));
+                append16(answers, quint16(rdata.size()));
+                answers += rdata;
+                ++answerCount;
+            }
+        }
+
+        if (behavior == WrongQuestion)
+            question[1] = question.at(1) == 'x' ? 'y' : 'x';
+        else if (behavior == LowerCaseQuestion)
+            question = question.toLower();
+
+        QByteArray response = query.left(2);
+        response += char(0x81 | (behavior == Truncate ? 0x02 : 0)); // QR, RD
+        response += char(0x80 | rcode); // RA
+        append16(response, 1);
+        append16(response, quint16(answerCount));
+        append16(response, 0);
+        append16(response, 0);
+        response += question;
+        response += answers;
+        return response;
+    }
+
+    static QByteArray encodeName(const QByteArray &name)
+    {
+        QByteArray encoded;
+        for (const QByteArray &label : name.split('.')) {
+            encoded += char(label.size());
+            encoded += label;
+        }
+        encoded += '\0';
+        return encoded;
+    }
+
+    QUdpSocket socket;
+    QHash<QByteArray, QByteArray> aliases;
+    QHash<QByteArray, Host> hosts;
+    QHash<QPair<QByteArray, quint16>, int> counts;
+};
+
+class tst_QDnsStubResolver : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void canResolve_data();
+    void canResolve();
+    void resolve();
+    void notFound();
+    void noAddresses();
+    void coalescing();
+    void pipelining();
+    void serverFailure();
+    void timeout();
+    void truncated();
+    void mismatchedReply();
+    void caseRandomization();
+    void canonicalName();
+    void foreignOwner();
+    void timeToLiveCap();
+
+#ifdef QT_BUILD_INTERNAL
+    void hostInfoCachesResults();
+    void hostInfoNegativeCache();
+    void hostInfoZeroTimeToLive();
+    void hostInfoCoalescing();
+#endif
+
+private:
+    QHostInfo lookupHost(const QString &name);
+
+    StubDnsServer *server = nullptr;
+};
+
+void tst_QDnsStubResolver::initTestCase()
+{
+    qRegisterMetaType<QHostInfo>();
+}
+
+void tst_QDnsStubResolver::init()
+{
+    server = new StubDnsServer;
+    QVERIFY(server->isListening());
+}
+
+void tst_QDnsStubResolver::cleanup()
+{
+#ifdef QT_BUILD_INTERNAL
+    qt_qhostinfo_use_dns_server(QHostAddress(), 0);
+    qt_qhostinfo_clear_cache();
+#endif
+    delete server;
+    server = nullptr;
+}
+
+QHostInfo tst_QDnsStubResolver::lookupHost(const QString &name)
+{
+    QHostInfo result;
+    result.setError(QHostInfo::UnknownError);
+    QEventLoop loop;
+    QHostInfo::lookupHost(name, &loop, [&](const QHostInfo &info) {
+        result = info;
+        loop.quit();
+    });
+    QTimer::singleShot(5000, &loop, &QEventLoop::quit);
+    loop.exec();
+    return result;
+}
+
+void tst_QDnsStubResolver::canResolve_data()
+{
+    QTest::addColumn<QString>("name");
+    QTest::addColumn<bool>("result");
+
+    QTest::newRow("empty") << QString() << false;
+    QTest::newRow("fqdn") << "www.example.test" << true;
+    QTest::newRow("trailing-dot") << "www.example.test." << true;
+    QTest::newRow("idn") << QString::fromUtf8("b\xc3\xbc\x63her.example.test") << true;
+    QTest::newRow("single-label") << "intranet" << false;
+    QTest::newRow("localhost") << "localhost" << false;
+    QTest::newRow("sub.localhost") << "app.localhost" << false;
+    QTest::newRow("mdns") << "printer.local" << false;
+    QTest::newRow("ipv4") << "192.0.2.1" << false;
+    QTest::newRow("ipv6") << "2001:db8::1" << false;
+    QTest::newRow("empty-label") << "www..example.test" << false;
+    QTest::newRow("long-label") << QString(64, u'a') + ".test" << false;
+    QTest::newRow("long-name") << (QString(60, u'a') + u'.').repeated(5) + "test" << false;
+}
+
+void tst_QDnsStubResolver::canResolve()
+{
+    QFETCH(QString, name);
+    QFETCH(bool, result);
+    QCOMPARE(QDnsStubResolver::canResolve(name), result);
+}
+
+void tst_QDnsStubResolver::resolve()
+{
+    server->addHost("www.example.test", { QHostAddress("2001:db8::1"), QHostAddress("192.0.2.1"),
+                                          QHostAddress("192.0.2.2") }, 120);
+
+    QDnsStubResolver resolver({ QHostAddress(QHostAddress::LocalHost) }, server->port());
+    QSignalSpy resolvedSpy(&resolver, &QDnsStubResolver::resolved);
+    QSignalSpy failedSpy(&resolver, &QDnsStubResolver::resolutionFailed);
+    resolver.resolve("www.example.test");
+
+    QTRY_COMPARE(resolvedSpy.count(), 1);
+    QCOMPARE(failedSpy.count(), 0);
+    const QList<QVariant> arguments = resolvedSpy.takeFirst();
+    QCOMPARE(arguments.at(0).toString(), QString("www.example.test"));
+    const QHostInfo info = arguments.at(1).value<QHostInfo>();
+    QCOMPARE(info.error(), QHostInfo::NoError);
+    QCOMPARE(info.hostName(), QString("www.example.test"));
+    const QList<QHostAddress> expected = { QHostAddress("192.0.2.1"), QHostAddress("192.0.2.2"),
+                                           QHostAddress("2001:db8::1") };
+    QCOMPARE(info.addresses(), expected);
+    QCOMPARE(arguments.at(2).toInt(), 120);
+
+    QCOMPARE(server->queryCount("www.example.test", StubDnsServer::A), 1);
+    QCOMPARE(server->queryCount("www.example.test", StubDnsServer::AAAA), 1);
+}
+
+void tst_QDnsStubResolver::notFound()
+{
+    QDnsStubResolver resolver({ QHostAddress(QHostAddress::LocalHost) }, server->port());
+    QSignalSpy resolvedSpy(&resolver, &QDnsStubResolver::resolved);
+    resolver.resolve("missing.example.test");
+
+    QTRY_COMPARE(resolvedSpy.count(), 1);
+    const QList<QVariant> arguments = resolvedSpy.takeFirst();
+    QCOMPARE(arguments.at(1).value<QHostInfo>().error(), QHostInfo::HostNotFound);
+    QVERIFY(arguments.at(1).value<QHostInfo>().addresses().isEmpty());
+    QCOMPARE(arguments.at(2).toInt(), -1);
+}
+
+void tst_QDnsStubResolver::noAddresses()
+{
+    server->addHost("empty.example.test", {});
+
+    QDnsStubResolver resolver({ QHostAddress(QHostAddress::LocalHost) }, server->port());
+    QSignalSpy resolvedSpy(&resolver, &QDnsStubResolver::resolved);
+    resolver.resolve("empty.example.test");
+
+    QTRY_COMPARE(resolvedSpy.count(), 1);
+    QCOMPARE(resolvedSpy.at(0).at(1).value<QHostInfo>().error(), QHostInfo::HostNotFound);
+}
+
+void tst_QDnsStubResolver::coalescing()
+{
+    server->addHost("busy.example.test", { QHostAddress("192.0.2.3") });
+
+    QDnsStubResolver resolver({ QHostAddress(QHostAddress::LocalHost) }, server->port());
+    QSignalSpy resolvedSpy(&resolver, &QDnsStubResolver::resolved);
+    for (int i = 0; i < 10; ++i)
+        resolver.resolve("busy.example.test");
+
+    QTRY_COMPARE(resolvedSpy.count(), 1);
+    QCOMPARE(server->queryCount("busy.example.test", StubDnsServer::A), 1);
+    QCOMPARE(server->queryCount("busy.example.test", StubDnsServer::AAAA), 1);
+}
+
+void tst_QDnsStubResolver::pipelining()
+{
+    const int count = 100;
+    for (int i = 0; i < count; ++i) {
+        server->addHost("host" + QByteArray::number(i) + ".example.test",
+                        { QHostAddress(QString("192.0.2.%1").arg(i + 1)) });
+    }
+
+    QDnsStubResolver resolver({ QHostAddress(QHostAddress::LocalHost) }, server->port());
+    QSignalSpy resolvedSpy(&resolver, &QDnsStubResolver::resolved);
+    for (int i = 0; i < count; ++i)
+        resolver.resolve(QString("host%1.example.test").arg(i));
+
+    QTRY_COMPARE(resolvedSpy.count(), count);
+    for (const QList<QVariant> &arguments : qAsConst(resolvedSpy)) {
+        const QString name = arguments.at(0).toString();
+        const int i = name.mid(4, name.indexOf(u'.') - 4).toInt();
+        const QHostInfo info = arguments.at(1).value<QHostInfo>();
+        QCOMPARE(info.addresses(), QList<QHostAddress>{ QHostAddress(QString("192.0.2.%1").arg(i + 1)) });
+        QCOMPARE(server->queryCount(name.toLatin1()), 2);
+    }
+}
+
+void tst_QDnsStubResolver::serverFailure()
+{
+    server->addFailure("broken.example.test", 2); // SERVFAIL
+
+    QDnsStubResolver resolver({ QHostAddress(QHostAddress::LocalHost) }, server->port());
+    QSignalSpy resolvedSpy(&resolver, &QDnsStubResolver::resolved);
+    QSignalSpy failedSpy(&resolver, &QDnsStubResolver::resolutionFailed);
+    resolver.resolve("broken.example.test");
+
+    QTRY_COMPARE(failedSpy.count(), 1);
+    QCOMPARE(resolvedSpy.count(), 0);
+    QCOMPARE(server->queryCount("broken.example.test", StubDnsServer::A), resolver.maximumAttempts());
+}
+
+void tst_QDnsStubResolver::timeout()
+{
+    server->behavior = StubDnsServer::Ignore;
+
+    QDnsStubResolver resolver({ QHostAddress(QHostAddress::LocalHost) }, server->port());
+    resolver.setRetransmitInterval(50);
+    QSignalSpy failedSpy(&resolver, &QDnsStubResolver::resolutionFailed);
+    resolver.resolve("silent.example.test");
+
+    QTRY_COMPARE(failedSpy.count(), 1);
+    QCOMPARE(server->queryCount("silent.example.test", StubDnsServer::A), resolver.maximumAttempts());
+    QCOMPARE(server->queryCount("silent.example.test", StubDnsServer::AAAA), resolver.maximumAttempts());
+}
+
+void tst_QDnsStubResolver::truncated()
+{
+    server->behavior = StubDnsServer::Truncate;
+    server->addHost("large.example.test", { QHostAddress("192.0.2.4") });
+
+    QDnsStubResolver resolver({ QHostAddress(QHostAddress::LocalHost) }, server->port());
+    QSignalSpy resolvedSpy(&resolver, &QDnsStubResolver::resolved);
+    QSignalSpy failedSpy(&resolver, &QDnsStubResolver::resolutionFailed);
+    resolver.resolve("large.example.test");
+
+    QTRY_COMPARE(failedSpy.count(), 1);
+    QCOMPARE(resolvedSpy.count(), 0);
+    QCOMPARE(server->queryCount("large.example.test", StubDnsServer::A), 1);
+}
+
+void tst_QDnsStubResolver::mismatchedReply()
+{
+    server->behavior = StubDnsServer::WrongQuestion;
+    server->addHost("spoofed.example.test", { QHostAddress("192.0.2.5") });
+
+    QDnsStubResolver resolver({ QHostAddress(QHostAddress::LocalHost) }, server->port());
+    resolver.setRetransmitInterval(50);
+    QSignalSpy resolvedSpy(&resolver, &QDnsStubResolver::resolved);
+    QSignalSpy failedSpy(&resolver, &QDnsStubResolver::resolutionFailed);
+    resolver.resolve("spoofed.example.test");
+
+    // the replies are dropped, so the queries time out
+    QTRY_COMPARE(failedSpy.count(), 1);
+    QCOMPARE(resolvedSpy.count(), 0);
+}
+
+void tst_QDnsStubResolver::caseRandomization()
+{
+    const QByteArray name = "a.quite.long.name.with.many.letters.example.test";
+    server->addHost(name, { QHostAddress("192.0.2.6") });
+
+    QDnsStubResolver resolver({ QHostAddress(QHostAddress::LocalHost) }, server->port());
+    QSignalSpy resolvedSpy(&resolver, &QDnsStubResolver::resolved);
+    QSet<QByteArray> questions;
+    for (int i = 0; i < 4; ++i) {
+        resolver.resolve(QString::fromLatin1(name));
+        QTRY_COMPARE(resolvedSpy.count(), i + 1);
+        QCOMPARE(server->lastQuestionName.toLower(), name);
+        questions.insert(server->lastQuestionName);
+    }
+    // with 40 letters each, the chance of all questions matching is nil
+    QVERIFY(questions.size() > 1);
+
+    // a reply that does not preserve the case is dropped
+    server->behavior = StubDnsServer::LowerCaseQuestion;
+    resolver.setRetransmitInterval(50);
+    QSignalSpy failedSpy(&resolver, &QDnsStubResolver::resolutionFailed);
+    resolver.resolve(QString::fromLatin1(name));
+    QTRY_COMPARE(failedSpy.count(), 1);
+}
+
+void tst_QDnsStubResolver::canonicalName()
+{
+    server->addAlias("alias.example.test", "target.example.test");
+    server->addHost("target.example.test", { QHostAddress("192.0.2.7") }, 120);
+
+    QDnsStubResolver resolver({ QHostAddress(QHostAddress::LocalHost) }, server->port());
+    QSignalSpy resolvedSpy(&resolver, &QDnsStubResolver::resolved);
+    resolver.resolve("alias.example.test");
+
+    QTRY_COMPARE(resolvedSpy.count(), 1);
+    const QList<QVariant> arguments = resolvedSpy.takeFirst();
+    const QHostInfo info = arguments.at(1).value<QHostInfo>();
+    QCOMPARE(info.error(), QHostInfo::NoError);
+    QCOMPARE(info.addresses(), QList<QHostAddress>{ QHostAddress("192.0.2.7") });
+    // the CNAME record has the shorter TTL
+    QCOMPARE(arguments.at(2).toInt(), 60);
+}
+
+void tst_QDnsStubResolver::foreignOwner()
+{
+    server->behavior = StubDnsServer::WrongOwner;
+    server->addHost("victim.example.test", { QHostAddress("192.0.2.8") });
+
+    QDnsStubResolver resolver({ QHostAddress(QHostAddress::LocalHost) }, server->port());
+    QSignalSpy resolvedSpy(&resolver, &QDnsStubResolver::resolved);
+    resolver.resolve("victim.example.test");
+
+    // records for other names are ignored, so there are no addresses
+    QTRY_COMPARE(resolvedSpy.count(), 1);
+    const QHostInfo info = resolvedSpy.at(0).at(1).value<QHostInfo>();
+    QCOMPARE(info.error(), QHostInfo::HostNotFound);
+    QVERIFY(info.addresses().isEmpty());
+}
+
+void tst_QDnsStubResolver::timeToLiveCap()
+{
+    server->addHost("stable.example.test", { QHostAddress("192.0.2.9") }, 86400);
+
+    QDnsStubResolver resolver({ QHostAddress(QHostAddress::LocalHost) }, server->port());
+    QSignalSpy resolvedSpy(&resolver, &QDnsStubResolver::resolved);
+    resolver.resolve("stable.example.test");
+
+    QTRY_COMPARE(resolvedSpy.count(), 1);
+    QCOMPARE(resolvedSpy.at(0).at(2).toInt(), 300);
+}
+
+#ifdef QT_BUILD_INTERNAL
+void tst_QDnsStubResolver::hostInfoCachesResults()
+{
+    server->addHost("cached.example.test", { QHostAddress("192.0.2.10") }, 300);
+    qt_qhostinfo_use_dns_server(QHostAddress::LocalHost, server->port());
+
+    QHostInfo info = lookupHost("cached.example.test");
+    QCOMPARE(info.error(), QHostInfo::NoError);
+    QCOMPARE(info.addresses(), QList<QHostAddress>{ QHostAddress("192.0.2.10") });
+    QCOMPARE(server->queryCount("cached.example.test"), 2);
+
+    info = lookupHost("cached.example.test");
+    QCOMPARE(info.error(), QHostInfo::NoError);
+    QCOMPARE(info.addresses(), QList<QHostAddress>{ QHostAddress("192.0.2.10") });
+    QCOMPARE(server->queryCount("cached.example.test"), 2);
+}
+
+void tst_QDnsStubResolver::hostInfoNegativeCache()
+{
+    qt_qhostinfo_use_dns_server(QHostAddress::LocalHost, server->port());
+
+    QHostInfo info = lookupHost("missing.example.test");
+    QCOMPARE(info.error(), QHostInfo::HostNotFound);
+    QCOMPARE(server->queryCount("missing.example.test"), 2);
+
+    info = lookupHost("missing.example.test");
+    QCOMPARE(info.error(), QHostInfo::HostNotFound);
+    QCOMPARE(server->queryCount("missing.example.test"), 2);
+}
+
+void tst_QDnsStubResolver::hostInfoZeroTimeToLive()
+{
+    server->addHost("volatile.example.test", { QHostAddress("192.0.2.11") }, 0);
+    qt_qhostinfo_use_dns_server(QHostAddress::LocalHost, server->port());
+
+    QCOMPARE(lookupHost("volatile.example.test").error(), QHostInfo::NoError);
+    QCOMPARE(lookupHost("volatile.example.test").error(), QHostInfo::NoError);
+    QCOMPARE(server->queryCount("volatile.example.test"), 4);
+}
+
+void tst_QDnsStubResolver::hostInfoCoalescing()
+{
+    server->addHost("popular.example.test", { QHostAddress("192.0.2.12") });
+    qt_qhostinfo_use_dns_server(QHostAddress::LocalHost, server->port());
+
+    int results = 0;
+    for (int i = 0; i < 10; ++i) {
+        QHostInfo::lookupHost("popular.example.test", this, [&](const QHostInfo &info) {
+            QCOMPARE(info.error(), QHostInfo::NoError);
+            ++results;
+        });
+    }
+
+    QTRY_COMPARE(results, 10);
+    QCOMPARE(server->queryCount("popular.example.test"), 2);
+}
+#endif
+
+QTEST_MAIN(tst_QDnsStubResolver)
+#include "tst_qdnsstubresolver.moc"
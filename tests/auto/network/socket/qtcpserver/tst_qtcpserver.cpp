@@ -41,6 +41,8 @@
 #include <QTest>
 #include <QSignalSpy>
 #include <QTimer>
+#include <QThread>
+#include <QScopeGuard>
 
 #ifndef Q_OS_WIN
 #include <unistd.h>
@@ -117,6 +119,8 @@ private slots:
 
     void pauseAccepting();
 
+    void portSharing();
+
 private:
     bool shouldSkipIpv6TestsForBrokenGetsockopt();
 #ifdef SHOULD_CHECK_SYSCALL_SUPPORT
@@ -1081,5 +1085,89 @@ void tst_QTcpServer::pauseAccepting()
     QCOMPARE(spy.count(), 6);
 }
 
+void tst_QTcpServer::portSharing()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QTcpServer server;
+    QVERIFY(!server.isPortSharingEnabled());
+    server.setPortSharingEnabled(true);
+    QVERIFY(server.isPortSharingEnabled());
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    const quint16 port = server.serverPort();
+
+    // A server that does not share its port must not be able to join.
+    QTcpServer exclusiveServer;
+    QVERIFY(!exclusiveServer.listen(QHostAddress::LocalHost, port));
+    QCOMPARE(exclusiveServer.serverError(), QAbstractSocket::AddressInUseError);
+
+#ifndef Q_OS_LINUX
+    QTcpServer sharingServer;
+    sharingServer.setPortSharingEnabled(true);
+    QVERIFY(!sharingServer.listen(QHostAddress::LocalHost, port));
+    QSKIP("Port sharing is only supported on Linux");
+#else
+    // One server in the main thread and one in each worker thread; every
+    // server accepts the connections the kernel assigns to it.
+    constexpr int ThreadCount = 3;
+    constexpr int ConnectionCount = 64;
+    QAtomicInt accepted[ThreadCount + 1];
+    auto acceptAll = [&accepted](QTcpServer *server, int index) {
+        connect(server, &QTcpServer::newConnection, server, [server, &accepted, index] {
+            while (server->hasPendingConnections()) {
+                delete server->nextPendingConnection();
+                accepted[index].ref();
+            }
+        });
+    };
+    acceptAll(&server, 0);
+
+    QThread threads[ThreadCount];
+    for (int i = 0; i < ThreadCount; ++i) {
+        QTcpServer *threadServer = new QTcpServer;
+        threadServer->setPortSharingEnabled(true);
+        acceptAll(threadServer, i + 1);
+        threadServer->moveToThread(&threads[i]);
+        connect(&threads[i], &QThread::finished, threadServer, &QObject::deleteLater);
+        threads[i].start();
+
+        bool listening = false;
+        QMetaObject::invokeMethod(threadServer, [threadServer, port, &listening] {
+            listening = threadServer->listen(QHostAddress::LocalHost, port);
+        }, Qt::BlockingQueuedConnection);
+        QVERIFY(listening);
+    }
+    auto stopThreads = qScopeGuard([&threads] {
+        for (QThread &thread : threads) {
+            thread.quit();
+            thread.wait();
+        }
+    });
+
+    QTcpSocket sockets[ConnectionCount];
+    for (QTcpSocket &socket : sockets) {
+        socket.connectToHost(QHostAddress::LocalHost, port);
+        QVERIFY(socket.waitForConnected(5000));
+    }
+
+    auto totalAccepted = [&accepted] {
+        int total = 0;
+        for (const QAtomicInt &count : accepted)
+            total += count.loadRelaxed();
+        return total;
+    };
+    QTRY_COMPARE(totalAccepted(), ConnectionCount);
+
+    // With this many connections, the kernel picking the same listener for
+    // all of them would mean the load is not being balanced.
+    int serversUsed = 0;
+    for (const QAtomicInt &count : accepted)
+        serversUsed += count.loadRelaxed() > 0 ? 1 : 0;
+    QVERIFY2(serversUsed > 1, "All connections were accepted by the same server");
+#endif
+}
+
 QTEST_MAIN(tst_QTcpServer)
 #include "tst_qtcpserver.moc"
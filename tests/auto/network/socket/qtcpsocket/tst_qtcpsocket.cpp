@@ -62,6 +62,7 @@
 #include <QStringList>
 #include <QTcpServer>
 #include <QTcpSocket>
+#include <QTemporaryFile>
 #ifndef QT_NO_SSL
 #include <QSslSocket>
 #endif
@@ -206,6 +207,9 @@ private slots:
     void socketDiscardDataInWriteMode();
     void writeOnReadBufferOverflow();
     void readNotificationsAfterBind();
+    void sendFile_data();
+    void sendFile();
+    void sendFileInvalid();
 
 protected slots:
     void nonBlockingIMAP_hostFound();
@@ -3240,5 +3244,96 @@ void tst_QTcpSocket::readNotificationsAfterBind()
     QCOMPARE(spyReadyRead.count(), 0);
 }
 
+void tst_QTcpSocket::sendFile_data()
+{
+    QTest::addColumn<qint64>("offset");
+    QTest::addColumn<qint64>("length");
+
+    QTest::newRow("whole") << qint64(0) << qint64(-1);
+    QTest::newRow("range") << qint64(1000) << qint64(300000);
+    QTest::newRow("tail") << qint64(700000) << qint64(-1);
+    QTest::newRow("empty") << qint64(1000) << qint64(0);
+}
+
+void tst_QTcpSocket::sendFile()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+    QFETCH(qint64, offset);
+    QFETCH(qint64, length);
+
+    QByteArray contents(1024 * 1024, Qt::Uninitialized);
+    for (qsizetype i = 0; i < contents.size(); ++i)
+        contents[i] = char(i * 7 + i / 251);
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write(contents), qint64(contents.size()));
+    QVERIFY(file.flush());
+    QVERIFY(file.seek(42));
+
+    QTcpServer tcpServer;
+    QVERIFY(tcpServer.listen(QHostAddress::LocalHost));
+    QScopedPointer<QTcpSocket> socket(newSocket());
+    socket->connectToHost(tcpServer.serverAddress(), tcpServer.serverPort());
+    QVERIFY(socket->waitForConnected(5000));
+    QVERIFY(tcpServer.waitForNewConnection(5000));
+    QScopedPointer<QTcpSocket> peer(tcpServer.nextPendingConnection());
+    QVERIFY(peer);
+
+    QByteArray received;
+    connect(peer.data(), &QIODevice::readyRead, [&] { received += peer->readAll(); });
+    qint64 bytesWritten = 0;
+    connect(socket.data(), &QIODevice::bytesWritten, [&](qint64 bytes) { bytesWritten += bytes; });
+
+    // Data written before and after the file must keep its place around it.
+    QCOMPARE(socket->write("head"), qint64(4));
+    QVERIFY(socket->sendFile(&file, offset, length));
+    QCOMPARE(socket->write("tail"), qint64(4));
+    QCOMPARE(file.pos(), qint64(42));
+
+    const QByteArray expected = "head" + contents.mid(offset, length) + "tail";
+    QTRY_COMPARE(received.size(), expected.size());
+    QCOMPARE(received, expected);
+    QTRY_COMPARE(socket->bytesToWrite(), qint64(0));
+    QCOMPARE(bytesWritten, qint64(expected.size()));
+}
+
+void tst_QTcpSocket::sendFileInvalid()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write("0123456789"), qint64(10));
+    QVERIFY(file.flush());
+
+    QScopedPointer<QTcpSocket> socket(newSocket());
+    QTest::ignoreMessage(QtWarningMsg,
+                         "QAbstractSocket::sendFile() is only allowed on a connected TCP socket");
+    QVERIFY(!socket->sendFile(&file));
+
+    QTcpServer tcpServer;
+    QVERIFY(tcpServer.listen(QHostAddress::LocalHost));
+    socket->connectToHost(tcpServer.serverAddress(), tcpServer.serverPort());
+    QVERIFY(socket->waitForConnected(5000));
+
+    const char rangeWarning[] = "QAbstractSocket::sendFile() called with a range outside of the file";
+    QTest::ignoreMessage(QtWarningMsg, rangeWarning);
+    QVERIFY(!socket->sendFile(&file, 11));
+    QTest::ignoreMessage(QtWarningMsg, rangeWarning);
+    QVERIFY(!socket->sendFile(&file, 4, 7));
+    QTest::ignoreMessage(QtWarningMsg, rangeWarning);
+    QVERIFY(!socket->sendFile(&file, -1));
+
+    file.close();
+    QTest::ignoreMessage(QtWarningMsg,
+                         "QAbstractSocket::sendFile() requires a seekable file that is open for reading");
+    QVERIFY(!socket->sendFile(&file));
+    QCOMPARE(socket->bytesToWrite(), qint64(0));
+}
+
 QTEST_MAIN(tst_QTcpSocket)
 #include "tst_qtcpsocket.moc"
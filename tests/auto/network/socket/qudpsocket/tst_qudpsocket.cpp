@@ -106,6 +106,9 @@ private slots:
     void outOfProcessConnectedClientServerTest();
     void outOfProcessUnconnectedClientServerTest();
     void zeroLengthDatagram();
+    void batchedDatagrams_data();
+    void batchedDatagrams();
+    void receiveDatagramsLimits();
     void multicastTtlOption_data();
     void multicastTtlOption();
     void multicastLoopbackOption_data();
@@ -1259,6 +1262,103 @@ void tst_QUdpSocket::zeroLengthDatagram()
     QCOMPARE(receiver.readDatagram(&buf, 1), qint64(0));
 }
 
+void tst_QUdpSocket::batchedDatagrams_data()
+{
+    QTest::addColumn<QHostAddress>("address");
+    QTest::addColumn<qint64>("maxSize");
+
+    QTest::newRow("ipv4") << QHostAddress(QHostAddress::LocalHost) << qint64(-1);
+    QTest::newRow("ipv4-maxSize") << QHostAddress(QHostAddress::LocalHost) << qint64(200);
+    if (QtNetworkSettings::hasIPv6())
+        QTest::newRow("ipv6") << QHostAddress(QHostAddress::LocalHostIPv6) << qint64(-1);
+}
+
+void tst_QUdpSocket::batchedDatagrams()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+    QFETCH(QHostAddress, address);
+    QFETCH(qint64, maxSize);
+
+    QUdpSocket receiver;
+    QVERIFY2(receiver.bind(address, 0), QtNetworkSettings::msgSocketError(receiver).constData());
+    QVERIFY(receiver.receiveDatagrams(10).isEmpty());
+
+    const int count = 100;
+    QList<QNetworkDatagram> datagrams;
+    for (int i = 0; i < count; ++i)
+        datagrams.append(QNetworkDatagram(QByteArray(i * 2, char('a' + i % 26)), address, receiver.localPort()));
+
+    QUdpSocket sender;
+    QSignalSpy bytesWrittenSpy(&sender, &QUdpSocket::bytesWritten);
+    qsizetype written = 0;
+    while (written < count) {
+        const qsizetype sent = sender.writeDatagrams(datagrams.mid(written));
+        QVERIFY2(sent >= 0, QtNetworkSettings::msgSocketError(sender).constData());
+        written += sent;
+    }
+    QVERIFY(!bytesWrittenSpy.isEmpty());
+    qint64 totalBytes = 0;
+    for (const auto &args : std::as_const(bytesWrittenSpy))
+        totalBytes += args.at(0).toLongLong();
+    QCOMPARE(totalBytes, qint64((count - 1) * count));
+
+    QList<QNetworkDatagram> received;
+    while (received.size() < count) {
+        if (!receiver.hasPendingDatagrams())
+            QVERIFY2(receiver.waitForReadyRead(5000), QtNetworkSettings::msgSocketError(receiver).constData());
+        received += receiver.receiveDatagrams(count, maxSize);
+    }
+    QCOMPARE(received.size(), count);
+    for (int i = 0; i < count; ++i) {
+        const QNetworkDatagram &dg = received.at(i);
+        QVERIFY(dg.isValid());
+        QCOMPARE(dg.data(), datagrams.at(i).data());
+        QCOMPARE(dg.senderPort(), int(sender.localPort()));
+        QCOMPARE(dg.destinationPort(), int(receiver.localPort()));
+        QCOMPARE(dg.destinationAddress(), address);
+    }
+    QVERIFY(!receiver.hasPendingDatagrams());
+}
+
+void tst_QUdpSocket::receiveDatagramsLimits()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QUdpSocket receiver;
+    QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+    QUdpSocket sender;
+    QList<QNetworkDatagram> datagrams;
+    for (int i = 0; i < 5; ++i)
+        datagrams.append(QNetworkDatagram(QByteArray(100, char('0' + i)), QHostAddress::LocalHost, receiver.localPort()));
+    QCOMPARE(sender.writeDatagrams(datagrams), qsizetype(5));
+    QCOMPARE(sender.writeDatagrams({}), qsizetype(0));
+
+    QVERIFY(receiver.waitForReadyRead(5000));
+    QVERIFY(receiver.receiveDatagrams(0).isEmpty());
+
+    // loopback datagrams are queued by the time the write returns;
+    // maxCount limits the number of datagrams, maxSize truncates them
+    QList<QNetworkDatagram> received = receiver.receiveDatagrams(2, 10);
+    QCOMPARE(received.size(), 2);
+    QCOMPARE(received.at(0).data(), QByteArray(10, '0'));
+    QCOMPARE(received.at(1).data(), QByteArray(10, '1'));
+
+    // maxSize 0 discards the contents
+    received = receiver.receiveDatagrams(1, 0);
+    QCOMPARE(received.size(), 1);
+    QVERIFY(received.at(0).data().isEmpty());
+    QCOMPARE(received.at(0).senderPort(), int(sender.localPort()));
+
+    received = receiver.receiveDatagrams(10);
+    QCOMPARE(received.size(), 2);
+    QCOMPARE(received.at(0).data(), QByteArray(100, '3'));
+    QCOMPARE(received.at(1).data(), QByteArray(100, '4'));
+}
+
 void tst_QUdpSocket::multicastTtlOption_data()
 {
     QTest::addColumn<QHostAddress>("bindAddress");
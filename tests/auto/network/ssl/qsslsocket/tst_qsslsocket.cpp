@@ -65,6 +65,7 @@
 
 #include "private/qsslsocket_p.h"
 #include "private/qsslconfiguration_p.h"
+#include "private/qtlssessioncache_p.h"
 
 Q_DECLARE_METATYPE(QSslSocket::SslMode)
 typedef QList<QSslError::SslError> SslErrorList;
@@ -261,6 +262,7 @@ private slots:
     void selfSignedCertificates();
     void pskHandshake_data();
     void pskHandshake();
+    void sessionCache();
 #endif // openssl
 
     void setEmptyDefaultConfiguration(); // this test should be last
@@ -5055,6 +5057,101 @@ void tst_QSslSocket::pskHandshake()
     }
 }
 
+// Server whose sockets share one TLS context, so that they can resume the
+// sessions negotiated by each other.
+class SessionResumingServer : public QTcpServer
+{
+    Q_OBJECT
+protected:
+    void incomingConnection(qintptr socketDescriptor) override
+    {
+        QSslSocket *socket = new QSslSocket(this);
+        // OpenSSL does not resume sessions on a server that asks for a
+        // client certificate without setting a session id context
+        socket->setPeerVerifyMode(QSslSocket::VerifyNone);
+        socket->setLocalCertificate(tst_QSslSocket::testDataDir + "certs/fluke.cert");
+        socket->setPrivateKey(tst_QSslSocket::testDataDir + "certs/fluke.key");
+        if (context)
+            QSslSocketPrivate::checkSettingSslContext(socket, context);
+        connect(socket, &QSslSocket::encrypted, this, [this, socket]() {
+            if (!context)
+                context = QSslSocketPrivate::sslContext(socket);
+            socket->write("ready");
+        });
+        QVERIFY(socket->setSocketDescriptor(socketDescriptor, QAbstractSocket::ConnectedState));
+        socket->startServerEncryption();
+    }
+
+private:
+    std::shared_ptr<QSslContext> context;
+};
+
+void tst_QSslSocket::sessionCache()
+{
+    if (!isTestingOpenSsl)
+        QSKIP("The active TLS backend does not support this test");
+
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QTlsSessionCache *cache = QTlsSessionCache::instance();
+    QVERIFY(cache);
+    cache->clear();
+    const auto cleanup = qScopeGuard([cache] { cache->clear(); });
+
+    SessionResumingServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+
+    // Returns whether the connection resumed a cached session
+    const auto connectAndCheckResumed = [&server](QSslConfiguration configuration,
+                                                  bool ignoreErrors = false) {
+        QSslSocket socket;
+        socket.setSslConfiguration(configuration);
+        if (ignoreErrors) {
+            connect(&socket, &QSslSocket::sslErrors, &socket,
+                    [&socket]() { socket.ignoreSslErrors(); });
+        }
+        socket.connectToHostEncrypted(QStringLiteral("127.0.0.1"), server.serverPort());
+        // the TLS 1.3 session ticket arrives after the handshake, before the data
+        QTest::qWaitFor([&socket]() { return socket.bytesAvailable() > 0; }, 5000);
+        if (!socket.isEncrypted())
+            qWarning() << "Handshake failed" << socket.errorString();
+        return QSslConfigurationPrivate::peerSessionWasShared(socket.sslConfiguration());
+    };
+
+    QSslConfiguration configuration = QSslConfiguration::defaultConfiguration();
+    configuration.setPeerVerifyMode(QSslSocket::VerifyNone);
+
+    QVERIFY(!connectAndCheckResumed(configuration));
+    QCOMPARE(cache->hits(), 0u);
+    QCOMPARE(cache->misses(), 1u);
+    QCOMPARE(cache->size(), 1);
+
+    // a new socket resumes the session of the previous one
+    QVERIFY(connectAndCheckResumed(configuration));
+    QCOMPARE(cache->hits(), 1u);
+    QCOMPARE(cache->misses(), 1u);
+
+    // opting out of session sharing bypasses the cache
+    QSslConfiguration notShared = configuration;
+    notShared.setSslOption(QSsl::SslOptionDisableSessionSharing, true);
+    QVERIFY(!connectAndCheckResumed(notShared));
+    QCOMPARE(cache->hits(), 1u);
+    QCOMPARE(cache->misses(), 1u);
+
+    // a configuration that verifies the peer does not get the session,
+    // and the session of a handshake with (ignored) errors is not stored
+    QSslConfiguration verifying = configuration;
+    verifying.setPeerVerifyMode(QSslSocket::VerifyPeer);
+    QVERIFY(!connectAndCheckResumed(verifying, true));
+    QCOMPARE(cache->hits(), 1u);
+    QCOMPARE(cache->misses(), 2u);
+    QCOMPARE(cache->size(), 1);
+    QVERIFY(!connectAndCheckResumed(verifying, true));
+    QCOMPARE(cache->misses(), 3u);
+}
+
 #endif // QT_CONFIG(openssl)
 #endif // QT_CONFIG(ssl)
 
@@ -29,6 +29,10 @@
 #include <QTest>
 #include <qjsondocument.h>
 #include <qjsonobject.h>
+#include <qjsonarray.h>
+#include <qjsonstreamreader.h>
+#include <qjsonstreamwriter.h>
+#include <private/qlazyjsonvalue_p.h>
 
 class BenchmarkQtJson: public QObject
 {
@@ -45,6 +49,14 @@ private Q_SLOTS:
     void parseNumbers();
     void parseJson();
     void parseJsonToVariant();
+    void parseLargeDocument_data();
+    void parseLargeDocument();
+    void streamLargeDocument_data() { parseLargeDocument_data(); }
+    void streamLargeDocument();
+    void readFewFields_data();
+    void readFewFields();
+    void writeLargeDocument_data();
+    void writeLargeDocument();
 
     void jsonObjectInsert();
     void variantMapInsert();
@@ -117,6 +129,166 @@ void BenchmarkQtJson::parseJsonToVariant()
     }
 }
 
+void BenchmarkQtJson::parseLargeDocument_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    // a log of 100000 entries, formatted like QJsonDocument::Indented does it
+    auto makeLog = [](auto message) {
+        QJsonArray log;
+        for (int i = 0; i < 100000; ++i) {
+            QJsonObject entry;
+            entry.insert("id", i);
+            entry.insert("timestamp", 1600000000.0 + i * 0.25);
+            entry.insert("level", i % 10 ? "info" : "warning");
+            entry.insert("category", "qt.network.http2");
+            entry.insert("message", message(i));
+            entry.insert("tags", QJsonArray { "request", "response", i % 2 == 0 });
+            log.append(entry);
+        }
+        return QJsonDocument(log).toJson();
+    };
+
+    QTest::newRow("ascii") << makeLog([](int i) {
+        return QStringLiteral("received %1 bytes from the server after a delay of %2 ms")
+                .arg(i * 17).arg(i % 500);
+    });
+    QTest::newRow("escaped") << makeLog([](int i) {
+        return QStringLiteral("\"GET /index.html\"\tstatus %1\nheaders:\t\"%2\"")
+                .arg(200 + i % 3).arg(i);
+    });
+    QTest::newRow("utf8") << makeLog([](int i) {
+        return QStringLiteral("Grüße aus Zürich, %1 € pro Übertragung").arg(i);
+    });
+}
+
+void BenchmarkQtJson::parseLargeDocument()
+{
+    QFETCH(QByteArray, json);
+
+    QBENCHMARK {
+        QJsonDocument doc = QJsonDocument::fromJson(json);
+        QVERIFY(doc.isArray());
+    }
+}
+
+void BenchmarkQtJson::streamLargeDocument()
+{
+    QFETCH(QByteArray, json);
+
+    QBENCHMARK {
+        QJsonStreamReader reader(json);
+        qsizetype tokens = 0;
+        while (reader.readNext() != QJsonStreamReader::NoToken)
+            ++tokens;
+        QVERIFY(!reader.hasError());
+        QCOMPARE(tokens, 1800002);
+    }
+}
+
+void BenchmarkQtJson::readFewFields_data()
+{
+    QTest::addColumn<bool>("lazy");
+
+    QTest::newRow("QJsonDocument") << false;
+    QTest::newRow("QLazyJsonValue") << true;
+}
+
+void BenchmarkQtJson::readFewFields()
+{
+    QFETCH(bool, lazy);
+
+    // a few header fields followed by a large payload
+    QJsonArray payload;
+    for (int i = 0; i < 100000; ++i)
+        payload.append(QJsonObject { { "id", i }, { "value", QString::number(i * 0.5) } });
+    const QByteArray json = QJsonDocument(QJsonObject {
+        { "a_version", 3 },
+        { "b_name", "payload" },
+        { "c_count", payload.size() },
+        { "d_payload", payload }
+    }).toJson(QJsonDocument::Compact);
+
+    QBENCHMARK {
+        if (lazy) {
+            const QLazyJsonValue doc(json);
+            QCOMPARE(doc["a_version"].toJsonValue().toInt(), 3);
+            QCOMPARE(doc["b_name"].toJsonValue().toString(), QLatin1String("payload"));
+            QCOMPARE(doc["c_count"].toJsonValue().toInt(), 100000);
+        } else {
+            const QJsonObject doc = QJsonDocument::fromJson(json).object();
+            QCOMPARE(doc["a_version"].toInt(), 3);
+            QCOMPARE(doc["b_name"].toString(), QLatin1String("payload"));
+            QCOMPARE(doc["c_count"].toInt(), 100000);
+        }
+    }
+}
+
+void BenchmarkQtJson::writeLargeDocument_data()
+{
+    QTest::addColumn<int>("mode");
+
+    QTest::newRow("toJson") << 0;
+    QTest::newRow("QJsonStreamWriter::appendValue") << 1;
+    QTest::newRow("QJsonStreamWriter") << 2;
+}
+
+void BenchmarkQtJson::writeLargeDocument()
+{
+    QFETCH(int, mode);
+
+    // discards everything, so that only the cost of producing the text is measured
+    class NullDevice : public QIODevice
+    {
+    protected:
+        qint64 readData(char *, qint64) override { return -1; }
+        qint64 writeData(const char *, qint64 len) override { return len; }
+    } device;
+    device.open(QIODevice::WriteOnly | QIODevice::Unbuffered);
+
+    auto message = [](int i) {
+        return QStringLiteral("\"GET /index.html\"\tstatus %1, Grüße aus Zürich").arg(i);
+    };
+    QJsonArray log;
+    for (int i = 0; i < 100000; ++i) {
+        log.append(QJsonObject {
+            { "id", i },
+            { "level", i % 10 ? "info" : "warning" },
+            { "message", message(i) },
+            { "tags", QJsonArray { "request", "response", i % 2 == 0 } }
+        });
+    }
+
+    QBENCHMARK {
+        if (mode == 0) {
+            device.write(QJsonDocument(log).toJson(QJsonDocument::Compact));
+        } else if (mode == 1) {
+            QJsonStreamWriter writer(&device);
+            writer.appendValue(log);
+        } else {
+            QJsonStreamWriter writer(&device);
+            writer.startArray();
+            for (int i = 0; i < 100000; ++i) {
+                writer.startObject();
+                writer.appendKey(u"id");
+                writer.append(i);
+                writer.appendKey(u"level");
+                writer.append(i % 10 ? u"info" : u"warning");
+                writer.appendKey(u"message");
+                writer.append(message(i));
+                writer.appendKey(u"tags");
+                writer.startArray();
+                writer.append(u"request");
+                writer.append(u"response");
+                writer.append(i % 2 == 0);
+                writer.endArray();
+                writer.endObject();
+            }
+            writer.endArray();
+        }
+    }
+}
+
 void BenchmarkQtJson::jsonObjectInsert()
 {
     QJsonObject object;
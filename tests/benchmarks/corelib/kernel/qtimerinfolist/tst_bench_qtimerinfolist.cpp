@@ -0,0 +1,130 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+#include <QtCore/qobject.h>
+#include <QtCore/private/qtimerinfo_unix_p.h>
+
+class tst_QTimerInfoList : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void registerAndUnregister_data();
+    void registerAndUnregister();
+    void registerFireAndKill_data();
+    void registerFireAndKill();
+};
+
+class TimerReceiver : public QObject
+{
+public:
+    QTimerInfoList *timerList = nullptr;
+    int fired = 0;
+
+    bool event(QEvent *e) override
+    {
+        if (e->type() != QEvent::Timer)
+            return QObject::event(e);
+        ++fired;
+        timerList->unregisterTimer(static_cast<QTimerEvent *>(e)->timerId());
+        return true;
+    }
+};
+
+static void addTimerRows()
+{
+    QTest::addColumn<int>("timerCount");
+    QTest::addColumn<Qt::TimerType>("timerType");
+
+    for (int timerCount : { 10000, 100000, 1000000 }) {
+        QTest::addRow("precise-%d", timerCount) << timerCount << Qt::PreciseTimer;
+        QTest::addRow("coarse-%d", timerCount) << timerCount << Qt::CoarseTimer;
+        QTest::addRow("verycoarse-%d", timerCount) << timerCount << Qt::VeryCoarseTimer;
+    }
+}
+
+void tst_QTimerInfoList::registerAndUnregister_data()
+{
+    addTimerRows();
+}
+
+// One idle timeout per connection: register lots of timers with long
+// intervals, then kill them in an order unrelated to their timeouts.
+void tst_QTimerInfoList::registerAndUnregister()
+{
+    QFETCH(int, timerCount);
+    QFETCH(Qt::TimerType, timerType);
+
+    QObject receiver;
+    QBENCHMARK {
+        QTimerInfoList timerList;
+        for (int id = 1; id <= timerCount; ++id)
+            timerList.registerTimer(id, 30000 + (id * 7919) % 60000, timerType, &receiver);
+        for (int id = 1; id <= timerCount; id += 2)
+            timerList.unregisterTimer(id);
+        for (int id = 2; id <= timerCount; id += 2)
+            timerList.unregisterTimer(id);
+    }
+}
+
+void tst_QTimerInfoList::registerFireAndKill_data()
+{
+    addTimerRows();
+}
+
+// Register timers expiring within the next 100 ms, fire each once and kill
+// it from its timer event.
+void tst_QTimerInfoList::registerFireAndKill()
+{
+    QFETCH(int, timerCount);
+    QFETCH(Qt::TimerType, timerType);
+
+    // very coarse timers have a granularity of one second
+    const int maxInterval = timerType == Qt::VeryCoarseTimer ? 1000 : 100;
+
+    QBENCHMARK {
+        QTimerInfoList timerList;
+        TimerReceiver receiver;
+        receiver.timerList = &timerList;
+        for (int id = 1; id <= timerCount; ++id)
+            timerList.registerTimer(id, (id * 7919) % maxInterval, timerType, &receiver);
+
+        timespec tm;
+        while (timerList.timerWait(tm)) {
+            if (tm.tv_sec || tm.tv_nsec)
+                nanosleep(&tm, nullptr);
+            timerList.activateTimers();
+        }
+        QCOMPARE(receiver.fired, timerCount);
+    }
+}
+
+QTEST_MAIN(tst_QTimerInfoList)
+
+#include "tst_bench_qtimerinfolist.moc"
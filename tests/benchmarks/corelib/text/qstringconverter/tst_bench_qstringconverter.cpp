@@ -0,0 +1,132 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QTest>
+
+#include <QStringDecoder>
+#include <QStringEncoder>
+
+class tst_QStringConverter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void fromUtf8_data() const;
+    void fromUtf8() const;
+    void toUtf8_data() const { fromUtf8_data(); }
+    void toUtf8() const;
+    void decoder_data() const { fromUtf8_data(); }
+    void decoder() const;
+    void encoder_data() const { fromUtf8_data(); }
+    void encoder() const;
+    void isValidUtf8_data() const { fromUtf8_data(); }
+    void isValidUtf8() const;
+};
+
+void tst_QStringConverter::fromUtf8_data() const
+{
+    QTest::addColumn<QString>("text");
+
+    // about 64 kB of UTF-8 for each
+    const auto addRow = [](const char *name, const QString &sentence) {
+        const qsizetype bytes = sentence.toUtf8().size();
+        QTest::newRow(name) << sentence.repeated(65536 / bytes + 1);
+    };
+    addRow("ascii", u"The quick brown fox jumps over the lazy dog. "_qs);
+    addRow("latin1", u"Größenwahn à la française, señor! Ça va très bien. "_qs);
+    addRow("cyrillic", u"Съешь же ещё этих мягких французских булок, да выпей чаю. "_qs);
+    addRow("cjk", u"我能吞下玻璃而不伤身体。私はガラスを食べられます。それは私を傷つけません。"_qs);
+    addRow("mixed", u"<p class=\"title\">Привет, 世界! Qt 6 — ½ ≠ ∞</p>\n"_qs);
+    addRow("emoji", u"Hello 😀 world 🎉 done 👍🏽 "_qs);
+}
+
+void tst_QStringConverter::fromUtf8() const
+{
+    QFETCH(QString, text);
+    const QByteArray utf8 = text.toUtf8();
+
+    QBENCHMARK {
+        [[maybe_unused]] auto r = QString::fromUtf8(utf8);
+    }
+}
+
+void tst_QStringConverter::toUtf8() const
+{
+    QFETCH(QString, text);
+
+    QBENCHMARK {
+        [[maybe_unused]] auto r = text.toUtf8();
+    }
+}
+
+// decoder() and encoder() convert into a preallocated buffer, so they
+// measure the conversion without the allocation of the result
+void tst_QStringConverter::decoder() const
+{
+    QFETCH(QString, text);
+    const QByteArray utf8 = text.toUtf8();
+    QStringDecoder decoder(QStringDecoder::Utf8);
+    QString buffer(decoder.requiredSpace(utf8.size()), Qt::Uninitialized);
+
+    QBENCHMARK {
+        decoder.resetState();
+        decoder.appendToBuffer(buffer.data(), utf8);
+    }
+    QVERIFY(!decoder.hasError());
+}
+
+void tst_QStringConverter::encoder() const
+{
+    QFETCH(QString, text);
+    QStringEncoder encoder(QStringEncoder::Utf8);
+    QByteArray buffer(encoder.requiredSpace(text.size()), Qt::Uninitialized);
+
+    QBENCHMARK {
+        encoder.resetState();
+        encoder.appendToBuffer(buffer.data(), text);
+    }
+    QVERIFY(!encoder.hasError());
+}
+
+void tst_QStringConverter::isValidUtf8() const
+{
+    QFETCH(QString, text);
+    const QByteArray utf8 = text.toUtf8();
+
+    // isValidUtf8() is pure, so make sure the compiler can't hoist it
+    const char *volatile data = utf8.constData();
+    qsizetype valid = 0;
+    QBENCHMARK {
+        valid += QByteArrayView(data, utf8.size()).isValidUtf8();
+    }
+    QVERIFY(valid);
+}
+
+QTEST_MAIN(tst_QStringConverter)
+
+#include "tst_bench_qstringconverter.moc"
@@ -40,6 +40,8 @@ public:
 private slots:
     void startRunnables();
     void activeThreadCount();
+    void forkJoin_data();
+    void forkJoin();
 };
 
 tst_QThreadPool::tst_QThreadPool()
@@ -75,6 +77,54 @@ void tst_QThreadPool::activeThreadCount()
     }
 }
 
+void tst_QThreadPool::forkJoin_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<bool>("workStealing");
+
+    QList<int> threadCounts = { 1, 2, 4, 8 };
+    if (!threadCounts.contains(QThread::idealThreadCount()))
+        threadCounts.append(QThread::idealThreadCount());
+    for (int threadCount : qAsConst(threadCounts)) {
+        QTest::addRow("shared-queue-%d", threadCount) << threadCount << false;
+        QTest::addRow("work-stealing-%d", threadCount) << threadCount << true;
+    }
+}
+
+// Recursively splits into 2^16 tiny tasks, as QtConcurrent::map over a
+// large sequence would. Shows how the pool scales with the thread count.
+void tst_QThreadPool::forkJoin()
+{
+    QFETCH(int, threadCount);
+    QFETCH(bool, workStealing);
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(threadCount);
+    threadPool.setWorkStealingEnabled(workStealing);
+
+    constexpr int depth = 16;
+    QSemaphore done;
+    QAtomicInt pendingLeaves;
+    QAtomicInteger<quint64> checksum;
+    std::function<void(int, quint64)> split = [&](int level, quint64 value) {
+        if (level == depth) {
+            checksum.fetchAndAddRelaxed(value % 7);
+            if (!pendingLeaves.deref())
+                done.release();
+            return;
+        }
+        threadPool.start([&split, level, value] { split(level + 1, value * 2); });
+        threadPool.start([&split, level, value] { split(level + 1, value * 2 + 1); });
+    };
+
+    QBENCHMARK {
+        pendingLeaves.storeRelaxed(1 << depth);
+        threadPool.start([&split] { split(0, 0); });
+        done.acquire();
+    }
+    QVERIFY(checksum.loadRelaxed() > 0);
+}
+
 QTEST_MAIN(tst_QThreadPool)
 
 #include "tst_bench_qthreadpool.moc"
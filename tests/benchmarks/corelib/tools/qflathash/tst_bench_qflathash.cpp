@@ -0,0 +1,164 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QHash>
+#include <QList>
+#include <QRandomGenerator>
+#include <QTest>
+
+#include <private/qflathash_p.h>
+
+#include <unordered_map>
+
+/*
+  Compares QFlatHash against QHash and std::unordered_map for quint32 keys and
+  values, with sizes from 1e3 to 1e8 entries. The lookup benchmarks perform a
+  fixed number of random lookups, so that the large rows show the cost of cache
+  misses rather than the cost of the loop. The 1e8 rows need several GB of
+  memory; select rows by data tag to skip them.
+*/
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void qflathash_insert_data() { data(); }
+    void qflathash_insert() { insert_template<QFlatHash<quint32, quint32>>(); }
+    void qhash_insert_data() { data(); }
+    void qhash_insert() { insert_template<QHash<quint32, quint32>>(); }
+    void unordered_map_insert_data() { data(); }
+    void unordered_map_insert() { insert_template<std::unordered_map<quint32, quint32>>(); }
+
+    void qflathash_lookupHit_data() { data(); }
+    void qflathash_lookupHit() { lookup_template<QFlatHash<quint32, quint32>>(true); }
+    void qhash_lookupHit_data() { data(); }
+    void qhash_lookupHit() { lookup_template<QHash<quint32, quint32>>(true); }
+    void unordered_map_lookupHit_data() { data(); }
+    void unordered_map_lookupHit() { lookup_template<std::unordered_map<quint32, quint32>>(true); }
+
+    void qflathash_lookupMiss_data() { data(); }
+    void qflathash_lookupMiss() { lookup_template<QFlatHash<quint32, quint32>>(false); }
+    void qhash_lookupMiss_data() { data(); }
+    void qhash_lookupMiss() { lookup_template<QHash<quint32, quint32>>(false); }
+    void unordered_map_lookupMiss_data() { data(); }
+    void unordered_map_lookupMiss() { lookup_template<std::unordered_map<quint32, quint32>>(false); }
+
+private:
+    void data();
+    template <typename Container> void insert_template();
+    template <typename Container> void lookup_template(bool hit);
+};
+
+static constexpr qsizetype LookupCount = 1000000;
+
+// even keys are inserted, odd keys are guaranteed misses
+static QList<quint32> makeKeys(qsizetype count, quint32 seed, bool present)
+{
+    QRandomGenerator rng(seed);
+    QList<quint32> keys;
+    keys.reserve(count);
+    for (qsizetype i = 0; i < count; ++i) {
+        const quint32 k = rng.generate();
+        keys.append(present ? k & ~1u : k | 1u);
+    }
+    return keys;
+}
+
+template <typename Container>
+static void insertKeys(Container &c, const QList<quint32> &keys)
+{
+    for (quint32 k : keys)
+        c[k] = k;
+}
+
+template <typename Container>
+static quint32 lookupKeys(const Container &c, const QList<quint32> &keys)
+{
+    quint32 sum = 0;
+    for (quint32 k : keys) {
+        const auto it = c.find(k);
+        if (it != c.end()) {
+            if constexpr (std::is_same_v<Container, std::unordered_map<quint32, quint32>>)
+                sum += it->second;
+            else
+                sum += it.value();
+        }
+    }
+    return sum;
+}
+
+void tst_QFlatHash::data()
+{
+    QTest::addColumn<qsizetype>("size");
+
+    for (qsizetype size = 1000; size <= 100000000; size *= 10)
+        QTest::addRow("%lld", qlonglong(size)) << size;
+}
+
+template <typename Container>
+void tst_QFlatHash::insert_template()
+{
+    QFETCH(qsizetype, size);
+    const QList<quint32> keys = makeKeys(size, 1, true);
+
+    QBENCHMARK {
+        Container c;
+        insertKeys(c, keys);
+    }
+}
+
+template <typename Container>
+void tst_QFlatHash::lookup_template(bool hit)
+{
+    QFETCH(qsizetype, size);
+    const QList<quint32> keys = makeKeys(size, 1, true);
+    Container c;
+    insertKeys(c, keys);
+
+    QList<quint32> probes;
+    if (hit) {
+        QRandomGenerator rng(2);
+        probes.reserve(LookupCount);
+        for (qsizetype i = 0; i < LookupCount; ++i)
+            probes.append(keys.at(rng.bounded(keys.size())));
+    } else {
+        probes = makeKeys(LookupCount, 2, false);
+    }
+
+    quint32 sum = 0;
+    QBENCHMARK {
+        sum += lookupKeys(c, probes);
+    }
+    if (!hit)
+        QCOMPARE(sum, 0u);
+}
+
+QTEST_APPLESS_MAIN(tst_QFlatHash)
+
+#include "tst_bench_qflathash.moc"
@@ -96,6 +96,12 @@ private slots:
 
     void unalignedBlendArgb32_data();
     void unalignedBlendArgb32();
+
+    void gradientBench_data();
+    void gradientBench();
+
+    void formatBench_data();
+    void formatBench();
 };
 
 void BlendBench::blendBench_data()
@@ -172,8 +178,8 @@ void BlendBench::blendBenchAlpha()
 void BlendBench::unalignedBlendArgb32_data()
 {
     // The performance of blending can depend of the alignment of the data
-    // on 16 bytes. Some SIMD instruction set have significantly better
-    // memory access when the memory is aligned on 16 bytes boundary.
+    // on 16, 32 or 64 bytes. Some SIMD instruction set have significantly better
+    // memory access when the memory is aligned on the size of their registers.
 
     // offset in 32 bits words
     QTest::addColumn<int>("offset");
@@ -181,6 +187,9 @@ void BlendBench::unalignedBlendArgb32_data()
     QTest::newRow("unaligned by 4 bytes") << 1;
     QTest::newRow("unaligned by 8 bytes") << 2;
     QTest::newRow("unaligned by 12 bytes") << 3;
+    QTest::newRow("unaligned by 20 bytes") << 5;
+    QTest::newRow("unaligned by 36 bytes") << 9;
+    QTest::newRow("unaligned by 60 bytes") << 15;
 }
 
 void BlendBench::unalignedBlendArgb32()
@@ -189,11 +198,11 @@ void BlendBench::unalignedBlendArgb32()
 
     // We use dst aligned by design. We don't want to test all the combination of alignemnt for src and dst.
     // Moreover, it make sense for us to align dst in the implementation because it is accessed more often.
-    uchar *dstMemory = static_cast<uchar*>(qMallocAligned((dimension * dimension * sizeof(quint32)), 16));
+    uchar *dstMemory = static_cast<uchar*>(qMallocAligned((dimension * dimension * sizeof(quint32)), 64));
     QImage destination(dstMemory, dimension, dimension, QImage::Format_ARGB32_Premultiplied);
     destination.fill(0x12345678); // avoid special cases of alpha
 
-    uchar *srcMemory = static_cast<uchar*>(qMallocAligned((dimension * dimension * sizeof(quint32)) + 16, 16));
+    uchar *srcMemory = static_cast<uchar*>(qMallocAligned((dimension * dimension * sizeof(quint32)) + 64, 64));
     QFETCH(int, offset);
     uchar *imageSrcMemory = srcMemory + (offset * sizeof(quint32));
 
@@ -209,6 +218,121 @@ void BlendBench::unalignedBlendArgb32()
     qFreeAligned(dstMemory);
 }
 
+void BlendBench::gradientBench_data()
+{
+    QTest::addColumn<int>("gradientType");
+    QTest::addColumn<int>("spread");
+
+    const char *types[] = { "linear", "radial", "conical" };
+    const char *spreads[] = { "pad", "reflect", "repeat" };
+    for (int type = QGradient::LinearGradient; type <= QGradient::ConicalGradient; ++type) {
+        for (int spread = QGradient::PadSpread; spread <= QGradient::RepeatSpread; ++spread)
+            QTest::addRow("%s, %s", types[type], spreads[spread]) << type << spread;
+    }
+}
+
+void BlendBench::gradientBench()
+{
+    QFETCH(int, gradientType);
+    QFETCH(int, spread);
+
+    QGradient gradient;
+    switch (gradientType) {
+    case QGradient::LinearGradient:
+        gradient = QLinearGradient(0, 0, 100, 70);
+        break;
+    case QGradient::RadialGradient:
+        gradient = QRadialGradient(256, 256, 100, 230, 240);
+        break;
+    case QGradient::ConicalGradient:
+        gradient = QConicalGradient(256, 256, 30);
+        break;
+    }
+    gradient.setSpread(QGradient::Spread(spread));
+    gradient.setColorAt(0, QColor(255, 0, 255, 200));
+    gradient.setColorAt(0.5, Qt::white);
+    gradient.setColorAt(1, QColor(0, 0, 255, 127));
+
+    QImage img(512, 512, QImage::Format_ARGB32_Premultiplied);
+    img.fill(0xff406080);
+    QPainter p(&img);
+    p.setPen(Qt::NoPen);
+    p.setBrush(gradient);
+
+    QBENCHMARK {
+        p.drawRect(0, 0, 512, 512);
+    }
+}
+
+enum FormatBenchOperation { SolidFill, ImageBlend, GradientFill, TransformedImage };
+
+void BlendBench::formatBench_data()
+{
+    QTest::addColumn<QImage::Format>("format");
+    QTest::addColumn<int>("operation");
+
+    const struct {
+        QImage::Format format;
+        const char *name;
+    } formats[] = {
+        { QImage::Format_ARGB32_Premultiplied, "ARGB32PM" },
+        { QImage::Format_RGBA64_Premultiplied, "RGBA64PM" },
+        { QImage::Format_RGBA16FPx4_Premultiplied, "RGBA16FPM" },
+        { QImage::Format_RGBA32FPx4_Premultiplied, "RGBA32FPM" },
+        { QImage::Format_RGBA32FPx4, "RGBA32F" },
+    };
+    const char *operations[] = { "solid", "image", "gradient", "transformed" };
+    for (int operation = SolidFill; operation <= TransformedImage; ++operation) {
+        for (const auto &format : formats)
+            QTest::addRow("%s, %s", operations[operation], format.name) << format.format << operation;
+    }
+}
+
+void BlendBench::formatBench()
+{
+    QFETCH(QImage::Format, format);
+    QFETCH(int, operation);
+
+    QImage src(512, 512, QImage::Format_ARGB32_Premultiplied);
+    paint(&src);
+    src.convertTo(format);
+
+    QImage img(512, 512, format);
+    img.fill(QColor(64, 96, 128));
+    QPainter p(&img);
+    p.setPen(Qt::NoPen);
+
+    switch (operation) {
+    case SolidFill:
+        p.setBrush(QColor(127, 127, 127, 127));
+        break;
+    case ImageBlend:
+        p.setBrush(QBrush(src));
+        break;
+    case GradientFill: {
+        QLinearGradient gradient(0, 0, 512, 400);
+        gradient.setColorAt(0, QColor(255, 0, 255, 200));
+        gradient.setColorAt(1, QColor(0, 0, 255, 127));
+        p.setBrush(gradient);
+        break;
+    }
+    case TransformedImage:
+        p.setRenderHint(QPainter::SmoothPixmapTransform);
+        p.translate(256, 256);
+        p.rotate(30);
+        p.scale(1.5, 1.5);
+        p.translate(-256, -256);
+        break;
+    }
+
+    QBENCHMARK {
+        if (operation == TransformedImage)
+            p.drawImage(0, 0, src);
+        else
+            p.drawRect(0, 0, 512, 512);
+    }
+}
+
 QTEST_MAIN(BlendBench)
 
 #include "main.moc"
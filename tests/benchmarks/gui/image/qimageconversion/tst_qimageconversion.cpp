@@ -27,6 +27,7 @@
 ****************************************************************************/
 
 #include <qtest.h>
+#include <QColorSpace>
 #include <QImage>
 
 Q_DECLARE_METATYPE(QImage::Format)
@@ -56,6 +57,9 @@ private slots:
     void convertGenericInplace_data();
     void convertGenericInplace();
 
+    void convertToColorSpace_data();
+    void convertToColorSpace();
+
 private:
     QImage generateImageRgb888(int width, int height);
     QImage generateImageRgb16(int width, int height);
@@ -393,6 +397,36 @@ void tst_QImageConversion::convertGenericInplace()
     }
 }
 
+void tst_QImageConversion::convertToColorSpace_data()
+{
+    QTest::addColumn<QImage>("inputImage");
+
+    QImage argb32 = generateImageArgb32(1000, 1000);
+    argb32.setColorSpace(QColorSpace::SRgb);
+
+    QTest::newRow("argb32") << argb32;
+    QTest::newRow("argb32pm") << argb32.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    QTest::newRow("rgb32") << argb32.convertToFormat(QImage::Format_RGB32);
+    QTest::newRow("rgba64") << argb32.convertToFormat(QImage::Format_RGBA64);
+    QTest::newRow("rgba64pm") << argb32.convertToFormat(QImage::Format_RGBA64_Premultiplied);
+    QTest::newRow("rgbx16fpx4") << argb32.convertToFormat(QImage::Format_RGBX16FPx4);
+    QTest::newRow("rgba16fpx4pm") << argb32.convertToFormat(QImage::Format_RGBA16FPx4_Premultiplied);
+    QTest::newRow("rgba32fpx4") << argb32.convertToFormat(QImage::Format_RGBA32FPx4);
+    QTest::newRow("rgba32fpx4pm") << argb32.convertToFormat(QImage::Format_RGBA32FPx4_Premultiplied);
+}
+
+void tst_QImageConversion::convertToColorSpace()
+{
+    QFETCH(QImage, inputImage);
+
+    const QColorSpace displayP3(QColorSpace::DisplayP3);
+
+    QBENCHMARK {
+        QImage output = inputImage.convertedToColorSpace(displayP3);
+        output.constBits();
+    }
+}
+
 /*
  Fill a RGB888 image with "random" pixel values.
  */
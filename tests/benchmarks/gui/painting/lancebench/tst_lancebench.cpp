@@ -31,6 +31,9 @@
 #include <qtest.h>
 #include <QDir>
 #include <QPainter>
+#include <QPicture>
+
+#include <private/qrastertilerenderer_p.h>
 
 #ifndef QT_NO_OPENGL
 #include <QOpenGLFramebufferObjectFormat>
@@ -49,12 +52,15 @@ public:
 private:
     enum GraphicsEngine {
         Raster = 0,
-        OpenGL = 1
+        OpenGL = 1,
+        RasterPicture = 2,
+        RasterTiled = 3
     };
 
     void setupTestSuite(const QStringList& blacklist = QStringList());
     void runTestSuite(GraphicsEngine engine, QImage::Format format, const QSurfaceFormat &contextFormat = QSurfaceFormat());
     void paint(QPaintDevice *device, GraphicsEngine engine, QImage::Format format, const QStringList &script, const QString &filePath);
+    void replay(GraphicsEngine engine, QImage::Format format, const QStringList &script, const QString &filePath);
 
     QStringList qpsFiles;
     QHash<QString, QStringList> scripts;
@@ -78,6 +84,12 @@ private slots:
     void testRasterARGB8565PM();
     void testRasterGrayscale8_data();
     void testRasterGrayscale8();
+    void testRasterPictureARGB32PM_data();
+    void testRasterPictureARGB32PM();
+    void testRasterTiledARGB32PM_data();
+    void testRasterTiledARGB32PM();
+    void testRasterTiledRGB32_data();
+    void testRasterTiledRGB32();
 
 #ifndef QT_NO_OPENGL
     void testOpenGL_data();
@@ -96,7 +108,7 @@ tst_LanceBench::tst_LanceBench()
 
 void tst_LanceBench::initTestCase()
 {
-    QString baseDir = QFINDTESTDATA("../../../../auto/other/lancelot/scripts/text.qps");
+    QString baseDir = QFINDTESTDATA("../../../../baseline/painting/scripts/text.qps");
     scriptsDir = baseDir.left(baseDir.lastIndexOf('/')) + '/';
     QDir qpsDir(scriptsDir);
     qpsFiles = qpsDir.entryList(QStringList() << QLatin1String("*.qps"), QDir::Files | QDir::Readable);
@@ -184,6 +196,36 @@ void tst_LanceBench::testRasterGrayscale8()
     runTestSuite(Raster, QImage::Format_Grayscale8);
 }
 
+void tst_LanceBench::testRasterPictureARGB32PM_data()
+{
+    setupTestSuite();
+}
+
+void tst_LanceBench::testRasterPictureARGB32PM()
+{
+    runTestSuite(RasterPicture, QImage::Format_ARGB32_Premultiplied);
+}
+
+void tst_LanceBench::testRasterTiledARGB32PM_data()
+{
+    setupTestSuite();
+}
+
+void tst_LanceBench::testRasterTiledARGB32PM()
+{
+    runTestSuite(RasterTiled, QImage::Format_ARGB32_Premultiplied);
+}
+
+void tst_LanceBench::testRasterTiledRGB32_data()
+{
+    setupTestSuite();
+}
+
+void tst_LanceBench::testRasterTiledRGB32()
+{
+    runTestSuite(RasterTiled, QImage::Format_RGB32);
+}
+
 #ifndef QT_NO_OPENGL
 bool tst_LanceBench::checkSystemGLSupport()
 {
@@ -281,6 +323,8 @@ void tst_LanceBench::runTestSuite(GraphicsEngine engine, QImage::Format format,
         QImage img(800, 800, format);
         paint(&img, engine, format, script, QFileInfo(filePath).absoluteFilePath());
         rendered = img;
+    } else if (engine == RasterPicture || engine == RasterTiled) {
+        replay(engine, format, script, QFileInfo(filePath).absoluteFilePath());
 #ifndef QT_NO_OPENGL
     } else if (engine == OpenGL) {
         QWindow win;
@@ -313,6 +357,10 @@ void tst_LanceBench::paint(QPaintDevice *device, GraphicsEngine engine, QImage::
     case Raster:
         pcmd.setType(ImageType);
         break;
+    case RasterPicture:
+    case RasterTiled:
+        Q_UNREACHABLE();
+        break;
     }
     pcmd.setFilePath(filePath);
     QBENCHMARK {
@@ -323,6 +371,52 @@ void tst_LanceBench::paint(QPaintDevice *device, GraphicsEngine engine, QImage::
     }
 }
 
+// Records the script into a picture, and replays it into an image,
+// with one painter or tile by tile in parallel.
+void tst_LanceBench::replay(GraphicsEngine engine, QImage::Format format, const QStringList &script, const QString &filePath)
+{
+    QPicture picture;
+    PaintCommands pcmd(script, 800, 800, format);
+    pcmd.setType(PictureType);
+    pcmd.setFilePath(filePath);
+    QPainter p(&picture);
+    pcmd.setPainter(&p);
+    pcmd.runCommands();
+    p.end();
+
+    QImage img(800, 800, format);
+    if (engine == RasterPicture) {
+        QBENCHMARK {
+            QPainter p(&img);
+            p.drawPicture(0, 0, picture);
+            p.end();
+        }
+        return;
+    }
+
+    // Painting the picture at once is the reference, the tiles must match
+    // it exactly. The first replay only fills the glyph and pixmap caches.
+    const auto serialReplay = [&]() {
+        QImage image(800, 800, format);
+        image.fill(Qt::transparent);
+        QPainter p(&image);
+        p.drawPicture(0, 0, picture);
+        p.end();
+        return image;
+    };
+    serialReplay();
+    const QImage expected = serialReplay();
+
+    img.fill(Qt::transparent);
+    QRasterTileRenderer renderer(&img);
+    QVERIFY(renderer.render(picture));
+    QCOMPARE(img, expected);
+
+    QBENCHMARK {
+        renderer.render(picture);
+    }
+}
+
 QTEST_MAIN(tst_LanceBench)
 
 #include "tst_lancebench.moc"
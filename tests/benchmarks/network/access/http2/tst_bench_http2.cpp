@@ -0,0 +1,229 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+// This file contains benchmarks for HTTP/2 streams multiplexed over one
+// loopback connection, using the server from the http2 autotest.
+
+#include "../../../../auto/network/access/http2/http2srv.h"
+
+#include <QTest>
+#include <QTestEventLoop>
+#include <QtCore/qthread.h>
+#include <QtNetwork/qhttp2configuration.h>
+#include <QtNetwork/qnetworkaccessmanager.h>
+#include <QtNetwork/qnetworkreply.h>
+#include <QtNetwork/qnetworkrequest.h>
+
+#include <memory>
+
+class tst_Http2 : public QObject
+{
+    Q_OBJECT
+public:
+    tst_Http2();
+    ~tst_Http2();
+
+private slots:
+    void multiplexedDownloads_data();
+    void multiplexedDownloads();
+    void multiplexedUploads_data();
+    void multiplexedUploads();
+
+private:
+    Http2Server *newServer(const QHttp2Configuration &configuration);
+    QNetworkRequest newRequest(int streamNumber, const QHttp2Configuration &configuration,
+                               QNetworkRequest::Priority priority = QNetworkRequest::NormalPriority) const;
+    bool waitForReplies(const QList<QNetworkReply *> &replies);
+
+    QThread workerThread;
+    quint16 serverPort = 0;
+};
+
+using ServerPtr = std::unique_ptr<Http2Server, void (*)(Http2Server *)>;
+
+tst_Http2::tst_Http2()
+{
+    workerThread.start();
+}
+
+tst_Http2::~tst_Http2()
+{
+    workerThread.quit();
+    workerThread.wait();
+}
+
+Http2Server *tst_Http2::newServer(const QHttp2Configuration &configuration)
+{
+    RawSettings clientSettings;
+    clientSettings[Http2::Settings::ENABLE_PUSH_ID] = configuration.serverPushEnabled();
+    clientSettings[Http2::Settings::INITIAL_WINDOW_SIZE_ID] = configuration.streamReceiveWindowSize();
+
+    auto server = new Http2Server(H2Type::h2cDirect,
+                                  {{Http2::Settings::MAX_CONCURRENT_STREAMS_ID, 100}},
+                                  clientSettings);
+    // GET requests get the response body, POST requests an empty response:
+    connect(server, &Http2Server::receivedRequest, server, [server](quint32 streamID) {
+        server->sendResponse(streamID, false);
+    });
+    connect(server, &Http2Server::receivedData, server, [server](quint32 streamID) {
+        server->sendResponse(streamID, true);
+    });
+    server->moveToThread(&workerThread);
+
+    serverPort = 0;
+    QTestEventLoop loop;
+    connect(server, &Http2Server::serverStarted, &loop, [this, &loop](quint16 port) {
+        serverPort = port;
+        loop.exitLoop();
+    });
+    QMetaObject::invokeMethod(server, "startServer", Qt::QueuedConnection);
+    loop.enterLoop(5);
+    return server;
+}
+
+QNetworkRequest tst_Http2::newRequest(int streamNumber, const QHttp2Configuration &configuration,
+                                      QNetworkRequest::Priority priority) const
+{
+    QUrl url(QStringLiteral("http://127.0.0.1"));
+    url.setPort(serverPort);
+    url.setPath(QString("/stream%1.html").arg(streamNumber));
+
+    QNetworkRequest request(url);
+    request.setAttribute(QNetworkRequest::Http2DirectAttribute, true);
+    request.setAttribute(QNetworkRequest::Http2CleartextAllowedAttribute, true);
+    request.setHeader(QNetworkRequest::ContentTypeHeader, QVariant("text/plain"));
+    request.setPriority(priority);
+    request.setHttp2Configuration(configuration);
+    return request;
+}
+
+bool tst_Http2::waitForReplies(const QList<QNetworkReply *> &replies)
+{
+    QTestEventLoop loop;
+    int pending = int(replies.size());
+    for (QNetworkReply *reply : replies) {
+        connect(reply, &QNetworkReply::finished, &loop, [&loop, &pending] {
+            if (--pending == 0)
+                loop.exitLoop();
+        });
+    }
+    loop.enterLoop(60);
+    if (loop.timeout())
+        return false;
+    return std::all_of(replies.cbegin(), replies.cend(), [](QNetworkReply *reply) {
+        return reply->error() == QNetworkReply::NoError;
+    });
+}
+
+static void deleteLaterServer(Http2Server *server)
+{
+    server->stopSendingDATAFrames();
+    server->deleteLater();
+}
+
+void tst_Http2::multiplexedDownloads_data()
+{
+    QTest::addColumn<int>("streams");
+    QTest::addColumn<bool>("autoTuning");
+
+    // The same 32 MiB total, split between more streams:
+    for (int streams : { 1, 8, 32 }) {
+        QTest::addRow("%d-streams-fixed-window", streams) << streams << false;
+        QTest::addRow("%d-streams-auto-tuned", streams) << streams << true;
+    }
+}
+
+void tst_Http2::multiplexedDownloads()
+{
+    QFETCH(int, streams);
+    QFETCH(bool, autoTuning);
+
+    // QNetworkRequest's defaults: a 64 KiB stream receive window
+    QHttp2Configuration configuration = QNetworkRequest().http2Configuration();
+    configuration.setWindowAutoTuningEnabled(autoTuning);
+
+    ServerPtr server(newServer(configuration), deleteLaterServer);
+    QVERIFY(serverPort);
+    const qsizetype totalSize = 32 * 1024 * 1024;
+    server->setResponseBody(QByteArray(totalSize / streams, 'x'));
+
+    QNetworkAccessManager manager;
+    int streamNumber = 0;
+    QBENCHMARK {
+        QList<QNetworkReply *> replies;
+        for (int i = 0; i < streams; ++i)
+            replies.append(manager.get(newRequest(streamNumber++, configuration)));
+        QVERIFY(waitForReplies(replies));
+        for (QNetworkReply *reply : qAsConst(replies)) {
+            QCOMPARE(reply->bytesAvailable(), totalSize / streams);
+            reply->deleteLater();
+        }
+    }
+}
+
+void tst_Http2::multiplexedUploads_data()
+{
+    QTest::addColumn<int>("streams");
+
+    for (int streams : { 1, 8, 32 })
+        QTest::addRow("%d-streams", streams) << streams;
+}
+
+void tst_Http2::multiplexedUploads()
+{
+    QFETCH(int, streams);
+
+    const QHttp2Configuration configuration = QNetworkRequest().http2Configuration();
+
+    ServerPtr server(newServer(configuration), deleteLaterServer);
+    QVERIFY(serverPort);
+    const QByteArray payload(8 * 1024 * 1024 / streams, 'x');
+
+    // Uploads with different weights compete for the connection:
+    const QNetworkRequest::Priority priorities[] = {
+        QNetworkRequest::HighPriority,
+        QNetworkRequest::NormalPriority,
+        QNetworkRequest::LowPriority
+    };
+
+    QNetworkAccessManager manager;
+    int streamNumber = 0;
+    QBENCHMARK {
+        QList<QNetworkReply *> replies;
+        for (int i = 0; i < streams; ++i) {
+            replies.append(manager.post(newRequest(streamNumber++, configuration,
+                                                   priorities[i % 3]), payload));
+        }
+        QVERIFY(waitForReplies(replies));
+        qDeleteAll(replies);
+    }
+}
+
+QTEST_MAIN(tst_Http2)
+
+#include "tst_bench_http2.moc"
@@ -0,0 +1,103 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+#include <QtCore/QEventLoop>
+#include <QtCore/QTemporaryFile>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
+
+class tst_QTcpSocket : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void sendFile_data();
+    void sendFile();
+};
+
+void tst_QTcpSocket::sendFile_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<bool>("zeroCopy");
+
+    for (int megabytes : {1, 16, 64}) {
+        QTest::addRow("write-%dMiB", megabytes) << megabytes * 1024 * 1024 << false;
+        QTest::addRow("sendFile-%dMiB", megabytes) << megabytes * 1024 * 1024 << true;
+    }
+}
+
+// Serves a file over a loopback connection, either by reading it into a
+// QByteArray and writing that, or with QAbstractSocket::sendFile().
+void tst_QTcpSocket::sendFile()
+{
+    QFETCH(int, size);
+    QFETCH(bool, zeroCopy);
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    const QByteArray block(1024 * 1024, 'a');
+    for (int written = 0; written < size; written += block.size())
+        QCOMPARE(file.write(block), qint64(block.size()));
+    QVERIFY(file.flush());
+
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    QTcpSocket socket;
+    socket.connectToHost(server.serverAddress(), server.serverPort());
+    QVERIFY(socket.waitForConnected(5000));
+    QVERIFY(server.waitForNewConnection(5000));
+    QTcpSocket *peer = server.nextPendingConnection();
+    QVERIFY(peer);
+
+    QEventLoop loop;
+    qint64 received = 0;
+    connect(peer, &QIODevice::readyRead, &loop, [&] {
+        char buffer[64 * 1024];
+        qint64 bytesRead;
+        while ((bytesRead = peer->read(buffer, sizeof(buffer))) > 0)
+            received += bytesRead;
+        if (received >= size)
+            loop.quit();
+    });
+
+    QBENCHMARK {
+        received = 0;
+        if (zeroCopy) {
+            QVERIFY(socket.sendFile(&file));
+        } else {
+            QVERIFY(file.seek(0));
+            QCOMPARE(socket.write(file.readAll()), qint64(size));
+        }
+        loop.exec();
+        QCOMPARE(received, qint64(size));
+    }
+}
+
+QTEST_MAIN(tst_QTcpSocket)
+#include "tst_qtcpsocket.moc"
@@ -41,6 +41,8 @@ public:
 private slots:
     void pendingDatagramSize_data();
     void pendingDatagramSize();
+    void loopback_data();
+    void loopback();
 };
 
 tst_QUdpSocket::tst_QUdpSocket()
@@ -76,5 +78,51 @@ void tst_QUdpSocket::pendingDatagramSize()
     }
 }
 
+void tst_QUdpSocket::loopback_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<bool>("batched");
+    for (int value : {64, 512, 1400}) {
+        QTest::addRow("single-%d", value) << value << false;
+        QTest::addRow("batched-%d", value) << value << true;
+    }
+}
+
+void tst_QUdpSocket::loopback()
+{
+    QFETCH(int, size);
+    QFETCH(bool, batched);
+
+    // Send bursts small enough to fit in the default receive buffer, so
+    // that no datagram is dropped.
+    constexpr int BurstSize = 32;
+    constexpr int Bursts = 64;
+
+    QUdpSocket receiver;
+    QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+    QUdpSocket sender;
+    QVERIFY(sender.bind(QHostAddress::LocalHost, 0));
+
+    const QNetworkDatagram datagram(QByteArray(size, 'a'), QHostAddress::LocalHost,
+                                    receiver.localPort());
+    const QList<QNetworkDatagram> burst(BurstSize, datagram);
+
+    QBENCHMARK {
+        for (int i = 0; i < Bursts; ++i) {
+            if (batched) {
+                QCOMPARE(sender.writeDatagrams(burst), qsizetype(BurstSize));
+                int received = 0;
+                while (received < BurstSize)
+                    received += receiver.receiveDatagrams(BurstSize - received, size).size();
+            } else {
+                for (int j = 0; j < BurstSize; ++j)
+                    QCOMPARE(sender.writeDatagram(datagram), qint64(size));
+                for (int j = 0; j < BurstSize; ++j)
+                    QCOMPARE(receiver.receiveDatagram(size).data().size(), size);
+            }
+        }
+    }
+}
+
 QTEST_MAIN(tst_QUdpSocket)
 #include "tst_qudpsocket.moc"
@@ -31,6 +31,11 @@
 #include <qcoreapplication.h>
 #include <qsslconfiguration.h>
 #include <qsslsocket.h>
+#include <qtcpserver.h>
+
+#include <QtNetwork/private/qsslconfiguration_p.h>
+#include <QtNetwork/private/qsslsocket_p.h>
+#include <QtNetwork/private/qtlssessioncache_p.h>
 
 
 #include "../../../../auto/network-settings.h"
@@ -51,6 +56,39 @@ public slots:
 private slots:
     void rootCertLoading();
     void systemCaCertificates();
+    void handshake_data();
+    void handshake();
+};
+
+// Local server whose sockets share one TLS context, so that clients can
+// resume the sessions negotiated with it.
+class HandshakeServer : public QTcpServer
+{
+public:
+    QString certificateFile;
+    QString keyFile;
+
+protected:
+    void incomingConnection(qintptr socketDescriptor) override
+    {
+        QSslSocket *socket = new QSslSocket(this);
+        socket->setLocalCertificate(certificateFile);
+        socket->setPrivateKey(keyFile);
+        socket->setPeerVerifyMode(QSslSocket::VerifyNone);
+        if (context)
+            QSslSocketPrivate::checkSettingSslContext(socket, context);
+        connect(socket, &QSslSocket::encrypted, this, [this, socket]() {
+            if (!context)
+                context = QSslSocketPrivate::sslContext(socket);
+            socket->write("ready");
+        });
+        connect(socket, &QSslSocket::disconnected, socket, &QObject::deleteLater);
+        socket->setSocketDescriptor(socketDescriptor);
+        socket->startServerEncryption();
+    }
+
+private:
+    std::shared_ptr<QSslContext> context;
 };
 
 tst_QSslSocket::tst_QSslSocket()
@@ -63,8 +101,8 @@ tst_QSslSocket::~tst_QSslSocket()
 
 void tst_QSslSocket::initTestCase()
 {
-    if (!QtNetworkSettings::verifyTestNetworkSettings())
-        QSKIP("No network test server available");
+    if (!QSslSocket::supportsSsl())
+        QSKIP("No SSL support");
 }
 
 void tst_QSslSocket::init()
@@ -79,6 +117,9 @@ void tst_QSslSocket::cleanup()
 
 void tst_QSslSocket::rootCertLoading()
 {
+    if (!QtNetworkSettings::verifyTestNetworkSettings())
+        QSKIP("No network test server available");
+
     QBENCHMARK_ONCE {
         QSslSocket socket;
         socket.connectToHostEncrypted(QtNetworkSettings::serverName(), 443);
@@ -96,5 +137,50 @@ void tst_QSslSocket::systemCaCertificates()
   }
 }
 
+void tst_QSslSocket::handshake_data()
+{
+    QTest::addColumn<bool>("resume");
+
+    QTest::newRow("full") << false;
+    QTest::newRow("resumed") << true;
+}
+
+void tst_QSslSocket::handshake()
+{
+    QFETCH(bool, resume);
+
+    HandshakeServer server;
+    server.certificateFile =
+            QFINDTESTDATA("../../../../auto/network/ssl/qsslsocket/certs/fluke.cert");
+    server.keyFile = QFINDTESTDATA("../../../../auto/network/ssl/qsslsocket/certs/fluke.key");
+    if (server.certificateFile.isEmpty() || server.keyFile.isEmpty())
+        QSKIP("Test certificates not found");
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+
+    QSslConfiguration configuration = QSslConfiguration::defaultConfiguration();
+    configuration.setPeerVerifyMode(QSslSocket::VerifyNone);
+    configuration.setSslOption(QSsl::SslOptionDisableSessionSharing, !resume);
+    QTlsSessionCache::instance()->clear();
+
+    const auto connectToServer = [&](bool expectResumed) {
+        QSslSocket socket;
+        socket.setSslConfiguration(configuration);
+        socket.connectToHostEncrypted(QStringLiteral("127.0.0.1"), server.serverPort());
+        // wait for data, so that a TLS 1.3 session ticket has been received
+        QVERIFY(QTest::qWaitFor([&socket]() { return socket.bytesAvailable() > 0; }, 5000));
+        QCOMPARE(QSslConfigurationPrivate::peerSessionWasShared(socket.sslConfiguration()),
+                 expectResumed);
+        socket.disconnectFromHost();
+    };
+
+    // negotiate the session to resume
+    if (resume)
+        connectToServer(false);
+
+    QBENCHMARK {
+        connectToServer(resume);
+    }
+}
+
 QTEST_MAIN(tst_QSslSocket)
 #include "tst_qsslsocket.moc"